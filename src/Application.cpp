@@ -1,12 +1,18 @@
 #include "Application.hpp"
 #include "Camera.hpp"
+#include "MeshDecimator.hpp"
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
 #include <numbers>
+#include <cmath>
 #include <exception>
 #include <stdexcept>
 #include <chrono>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
 #include <argparse/argparse.hpp>
+#include <Eigen/Eigen>
 
 Application::Application(int argc_, char** argv_)
 {
@@ -15,7 +21,7 @@ Application::Application(int argc_, char** argv_)
 	// Input dataset.
 	argumentParser
 		.add_argument("--dataset")
-		.help("Input dataset. Supported: \"VirtualDataLoader\", \"TUM\".")
+		.help("Input dataset. Supported: \"VirtualDataLoader\", \"Procedural\", \"TUM\", \"Sens\".")
 		.default_value("VirtualDataLoader");
 	// Parameters of VirtualDataLoader.
 	argumentParser
@@ -36,17 +42,121 @@ Application::Application(int argc_, char** argv_)
 		.nargs(1)
 		.scan<'g', float>()
 		.default_value(0.5f);
+	// Parameters of ProceduralDataLoader.
+	argumentParser
+		.add_argument("--Procedural.extent")
+		.help("The frame extent of ProceduralDataLoader.")
+		.nargs(2)
+		.scan<'i', int>()
+		.default_value(std::vector<int>{320, 240});
+	argumentParser
+		.add_argument("--Procedural.scene-size")
+		.help("The size of the synthesized room in ProceduralDataLoader.")
+		.nargs(3)
+		.scan<'g', float>()
+		.default_value(std::vector<float>{9.0f, 3.0f, 9.0f});
+	argumentParser
+		.add_argument("--Procedural.pillars")
+		.help("The number of pillars along x and z axes in ProceduralDataLoader.")
+		.nargs(2)
+		.scan<'i', int>()
+		.default_value(std::vector<int>{4, 4});
+	argumentParser
+		.add_argument("--Procedural.period")
+		.help("The number of frames in one loop of the trajectory in ProceduralDataLoader.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(3000);
+	argumentParser
+		.add_argument("--Procedural.seed")
+		.help("The random seed used to place the pillars in ProceduralDataLoader.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(0);
+	argumentParser
+		.add_argument("--Procedural.window-ratio")
+		.help("The fraction of the wall height (from the ceiling down) covered by windows in ProceduralDataLoader. Windows and the skylight have invalid depth.")
+		.nargs(1)
+		.scan<'g', float>()
+		.default_value(0.0f);
+	argumentParser.add_argument("--Procedural.gpu")
+		.help("Render the frames of ProceduralDataLoader on the GPU directly into the input textures, without host memory or uploads.")
+		.flag();
 	// Parameters of TUM.
 	argumentParser
 		.add_argument("--TUM.path")
-		.help("Path to the folder of TUM RGB-D dataset.");
+		.help("Path to the folder of TUM RGB-D dataset, or to its .tgz/.tar.gz/.tar archive, which is read without extraction.");
+	argumentParser
+		.add_argument("--TUM.threads")
+		.help("The number of threads decoding the images of the TUM dataset. 0 uses all hardware threads.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(0);
+	argumentParser
+		.add_argument("--TUM.look-ahead")
+		.help("The maximal number of frames read and decoded ahead of the frame being processed.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(8);
+	// Parameters of Sens.
+	argumentParser
+		.add_argument("--Sens.path")
+		.help("Path to the ScanNet sensor stream (.sens) file.");
+	argumentParser
+		.add_argument("--Sens.threads")
+		.help("The number of threads decoding the frames of the sensor stream. 0 uses all hardware threads.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(0);
+	argumentParser
+		.add_argument("--Sens.look-ahead")
+		.help("The maximal number of frames read and decoded ahead of the frame being processed.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(8);
 	// Application settings.
 	argumentParser.add_argument("--debug")
-		.help("Enable headless mode.")
+		.help("Enable debug mode.")
 		.flag();
 	argumentParser.add_argument("--headless")
-		.help("Enable debug mode.")
+		.help("Enable headless mode. No window is opened, and the application exits after the last frame.")
 		.flag();
+	// Scalability test settings.
+	argumentParser
+		.add_argument("--benchmark.duration")
+		.help("Run a scalability test for the given number of seconds, then exit. The exit code is non-zero if drift in per-frame cost is detected.")
+		.nargs(1)
+		.scan<'g', double>();
+	argumentParser
+		.add_argument("--benchmark.window")
+		.help("The length of a statistics window in seconds in the scalability test.")
+		.nargs(1)
+		.scan<'g', double>()
+		.default_value(10.0);
+	argumentParser
+		.add_argument("--benchmark.warmup")
+		.help("The warmup period in seconds excluded from drift detection in the scalability test.")
+		.nargs(1)
+		.scan<'g', double>()
+		.default_value(30.0);
+	argumentParser
+		.add_argument("--benchmark.drift-tolerance")
+		.help("The allowed relative growth of frame time and fence wait time in the scalability test.")
+		.nargs(1)
+		.scan<'g', double>()
+		.default_value(0.2);
+	argumentParser
+		.add_argument("--benchmark.drift-floor")
+		.help("The allowed absolute growth of frame time and fence wait time in milliseconds in the scalability test.")
+		.nargs(1)
+		.scan<'g', double>()
+		.default_value(1.0);
+	argumentParser
+		.add_argument("--benchmark.memory-tolerance")
+		.help("The allowed relative growth of allocated memory in the scalability test.")
+		.nargs(1)
+		.scan<'g', double>()
+		.default_value(0.05);
 	// KinectFusion parameters.
 	argumentParser
 		.add_argument("--truncation-weight")
@@ -76,6 +186,41 @@ Application::Application(int argc_, char** argv_)
 		.help("The truncation distance of TSDF. By default, it is 3x the voxel size.")
 		.nargs(1)
 		.scan<'g', float>();
+	argumentParser.add_argument("--sparse-volume")
+		.help("Bind GPU memory only for the observed regions of the TSDF volume. Falls back to a dense volume if sparse binding is not supported.")
+		.flag();
+	argumentParser
+		.add_argument("--color-bricks")
+		.help("The number of color bricks (8x8x8 voxels) of the color pool. Colors of further bricks are dropped. By default, 1/8 of the volume's bricks.")
+		.nargs(1)
+		.scan<'i', int>();
+	argumentParser
+		.add_argument("--tracking-level")
+		.help("The finest pyramid level used in ICP. Level l tracks at 1/2^l of the depth frame resolution. Fusion always uses the full resolution.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(0);
+	argumentParser
+		.add_argument("--fusion.work-group-size")
+		.help("The work group size of fusion, whose work items are the (x, y) columns of the volume. The pipeline is specialized for it.")
+		.nargs(2)
+		.scan<'i', int>()
+		.default_value(std::vector<int>{32, 32});
+	argumentParser.add_argument("--pipelined-tracking")
+		.help("Fuse each frame on the compute queue while the next frame is tracked on the main queue, against model maps ray casted before that fusion.")
+		.flag();
+	argumentParser
+		.add_argument("--pipelined-tracking.lag")
+		.help("With --pipelined-tracking, ray cast the model maps every n frames. The model used to track a frame misses the last n fused frames at most.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(1);
+	argumentParser.add_argument("--half-precision")
+		.help("Run bilateral filtering, half sampling, normal computation and the ICP linear system in fp16 arithmetic. Requires shaderFloat16; otherwise, fp32 is used.")
+		.flag();
+	argumentParser.add_argument("--half-precision.check")
+		.help("Also run the other precision on every frame and check that the fp16 depth maps, normal maps and poses stay within tolerance of fp32. The exit code is non-zero otherwise.")
+		.flag();
 	argumentParser
 		.add_argument("--sigma-color")
 		.help("The sigma color term in bilateral filtering.")
@@ -106,6 +251,124 @@ Application::Application(int argc_, char** argv_)
 		.nargs(1)
 		.scan<'g', float>()
 		.default_value(std::numbers::pi_v<float> / 15.0f);
+	argumentParser.add_argument("--gravity-prior")
+		.help("Use the gravity direction provided by the dataset (e.g. TUM accelerometer data) to add the last pose with corrected roll and pitch as an initial pose hypothesis in ICP.")
+		.flag();
+	argumentParser
+		.add_argument("--gravity-weight")
+		.help("The weight of the gravity alignment term in ICP, relative to one correspondence. Only used with --gravity-prior.")
+		.nargs(1)
+		.scan<'g', float>()
+		.default_value(0.0f);
+	argumentParser
+		.add_argument("--mesh-cache-slabs")
+		.help("The number of slabs of the incremental mesh cache. Each slab holds the mesh of one brick of 8x8x8 voxels. If 0, the mesh cache is disabled.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(0);
+	argumentParser
+		.add_argument("--export-mesh")
+		.help("Export the mesh of the mesh cache to this binary PLY file on exit. Requires --mesh-cache-slabs.");
+	argumentParser
+		.add_argument("--export-mesh.budgets")
+		.help("Triangle budgets of the exported mesh. The mesh is decimated and exported once per budget, with the budget appended to the file name if there are several. 0 exports the full mesh.")
+		.nargs(argparse::nargs_pattern::at_least_one)
+		.scan<'i', int>()
+		.default_value(std::vector<int>{ 0 });
+	argumentParser
+		.add_argument("--export-mesh.max-error")
+		.help("The maximal quadric error of a collapsed edge, normalized by the area of the merged triangles, in meters. If 0, the error is unbounded and only the triangle budget stops the decimation.")
+		.nargs(1)
+		.scan<'g', float>()
+		.default_value(0.0f);
+	argumentParser
+		.add_argument("--export-mesh.threads")
+		.help("The number of decimation threads. If 0, the number of hardware threads is used.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(0);
+	argumentParser
+		.add_argument("--export-point-cloud")
+		.help("Export the zero surface of the volume as an oriented point cloud to this binary PLY file on exit.");
+	argumentParser
+		.add_argument("--export-point-cloud.staging-budget")
+		.help("The size of the host visible buffers used to extract the point cloud chunk by chunk, in MiB.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(64);
+	argumentParser
+		.add_argument("--ray-casting.batch-benchmark")
+		.help("On exit, ray cast n thumbnails around the last camera pose one by one and in one batch, and report both times.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(0);
+	argumentParser
+		.add_argument("--save-volume")
+		.help("Save the TSDF volume to this file on exit, for --localize.");
+	argumentParser
+		.add_argument("--localize")
+		.help("Load the TSDF volume saved by --save-volume and only track the camera against it, without fusion. The volume parameters are taken from the file.");
+	argumentParser
+		.add_argument("--localize.keyframes")
+		.help("With --localize, the number of keyframes whose ray casted model maps are cached. If 0, the model maps are ray casted for every frame.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(16);
+	argumentParser
+		.add_argument("--localize.keyframe-distance")
+		.help("With --localize, the maximal distance (in meters) between the camera and a keyframe whose model maps are reused.")
+		.nargs(1)
+		.scan<'g', float>()
+		.default_value(0.1f);
+	argumentParser
+		.add_argument("--localize.keyframe-angle")
+		.help("With --localize, the maximal rotation angle (in radians) between the camera and a keyframe whose model maps are reused.")
+		.nargs(1)
+		.scan<'g', float>()
+		.default_value(0.1f);
+	argumentParser
+		.add_argument("--map-stream")
+		.help("Publish the mesh, the camera pose, and a ray casted thumbnail to a shared memory region of this name after each fusion, for KinectFusion-Viewer. Requires --mesh-cache-slabs.");
+	argumentParser
+		.add_argument("--map-stream.slot-size")
+		.help("The size of a version of the map stream, in MiB. Changed bricks that do not fit are sent in the next versions.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(16);
+	argumentParser
+		.add_argument("--map-stream.thumbnail-size")
+		.help("The maximal width and height of the thumbnail of the map stream. If 0, no thumbnail is published.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(160);
+	argumentParser
+		.add_argument("--pose-stream")
+		.help("Publish the camera pose of each frame to a shared memory region of this name right after it is estimated, before fusion.");
+	argumentParser
+		.add_argument("--pose-stream.history")
+		.help("The number of recent poses kept in the pose stream for consumers that read the history.")
+		.nargs(1)
+		.scan<'i', int>()
+		.default_value(64);
+	argumentParser
+		.add_argument("--pose-stream.measure-latency")
+		.help("Poll the pose stream on a background thread and report the publish-to-read latency on exit. It occupies one CPU core.")
+		.flag();
+	argumentParser
+		.add_argument("--metrics.prometheus")
+		.help("Periodically write the operational metrics to this file in the Prometheus text format, e.g. for the textfile collector of node_exporter.");
+	argumentParser
+		.add_argument("--metrics.json")
+		.help("Periodically append the operational metrics to this file as JSON lines. The file is truncated on start.");
+	argumentParser
+		.add_argument("--metrics.period")
+		.help("The number of seconds between two metrics exports.")
+		.nargs(1)
+		.scan<'g', double>()
+		.default_value(15.0);
+	argumentParser.add_argument("--multi-hypothesis-icp")
+		.help("Besides the last pose, also start ICP from a constant velocity prediction and small rotational perturbations of the last pose. The hypothesis with the most inliers in the coarsest pyramid level is refined.")
+		.flag();
 	argumentParser.parse_args(argc_, argv_);
 
 	// Set application mode.
@@ -114,7 +377,11 @@ Application::Application(int argc_, char** argv_)
 	if (argumentParser.get<bool>("--headless"))
 		this->_headlessMode = true;
 
+	// Create the metrics registry. It is always updated, and only exported if requested.
+	this->_pMetrics.reset(new MetricsRegistry());
+
 	// Load dataset
+	std::chrono::steady_clock::time_point dataLoaderCreationBegin = std::chrono::steady_clock::now();
 	if (argumentParser.get<std::string>("--dataset") == "VirtualDataLoader") {
 		std::vector<int> extent = argumentParser.get<std::vector<int>>("--VirtualDataLoader.extent");
 		std::vector<float> center = argumentParser.get<std::vector<float>>("--VirtualDataLoader.center");
@@ -125,23 +392,63 @@ Application::Application(int argc_, char** argv_)
 			length
 		));
 	}
+	else if (argumentParser.get<std::string>("--dataset") == "Procedural") {
+		std::vector<int> extent = argumentParser.get<std::vector<int>>("--Procedural.extent");
+		std::vector<float> sceneSize = argumentParser.get<std::vector<float>>("--Procedural.scene-size");
+		std::vector<int> pillars = argumentParser.get<std::vector<int>>("--Procedural.pillars");
+		int period = argumentParser.get<int>("--Procedural.period");
+		int seed = argumentParser.get<int>("--Procedural.seed");
+		float windowRatio = argumentParser.get<float>("--Procedural.window-ratio");
+		this->_pDataLoader.reset(new ProceduralDataLoader(
+			vk::Extent2D(static_cast<std::uint32_t>(extent[0]), static_cast<std::uint32_t>(extent[1])),
+			jjyou::glsl::vec3(sceneSize[0], sceneSize[1], sceneSize[2]),
+			jjyou::glsl::uvec2(static_cast<std::uint32_t>(pillars[0]), static_cast<std::uint32_t>(pillars[1])),
+			static_cast<std::uint32_t>(period),
+			static_cast<std::uint32_t>(seed),
+			windowRatio,
+			!argumentParser.get<bool>("--Procedural.gpu")
+		));
+	}
 	else if (argumentParser.get<std::string>("--dataset") == "TUM") {
 		std::optional<std::string> path = argumentParser.present<std::string>("--TUM.path");
 		if (!path.has_value()) {
 			throw std::logic_error("[Application] Please specify the path to the TUM dataset by \"--TUM.path\".");
 		}
 		this->_pDataLoader.reset(new TUMDataset(
-			*path
+			*path,
+			static_cast<std::uint32_t>(std::max(argumentParser.get<int>("--TUM.threads"), 0)),
+			static_cast<std::uint32_t>(std::max(argumentParser.get<int>("--TUM.look-ahead"), 1))
+		));
+	}
+	else if (argumentParser.get<std::string>("--dataset") == "Sens") {
+		std::optional<std::string> path = argumentParser.present<std::string>("--Sens.path");
+		if (!path.has_value()) {
+			throw std::logic_error("[Application] Please specify the path to the sensor stream by \"--Sens.path\".");
+		}
+		this->_pDataLoader.reset(new SensStreamLoader(
+			*path,
+			static_cast<std::uint32_t>(std::max(argumentParser.get<int>("--Sens.threads"), 0)),
+			static_cast<std::uint32_t>(std::max(argumentParser.get<int>("--Sens.look-ahead"), 1))
 		));
 	}
 	else {
 		throw std::logic_error("[Application] Unsupported dataset " + argumentParser.get<std::string>("--dataset") + ".");
 	}
+	this->_dataLoaderCreationTime = std::chrono::steady_clock::now() - dataLoaderCreationBegin;
+	this->_pDataLoader->setMetrics(this->_pMetrics.get());
 
 	// Create Vulkan engine
 	this->_pEngine.reset(new Engine(this->_headlessMode, this->_debugMode));
 	this->_physicalDeviceName = std::string(this->_pEngine->context().physicalDevice().getProperties().deviceName.data());
 
+	// Create the GPU frame generator
+	if (argumentParser.get<std::string>("--dataset") == "Procedural" && argumentParser.get<bool>("--Procedural.gpu")) {
+		this->_pSyntheticFrameGenerator.reset(new SyntheticFrameGenerator(
+			*this->_pEngine,
+			static_cast<ProceduralDataLoader&>(*this->_pDataLoader)
+		));
+	}
+
 	// Create KinectFusion
 	int truncationWeight = argumentParser.get<int>("--truncation-weight");
 	std::vector<int> _volumeResolution = argumentParser.get<std::vector<int>>("--volume-resolution");
@@ -156,6 +463,36 @@ Application::Application(int argc_, char** argv_)
 	if (_volumeCorner.has_value())
 		volumeCorner = jjyou::glsl::vec3((*_volumeCorner)[0], (*_volumeCorner)[1], (*_volumeCorner)[2]);
 	std::optional<float> truncationDistance = argumentParser.present<float>("--truncation-distance");
+	bool sparseVolume = argumentParser.get<bool>("--sparse-volume");
+	std::optional<int> _colorBrickCapacity = argumentParser.present<int>("--color-bricks");
+	std::optional<std::uint32_t> colorBrickCapacity;
+	if (_colorBrickCapacity.has_value())
+		colorBrickCapacity = static_cast<std::uint32_t>(std::max(*_colorBrickCapacity, 1));
+	// In localization mode, the volume must have the parameters of the saved one.
+	std::optional<std::string> localizePath = argumentParser.present<std::string>("--localize");
+	std::uint32_t modelMapCacheSize = 0U;
+	std::vector<int> fusionWorkGroupSize = argumentParser.get<std::vector<int>>("--fusion.work-group-size");
+	if (localizePath.has_value()) {
+		if (argumentParser.get<bool>("--pipelined-tracking")) {
+			throw std::logic_error("[Application] \"--localize\" does not fuse frames, so it cannot be combined with \"--pipelined-tracking\".");
+		}
+		TSDFVolume::FileHeader header = TSDFVolume::readFileHeader(*localizePath);
+		volumeResolution = header.resolution;
+		volumeSize = header.size;
+		volumeCorner = header.corner;
+		truncationDistance = header.truncationDistance;
+		if (!colorBrickCapacity.has_value())
+			colorBrickCapacity = header.colorBrickCapacity;
+		modelMapCacheSize = static_cast<std::uint32_t>(std::max(argumentParser.get<int>("--localize.keyframes"), 0));
+	}
+	std::uint32_t trackingLevel = static_cast<std::uint32_t>(argumentParser.get<int>("--tracking-level"));
+	std::uint32_t meshCacheSlabs = static_cast<std::uint32_t>(argumentParser.get<int>("--mesh-cache-slabs"));
+	if (argumentParser.present<std::string>("--export-mesh").has_value() && meshCacheSlabs == 0U) {
+		throw std::logic_error("[Application] \"--export-mesh\" requires the mesh cache. Please specify \"--mesh-cache-slabs\".");
+	}
+	if (argumentParser.present<std::string>("--map-stream").has_value() && meshCacheSlabs == 0U) {
+		throw std::logic_error("[Application] \"--map-stream\" requires the mesh cache. Please specify \"--mesh-cache-slabs\".");
+	}
 	this->_pKinectFusion.reset(new KinectFusion(
 		*this->_pEngine,
 		this->_pDataLoader->colorFrameExtent(),
@@ -167,30 +504,228 @@ Application::Application(int argc_, char** argv_)
 		volumeResolution,
 		volumeSize,
 		volumeCorner,
-		truncationDistance
+		truncationDistance,
+		sparseVolume,
+		trackingLevel,
+		meshCacheSlabs,
+		argumentParser.get<bool>("--pipelined-tracking"),
+		argumentParser.get<bool>("--half-precision"),
+		colorBrickCapacity,
+		modelMapCacheSize,
+		argumentParser.get<float>("--localize.keyframe-distance"),
+		argumentParser.get<float>("--localize.keyframe-angle"),
+		jjyou::glsl::uvec2(
+			static_cast<std::uint32_t>(std::max(fusionWorkGroupSize[0], 1)),
+			static_cast<std::uint32_t>(std::max(fusionWorkGroupSize[1], 1))
+		)
 	));
+	if (localizePath.has_value()) {
+		std::chrono::steady_clock::time_point loadBegin = std::chrono::steady_clock::now();
+		this->_pKinectFusion->loadTSDFVolume(*localizePath);
+		std::cout << "[Application] Loaded volume " << *localizePath << " in "
+			<< std::chrono::duration<double>(std::chrono::steady_clock::now() - loadBegin).count() << " s." << std::endl;
+	}
+	this->_pKinectFusion->setMetrics(this->_pMetrics.get());
+	if (argumentParser.get<bool>("--half-precision") && !this->_pKinectFusion->halfPrecision()) {
+		std::cout << "[Application] The device does not support shaderFloat16. The image-space kernels run in fp32." << std::endl;
+	}
+	if (argumentParser.get<bool>("--half-precision.check") && !this->_pEngine->enabledVulkan12Features().shaderFloat16) {
+		throw std::runtime_error("[Application] \"--half-precision.check\" requires a device that supports shaderFloat16.");
+	}
 
 	// Init assets
 	this->_initAssets();
 
+	// Create map publisher
+	std::optional<std::string> mapStreamName = argumentParser.present<std::string>("--map-stream");
+	if (mapStreamName.has_value()) {
+		this->_pMapPublisher.reset(new MapPublisher(
+			*this->_pEngine,
+			*this->_pKinectFusion,
+			MapPublisher::Parameters{
+				.name = *mapStreamName,
+				.slotSize = static_cast<std::size_t>(std::max(argumentParser.get<int>("--map-stream.slot-size"), 1)) << 20,
+				.thumbnailSize = static_cast<std::uint32_t>(std::max(argumentParser.get<int>("--map-stream.thumbnail-size"), 0))
+			}
+		));
+	}
+
+	// Create pose publisher
+	std::optional<std::string> poseStreamName = argumentParser.present<std::string>("--pose-stream");
+	if (poseStreamName.has_value()) {
+		this->_pPosePublisher.reset(new PosePublisher(
+			*poseStreamName,
+			static_cast<std::uint32_t>(std::max(argumentParser.get<int>("--pose-stream.history"), 2))
+		));
+		if (argumentParser.get<bool>("--pose-stream.measure-latency"))
+			this->_pPoseLatencyProbe.reset(new PoseLatencyProbe(*poseStreamName));
+	}
+
+	// Create scalability monitor
+	std::optional<double> benchmarkDuration = argumentParser.present<double>("--benchmark.duration");
+	if (benchmarkDuration.has_value()) {
+		this->_pScalabilityMonitor.reset(new ScalabilityMonitor(
+			*this->_pEngine,
+			*benchmarkDuration,
+			argumentParser.get<double>("--benchmark.window"),
+			argumentParser.get<double>("--benchmark.warmup"),
+			argumentParser.get<double>("--benchmark.drift-tolerance"),
+			argumentParser.get<double>("--benchmark.drift-floor") / 1000.0,
+			argumentParser.get<double>("--benchmark.memory-tolerance")
+		));
+	}
+
+	// Create metrics exporter
+	std::optional<std::string> metricsPrometheusPath = argumentParser.present<std::string>("--metrics.prometheus");
+	std::optional<std::string> metricsJsonPath = argumentParser.present<std::string>("--metrics.json");
+	if (metricsPrometheusPath.has_value() || metricsJsonPath.has_value()) {
+		this->_pMetricsExporter.reset(new MetricsExporter(
+			*this->_pMetrics,
+			metricsPrometheusPath,
+			metricsJsonPath,
+			std::chrono::duration<double>(std::max(argumentParser.get<double>("--metrics.period"), 0.1))
+		));
+	}
+
 	// Store other arguments
 	this->_arguments.sigmaColor = argumentParser.get<float>("--sigma-color");
 	this->_arguments.sigmaSpace = argumentParser.get<float>("--sigma-space");
 	this->_arguments.filterKernelSize = argumentParser.get<int>("--filter-kernel-size");
 	this->_arguments.distanceThreshold = argumentParser.get<float>("--distance-threshold");
 	this->_arguments.angleThreshold = argumentParser.get<float>("--angle-threshold");
+	this->_arguments.multiHypothesisICP = argumentParser.get<bool>("--multi-hypothesis-icp");
+	this->_arguments.pipelinedTracking = argumentParser.get<bool>("--pipelined-tracking");
+	this->_arguments.pipelinedTrackingLag = std::max(argumentParser.get<int>("--pipelined-tracking.lag"), 1);
+	this->_arguments.halfPrecisionCheck = argumentParser.get<bool>("--half-precision.check");
+	this->_arguments.gravityPrior = argumentParser.get<bool>("--gravity-prior");
+	this->_arguments.gravityWeight = argumentParser.get<float>("--gravity-weight");
+	this->_arguments.exportMeshPath = argumentParser.present<std::string>("--export-mesh");
+	this->_arguments.exportMeshBudgets = argumentParser.get<std::vector<int>>("--export-mesh.budgets");
+	this->_arguments.exportMeshMaxError = argumentParser.get<float>("--export-mesh.max-error");
+	this->_arguments.exportMeshThreads = argumentParser.get<int>("--export-mesh.threads");
+	this->_arguments.exportPointCloudPath = argumentParser.present<std::string>("--export-point-cloud");
+	this->_arguments.exportPointCloudStagingBudget = argumentParser.get<int>("--export-point-cloud.staging-budget");
+	this->_arguments.saveVolumePath = argumentParser.present<std::string>("--save-volume");
+	this->_arguments.batchRayCastingBenchmark = std::max(argumentParser.get<int>("--ray-casting.batch-benchmark"), 0);
+	this->_arguments.localizePath = localizePath;
 }
 
 void Application::mainLoop(void) {
+	if (!this->_pScalabilityMonitor) {
+		this->_mainLoop();
+		return;
+	}
+	// In scalability tests, resource exhaustion is reported as a failure instead of terminating the program.
+	try {
+		this->_mainLoop();
+	}
+	catch (const vk::SystemError& e) {
+		this->_pScalabilityMonitor->recordFailure(e.what());
+	}
+	if (!this->_pScalabilityMonitor->report(std::cout))
+		this->_succeeded = false;
+}
+
+void Application::_mainLoop(void) {
 	std::uint32_t resourceCycleCounter = 0;
 	bool firstFrame = true;
+	std::uint32_t numTrackedFrames = 0U;
+	jjyou::glsl::mat4 secondLastFrameView{};
 	jjyou::glsl::mat4 lastFrameView{};
 	jjyou::glsl::mat4 currFrameView{};
+	Camera lastFrameCamera{};
 	FrameData frameData{};
+	std::int64_t captureTime = 0LL;
 	bool eof = false;
 	std::chrono::steady_clock::time_point timer{};
 	std::uint32_t numFramesSinceLastTimer = 0U;
 	std::uint32_t fps = 0U;
+	struct {
+		std::uint32_t numFrames = 0U;
+		std::uint32_t numFailures = 0U;
+		std::uint64_t numIterations = 0U;
+		std::chrono::duration<double> trackingTime{};
+		std::uint32_t numGroundTruthFrames = 0U;
+		// Sums of the estimated (x) and groundtruth (y) camera positions, for the rigid alignment of the trajectories.
+		Eigen::Vector3d sumEstimatedPosition = Eigen::Vector3d::Zero();
+		Eigen::Vector3d sumGroundTruthPosition = Eigen::Vector3d::Zero();
+		double sumSquaredEstimatedPosition = 0.0;
+		double sumSquaredGroundTruthPosition = 0.0;
+		Eigen::Matrix3d sumCrossCovariance = Eigen::Matrix3d::Zero();	// Sum of y x^T.
+		std::uint32_t numProcessedFrames = 0U;
+		std::chrono::duration<double> processingTime{};	// Wall time of the main loop iterations that processed a frame.
+	} icpStatistics;
+	// Absolute trajectory error RMSE, after the rigid alignment of the estimated trajectory to the groundtruth
+	// that minimizes it (Horn / Umeyama without scale). It is computed in closed form from the sums above.
+	auto absoluteTrajectoryError = [&icpStatistics](void) {
+		if (icpStatistics.numGroundTruthFrames == 0U)
+			return 0.0;
+		double numFrames = static_cast<double>(icpStatistics.numGroundTruthFrames);
+		Eigen::Vector3d meanEstimated = icpStatistics.sumEstimatedPosition / numFrames;
+		Eigen::Vector3d meanGroundTruth = icpStatistics.sumGroundTruthPosition / numFrames;
+		double varianceEstimated = icpStatistics.sumSquaredEstimatedPosition - numFrames * meanEstimated.squaredNorm();
+		double varianceGroundTruth = icpStatistics.sumSquaredGroundTruthPosition - numFrames * meanGroundTruth.squaredNorm();
+		Eigen::Matrix3d crossCovariance = icpStatistics.sumCrossCovariance - numFrames * meanGroundTruth * meanEstimated.transpose();
+		Eigen::JacobiSVD<Eigen::Matrix3d> svd(crossCovariance, Eigen::ComputeFullU | Eigen::ComputeFullV);
+		Eigen::Vector3d singularValues = svd.singularValues();
+		// Exclude reflections.
+		if ((svd.matrixU() * svd.matrixV().transpose()).determinant() < 0.0)
+			singularValues(2) = -singularValues(2);
+		double sumSquaredError = varianceEstimated + varianceGroundTruth - 2.0 * singularValues.sum();
+		return std::sqrt(std::max(sumSquaredError, 0.0) / numFrames);
+	};
+	struct {
+		std::uint32_t numFrames = 0U;
+		std::chrono::duration<double> time{};
+	} fusionStatistics;
+	struct {
+		std::uint32_t numFrames = 0U;
+		KinectFusion::KernelTimes kernelTimes{};
+		double sumValidPixelRatio = 0.0;	// At the tracking level.
+	} kernelStatistics;
+	struct {
+		std::uint32_t numFrames = 0U;
+		std::array<float, KinectFusion::NUM_PYRAMID_LEVELS> maxDepthError{};
+		std::array<float, KinectFusion::NUM_PYRAMID_LEVELS> maxNormalError{};
+		float maxMismatchedPixelRatio = 0.0f;
+		std::uint32_t numTrackingMismatches = 0U;
+		float maxRotationError = 0.0f;
+		float maxTranslationError = 0.0f;
+		KinectFusion::KernelTimes fp32Times{};
+		KinectFusion::KernelTimes fp16Times{};
+	} halfPrecisionStatistics;
+	struct {
+		std::uint32_t numFrames = 0U;
+		std::chrono::duration<double> time{};
+	} rayCastingStatistics;
+	auto addKernelTimes = [](KinectFusion::KernelTimes& sum_, const KinectFusion::KernelTimes& times_) {
+		sum_.bilateralFiltering += times_.bilateralFiltering;
+		sum_.halfSampling += times_.halfSampling;
+		sum_.compactValidPixels += times_.compactValidPixels;
+		sum_.computeVertexMap += times_.computeVertexMap;
+		sum_.computeNormalMap += times_.computeNormalMap;
+		sum_.buildLinearFunction += times_.buildLinearFunction;
+	};
+	auto totalKernelTime = [](const KinectFusion::KernelTimes& times_) {
+		return times_.bilateralFiltering + times_.halfSampling + times_.compactValidPixels + times_.computeVertexMap + times_.computeNormalMap + times_.buildLinearFunction;
+	};
+	struct {
+		std::uint32_t numFrames = 0U;
+		std::uint64_t colorBytes = 0U;
+		std::uint64_t rgbaColorBytes = 0U;
+		std::chrono::duration<double> loadTime{};
+		std::chrono::duration<double> uploadTime{};
+		std::chrono::duration<double> firstLoadTime{};
+	} uploadStatistics;
+	struct {
+		std::uint32_t numFrames = 0U;
+		std::chrono::duration<double> time{};
+	} synthesisStatistics;
+	struct {
+		std::uint32_t numUpdates = 0U;
+		std::uint64_t numRemeshedBricks = 0U;
+		std::chrono::duration<double> remeshTime{};
+	} meshCacheStatistics;
 	// UI
 	struct {
 		struct {
@@ -201,24 +736,93 @@ void Application::mainLoop(void) {
 		} ar;
 		struct {
 			bool resetVolume = false;
+			bool exportMesh = false;
+			bool exportPointCloud = false;
 		} fusion;
 		struct {
 			bool trackCamera = true;
 			bool displayInputFrames = false;
 			bool drawGTCamera = false;
+			bool drawMesh = false;
 		} visualization;
 	} ui;
 
+	// Publish the map and collect statistics once a frame is fused.
+	auto onFused = [&](std::uint32_t frameIndex_, const Camera& camera_, const jjyou::glsl::mat4& view_) {
+		if (this->_pMapPublisher) {
+			this->_pMapPublisher->publish(frameIndex_, camera_, view_);
+		}
+		if (this->_pKinectFusion->meshCacheEnabled()) {
+			++meshCacheStatistics.numUpdates;
+			meshCacheStatistics.numRemeshedBricks += this->_pKinectFusion->meshCache().statistics().numRemeshedBricks;
+			meshCacheStatistics.remeshTime += this->_pKinectFusion->meshCache().statistics().remeshTime;
+		}
+	};
+	// With pipelined tracking, a frame is fused while the next frame is loaded and tracked.
+	struct FusedFrame {
+		std::uint32_t frameIndex;
+		Camera camera;
+		jjyou::glsl::mat4 view;
+	};
+	std::optional<FusedFrame> pendingFusion{};
+	bool modelEmpty = true;
+	std::uint32_t numFramesSinceModelPrediction = 0U;
+	// In localization mode, the first frame is already tracked against the loaded volume, starting from the initial pose.
+	bool localization = this->_arguments.localizePath.has_value();
+	if (localization)
+		lastFrameView = this->_pDataLoader->initialPose();
+	auto endPendingFusion = [&](void) {
+		if (!pendingFusion.has_value())
+			return;
+		this->_pKinectFusion->endFuse();
+		onFused(pendingFusion->frameIndex, pendingFusion->camera, pendingFusion->view);
+		pendingFusion.reset();
+	};
+
+	// Operational metrics. The per-frame updates are relaxed atomics, and the gauges that need queries are sampled once per second.
+	MetricsRegistry::Counter& framesLoadedMetric = this->_pMetrics->counter("kinectfusion_frames_loaded_total", "Number of frames returned by the data loader.");
+	MetricsRegistry::Counter& framesProcessedMetric = this->_pMetrics->counter("kinectfusion_frames_processed_total", "Number of valid frames processed by the main loop.");
+	MetricsRegistry::Counter& framesDroppedMetric = this->_pMetrics->counter("kinectfusion_frames_dropped_total", "Number of invalid frames returned by the data loader.");
+	MetricsRegistry::Histogram& loadTimeMetric = this->_pMetrics->histogram("kinectfusion_load_seconds", "Time spent getting a frame from the data loader.", 1.0e-6);
+	MetricsRegistry::Histogram& uploadTimeMetric = this->_pMetrics->histogram("kinectfusion_upload_seconds", "Time spent uploading a frame to the GPU.", 1.0e-6);
+	MetricsRegistry::Histogram& trackingTimeMetric = this->_pMetrics->histogram("kinectfusion_tracking_seconds", "Time spent estimating the pose of a frame.", 1.0e-6);
+	MetricsRegistry::Histogram& fusionTimeMetric = this->_pMetrics->histogram("kinectfusion_fusion_seconds", "Time spent fusing a frame, without pipelined tracking.", 1.0e-6);
+	MetricsRegistry::Histogram& rayCastingTimeMetric = this->_pMetrics->histogram("kinectfusion_ray_casting_seconds", "Time spent ray casting the view.", 1.0e-6);
+	MetricsRegistry::Histogram& frameTimeMetric = this->_pMetrics->histogram("kinectfusion_frame_seconds", "Wall time of the main loop iterations that processed a frame.", 1.0e-6);
+	MetricsRegistry::Gauge& fpsMetric = this->_pMetrics->gauge("kinectfusion_fps", "Number of main loop iterations in the last second.");
+	MetricsRegistry::Gauge& deviceMemoryMetric = this->_pMetrics->gauge("kinectfusion_device_memory_bytes", "Device memory allocated through VMA.");
+	auto updateDeviceMemoryMetric = [&](void) {
+		const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+		vmaGetMemoryProperties(*this->_pEngine->allocator(), &pMemoryProperties);
+		std::vector<VmaBudget> budgets(pMemoryProperties->memoryHeapCount);
+		vmaGetHeapBudgets(*this->_pEngine->allocator(), budgets.data());
+		VkDeviceSize allocationBytes = 0U;
+		for (const VmaBudget& budget : budgets)
+			allocationBytes += budget.statistics.allocationBytes;
+		deviceMemoryMetric.set(static_cast<double>(allocationBytes));
+	};
+	updateDeviceMemoryMetric();
+
 	// Main loop
 	timer = std::chrono::steady_clock::now();
-	while (!this->_pEngine->window().windowShouldClose()) {
+	while (this->_headlessMode || !this->_pEngine->window().windowShouldClose()) {
+
+		// Stop the scalability test
+		if (this->_pScalabilityMonitor && this->_pScalabilityMonitor->finished())
+			break;
+		// Without a window, nothing is left to do after the last frame.
+		if (this->_headlessMode && eof)
+			break;
 
 		// Compute FPS
 		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		ScalabilityMonitor::Duration fenceWaitBegin = this->_pEngine->fenceWaitTime();
 		if (std::chrono::duration_cast<std::chrono::seconds>(now - timer).count()) {
 			timer = now;
 			fps = numFramesSinceLastTimer;
 			numFramesSinceLastTimer = 0U;
+			fpsMetric.set(static_cast<double>(fps));
+			updateDeviceMemoryMetric();
 		}
 		++numFramesSinceLastTimer;
 
@@ -229,14 +833,26 @@ void Application::mainLoop(void) {
 
 		// Fetch data
 		if (!eof) {
+			std::chrono::steady_clock::time_point loadBegin = std::chrono::steady_clock::now();
 			frameData = this->_pDataLoader->getFrame();
+			captureTime = PoseStream::now();
+			std::chrono::duration<double> loadTime = std::chrono::steady_clock::now() - loadBegin;
+			if (uploadStatistics.loadTime.count() == 0.0)
+				uploadStatistics.firstLoadTime = loadTime;
+			uploadStatistics.loadTime += loadTime;
+			if (frameData.state == FrameState::Invalid)
+				framesDroppedMetric.add();
+			else if (frameData.state != FrameState::Eof) {
+				framesLoadedMetric.add();
+				loadTimeMetric.record(loadTime);
+			}
 		}
 		if (frameData.state == FrameState::Eof) {
 			eof = true;
 		}
 
 		// Draw UI
-		if (ImGui::Begin("KinectFusion-Vulkan")) {
+		if (!this->_headlessMode && ImGui::Begin("KinectFusion-Vulkan")) {
 			if (ImGui::TreeNode("AR")) {
 				ImGui::Checkbox("Draw AR sphere", &ui.ar.drawARSphere);
 				ImGui::SliderFloat3("Position", ui.ar.position.data.data(), -5.0f, 5.0f);
@@ -250,12 +866,20 @@ void Application::mainLoop(void) {
 				if (ImGui::Button("Reset volume")) {
 					ui.fusion.resetVolume = true;
 				}
+				if (this->_arguments.exportMeshPath.has_value() && ImGui::Button("Export mesh")) {
+					ui.fusion.exportMesh = true;
+				}
+				if (this->_arguments.exportPointCloudPath.has_value() && ImGui::Button("Export point cloud")) {
+					ui.fusion.exportPointCloud = true;
+				}
 				ImGui::TreePop();
 			}
 			if (ImGui::TreeNode("Visualization")) {
 				ImGui::Checkbox("Track camera", &ui.visualization.trackCamera);
 				ImGui::Checkbox("Display input frames", &ui.visualization.displayInputFrames);
 				ImGui::Checkbox("Draw groundtruth camera", &ui.visualization.drawGTCamera);
+				if (this->_pKinectFusion->meshCacheEnabled())
+					ImGui::Checkbox("Draw mesh", &ui.visualization.drawMesh);
 				ImGui::TreePop();
 			}
 			if (ImGui::TreeNode("Info")) {
@@ -263,21 +887,152 @@ void Application::mainLoop(void) {
 				ImGui::Text("Frame index: %d", frameData.frameIndex);
 				ImGui::Text("Frame state: %s", to_string(frameData.state).c_str());
 				ImGui::Text("FPS: %d", fps);
+				DescriptorAllocator::Statistics descriptorAllocatorStatistics = this->_pEngine->descriptorAllocator().statistics();
+				ImGui::Text("Descriptor sets: %u live, %u pending, %u free, %u pools", descriptorAllocatorStatistics.numLiveSets, descriptorAllocatorStatistics.numPendingSets, descriptorAllocatorStatistics.numFreeSets, descriptorAllocatorStatistics.numPools);
+				ImGui::Text("Descriptor allocations (last frame): %u (%u from pools)", descriptorAllocatorStatistics.numFrameAllocations, descriptorAllocatorStatistics.numFramePoolAllocations);
+				std::array<float, KinectFusion::NUM_PYRAMID_LEVELS> validPixelRatios = this->_pKinectFusion->validPixelRatios();
+				ImGui::Text("Valid pixels: %.1f%% / %.1f%% / %.1f%%", validPixelRatios[0] * 100.0f, validPixelRatios[1] * 100.0f, validPixelRatios[2] * 100.0f);
+				ImGui::Text("Tracking: level %u%s, %.2f ms per frame, ATE %.4f m", this->_pKinectFusion->trackingLevel(), this->_arguments.pipelinedTracking ? " (pipelined)" : "", icpStatistics.numFrames == 0U ? 0.0 : icpStatistics.trackingTime.count() * 1000.0 / static_cast<double>(icpStatistics.numFrames), absoluteTrajectoryError());
+				if (kernelStatistics.numFrames != 0U) {
+					double numFrames = static_cast<double>(kernelStatistics.numFrames);
+					const KinectFusion::KernelTimes& kernelTimes = kernelStatistics.kernelTimes;
+					ImGui::Text("Kernels (%s): filter %.3f, half sampling %.3f, compaction %.3f, vertex %.3f, normal %.3f, linear function %.3f ms per frame", this->_pKinectFusion->halfPrecision() ? "fp16" : "fp32", kernelTimes.bilateralFiltering.count() * 1000.0 / numFrames, kernelTimes.halfSampling.count() * 1000.0 / numFrames, kernelTimes.compactValidPixels.count() * 1000.0 / numFrames, kernelTimes.computeVertexMap.count() * 1000.0 / numFrames, kernelTimes.computeNormalMap.count() * 1000.0 / numFrames, kernelTimes.buildLinearFunction.count() * 1000.0 / numFrames);
+				}
+				if (halfPrecisionStatistics.numFrames != 0U) {
+					double numFrames = static_cast<double>(halfPrecisionStatistics.numFrames);
+					ImGui::Text("Half precision check: fp16 %.3f / fp32 %.3f ms, rotation %.4f rad, translation %.4f m, %u tracking mismatches", totalKernelTime(halfPrecisionStatistics.fp16Times).count() * 1000.0 / numFrames, totalKernelTime(halfPrecisionStatistics.fp32Times).count() * 1000.0 / numFrames, halfPrecisionStatistics.maxRotationError, halfPrecisionStatistics.maxTranslationError, halfPrecisionStatistics.numTrackingMismatches);
+				}
+				if (localization) {
+					const KinectFusion::ModelMapCacheStatistics& cacheStatistics = this->_pKinectFusion->modelMapCacheStatistics();
+					ImGui::Text("Localization: %llu hits, %llu misses, %u keyframes (%llu evicted)", static_cast<unsigned long long>(cacheStatistics.numHits), static_cast<unsigned long long>(cacheStatistics.numMisses), cacheStatistics.numKeyframes, static_cast<unsigned long long>(cacheStatistics.numEvictions));
+				}
+				else if (fusionStatistics.numFrames != 0U) {
+					ImGui::Text("Fusion: %.2f ms per frame", fusionStatistics.time.count() * 1000.0 / static_cast<double>(fusionStatistics.numFrames));
+				}
+				ImGui::Text("ICP: %.2f iterations per frame, %u / %u failed (gravity %s)", icpStatistics.numFrames == 0U ? 0.0 : static_cast<double>(icpStatistics.numIterations) / static_cast<double>(icpStatistics.numFrames), icpStatistics.numFailures, icpStatistics.numFrames, this->_pKinectFusion->worldGravity().has_value() ? "on" : "off");
+				if (uploadStatistics.numFrames != 0U) {
+					double numUploadedFrames = static_cast<double>(uploadStatistics.numFrames);
+					ImGui::Text("Color upload: %s, %.2f MiB per frame (%.2f MiB saved vs RGBA8888)", to_string(this->_pDataLoader->colorFormat()).c_str(), static_cast<double>(uploadStatistics.colorBytes) / numUploadedFrames / 1048576.0, static_cast<double>(uploadStatistics.rgbaColorBytes - uploadStatistics.colorBytes) / numUploadedFrames / 1048576.0);
+					ImGui::Text("Input CPU time: load %.2f ms, upload %.2f ms per frame", uploadStatistics.loadTime.count() * 1000.0 / numUploadedFrames, uploadStatistics.uploadTime.count() * 1000.0 / numUploadedFrames);
+				}
+				if (const FramePrefetcher* pPrefetcher = this->_pDataLoader->prefetcher()) {
+					FramePrefetcher::Statistics prefetchStatistics = pPrefetcher->statistics();
+					ImGui::Text("Prefetch: %u / %llu frames, read %.1f MiB/s, decode %.2f ms per frame (%u threads)", prefetchStatistics.numFrames, static_cast<unsigned long long>(pPrefetcher->numFrames()), prefetchStatistics.readTime.count() == 0.0 ? 0.0 : static_cast<double>(prefetchStatistics.numBytesRead) / 1048576.0 / prefetchStatistics.readTime.count(), prefetchStatistics.numFrames == 0U ? 0.0 : prefetchStatistics.decodeTime.count() * 1000.0 / static_cast<double>(prefetchStatistics.numFrames), pPrefetcher->numThreads());
+				}
+				if (synthesisStatistics.numFrames != 0U) {
+					ImGui::Text("Input GPU synthesis: %.2f ms per frame (no upload)", synthesisStatistics.time.count() * 1000.0 / static_cast<double>(synthesisStatistics.numFrames));
+				}
+				const TSDFVolume& tsdfVolume = this->_pKinectFusion->tsdfVolume();
+				ImGui::Text("Volume pages: %u / %u resident (%s, %.1f MiB)", tsdfVolume.numResidentPages(), tsdfVolume.numPages(), tsdfVolume.sparse() ? "sparse" : "dense", static_cast<double>(tsdfVolume.numResidentPages()) * static_cast<double>(tsdfVolume.pageSize()) / 1048576.0);
+				ImGui::Text("Color bricks: %u / %u allocated (%u dropped), %.1f MiB (vs %.1f MiB dense)", tsdfVolume.numAllocatedColorBricks(), tsdfVolume.colorBrickCapacity(), tsdfVolume.numDroppedColorBricks(), static_cast<double>(tsdfVolume.colorMemorySize()) / 1048576.0, static_cast<double>(tsdfVolume.denseColorMemorySize()) / 1048576.0);
+				ImGui::Text("Ray casting: %.2f ms per frame", rayCastingStatistics.numFrames == 0U ? 0.0 : rayCastingStatistics.time.count() * 1000.0 / static_cast<double>(rayCastingStatistics.numFrames));
+				if (this->_pKinectFusion->meshCacheEnabled()) {
+					const MeshCache::Statistics& meshStatistics = this->_pKinectFusion->meshCache().statistics();
+					ImGui::Text("Mesh re-meshing (last frame): %u bricks, %.2f ms (%u dropped, %u overflowed)", meshStatistics.numRemeshedBricks, meshStatistics.remeshTime.count() * 1000.0, meshStatistics.numDroppedBricks, meshStatistics.numOverflowedBricks);
+					ImGui::Text("Mesh: %llu triangles, %u / %u slabs (%.1f MiB)", static_cast<unsigned long long>(meshStatistics.numTriangles), meshStatistics.numUsedSlabs, this->_pKinectFusion->meshCache().numSlabs(), static_cast<double>(meshStatistics.memorySize) / 1048576.0);
+				}
+				if (this->_pMapPublisher) {
+					const MapPublisher::Statistics& mapStreamStatistics = this->_pMapPublisher->statistics();
+					ImGui::Text("Map stream: version %llu, %u bricks (%u refreshed, %u pending), %.1f KiB, %.2f ms", static_cast<unsigned long long>(mapStreamStatistics.version), mapStreamStatistics.numBricks, mapStreamStatistics.numRefreshedBricks, mapStreamStatistics.numPendingBricks, static_cast<double>(mapStreamStatistics.numBytes) / 1024.0, mapStreamStatistics.publishTime.count() * 1000.0);
+				}
+				if (this->_pPosePublisher) {
+					ImGui::Text("Pose stream: version %llu", static_cast<unsigned long long>(this->_pPosePublisher->version()));
+					if (this->_pPoseLatencyProbe) {
+						PoseSubscriber::LatencyStatistics latencyStatistics = this->_pPoseLatencyProbe->latencyStatistics();
+						ImGui::SameLine();
+						ImGui::Text("(latency: mean %.1f us, p99 %.0f us)", latencyStatistics.mean.count() * 1.0e6, latencyStatistics.p99.count() * 1.0e6);
+					}
+				}
 				ImGui::TreePop();
 			}
 		}
-		ImGui::End();
+		if (!this->_headlessMode)
+			ImGui::End();
 
 		// Process the new frame
 		if (!eof && frameData.state != FrameState::Invalid) {
-			// Upload the new frame
-			this->_inputMaps[resourceCycleCounter].createTextures(
-				{ {this->_pDataLoader->colorFrameExtent(), this->_pDataLoader->depthFrameExtent()} },
-				{ {frameData.colorMap, frameData.depthMap} },
-				false
-			);
+			if (this->_pSyntheticFrameGenerator) {
+				// Render the new frame directly into the input textures, which are created once in `_initAssets`.
+				std::chrono::steady_clock::time_point synthesisBegin = std::chrono::steady_clock::now();
+				this->_pSyntheticFrameGenerator->generate(this->_inputMaps[resourceCycleCounter], frameData.camera, *frameData.view);
+				synthesisStatistics.time += std::chrono::steady_clock::now() - synthesisBegin;
+				++synthesisStatistics.numFrames;
+			}
+			else {
+				// Upload the new frame. The color map is uploaded in its native format and converted on the GPU.
+				std::chrono::steady_clock::time_point uploadBegin = std::chrono::steady_clock::now();
+				this->_inputMaps[resourceCycleCounter].createTextures(
+					{ {this->_pDataLoader->colorFrameExtent(), this->_pDataLoader->depthFrameExtent()} },
+					{ {frameData.colorMap, frameData.depthMap} },
+					false,
+					this->_pDataLoader->colorFormat()
+				);
+				std::chrono::duration<double> uploadTime = std::chrono::steady_clock::now() - uploadBegin;
+				uploadStatistics.uploadTime += uploadTime;
+				uploadTimeMetric.record(uploadTime);
+				++uploadStatistics.numFrames;
+				uploadStatistics.colorBytes += colorFrameSize(this->_pDataLoader->colorFormat(), this->_pDataLoader->colorFrameExtent());
+				uploadStatistics.rgbaColorBytes += colorFrameSize(ColorFormat::RGBA8888, this->_pDataLoader->colorFrameExtent());
+			}
 			// Estimate the camera pose
-			if (!firstFrame) {
+			if (!firstFrame || localization) {
+				std::vector<jjyou::glsl::mat4> poseHypotheses{};
+				if (this->_arguments.multiHypothesisICP) {
+					// Constant velocity prediction.
+					if (numTrackedFrames >= 2U)
+						poseHypotheses.push_back(lastFrameView * jjyou::glsl::inverse(secondLastFrameView) * lastFrameView);
+					// Rotate the last pose about the camera's x and y axes.
+					constexpr float perturbationAngle = std::numbers::pi_v<float> / 60.0f;
+					for (int axis = 0; axis < 2; ++axis) {
+						for (float angle : { perturbationAngle, -perturbationAngle }) {
+							int i = (axis + 1) % 3, j = (axis + 2) % 3;
+							jjyou::glsl::mat4 rotation(1.0f);
+							rotation[i][i] = std::cos(angle);
+							rotation[i][j] = std::sin(angle);
+							rotation[j][i] = -std::sin(angle);
+							rotation[j][j] = std::cos(angle);
+							poseHypotheses.push_back(rotation * lastFrameView);
+						}
+					}
+				}
+				// The last pose with roll and pitch corrected by the measured gravity is a hypothesis of its own.
+				if (this->_arguments.gravityPrior && frameData.gravity.has_value()) {
+					std::optional<jjyou::glsl::mat4> gravityAlignedView = this->_pKinectFusion->alignGravity(lastFrameView, *frameData.gravity);
+					if (gravityAlignedView.has_value())
+						poseHypotheses.push_back(*gravityAlignedView);
+				}
+				// Without predicted model maps, the volume is ray casted, so the pending fusion must end first.
+				if (!this->_pKinectFusion->modelPredicted())
+					endPendingFusion();
+				// Compare both precisions before the regular estimation, which leaves the state of the configured precision.
+				if (this->_arguments.halfPrecisionCheck) {
+					KinectFusion::HalfPrecisionComparison comparison = this->_pKinectFusion->compareHalfPrecision(
+						this->_inputMaps[resourceCycleCounter],
+						frameData.camera,
+						lastFrameView,
+						this->_arguments.sigmaColor,
+						this->_arguments.sigmaSpace,
+						this->_arguments.filterKernelSize,
+						this->_arguments.distanceThreshold,
+						this->_arguments.angleThreshold,
+						poseHypotheses,
+						this->_arguments.gravityPrior ? frameData.gravity : std::nullopt,
+						this->_arguments.gravityWeight
+					);
+					++halfPrecisionStatistics.numFrames;
+					for (std::uint32_t level = this->_pKinectFusion->trackingLevel(); level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+						halfPrecisionStatistics.maxDepthError[level] = std::max(halfPrecisionStatistics.maxDepthError[level], comparison.maxDepthError[level]);
+						halfPrecisionStatistics.maxNormalError[level] = std::max(halfPrecisionStatistics.maxNormalError[level], comparison.maxNormalError[level]);
+						halfPrecisionStatistics.maxMismatchedPixelRatio = std::max(halfPrecisionStatistics.maxMismatchedPixelRatio, static_cast<float>(comparison.numMismatchedPixels[level]) / static_cast<float>(comparison.numPixels[level]));
+					}
+					if (comparison.trackingMismatch)
+						++halfPrecisionStatistics.numTrackingMismatches;
+					halfPrecisionStatistics.maxRotationError = std::max(halfPrecisionStatistics.maxRotationError, comparison.rotationError);
+					halfPrecisionStatistics.maxTranslationError = std::max(halfPrecisionStatistics.maxTranslationError, comparison.translationError);
+					addKernelTimes(halfPrecisionStatistics.fp32Times, comparison.fp32Times);
+					addKernelTimes(halfPrecisionStatistics.fp16Times, comparison.fp16Times);
+				}
+				std::chrono::steady_clock::time_point trackingBegin = std::chrono::steady_clock::now();
 				std::optional<jjyou::glsl::mat4> estimatedView = this->_pKinectFusion->estimatePose(
 					this->_inputMaps[resourceCycleCounter],
 					frameData.camera,
@@ -286,26 +1041,102 @@ void Application::mainLoop(void) {
 					this->_arguments.sigmaSpace,
 					this->_arguments.filterKernelSize,
 					this->_arguments.distanceThreshold,
-					this->_arguments.angleThreshold
+					this->_arguments.angleThreshold,
+					poseHypotheses,
+					this->_arguments.gravityPrior ? frameData.gravity : std::nullopt,
+					this->_arguments.gravityWeight
 				);
+				std::chrono::duration<double> trackingTime = std::chrono::steady_clock::now() - trackingBegin;
+				icpStatistics.trackingTime += trackingTime;
+				trackingTimeMetric.record(trackingTime);
+				++icpStatistics.numFrames;
+				icpStatistics.numIterations += this->_pKinectFusion->numICPIterations();
+				std::optional<KinectFusion::KernelTimes> kernelTimes = this->_pKinectFusion->kernelTimes();
+				if (kernelTimes.has_value()) {
+					++kernelStatistics.numFrames;
+					addKernelTimes(kernelStatistics.kernelTimes, *kernelTimes);
+					kernelStatistics.sumValidPixelRatio += this->_pKinectFusion->validPixelRatios()[this->_pKinectFusion->trackingLevel()];
+				}
 				if (estimatedView.has_value())
 					currFrameView = *estimatedView;
+				else
+					++icpStatistics.numFailures;
+				// Publish the pose before fusion, so that consumers receive it as early as possible.
+				if (this->_pPosePublisher) {
+					this->_pPosePublisher->publish(PoseStream::Sample{
+						.frameIndex = frameData.frameIndex,
+						.status = estimatedView.has_value() ? PoseStream::TrackingStatus::Tracked : PoseStream::TrackingStatus::Lost,
+						.numICPIterations = this->_pKinectFusion->numICPIterations(),
+						.captureTime = captureTime,
+						.view = currFrameView
+					});
+				}
+				// Absolute trajectory error: distance between the aligned estimated and groundtruth camera positions.
+				if (frameData.view.has_value()) {
+					jjyou::glsl::vec3 estimated = jjyou::glsl::vec3(jjyou::glsl::inverse(currFrameView)[3]);
+					jjyou::glsl::vec3 groundTruth = jjyou::glsl::vec3(jjyou::glsl::inverse(*frameData.view)[3]);
+					Eigen::Vector3d x(estimated.x, estimated.y, estimated.z);
+					Eigen::Vector3d y(groundTruth.x, groundTruth.y, groundTruth.z);
+					++icpStatistics.numGroundTruthFrames;
+					icpStatistics.sumEstimatedPosition += x;
+					icpStatistics.sumGroundTruthPosition += y;
+					icpStatistics.sumSquaredEstimatedPosition += x.squaredNorm();
+					icpStatistics.sumSquaredGroundTruthPosition += y.squaredNorm();
+					icpStatistics.sumCrossCovariance += y * x.transpose();
+				}
 			}
 			else {
 				currFrameView = this->_pDataLoader->initialPose();
+				if (this->_pPosePublisher) {
+					this->_pPosePublisher->publish(PoseStream::Sample{
+						.frameIndex = frameData.frameIndex,
+						.status = PoseStream::TrackingStatus::Initial,
+						.captureTime = captureTime,
+						.view = currFrameView
+					});
+				}
+			}
+			// Fuse the new frame. With pipelined tracking, it is fused after the visualization.
+			if (!this->_arguments.pipelinedTracking && !localization) {
+				std::chrono::steady_clock::time_point fusionBegin = std::chrono::steady_clock::now();
+				this->_pKinectFusion->fuse(
+					this->_inputMaps[resourceCycleCounter],
+					frameData.camera,
+					currFrameView,
+					this->_arguments.gravityPrior ? frameData.gravity : std::nullopt
+				);
+				std::chrono::duration<double> fusionTime = std::chrono::steady_clock::now() - fusionBegin;
+				fusionStatistics.time += fusionTime;
+				++fusionStatistics.numFrames;
+				fusionTimeMetric.record(fusionTime);
+				onFused(frameData.frameIndex, frameData.camera, currFrameView);
 			}
-			// Fuse the new frame
-			this->_pKinectFusion->fuse(
-				this->_inputMaps[resourceCycleCounter],
-				frameData.camera,
-				currFrameView
-			);
 		}
+		// The volume is accessed from here on, so the fusion that overlapped with tracking must end.
+		endPendingFusion();
 
 		// Reset the volume if requested
 		if (ui.fusion.resetVolume) {
 			ui.fusion.resetVolume = false;
-			this->_pKinectFusion->initTSDFVolume();
+			// The versions in flight still read the volume.
+			if (this->_pMapPublisher)
+				this->_pMapPublisher->reset();
+			// In localization mode, the saved volume is reloaded.
+			if (localization)
+				this->_pKinectFusion->loadTSDFVolume(*this->_arguments.localizePath);
+			else
+				this->_pKinectFusion->initTSDFVolume();
+			modelEmpty = true;
+		}
+
+		// Export the mesh if requested
+		if (ui.fusion.exportMesh) {
+			ui.fusion.exportMesh = false;
+			this->_exportMesh();
+		}
+		if (ui.fusion.exportPointCloud) {
+			ui.fusion.exportPointCloud = false;
+			this->_exportPointCloud();
 		}
 
 		// Track camera
@@ -324,27 +1155,51 @@ void Application::mainLoop(void) {
 			);
 		}
 
-		// Ray casting for visualization
-		// Resize the ray casting map if its size does not match the window framebuffer
-		Camera rayCastingCamera = this->_pEngine->getCamera();
-		vk::Extent2D rayCastingExtent = vk::Extent2D(rayCastingCamera.width, rayCastingCamera.height);
-		if (this->_rayCastingMaps[resourceCycleCounter].texture(0).extent() != rayCastingExtent)
-			this->_rayCastingMaps[resourceCycleCounter].createTextures(
-				{ {rayCastingExtent, rayCastingExtent, rayCastingExtent} },
-				std::nullopt,
-				false
+		// Ray casting for visualization. There is nothing to visualize in headless mode.
+		if (!this->_headlessMode) {
+			// Resize the ray casting map if its size does not match the window framebuffer
+			Camera rayCastingCamera = this->_pEngine->getCamera();
+			vk::Extent2D rayCastingExtent = vk::Extent2D(rayCastingCamera.width, rayCastingCamera.height);
+			if (this->_rayCastingMaps[resourceCycleCounter].texture(0).extent() != rayCastingExtent)
+				this->_rayCastingMaps[resourceCycleCounter].createTextures(
+					{ {rayCastingExtent, rayCastingExtent, rayCastingExtent} },
+					std::nullopt,
+					false
+				);
+			// Ray casting
+			std::chrono::steady_clock::time_point rayCastingBegin = std::chrono::steady_clock::now();
+			this->_pKinectFusion->rayCasting(
+				this->_rayCastingMaps[resourceCycleCounter],
+				rayCastingCamera,
+				this->_pEngine->window().getViewMatrix(),
+				rayCastingCamera.zNear, rayCastingCamera.zFar,
+				10000.0f,
+				std::nullopt
 			);
-		// Ray casting
-		this->_pKinectFusion->rayCasting(
-			this->_rayCastingMaps[resourceCycleCounter],
-			rayCastingCamera,
-			this->_pEngine->window().getViewMatrix(),
-			rayCastingCamera.zNear, rayCastingCamera.zFar,
-			10000.0f,
-			std::nullopt
-		);
-
-		// Display ray casting maps or input frames
+			std::chrono::duration<double> rayCastingTime = std::chrono::steady_clock::now() - rayCastingBegin;
+			++rayCastingStatistics.numFrames;
+			rayCastingStatistics.time += rayCastingTime;
+			rayCastingTimeMetric.record(rayCastingTime);
+		}
+
+		// Start fusing the new frame. It runs on the compute queue until the next frame is tracked.
+		// The model maps are predicted before fusion every `lag` frames, except from an empty volume.
+		if (this->_arguments.pipelinedTracking && !eof && frameData.state != FrameState::Invalid) {
+			bool predictModel = !modelEmpty && ++numFramesSinceModelPrediction >= static_cast<std::uint32_t>(this->_arguments.pipelinedTrackingLag);
+			if (predictModel)
+				numFramesSinceModelPrediction = 0U;
+			this->_pKinectFusion->beginFuse(
+				this->_inputMaps[resourceCycleCounter],
+				frameData.camera,
+				currFrameView,
+				this->_arguments.gravityPrior ? frameData.gravity : std::nullopt,
+				predictModel
+			);
+			pendingFusion = FusedFrame{ .frameIndex = frameData.frameIndex, .camera = frameData.camera, .view = currFrameView };
+			modelEmpty = false;
+		}
+
+		// Display ray casting maps or input frames. The engine discards draws in headless mode.
 		if (!ui.visualization.displayInputFrames) {
 			this->_pEngine->drawSurface(this->_rayCastingMaps[resourceCycleCounter]);
 		}
@@ -369,6 +1224,11 @@ void Application::mainLoop(void) {
 			this->_pEngine->drawPrimitives(this->_arSphere, model);
 		}
 
+		// Draw the mesh of the model
+		if (ui.visualization.drawMesh && this->_pKinectFusion->meshCacheEnabled()) {
+			this->_pEngine->drawPrimitives(this->_pKinectFusion->meshCache(), jjyou::glsl::mat4(1.0f));
+		}
+
 		// Draw world space axis
 		this->_pEngine->drawPrimitives(this->_axis, jjyou::glsl::mat4(1.0f));
 
@@ -386,14 +1246,277 @@ void Application::mainLoop(void) {
 		}
 
 		// Record command buffer and present frame.
+		std::size_t numPrimitivesToDraw = this->_pEngine->numPrimitivesToDraw();
 		this->_pEngine->recordCommandbuffer();
 		this->_pEngine->presentFrame();
-		this->_pEngine->window().pollEvents();
+		if (!this->_headlessMode)
+			this->_pEngine->window().pollEvents();
+		if (this->_pScalabilityMonitor) {
+			// The pages of a sparse volume are allocated one by one as the scene is explored.
+			const TSDFVolume& tsdfVolume = this->_pKinectFusion->tsdfVolume();
+			std::uint32_t numPageAllocations = tsdfVolume.sparse() ? tsdfVolume.numResidentPages() : 0U;
+			this->_pScalabilityMonitor->recordFrame(std::chrono::steady_clock::now() - now, this->_pEngine->fenceWaitTime() - fenceWaitBegin, numPrimitivesToDraw, numPageAllocations, numPageAllocations * tsdfVolume.pageSize());
+		}
 		if (!eof)
 			resourceCycleCounter = (resourceCycleCounter + 1) % Engine::NUM_FRAMES_IN_FLIGHT;
+		if (!eof && frameData.state != FrameState::Invalid) {
+			++numTrackedFrames;
+			lastFrameCamera = frameData.camera;
+			secondLastFrameView = lastFrameView;
+			std::chrono::duration<double> frameTime = std::chrono::steady_clock::now() - now;
+			++icpStatistics.numProcessedFrames;
+			icpStatistics.processingTime += frameTime;
+			framesProcessedMetric.add();
+			frameTimeMetric.record(frameTime);
+		}
 		firstFrame = false;
 		lastFrameView = currFrameView;
 	}
+	endPendingFusion();
+	if (this->_pMapPublisher)
+		this->_pMapPublisher->flush();
+	if (uploadStatistics.numFrames != 0U) {
+		double numUploadedFrames = static_cast<double>(uploadStatistics.numFrames);
+		std::cout << "[Application] Color upload (" << to_string(this->_pDataLoader->colorFormat()) << "): "
+			<< static_cast<double>(uploadStatistics.colorBytes) / numUploadedFrames << " bytes per frame, "
+			<< static_cast<double>(uploadStatistics.rgbaColorBytes - uploadStatistics.colorBytes) / numUploadedFrames << " bytes saved vs RGBA8888; CPU time "
+			<< uploadStatistics.loadTime.count() * 1000.0 / numUploadedFrames << " ms load, "
+			<< uploadStatistics.uploadTime.count() * 1000.0 / numUploadedFrames << " ms upload per frame." << std::endl;
+	}
+	if (uploadStatistics.loadTime.count() != 0.0) {
+		// Compare the archives with the extracted folders.
+		std::cout << "[Application] Time to first frame: "
+			<< (this->_dataLoaderCreationTime + uploadStatistics.firstLoadTime).count() * 1000.0 << " ms ("
+			<< this->_dataLoaderCreationTime.count() * 1000.0 << " ms to create the data loader";
+		if (const TUMDataset* pTUMDataset = dynamic_cast<const TUMDataset*>(this->_pDataLoader.get()); pTUMDataset && pTUMDataset->archive())
+			std::cout << ", including " << pTUMDataset->archive()->indexTime().count() * 1000.0 << " ms to index " << pTUMDataset->archive()->numMembers() << " archive members";
+		std::cout << ")." << std::endl;
+	}
+	if (const FramePrefetcher* pPrefetcher = this->_pDataLoader->prefetcher()) {
+		// The load time per frame above is the time the main loop waits for a frame.
+		// The sustained rate is bounded by the reader thread and by the decoding threads, whichever is slower.
+		// The ingest rate is the number of decoded frames over the wall-clock time, including the waits for free slots.
+		FramePrefetcher::Statistics prefetchStatistics = pPrefetcher->statistics();
+		if (prefetchStatistics.numFrames != 0U) {
+			double numPrefetchedFrames = static_cast<double>(prefetchStatistics.numFrames);
+			double frameTime = std::max(prefetchStatistics.readTime.count() / numPrefetchedFrames, prefetchStatistics.decodeTime.count() / numPrefetchedFrames / static_cast<double>(pPrefetcher->numThreads()));
+			std::cout << "[Application] Prefetch: " << prefetchStatistics.numFrames << " frames, "
+				<< static_cast<double>(prefetchStatistics.numBytesRead) / 1048576.0 << " MiB read at "
+				<< (prefetchStatistics.readTime.count() == 0.0 ? 0.0 : static_cast<double>(prefetchStatistics.numBytesRead) / 1048576.0 / prefetchStatistics.readTime.count()) << " MiB/s, decode "
+				<< prefetchStatistics.decodeTime.count() * 1000.0 / numPrefetchedFrames << " ms per frame on " << pPrefetcher->numThreads() << " threads, wait "
+				<< prefetchStatistics.waitTime.count() * 1000.0 / numPrefetchedFrames << " ms per frame, sustained "
+				<< (frameTime == 0.0 ? 0.0 : 1.0 / frameTime) << " frames/s, ingest "
+				<< (prefetchStatistics.elapsedTime.count() == 0.0 ? 0.0 : static_cast<double>(prefetchStatistics.numDecodedFrames) / prefetchStatistics.elapsedTime.count()) << " frames/s." << std::endl;
+		}
+	}
+	if (synthesisStatistics.numFrames != 0U) {
+		std::cout << "[Application] Input GPU synthesis: "
+			<< synthesisStatistics.time.count() * 1000.0 / static_cast<double>(synthesisStatistics.numFrames) << " ms per frame, "
+			<< synthesisStatistics.numFrames << " frames without upload." << std::endl;
+	}
+	if (meshCacheStatistics.numUpdates != 0U) {
+		const MeshCache::Statistics& meshStatistics = this->_pKinectFusion->meshCache().statistics();
+		std::cout << "[Application] Mesh cache: "
+			<< static_cast<double>(meshCacheStatistics.numRemeshedBricks) / static_cast<double>(meshCacheStatistics.numUpdates) << " bricks, "
+			<< meshCacheStatistics.remeshTime.count() * 1000.0 / static_cast<double>(meshCacheStatistics.numUpdates) << " ms re-meshed per frame; "
+			<< meshStatistics.numTriangles << " triangles in " << meshStatistics.numUsedSlabs << " / " << this->_pKinectFusion->meshCache().numSlabs() << " slabs, "
+			<< static_cast<double>(meshStatistics.memorySize) / 1048576.0 << " MiB." << std::endl;
+	}
+	{
+		const TSDFVolume& tsdfVolume = this->_pKinectFusion->tsdfVolume();
+		std::cout << "[Application] Color bricks: " << tsdfVolume.numAllocatedColorBricks() << " / " << tsdfVolume.colorBrickCapacity() << " allocated, "
+			<< tsdfVolume.numDroppedColorBricks() << " dropped; "
+			<< static_cast<double>(tsdfVolume.colorMemorySize()) / 1048576.0 << " MiB vs "
+			<< static_cast<double>(tsdfVolume.denseColorMemorySize()) / 1048576.0 << " MiB with a color per voxel";
+		if (rayCastingStatistics.numFrames != 0U)
+			std::cout << "; ray casting " << rayCastingStatistics.time.count() * 1000.0 / static_cast<double>(rayCastingStatistics.numFrames) << " ms per frame";
+		std::cout << "." << std::endl;
+	}
+	if (this->_pMetricsExporter) {
+		MetricsExporter::Statistics exportStatistics = this->_pMetricsExporter->statistics();
+		double meanExportTime = exportStatistics.numExports == 0U ? 0.0 : exportStatistics.exportTime.count() / static_cast<double>(exportStatistics.numExports);
+		std::cout << "[Application] Metrics: " << exportStatistics.numExports << " exports (" << exportStatistics.numFailures << " failed), "
+			<< meanExportTime * 1000.0 << " ms per export (max " << exportStatistics.maxExportTime.count() * 1000.0 << " ms, "
+			<< meanExportTime / this->_pMetricsExporter->period().count() * 100.0 << "% of the period), "
+			<< MetricsRegistry::measureUpdateTime().count() * 1.0e9 << " ns per hot path update." << std::endl;
+	}
+	if (this->_pPoseLatencyProbe) {
+		PoseSubscriber::LatencyStatistics latencyStatistics = this->_pPoseLatencyProbe->latencyStatistics();
+		std::cout << "[Application] Pose stream latency: " << latencyStatistics.numSamples << " / " << this->_pPosePublisher->version() << " poses read, mean "
+			<< latencyStatistics.mean.count() * 1.0e6 << " us, p50 "
+			<< latencyStatistics.p50.count() * 1.0e6 << " us, p99 "
+			<< latencyStatistics.p99.count() * 1.0e6 << " us, max "
+			<< latencyStatistics.max.count() * 1.0e6 << " us." << std::endl;
+	}
+	if (this->_arguments.batchRayCastingBenchmark != 0 && numTrackedFrames != 0U) {
+		this->_benchmarkBatchRayCasting(lastFrameCamera, lastFrameView);
+	}
+	if (this->_arguments.exportMeshPath.has_value()) {
+		this->_exportMesh();
+	}
+	if (this->_arguments.exportPointCloudPath.has_value()) {
+		this->_exportPointCloud();
+	}
+	if (icpStatistics.numFrames != 0U) {
+		std::cout << "[Application] ICP: " << static_cast<double>(icpStatistics.numIterations) / static_cast<double>(icpStatistics.numFrames)
+			<< " iterations per frame, " << icpStatistics.numFailures << " / " << icpStatistics.numFrames << " failed"
+			<< " (gravity prior " << (this->_arguments.gravityPrior ? "on" : "off") << ")." << std::endl;
+		std::cout << "[Application] Tracking at level " << this->_pKinectFusion->trackingLevel();
+		if (this->_arguments.pipelinedTracking)
+			std::cout << " (pipelined, lag " << this->_arguments.pipelinedTrackingLag << ")";
+		std::cout << ": " << icpStatistics.trackingTime.count() * 1000.0 / static_cast<double>(icpStatistics.numFrames) << " ms per frame";
+		if (icpStatistics.numGroundTruthFrames != 0U)
+			std::cout << ", ATE RMSE " << absoluteTrajectoryError() << " m (aligned)";
+		std::cout << ", throughput " << static_cast<double>(icpStatistics.numProcessedFrames) / icpStatistics.processingTime.count() << " frames/s." << std::endl;
+	}
+	if (localization) {
+		const KinectFusion::ModelMapCacheStatistics& cacheStatistics = this->_pKinectFusion->modelMapCacheStatistics();
+		std::cout << "[Application] Localization: " << cacheStatistics.numHits << " / " << cacheStatistics.numHits + cacheStatistics.numMisses << " frames reused the model maps of "
+			<< cacheStatistics.numKeyframes << " keyframes (" << cacheStatistics.numEvictions << " evicted)";
+		if (icpStatistics.numFrames != 0U)
+			std::cout << "; tracking " << icpStatistics.trackingTime.count() * 1000.0 / static_cast<double>(icpStatistics.numFrames) << " ms per frame without fusion";
+		std::cout << "." << std::endl;
+	}
+	else if (fusionStatistics.numFrames != 0U) {
+		std::cout << "[Application] Fusion: " << fusionStatistics.time.count() * 1000.0 / static_cast<double>(fusionStatistics.numFrames) << " ms per frame";
+		if (icpStatistics.numFrames != 0U)
+			std::cout << ", tracking and fusion " << (icpStatistics.trackingTime + fusionStatistics.time).count() * 1000.0 / static_cast<double>(icpStatistics.numFrames) << " ms per frame";
+		std::cout << "." << std::endl;
+	}
+	if (this->_arguments.saveVolumePath.has_value()) {
+		std::chrono::steady_clock::time_point saveBegin = std::chrono::steady_clock::now();
+		this->_pKinectFusion->saveTSDFVolume(*this->_arguments.saveVolumePath);
+		std::cout << "[Application] Saved volume " << *this->_arguments.saveVolumePath << " in "
+			<< std::chrono::duration<double>(std::chrono::steady_clock::now() - saveBegin).count() << " s ("
+			<< static_cast<double>(std::filesystem::file_size(*this->_arguments.saveVolumePath)) / 1048576.0 << " MiB)." << std::endl;
+	}
+	if (kernelStatistics.numFrames != 0U) {
+		double numFrames = static_cast<double>(kernelStatistics.numFrames);
+		const KinectFusion::KernelTimes& kernelTimes = kernelStatistics.kernelTimes;
+		std::cout << "[Application] Kernel GPU time (" << (this->_pKinectFusion->halfPrecision() ? "fp16" : "fp32") << "): "
+			<< kernelTimes.bilateralFiltering.count() * 1000.0 / numFrames << " ms bilateral filtering, "
+			<< kernelTimes.halfSampling.count() * 1000.0 / numFrames << " ms half sampling, "
+			<< kernelTimes.compactValidPixels.count() * 1000.0 / numFrames << " ms compaction, "
+			<< kernelTimes.computeVertexMap.count() * 1000.0 / numFrames << " ms vertex map, "
+			<< kernelTimes.computeNormalMap.count() * 1000.0 / numFrames << " ms normal map, "
+			<< kernelTimes.buildLinearFunction.count() * 1000.0 / numFrames << " ms linear function per frame." << std::endl;
+		// The stages after the compaction only launch work groups for the valid pixels.
+		std::cout << "[Application] Compaction: "
+			<< kernelTimes.compactValidPixels.count() * 1000.0 / numFrames << " ms per frame, against "
+			<< (kernelTimes.computeVertexMap + kernelTimes.computeNormalMap + kernelTimes.buildLinearFunction).count() * 1000.0 / numFrames << " ms of the compacted stages, "
+			<< kernelStatistics.sumValidPixelRatio * 100.0 / numFrames << "% valid pixels at the tracking level." << std::endl;
+	}
+	if (halfPrecisionStatistics.numFrames != 0U) {
+		double numFrames = static_cast<double>(halfPrecisionStatistics.numFrames);
+		float maxDepthError = *std::max_element(halfPrecisionStatistics.maxDepthError.begin(), halfPrecisionStatistics.maxDepthError.end());
+		float maxNormalError = *std::max_element(halfPrecisionStatistics.maxNormalError.begin(), halfPrecisionStatistics.maxNormalError.end());
+		bool passed =
+			maxDepthError <= KinectFusion::HALF_PRECISION_MAX_DEPTH_ERROR &&
+			maxNormalError <= KinectFusion::HALF_PRECISION_MAX_NORMAL_ERROR &&
+			halfPrecisionStatistics.maxMismatchedPixelRatio <= KinectFusion::HALF_PRECISION_MAX_MISMATCHED_PIXEL_RATIO &&
+			halfPrecisionStatistics.numTrackingMismatches == 0U &&
+			halfPrecisionStatistics.maxRotationError <= KinectFusion::HALF_PRECISION_MAX_ROTATION_ERROR &&
+			halfPrecisionStatistics.maxTranslationError <= KinectFusion::HALF_PRECISION_MAX_TRANSLATION_ERROR;
+		std::cout << "[Application] Half precision check over " << halfPrecisionStatistics.numFrames << " frames: "
+			<< "max depth error " << maxDepthError << " m, max normal error " << maxNormalError << " rad, "
+			<< "max mismatched pixels " << halfPrecisionStatistics.maxMismatchedPixelRatio * 100.0f << "%, "
+			<< halfPrecisionStatistics.numTrackingMismatches << " tracking mismatches, "
+			<< "max pose error " << halfPrecisionStatistics.maxRotationError << " rad / " << halfPrecisionStatistics.maxTranslationError << " m; "
+			<< "kernels " << totalKernelTime(halfPrecisionStatistics.fp16Times).count() * 1000.0 / numFrames << " ms fp16 vs "
+			<< totalKernelTime(halfPrecisionStatistics.fp32Times).count() * 1000.0 / numFrames << " ms fp32 per frame. "
+			<< (passed ? "PASSED" : "FAILED") << "." << std::endl;
+		if (!passed)
+			this->_succeeded = false;
+	}
+}
+
+void Application::_exportMesh(void) {
+	const std::vector<int>& budgets = this->_arguments.exportMeshBudgets;
+	std::filesystem::path basePath(*this->_arguments.exportMeshPath);
+	for (int budget : budgets) {
+		std::filesystem::path path = basePath;
+		if (budgets.size() > 1)
+			path.replace_filename(basePath.stem().string() + "_" + std::to_string(budget) + basePath.extension().string());
+		// Weld the triangles slab by slab from the staging memory, without downloading the vertex soup first.
+		MeshDecimator decimator;
+		std::chrono::steady_clock::time_point downloadBegin = std::chrono::steady_clock::now();
+		this->_pKinectFusion->meshCache().download([&decimator](const Vertex<MaterialType::Lambertian>* vertices_, std::uint32_t numVertices_) {
+			decimator.addTriangles(vertices_, numVertices_);
+		});
+		std::chrono::duration<double> downloadTime = std::chrono::steady_clock::now() - downloadBegin;
+		decimator.decimate(MeshDecimator::Parameters{
+			.targetTriangles = static_cast<std::uint64_t>(std::max(budget, 0)),
+			.maxError = this->_arguments.exportMeshMaxError,
+			.numThreads = static_cast<std::uint32_t>(std::max(this->_arguments.exportMeshThreads, 0))
+		});
+		std::chrono::steady_clock::time_point writeBegin = std::chrono::steady_clock::now();
+		std::uint64_t numBytes = decimator.write(path);
+		std::chrono::duration<double> writeTime = std::chrono::steady_clock::now() - writeBegin;
+		const MeshDecimator::Statistics& statistics = decimator.statistics();
+		std::cout << "[Application] Exported mesh " << path.string() << " (budget " << budget << "): "
+			<< statistics.numInputTriangles << " -> " << statistics.numOutputTriangles << " triangles, "
+			<< statistics.numOutputVertices << " vertices; "
+			<< downloadTime.count() * 1000.0 << " ms download, "
+			<< statistics.decimationTime.count() * 1000.0 << " ms decimation (" << statistics.numPartitions << " partitions), "
+			<< writeTime.count() * 1000.0 << " ms write, "
+			<< static_cast<double>(numBytes) / 1048576.0 << " MiB." << std::endl;
+	}
+}
+
+void Application::_benchmarkBatchRayCasting(const Camera& camera_, const jjyou::glsl::mat4& view_) {
+	// Thumbnails of 160 pixels wide, looking around the camera like the faces of a cube map.
+	std::uint32_t numViews = static_cast<std::uint32_t>(this->_arguments.batchRayCastingBenchmark);
+	constexpr int numRepetitions = 10;
+	Camera camera = camera_;
+	camera.resize(vk::Extent2D(160U, std::max(camera_.height * 160U / std::max(camera_.width, 1U), 1U)));
+	vk::Extent2D extent(camera.width, camera.height);
+	std::vector<Surface<MaterialType::Lambertian>> surfaces{};
+	std::vector<const Surface<MaterialType::Lambertian>*> pSurfaces{};
+	std::vector<Camera> cameras(numViews, camera);
+	std::vector<jjyou::glsl::mat4> views{};
+	surfaces.reserve(numViews);
+	for (std::uint32_t i = 0; i < numViews; ++i) {
+		surfaces.push_back(this->_pEngine->createSurface<MaterialType::Lambertian>());
+		surfaces.back().createTextures({ {extent, extent, extent} }, std::nullopt, false);
+		pSurfaces.push_back(&surfaces.back());
+		float angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(i) / static_cast<float>(numViews);
+		jjyou::glsl::mat4 rotation(1.0f);
+		rotation[0][0] = std::cos(angle);
+		rotation[0][2] = -std::sin(angle);
+		rotation[2][0] = std::sin(angle);
+		rotation[2][2] = std::cos(angle);
+		views.push_back(rotation * view_);
+	}
+	float minDepth = this->_pDataLoader->minDepth();
+	float maxDepth = this->_pDataLoader->maxDepth();
+	std::chrono::steady_clock::time_point sequentialBegin = std::chrono::steady_clock::now();
+	for (int repetition = 0; repetition < numRepetitions; ++repetition) {
+		for (std::uint32_t i = 0; i < numViews; ++i)
+			this->_pKinectFusion->rayCasting(surfaces[i], cameras[i], views[i], minDepth, maxDepth, 10000.0f, std::nullopt);
+	}
+	std::chrono::duration<double> sequentialTime = std::chrono::steady_clock::now() - sequentialBegin;
+	std::chrono::steady_clock::time_point batchBegin = std::chrono::steady_clock::now();
+	for (int repetition = 0; repetition < numRepetitions; ++repetition) {
+		this->_pKinectFusion->batchRayCasting(pSurfaces, cameras, views, minDepth, maxDepth, 10000.0f, std::nullopt);
+	}
+	std::chrono::duration<double> batchTime = std::chrono::steady_clock::now() - batchBegin;
+	std::cout << "[Application] Ray casting " << numViews << " views of " << extent.width << "x" << extent.height << ": "
+		<< batchTime.count() * 1000.0 / numRepetitions << " ms batched vs "
+		<< sequentialTime.count() * 1000.0 / numRepetitions << " ms one by one ("
+		<< sequentialTime.count() / batchTime.count() << "x)." << std::endl;
+}
+
+void Application::_exportPointCloud(void) {
+	KinectFusion::PointCloudStatistics statistics = this->_pKinectFusion->exportPointCloud(
+		*this->_arguments.exportPointCloudPath,
+		static_cast<vk::DeviceSize>(std::max(this->_arguments.exportPointCloudStagingBudget, 1)) << 20
+	);
+	std::cout << "[Application] Exported point cloud " << *this->_arguments.exportPointCloudPath << ": "
+		<< statistics.numPoints << " points in " << statistics.numChunks << " chunks (" << statistics.numRetries << " retried); "
+		<< statistics.extractionTime.count() * 1000.0 << " ms extraction, "
+		<< statistics.writeWaitTime.count() * 1000.0 << " ms waiting for writes, "
+		<< statistics.totalTime.count() * 1000.0 << " ms total, "
+		<< static_cast<double>(statistics.numBytes) / 1048576.0 << " MiB." << std::endl;
 }
 
 void Application::_initAssets(void) {
@@ -478,7 +1601,8 @@ void Application::_initAssets(void) {
 
 	// Ray casting maps
 	{
-		std::pair<int, int> framebufferSize = this->_pEngine->window().framebufferSize();
+		// The maps are only resized to the window framebuffer, so any size works in headless mode.
+		std::pair<int, int> framebufferSize = this->_headlessMode ? std::pair<int, int>(800, 600) : this->_pEngine->window().framebufferSize();
 		vk::Extent2D rayCastingExtent = vk::Extent2D(static_cast<std::uint32_t>(framebufferSize.first), static_cast<std::uint32_t>(framebufferSize.second));
 		this->_rayCastingMaps.reserve(static_cast<std::size_t>(Engine::NUM_FRAMES_IN_FLIGHT));
 		for (std::uint32_t i = 0; i < Engine::NUM_FRAMES_IN_FLIGHT; ++i) {
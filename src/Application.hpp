@@ -2,7 +2,15 @@
 #include "Engine.hpp"
 #include "KinectFusion.hpp"
 #include "DataLoader.hpp"
+#include "ScalabilityMonitor.hpp"
+#include "MapStream.hpp"
+#include "PoseStream.hpp"
+#include "SyntheticFrameGenerator.hpp"
+#include "Metrics.hpp"
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 /***********************************************************************
  * @class	Application
@@ -20,6 +28,12 @@ public:
 	  */
 	void mainLoop(void);
 
+	/** @brief	Check whether the application finished successfully.
+	  *			Returns `false` if the scalability test detected drift or failures,
+	  *			or if the half precision check exceeded its tolerances.
+	  */
+	bool succeeded(void) const { return this->_succeeded; }
+
 	/** @brief	Disable copy/move constructor/assignment.
 	  */
 	Application(const Application&) = delete;
@@ -37,16 +51,40 @@ private:
 
 	bool _headlessMode = false;
 	bool _debugMode = false;
+	bool _succeeded = true;
 	struct Arguments {
 		float sigmaColor{};
 		float sigmaSpace{};
 		int filterKernelSize{};
 		float distanceThreshold{};
 		float angleThreshold{};
+		bool multiHypothesisICP{};
+		bool pipelinedTracking{};
+		int pipelinedTrackingLag{};
+		bool halfPrecisionCheck{};
+		bool gravityPrior{};
+		float gravityWeight{};
+		std::optional<std::string> exportMeshPath{};
+		std::vector<int> exportMeshBudgets{};
+		float exportMeshMaxError{};
+		int exportMeshThreads{};
+		std::optional<std::string> exportPointCloudPath{};
+		int exportPointCloudStagingBudget{};
+		std::optional<std::string> saveVolumePath{};
+		std::optional<std::string> localizePath{};
+		int batchRayCastingBenchmark{};
 	} _arguments{};
+	std::unique_ptr<MetricsRegistry> _pMetrics{};	// Declared first, so that it outlives the components that update it.
+	std::unique_ptr<MetricsExporter> _pMetricsExporter{};
 	std::unique_ptr<Engine> _pEngine{};
 	std::unique_ptr<DataLoader> _pDataLoader{};
+	std::chrono::duration<double> _dataLoaderCreationTime{}; // Part of the time to the first frame.
 	std::unique_ptr<KinectFusion> _pKinectFusion{};
+	std::unique_ptr<SyntheticFrameGenerator> _pSyntheticFrameGenerator{};
+	std::unique_ptr<ScalabilityMonitor> _pScalabilityMonitor{};
+	std::unique_ptr<MapPublisher> _pMapPublisher{};
+	std::unique_ptr<PosePublisher> _pPosePublisher{};
+	std::unique_ptr<PoseLatencyProbe> _pPoseLatencyProbe{};
 	std::string _physicalDeviceName{};
 	Primitives<MaterialType::Simple, PrimitiveType::Line> _axis{ nullptr };
 	Primitives<MaterialType::Lambertian, PrimitiveType::Triangle> _arSphere{ nullptr };
@@ -57,6 +95,19 @@ private:
 	std::vector<Surface<MaterialType::Simple>> _arSurfaces{};
 
 	void _initAssets(void);
+	void _mainLoop(void);
+
+	/** @brief	Decimate the mesh of the mesh cache to each triangle budget and write it to `--export-mesh`.
+	  */
+	void _exportMesh(void);
+
+	/** @brief	Extract the oriented point cloud of the volume and write it to `--export-point-cloud`.
+	  */
+	void _exportPointCloud(void);
+
+	/** @brief	Ray cast `--ray-casting.batch-benchmark` thumbnails around a camera pose one by one and in one batch, and print both times.
+	  */
+	void _benchmarkBatchRayCasting(const Camera& camera_, const jjyou::glsl::mat4& view_);
 	static void _updateCameraFrame(
 		Primitives<MaterialType::Simple, PrimitiveType::Line>& cameraFrame_,
 		Primitives<MaterialType::Simple, PrimitiveType::Line>& grayCameraFrame_,
@@ -3,6 +3,12 @@
 #include <stdexcept>
 #include <numbers>
 #include <fstream>
+#include <random>
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <string>
 #include <stb_image.h>
 
 VirtualDataLoader::VirtualDataLoader(
@@ -78,11 +84,175 @@ FrameData VirtualDataLoader::getFrame(void) {
 	return res;
 }
 
+ProceduralDataLoader::ProceduralDataLoader(
+	vk::Extent2D extent_,
+	jjyou::glsl::vec3 sceneSize_,
+	jjyou::glsl::uvec2 numPillars_,
+	std::uint32_t period_,
+	std::uint32_t seed_,
+	float windowRatio_,
+	bool hostRendering_
+) : DataLoader(), _extent(extent_), _sceneSize(sceneSize_), _period(period_), _windowRatio(windowRatio_), _hostRendering(hostRendering_)
+{
+	if (this->_period == 0U)
+		throw std::logic_error("[ProceduralDataLoader] The trajectory period must be positive.");
+	this->_camera = Camera::fromGraphics(std::nullopt, std::numbers::pi_v<float> / 3.0f, this->minDepth(), this->maxDepth(), this->_extent.width, this->_extent.height);
+	// Place the pillars on a jittered grid in the inner half of the room,
+	// so that they never block the trajectory.
+	std::mt19937 randomEngine(seed_);
+	std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+	jjyou::glsl::vec3 halfSize = this->_sceneSize * 0.5f;
+	jjyou::glsl::vec2 cellSize(
+		halfSize.x / static_cast<float>(std::max(numPillars_.x, 1U)),
+		halfSize.z / static_cast<float>(std::max(numPillars_.y, 1U))
+	);
+	this->_pillars.reserve(static_cast<std::size_t>(numPillars_.x) * static_cast<std::size_t>(numPillars_.y));
+	for (std::uint32_t i = 0; i < numPillars_.x; ++i)
+		for (std::uint32_t j = 0; j < numPillars_.y; ++j) {
+			float width = (0.3f + 0.4f * uniform(randomEngine)) * std::min(cellSize.x, cellSize.y);
+			float height = (0.3f + 0.7f * uniform(randomEngine)) * this->_sceneSize.y;
+			jjyou::glsl::vec2 center(
+				-0.5f * halfSize.x + (static_cast<float>(i) + 0.25f + 0.5f * uniform(randomEngine)) * cellSize.x,
+				-0.5f * halfSize.z + (static_cast<float>(j) + 0.25f + 0.5f * uniform(randomEngine)) * cellSize.y
+			);
+			Box pillar{};
+			pillar.minCorner = jjyou::glsl::vec3(center.x - 0.5f * width, -halfSize.y, center.y - 0.5f * width);
+			pillar.maxCorner = jjyou::glsl::vec3(center.x + 0.5f * width, -halfSize.y + height, center.y + 0.5f * width);
+			pillar.color = FrameData::ColorPixel(
+				static_cast<unsigned char>(64.0f + 191.0f * uniform(randomEngine)),
+				static_cast<unsigned char>(64.0f + 191.0f * uniform(randomEngine)),
+				static_cast<unsigned char>(64.0f + 191.0f * uniform(randomEngine)),
+				255
+			);
+			this->_pillars.push_back(pillar);
+		}
+	if (!this->_hostRendering)
+		return;
+	this->_colorMap.reset(new FrameData::ColorPixel[this->_extent.width * this->_extent.height]{});
+	this->_depthMap.reset(new FrameData::DepthPixel[this->_extent.width * this->_extent.height]{});
+}
+
+FrameData ProceduralDataLoader::getFrame(void) {
+	FrameData res{};
+	res.state = FrameState::Valid;
+	res.frameIndex = this->_frameIndex;
+	res.colorMap = this->_colorMap.get();
+	res.depthMap = this->_depthMap.get();
+	res.camera = this->_camera;
+	res.view = this->_getView(this->_frameIndex);
+	if (!this->_hostRendering) {
+		++this->_frameIndex;
+		return res;
+	}
+	jjyou::glsl::mat3 invProjection = jjyou::glsl::inverse(this->_camera.getVisionProjection());
+	jjyou::glsl::mat4 invView = jjyou::glsl::inverse(*res.view);
+	jjyou::glsl::vec3 roomMinCorner = this->_sceneSize * -0.5f;
+	jjyou::glsl::vec3 roomMaxCorner = this->_sceneSize * 0.5f;
+	for (std::uint32_t r = 0; r < this->_extent.height; ++r)
+		for (std::uint32_t c = 0; c < this->_extent.width; ++c) {
+			FrameData::ColorPixel& colorPixel = this->_colorMap[r * this->_extent.width + c];
+			FrameData::DepthPixel& depthPixel = this->_depthMap[r * this->_extent.width + c];
+			jjyou::glsl::vec3 rayOrigin = jjyou::glsl::vec3(invView[3]);
+			jjyou::glsl::vec3 rayDir(static_cast<float>(c) + 0.5f, static_cast<float>(r) + 0.5f, 1.0f);
+			rayDir = invProjection * rayDir;
+			float scaleFactor = jjyou::glsl::norm(rayDir);
+			rayDir = jjyou::glsl::normalized(jjyou::glsl::mat3(invView) * rayDir);
+			rayDir.x = (rayDir.x == 0.0f) ? 1e-5f : rayDir.x;
+			rayDir.y = (rayDir.y == 0.0f) ? 1e-5f : rayDir.y;
+			rayDir.z = (rayDir.z == 0.0f) ? 1e-5f : rayDir.z;
+			// The camera is always inside the room, so the ray always hits a wall.
+			float xExit = ((rayDir.x > 0.0f ? roomMaxCorner.x : roomMinCorner.x) - rayOrigin.x) / rayDir.x;
+			float yExit = ((rayDir.y > 0.0f ? roomMaxCorner.y : roomMinCorner.y) - rayOrigin.y) / rayDir.y;
+			float zExit = ((rayDir.z > 0.0f ? roomMaxCorner.z : roomMinCorner.z) - rayOrigin.z) / rayDir.z;
+			float hitT = std::min(std::min(xExit, yExit), zExit);
+			FrameData::ColorPixel hitColor(200, 200, 200, 255);
+			// Windows in the upper part of the walls and the skylight do not reflect the sensor's light.
+			float hitY = rayOrigin.y + hitT * rayDir.y;
+			bool hitWindow = (this->_windowRatio > 0.0f) && (hitY >= roomMaxCorner.y - this->_windowRatio * this->_sceneSize.y);
+			for (const Box& pillar : this->_pillars) {
+				float xMin = ((rayDir.x > 0.0f ? pillar.minCorner.x : pillar.maxCorner.x) - rayOrigin.x) / rayDir.x;
+				float yMin = ((rayDir.y > 0.0f ? pillar.minCorner.y : pillar.maxCorner.y) - rayOrigin.y) / rayDir.y;
+				float zMin = ((rayDir.z > 0.0f ? pillar.minCorner.z : pillar.maxCorner.z) - rayOrigin.z) / rayDir.z;
+				float minT = std::max(std::max(xMin, yMin), zMin);
+				float xMax = ((rayDir.x > 0.0f ? pillar.maxCorner.x : pillar.minCorner.x) - rayOrigin.x) / rayDir.x;
+				float yMax = ((rayDir.y > 0.0f ? pillar.maxCorner.y : pillar.minCorner.y) - rayOrigin.y) / rayDir.y;
+				float zMax = ((rayDir.z > 0.0f ? pillar.maxCorner.z : pillar.minCorner.z) - rayOrigin.z) / rayDir.z;
+				float maxT = std::min(std::min(xMax, yMax), zMax);
+				if (minT < maxT && minT > 0.0f && minT < hitT) {
+					hitT = minT;
+					hitColor = pillar.color;
+					hitWindow = false;
+				}
+			}
+			// Checkerboard pattern with 0.5m tiles.
+			jjyou::glsl::vec3 hitPoint = rayOrigin + hitT * rayDir;
+			int tile = static_cast<int>(std::floor(hitPoint.x * 2.0f)) + static_cast<int>(std::floor(hitPoint.y * 2.0f)) + static_cast<int>(std::floor(hitPoint.z * 2.0f));
+			if (tile % 2)
+				hitColor = FrameData::ColorPixel(static_cast<unsigned char>(hitColor.x * 3 / 4), static_cast<unsigned char>(hitColor.y * 3 / 4), static_cast<unsigned char>(hitColor.z * 3 / 4), 255);
+			float hitDepth = hitT / scaleFactor;
+			if (hitWindow || hitDepth < this->minDepth() || hitDepth > this->maxDepth()) {
+				colorPixel = FrameData::ColorPixel(0, 0, 0, 0);
+				depthPixel = this->invalidDepth();
+			}
+			else {
+				colorPixel = hitColor;
+				depthPixel = hitDepth;
+			}
+		}
+	++this->_frameIndex;
+	return res;
+}
+
+jjyou::glsl::mat4 ProceduralDataLoader::_getView(std::uint32_t frameIndex_) const {
+	// The camera moves on an ellipse in the outer part of the room and looks at
+	// a point moving on a smaller ellipse, so that both walls and pillars are visible.
+	float theta = 2.0f * std::numbers::pi_v<float> * static_cast<float>(frameIndex_ % this->_period) / static_cast<float>(this->_period);
+	jjyou::glsl::vec3 halfSize = this->_sceneSize * 0.5f;
+	jjyou::glsl::vec3 eye(
+		0.75f * halfSize.x * std::cos(theta),
+		0.2f * halfSize.y * std::sin(3.0f * theta),
+		0.75f * halfSize.z * std::sin(theta)
+	);
+	jjyou::glsl::vec3 target(
+		0.3f * halfSize.x * std::cos(2.0f * theta),
+		-0.2f * halfSize.y,
+		0.3f * halfSize.z * std::sin(2.0f * theta)
+	);
+	// Vision convention: x right, y down, z forward.
+	jjyou::glsl::vec3 zAxis = jjyou::glsl::normalized(target - eye);
+	jjyou::glsl::vec3 xAxis = jjyou::glsl::normalized(jjyou::glsl::cross(zAxis, jjyou::glsl::vec3(0.0f, 1.0f, 0.0f)));
+	jjyou::glsl::vec3 yAxis = jjyou::glsl::cross(zAxis, xAxis);
+	jjyou::glsl::mat4 invView(1.0f);
+	invView[0] = jjyou::glsl::vec4(xAxis, 0.0f);
+	invView[1] = jjyou::glsl::vec4(yAxis, 0.0f);
+	invView[2] = jjyou::glsl::vec4(zAxis, 0.0f);
+	invView[3] = jjyou::glsl::vec4(eye, 1.0f);
+	return jjyou::glsl::inverse(invView);
+}
+
 TUMDataset::TUMDataset(
-	const std::filesystem::path& path_
+	const std::filesystem::path& path_,
+	std::uint32_t numThreads_,
+	std::uint32_t lookAhead_
 ) :
-	DataLoader()
+	DataLoader(), _path(path_)
 {
+	// Index the archive. The dataset folder is the shallowest directory with a "rgb.txt".
+	if (TarArchive::isArchive(path_)) {
+		this->_pArchive = std::make_unique<TarArchive>(path_);
+		std::optional<std::filesystem::path> root = std::nullopt;
+		for (const std::string& name : this->_pArchive->names()) {
+			std::filesystem::path member(name);
+			if (member.filename() != "rgb.txt")
+				continue;
+			if (!root.has_value() || std::distance(member.begin(), member.end()) <= std::distance(root->begin(), root->end()))
+				root = member.parent_path();
+		}
+		if (!root.has_value())
+			throw std::runtime_error("[TUMDataset] Cannot find rgb.txt in " + path_.string() + ".");
+		this->_path = path_ / *root;
+	}
+	const std::filesystem::path& dataPath = this->_path;
 	// https://cvg.cit.tum.de/data/datasets/rgbd-dataset/file_formats
 	this->_camera = Camera::fromVision(
 		525.0f,
@@ -94,18 +264,16 @@ TUMDataset::TUMDataset(
 		this->depthFrameExtent().width,
 		this->depthFrameExtent().height
 	);
-	this->_colorMap.reset(new FrameData::ColorPixel[this->colorFrameExtent().width * this->colorFrameExtent().height]{});
-	this->_depthMap.reset(new FrameData::DepthPixel[this->depthFrameExtent().width * this->depthFrameExtent().height]{});
-	std::ifstream inputFile;
+	std::optional<std::istringstream> inputFile;
 	std::string inputBuffer;
 	std::stringstream lineStream;
 	// Read RGB image names and timestamps.
 	std::vector<double> rgbTimestamps;
 	std::vector<std::filesystem::path> rgbImageNames;
-	inputFile.open(path_ / "rgb.txt", std::ios::in);
-	if (!inputFile.is_open())
-		throw std::runtime_error("[TUMDataset] Cannot open " + (path_ / "rgb.txt").string() + ".");
-	while (std::getline(inputFile, inputBuffer)) {
+	inputFile = this->_openText(dataPath / "rgb.txt");
+	if (!inputFile.has_value())
+		throw std::runtime_error("[TUMDataset] Cannot open " + (dataPath / "rgb.txt").string() + ".");
+	while (std::getline(*inputFile, inputBuffer)) {
 		if (inputBuffer.empty() || inputBuffer.front() == '#')
 			continue;
 		lineStream.clear();
@@ -116,16 +284,15 @@ TUMDataset::TUMDataset(
 		rgbTimestamps.push_back(rgbTimestamp);
 		rgbImageNames.emplace_back(rgbImageName);
 	}
-	inputFile.close();
 	if (rgbImageNames.empty())
-		throw std::runtime_error("[TUMDataset] No rgb data in " + (path_ / "rgb.txt").string() + ".");
+		throw std::runtime_error("[TUMDataset] No rgb data in " + (dataPath / "rgb.txt").string() + ".");
 	// Read depth image names and timestamps.
 	std::vector<double> depthTimestamps;
 	std::vector<std::filesystem::path> depthImageNames;
-	inputFile.open(path_ / "depth.txt", std::ios::in);
-	if (!inputFile.is_open())
-		throw std::runtime_error("[TUMDataset] Cannot open " + (path_ / "depth.txt").string() + ".");
-	while (std::getline(inputFile, inputBuffer)) {
+	inputFile = this->_openText(dataPath / "depth.txt");
+	if (!inputFile.has_value())
+		throw std::runtime_error("[TUMDataset] Cannot open " + (dataPath / "depth.txt").string() + ".");
+	while (std::getline(*inputFile, inputBuffer)) {
 		if (inputBuffer.empty() || inputBuffer.front() == '#')
 			continue;
 		lineStream.clear();
@@ -136,22 +303,21 @@ TUMDataset::TUMDataset(
 		depthTimestamps.push_back(depthTimestamp);
 		depthImageNames.emplace_back(depthImageName);
 	}
-	inputFile.close();
 	if (depthImageNames.empty())
-		throw std::runtime_error("[TUMDataset] No depth data in " + (path_ / "depth.txt").string() + ".");
+		throw std::runtime_error("[TUMDataset] No depth data in " + (dataPath / "depth.txt").string() + ".");
 	// Read groundtruth trajectory data and timestamps.
 	std::vector<double> groundtruthTimestamps;
 	std::vector<jjyou::glsl::mat4> groundtruthViews;
-	inputFile.open(path_ / "groundtruth.txt", std::ios::in);
-	if (!inputFile.is_open())
-		throw std::runtime_error("[TUMDataset] Cannot open " + (path_ / "groundtruth.txt").string() + ".");
+	inputFile = this->_openText(dataPath / "groundtruth.txt");
+	if (!inputFile.has_value())
+		throw std::runtime_error("[TUMDataset] Cannot open " + (dataPath / "groundtruth.txt").string() + ".");
 	jjyou::glsl::mat4 transform(
 		0.0f, 0.0f, -1.0f, 0.0f,
 		1.0f, 0.0f, 0.0f, 0.0f,
 		0.0f, -1.0f, 0.0f, 0.0f,
 		0.0f, 0.0f, 0.0f, 1.0f
 	);
-	while (std::getline(inputFile, inputBuffer)) {
+	while (std::getline(*inputFile, inputBuffer)) {
 		if (inputBuffer.empty() || inputBuffer.front() == '#')
 			continue;
 		lineStream.clear();
@@ -166,27 +332,47 @@ TUMDataset::TUMDataset(
 		view = jjyou::glsl::inverse(transform * view);
 		groundtruthViews.emplace_back(view);
 	}
-	inputFile.close();
 	if (groundtruthViews.empty())
-		throw std::runtime_error("[TUMDataset] No groundtruth data in " + (path_ / "groundtruth.txt").string() + ".");
+		throw std::runtime_error("[TUMDataset] No groundtruth data in " + (dataPath / "groundtruth.txt").string() + ".");
+	// Read accelerometer data and timestamps, if available.
+	std::vector<double> accelerometerTimestamps;
+	std::vector<jjyou::glsl::vec3> accelerometerGravities;
+	inputFile = this->_openText(dataPath / "accelerometer.txt");
+	if (inputFile.has_value()) {
+		while (std::getline(*inputFile, inputBuffer)) {
+			if (inputBuffer.empty() || inputBuffer.front() == '#')
+				continue;
+			lineStream.clear();
+			lineStream << inputBuffer;
+			double accelerometerTimestamp{};
+			jjyou::glsl::vec3 acceleration;
+			lineStream >> accelerometerTimestamp >> acceleration.x >> acceleration.y >> acceleration.z;
+			if (jjyou::glsl::norm(acceleration) == 0.0f)
+				continue;
+			accelerometerTimestamps.push_back(accelerometerTimestamp);
+			accelerometerGravities.push_back(-jjyou::glsl::normalized(acceleration));
+		}
+	}
 	// Match depth images with RGB images and groundtruth poses.
 	this->_colorFrameNames.reserve(depthImageNames.size());
 	std::size_t rgbCounter = 0;
 	this->_depthFrameNames.reserve(depthImageNames.size());
 	this->_views.reserve(depthImageNames.size());
 	std::size_t groundtruthCounter = 0;
+	this->_gravities.reserve(accelerometerGravities.empty() ? 0ULL : depthImageNames.size());
+	std::size_t accelerometerCounter = 0;
 	for (std::size_t depthCounter = 0; depthCounter < depthImageNames.size(); ++depthCounter) {
 		double depthTimestamp = depthTimestamps[depthCounter];
-		this->_depthFrameNames.push_back(path_ / depthImageNames[depthCounter]);
+		this->_depthFrameNames.push_back(dataPath / depthImageNames[depthCounter]);
 		while (rgbCounter + 1ULL < rgbImageNames.size() && rgbTimestamps[rgbCounter + 1ULL] < depthTimestamp)
 			++rgbCounter;
 		if (rgbCounter + 1ULL == rgbImageNames.size() ||
 			(std::abs(rgbTimestamps[rgbCounter] - depthTimestamp) < std::abs(rgbTimestamps[rgbCounter + 1ULL] - depthTimestamp))
 			) {
-			this->_colorFrameNames.push_back(path_ / rgbImageNames[rgbCounter]);
+			this->_colorFrameNames.push_back(dataPath / rgbImageNames[rgbCounter]);
 		}
 		else {
-			this->_colorFrameNames.push_back(path_ / rgbImageNames[rgbCounter + 1ULL]);
+			this->_colorFrameNames.push_back(dataPath / rgbImageNames[rgbCounter + 1ULL]);
 		}
 		while (groundtruthCounter + 1ULL < groundtruthViews.size() && groundtruthTimestamps[groundtruthCounter + 1ULL] < depthTimestamp)
 			++groundtruthCounter;
@@ -198,49 +384,330 @@ TUMDataset::TUMDataset(
 		else {
 			this->_views.push_back(groundtruthViews[groundtruthCounter + 1ULL]);
 		}
+		if (accelerometerGravities.empty())
+			continue;
+		while (accelerometerCounter + 1ULL < accelerometerGravities.size() && accelerometerTimestamps[accelerometerCounter + 1ULL] < depthTimestamp)
+			++accelerometerCounter;
+		if (accelerometerCounter + 1ULL == accelerometerGravities.size() ||
+			(std::abs(accelerometerTimestamps[accelerometerCounter] - depthTimestamp) < std::abs(accelerometerTimestamps[accelerometerCounter + 1ULL] - depthTimestamp))
+			) {
+			this->_gravities.push_back(accelerometerGravities[accelerometerCounter]);
+		}
+		else {
+			this->_gravities.push_back(accelerometerGravities[accelerometerCounter + 1ULL]);
+		}
 	}
+	// Start reading and decoding the images.
+	this->_pPrefetcher = std::make_unique<FramePrefetcher>(
+		static_cast<std::uint64_t>(this->_depthFrameNames.size()),
+		colorFrameSize(this->colorFormat(), this->colorFrameExtent()),
+		static_cast<std::size_t>(this->depthFrameExtent().width) * static_cast<std::size_t>(this->depthFrameExtent().height),
+		numThreads_,
+		lookAhead_,
+		[this](FramePrefetcher::Slot& slot_) { return this->_readFrame(slot_); },
+		[this](FramePrefetcher::Slot& slot_) { this->_decodeSlot(slot_); }
+	);
 }
+
 FrameData TUMDataset::getFrame(void) {
 	if (this->_frameIndex == static_cast<std::uint32_t>(this->_colorFrameNames.size())) {
+		// Still return the data of the last frame, whose slot is still held.
+		const FramePrefetcher::Slot& slot = *this->_pPrefetcher->last();
 		FrameData res{};
 		res.state = FrameState::Eof;
 		res.frameIndex = this->_frameIndex;
-		// Still return the data of the last frame.
-		res.colorMap = this->_colorMap.get();
-		res.depthMap = this->_depthMap.get();
+		res.colorMap = slot.colorMap.get();
+		res.depthMap = slot.depthMap.get();
 		res.camera = this->_camera;
 		res.view = this->_views.back();
 		return res;
 	}
+	const FramePrefetcher::Slot& slot = this->_pPrefetcher->next();
 	FrameData res{};
 	res.state = FrameState::Valid;
 	res.frameIndex = this->_frameIndex;
-	res.colorMap = this->_colorMap.get();
-	res.depthMap = this->_depthMap.get();
+	res.colorMap = slot.colorMap.get();
+	res.depthMap = slot.depthMap.get();
 	res.camera = this->_camera;
-	res.view = this->_views[this->_frameIndex];
+	res.view = slot.view;
+	if (!this->_gravities.empty())
+		res.gravity = this->_gravities[this->_frameIndex];
+	++this->_frameIndex;
+	return res;
+}
+
+bool TUMDataset::_readFile(const std::filesystem::path& path_, std::vector<std::uint8_t>& data_) {
+	if (this->_pArchive)
+		return this->_pArchive->read(path_.lexically_relative(this->_pArchive->path()).generic_string(), data_);
+	std::ifstream file(path_, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return false;
+	data_.resize(static_cast<std::size_t>(file.tellg()));
+	file.seekg(0, std::ios::beg);
+	file.read(reinterpret_cast<char*>(data_.data()), static_cast<std::streamsize>(data_.size()));
+	if (static_cast<std::size_t>(file.gcount()) != data_.size())
+		throw std::runtime_error("[TUMDataset] Cannot read " + path_.string() + ".");
+	return true;
+}
+
+std::optional<std::istringstream> TUMDataset::_openText(const std::filesystem::path& path_) {
+	std::vector<std::uint8_t> data{};
+	if (!this->_readFile(path_, data))
+		return std::nullopt;
+	return std::istringstream(std::string(data.begin(), data.end()));
+}
+
+std::size_t TUMDataset::_readFrame(FramePrefetcher::Slot& slot_) {
+	const std::filesystem::path& colorFrameName = this->_colorFrameNames[slot_.frameIndex];
+	const std::filesystem::path& depthFrameName = this->_depthFrameNames[slot_.frameIndex];
+	if (!this->_readFile(colorFrameName, slot_.colorData))
+		throw std::runtime_error("[TUMDataset] Cannot open " + colorFrameName.string() + ".");
+	if (!this->_readFile(depthFrameName, slot_.depthData))
+		throw std::runtime_error("[TUMDataset] Cannot open " + depthFrameName.string() + ".");
+	slot_.view = this->_views[slot_.frameIndex];
+	return slot_.colorData.size() + slot_.depthData.size();
+}
+
+void TUMDataset::_decodeSlot(FramePrefetcher::Slot& slot_) const {
+	const std::filesystem::path& colorFrameName = this->_colorFrameNames[slot_.frameIndex];
+	const std::filesystem::path& depthFrameName = this->_depthFrameNames[slot_.frameIndex];
+	// `colorFrameExtent` and `depthFrameExtent` are not const.
+	vk::Extent2D colorExtent(640U, 480U);
+	vk::Extent2D depthExtent(640U, 480U);
 	{
 		int colorExtentX{}, colorExtentY{}, colorChannel{};
-		std::uint8_t* colorPixels = stbi_load(this->_colorFrameNames[this->_frameIndex].string().c_str(), &colorExtentX, &colorExtentY, &colorChannel, STBI_rgb_alpha);
-		if (colorPixels == nullptr) throw std::runtime_error("[TUMDataset] Failed to load " + this->_colorFrameNames[this->_frameIndex].string() + ".");
-		if (static_cast<std::uint32_t>(colorExtentX) != this->colorFrameExtent().width || static_cast<std::uint32_t>(colorExtentY) != this->colorFrameExtent().height)
-			throw std::runtime_error("[TUMDataset] The size of image " + this->_colorFrameNames[this->_frameIndex].string() + " does not match.");
-		memcpy(this->_colorMap.get(), colorPixels, sizeof(FrameData::ColorPixel) * static_cast<std::size_t>(this->colorFrameExtent().width) * static_cast<std::size_t>(this->colorFrameExtent().height));
+		std::uint8_t* colorPixels = stbi_load_from_memory(slot_.colorData.data(), static_cast<int>(slot_.colorData.size()), &colorExtentX, &colorExtentY, &colorChannel, STBI_rgb);
+		if (colorPixels == nullptr) throw std::runtime_error("[TUMDataset] Failed to load " + colorFrameName.string() + ".");
+		if (static_cast<std::uint32_t>(colorExtentX) != colorExtent.width || static_cast<std::uint32_t>(colorExtentY) != colorExtent.height) {
+			stbi_image_free(colorPixels);
+			throw std::runtime_error("[TUMDataset] The size of image " + colorFrameName.string() + " does not match.");
+		}
+		memcpy(slot_.colorMap.get(), colorPixels, colorFrameSize(ColorFormat::RGB888, colorExtent));
 		stbi_image_free(colorPixels);
 	}
-	if (stbi_is_16_bit(this->_depthFrameNames[this->_frameIndex].string().c_str())) {
+	if (stbi_is_16_bit_from_memory(slot_.depthData.data(), static_cast<int>(slot_.depthData.size()))) {
 		int depthExtentX{}, depthExtentY{}, depthChannel{};
-		std::uint16_t* depthPixels = stbi_load_16(this->_depthFrameNames[this->_frameIndex].string().c_str(), &depthExtentX, &depthExtentY, &depthChannel, STBI_grey);
-		if (depthPixels == nullptr) throw std::runtime_error("[TUMDataset] Failed to load " + this->_depthFrameNames[this->_frameIndex].string() + ".");
-		if (static_cast<std::uint32_t>(depthExtentX) != this->depthFrameExtent().width || static_cast<std::uint32_t>(depthExtentY) != this->depthFrameExtent().height)
-			throw std::runtime_error("[TUMDataset] The size of image " + this->_depthFrameNames[this->_frameIndex].string() + " does not match.");
-		for (std::size_t i = 0; i < static_cast<std::size_t>(this->depthFrameExtent().width) * static_cast<std::size_t>(this->depthFrameExtent().height); ++i)
-			this->_depthMap[i] = static_cast<float>(depthPixels[i]) / 5000.0f;
+		std::uint16_t* depthPixels = stbi_load_16_from_memory(slot_.depthData.data(), static_cast<int>(slot_.depthData.size()), &depthExtentX, &depthExtentY, &depthChannel, STBI_grey);
+		if (depthPixels == nullptr) throw std::runtime_error("[TUMDataset] Failed to load " + depthFrameName.string() + ".");
+		if (static_cast<std::uint32_t>(depthExtentX) != depthExtent.width || static_cast<std::uint32_t>(depthExtentY) != depthExtent.height) {
+			stbi_image_free(depthPixels);
+			throw std::runtime_error("[TUMDataset] The size of image " + depthFrameName.string() + " does not match.");
+		}
+		for (std::size_t i = 0; i < static_cast<std::size_t>(depthExtent.width) * static_cast<std::size_t>(depthExtent.height); ++i)
+			slot_.depthMap[i] = static_cast<float>(depthPixels[i]) / 5000.0f;
 		stbi_image_free(depthPixels);
 	}
 	else {
-		throw std::runtime_error("[TUMDataset] The image format of " + this->_depthFrameNames[this->_frameIndex].string() + " is not 16-bit.");
+		throw std::runtime_error("[TUMDataset] The image format of " + depthFrameName.string() + " is not 16-bit.");
+	}
+}
+
+SensStreamLoader::SensStreamLoader(
+	const std::filesystem::path& path_,
+	std::uint32_t numThreads_,
+	std::uint32_t lookAhead_
+) :
+	DataLoader(), _path(path_)
+{
+	// The reads are done in blocks of `READ_BLOCK_SIZE`, so the stream buffer is disabled.
+	this->_readBuffer.resize(SensStreamLoader::READ_BLOCK_SIZE);
+	this->_file.rdbuf()->pubsetbuf(nullptr, 0);
+	this->_file.open(path_, std::ios::in | std::ios::binary);
+	if (!this->_file.is_open())
+		throw std::runtime_error("[SensStreamLoader] Cannot open " + path_.string() + ".");
+	// Read the header.
+	std::uint32_t version{};
+	this->_read(&version, sizeof(version));
+	if (version != 4U)
+		throw std::runtime_error("[SensStreamLoader] Unsupported version " + std::to_string(version) + " of " + path_.string() + ".");
+	std::uint64_t sensorNameLength{};
+	this->_read(&sensorNameLength, sizeof(sensorNameLength));
+	std::string sensorName(static_cast<std::size_t>(sensorNameLength), '\0');
+	this->_read(sensorName.data(), sensorName.size());
+	std::array<float, 16> colorIntrinsics{}, colorExtrinsics{}, depthIntrinsics{}, depthExtrinsics{};
+	this->_read(colorIntrinsics.data(), sizeof(colorIntrinsics));
+	this->_read(colorExtrinsics.data(), sizeof(colorExtrinsics));
+	this->_read(depthIntrinsics.data(), sizeof(depthIntrinsics));
+	this->_read(depthExtrinsics.data(), sizeof(depthExtrinsics));
+	std::int32_t colorCompression{}, depthCompression{};
+	this->_read(&colorCompression, sizeof(colorCompression));
+	this->_read(&depthCompression, sizeof(depthCompression));
+	if (colorCompression < 0 || colorCompression > 2)
+		throw std::runtime_error("[SensStreamLoader] Unsupported color compression type " + std::to_string(colorCompression) + " of " + path_.string() + ".");
+	if (depthCompression < 0 || depthCompression > 1)
+		throw std::runtime_error("[SensStreamLoader] Unsupported depth compression type " + std::to_string(depthCompression) + " of " + path_.string() + ".");
+	this->_colorCompression = static_cast<_ColorCompression>(colorCompression);
+	this->_depthCompression = static_cast<_DepthCompression>(depthCompression);
+	std::array<std::uint32_t, 4> extents{};
+	this->_read(extents.data(), sizeof(extents));
+	this->_colorExtent = vk::Extent2D(extents[0], extents[1]);
+	this->_depthExtent = vk::Extent2D(extents[2], extents[3]);
+	this->_read(&this->_depthShift, sizeof(this->_depthShift));
+	this->_read(&this->_numFrames, sizeof(this->_numFrames));
+	if (this->_numFrames == 0ULL)
+		throw std::runtime_error("[SensStreamLoader] No frames in " + path_.string() + ".");
+	// The matrices are stored in row-major order.
+	// Fusion looks up the color of a depth pixel by scaling its coordinates to the color extent,
+	// so the color image must be registered to the depth image.
+	constexpr float intrinsicsTolerance = 0.01f;
+	constexpr float extrinsicsTolerance = 0.001f;
+	float colorWidth = static_cast<float>(this->_colorExtent.width), colorHeight = static_cast<float>(this->_colorExtent.height);
+	float depthWidth = static_cast<float>(this->_depthExtent.width), depthHeight = static_cast<float>(this->_depthExtent.height);
+	bool registered =
+		std::abs(colorIntrinsics[0] / colorWidth - depthIntrinsics[0] / depthWidth) <= intrinsicsTolerance &&
+		std::abs(colorIntrinsics[5] / colorHeight - depthIntrinsics[5] / depthHeight) <= intrinsicsTolerance &&
+		std::abs(colorIntrinsics[2] / colorWidth - depthIntrinsics[2] / depthWidth) <= intrinsicsTolerance &&
+		std::abs(colorIntrinsics[6] / colorHeight - depthIntrinsics[6] / depthHeight) <= intrinsicsTolerance;
+	for (std::size_t i = 0; i < colorExtrinsics.size(); ++i)
+		registered = registered && std::abs(colorExtrinsics[i] - depthExtrinsics[i]) <= extrinsicsTolerance;
+	if (!registered)
+		throw std::runtime_error("[SensStreamLoader] The color image of " + path_.string() + " is not registered to the depth image.");
+	this->_camera = Camera::fromVision(
+		depthIntrinsics[0],
+		depthIntrinsics[5],
+		depthIntrinsics[2],
+		depthIntrinsics[6],
+		this->minDepth(),
+		this->maxDepth(),
+		this->_depthExtent.width,
+		this->_depthExtent.height
+	);
+	// Read the pose of the first frame here to get the initial pose.
+	this->_firstView = this->_readView();
+	if (this->_firstView.has_value())
+		this->_initialPose = *this->_firstView;
+	// Start reading and decoding the frames.
+	this->_pPrefetcher = std::make_unique<FramePrefetcher>(
+		this->_numFrames,
+		colorFrameSize(ColorFormat::RGB888, this->_colorExtent),
+		static_cast<std::size_t>(this->_depthExtent.width) * static_cast<std::size_t>(this->_depthExtent.height),
+		numThreads_,
+		lookAhead_,
+		[this](FramePrefetcher::Slot& slot_) { return this->_readFrame(slot_); },
+		[this](FramePrefetcher::Slot& slot_) { this->_decodeSlot(slot_); }
+	);
+}
+
+FrameData SensStreamLoader::getFrame(void) {
+	if (this->_frameIndex == this->_numFrames) {
+		// Still return the data of the last frame, whose slot is still held.
+		const FramePrefetcher::Slot& slot = *this->_pPrefetcher->last();
+		FrameData res{};
+		res.state = FrameState::Eof;
+		res.frameIndex = this->_frameIndex;
+		res.colorMap = slot.colorMap.get();
+		res.depthMap = slot.depthMap.get();
+		res.camera = this->_camera;
+		res.view = slot.view;
+		return res;
 	}
+	const FramePrefetcher::Slot& slot = this->_pPrefetcher->next();
+	FrameData res{};
+	res.state = FrameState::Valid;
+	res.frameIndex = this->_frameIndex;
+	res.colorMap = slot.colorMap.get();
+	res.depthMap = slot.depthMap.get();
+	res.camera = this->_camera;
+	res.view = slot.view;
 	++this->_frameIndex;
 	return res;
 }
+
+void SensStreamLoader::_read(void* dst_, std::size_t size_) {
+	char* pDst = static_cast<char*>(dst_);
+	while (size_ > 0U) {
+		if (this->_readBufferBegin == this->_readBufferEnd) {
+			// Blocks are read back to back from the beginning of the file, so their offsets are multiples of the block size.
+			this->_file.read(this->_readBuffer.data(), static_cast<std::streamsize>(this->_readBuffer.size()));
+			std::size_t numBytesRead = static_cast<std::size_t>(this->_file.gcount());
+			if (numBytesRead == 0U)
+				throw std::runtime_error("[SensStreamLoader] Unexpected end of file " + this->_path.string() + ".");
+			this->_readBufferBegin = 0U;
+			this->_readBufferEnd = numBytesRead;
+			this->_numBytesRead += numBytesRead;
+		}
+		std::size_t numBytes = std::min(size_, this->_readBufferEnd - this->_readBufferBegin);
+		std::memcpy(pDst, this->_readBuffer.data() + this->_readBufferBegin, numBytes);
+		this->_readBufferBegin += numBytes;
+		pDst += numBytes;
+		size_ -= numBytes;
+	}
+}
+
+std::optional<jjyou::glsl::mat4> SensStreamLoader::_readView(void) {
+	std::array<float, 16> cameraToWorld{};
+	this->_read(cameraToWorld.data(), sizeof(cameraToWorld));
+	// Frames without tracking have infinite entries.
+	for (float element : cameraToWorld)
+		if (!std::isfinite(element))
+			return std::nullopt;
+	// Row-major, in vision convention (x right, y down, z forward).
+	jjyou::glsl::mat4 invView(1.0f);
+	for (int r = 0; r < 4; ++r)
+		for (int c = 0; c < 4; ++c)
+			invView[c][r] = cameraToWorld[r * 4 + c];
+	// The world of ScanNet is z-up. Rotate it to y-down, like the world of `TUMDataset`.
+	jjyou::glsl::mat4 transform(
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, -1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	);
+	return jjyou::glsl::inverse(transform * invView);
+}
+
+std::size_t SensStreamLoader::_readFrame(FramePrefetcher::Slot& slot_) {
+	std::size_t numBytesReadBegin = this->_numBytesRead;
+	// The pose of the first frame is read by the constructor.
+	slot_.view = (slot_.frameIndex == 0ULL) ? this->_firstView : this->_readView();
+	std::array<std::uint64_t, 2> timestamps{};
+	this->_read(timestamps.data(), sizeof(timestamps));
+	std::uint64_t colorDataSize{}, depthDataSize{};
+	this->_read(&colorDataSize, sizeof(colorDataSize));
+	this->_read(&depthDataSize, sizeof(depthDataSize));
+	slot_.colorData.resize(static_cast<std::size_t>(colorDataSize));
+	this->_read(slot_.colorData.data(), slot_.colorData.size());
+	slot_.depthData.resize(static_cast<std::size_t>(depthDataSize));
+	this->_read(slot_.depthData.data(), slot_.depthData.size());
+	return this->_numBytesRead - numBytesReadBegin;
+}
+
+void SensStreamLoader::_decodeSlot(FramePrefetcher::Slot& slot_) const {
+	std::size_t colorMapSize = colorFrameSize(ColorFormat::RGB888, this->_colorExtent);
+	if (this->_colorCompression == _ColorCompression::Raw) {
+		if (slot_.colorData.size() != colorMapSize)
+			throw std::runtime_error("[SensStreamLoader] The size of the color image of frame " + std::to_string(slot_.frameIndex) + " does not match.");
+		std::memcpy(slot_.colorMap.get(), slot_.colorData.data(), colorMapSize);
+	}
+	else {
+		int colorExtentX{}, colorExtentY{}, colorChannel{};
+		std::uint8_t* colorPixels = stbi_load_from_memory(slot_.colorData.data(), static_cast<int>(slot_.colorData.size()), &colorExtentX, &colorExtentY, &colorChannel, STBI_rgb);
+		if (colorPixels == nullptr)
+			throw std::runtime_error("[SensStreamLoader] Failed to decode the color image of frame " + std::to_string(slot_.frameIndex) + ".");
+		if (static_cast<std::uint32_t>(colorExtentX) != this->_colorExtent.width || static_cast<std::uint32_t>(colorExtentY) != this->_colorExtent.height) {
+			stbi_image_free(colorPixels);
+			throw std::runtime_error("[SensStreamLoader] The size of the color image of frame " + std::to_string(slot_.frameIndex) + " does not match.");
+		}
+		std::memcpy(slot_.colorMap.get(), colorPixels, colorMapSize);
+		stbi_image_free(colorPixels);
+	}
+	std::size_t numDepthPixels = static_cast<std::size_t>(this->_depthExtent.width) * static_cast<std::size_t>(this->_depthExtent.height);
+	std::vector<std::uint16_t> depthPixels(numDepthPixels);
+	if (this->_depthCompression == _DepthCompression::Raw) {
+		if (slot_.depthData.size() != numDepthPixels * sizeof(std::uint16_t))
+			throw std::runtime_error("[SensStreamLoader] The size of the depth image of frame " + std::to_string(slot_.frameIndex) + " does not match.");
+		std::memcpy(depthPixels.data(), slot_.depthData.data(), slot_.depthData.size());
+	}
+	else {
+		int numDecodedBytes = stbi_zlib_decode_buffer(
+			reinterpret_cast<char*>(depthPixels.data()),
+			static_cast<int>(numDepthPixels * sizeof(std::uint16_t)),
+			reinterpret_cast<const char*>(slot_.depthData.data()),
+			static_cast<int>(slot_.depthData.size())
+		);
+		if (numDecodedBytes != static_cast<int>(numDepthPixels * sizeof(std::uint16_t)))
+			throw std::runtime_error("[SensStreamLoader] Failed to decode the depth image of frame " + std::to_string(slot_.frameIndex) + ".");
+	}
+	for (std::size_t i = 0; i < numDepthPixels; ++i)
+		slot_.depthMap[i] = static_cast<float>(depthPixels[i]) / this->_depthShift;
+}
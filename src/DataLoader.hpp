@@ -6,7 +6,13 @@
 #include <optional>
 #include <memory>
 #include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
 #include "Camera.hpp"
+#include "Primitives.hpp"
+#include "FramePrefetcher.hpp"
+#include "TarArchive.hpp"
 
 /***********************************************************************
  * @enum	FrameState
@@ -43,10 +49,11 @@ struct FrameData {
 
 	FrameState state = FrameState::Invalid;
 	std::uint32_t frameIndex = 0U;
-	const ColorPixel* colorMap = nullptr; // The memory should be valid until next `getFrame` call.
-	const DepthPixel* depthMap = nullptr; // The memory should be valid until next `getFrame` call.
+	const void* colorMap = nullptr; // Raw color data in `DataLoader::colorFormat`, e.g. `ColorPixel` for RGBA8888. The memory should be valid until next `getFrame` call.
+	const DepthPixel* depthMap = nullptr; // The memory should be valid until next `getFrame` call. Both maps are null if the frame is rendered on the GPU.
 	Camera camera{};	// Camera intrinsics parameters for the depth data.
 	std::optional<jjyou::glsl::mat4> view = std::nullopt; // Optional ground truth view matrix that transforms objects from world space to camera space.
+	std::optional<jjyou::glsl::vec3> gravity = std::nullopt; // Optional unit gravity direction in camera space, e.g. measured by an accelerometer.
 };
 
 /***********************************************************************
@@ -62,6 +69,11 @@ struct FrameData {
  * The size of input frames should be fixed throughout the algorithm, as it is
  * used to pre-allocate vulkan memory.
  * 
+ * Color format:
+ *  - `ColorFormat colorFormat(void)`
+ * The layout of `FrameData::colorMap`. The data is uploaded as-is and converted on the GPU,
+ * so a loader should advertise the native format of its source instead of converting it on the CPU.
+ * 
  * Invalid measurement:
  *  - `float minDepth(void)`
  *  - `float maxDepth(void)`
@@ -85,7 +97,8 @@ struct FrameData {
  * 
  * Data fetching:
  *  - `FrameData getFrame(void)`
- * The dataloader can optionally provide a ground truth camera view matrix stored in `FrameData::view`.
+ * The dataloader can optionally provide a ground truth camera view matrix stored in `FrameData::view`,
+ * and a gravity direction stored in `FrameData::gravity`, which is used as a prior in pose estimation.
  *  - `jjyou::glsl::mat4 initialPose(void)`
  * You may wish to set an initial pose (view matrix for the first frame) so that the reconstructed scene
  * is centered in the TSDF volume. If you don't have any prior about the scene, just set it as identity.
@@ -117,6 +130,10 @@ public:
 	  */
 	virtual vk::Extent2D depthFrameExtent(void) = 0;
 
+	/** @brief	Get the layout of input color frames.
+	  */
+	virtual ColorFormat colorFormat(void) { return ColorFormat::RGBA8888; }
+
 	/** @brief	Get the lower bound of valid depth.
 	  */
 	virtual float minDepth(void) = 0;
@@ -137,6 +154,16 @@ public:
 	  */
 	virtual FrameData getFrame(void) = 0;
 
+	/** @brief	Get the prefetcher that reads and decodes frames ahead of `getFrame`, or nullptr if the loader does not prefetch.
+	  */
+	virtual const FramePrefetcher* prefetcher(void) const { return nullptr; }
+
+	/** @brief	Register the ingest metrics of the loader in a registry, and update them from now on.
+	  *			Loaders without a prefetcher have no ingest metrics.
+	  * @param	pMetrics_	The registry, which must outlive the loader, or nullptr to stop updating.
+	  */
+	virtual void setMetrics(MetricsRegistry* pMetrics_) { (void)pMetrics_; }
+
 };
 
 /***********************************************************************
@@ -212,6 +239,114 @@ private:
 
 };
 
+/***********************************************************************
+ * @class	ProceduralDataLoader
+ * @brief	Procedural data loader that synthesizes data of a large room
+ *			filled with randomly placed pillars.
+ *
+ * The camera moves along a closed trajectory through the room and loops
+ * forever, so this loader never reports `FrameState::Eof`. It is meant for
+ * long running scalability tests over big TSDF volumes.
+ ***********************************************************************/
+class ProceduralDataLoader : public DataLoader {
+
+public:
+
+	/** @brief	Constructor.
+	  * @param	extent_			The frame extent.
+	  * @param	sceneSize_		The size of the room. The room is centered at the origin.
+	  * @param	numPillars_		Number of pillars along x and z axes.
+	  * @param	period_			Number of frames in one loop of the trajectory.
+	  * @param	seed_			Random seed used to place the pillars.
+	  * @param	windowRatio_	Fraction of the wall height (from the ceiling down) covered by windows.
+	  *							If positive, windows and the ceiling (skylight) have invalid depth.
+	  * @param	hostRendering_	Whether to render the frames on the CPU. If false, `getFrame` only
+	  *							returns the camera and the groundtruth pose, with null color and depth
+	  *							maps, and the frames should be rendered on the GPU by `SyntheticFrameGenerator`.
+	  */
+	ProceduralDataLoader(
+		vk::Extent2D extent_,
+		jjyou::glsl::vec3 sceneSize_,
+		jjyou::glsl::uvec2 numPillars_,
+		std::uint32_t period_,
+		std::uint32_t seed_,
+		float windowRatio_ = 0.0f,
+		bool hostRendering_ = true
+	);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	ProceduralDataLoader(const ProceduralDataLoader&) = delete;
+	ProceduralDataLoader(ProceduralDataLoader&&) = delete;
+	ProceduralDataLoader& operator=(const ProceduralDataLoader&) = delete;
+	ProceduralDataLoader& operator=(ProceduralDataLoader&&) = delete;
+
+	/** @brief	Destructor.
+	  */
+	virtual ~ProceduralDataLoader(void) override {}
+
+	/** @brief	Get the size of input color frames.
+	  */
+	virtual vk::Extent2D colorFrameExtent(void) override { return this->_extent; }
+
+	/** @brief	Get the size of input depth frames.
+	  */
+	virtual vk::Extent2D depthFrameExtent(void) override { return this->_extent; }
+
+	/** @brief	Get the lower bound of valid depth.
+	  */
+	virtual float minDepth(void) override { return 0.1f; }
+
+	/** @brief	Get the upper bound of valid depth.
+	  */
+	virtual float maxDepth(void) override { return 20.0f; }
+
+	/** @brief	Get the invalid depth value.
+	  */
+	virtual float invalidDepth(void) override { return this->maxDepth(); }
+
+	/** @brief	Get the initial pose for the first frame.
+	  */
+	virtual jjyou::glsl::mat4 initialPose(void) override { return this->_getView(0U); }
+
+	/** @brief	Get a new frame.
+	  */
+	virtual FrameData getFrame(void) override;
+
+	/** @brief	Axis-aligned box of the scene.
+	  */
+	struct Box {
+		jjyou::glsl::vec3 minCorner{};
+		jjyou::glsl::vec3 maxCorner{};
+		FrameData::ColorPixel color{};
+	};
+
+	/** @brief	Getters of the scene.
+	  */
+	const jjyou::glsl::vec3& sceneSize(void) const { return this->_sceneSize; }
+	float windowRatio(void) const { return this->_windowRatio; }
+	const std::vector<Box>& pillars(void) const { return this->_pillars; }
+	bool hostRendering(void) const { return this->_hostRendering; }
+
+private:
+
+	vk::Extent2D _extent{};
+	jjyou::glsl::vec3 _sceneSize{};
+	std::uint32_t _period = 0U;
+	float _windowRatio = 0.0f;
+	bool _hostRendering = true;
+	std::uint32_t _frameIndex = 0;
+	Camera _camera{};
+	std::vector<Box> _pillars{};
+	std::unique_ptr<FrameData::ColorPixel[]> _colorMap{};
+	std::unique_ptr<FrameData::DepthPixel[]> _depthMap{};
+
+	/** @brief	Get the view matrix of a frame on the looping trajectory.
+	  */
+	jjyou::glsl::mat4 _getView(std::uint32_t frameIndex_) const;
+
+};
+
 /***********************************************************************
  * @class	TUMDataset
  * @brief	Data loader that loads the TUM RGBD dataset from the disk.
@@ -222,18 +357,28 @@ class TUMDataset : public DataLoader {
 public:
 
 	/** @brief	Constructor.
-	  * @param	path_		Path to the folder of the dataset.
+	  * @param	path_			Path to the folder of the dataset, or to a .tgz/.tar.gz/.tar archive of it.
+	  * @param	numThreads_		Number of decoding threads. If 0, the number of hardware threads is used.
+	  * @param	lookAhead_		Maximal number of frames read and decoded ahead of `getFrame`.
 	  * 
 	  *	In the folder there should be a "rgb" folder containing all RGB images,
 	  * a "depth" folder containing all depth images, a "rgb.txt" file containing the
 	  * names of RGB images, a "depth.txt" file containing the names of depth images,
 	  * a "groundtruth.txt" file containing the groundtruth trajectory data,
-	  * and an "accelerometer.txt" file containing the inertial data (not used).
-	  * The timestamps of RGB images, depth images, and groundtruth trajectories
-	  * may not match. They are grouped by nearest search on timestamps.
+	  * and an optional "accelerometer.txt" file containing the inertial data.
+	  * The timestamps of RGB images, depth images, groundtruth trajectories, and
+	  * accelerometer samples may not match. They are grouped by nearest search on timestamps.
+	  * The accelerometer measures the reaction to gravity in the camera frame,
+	  * so the gravity direction of a frame is the negated, normalized sample.
+	  *
+	  * An archive is indexed once without extracting it (see `TarArchive`). The
+	  * folder of the dataset is the directory of "rgb.txt" in the archive. The
+	  * images are read from the archive by the reader thread of the prefetcher.
 	  */
 	TUMDataset(
-		const std::filesystem::path& path_
+		const std::filesystem::path& path_,
+		std::uint32_t numThreads_ = 0U,
+		std::uint32_t lookAhead_ = 8U
 	);
 
 	/** @brief	Disable copy/move constructor/assignment.
@@ -255,6 +400,10 @@ public:
 	  */
 	virtual vk::Extent2D depthFrameExtent(void) override { return vk::Extent2D(640U, 480U); }
 
+	/** @brief	Get the layout of input color frames. The images are decoded as packed RGB.
+	  */
+	virtual ColorFormat colorFormat(void) override { return ColorFormat::RGB888; }
+
 	/** @brief	Get the lower bound of valid depth.
 	  */
 	virtual float minDepth(void) override { return 0.01f; }
@@ -275,14 +424,190 @@ public:
 	  */
 	virtual FrameData getFrame(void) override;
 
+	/** @brief	Get the prefetcher.
+	  */
+	virtual const FramePrefetcher* prefetcher(void) const override { return this->_pPrefetcher.get(); }
+
+	/** @brief	Register the ingest metrics of the prefetcher.
+	  */
+	virtual void setMetrics(MetricsRegistry* pMetrics_) override { this->_pPrefetcher->setMetrics(pMetrics_); }
+
+	/** @brief	Get the archive the dataset is read from, or nullptr if it is read from a folder.
+	  */
+	const TarArchive* archive(void) const { return this->_pArchive.get(); }
+
 private:
 
+	std::filesystem::path _path{};
+	std::unique_ptr<TarArchive> _pArchive{};
 	std::vector<std::filesystem::path> _colorFrameNames{};
 	std::vector<std::filesystem::path> _depthFrameNames{};
 	std::vector<jjyou::glsl::mat4> _views{};
+	std::vector<jjyou::glsl::vec3> _gravities{}; // Empty if there is no accelerometer data.
 	Camera _camera{};
 	std::uint32_t _frameIndex = 0;
-	std::unique_ptr<FrameData::ColorPixel[]> _colorMap{};
-	std::unique_ptr<FrameData::DepthPixel[]> _depthMap{};
+
+	// Declared last, so that the threads are stopped before the other members are destroyed.
+	std::unique_ptr<FramePrefetcher> _pPrefetcher{};
+
+	/** @brief	Read a file of the dataset, from the folder or from the archive.
+	  * @return	Whether the file exists.
+	  */
+	bool _readFile(const std::filesystem::path& path_, std::vector<std::uint8_t>& data_);
+
+	/** @brief	Open a text file of the dataset.
+	  * @return	The content of the file, or std::nullopt if it does not exist.
+	  */
+	std::optional<std::istringstream> _openText(const std::filesystem::path& path_);
+
+	/** @brief	Read the compressed images of a frame into a slot.
+	  */
+	std::size_t _readFrame(FramePrefetcher::Slot& slot_);
+
+	/** @brief	Decode the images of a slot.
+	  */
+	void _decodeSlot(FramePrefetcher::Slot& slot_) const;
+
+};
+
+/***********************************************************************
+ * @class	SensStreamLoader
+ * @brief	Data loader that streams a ScanNet sensor stream (.sens) file.
+ * @sa		https://github.com/ScanNet/ScanNet/tree/master/SensReader
+ *
+ * The file holds a header with the intrinsics and the frame extents,
+ * followed by the frames. Each frame has a camera-to-world pose, a JPEG
+ * (or PNG / raw) color image, and a zlib-compressed (or raw) uint16 depth
+ * image. The file is read sequentially by a reader thread with large
+ * reads at offsets that are multiples of the read block size. The frames
+ * are decoded by a pool of worker threads, up to `lookAhead_` frames ahead
+ * of `getFrame` (see `FramePrefetcher`), so the main loop only waits if
+ * decoding is slower than the consumer. Invalid poses (infinite entries) are returned as
+ * `std::nullopt`. The poses are rotated from the z-up world of ScanNet to
+ * the y-down world of `TUMDataset`. The depth intrinsics define the camera,
+ * and the color image must be registered to the depth image (same
+ * extrinsics, same intrinsics up to the image extents), otherwise the
+ * constructor throws.
+ ***********************************************************************/
+class SensStreamLoader : public DataLoader {
+
+public:
+
+	/** @brief	Size of the blocks read from the file.
+	  */
+	static inline constexpr std::size_t READ_BLOCK_SIZE = 4U << 20;
+
+	/** @brief	Constructor.
+	  * @param	path_			Path to the .sens file.
+	  * @param	numThreads_		Number of decoding threads. If 0, the number of hardware threads is used.
+	  * @param	lookAhead_		Maximal number of frames read and decoded ahead of `getFrame`.
+	  */
+	SensStreamLoader(
+		const std::filesystem::path& path_,
+		std::uint32_t numThreads_ = 0U,
+		std::uint32_t lookAhead_ = 8U
+	);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	SensStreamLoader(const SensStreamLoader&) = delete;
+	SensStreamLoader(SensStreamLoader&&) = delete;
+	SensStreamLoader& operator=(const SensStreamLoader&) = delete;
+	SensStreamLoader& operator=(SensStreamLoader&&) = delete;
+
+	/** @brief	Destructor. Stop the reader and the workers.
+	  */
+	virtual ~SensStreamLoader(void) override {}
+
+	/** @brief	Get the size of input color frames.
+	  */
+	virtual vk::Extent2D colorFrameExtent(void) override { return this->_colorExtent; }
+
+	/** @brief	Get the size of input depth frames.
+	  */
+	virtual vk::Extent2D depthFrameExtent(void) override { return this->_depthExtent; }
+
+	/** @brief	Get the layout of input color frames. The images are decoded as packed RGB.
+	  */
+	virtual ColorFormat colorFormat(void) override { return ColorFormat::RGB888; }
+
+	/** @brief	Get the lower bound of valid depth.
+	  */
+	virtual float minDepth(void) override { return 0.01f; }
+
+	/** @brief	Get the upper bound of valid depth.
+	  */
+	virtual float maxDepth(void) override { return 100.0f; }
+
+	/** @brief	Get the invalid depth value.
+	  */
+	virtual float invalidDepth(void) override { return 0.0f; }
+
+	/** @brief	Get the initial pose for the first frame.
+	  */
+	virtual jjyou::glsl::mat4 initialPose(void) override { return this->_initialPose; }
+
+	/** @brief	Get a new frame.
+	  */
+	virtual FrameData getFrame(void) override;
+
+	/** @brief	Get the number of frames in the file.
+	  */
+	std::uint64_t numFrames(void) const { return this->_numFrames; }
+
+	/** @brief	Get the prefetcher.
+	  */
+	virtual const FramePrefetcher* prefetcher(void) const override { return this->_pPrefetcher.get(); }
+
+	/** @brief	Register the ingest metrics of the prefetcher.
+	  */
+	virtual void setMetrics(MetricsRegistry* pMetrics_) override { this->_pPrefetcher->setMetrics(pMetrics_); }
+
+private:
+
+	/** @brief	Compression types of the .sens format.
+	  */
+	enum class _ColorCompression : std::int32_t { Raw = 0, PNG = 1, JPEG = 2 };
+	enum class _DepthCompression : std::int32_t { Raw = 0, Zlib = 1 };
+
+	std::filesystem::path _path{};
+	vk::Extent2D _colorExtent{};
+	vk::Extent2D _depthExtent{};
+	_ColorCompression _colorCompression = _ColorCompression::JPEG;
+	_DepthCompression _depthCompression = _DepthCompression::Zlib;
+	float _depthShift = 1000.0f;
+	std::uint64_t _numFrames = 0ULL;
+	Camera _camera{};
+	jjyou::glsl::mat4 _initialPose = jjyou::glsl::mat4(1.0f);
+	std::optional<jjyou::glsl::mat4> _firstView = std::nullopt; // Read in the constructor.
+	std::uint32_t _frameIndex = 0;
+
+	// File reading. Only the reader thread uses them after construction.
+	std::ifstream _file{};
+	std::vector<char> _readBuffer{};
+	std::size_t _readBufferBegin = 0U;
+	std::size_t _readBufferEnd = 0U;
+	std::size_t _numBytesRead = 0U;
+
+	// Declared last, so that the threads are stopped before the other members are destroyed.
+	std::unique_ptr<FramePrefetcher> _pPrefetcher{};
+
+	/** @brief	Read bytes from the file through the block buffer.
+	  */
+	void _read(void* dst_, std::size_t size_);
+
+	/** @brief	Read a camera-to-world matrix and convert it to a view matrix.
+	  * @return	The view matrix, or std::nullopt if the pose is invalid.
+	  */
+	std::optional<jjyou::glsl::mat4> _readView(void);
+
+	/** @brief	Read the pose and the compressed data of the next frame into a slot.
+	  * @return	The number of bytes read from the file.
+	  */
+	std::size_t _readFrame(FramePrefetcher::Slot& slot_);
+
+	/** @brief	Decode the compressed data of a slot.
+	  */
+	void _decodeSlot(FramePrefetcher::Slot& slot_) const;
 
 };
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "DescriptorAllocator.hpp"
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#define VK_THROW(err) \
+	throw std::runtime_error("[DescriptorAllocator] Vulkan error in file " + std::string(__FILE__) + " line " + std::to_string(__LINE__) + ": " + vk::to_string(err))
+
+#define VK_CHECK(value) \
+	if (vk::Result err = (value); err != vk::Result::eSuccess) { VK_THROW(err); }
+
+void PooledDescriptorSet::clear(void) {
+	if (this->_pAllocator != nullptr && this->_descriptorSet)
+		this->_pAllocator->_release(this->_descriptorSetLayout, this->_descriptorSet);
+	this->_pAllocator = nullptr;
+	this->_descriptorSetLayout = nullptr;
+	this->_descriptorSet = nullptr;
+}
+
+DescriptorAllocator::DescriptorAllocator(
+	const vk::raii::Device& device_,
+	std::uint32_t numFrames_,
+	std::uint32_t initialPoolSize_
+) : _pDevice(&device_), _initialPoolSize(initialPoolSize_), _numFrames(numFrames_)
+{
+	if (initialPoolSize_ == 0U)
+		throw std::logic_error("[DescriptorAllocator] The initial pool size must be positive.");
+}
+
+vk::raii::DescriptorSetLayout DescriptorAllocator::createDescriptorSetLayout(const vk::DescriptorSetLayoutCreateInfo& descriptorSetLayoutCreateInfo_) {
+	vk::raii::DescriptorSetLayout descriptorSetLayout(*this->_pDevice, descriptorSetLayoutCreateInfo_);
+	_Layout layout{};
+	for (std::uint32_t i = 0; i < descriptorSetLayoutCreateInfo_.bindingCount; ++i) {
+		const vk::DescriptorSetLayoutBinding& binding = descriptorSetLayoutCreateInfo_.pBindings[i];
+		auto descriptorCount = std::find_if(layout.descriptorCounts.begin(), layout.descriptorCounts.end(), [&](const vk::DescriptorPoolSize& poolSize) { return poolSize.type == binding.descriptorType; });
+		if (descriptorCount == layout.descriptorCounts.end())
+			layout.descriptorCounts.emplace_back(binding.descriptorType, binding.descriptorCount);
+		else
+			descriptorCount->descriptorCount += binding.descriptorCount;
+	}
+	if (layout.descriptorCounts.empty())
+		throw std::logic_error("[DescriptorAllocator] Descriptor set layouts without descriptors are not supported.");
+	// The handle of a destroyed layout may be reused. Descriptor sets of the old layout must not be handed out for the new one.
+	VkDescriptorSetLayout handle = static_cast<VkDescriptorSetLayout>(*descriptorSetLayout);
+	std::size_t numPendingSets = this->_pendingSets.size();
+	std::erase_if(this->_pendingSets, [&](const _PendingSet& pendingSet) { return static_cast<VkDescriptorSetLayout>(pendingSet.descriptorSetLayout) == handle; });
+	this->_statistics.numPendingSets -= static_cast<std::uint32_t>(numPendingSets - this->_pendingSets.size());
+	if (auto oldLayout = this->_layouts.find(handle); oldLayout != this->_layouts.end())
+		this->_statistics.numFreeSets -= static_cast<std::uint32_t>(oldLayout->second.freeList.size());
+	this->_layouts[handle] = std::move(layout);
+	return descriptorSetLayout;
+}
+
+PooledDescriptorSet DescriptorAllocator::allocate(vk::DescriptorSetLayout descriptorSetLayout_) {
+	auto layout = this->_layouts.find(static_cast<VkDescriptorSetLayout>(descriptorSetLayout_));
+	if (layout == this->_layouts.end())
+		throw std::logic_error("[DescriptorAllocator] The descriptor set layout was not created by this allocator.");
+	++this->_statistics.numFrameAllocations;
+	++this->_statistics.numLiveSets;
+	// Reuse a released descriptor set with the same layout.
+	std::vector<vk::DescriptorSet>& freeList = layout->second.freeList;
+	if (!freeList.empty()) {
+		vk::DescriptorSet descriptorSet = freeList.back();
+		freeList.pop_back();
+		--this->_statistics.numFreeSets;
+		return PooledDescriptorSet(*this, descriptorSetLayout_, descriptorSet);
+	}
+	// Allocate from the last pool of the layout. Chain a new pool if it is full.
+	if (layout->second.numAvailableSets == 0U) {
+		std::uint32_t poolSize = (layout->second.poolSize == 0U) ? this->_initialPoolSize : layout->second.poolSize * 2U;
+		this->_pools.push_back(this->_createPool(layout->second.descriptorCounts, poolSize));
+		++this->_statistics.numPools;
+		layout->second.pool = *this->_pools.back();
+		layout->second.poolSize = poolSize;
+		layout->second.numAvailableSets = poolSize;
+	}
+	vk::DescriptorSet descriptorSet = this->_allocateFromPool(layout->second.pool, descriptorSetLayout_);
+	--layout->second.numAvailableSets;
+	return PooledDescriptorSet(*this, descriptorSetLayout_, descriptorSet);
+}
+
+void DescriptorAllocator::beginFrame(void) {
+	this->_frameStatistics.numFrameAllocations = this->_statistics.numFrameAllocations;
+	this->_frameStatistics.numFramePoolAllocations = this->_statistics.numFramePoolAllocations;
+	this->_statistics.numFrameAllocations = 0U;
+	this->_statistics.numFramePoolAllocations = 0U;
+	++this->_frameCounter;
+	// The frames that may have used the pending descriptor sets have completed.
+	while (!this->_pendingSets.empty() && this->_pendingSets.front().releaseFrame + this->_numFrames <= this->_frameCounter) {
+		const _PendingSet& pendingSet = this->_pendingSets.front();
+		this->_layouts.at(static_cast<VkDescriptorSetLayout>(pendingSet.descriptorSetLayout)).freeList.push_back(pendingSet.descriptorSet);
+		this->_pendingSets.pop_front();
+		--this->_statistics.numPendingSets;
+		++this->_statistics.numFreeSets;
+	}
+}
+
+DescriptorAllocator::Statistics DescriptorAllocator::statistics(void) const {
+	Statistics res = this->_statistics;
+	res.numFrameAllocations = this->_frameStatistics.numFrameAllocations;
+	res.numFramePoolAllocations = this->_frameStatistics.numFramePoolAllocations;
+	return res;
+}
+
+vk::raii::DescriptorPool DescriptorAllocator::_createPool(const std::vector<vk::DescriptorPoolSize>& descriptorCounts_, std::uint32_t maxSets_) const {
+	std::vector<vk::DescriptorPoolSize> descriptorPoolSizes = descriptorCounts_;
+	for (vk::DescriptorPoolSize& descriptorPoolSize : descriptorPoolSizes)
+		descriptorPoolSize.descriptorCount *= maxSets_;
+	// No eFreeDescriptorSet flag. Descriptor sets are recycled via free lists.
+	vk::DescriptorPoolCreateInfo descriptorPoolCreateInfo = vk::DescriptorPoolCreateInfo()
+		.setFlags(vk::DescriptorPoolCreateFlags(0))
+		.setMaxSets(maxSets_)
+		.setPoolSizes(descriptorPoolSizes);
+	return vk::raii::DescriptorPool(*this->_pDevice, descriptorPoolCreateInfo);
+}
+
+vk::DescriptorSet DescriptorAllocator::_allocateFromPool(vk::DescriptorPool pool_, vk::DescriptorSetLayout descriptorSetLayout_) {
+	++this->_statistics.numFramePoolAllocations;
+	VkDescriptorSetLayout descriptorSetLayout = static_cast<VkDescriptorSetLayout>(descriptorSetLayout_);
+	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+		.pNext = nullptr,
+		.descriptorPool = static_cast<VkDescriptorPool>(pool_),
+		.descriptorSetCount = 1U,
+		.pSetLayouts = &descriptorSetLayout
+	};
+	VkDescriptorSet descriptorSet = nullptr;
+	// Call the C API directly, since the RAII API returns descriptor sets that free themselves on destruction.
+	VK_CHECK(static_cast<vk::Result>(this->_pDevice->getDispatcher()->vkAllocateDescriptorSets(
+		static_cast<VkDevice>(**this->_pDevice),
+		&descriptorSetAllocateInfo,
+		&descriptorSet
+	)));
+	return descriptorSet;
+}
+
+void DescriptorAllocator::_release(vk::DescriptorSetLayout descriptorSetLayout_, vk::DescriptorSet descriptorSet_) {
+	this->_pendingSets.push_back(_PendingSet{
+		.releaseFrame = this->_frameCounter,
+		.descriptorSetLayout = descriptorSetLayout_,
+		.descriptorSet = descriptorSet_
+	});
+	--this->_statistics.numLiveSets;
+	++this->_statistics.numPendingSets;
+}
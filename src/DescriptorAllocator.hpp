@@ -0,0 +1,239 @@
+#pragma once
+#include <vulkan/vulkan_raii.hpp>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <stdexcept>
+
+class DescriptorAllocator;
+
+/***********************************************************************
+ * @class	PooledDescriptorSet
+ * @brief	RAII wrapper of a descriptor set allocated by `DescriptorAllocator`.
+ *
+ * On destruction, the descriptor set is not freed but returned to the
+ * allocator, which reuses it for a later allocation with the same layout
+ * once the frames that may still reference it have completed.
+ ***********************************************************************/
+class PooledDescriptorSet {
+
+public:
+
+	/** @brief	Construct an empty descriptor set in invalid state.
+	  */
+	PooledDescriptorSet(std::nullptr_t) {}
+
+	/** @brief	Copy constructor is disabled.
+	  */
+	PooledDescriptorSet(const PooledDescriptorSet&) = delete;
+
+	/** @brief	Move constructor.
+	  */
+	PooledDescriptorSet(PooledDescriptorSet&& other_) noexcept :
+		_pAllocator(other_._pAllocator),
+		_descriptorSetLayout(other_._descriptorSetLayout),
+		_descriptorSet(other_._descriptorSet)
+	{
+		other_._pAllocator = nullptr;
+		other_._descriptorSetLayout = nullptr;
+		other_._descriptorSet = nullptr;
+	}
+
+	/** @brief	Copy assignment is disabled.
+	  */
+	PooledDescriptorSet& operator=(const PooledDescriptorSet&) = delete;
+
+	/** @brief	Move assignment.
+	  */
+	PooledDescriptorSet& operator=(PooledDescriptorSet&& other_) noexcept {
+		if (this != &other_) {
+			this->clear();
+			this->_pAllocator = other_._pAllocator;
+			this->_descriptorSetLayout = other_._descriptorSetLayout;
+			this->_descriptorSet = other_._descriptorSet;
+			other_._pAllocator = nullptr;
+			other_._descriptorSetLayout = nullptr;
+			other_._descriptorSet = nullptr;
+		}
+		return *this;
+	}
+
+	/** @brief	Destructor.
+	  */
+	~PooledDescriptorSet(void) {
+		this->clear();
+	}
+
+	/** @brief	Return the descriptor set to the allocator.
+	  */
+	void clear(void);
+
+	/** @brief	Get the vulkan descriptor set.
+	  */
+	vk::DescriptorSet operator*(void) const { return this->_descriptorSet; }
+
+	/** @brief	Get the descriptor set layout.
+	  */
+	vk::DescriptorSetLayout descriptorSetLayout(void) const { return this->_descriptorSetLayout; }
+
+private:
+
+	DescriptorAllocator* _pAllocator = nullptr;
+	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr };
+	vk::DescriptorSet _descriptorSet{ nullptr };
+
+	PooledDescriptorSet(
+		DescriptorAllocator& allocator_,
+		vk::DescriptorSetLayout descriptorSetLayout_,
+		vk::DescriptorSet descriptorSet_
+	) : _pAllocator(&allocator_), _descriptorSetLayout(descriptorSetLayout_), _descriptorSet(descriptorSet_) {}
+
+	friend class DescriptorAllocator;
+
+};
+
+/***********************************************************************
+ * @class	DescriptorAllocator
+ * @brief	Descriptor set allocator that grows on demand.
+ *
+ * Descriptor set layouts are created through `createDescriptorSetLayout`,
+ * which records the number of descriptors of each type that a set of the
+ * layout needs. Every layout owns a chain of pools sized exactly for it.
+ * When the last pool of a layout is full, a new pool twice as large is
+ * chained. Since the allocator counts the sets allocated from each pool,
+ * it never relies on `vkAllocateDescriptorSets` reporting pool exhaustion,
+ * which is only guaranteed with Vulkan 1.1 or `VK_KHR_maintenance1`.
+ *
+ * Descriptor sets live as long as the returned `PooledDescriptorSet`.
+ * A released descriptor set may still be referenced by command buffers of
+ * the frames in flight, so it is not reused immediately. It is kept in a
+ * pending list together with the frame it was released in, and moved to
+ * the free list of its layout by `beginFrame` once `numFrames_` more frames
+ * have begun, i.e. once the frame fence that guarded its last use has been
+ * waited for. Later allocations with the same layout reuse it without
+ * calling `vkAllocateDescriptorSets`.
+ *
+ * There are no per-frame pools that are reset wholesale: no descriptor set
+ * is allocated per frame. Resources that change every frame own one
+ * descriptor set per frame in flight, which is allocated once and
+ * rewritten when the resource is recreated.
+ *
+ * The allocator counts the calls to `vkAllocateDescriptorSets` in every frame,
+ * so that descriptor allocations in hot paths can be detected.
+ ***********************************************************************/
+class DescriptorAllocator {
+
+public:
+
+	/** @brief	Allocation statistics.
+	  */
+	struct Statistics {
+		std::uint32_t numPools = 0U;				//!< Number of pools.
+		std::uint32_t numLiveSets = 0U;				//!< Number of descriptor sets in use.
+		std::uint32_t numPendingSets = 0U;			//!< Number of released descriptor sets that frames in flight may still use.
+		std::uint32_t numFreeSets = 0U;				//!< Number of descriptor sets in free lists.
+		std::uint32_t numFrameAllocations = 0U;		//!< Number of `allocate` calls in the last frame.
+		std::uint32_t numFramePoolAllocations = 0U;	//!< Number of `vkAllocateDescriptorSets` calls in the last frame.
+	};
+
+	/** @brief	Construct an empty allocator in invalid state.
+	  */
+	DescriptorAllocator(std::nullptr_t) {}
+
+	/** @brief	Constructor.
+	  * @param	device_				The Vulkan device.
+	  * @param	numFrames_			Number of frames in flight, i.e. number of frames before a released descriptor set is reused.
+	  * @param	initialPoolSize_	Maximum number of descriptor sets in the first pool of each layout.
+	  */
+	DescriptorAllocator(
+		const vk::raii::Device& device_,
+		std::uint32_t numFrames_,
+		std::uint32_t initialPoolSize_
+	);
+
+	/** @brief	Copy constructor is disabled.
+	  */
+	DescriptorAllocator(const DescriptorAllocator&) = delete;
+
+	/** @brief	Move constructor.
+	  */
+	DescriptorAllocator(DescriptorAllocator&& other_) = default;
+
+	/** @brief	Copy assignment is disabled.
+	  */
+	DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+	/** @brief	Move assignment.
+	  * @note	Only an allocator without live descriptor sets can be moved.
+	  */
+	DescriptorAllocator& operator=(DescriptorAllocator&& other_) noexcept {
+		if (this != &other_) {
+			this->_pDevice = other_._pDevice;
+			this->_initialPoolSize = other_._initialPoolSize;
+			this->_pools = std::move(other_._pools);
+			this->_layouts = std::move(other_._layouts);
+			this->_pendingSets = std::move(other_._pendingSets);
+			this->_numFrames = other_._numFrames;
+			this->_frameCounter = other_._frameCounter;
+			this->_statistics = other_._statistics;
+			this->_frameStatistics = other_._frameStatistics;
+		}
+		return *this;
+	}
+
+	/** @brief	Destructor.
+	  */
+	~DescriptorAllocator(void) = default;
+
+	/** @brief	Create a descriptor set layout whose descriptor sets can be allocated by this allocator.
+	  */
+	vk::raii::DescriptorSetLayout createDescriptorSetLayout(const vk::DescriptorSetLayoutCreateInfo& descriptorSetLayoutCreateInfo_);
+
+	/** @brief	Allocate a descriptor set.
+	  * @param	descriptorSetLayout_	A layout created by `createDescriptorSetLayout`.
+	  */
+	PooledDescriptorSet allocate(vk::DescriptorSetLayout descriptorSetLayout_);
+
+	/** @brief	Begin a new frame. Recycle the descriptor sets released `numFrames_` frames ago
+	  *			and reset the per-frame statistics.
+	  * @note	The caller must have waited for the fence of the frame that begins, so that
+	  *			all frames up to `numFrames_` frames ago have completed.
+	  */
+	void beginFrame(void);
+
+	/** @brief	Get the allocation statistics.
+	  *			Per-frame counters refer to the last completed frame.
+	  */
+	Statistics statistics(void) const;
+
+private:
+
+	const vk::raii::Device* _pDevice = nullptr;
+	std::uint32_t _initialPoolSize = 0U;
+	std::vector<vk::raii::DescriptorPool> _pools{};
+	struct _Layout {
+		std::vector<vk::DescriptorPoolSize> descriptorCounts{};		// Number of descriptors of each type in one set.
+		vk::DescriptorPool pool{ nullptr };							// The last pool of the layout, owned by `_pools`.
+		std::uint32_t poolSize = 0U;								// Maximum number of descriptor sets in `pool`.
+		std::uint32_t numAvailableSets = 0U;						// Number of descriptor sets that `pool` can still allocate.
+		std::vector<vk::DescriptorSet> freeList{};
+	};
+	std::unordered_map<VkDescriptorSetLayout, _Layout> _layouts{};
+	struct _PendingSet {
+		std::uint64_t releaseFrame = 0ULL;
+		vk::DescriptorSetLayout descriptorSetLayout{ nullptr };
+		vk::DescriptorSet descriptorSet{ nullptr };
+	};
+	std::deque<_PendingSet> _pendingSets{};		// Ordered by release frame
+	std::uint32_t _numFrames = 0U;
+	std::uint64_t _frameCounter = 0ULL;
+	Statistics _statistics{};
+	Statistics _frameStatistics{};
+
+	vk::raii::DescriptorPool _createPool(const std::vector<vk::DescriptorPoolSize>& descriptorCounts_, std::uint32_t maxSets_) const;
+	vk::DescriptorSet _allocateFromPool(vk::DescriptorPool pool_, vk::DescriptorSetLayout descriptorSetLayout_);
+	void _release(vk::DescriptorSetLayout descriptorSetLayout_, vk::DescriptorSet descriptorSet_);
+
+	friend class PooledDescriptorSet;
+
+};
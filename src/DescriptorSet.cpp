@@ -1,6 +1,8 @@
 #include "DescriptorSet.hpp"
 #include "Engine.hpp"
 #include "KinectFusion.hpp"
+#include <algorithm>
+#include <set>
 
 #define VK_THROW(err) \
 	throw std::runtime_error("[DescriptorSet] Vulkan error in file " + std::string(__FILE__) + " line " + std::to_string(__LINE__) + ": " + vk::to_string(err))
@@ -8,19 +10,30 @@
 #define VK_CHECK(value) \
 	if (vk::Result err = (value); err != vk::Result::eSuccess) { VK_THROW(err); }
 
+namespace {
+
+	/** @brief	Get the queue families that share the buffers of tracking.
+	  *
+	  * With pipelined tracking, the frame pyramid and ICP run on the main queue,
+	  * while the model maps are ray casted and compacted on the compute queue.
+	  */
+	std::vector<std::uint32_t> trackingQueueFamilyIndices(const Engine& engine_) {
+		std::set<std::uint32_t> queueFamilyIndices = {
+			*engine_.context().queueFamilyIndex(jjyou::vk::Context::QueueType::Main),
+			*engine_.context().queueFamilyIndex(jjyou::vk::Context::QueueType::Compute)
+		};
+		return std::vector<std::uint32_t>(queueFamilyIndices.begin(), queueFamilyIndices.end());
+	}
+
+}
+
 ViewLevelDescriptorSet::ViewLevelDescriptorSet(
 	const Engine & engine_
 ) :
 	_pEngine(&engine_), _descriptorSetLayout(*engine_.viewLevelDescriptorSetLayout())
 {
 	// Create descriptor set
-	{
-		vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo()
-			.setDescriptorPool(*this->_pEngine->descriptorPool())
-			.setDescriptorSetCount(1)
-			.setSetLayouts(this->_descriptorSetLayout);
-		this->_descriptorSet = std::move(this->_pEngine->context().device().allocateDescriptorSets(descriptorSetAllocateInfo)[0]);
-	}
+	this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
 	// Create uniform buffer for binding 0
 	{
 		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
@@ -68,44 +81,62 @@ InstanceLevelDescriptorSet::InstanceLevelDescriptorSet(
 	const Engine& engine_,
 	std::uint32_t numModelTransforms_
 ) :
-	_pEngine(&engine_), _descriptorSetLayout(*engine_.instanceLevelDescriptorSetLayout()), _numModelTransforms(numModelTransforms_)
+	_pEngine(&engine_), _descriptorSetLayout(*engine_.instanceLevelDescriptorSetLayout())
 {
 	// Create descriptor set
+	this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
+	// Create storage buffer for binding 0 and update the descriptor set
+	this->_createModelTransformsBuffer(numModelTransforms_);
+}
+
+void InstanceLevelDescriptorSet::reserve(std::uint32_t numModelTransforms_) {
+	if (numModelTransforms_ <= this->_numModelTransforms)
+		return;
+	std::uint32_t numModelTransforms = std::max(this->_numModelTransforms, 1U);
+	while (numModelTransforms < numModelTransforms_)
+		numModelTransforms *= 2U;
+	this->_createModelTransformsBuffer(numModelTransforms);
+}
+
+void InstanceLevelDescriptorSet::flush(std::uint32_t numModelTransforms_) const {
+	if (numModelTransforms_ == 0U)
+		return;
+	// No-op if the memory is host coherent.
+	VK_CHECK(static_cast<vk::Result>(vmaFlushAllocation(
+		*this->_pEngine->allocator(),
+		*this->_modelTransformsBufferMemory,
+		0,
+		sizeof(InstanceLevelDescriptorSet::ModelTransforms) * static_cast<VkDeviceSize>(numModelTransforms_)
+	)));
+}
+
+void InstanceLevelDescriptorSet::_createModelTransformsBuffer(std::uint32_t numModelTransforms_) {
+	this->_numModelTransforms = numModelTransforms_;
+	// Create storage buffer for binding 0
 	{
-		vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo()
-			.setDescriptorPool(*this->_pEngine->descriptorPool())
-			.setDescriptorSetCount(1)
-			.setSetLayouts(this->_descriptorSetLayout);
-		this->_descriptorSet = std::move(this->_pEngine->context().device().allocateDescriptorSets(descriptorSetAllocateInfo)[0]);
-	}
-	// Create uniform buffer for binding 0
-	{
-		vk::DeviceSize minAlignment = this->_pEngine->context().physicalDevice().getProperties().limits.minUniformBufferOffsetAlignment;
-		this->_modelTransformsBufferOffset = sizeof(InstanceLevelDescriptorSet::ModelTransforms);
-		if (minAlignment > 0)
-			this->_modelTransformsBufferOffset = (this->_modelTransformsBufferOffset + minAlignment - 1) & ~(minAlignment - 1);
 		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
 			.setFlags(vk::BufferCreateFlags(0))
-			.setSize(this->_modelTransformsBufferOffset * static_cast<vk::DeviceSize>(this->_numModelTransforms))
-			.setUsage(vk::BufferUsageFlagBits::eUniformBuffer)
+			.setSize(sizeof(InstanceLevelDescriptorSet::ModelTransforms) * static_cast<vk::DeviceSize>(this->_numModelTransforms))
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
 			.setSharingMode(vk::SharingMode::eExclusive)
 			.setQueueFamilyIndices(nullptr);
+		// Host coherent memory is not required, as the written range is flushed once per frame.
 		VmaAllocationCreateInfo vmaAllocationCreateInfo{
 			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
 			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
-			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
 			.memoryTypeBits = 0,
 			.pool = nullptr,
 			.pUserData = nullptr,
 			.priority = 0.0f,
 		};
-		VkBuffer uniformBuffer = nullptr;
-		VmaAllocation uniformBufferMemory = nullptr;
+		VkBuffer storageBuffer = nullptr;
+		VmaAllocation storageBufferMemory = nullptr;
 		VmaAllocationInfo allocationInfo{};
-		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &uniformBuffer, &uniformBufferMemory, &allocationInfo);
-		this->_modelTransformsBuffer = vk::raii::Buffer(this->_pEngine->context().device(), uniformBuffer);
-		this->_modelTransformsBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), uniformBufferMemory);
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &storageBuffer, &storageBufferMemory, &allocationInfo);
+		this->_modelTransformsBuffer = vk::raii::Buffer(this->_pEngine->context().device(), storageBuffer);
+		this->_modelTransformsBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), storageBufferMemory);
 		this->_modelTransformsBufferMemoryMappedAddress = allocationInfo.pMappedData;
 	}
 	// Update the descriptor set
@@ -113,13 +144,13 @@ InstanceLevelDescriptorSet::InstanceLevelDescriptorSet(
 		vk::DescriptorBufferInfo descriptorBufferInfo = vk::DescriptorBufferInfo()
 			.setBuffer(*this->_modelTransformsBuffer)
 			.setOffset(0)
-			.setRange(sizeof(InstanceLevelDescriptorSet::ModelTransforms));
+			.setRange(VK_WHOLE_SIZE);
 		vk::WriteDescriptorSet writeDescriptorSet = vk::WriteDescriptorSet()
 			.setDstSet(*this->_descriptorSet)
 			.setDstBinding(0)
 			.setDstArrayElement(0)
 			.setDescriptorCount(1)
-			.setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
+			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
 			.setBufferInfo(descriptorBufferInfo);
 		this->_pEngine->context().device().updateDescriptorSets(writeDescriptorSet, nullptr);
 	}
@@ -132,13 +163,7 @@ RayCastingDescriptorSet::RayCastingDescriptorSet(
 	_pEngine(&engine_), _pKinectFusion(&kinectFusion_), _descriptorSetLayout(*kinectFusion_.rayCastingDescriptorSetLayout())
 {
 	// Create descriptor set
-	{
-		vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo()
-			.setDescriptorPool(*this->_pEngine->descriptorPool())
-			.setDescriptorSetCount(1)
-			.setSetLayouts(this->_descriptorSetLayout);
-		this->_descriptorSet = std::move(this->_pEngine->context().device().allocateDescriptorSets(descriptorSetAllocateInfo)[0]);
-	}
+	this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
 	// Create uniform buffer for binding 0
 	{
 		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
@@ -182,20 +207,88 @@ RayCastingDescriptorSet::RayCastingDescriptorSet(
 	}
 }
 
-FusionDescriptorSet::FusionDescriptorSet(
+BatchRayCastingDescriptorSet::BatchRayCastingDescriptorSet(
 	const Engine& engine_,
 	const KinectFusion& kinectFusion_
 ) :
-	_pEngine(&engine_), _pKinectFusion(&kinectFusion_), _descriptorSetLayout(*kinectFusion_.fusionDescriptorSetLayout())
+	_pEngine(&engine_), _pKinectFusion(&kinectFusion_), _descriptorSetLayout(*kinectFusion_.batchRayCastingDescriptorSetLayout())
 {
 	// Create descriptor set
+	this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
+	// Create uniform buffer for binding 0
 	{
-		vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo()
-			.setDescriptorPool(*this->_pEngine->descriptorPool())
-			.setDescriptorSetCount(1)
-			.setSetLayouts(this->_descriptorSetLayout);
-		this->_descriptorSet = std::move(this->_pEngine->context().device().allocateDescriptorSets(descriptorSetAllocateInfo)[0]);
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(sizeof(BatchRayCastingDescriptorSet::BatchRayCastingParameters))
+			.setUsage(vk::BufferUsageFlagBits::eUniformBuffer)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer uniformBuffer = nullptr;
+		VmaAllocation uniformBufferMemory = nullptr;
+		VmaAllocationInfo allocationInfo{};
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &uniformBuffer, &uniformBufferMemory, &allocationInfo);
+		this->_batchRayCastingParametersBuffer = vk::raii::Buffer(this->_pEngine->context().device(), uniformBuffer);
+		this->_batchRayCastingParametersBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), uniformBufferMemory);
+		this->_batchRayCastingParametersBufferMemoryMappedAddress = allocationInfo.pMappedData;
 	}
+	// Update the descriptor set. The images are written by `setImageViews`.
+	{
+		vk::DescriptorBufferInfo descriptorBufferInfo = vk::DescriptorBufferInfo()
+			.setBuffer(*this->_batchRayCastingParametersBuffer)
+			.setOffset(0)
+			.setRange(sizeof(BatchRayCastingDescriptorSet::BatchRayCastingParameters));
+		vk::WriteDescriptorSet writeDescriptorSet = vk::WriteDescriptorSet()
+			.setDstSet(*this->_descriptorSet)
+			.setDstBinding(0)
+			.setDstArrayElement(0)
+			.setDescriptorCount(1)
+			.setDescriptorType(vk::DescriptorType::eUniformBuffer)
+			.setBufferInfo(descriptorBufferInfo);
+		this->_pEngine->context().device().updateDescriptorSets(writeDescriptorSet, nullptr);
+	}
+}
+
+void BatchRayCastingDescriptorSet::setImageViews(const std::vector<std::array<vk::ImageView, 3>>& imageViews_) const {
+	if (imageViews_.empty() || imageViews_.size() > BatchRayCastingDescriptorSet::MAX_VIEWS) {
+		throw std::logic_error("[BatchRayCastingDescriptorSet] The number of views must be between 1 and " + std::to_string(BatchRayCastingDescriptorSet::MAX_VIEWS) + ".");
+	}
+	std::array<std::array<vk::DescriptorImageInfo, BatchRayCastingDescriptorSet::MAX_VIEWS>, 3> descriptorImageInfos{};
+	std::array<vk::WriteDescriptorSet, 3> writeDescriptorSets{};
+	for (std::uint32_t i = 0; i < 3; ++i) {
+		for (std::uint32_t view = 0; view < BatchRayCastingDescriptorSet::MAX_VIEWS; ++view) {
+			descriptorImageInfos[i][view]
+				.setSampler(nullptr)
+				.setImageView(imageViews_[view < imageViews_.size() ? view : 0][i])
+				.setImageLayout(vk::ImageLayout::eGeneral);
+		}
+		writeDescriptorSets[i]
+			.setDstSet(*this->_descriptorSet)
+			.setDstBinding(i + 1)
+			.setDstArrayElement(0)
+			.setDescriptorType(vk::DescriptorType::eStorageImage)
+			.setImageInfo(descriptorImageInfos[i]);
+	}
+	this->_pEngine->context().device().updateDescriptorSets(writeDescriptorSets, nullptr);
+}
+
+FusionDescriptorSet::FusionDescriptorSet(
+	const Engine& engine_,
+	const KinectFusion& kinectFusion_
+) :
+	_pEngine(&engine_), _pKinectFusion(&kinectFusion_), _descriptorSetLayout(*kinectFusion_.fusionDescriptorSetLayout())
+{
+	// Create descriptor set
+	this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
 	// Create uniform buffer for binding 0
 	{
 		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
@@ -247,22 +340,18 @@ ICPDescriptorSet::ICPDescriptorSet(
 	_pEngine(&engine_),
 	_pKinectFusion(&kinectFusion_),
 	_descriptorSetLayout(*kinectFusion_.icpDescriptorSetLayout()),
-	_globalSumBufferSize(sizeof(float) * 27ULL * static_cast<vk::DeviceSize>(globalSumBufferLength_))
+	_globalSumBufferSize(sizeof(float) * ICPDescriptorSet::NUM_SUM_TERMS * ICPDescriptorSet::MAX_NUM_HYPOTHESES * static_cast<vk::DeviceSize>(globalSumBufferLength_))
 {
 	// Create descriptor set
-	{
-		vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo()
-			.setDescriptorPool(*this->_pEngine->descriptorPool())
-			.setDescriptorSetCount(1)
-			.setSetLayouts(this->_descriptorSetLayout);
-		this->_descriptorSet = std::move(this->_pEngine->context().device().allocateDescriptorSets(descriptorSetAllocateInfo)[0]);
-	}
+	this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
 	// Create uniform buffer for binding 0
 	this->_createUniformBufferBinding0();
 	// Create storage buffer for binding 1
 	this->_createStorageBufferBinding1();
 	// Create storage buffer for binding 2
 	this->_createStorageBufferBinding2();
+	// Create storage buffer for binding 3
+	this->_createStorageBufferBinding3();
 	// Update the descriptor set
 	{
 		std::vector<vk::DescriptorBufferInfo> descriptorBufferInfos = {
@@ -278,6 +367,10 @@ ICPDescriptorSet::ICPDescriptorSet(
 			.setBuffer(*this->_reductionResultBuffer)
 			.setOffset(0)
 			.setRange(sizeof(ICPDescriptorSet::ReductionResult)),
+			vk::DescriptorBufferInfo()
+			.setBuffer(*this->_icpStateBuffer)
+			.setOffset(0)
+			.setRange(sizeof(ICPDescriptorSet::ICPState)),
 		};
 		std::vector<vk::WriteDescriptorSet> writeDescriptorSets = {
 			vk::WriteDescriptorSet()
@@ -301,18 +394,26 @@ ICPDescriptorSet::ICPDescriptorSet(
 			.setDescriptorCount(1)
 			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
 			.setBufferInfo(descriptorBufferInfos[2]),
+			vk::WriteDescriptorSet()
+			.setDstSet(*this->_descriptorSet)
+			.setDstBinding(3)
+			.setDstArrayElement(0)
+			.setDescriptorCount(1)
+			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+			.setBufferInfo(descriptorBufferInfos[3]),
 		};
 		this->_pEngine->context().device().updateDescriptorSets(writeDescriptorSets, nullptr);
 	}
 }
 
 void ICPDescriptorSet::_createUniformBufferBinding0(void) {
+	std::vector<std::uint32_t> queueFamilyIndices = trackingQueueFamilyIndices(*this->_pEngine);
 	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
 		.setFlags(vk::BufferCreateFlags(0))
 		.setSize(sizeof(ICPDescriptorSet::ICPParameters))
 		.setUsage(vk::BufferUsageFlagBits::eUniformBuffer)
-		.setSharingMode(vk::SharingMode::eExclusive)
-		.setQueueFamilyIndices(nullptr);
+		.setSharingMode(queueFamilyIndices.size() >= 2 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(queueFamilyIndices);
 	VmaAllocationCreateInfo vmaAllocationCreateInfo{
 		.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
 		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
@@ -333,12 +434,13 @@ void ICPDescriptorSet::_createUniformBufferBinding0(void) {
 }
 
 void ICPDescriptorSet::_createStorageBufferBinding1(void) {
+	std::vector<std::uint32_t> queueFamilyIndices = trackingQueueFamilyIndices(*this->_pEngine);
 	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
 		.setFlags(vk::BufferCreateFlags(0))
 		.setSize(this->_globalSumBufferSize)
 		.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
-		.setSharingMode(vk::SharingMode::eExclusive)
-		.setQueueFamilyIndices(nullptr);
+		.setSharingMode(queueFamilyIndices.size() >= 2 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(queueFamilyIndices);
 	VmaAllocationCreateInfo vmaAllocationCreateInfo{
 		.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
 		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
@@ -356,12 +458,13 @@ void ICPDescriptorSet::_createStorageBufferBinding1(void) {
 	this->_globalSumBufferBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), storageBufferMemory);
 }
 void ICPDescriptorSet::_createStorageBufferBinding2(void) {
+	std::vector<std::uint32_t> queueFamilyIndices = trackingQueueFamilyIndices(*this->_pEngine);
 	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
 		.setFlags(vk::BufferCreateFlags(0))
 		.setSize(sizeof(ICPDescriptorSet::ReductionResult))
 		.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
-		.setSharingMode(vk::SharingMode::eExclusive)
-		.setQueueFamilyIndices(nullptr);
+		.setSharingMode(queueFamilyIndices.size() >= 2 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(queueFamilyIndices);
 	VmaAllocationCreateInfo vmaAllocationCreateInfo{
 		.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
 		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
@@ -379,4 +482,263 @@ void ICPDescriptorSet::_createStorageBufferBinding2(void) {
 	this->_reductionResultBuffer = vk::raii::Buffer(this->_pEngine->context().device(), storageBuffer);
 	this->_reductionResultBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), storageBufferMemory);
 	this->_reductionResultBufferMemoryMappedAddress = allocationInfo.pMappedData;
-}
\ No newline at end of file
+}
+
+void ICPDescriptorSet::_createStorageBufferBinding3(void) {
+	std::vector<std::uint32_t> queueFamilyIndices = trackingQueueFamilyIndices(*this->_pEngine);
+	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+		.setFlags(vk::BufferCreateFlags(0))
+		.setSize(sizeof(ICPDescriptorSet::ICPState))
+		.setUsage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst)
+		.setSharingMode(queueFamilyIndices.size() >= 2 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(queueFamilyIndices);
+	VmaAllocationCreateInfo vmaAllocationCreateInfo{
+		.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+		.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.memoryTypeBits = 0,
+		.pool = nullptr,
+		.pUserData = nullptr,
+		.priority = 0.0f,
+	};
+	VkBuffer storageBuffer = nullptr;
+	VmaAllocation storageBufferMemory = nullptr;
+	VmaAllocationInfo allocationInfo{};
+	vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &storageBuffer, &storageBufferMemory, &allocationInfo);
+	this->_icpStateBuffer = vk::raii::Buffer(this->_pEngine->context().device(), storageBuffer);
+	this->_icpStateBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), storageBufferMemory);
+	this->_icpStateBufferMemoryMappedAddress = allocationInfo.pMappedData;
+}
+
+ValidPixelsDescriptorSet::ValidPixelsDescriptorSet(
+	const Engine& engine_,
+	const KinectFusion& kinectFusion_,
+	vk::Extent2D extent_
+) :
+	_pEngine(&engine_),
+	_pKinectFusion(&kinectFusion_),
+	_descriptorSetLayout(*kinectFusion_.validPixelsDescriptorSetLayout()),
+	_extent(extent_)
+{
+	// Create descriptor set
+	this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
+	// Create storage buffer for binding 0
+	this->_createStorageBufferBinding0();
+	// Create storage buffer for binding 1
+	this->_createStorageBufferBinding1();
+	// Create storage buffer for binding 2
+	this->_createStorageBufferBinding2();
+	// Update the descriptor set
+	{
+		std::array<vk::DescriptorBufferInfo, 3> descriptorBufferInfos = { {
+			vk::DescriptorBufferInfo()
+			.setBuffer(*this->_validityMaskBuffer)
+			.setOffset(0)
+			.setRange(this->_validityMaskBufferSize()),
+			vk::DescriptorBufferInfo()
+			.setBuffer(*this->_validPixelsBuffer)
+			.setOffset(0)
+			.setRange(this->_validPixelsBufferSize()),
+			vk::DescriptorBufferInfo()
+			.setBuffer(*this->_validPixelsCounterBuffer)
+			.setOffset(0)
+			.setRange(sizeof(ValidPixelsDescriptorSet::ValidPixelsCounter))
+		} };
+		std::array<vk::WriteDescriptorSet, 3> writeDescriptorSets{};
+		for (std::uint32_t i = 0; i < 3; ++i) {
+			writeDescriptorSets[i]
+				.setDstSet(*this->_descriptorSet)
+				.setDstBinding(i)
+				.setDstArrayElement(0)
+				.setDescriptorCount(1)
+				.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+				.setBufferInfo(descriptorBufferInfos[i]);
+		}
+		this->_pEngine->context().device().updateDescriptorSets(writeDescriptorSets, nullptr);
+	}
+}
+
+void ValidPixelsDescriptorSet::reset(const vk::raii::CommandBuffer& commandBuffer_) const {
+	commandBuffer_.fillBuffer(*this->_validityMaskBuffer, 0ULL, VK_WHOLE_SIZE, 0U);
+	// Zero the counter and the number of work groups along x. The y and z dimensions are always 1.
+	commandBuffer_.fillBuffer(*this->_validPixelsCounterBuffer, 0ULL, 2ULL * sizeof(std::uint32_t), 0U);
+	commandBuffer_.fillBuffer(*this->_validPixelsCounterBuffer, 2ULL * sizeof(std::uint32_t), 2ULL * sizeof(std::uint32_t), 1U);
+}
+
+void ValidPixelsDescriptorSet::_createStorageBufferBinding0(void) {
+	std::vector<std::uint32_t> queueFamilyIndices = trackingQueueFamilyIndices(*this->_pEngine);
+	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+		.setFlags(vk::BufferCreateFlags(0))
+		.setSize(this->_validityMaskBufferSize())
+		.setUsage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst)
+		.setSharingMode(queueFamilyIndices.size() >= 2 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(queueFamilyIndices);
+	VmaAllocationCreateInfo vmaAllocationCreateInfo{
+		.flags = VmaAllocationCreateFlags(0),
+		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+		.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		.memoryTypeBits = 0,
+		.pool = nullptr,
+		.pUserData = nullptr,
+		.priority = 0.0f,
+	};
+	VkBuffer storageBuffer = nullptr;
+	VmaAllocation storageBufferMemory = nullptr;
+	vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &storageBuffer, &storageBufferMemory, nullptr);
+	this->_validityMaskBuffer = vk::raii::Buffer(this->_pEngine->context().device(), storageBuffer);
+	this->_validityMaskBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), storageBufferMemory);
+}
+
+void ValidPixelsDescriptorSet::_createStorageBufferBinding1(void) {
+	std::vector<std::uint32_t> queueFamilyIndices = trackingQueueFamilyIndices(*this->_pEngine);
+	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+		.setFlags(vk::BufferCreateFlags(0))
+		.setSize(this->_validPixelsBufferSize())
+		.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
+		.setSharingMode(queueFamilyIndices.size() >= 2 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(queueFamilyIndices);
+	VmaAllocationCreateInfo vmaAllocationCreateInfo{
+		.flags = VmaAllocationCreateFlags(0),
+		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+		.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		.memoryTypeBits = 0,
+		.pool = nullptr,
+		.pUserData = nullptr,
+		.priority = 0.0f,
+	};
+	VkBuffer storageBuffer = nullptr;
+	VmaAllocation storageBufferMemory = nullptr;
+	vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &storageBuffer, &storageBufferMemory, nullptr);
+	this->_validPixelsBuffer = vk::raii::Buffer(this->_pEngine->context().device(), storageBuffer);
+	this->_validPixelsBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), storageBufferMemory);
+}
+
+void ValidPixelsDescriptorSet::_createStorageBufferBinding2(void) {
+	std::vector<std::uint32_t> queueFamilyIndices = trackingQueueFamilyIndices(*this->_pEngine);
+	// The counter is small and read back by the host for statistics, so it is host visible.
+	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+		.setFlags(vk::BufferCreateFlags(0))
+		.setSize(sizeof(ValidPixelsDescriptorSet::ValidPixelsCounter))
+		.setUsage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst)
+		.setSharingMode(queueFamilyIndices.size() >= 2 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(queueFamilyIndices);
+	VmaAllocationCreateInfo vmaAllocationCreateInfo{
+		.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+		.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.memoryTypeBits = 0,
+		.pool = nullptr,
+		.pUserData = nullptr,
+		.priority = 0.0f,
+	};
+	VkBuffer storageBuffer = nullptr;
+	VmaAllocation storageBufferMemory = nullptr;
+	VmaAllocationInfo allocationInfo{};
+	vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &storageBuffer, &storageBufferMemory, &allocationInfo);
+	this->_validPixelsCounterBuffer = vk::raii::Buffer(this->_pEngine->context().device(), storageBuffer);
+	this->_validPixelsCounterBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), storageBufferMemory);
+	this->_validPixelsCounterBufferMemoryMappedAddress = allocationInfo.pMappedData;
+}
+
+PointCloudDescriptorSet::PointCloudDescriptorSet(
+	const Engine& engine_,
+	const KinectFusion& kinectFusion_,
+	std::uint32_t capacity_
+) :
+	_pEngine(&engine_),
+	_pKinectFusion(&kinectFusion_),
+	_descriptorSetLayout(*kinectFusion_.pointCloudDescriptorSetLayout()),
+	_capacity(capacity_)
+{
+	if (capacity_ == 0U) {
+		throw std::logic_error("[PointCloudDescriptorSet] The capacity must be positive.");
+	}
+	// Create descriptor set
+	this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
+	// Create storage buffer for binding 0
+	this->_createStorageBufferBinding0();
+	// Create storage buffer for binding 1
+	this->_createStorageBufferBinding1();
+	// Update the descriptor set
+	{
+		std::array<vk::DescriptorBufferInfo, 2> descriptorBufferInfos = { {
+			vk::DescriptorBufferInfo()
+			.setBuffer(*this->_pointsBuffer)
+			.setOffset(0)
+			.setRange(this->_pointsBufferSize()),
+			vk::DescriptorBufferInfo()
+			.setBuffer(*this->_counterBuffer)
+			.setOffset(0)
+			.setRange(sizeof(std::uint32_t))
+		} };
+		std::array<vk::WriteDescriptorSet, 2> writeDescriptorSets{};
+		for (std::uint32_t i = 0; i < 2; ++i) {
+			writeDescriptorSets[i]
+				.setDstSet(*this->_descriptorSet)
+				.setDstBinding(i)
+				.setDstArrayElement(0)
+				.setDescriptorCount(1)
+				.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+				.setBufferInfo(descriptorBufferInfos[i]);
+		}
+		this->_pEngine->context().device().updateDescriptorSets(writeDescriptorSets, nullptr);
+	}
+	this->reset();
+}
+
+void PointCloudDescriptorSet::_createStorageBufferBinding0(void) {
+	// The points are read back by the host in chunks, so the buffer doubles as the staging buffer.
+	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+		.setFlags(vk::BufferCreateFlags(0))
+		.setSize(this->_pointsBufferSize())
+		.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
+		.setSharingMode(vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(nullptr);
+	VmaAllocationCreateInfo vmaAllocationCreateInfo{
+		.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+		.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+		.memoryTypeBits = 0,
+		.pool = nullptr,
+		.pUserData = nullptr,
+		.priority = 0.0f,
+	};
+	VkBuffer storageBuffer = nullptr;
+	VmaAllocation storageBufferMemory = nullptr;
+	VmaAllocationInfo allocationInfo{};
+	vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &storageBuffer, &storageBufferMemory, &allocationInfo);
+	this->_pointsBuffer = vk::raii::Buffer(this->_pEngine->context().device(), storageBuffer);
+	this->_pointsBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), storageBufferMemory);
+	this->_pointsBufferMemoryMappedAddress = allocationInfo.pMappedData;
+}
+
+void PointCloudDescriptorSet::_createStorageBufferBinding1(void) {
+	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+		.setFlags(vk::BufferCreateFlags(0))
+		.setSize(sizeof(std::uint32_t))
+		.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
+		.setSharingMode(vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(nullptr);
+	VmaAllocationCreateInfo vmaAllocationCreateInfo{
+		.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+		.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.memoryTypeBits = 0,
+		.pool = nullptr,
+		.pUserData = nullptr,
+		.priority = 0.0f,
+	};
+	VkBuffer storageBuffer = nullptr;
+	VmaAllocation storageBufferMemory = nullptr;
+	VmaAllocationInfo allocationInfo{};
+	vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &storageBuffer, &storageBufferMemory, &allocationInfo);
+	this->_counterBuffer = vk::raii::Buffer(this->_pEngine->context().device(), storageBuffer);
+	this->_counterBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), storageBufferMemory);
+	this->_counterBufferMemoryMappedAddress = allocationInfo.pMappedData;
+}
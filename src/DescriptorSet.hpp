@@ -3,6 +3,10 @@
 #include <jjyou/vk/Vulkan.hpp>
 #include <jjyou/glsl/glsl.hpp>
 #include <stdexcept>
+#include <array>
+#include <vector>
+#include "DescriptorAllocator.hpp"
+#include "Primitives.hpp"
 
 class Engine;
 class KinectFusion;
@@ -65,7 +69,7 @@ public:
 
 	/** @brief	Get the descriptor set.
 	  */
-	const vk::raii::DescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
+	const PooledDescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
 
 	/** @brief	Get the mapped address for CameraParameters (binding 0).
 	  */
@@ -90,7 +94,7 @@ public:
 	
 	/** @brief	Create the descriptor set layout.
 	  */
-	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(const vk::raii::Device& device_) {
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
 		std::vector<vk::DescriptorSetLayoutBinding> descriptorSetLayoutBindings = {
 			vk::DescriptorSetLayoutBinding()
 			.setBinding(0)
@@ -102,14 +106,14 @@ public:
 		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
 			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
 			.setBindings(descriptorSetLayoutBindings);
-		return vk::raii::DescriptorSetLayout(device_, descriptorSetLayoutCreateInfo);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
 	}
 
 private:
 
 	const Engine* _pEngine = nullptr;
 	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by the engine.
-	vk::raii::DescriptorSet _descriptorSet{ nullptr };
+	PooledDescriptorSet _descriptorSet{ nullptr };
 	vk::raii::Buffer _cameraParametersBuffer{ nullptr };
 	jjyou::vk::VmaAllocation _cameraParametersBufferMemory{ nullptr };
 	void* _cameraParametersBufferMemoryMappedAddress = nullptr;
@@ -119,6 +123,11 @@ private:
 /***********************************************************************
  * @class	InstanceLevelDescriptorSet
  * @brief	Descriptor set 1 in the primitives shaders.
+ *
+ * The model transforms of all instances drawn in a frame are stored
+ * contiguously in a storage buffer. The shaders index it with
+ * `gl_InstanceIndex`, so that multiple instances of the same primitives
+ * can be drawn by a single instanced draw call.
  ***********************************************************************/
 class InstanceLevelDescriptorSet {
 
@@ -126,7 +135,7 @@ public:
 
 	/***********************************************************************
 	 * @class	ModelTransforms
-	 * @brief	Binding 0 dynamic uniform buffer in the shaders.
+	 * @brief	Element of the binding 0 storage buffer in the shaders.
 	 ***********************************************************************/
 	struct ModelTransforms {
 		jjyou::glsl::mat4 model{};
@@ -137,7 +146,7 @@ public:
 	  */
 	InstanceLevelDescriptorSet(std::nullptr_t) {}
 
-	/** @brief	Construct a descriptor set given the engine and the number of ModelTransforms.
+	/** @brief	Construct a descriptor set given the engine and the initial number of ModelTransforms.
 	  */
 	InstanceLevelDescriptorSet(const Engine& engine_, std::uint32_t numModelTransforms_);
 
@@ -160,7 +169,6 @@ public:
 			this->_pEngine = other_._pEngine;
 			this->_descriptorSetLayout = other_._descriptorSetLayout;
 			this->_descriptorSet = std::move(other_._descriptorSet);
-			this->_modelTransformsBufferOffset = other_._modelTransformsBufferOffset;
 			this->_modelTransformsBuffer = std::move(other_._modelTransformsBuffer);
 			this->_modelTransformsBufferMemory = std::move(other_._modelTransformsBufferMemory);
 			this->_modelTransformsBufferMemoryMappedAddress = other_._modelTransformsBufferMemoryMappedAddress;
@@ -175,23 +183,27 @@ public:
 
 	/** @brief	Get the descriptor set.
 	  */
-	const vk::raii::DescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
+	const PooledDescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
 
 	/** @brief	Get the mapped address for ModelTransforms (binding 0).
 	  */
 	ModelTransforms& modelTransforms(std::uint32_t idx_) const {
-		char* baseAddr = reinterpret_cast<char*>(this->_modelTransformsBufferMemoryMappedAddress);
-		char* offsetAddr = baseAddr + this->modelTransformsDynamicOffset(idx_);
-		return *reinterpret_cast<ModelTransforms*>(offsetAddr);
+		return reinterpret_cast<ModelTransforms*>(this->_modelTransformsBufferMemoryMappedAddress)[idx_];
 	}
 
-	/** @brief	Get the number of model transforms in the dynamic uniform buffer at binding 0.
+	/** @brief	Get the number of model transforms in the storage buffer at binding 0.
 	  */
 	std::uint32_t numModelTransforms(void) const { return this->_numModelTransforms; }
 
-	/** @brief	Get the dynamic uniform offset.
+	/** @brief	Make sure the storage buffer can hold at least `numModelTransforms_` model transforms.
+	  *			The buffer is recreated with doubled capacity if it is too small.
+	  * @note	The caller must make sure the GPU is not using this descriptor set.
 	  */
-	std::uint32_t modelTransformsDynamicOffset(std::uint32_t idx_) const { return idx_ * static_cast<std::uint32_t>(this->_modelTransformsBufferOffset); }
+	void reserve(std::uint32_t numModelTransforms_);
+
+	/** @brief	Flush the first `numModelTransforms_` model transforms written by the host.
+	  */
+	void flush(std::uint32_t numModelTransforms_) const;
 
 	/** @brief	Bind the descriptor set.
 	  */
@@ -199,10 +211,9 @@ public:
 		const vk::raii::CommandBuffer& commandBuffer_,
 		vk::PipelineBindPoint pipelineBindPoint_,
 		const vk::raii::PipelineLayout& pipelineLayout_,
-		std::uint32_t setIndex_,
-		std::uint32_t instanceIndex_
+		std::uint32_t setIndex_
 	) const {
-		commandBuffer_.bindDescriptorSets(pipelineBindPoint_, *pipelineLayout_, setIndex_, *this->_descriptorSet, this->modelTransformsDynamicOffset(instanceIndex_));
+		commandBuffer_.bindDescriptorSets(pipelineBindPoint_, *pipelineLayout_, setIndex_, *this->_descriptorSet, nullptr);
 	}
 
 	/** @brief	Get the descriptor set layout.
@@ -213,11 +224,11 @@ public:
 	
 	/** @brief	Create the descriptor set layout.
 	  */
-	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(const vk::raii::Device& device_) {
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
 		std::vector<vk::DescriptorSetLayoutBinding> descriptorSetLayoutBindings = {
 			vk::DescriptorSetLayoutBinding()
 			.setBinding(0)
-			.setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
+			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
 			.setDescriptorCount(1)
 			.setStageFlags(vk::ShaderStageFlagBits::eVertex)
 			.setPImmutableSamplers(nullptr)
@@ -225,20 +236,21 @@ public:
 		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
 			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
 			.setBindings(descriptorSetLayoutBindings);
-		return vk::raii::DescriptorSetLayout(device_, descriptorSetLayoutCreateInfo);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
 	}
 
 private:
 
 	const Engine* _pEngine = nullptr;
 	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by the engine.
-	vk::raii::DescriptorSet _descriptorSet{ nullptr };
-	vk::DeviceSize _modelTransformsBufferOffset = 0;
+	PooledDescriptorSet _descriptorSet{ nullptr };
 	vk::raii::Buffer _modelTransformsBuffer{ nullptr };
 	jjyou::vk::VmaAllocation _modelTransformsBufferMemory{ nullptr };
 	void* _modelTransformsBufferMemoryMappedAddress = nullptr;
 	std::uint32_t _numModelTransforms = 0;
 
+	void _createModelTransformsBuffer(std::uint32_t numModelTransforms_);
+
 };
 
 /***********************************************************************
@@ -305,7 +317,7 @@ public:
 
 	/** @brief	Get the descriptor set.
 	  */
-	const vk::raii::DescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
+	const PooledDescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
 
 	/** @brief	Get the mapped address for RayCastingParameters (binding 0).
 	  */
@@ -330,7 +342,7 @@ public:
 
 	/** @brief	Create the descriptor set layout.
 	  */
-	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(const vk::raii::Device& device_) {
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
 		std::vector<vk::DescriptorSetLayoutBinding> descriptorSetLayoutBindings = {
 			vk::DescriptorSetLayoutBinding()
 			.setBinding(0)
@@ -342,7 +354,7 @@ public:
 		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
 			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
 			.setBindings(descriptorSetLayoutBindings);
-		return vk::raii::DescriptorSetLayout(device_, descriptorSetLayoutCreateInfo);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
 	}
 
 private:
@@ -350,13 +362,168 @@ private:
 	const Engine* _pEngine = nullptr;
 	const KinectFusion* _pKinectFusion = nullptr;
 	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by KinectFusion.
-	vk::raii::DescriptorSet _descriptorSet{ nullptr };
+	PooledDescriptorSet _descriptorSet{ nullptr };
 	vk::raii::Buffer _rayCastingParametersBuffer{ nullptr };
 	jjyou::vk::VmaAllocation _rayCastingParametersBufferMemory{ nullptr };
 	void* _rayCastingParametersBufferMemoryMappedAddress = nullptr;
 
 };
 
+/***********************************************************************
+ * @class	BatchRayCastingDescriptorSet
+ * @brief	Descriptor set 1 in the batched ray casting shader.
+ *
+ *			Binding 0 holds the ray casting parameters of up to `MAX_VIEWS`
+ *			views. Bindings 1, 2, and 3 are arrays of the color, depth, and
+ *			normal storage images of their surfaces.
+ ***********************************************************************/
+class BatchRayCastingDescriptorSet {
+
+public:
+
+	/** @brief	Maximal number of views in one dispatch. Must match `MAX_VIEWS` in "rayCastingBatch.comp".
+	  */
+	static inline constexpr std::uint32_t MAX_VIEWS = 8U;
+
+	/***********************************************************************
+	 * @class	ViewParameters
+	 * @brief	Ray casting parameters of a view.
+	 ***********************************************************************/
+	struct ViewParameters {
+		float fx, fy, cx, cy;
+		jjyou::glsl::mat4 invView;
+		float minDepth;
+		float maxDepth;
+		float invalidDepth;
+		float marchingStep;
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint32_t reserved[2];	// Arrays of structs are aligned to 16 bytes in uniform blocks.
+	};
+
+	/***********************************************************************
+	 * @class	BatchRayCastingParameters
+	 * @brief	Binding 0 uniform buffer in the batched ray casting shader.
+	 ***********************************************************************/
+	struct BatchRayCastingParameters {
+		std::array<ViewParameters, BatchRayCastingDescriptorSet::MAX_VIEWS> views;
+		std::uint32_t numViews;
+	};
+
+	/** @brief	Construct an empty descriptor set in invalid state.
+	  */
+	BatchRayCastingDescriptorSet(std::nullptr_t) {}
+
+	/** @brief	Construct a descriptor set given the engine and the fusion.
+	  */
+	BatchRayCastingDescriptorSet(
+		const Engine& engine_,
+		const KinectFusion& kinectFusion_
+	);
+
+	/** @brief	Copy constructor is disabled.
+	  */
+	BatchRayCastingDescriptorSet(const BatchRayCastingDescriptorSet&) = delete;
+
+	/** @brief	Move constructor.
+	  */
+	BatchRayCastingDescriptorSet(BatchRayCastingDescriptorSet&& other_) = default;
+
+	/** @brief	Copy assignment is disabled.
+	  */
+	BatchRayCastingDescriptorSet& operator=(const BatchRayCastingDescriptorSet&) = delete;
+
+	/** @brief	Move assignment.
+	  */
+	BatchRayCastingDescriptorSet& operator=(BatchRayCastingDescriptorSet&& other_) noexcept {
+		if (this != &other_) {
+			this->_pEngine = other_._pEngine;
+			this->_pKinectFusion = other_._pKinectFusion;
+			this->_descriptorSetLayout = other_._descriptorSetLayout;
+			this->_descriptorSet = std::move(other_._descriptorSet);
+			this->_batchRayCastingParametersBuffer = std::move(other_._batchRayCastingParametersBuffer);
+			this->_batchRayCastingParametersBufferMemory = std::move(other_._batchRayCastingParametersBufferMemory);
+			this->_batchRayCastingParametersBufferMemoryMappedAddress = other_._batchRayCastingParametersBufferMemoryMappedAddress;
+		}
+		return *this;
+	}
+
+	/** @brief	Destructor.
+	  */
+	~BatchRayCastingDescriptorSet(void) = default;
+
+	/** @brief	Get the descriptor set.
+	  */
+	const PooledDescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
+
+	/** @brief	Get the mapped address for BatchRayCastingParameters (binding 0).
+	  */
+	BatchRayCastingParameters& batchRayCastingParameters(void) const { return *reinterpret_cast<BatchRayCastingDescriptorSet::BatchRayCastingParameters*>(this->_batchRayCastingParametersBufferMemoryMappedAddress); }
+
+	/** @brief	Write the color, depth, and normal image views of the surfaces to bindings 1, 2, and 3.
+	  *
+	  * The unused array elements are written the images of the first surface, so that all
+	  * descriptors are valid. The descriptor set must not be in use.
+	  * @param	imageViews_	Image views of at most `MAX_VIEWS` surfaces.
+	  */
+	void setImageViews(const std::vector<std::array<vk::ImageView, 3>>& imageViews_) const;
+
+	/** @brief	Bind the descriptor set.
+	  */
+	void bind(
+		const vk::raii::CommandBuffer& commandBuffer_,
+		vk::PipelineBindPoint pipelineBindPoint_,
+		const vk::raii::PipelineLayout& pipelineLayout_,
+		std::uint32_t setIndex_
+	) const {
+		commandBuffer_.bindDescriptorSets(pipelineBindPoint_, *pipelineLayout_, setIndex_, *this->_descriptorSet, nullptr);
+	}
+
+	/** @brief	Get the descriptor set layout.
+	  */
+	vk::DescriptorSetLayout descriptorSetLayout(void) const {
+		return this->_descriptorSetLayout;
+	}
+
+	/** @brief	Create the descriptor set layout.
+	  */
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
+		std::vector<vk::DescriptorSetLayoutBinding> descriptorSetLayoutBindings = {
+			vk::DescriptorSetLayoutBinding()
+			.setBinding(0)
+			.setDescriptorType(vk::DescriptorType::eUniformBuffer)
+			.setDescriptorCount(1)
+			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+			.setPImmutableSamplers(nullptr)
+		};
+		for (std::uint32_t binding = 1; binding <= 3; ++binding) {
+			descriptorSetLayoutBindings.push_back(
+				vk::DescriptorSetLayoutBinding()
+				.setBinding(binding)
+				.setDescriptorType(vk::DescriptorType::eStorageImage)
+				.setDescriptorCount(BatchRayCastingDescriptorSet::MAX_VIEWS)
+				.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+				.setPImmutableSamplers(nullptr)
+			);
+		}
+		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
+			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
+			.setBindings(descriptorSetLayoutBindings);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+	}
+
+private:
+
+	const Engine* _pEngine = nullptr;
+	const KinectFusion* _pKinectFusion = nullptr;
+	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by KinectFusion.
+	PooledDescriptorSet _descriptorSet{ nullptr };
+	vk::raii::Buffer _batchRayCastingParametersBuffer{ nullptr };
+	jjyou::vk::VmaAllocation _batchRayCastingParametersBufferMemory{ nullptr };
+	void* _batchRayCastingParametersBufferMemoryMappedAddress = nullptr;
+
+};
+
 /***********************************************************************
  * @class	FusionDescriptorSet
  * @brief	Descriptor set 1 in the fusion shader.
@@ -422,7 +589,7 @@ public:
 
 	/** @brief	Get the descriptor set.
 	  */
-	const vk::raii::DescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
+	const PooledDescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
 
 	/** @brief	Get the mapped address for FusionParameters (binding 0).
 	  */
@@ -447,7 +614,7 @@ public:
 
 	/** @brief	Create the descriptor set layout.
 	  */
-	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(const vk::raii::Device& device_) {
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
 		std::vector<vk::DescriptorSetLayoutBinding> descriptorSetLayoutBindings = {
 			vk::DescriptorSetLayoutBinding()
 			.setBinding(0)
@@ -459,7 +626,7 @@ public:
 		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
 			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
 			.setBindings(descriptorSetLayoutBindings);
-		return vk::raii::DescriptorSetLayout(device_, descriptorSetLayoutCreateInfo);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
 	}
 
 private:
@@ -467,7 +634,7 @@ private:
 	const Engine* _pEngine = nullptr;
 	const KinectFusion* _pKinectFusion = nullptr;
 	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by KinectFusion.
-	vk::raii::DescriptorSet _descriptorSet{ nullptr };
+	PooledDescriptorSet _descriptorSet{ nullptr };
 	vk::raii::Buffer _fusionParametersBuffer{ nullptr };
 	jjyou::vk::VmaAllocation _fusionParametersBufferMemory{ nullptr };
 	void* _fusionParametersBufferMemoryMappedAddress = nullptr;
@@ -483,16 +650,65 @@ class ICPDescriptorSet {
 
 public:
 
+	/** @brief	Maximum number of initial pose hypotheses evaluated in the same dispatches.
+	  */
+	static inline constexpr std::uint32_t MAX_NUM_HYPOTHESES = 8;
+
+	/** @brief	Number of floats summed per hypothesis: 21 elements of the symmetric
+	  *			matrix A, 6 elements of b, the sum of squared residuals, and the
+	  *			number of inliers.
+	  */
+	static inline constexpr std::uint32_t NUM_SUM_TERMS = 29;
+
 	/***********************************************************************
 	 * @class	ICPParameters
 	 * @brief	Binding 0 uniform buffer in the shaders.
 	 ***********************************************************************/
 	struct ICPParameters {
-		jjyou::glsl::mat4 frameInvView;		//!< The inverse of the current view matrix of the frame data.
 		jjyou::glsl::mat4 modelView;		//!< The current view matrix of the model data.
-		float fx, fy, cx, cy;				//!< The camera projection parameters of the model data.
+		jjyou::glsl::vec4 intrinsics[3];	//!< The camera projection parameters (fx, fy, cx, cy) of the model data in each pyramid level.
+		jjyou::glsl::vec4 frameGravity;		//!< The gravity direction of the frame in camera space. w is 1 if the gravity term is used, otherwise 0.
+		jjyou::glsl::vec4 worldGravity;		//!< The gravity direction in world space.
 		float distanceThreshold;			//!< Distance threshold used in projective correspondence search.
 		float angleThreshold;				//!< Angle threshold used in projective correspondence search.
+		float minDeterminant;				//!< ICP fails if the absolute value of the determinant of A is smaller than this value.
+		float maxIncrement;					//!< ICP fails if the norm of the solution is larger than this value.
+		float convergenceThreshold;			//!< ICP converges if the norm of the solution is smaller than this value.
+		float gravityWeight;				//!< Weight of the gravity alignment term, relative to one correspondence.
+	};
+
+	/***********************************************************************
+	 * @class	ICPHypothesis
+	 * @brief	State of ICP started from one initial pose hypothesis.
+	 ***********************************************************************/
+	struct ICPHypothesis {
+		jjyou::glsl::mat4 frameInvView;		//!< The inverse of the current view matrix of the frame data.
+		std::uint32_t converged;			//!< Whether ICP has converged in the current pyramid level.
+		std::uint32_t failed;				//!< Whether ICP has failed.
+		std::uint32_t numIterations;		//!< Number of iterations that updated the pose.
+		std::uint32_t numInliers;			//!< Number of correspondences found in the last iteration.
+		float residual;						//!< Sum of squared point-to-plane residuals in the last iteration.
+		std::uint32_t padding[3];
+	};
+
+	/***********************************************************************
+	 * @class	ICPState
+	 * @brief	Binding 3 storage buffer in the shaders.
+	 *
+	 * The state is initialized by the host, then updated by the GPU after
+	 * every ICP iteration, so that all iterations can be recorded into one
+	 * command buffer. The y dimension of the dispatches indexes the
+	 * hypotheses. Once a hypothesis has converged in the current pyramid
+	 * level or failed, its work groups return immediately. Once all of them
+	 * have, the indirect dispatch arguments are set to zero and the
+	 * remaining iterations become no-ops.
+	 ***********************************************************************/
+	struct ICPState {
+		vk::DispatchIndirectCommand buildLinearFunctionDispatchIndirectCommand;	//!< Arguments of the next `buildLinearFunction.comp` dispatch.
+		vk::DispatchIndirectCommand reductionDispatchIndirectCommand;			//!< Arguments of the next `buildLinearFunctionReduction.comp` dispatch.
+		std::uint32_t numHypotheses;											//!< Number of hypotheses being evaluated.
+		std::uint32_t padding;
+		ICPHypothesis hypotheses[ICPDescriptorSet::MAX_NUM_HYPOTHESES];
 	};
 
 	/***********************************************************************
@@ -500,7 +716,7 @@ public:
 	 * @brief	Binding 2 uniform buffer in the shaders.
 	 ***********************************************************************/
 	struct ReductionResult {
-		float data[27];
+		float data[ICPDescriptorSet::MAX_NUM_HYPOTHESES][ICPDescriptorSet::NUM_SUM_TERMS];
 	};
 
 	/** @brief	Construct an empty descriptor set in invalid state.
@@ -508,6 +724,7 @@ public:
 	ICPDescriptorSet(std::nullptr_t) {}
 
 	/** @brief	Construct a descriptor set given the engine and the fusion.
+	  * @param	globalSumBufferLength_	Maximum number of `buildLinearFunction.comp` work groups per hypothesis.
 	  */
 	ICPDescriptorSet(
 		const Engine& engine_,
@@ -544,6 +761,9 @@ public:
 			this->_reductionResultBuffer = std::move(other_._reductionResultBuffer);
 			this->_reductionResultBufferMemory = std::move(other_._reductionResultBufferMemory);
 			this->_reductionResultBufferMemoryMappedAddress = other_._reductionResultBufferMemoryMappedAddress;
+			this->_icpStateBuffer = std::move(other_._icpStateBuffer);
+			this->_icpStateBufferMemory = std::move(other_._icpStateBufferMemory);
+			this->_icpStateBufferMemoryMappedAddress = other_._icpStateBufferMemoryMappedAddress;
 		}
 		return *this;
 	}
@@ -554,7 +774,7 @@ public:
 
 	/** @brief	Get the descriptor set.
 	  */
-	const vk::raii::DescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
+	const PooledDescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
 
 	/** @brief	Get the mapped address for ICPParameters (binding 0).
 	  */
@@ -564,6 +784,10 @@ public:
 	  */
 	ReductionResult& reductionResult(void) const { return *reinterpret_cast<ICPDescriptorSet::ReductionResult*>(this->_reductionResultBufferMemoryMappedAddress); }
 
+	/** @brief	Get the mapped address for ICPState (binding 3).
+	  */
+	ICPState& icpState(void) const { return *reinterpret_cast<ICPDescriptorSet::ICPState*>(this->_icpStateBufferMemoryMappedAddress); }
+
 	/** @brief	Bind the descriptor set.
 	  */
 	void bind(
@@ -589,9 +813,26 @@ public:
 		return this->_globalSumBufferBuffer;
 	}
 
+	/** @brief	Get the Vulkan buffer of ReductionResult.
+	  *
+	  *			You may wish to insert buffer memory barriers for this buffer.
+	  */
+	const vk::raii::Buffer& reductionResultBuffer(void) const {
+		return this->_reductionResultBuffer;
+	}
+
+	/** @brief	Get the Vulkan buffer of ICPState.
+	  *
+	  *			The buffer can be used as the argument buffer of `vkCmdDispatchIndirect`.
+	  *			You may wish to insert buffer memory barriers for this buffer.
+	  */
+	const vk::raii::Buffer& icpStateBuffer(void) const {
+		return this->_icpStateBuffer;
+	}
+
 	/** @brief	Create the descriptor set layout.
 	  */
-	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(const vk::raii::Device& device_) {
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
 		std::vector<vk::DescriptorSetLayoutBinding> descriptorSetLayoutBindings = {
 			vk::DescriptorSetLayoutBinding()
 			.setBinding(0)
@@ -610,12 +851,18 @@ public:
 			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
 			.setDescriptorCount(1)
 			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+			.setPImmutableSamplers(nullptr),
+			vk::DescriptorSetLayoutBinding()
+			.setBinding(3)
+			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+			.setDescriptorCount(1)
+			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
 			.setPImmutableSamplers(nullptr)
 		};
 		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
 			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
 			.setBindings(descriptorSetLayoutBindings);
-		return vk::raii::DescriptorSetLayout(device_, descriptorSetLayoutCreateInfo);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
 	}
 
 private:
@@ -623,7 +870,7 @@ private:
 	const Engine* _pEngine = nullptr;
 	const KinectFusion* _pKinectFusion = nullptr;
 	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by the engine.
-	vk::raii::DescriptorSet _descriptorSet{ nullptr };
+	PooledDescriptorSet _descriptorSet{ nullptr };
 	vk::raii::Buffer _icpParametersBuffer{ nullptr };
 	jjyou::vk::VmaAllocation _icpParametersBufferMemory{ nullptr };
 	void* _icpParametersBufferMemoryMappedAddress = nullptr;
@@ -633,9 +880,337 @@ private:
 	vk::raii::Buffer _reductionResultBuffer{ nullptr };
 	jjyou::vk::VmaAllocation _reductionResultBufferMemory{ nullptr };
 	void* _reductionResultBufferMemoryMappedAddress = nullptr;
+	vk::raii::Buffer _icpStateBuffer{ nullptr };
+	jjyou::vk::VmaAllocation _icpStateBufferMemory{ nullptr };
+	void* _icpStateBufferMemoryMappedAddress = nullptr;
 
 	void _createUniformBufferBinding0(void);
 	void _createStorageBufferBinding1(void);
 	void _createStorageBufferBinding2(void);
+	void _createStorageBufferBinding3(void);
+
+};
+
+/***********************************************************************
+ * @class	ValidPixelsDescriptorSet
+ * @brief	Descriptor set of the validity bitmask and the compacted list
+ *			of valid pixels in one level of the pyramid.
+ *
+ * This descriptor set is written by `compactValidPixels.comp` or
+ * `computeNormalMap.comp`, and read by the vertex map, normal map and ICP
+ * shaders. What makes a pixel valid depends on the pass that writes it:
+ * a valid depth for the depth compaction of the frame pyramid, and a valid
+ * vertex and normal otherwise. It contains 3 storage buffers:
+ *  - Binding 0: validity bitmask. Bit `i % 32` of word `i / 32` is set if
+ *    pixel `i` (row-major) is valid.
+ *  - Binding 1: row-major indices of the valid pixels, in arbitrary order.
+ *  - Binding 2: `ValidPixelsCounter`. It holds the number of valid pixels
+ *    and the indirect dispatch arguments of the shaders reading the list,
+ *    so that they only launch work groups for valid pixels.
+ ***********************************************************************/
+class ValidPixelsDescriptorSet {
+
+public:
+
+	/***********************************************************************
+	 * @class	ValidPixelsCounter
+	 * @brief	Binding 2 storage buffer in the shaders.
+	 ***********************************************************************/
+	struct ValidPixelsCounter {
+		std::uint32_t numValidPixels;						//!< Number of valid pixels.
+		vk::DispatchIndirectCommand dispatchIndirectCommand;	//!< Number of work groups to cover all valid pixels.
+	};
+
+	/** @brief	Construct an empty descriptor set in invalid state.
+	  */
+	ValidPixelsDescriptorSet(std::nullptr_t) {}
+
+	/** @brief	Construct a descriptor set given the engine, the fusion, and the extent of the pyramid level.
+	  */
+	ValidPixelsDescriptorSet(
+		const Engine& engine_,
+		const KinectFusion& kinectFusion_,
+		vk::Extent2D extent_
+	);
+
+	/** @brief	Copy constructor is disabled.
+	  */
+	ValidPixelsDescriptorSet(const ValidPixelsDescriptorSet&) = delete;
+
+	/** @brief	Move constructor.
+	  */
+	ValidPixelsDescriptorSet(ValidPixelsDescriptorSet&& other_) = default;
+
+	/** @brief	Copy assignment is disabled.
+	  */
+	ValidPixelsDescriptorSet& operator=(const ValidPixelsDescriptorSet&) = delete;
+
+	/** @brief	Move assignment.
+	  */
+	ValidPixelsDescriptorSet& operator=(ValidPixelsDescriptorSet&& other_) noexcept {
+		if (this != &other_) {
+			this->_pEngine = other_._pEngine;
+			this->_pKinectFusion = other_._pKinectFusion;
+			this->_descriptorSetLayout = other_._descriptorSetLayout;
+			this->_extent = other_._extent;
+			this->_descriptorSet = std::move(other_._descriptorSet);
+			this->_validityMaskBuffer = std::move(other_._validityMaskBuffer);
+			this->_validityMaskBufferMemory = std::move(other_._validityMaskBufferMemory);
+			this->_validPixelsBuffer = std::move(other_._validPixelsBuffer);
+			this->_validPixelsBufferMemory = std::move(other_._validPixelsBufferMemory);
+			this->_validPixelsCounterBuffer = std::move(other_._validPixelsCounterBuffer);
+			this->_validPixelsCounterBufferMemory = std::move(other_._validPixelsCounterBufferMemory);
+			this->_validPixelsCounterBufferMemoryMappedAddress = other_._validPixelsCounterBufferMemoryMappedAddress;
+		}
+		return *this;
+	}
+
+	/** @brief	Destructor.
+	  */
+	~ValidPixelsDescriptorSet(void) = default;
+
+	/** @brief	Get the descriptor set.
+	  */
+	const PooledDescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
+
+	/** @brief	Get the extent of the pyramid level.
+	  */
+	vk::Extent2D extent(void) const { return this->_extent; }
+
+	/** @brief	Get the mapped address for ValidPixelsCounter (binding 2).
+	  *
+	  *			The values are only meaningful after the compaction has finished.
+	  */
+	const ValidPixelsCounter& validPixelsCounter(void) const { return *reinterpret_cast<const ValidPixelsDescriptorSet::ValidPixelsCounter*>(this->_validPixelsCounterBufferMemoryMappedAddress); }
+
+	/** @brief	Bind the descriptor set.
+	  */
+	void bind(
+		const vk::raii::CommandBuffer& commandBuffer_,
+		vk::PipelineBindPoint pipelineBindPoint_,
+		const vk::raii::PipelineLayout& pipelineLayout_,
+		std::uint32_t setIndex_
+	) const {
+		commandBuffer_.bindDescriptorSets(pipelineBindPoint_, *pipelineLayout_, setIndex_, *this->_descriptorSet, nullptr);
+	}
+
+	/** @brief	Record commands that clear the bitmask and the counter before compaction.
+	  *
+	  *			You should insert a transfer-to-compute barrier for `validityMaskBuffer`
+	  *			and `validPixelsCounterBuffer` before the compaction.
+	  */
+	void reset(const vk::raii::CommandBuffer& commandBuffer_) const;
+
+	/** @brief	Get the descriptor set layout.
+	  */
+	vk::DescriptorSetLayout descriptorSetLayout(void) const {
+		return this->_descriptorSetLayout;
+	}
+
+	/** @brief	Get the Vulkan buffer of the validity bitmask.
+	  */
+	const vk::raii::Buffer& validityMaskBuffer(void) const {
+		return this->_validityMaskBuffer;
+	}
+
+	/** @brief	Get the Vulkan buffer of the row-major indices of valid pixels.
+	  */
+	const vk::raii::Buffer& validPixelsBuffer(void) const {
+		return this->_validPixelsBuffer;
+	}
+
+	/** @brief	Get the Vulkan buffer of ValidPixelsCounter.
+	  *
+	  *			The buffer can be used as the argument buffer of `vkCmdDispatchIndirect`
+	  *			with offset `offsetof(ValidPixelsCounter, dispatchIndirectCommand)`.
+	  */
+	const vk::raii::Buffer& validPixelsCounterBuffer(void) const {
+		return this->_validPixelsCounterBuffer;
+	}
+
+	/** @brief	Create the descriptor set layout.
+	  */
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
+		std::array<vk::DescriptorSetLayoutBinding, 3> descriptorSetLayoutBindings;
+		for (std::uint32_t i = 0; i < 3; ++i) {
+			descriptorSetLayoutBindings[i]
+				.setBinding(i)
+				.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+				.setDescriptorCount(1)
+				.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+				.setPImmutableSamplers(nullptr);
+		}
+		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
+			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
+			.setBindings(descriptorSetLayoutBindings);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+	}
+
+private:
+
+	const Engine* _pEngine = nullptr;
+	const KinectFusion* _pKinectFusion = nullptr;
+	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by KinectFusion.
+	vk::Extent2D _extent{};
+	PooledDescriptorSet _descriptorSet{ nullptr };
+	vk::raii::Buffer _validityMaskBuffer{ nullptr };
+	jjyou::vk::VmaAllocation _validityMaskBufferMemory{ nullptr };
+	vk::raii::Buffer _validPixelsBuffer{ nullptr };
+	jjyou::vk::VmaAllocation _validPixelsBufferMemory{ nullptr };
+	vk::raii::Buffer _validPixelsCounterBuffer{ nullptr };
+	jjyou::vk::VmaAllocation _validPixelsCounterBufferMemory{ nullptr };
+	void* _validPixelsCounterBufferMemoryMappedAddress = nullptr;
+
+	vk::DeviceSize _validityMaskBufferSize(void) const {
+		return sizeof(std::uint32_t) * ((static_cast<vk::DeviceSize>(this->_extent.width) * this->_extent.height + 31ULL) / 32ULL);
+	}
+	vk::DeviceSize _validPixelsBufferSize(void) const {
+		return sizeof(std::uint32_t) * static_cast<vk::DeviceSize>(this->_extent.width) * this->_extent.height;
+	}
+	void _createStorageBufferBinding0(void);
+	void _createStorageBufferBinding1(void);
+	void _createStorageBufferBinding2(void);
+
+};
+
+/***********************************************************************
+ * @class	PointCloudDescriptorSet
+ * @brief	Descriptor set of the append buffer of point cloud extraction.
+ *
+ * This descriptor set is written by `extractPointCloud.comp` and read by
+ * the host. Both buffers are host visible, so that the points of a chunk
+ * can be written to a file directly from the mapped memory. It contains
+ * 2 storage buffers:
+ *  - Binding 0: the points, as `Vertex<MaterialType::Lambertian>`.
+ *  - Binding 1: the number of points generated by the last extraction.
+ *    It may exceed the capacity, in which case the extra points are lost.
+ ***********************************************************************/
+class PointCloudDescriptorSet {
 
-};
\ No newline at end of file
+public:
+
+	/** @brief	Construct an empty descriptor set in invalid state.
+	  */
+	PointCloudDescriptorSet(std::nullptr_t) {}
+
+	/** @brief	Construct a descriptor set given the engine, the fusion, and the maximal number of points.
+	  */
+	PointCloudDescriptorSet(
+		const Engine& engine_,
+		const KinectFusion& kinectFusion_,
+		std::uint32_t capacity_
+	);
+
+	/** @brief	Copy constructor is disabled.
+	  */
+	PointCloudDescriptorSet(const PointCloudDescriptorSet&) = delete;
+
+	/** @brief	Move constructor.
+	  */
+	PointCloudDescriptorSet(PointCloudDescriptorSet&& other_) = default;
+
+	/** @brief	Copy assignment is disabled.
+	  */
+	PointCloudDescriptorSet& operator=(const PointCloudDescriptorSet&) = delete;
+
+	/** @brief	Move assignment.
+	  */
+	PointCloudDescriptorSet& operator=(PointCloudDescriptorSet&& other_) noexcept {
+		if (this != &other_) {
+			this->_pEngine = other_._pEngine;
+			this->_pKinectFusion = other_._pKinectFusion;
+			this->_descriptorSetLayout = other_._descriptorSetLayout;
+			this->_capacity = other_._capacity;
+			this->_descriptorSet = std::move(other_._descriptorSet);
+			this->_pointsBuffer = std::move(other_._pointsBuffer);
+			this->_pointsBufferMemory = std::move(other_._pointsBufferMemory);
+			this->_pointsBufferMemoryMappedAddress = other_._pointsBufferMemoryMappedAddress;
+			this->_counterBuffer = std::move(other_._counterBuffer);
+			this->_counterBufferMemory = std::move(other_._counterBufferMemory);
+			this->_counterBufferMemoryMappedAddress = other_._counterBufferMemoryMappedAddress;
+		}
+		return *this;
+	}
+
+	/** @brief	Destructor.
+	  */
+	~PointCloudDescriptorSet(void) = default;
+
+	/** @brief	Get the descriptor set.
+	  */
+	const PooledDescriptorSet& descriptorSet(void) const { return this->_descriptorSet; }
+
+	/** @brief	Get the maximal number of points.
+	  */
+	std::uint32_t capacity(void) const { return this->_capacity; }
+
+	/** @brief	Get the number of points generated by the last extraction, including the ones that did not fit.
+	  *
+	  *			The value is only meaningful after the extraction has finished.
+	  */
+	std::uint32_t numPoints(void) const { return *reinterpret_cast<const std::uint32_t*>(this->_counterBufferMemoryMappedAddress); }
+
+	/** @brief	Get the mapped address of the points (binding 0).
+	  */
+	const Vertex<MaterialType::Lambertian>* points(void) const { return reinterpret_cast<const Vertex<MaterialType::Lambertian>*>(this->_pointsBufferMemoryMappedAddress); }
+
+	/** @brief	Zero the counter. Call it before each extraction.
+	  */
+	void reset(void) const { *reinterpret_cast<std::uint32_t*>(this->_counterBufferMemoryMappedAddress) = 0U; }
+
+	/** @brief	Bind the descriptor set.
+	  */
+	void bind(
+		const vk::raii::CommandBuffer& commandBuffer_,
+		vk::PipelineBindPoint pipelineBindPoint_,
+		const vk::raii::PipelineLayout& pipelineLayout_,
+		std::uint32_t setIndex_
+	) const {
+		commandBuffer_.bindDescriptorSets(pipelineBindPoint_, *pipelineLayout_, setIndex_, *this->_descriptorSet, nullptr);
+	}
+
+	/** @brief	Get the descriptor set layout.
+	  */
+	vk::DescriptorSetLayout descriptorSetLayout(void) const {
+		return this->_descriptorSetLayout;
+	}
+
+	/** @brief	Create the descriptor set layout.
+	  */
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
+		std::array<vk::DescriptorSetLayoutBinding, 2> descriptorSetLayoutBindings;
+		for (std::uint32_t i = 0; i < 2; ++i) {
+			descriptorSetLayoutBindings[i]
+				.setBinding(i)
+				.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+				.setDescriptorCount(1)
+				.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+				.setPImmutableSamplers(nullptr);
+		}
+		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
+			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
+			.setBindings(descriptorSetLayoutBindings);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+	}
+
+private:
+
+	const Engine* _pEngine = nullptr;
+	const KinectFusion* _pKinectFusion = nullptr;
+	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by KinectFusion.
+	std::uint32_t _capacity = 0U;
+	PooledDescriptorSet _descriptorSet{ nullptr };
+	vk::raii::Buffer _pointsBuffer{ nullptr };
+	jjyou::vk::VmaAllocation _pointsBufferMemory{ nullptr };
+	void* _pointsBufferMemoryMappedAddress = nullptr;
+	vk::raii::Buffer _counterBuffer{ nullptr };
+	jjyou::vk::VmaAllocation _counterBufferMemory{ nullptr };
+	void* _counterBufferMemoryMappedAddress = nullptr;
+
+	vk::DeviceSize _pointsBufferSize(void) const {
+		return sizeof(Vertex<MaterialType::Lambertian>) * static_cast<vk::DeviceSize>(this->_capacity);
+	}
+	void _createStorageBufferBinding0(void);
+	void _createStorageBufferBinding1(void);
+
+};
@@ -2,47 +2,52 @@
 #include <iostream>
 #include <GLFW/glfw3.h>
 #include <numbers>
+#include <algorithm>
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
 
-Engine::Engine(bool headlessMode_, bool debugMode_) : _headlessMode(headlessMode_), _debugMode(debugMode_), _window(800, 600, "KinectFusion-Vulkan") {
-	if (headlessMode_)
-		throw std::logic_error("[Engine] Headless mode has not been implemented.");
+Engine::Engine(bool headlessMode_, bool debugMode_) : _headlessMode(headlessMode_), _debugMode(debugMode_) {
 	this->_createContext();
 	this->_createAllocator();
 	this->_createCommandPools();
-	this->_createSwapchain();
-	this->_createRenderPass();
-	this->_createDepthStencil();
-	this->_createFramebuffers();
-	this->_createDescriptorSetLayouts();
+	// Without a window, there is nothing to present or to draw to.
+	if (!this->_headlessMode) {
+		this->_createSwapchain();
+		this->_createRenderPass();
+		this->_createDepthStencil();
+		this->_createFramebuffers();
+	}
 	this->_createDescriptorPool();
-	this->_initImGui();
+	this->_createDescriptorSetLayouts();
+	if (!this->_headlessMode)
+		this->_initImGui();
 	this->_createPipelineLayouts();
-	this->_createPipelines();
+	if (!this->_headlessMode)
+		this->_createPipelines();
+	this->_createColorConversionPipeline();
 	this->_createFrameData();
 }
 
 Engine::~Engine(void) {
 	this->waitIdle();
-	ImGui_ImplVulkan_Shutdown();
-	ImGui_ImplGlfw_Shutdown();
+	if (!this->_headlessMode) {
+		ImGui_ImplVulkan_Shutdown();
+		ImGui_ImplGlfw_Shutdown();
+	}
 }
 
 vk::Result Engine::prepareFrame(void) {
-	this->_getPrimitivesToDraw<MaterialType::Simple, PrimitiveType::Point>().clear();
-	this->_getPrimitivesToDraw<MaterialType::Simple, PrimitiveType::Line>().clear();
-	this->_getPrimitivesToDraw<MaterialType::Simple, PrimitiveType::Triangle>().clear();
-	this->_getPrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Point>().clear();
-	this->_getPrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Line>().clear();
-	this->_getPrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Triangle>().clear();
-	this->_getSurfacesToDraw<MaterialType::Simple>().clear();
-	this->_getSurfacesToDraw<MaterialType::Lambertian>().clear();
-	vk::Result waitFenceResult = this->_context.device().waitForFences({ *this->_activeFrameData().inFlightFence }, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+	this->_activeFrameData().drawCommands.clear();
+	vk::Result waitFenceResult = this->waitForFences(*this->_activeFrameData().inFlightFence);
 	if (waitFenceResult != vk::Result::eSuccess) {
 		throw std::runtime_error("[Engine] Error occurred when waiting for the frame fence.");
 	}
+	this->_descriptorAllocator.beginFrame();
+	if (this->_headlessMode) {
+		this->_context.device().resetFences({ *this->_activeFrameData().inFlightFence });
+		return vk::Result::eSuccess;
+	}
 	vk::Result acquireImageResult{};
 	std::tie(acquireImageResult, this->_swapchainImageIndex) = this->_swapchain.swapchain().acquireNextImage(UINT64_MAX, *this->_activeFrameData().imageAvailableSemaphore, nullptr);
 	if (acquireImageResult == vk::Result::eErrorOutOfDateKHR) {
@@ -62,6 +67,13 @@ vk::Result Engine::prepareFrame(void) {
 }
 
 vk::Result Engine::presentFrame(void) {
+	if (this->_headlessMode) {
+		// An empty submission signals the frame fence once all work submitted to the main queue so far has completed,
+		// so that the frame fences still bound the number of frames in flight.
+		this->_context.queue(jjyou::vk::Context::QueueType::Main)->submit(nullptr, *this->_activeFrameData().inFlightFence);
+		this->_frameIndex = (this->_frameIndex + 1) % Engine::NUM_FRAMES_IN_FLIGHT;
+		return vk::Result::eSuccess;
+	}
 	this->_activeFrameData().graphicsCommandBuffer.end();
 	vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
 	vk::SubmitInfo submitInfo = vk::SubmitInfo()
@@ -91,7 +103,10 @@ vk::Result Engine::presentFrame(void) {
 	return presentResult;
 }
 
-void Engine::recordCommandbuffer(void) const {
+void Engine::recordCommandbuffer(void) {
+	// Draws are discarded in headless mode.
+	if (this->_headlessMode)
+		return;
 	// Set the viewport and the scissor
 	vk::Extent2D screenExtent = this->_swapchain.extent();
 	vk::Extent2D cameraExtent = vk::Extent2D(this->getCamera().width, this->getCamera().height);
@@ -124,36 +139,51 @@ void Engine::recordCommandbuffer(void) const {
 	this->_activeFrameData().viewLevelDescriptorSet.cameraParameters().projection = projectionMatrix;
 	this->_activeFrameData().viewLevelDescriptorSet.cameraParameters().view = viewMatrix;
 	this->_activeFrameData().viewLevelDescriptorSet.cameraParameters().viewPos = jjyou::glsl::vec4(-jjyou::glsl::transpose(jjyou::glsl::mat3(viewMatrix)) * jjyou::glsl::vec3(viewMatrix[3]), 1.0f);
-	std::uint32_t instanceCount = 0;
-	// Render primitives
-	auto renderPrimitives = [&]<MaterialType _materialType, PrimitiveType _primitiveType>() {
-		this->_activeFrameData().graphicsCommandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *this->_primitivePipelines[_materialType][_primitiveType]);
-		this->_activeFrameData().viewLevelDescriptorSet.bind(this->_activeFrameData().graphicsCommandBuffer, vk::PipelineBindPoint::eGraphics, this->_primitivePipelineLayouts[_materialType], 0);
-		for (const auto& instance : this->_getPrimitivesToDraw<_materialType, _primitiveType>()) {
-			this->_activeFrameData().instanceLevelDescriptorSet.modelTransforms(instanceCount).model = instance.modelMatrix;
-			this->_activeFrameData().instanceLevelDescriptorSet.modelTransforms(instanceCount).normal = instance.normalMatrix;
-			this->_activeFrameData().instanceLevelDescriptorSet.bind(this->_activeFrameData().graphicsCommandBuffer, vk::PipelineBindPoint::eGraphics, this->_primitivePipelineLayouts[_materialType], 1, instanceCount);
-			instance.pPrimitives->draw(this->_activeFrameData().graphicsCommandBuffer);
-			++instanceCount;
-		}
-	};
-	renderPrimitives.template operator() < MaterialType::Simple, PrimitiveType::Point > ();
-	renderPrimitives.template operator() < MaterialType::Simple, PrimitiveType::Line > ();
-	renderPrimitives.template operator() < MaterialType::Simple, PrimitiveType::Triangle > ();
-	renderPrimitives.template operator() < MaterialType::Lambertian, PrimitiveType::Point > ();
-	renderPrimitives.template operator() < MaterialType::Lambertian, PrimitiveType::Line > ();
-	renderPrimitives.template operator() < MaterialType::Lambertian, PrimitiveType::Triangle > ();
-	// Render surfaces
-	auto renderSurfaces = [&]<MaterialType _materialType>() {
-		this->_activeFrameData().graphicsCommandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *this->_surfacePipelines[_materialType]);
-		this->_activeFrameData().viewLevelDescriptorSet.bind(this->_activeFrameData().graphicsCommandBuffer, vk::PipelineBindPoint::eGraphics, this->_surfacePipelineLayouts[_materialType], 0);
-		for (const auto& pSurface : this->_getSurfacesToDraw<_materialType>()) {
-			pSurface->bindSampler(this->_activeFrameData().graphicsCommandBuffer, vk::PipelineBindPoint::eGraphics, this->_surfacePipelineLayouts[_materialType], 1);
-			pSurface->draw(this->_activeFrameData().graphicsCommandBuffer);
+	// Sort the draw commands by pipeline, then by geometry, so that pipelines are bound
+	// once and instances of the same geometry are adjacent.
+	std::vector<_DrawCommand>& drawCommands = this->_activeFrameData().drawCommands;
+	std::sort(drawCommands.begin(), drawCommands.end(), [](const _DrawCommand& lhs_, const _DrawCommand& rhs_) {
+		if (lhs_.pipelineIndex != rhs_.pipelineIndex)
+			return lhs_.pipelineIndex < rhs_.pipelineIndex;
+		if (lhs_.geometryId != rhs_.geometryId)
+			return lhs_.geometryId < rhs_.geometryId;
+		return lhs_.submissionIndex < rhs_.submissionIndex;
+	});
+	// Write the model transforms contiguously in the sorted order and flush them once.
+	InstanceLevelDescriptorSet& instanceLevelDescriptorSet = this->_activeFrameData().instanceLevelDescriptorSet;
+	instanceLevelDescriptorSet.reserve(static_cast<std::uint32_t>(drawCommands.size()));
+	for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(drawCommands.size()); ++i) {
+		instanceLevelDescriptorSet.modelTransforms(i).model = drawCommands[i].modelMatrix;
+		instanceLevelDescriptorSet.modelTransforms(i).normal = jjyou::glsl::transpose(jjyou::glsl::inverse(drawCommands[i].modelMatrix));
+	}
+	instanceLevelDescriptorSet.flush(static_cast<std::uint32_t>(drawCommands.size()));
+	// Record one instanced draw call per run of the same geometry.
+	const vk::raii::CommandBuffer& commandBuffer = this->_activeFrameData().graphicsCommandBuffer;
+	constexpr std::uint32_t numPrimitivesPipelines = MaterialType::NumMaterialTypes * PrimitiveType::NumPrimitiveTypes;
+	std::uint32_t boundPipelineIndex = std::numeric_limits<std::uint32_t>::max();
+	for (std::uint32_t first = 0; first < static_cast<std::uint32_t>(drawCommands.size());) {
+		const _DrawCommand& drawCommand = drawCommands[first];
+		std::uint32_t last = first + 1;
+		while (last < static_cast<std::uint32_t>(drawCommands.size()) && drawCommands[last].pipelineIndex == drawCommand.pipelineIndex && drawCommands[last].geometryId == drawCommand.geometryId)
+			++last;
+		if (drawCommand.pipelineIndex != boundPipelineIndex) {
+			if (drawCommand.pipelineIndex < numPrimitivesPipelines) {
+				std::uint32_t materialType = drawCommand.pipelineIndex / PrimitiveType::NumPrimitiveTypes;
+				std::uint32_t primitiveType = drawCommand.pipelineIndex % PrimitiveType::NumPrimitiveTypes;
+				commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *this->_primitivePipelines[materialType][primitiveType]);
+				this->_activeFrameData().viewLevelDescriptorSet.bind(commandBuffer, vk::PipelineBindPoint::eGraphics, this->_primitivePipelineLayouts[materialType], 0);
+				instanceLevelDescriptorSet.bind(commandBuffer, vk::PipelineBindPoint::eGraphics, this->_primitivePipelineLayouts[materialType], 1);
+			}
+			else {
+				std::uint32_t materialType = drawCommand.pipelineIndex - numPrimitivesPipelines;
+				commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *this->_surfacePipelines[materialType]);
+				this->_activeFrameData().viewLevelDescriptorSet.bind(commandBuffer, vk::PipelineBindPoint::eGraphics, this->_surfacePipelineLayouts[materialType], 0);
+			}
+			boundPipelineIndex = drawCommand.pipelineIndex;
 		}
-	};
-	renderSurfaces.template operator() < MaterialType::Simple > ();
-	renderSurfaces.template operator() < MaterialType::Lambertian > ();
+		drawCommand.recordFunction(*this, commandBuffer, drawCommand.pGeometry, last - first, first);
+		first = last;
+	}
 	// Render UI
 	ImGui::Render();
 	ImDrawData* imDrawData = ImGui::GetDrawData();
@@ -161,6 +191,25 @@ void Engine::recordCommandbuffer(void) const {
 	this->_activeFrameData().graphicsCommandBuffer.endRenderPass();
 }
 
+vk::Result Engine::waitForFences(vk::ArrayProxy<const vk::Fence> fences_) const {
+	std::chrono::steady_clock::time_point waitBegin = std::chrono::steady_clock::now();
+	vk::Result waitResult = this->_context.device().waitForFences(fences_, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+	this->_fenceWaitTime += std::chrono::steady_clock::now() - waitBegin;
+	return waitResult;
+}
+
+void Engine::signalAfterSubmittedFrames(vk::Semaphore semaphore_) const {
+	// The signal operation of a submission waits for all commands submitted before it to the same queue.
+	this->_context.queue(jjyou::vk::Context::QueueType::Main)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(nullptr)
+		.setSignalSemaphores(semaphore_),
+		nullptr
+	);
+}
+
 void Engine::waitIdle(void) const {
 	for (std::size_t queueType = 0; queueType < jjyou::vk::Context::NumQueueTypes; ++queueType)
 		this->_context.queue(queueType)->waitIdle();
@@ -185,8 +234,8 @@ void Engine::setCameraMode(
 
 void Engine::_createContext(void) {
 	// Create glfw window
-	//if (!this->_headlessMode)
-	//	this->_window = Window(800, 600, "KinectFusion-Vulkan");
+	if (!this->_headlessMode)
+		this->_window = Window(800, 600, "KinectFusion-Vulkan");
 	this->_sceneCamera = Camera::fromGraphics(std::nullopt, std::numbers::pi_v<float> / 3.0f, 0.1f, 100.0f, 800, 600);
 	jjyou::vk::ContextBuilder contextBuilder;
 	// Instance
@@ -197,7 +246,7 @@ void Engine::_createContext(void) {
 		.applicationVersion(0U, 1U, 0U, 0U)
 		.engineName("KinectFusion-Vulkan")
 		.engineVersion(0U, 1U, 0U, 0U)
-		.apiVersion(0U, 1U, 0U, 0U);
+		.apiVersion(0U, 1U, 2U, 0U);
 	if (this->_debugMode)
 		contextBuilder.useDefaultDebugUtilsMessenger();
 	if (!this->_headlessMode) {
@@ -212,7 +261,20 @@ void Engine::_createContext(void) {
 		contextBuilder.addSurface(this->_window.surface());
 	}
 	contextBuilder.selectPhysicalDevice(this->_context);
-	// Device
+	// Device. Enable optional features if the physical device supports them.
+	vk::PhysicalDeviceFeatures supportedFeatures = this->_context.physicalDevice().getFeatures();
+	this->_enabledFeatures = vk::PhysicalDeviceFeatures()
+		.setSparseBinding(supportedFeatures.sparseBinding)
+		.setSparseResidencyBuffer(supportedFeatures.sparseResidencyBuffer);
+	contextBuilder.enableDeviceFeatures(this->_enabledFeatures);
+	// fp16 arithmetic in shaders is core since Vulkan 1.2. Storage stays in fp32, so 16-bit storage is not needed.
+	// `VkPhysicalDeviceVulkan12Features` must not be chained to the device create info of older devices.
+	if (this->_context.physicalDevice().getProperties().apiVersion >= VK_API_VERSION_1_2) {
+		vk::PhysicalDeviceVulkan12Features supportedVulkan12Features = this->_context.physicalDevice().getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>().get<vk::PhysicalDeviceVulkan12Features>();
+		this->_enabledVulkan12Features = vk::PhysicalDeviceVulkan12Features()
+			.setShaderFloat16(supportedVulkan12Features.shaderFloat16);
+		contextBuilder.enableDeviceFeatures(this->_enabledVulkan12Features);
+	}
 	contextBuilder.buildDevice(this->_context);
 	// Check queue support. Require all types of queues (main, compute, transfer).
 	for (std::size_t queueType = 0; queueType < jjyou::vk::Context::NumQueueTypes; ++queueType)
@@ -350,39 +412,34 @@ void Engine::_createFramebuffers(void) {
 
 void Engine::_createDescriptorSetLayouts(void) {
 	// _viewLevelDescriptorSetLayout
-	this->_viewLevelDescriptorSetLayout = ViewLevelDescriptorSet::createDescriptorSetLayout(this->_context.device());
+	this->_viewLevelDescriptorSetLayout = ViewLevelDescriptorSet::createDescriptorSetLayout(this->_descriptorAllocator);
 
 	// _instanceLevelDescriptorSetLayout
-	this->_instanceLevelDescriptorSetLayout = InstanceLevelDescriptorSet::createDescriptorSetLayout(this->_context.device());
+	this->_instanceLevelDescriptorSetLayout = InstanceLevelDescriptorSet::createDescriptorSetLayout(this->_descriptorAllocator);
 
 	// _surfaceDescriptorSetLayouts - simple
-	this->_surfaceSamplerDescriptorSetLayouts[MaterialType::Simple] = Surface<MaterialType::Simple>::createSamplerDescriptorSetLayout(this->_context.device());
-	this->_surfaceStorageDescriptorSetLayouts[MaterialType::Simple] = Surface<MaterialType::Simple>::createStorageDescriptorSetLayout(this->_context.device());
+	this->_surfaceSamplerDescriptorSetLayouts[MaterialType::Simple] = Surface<MaterialType::Simple>::createSamplerDescriptorSetLayout(this->_descriptorAllocator);
+	this->_surfaceStorageDescriptorSetLayouts[MaterialType::Simple] = Surface<MaterialType::Simple>::createStorageDescriptorSetLayout(this->_descriptorAllocator);
 	
 	// _surfaceDescriptorSetLayouts - lambertian
-	this->_surfaceSamplerDescriptorSetLayouts[MaterialType::Lambertian] = Surface<MaterialType::Lambertian>::createSamplerDescriptorSetLayout(this->_context.device());
-	this->_surfaceStorageDescriptorSetLayouts[MaterialType::Lambertian] = Surface<MaterialType::Lambertian>::createStorageDescriptorSetLayout(this->_context.device());
+	this->_surfaceSamplerDescriptorSetLayouts[MaterialType::Lambertian] = Surface<MaterialType::Lambertian>::createSamplerDescriptorSetLayout(this->_descriptorAllocator);
+	this->_surfaceStorageDescriptorSetLayouts[MaterialType::Lambertian] = Surface<MaterialType::Lambertian>::createStorageDescriptorSetLayout(this->_descriptorAllocator);
+
+	// _colorConversionDescriptorSetLayout
+	this->_colorConversionDescriptorSetLayout = Surface<MaterialType::Simple>::createColorConversionDescriptorSetLayout(this->_descriptorAllocator);
 }
 
 void Engine::_createDescriptorPool(void) {
+	// ImGui only needs combined image samplers for its font atlas and user textures.
 	std::vector<vk::DescriptorPoolSize> descriptorPoolSizes = {
-		vk::DescriptorPoolSize(vk::DescriptorType::eSampler, 1000),
-		vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, 1000),
-		vk::DescriptorPoolSize(vk::DescriptorType::eSampledImage, 1000),
-		vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, 1000),
-		vk::DescriptorPoolSize(vk::DescriptorType::eUniformTexelBuffer, 1000),
-		vk::DescriptorPoolSize(vk::DescriptorType::eStorageTexelBuffer, 1000),
-		vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, 1000),
-		vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 1000),
-		vk::DescriptorPoolSize(vk::DescriptorType::eUniformBufferDynamic, 1000),
-		vk::DescriptorPoolSize(vk::DescriptorType::eStorageBufferDynamic, 1000),
-		vk::DescriptorPoolSize(vk::DescriptorType::eInputAttachment, 1000),
+		vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, 16),
 	};
 	vk::DescriptorPoolCreateInfo descriptorPoolCreateInfo = vk::DescriptorPoolCreateInfo()
 		.setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet)
-		.setMaxSets(1000)
+		.setMaxSets(16)
 		.setPoolSizes(descriptorPoolSizes);
-	this->_descriptorPool = vk::raii::DescriptorPool(this->_context.device(), descriptorPoolCreateInfo);
+	this->_imGuiDescriptorPool = vk::raii::DescriptorPool(this->_context.device(), descriptorPoolCreateInfo);
+	this->_descriptorAllocator = DescriptorAllocator(this->_context.device(), Engine::NUM_FRAMES_IN_FLIGHT, 16U);
 }
 
 void Engine::_initImGui(void) {
@@ -408,7 +465,7 @@ void Engine::_initImGui(void) {
 		.Device = *this->_context.device(),
 		.QueueFamily = *this->_context.queueFamilyIndex(jjyou::vk::Context::QueueType::Main),
 		.Queue = **this->_context.queue(jjyou::vk::Context::QueueType::Main),
-		.DescriptorPool = *this->_descriptorPool,
+		.DescriptorPool = *this->_imGuiDescriptorPool,
 		.RenderPass = *this->_renderPass,
 		.MinImageCount = this->_swapchain.numImages(),
 		.ImageCount = this->_swapchain.numImages(),
@@ -480,6 +537,23 @@ void Engine::_createPipelineLayouts() {
 			.setPushConstantRanges(nullptr);
 		this->_surfacePipelineLayouts[MaterialType::Lambertian] = vk::raii::PipelineLayout(this->_context.device(), pipelineLayoutCreateInfo);
 	}
+
+	// color conversion
+	{
+		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
+			*this->_surfaceStorageDescriptorSetLayouts[MaterialType::Simple],
+			*this->_colorConversionDescriptorSetLayout
+		};
+		vk::PushConstantRange pushConstantRange = vk::PushConstantRange()
+			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+			.setOffset(0U)
+			.setSize(sizeof(Surface<MaterialType::Simple>::ColorConversionParameters));
+		vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo()
+			.setFlags(vk::PipelineLayoutCreateFlags(0))
+			.setSetLayouts(descriptorSetLayouts)
+			.setPushConstantRanges(pushConstantRange);
+		this->_colorConversionPipelineLayout = vk::raii::PipelineLayout(this->_context.device(), pipelineLayoutCreateInfo);
+	}
 }
 
 void Engine::_createPipelines() {
@@ -565,13 +639,13 @@ void Engine::_createPipelines() {
 
 	// simple primitive
 	{
-#include "./shader/spv/simplePrimitive.vert.spv.h"
+#include "spv/simplePrimitive.vert.spv.h"
 		vk::raii::ShaderModule vertShaderModule(this->_context.device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(simplePrimitive_vert_spv))
 			.setCodeSize(sizeof(simplePrimitive_vert_spv))
 		);
-#include "./shader/spv/simplePrimitive.frag.spv.h"
+#include "spv/simplePrimitive.frag.spv.h"
 		vk::raii::ShaderModule fragShaderModule(this->_context.device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(simplePrimitive_frag_spv))
@@ -616,13 +690,13 @@ void Engine::_createPipelines() {
 
 	// lambertian primitive
 	{
-#include "./shader/spv/lambertianPrimitive.vert.spv.h"
+#include "spv/lambertianPrimitive.vert.spv.h"
 		vk::raii::ShaderModule vertShaderModule(this->_context.device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(lambertianPrimitive_vert_spv))
 			.setCodeSize(sizeof(lambertianPrimitive_vert_spv))
 		);
-#include "./shader/spv/lambertianPrimitive.frag.spv.h"
+#include "spv/lambertianPrimitive.frag.spv.h"
 		vk::raii::ShaderModule fragShaderModule(this->_context.device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(lambertianPrimitive_frag_spv))
@@ -667,13 +741,13 @@ void Engine::_createPipelines() {
 	
 	// simple surface
 	{
-#include "./shader/spv/surface.vert.spv.h"
+#include "spv/surface.vert.spv.h"
 		vk::raii::ShaderModule vertShaderModule(this->_context.device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(surface_vert_spv))
 			.setCodeSize(sizeof(surface_vert_spv))
 		);
-#include "./shader/spv/simpleSurface.frag.spv.h"
+#include "spv/simpleSurface.frag.spv.h"
 		vk::raii::ShaderModule fragShaderModule(this->_context.device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(simpleSurface_frag_spv))
@@ -711,13 +785,13 @@ void Engine::_createPipelines() {
 
 	// lambertian surface
 	{
-#include "./shader/spv/surface.vert.spv.h"
+#include "spv/surface.vert.spv.h"
 		vk::raii::ShaderModule vertShaderModule(this->_context.device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(surface_vert_spv))
 			.setCodeSize(sizeof(surface_vert_spv))
 		);
-#include "./shader/spv/lambertianSurface.frag.spv.h"
+#include "spv/lambertianSurface.frag.spv.h"
 		vk::raii::ShaderModule fragShaderModule(this->_context.device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(lambertianSurface_frag_spv))
@@ -754,6 +828,29 @@ void Engine::_createPipelines() {
 	}
 }
 
+void Engine::_createColorConversionPipeline(void) {
+#include "spv/convertColor.comp.spv.h"
+	vk::raii::ShaderModule shaderModule(this->_context.device(), vk::ShaderModuleCreateInfo()
+		.setFlags(vk::ShaderModuleCreateFlags(0))
+		.setPCode(reinterpret_cast<const uint32_t*>(convertColor_comp_spv))
+		.setCodeSize(sizeof(convertColor_comp_spv))
+	);
+	vk::ComputePipelineCreateInfo computePipelineCreateInfo = vk::ComputePipelineCreateInfo()
+		.setFlags(vk::PipelineCreateFlags(0))
+		.setStage(
+			vk::PipelineShaderStageCreateInfo()
+			.setFlags(vk::PipelineShaderStageCreateFlags(0))
+			.setStage(vk::ShaderStageFlagBits::eCompute)
+			.setModule(*shaderModule)
+			.setPName("main")
+			.setPSpecializationInfo(nullptr)
+		)
+		.setLayout(*this->_colorConversionPipelineLayout)
+		.setBasePipelineHandle(nullptr)
+		.setBasePipelineIndex(0);
+	this->_colorConversionPipeline = vk::raii::Pipeline(this->_context.device(), nullptr, computePipelineCreateInfo);
+}
+
 void Engine::_createFrameData(void) {
 	std::vector<vk::raii::CommandBuffer> graphicsCommandBuffers;
 	graphicsCommandBuffers = this->_context.device().allocateCommandBuffers(
@@ -778,6 +875,7 @@ void Engine::_createFrameData(void) {
 		this->_framesInFlight[i].graphicsCommandBuffer = std::move(graphicsCommandBuffers[i]);
 		this->_framesInFlight[i].viewLevelDescriptorSet = ViewLevelDescriptorSet(*this);
 		this->_framesInFlight[i].instanceLevelDescriptorSet = InstanceLevelDescriptorSet(*this, 256);
+		this->_framesInFlight[i].drawCommands.reserve(256);
 	}
 }
 
@@ -3,10 +3,12 @@
 #include <jjyou/vk/Vulkan.hpp>
 #include <exception>
 #include <stdexcept>
+#include <chrono>
 #include "Window.hpp"
 #include "Primitives.hpp"
 #include "Texture.hpp"
 #include "DescriptorSet.hpp"
+#include "DescriptorAllocator.hpp"
 #include "Camera.hpp"
 
 /***********************************************************************
@@ -17,6 +19,10 @@
  *			This class does not create or manage the resources related
  *			to KinectFusion. It is only responsible for Vulkan initialization
  *			and graphics rendering.
+ *
+ *			In headless mode, no window, swapchain, or graphics pipeline is
+ *			created. The frame functions keep the frames in flight bounded
+ *			by the frame fences, and draws are discarded.
  ***********************************************************************/
 class Engine {
 
@@ -47,14 +53,36 @@ public:
 	bool debugMode(void) const { return this->_debugMode; }
 	const jjyou::vk::Context& context(void) const { return this->_context; }
 	const jjyou::vk::VmaAllocator& allocator(void) const { return this->_allocator; }
+	const vk::PhysicalDeviceFeatures& enabledFeatures(void) const { return this->_enabledFeatures; }
+	const vk::PhysicalDeviceVulkan12Features& enabledVulkan12Features(void) const { return this->_enabledVulkan12Features; }
 	const Window& window(void) const { return this->_window; }
 	const vk::raii::CommandPool& commandPool(jjyou::vk::Context::QueueType queueType_) const { return this->_commandPools[queueType_]; }
 	const vk::raii::CommandPool& commandPool(std::size_t queueType_) const { return this->_commandPools[queueType_]; }
-	const vk::raii::DescriptorPool& descriptorPool(void) const { return this->_descriptorPool; }
+	DescriptorAllocator& descriptorAllocator(void) const { return this->_descriptorAllocator; }
 	const vk::raii::DescriptorSetLayout& viewLevelDescriptorSetLayout(void) const { return this->_viewLevelDescriptorSetLayout; }
 	const vk::raii::DescriptorSetLayout& instanceLevelDescriptorSetLayout(void) const { return this->_instanceLevelDescriptorSetLayout; }
 	const vk::raii::DescriptorSetLayout& surfaceSamplerDescriptorSetLayout(MaterialType _materialType) const { return this->_surfaceSamplerDescriptorSetLayouts[_materialType]; }
 	const vk::raii::DescriptorSetLayout& surfaceStorageDescriptorSetLayout(MaterialType _materialType) const { return this->_surfaceStorageDescriptorSetLayouts[_materialType]; }
+	const vk::raii::DescriptorSetLayout& colorConversionDescriptorSetLayout(void) const { return this->_colorConversionDescriptorSetLayout; }
+	const vk::raii::PipelineLayout& colorConversionPipelineLayout(void) const { return this->_colorConversionPipelineLayout; }
+	const vk::raii::Pipeline& colorConversionPipeline(void) const { return this->_colorConversionPipeline; }
+
+	/** @brief	Wait for all fences without timeout, and add the wait to `fenceWaitTime`.
+	  */
+	vk::Result waitForFences(vk::ArrayProxy<const vk::Fence> fences_) const;
+
+	/** @brief	Get the total host time blocked in `waitForFences`.
+	  */
+	std::chrono::duration<double> fenceWaitTime(void) const { return this->_fenceWaitTime; }
+
+	/** @brief	Signal a semaphore once the work submitted to the main queue so far has completed.
+	  *
+	  *			Other queues wait on the semaphore before writing resources that
+	  *			submitted frames may still read, e.g. the vertex buffer of a mesh,
+	  *			without blocking the host. The frame between `prepareFrame` and
+	  *			`presentFrame` is not submitted yet, so it is not covered.
+	  */
+	void signalAfterSubmittedFrames(vk::Semaphore semaphore_) const;
 
 	/** @brief	Create a `Primitives` instance.
 	  */
@@ -73,7 +101,7 @@ public:
 	/** @brief	Prepare a new frame. Call this function before rendering.
 	  * @return	The Vulkan result of acquiring a new image from the swapchain.
 	  *			If the result is `vk::Result::eErrorOutOfDateKHR`, you should skip
-	  *			this frame.
+	  *			this frame. Always `vk::Result::eSuccess` in headless mode.
 	  */
 	vk::Result prepareFrame(void);
 
@@ -92,10 +120,16 @@ public:
 		const Surface<materialType>& surface_
 	);
 
+	/** @brief	Get the number of primitives and surfaces sent to the engine in the current frame.
+	  */
+	std::size_t numPrimitivesToDraw(void) const {
+		return this->_activeFrameData().drawCommands.size();
+	}
+
 	/** @brief	Record the command buffer. Call this function after sending all instances
 	  *			to draw to the engine via `Engine::drawPrimitives` and `Engine::drawSurface`.
 	  */
-	void recordCommandbuffer(void) const;
+	void recordCommandbuffer(void);
 
 	/** @brief	Present the current frame. Call this function after recording the command buffer.
 	  */
@@ -146,6 +180,10 @@ private:
 	
 	jjyou::vk::Context _context{ nullptr };
 
+	// Optional device features that are enabled because the physical device supports them.
+	vk::PhysicalDeviceFeatures _enabledFeatures{};
+	vk::PhysicalDeviceVulkan12Features _enabledVulkan12Features{};
+
 	jjyou::vk::VmaAllocator _allocator{ nullptr };
 	
 	Window _window{ nullptr };
@@ -174,8 +212,14 @@ private:
 	std::array<vk::raii::DescriptorSetLayout, MaterialType::NumMaterialTypes> _surfaceSamplerDescriptorSetLayouts{ { vk::raii::DescriptorSetLayout{nullptr}, vk::raii::DescriptorSetLayout{nullptr} } };
 	std::array<vk::raii::DescriptorSetLayout, MaterialType::NumMaterialTypes> _surfaceStorageDescriptorSetLayouts{ { vk::raii::DescriptorSetLayout{nullptr}, vk::raii::DescriptorSetLayout{nullptr} } };
 
-	// Descriptor pool. Over-allocated for simplicity.
-	vk::raii::DescriptorPool _descriptorPool{ nullptr };
+	// Descriptor set layout of the raw color buffer converted into a simple surface
+	vk::raii::DescriptorSetLayout _colorConversionDescriptorSetLayout{ nullptr };
+
+	// Descriptor pool used by ImGui.
+	vk::raii::DescriptorPool _imGuiDescriptorPool{ nullptr };
+
+	// Descriptor allocator for all other descriptor sets. Grows on demand.
+	mutable DescriptorAllocator _descriptorAllocator{ nullptr };
 
 	// Pipelines layouts for drawing primitives
 	std::array<vk::raii::PipelineLayout, MaterialType::NumMaterialTypes> _primitivePipelineLayouts{ { vk::raii::PipelineLayout{nullptr}, vk::raii::PipelineLayout{nullptr} } };
@@ -183,6 +227,9 @@ private:
 	// Pipeline layouts for drawing a quad to display a surface
 	std::array<vk::raii::PipelineLayout, MaterialType::NumMaterialTypes> _surfacePipelineLayouts{ { vk::raii::PipelineLayout{nullptr}, vk::raii::PipelineLayout{nullptr} } };
 
+	// Pipeline layout for converting raw color data into a simple surface
+	vk::raii::PipelineLayout _colorConversionPipelineLayout{ nullptr };
+
 	// Pipelines for drawing scene primitives
 	std::array<std::array<vk::raii::Pipeline, PrimitiveType::NumPrimitiveTypes>, MaterialType::NumMaterialTypes> _primitivePipelines{ {
 		{ { vk::raii::Pipeline{nullptr}, vk::raii::Pipeline{nullptr}, vk::raii::Pipeline{nullptr} } },
@@ -192,6 +239,36 @@ private:
 	// Pipelines for drawing a quad to display a surface
 	std::array<vk::raii::Pipeline, MaterialType::NumMaterialTypes> _surfacePipelines{ { vk::raii::Pipeline{nullptr}, vk::raii::Pipeline{nullptr} } };
 
+	// Compute pipeline for converting raw color data into a simple surface
+	vk::raii::Pipeline _colorConversionPipeline{ nullptr };
+
+	// Host time blocked in `waitForFences`
+	mutable std::chrono::duration<double> _fenceWaitTime{};
+
+	// Render resources
+	/// Draw commands sent via `Engine::drawPrimitives` and `Engine::drawSurface`.
+	/// Before recording, they are sorted by pipeline and geometry, so that instances
+	/// of the same primitives are drawn by a single instanced draw call.
+	using _RecordFunction = void (*)(const Engine& engine_, const vk::raii::CommandBuffer& commandBuffer_, const void* pGeometry_, std::uint32_t instanceCount_, std::uint32_t firstInstance_);
+	struct _DrawCommand {
+		std::uint32_t pipelineIndex = 0U;		// Index returned by `_primitivesPipelineIndex` or `_surfacePipelineIndex`.
+		std::uint32_t submissionIndex = 0U;		// Keeps the submission order among draws of the same geometry.
+		std::uint64_t geometryId = 0ULL;		// `geometryId()` of the geometry. Unlike the address, it does not depend on the heap layout.
+		const void* pGeometry = nullptr;		// `const Primitives<M, P>*` or `const Surface<M>*`.
+		_RecordFunction recordFunction = nullptr;
+		jjyou::glsl::mat4 modelMatrix{ 1.0f };	// Ignored for surfaces.
+	};
+	static constexpr std::uint32_t _primitivesPipelineIndex(MaterialType materialType_, PrimitiveType primitiveType_) {
+		return static_cast<std::uint32_t>(materialType_) * PrimitiveType::NumPrimitiveTypes + static_cast<std::uint32_t>(primitiveType_);
+	}
+	static constexpr std::uint32_t _surfacePipelineIndex(MaterialType materialType_) {
+		return MaterialType::NumMaterialTypes * PrimitiveType::NumPrimitiveTypes + static_cast<std::uint32_t>(materialType_);
+	}
+	template<MaterialType _materialType, PrimitiveType _primitiveType>
+	static void _recordPrimitives(const Engine& engine_, const vk::raii::CommandBuffer& commandBuffer_, const void* pGeometry_, std::uint32_t instanceCount_, std::uint32_t firstInstance_);
+	template<MaterialType _materialType>
+	static void _recordSurface(const Engine& engine_, const vk::raii::CommandBuffer& commandBuffer_, const void* pGeometry_, std::uint32_t instanceCount_, std::uint32_t firstInstance_);
+
 	// Frame data
 	struct _FrameData {
 		vk::raii::Fence inFlightFence{ nullptr };
@@ -200,43 +277,15 @@ private:
 		vk::raii::CommandBuffer graphicsCommandBuffer{ nullptr };
 		ViewLevelDescriptorSet viewLevelDescriptorSet{ nullptr };
 		InstanceLevelDescriptorSet instanceLevelDescriptorSet{ nullptr };
+		std::vector<_DrawCommand> drawCommands{};	// Cleared when the frame begins. The capacity is kept, so that frames do not allocate once it has grown.
 	};
 	std::array<_FrameData, static_cast<std::size_t>(Engine::NUM_FRAMES_IN_FLIGHT)> _framesInFlight;
 	std::uint32_t _swapchainImageIndex = 0;
 	std::uint32_t _frameIndex = 0;
 	const _FrameData& _activeFrameData(void) const { return this->_framesInFlight[static_cast<std::size_t>(this->_frameIndex)]; }
+	_FrameData& _activeFrameData(void) { return this->_framesInFlight[static_cast<std::size_t>(this->_frameIndex)]; }
 	const vk::raii::Framebuffer& _activeFramebuffer(void) const { return this->_framebuffers[static_cast<std::size_t>(this->_swapchainImageIndex)]; }
 
-	// Render resources
-	/// Primitives
-	template<MaterialType _materialType, PrimitiveType _primitiveType>
-	struct _PrimitivesToDraw {
-		const Primitives<_materialType, _primitiveType>* pPrimitives = nullptr;
-		jjyou::glsl::mat4 modelMatrix{ 1.0f };
-		jjyou::glsl::mat4 normalMatrix{ 1.0f };
-	};
-	template<MaterialType _materialType, PrimitiveType _primitiveType>
-	std::vector<_PrimitivesToDraw<_materialType, _primitiveType>>&
-		_getPrimitivesToDraw(void);
-	template<MaterialType _materialType, PrimitiveType _primitiveType>
-	const std::vector <_PrimitivesToDraw<_materialType, _primitiveType>>&
-		_getPrimitivesToDraw(void) const;
-	std::vector<_PrimitivesToDraw<MaterialType::Simple, PrimitiveType::Point>> _simplePoints{};
-	std::vector<_PrimitivesToDraw<MaterialType::Simple, PrimitiveType::Line>> _simpleLines{};
-	std::vector<_PrimitivesToDraw<MaterialType::Simple, PrimitiveType::Triangle>> _simpleTriangles{};
-	std::vector<_PrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Point>> _lambertianPoints{};
-	std::vector<_PrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Line>> _lambertianLines{};
-	std::vector<_PrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Triangle>> _lambertianTriangles{};
-	/// Surfaces
-	template<MaterialType _materialType>
-	std::vector<const Surface<_materialType>*>&
-		_getSurfacesToDraw(void);
-	template<MaterialType _materialType>
-	const std::vector<const Surface<_materialType>*>&
-		_getSurfacesToDraw(void) const;
-	std::vector<const Surface<MaterialType::Simple>*> _simpleSurfaces{};
-	std::vector<const Surface<MaterialType::Lambertian>*> _lambertianSurfaces{};
-
 	// Initialization functions
 	void _createContext(void);
 	void _createAllocator(void);
@@ -250,83 +299,63 @@ private:
 	void _initImGui(void);
 	void _createPipelineLayouts(void);
 	void _createPipelines(void);
+	void _createColorConversionPipeline(void);
 	void _createFrameData(void);
 	void _resizeRenderResources(void);
 };
 
-//// Simple points
-template <>
-inline std::vector<Engine::_PrimitivesToDraw<MaterialType::Simple, PrimitiveType::Point>>&
-Engine::_getPrimitivesToDraw<MaterialType::Simple, PrimitiveType::Point>(void) { return this->_simplePoints; };
-template <>
-inline const std::vector<Engine::_PrimitivesToDraw<MaterialType::Simple, PrimitiveType::Point>>&
-Engine::_getPrimitivesToDraw<MaterialType::Simple, PrimitiveType::Point>(void) const { return this->_simplePoints; };
-//// Simple lines
-template <>
-inline std::vector<Engine::_PrimitivesToDraw<MaterialType::Simple, PrimitiveType::Line>>&
-Engine::_getPrimitivesToDraw<MaterialType::Simple, PrimitiveType::Line>(void) { return this->_simpleLines; };
-template <>
-inline const std::vector<Engine::_PrimitivesToDraw<MaterialType::Simple, PrimitiveType::Line>>&
-Engine::_getPrimitivesToDraw<MaterialType::Simple, PrimitiveType::Line>(void) const { return this->_simpleLines; };
-//// Simple triangles
-template <>
-inline std::vector<Engine::_PrimitivesToDraw<MaterialType::Simple, PrimitiveType::Triangle>>&
-Engine::_getPrimitivesToDraw<MaterialType::Simple, PrimitiveType::Triangle>(void) { return this->_simpleTriangles; };
-template <>
-inline const std::vector<Engine::_PrimitivesToDraw<MaterialType::Simple, PrimitiveType::Triangle>>&
-Engine::_getPrimitivesToDraw<MaterialType::Simple, PrimitiveType::Triangle>(void) const { return this->_simpleTriangles; };
-//// Lambertian points
-template <>
-inline std::vector<Engine::_PrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Point>>&
-Engine::_getPrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Point>(void) { return this->_lambertianPoints; };
-template <>
-inline const std::vector<Engine::_PrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Point>>&
-Engine::_getPrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Point>(void) const { return this->_lambertianPoints; };
-//// Lambertian lines
-template <>
-inline std::vector<Engine::_PrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Line>>&
-Engine::_getPrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Line>(void) { return this->_lambertianLines; };
-template <>
-inline const std::vector<Engine::_PrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Line>>&
-Engine::_getPrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Line>(void) const { return this->_lambertianLines; };
-//// Lambertian triangles
-template <>
-inline std::vector<Engine::_PrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Triangle>>&
-Engine::_getPrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Triangle>(void) { return this->_lambertianTriangles; };
-template <>
-inline const std::vector<Engine::_PrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Triangle>>&
-Engine::_getPrimitivesToDraw<MaterialType::Lambertian, PrimitiveType::Triangle>(void) const { return this->_lambertianTriangles; };
-//// Simple surfaces
-template <>
-inline std::vector<const Surface<MaterialType::Simple>*>&
-Engine::_getSurfacesToDraw(void) { return this->_simpleSurfaces; };
-template <>
-inline const std::vector<const Surface<MaterialType::Simple>*>&
-Engine::_getSurfacesToDraw(void) const { return this->_simpleSurfaces; };
-//// Lambertian surfaces
-template <>
-inline std::vector<const Surface<MaterialType::Lambertian>*>&
-Engine::_getSurfacesToDraw(void) { return this->_lambertianSurfaces; };
-template <>
-inline const std::vector<const Surface<MaterialType::Lambertian>*>&
-Engine::_getSurfacesToDraw(void) const { return this->_lambertianSurfaces; };
-
 template<MaterialType materialType, PrimitiveType primitiveType>
 inline void Engine::drawPrimitives(
 	const Primitives<materialType, primitiveType>& primitives_,
 	const jjyou::glsl::mat4& modelMatrix_
 ) {
-	_PrimitivesToDraw<materialType, primitiveType> _primitivesToDraw{
-		.pPrimitives = &primitives_,
-		.modelMatrix = modelMatrix_,
-		.normalMatrix = jjyou::glsl::transpose(jjyou::glsl::inverse(modelMatrix_))
-	};
-	this->_getPrimitivesToDraw<materialType, primitiveType>().push_back(_primitivesToDraw);
+	std::vector<_DrawCommand>& drawCommands = this->_activeFrameData().drawCommands;
+	drawCommands.push_back(_DrawCommand{
+		.pipelineIndex = Engine::_primitivesPipelineIndex(materialType, primitiveType),
+		.submissionIndex = static_cast<std::uint32_t>(drawCommands.size()),
+		.geometryId = primitives_.geometryId(),
+		.pGeometry = &primitives_,
+		.recordFunction = &Engine::_recordPrimitives<materialType, primitiveType>,
+		.modelMatrix = modelMatrix_
+	});
 }
 
 template<MaterialType materialType>
 inline void Engine::drawSurface(
 	const Surface<materialType>& surface_
 ) {
-	this->_getSurfacesToDraw<materialType>().push_back(&surface_);
+	std::vector<_DrawCommand>& drawCommands = this->_activeFrameData().drawCommands;
+	drawCommands.push_back(_DrawCommand{
+		.pipelineIndex = Engine::_surfacePipelineIndex(materialType),
+		.submissionIndex = static_cast<std::uint32_t>(drawCommands.size()),
+		.geometryId = surface_.geometryId(),
+		.pGeometry = &surface_,
+		.recordFunction = &Engine::_recordSurface<materialType>,
+		.modelMatrix = jjyou::glsl::mat4(1.0f)
+	});
+}
+
+template<MaterialType _materialType, PrimitiveType _primitiveType>
+inline void Engine::_recordPrimitives(
+	const Engine& engine_,
+	const vk::raii::CommandBuffer& commandBuffer_,
+	const void* pGeometry_,
+	std::uint32_t instanceCount_,
+	std::uint32_t firstInstance_
+) {
+	static_cast<const Primitives<_materialType, _primitiveType>*>(pGeometry_)->draw(commandBuffer_, instanceCount_, firstInstance_);
+}
+
+template<MaterialType _materialType>
+inline void Engine::_recordSurface(
+	const Engine& engine_,
+	const vk::raii::CommandBuffer& commandBuffer_,
+	const void* pGeometry_,
+	std::uint32_t instanceCount_,
+	std::uint32_t firstInstance_
+) {
+	// Surfaces are full screen quads. Drawing the same surface more than once is redundant.
+	const Surface<_materialType>* pSurface = static_cast<const Surface<_materialType>*>(pGeometry_);
+	pSurface->bindSampler(commandBuffer_, vk::PipelineBindPoint::eGraphics, engine_._surfacePipelineLayouts[_materialType], 1);
+	pSurface->draw(commandBuffer_);
 }
\ No newline at end of file
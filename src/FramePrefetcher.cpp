@@ -0,0 +1,178 @@
+#include "FramePrefetcher.hpp"
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+
+FramePrefetcher::FramePrefetcher(
+	std::uint64_t numFrames_,
+	std::size_t colorMapSize_,
+	std::size_t numDepthPixels_,
+	std::uint32_t numThreads_,
+	std::uint32_t lookAhead_,
+	ReadFunction read_,
+	DecodeFunction decode_
+) :
+	_numFrames(numFrames_),
+	_read(std::move(read_)),
+	_decode(std::move(decode_))
+{
+	// The slot of the last returned frame is held until the next `next` call.
+	this->_slots.resize(static_cast<std::size_t>(std::max(lookAhead_, 1U)) + 1U);
+	this->_slotStates.resize(this->_slots.size(), _SlotState::Empty);
+	for (Slot& slot : this->_slots) {
+		slot.colorMap.reset(new std::uint8_t[colorMapSize_]{});
+		slot.depthMap.reset(new float[numDepthPixels_]{});
+	}
+	if (numThreads_ == 0U)
+		numThreads_ = std::max(std::thread::hardware_concurrency(), 1U);
+	this->_startTime = std::chrono::steady_clock::now();
+	this->_workers.reserve(numThreads_);
+	for (std::uint32_t i = 0; i < numThreads_; ++i)
+		this->_workers.emplace_back(&FramePrefetcher::_decodeFrames, this);
+	this->_reader = std::thread(&FramePrefetcher::_readFrames, this);
+}
+
+FramePrefetcher::~FramePrefetcher(void) {
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_stop = true;
+	}
+	this->_condition.notify_all();
+	if (this->_reader.joinable())
+		this->_reader.join();
+	for (std::thread& worker : this->_workers)
+		if (worker.joinable())
+			worker.join();
+}
+
+const FramePrefetcher::Slot& FramePrefetcher::next(void) {
+	if (this->_nextFrameIndex == this->_numFrames) {
+		throw std::logic_error("[FramePrefetcher] All frames have been returned.");
+	}
+	std::chrono::steady_clock::time_point waitBegin = std::chrono::steady_clock::now();
+	std::unique_lock<std::mutex> lock(this->_mutex);
+	// Release the slot of the last frame to the reader.
+	if (this->_nextFrameIndex > 0ULL) {
+		this->_slotStates[(this->_nextFrameIndex - 1ULL) % this->_slots.size()] = _SlotState::Empty;
+		this->_condition.notify_all();
+	}
+	std::size_t slotIndex = this->_nextFrameIndex % this->_slots.size();
+	this->_condition.wait(lock, [&](void) {
+		return this->_exception || this->_slotStates[slotIndex] == _SlotState::Decoded;
+	});
+	if (this->_exception)
+		std::rethrow_exception(this->_exception);
+	std::chrono::duration<double> waitTime = std::chrono::steady_clock::now() - waitBegin;
+	this->_statistics.waitTime += waitTime;
+	++this->_statistics.numFrames;
+	++this->_nextFrameIndex;
+	if (this->_metrics.pWaitTime != nullptr) {
+		this->_metrics.pWaitTime->record(waitTime);
+		// The returned frame is not ahead.
+		std::ptrdiff_t numFramesAhead = std::count(this->_slotStates.begin(), this->_slotStates.end(), _SlotState::Decoded) - 1;
+		this->_metrics.pFramesAhead->set(static_cast<double>(numFramesAhead));
+	}
+	return this->_slots[slotIndex];
+}
+
+const FramePrefetcher::Slot* FramePrefetcher::last(void) const {
+	if (this->_nextFrameIndex == 0ULL)
+		return nullptr;
+	return &this->_slots[(this->_nextFrameIndex - 1ULL) % this->_slots.size()];
+}
+
+FramePrefetcher::Statistics FramePrefetcher::statistics(void) const {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return this->_statistics;
+}
+
+void FramePrefetcher::setMetrics(MetricsRegistry* pMetrics_) {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	if (pMetrics_ == nullptr) {
+		this->_metrics = _Metrics{};
+		return;
+	}
+	this->_metrics.pReadTime = &pMetrics_->histogram("kinectfusion_loader_read_seconds", "Time spent reading the compressed data of a frame.", 1.0e-6);
+	this->_metrics.pDecodeTime = &pMetrics_->histogram("kinectfusion_loader_decode_seconds", "Time spent decoding a frame.", 1.0e-6);
+	this->_metrics.pWaitTime = &pMetrics_->histogram("kinectfusion_loader_wait_seconds", "Time spent by the consumer waiting for a decoded frame.", 1.0e-6);
+	this->_metrics.pBytesRead = &pMetrics_->counter("kinectfusion_loader_read_bytes_total", "Number of compressed bytes read.");
+	this->_metrics.pFramesAhead = &pMetrics_->gauge("kinectfusion_loader_frames_ahead", "Number of frames decoded ahead of the consumer.");
+}
+
+void FramePrefetcher::_readFrames(void) {
+	for (std::uint64_t frameIndex = 0ULL; frameIndex < this->_numFrames; ++frameIndex) {
+		std::size_t slotIndex = frameIndex % this->_slots.size();
+		{
+			std::unique_lock<std::mutex> lock(this->_mutex);
+			this->_condition.wait(lock, [&](void) { return this->_stop || this->_slotStates[slotIndex] == _SlotState::Empty; });
+			if (this->_stop)
+				return;
+		}
+		// An empty slot is owned by the reader until it is queued.
+		Slot& slot = this->_slots[slotIndex];
+		slot.frameIndex = frameIndex;
+		std::chrono::steady_clock::time_point readBegin = std::chrono::steady_clock::now();
+		std::size_t numBytesRead = 0U;
+		try {
+			numBytesRead = this->_read(slot);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(this->_mutex);
+			this->_exception = std::current_exception();
+			this->_condition.notify_all();
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(this->_mutex);
+			std::chrono::duration<double> readTime = std::chrono::steady_clock::now() - readBegin;
+			this->_statistics.numBytesRead += numBytesRead;
+			this->_statistics.readTime += readTime;
+			if (this->_metrics.pReadTime != nullptr) {
+				this->_metrics.pReadTime->record(readTime);
+				this->_metrics.pBytesRead->add(numBytesRead);
+			}
+			this->_slotStates[slotIndex] = _SlotState::Read;
+			this->_decodeQueue.push_back(frameIndex);
+		}
+		this->_condition.notify_all();
+	}
+}
+
+void FramePrefetcher::_decodeFrames(void) {
+	while (true) {
+		std::uint64_t frameIndex{};
+		{
+			std::unique_lock<std::mutex> lock(this->_mutex);
+			this->_condition.wait(lock, [&](void) { return this->_stop || !this->_decodeQueue.empty(); });
+			if (this->_stop)
+				return;
+			frameIndex = this->_decodeQueue.front();
+			this->_decodeQueue.pop_front();
+		}
+		// A read slot is owned by the worker that dequeued it until it is decoded.
+		std::size_t slotIndex = frameIndex % this->_slots.size();
+		std::chrono::steady_clock::time_point decodeBegin = std::chrono::steady_clock::now();
+		try {
+			this->_decode(this->_slots[slotIndex]);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(this->_mutex);
+			this->_exception = std::current_exception();
+			this->_condition.notify_all();
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(this->_mutex);
+			std::chrono::steady_clock::time_point decodeEnd = std::chrono::steady_clock::now();
+			std::chrono::duration<double> decodeTime = decodeEnd - decodeBegin;
+			this->_statistics.decodeTime += decodeTime;
+			++this->_statistics.numDecodedFrames;
+			this->_statistics.elapsedTime = decodeEnd - this->_startTime;
+			if (this->_metrics.pDecodeTime != nullptr)
+				this->_metrics.pDecodeTime->record(decodeTime);
+			this->_slotStates[slotIndex] = _SlotState::Decoded;
+		}
+		this->_condition.notify_all();
+	}
+}
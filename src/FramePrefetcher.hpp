@@ -0,0 +1,161 @@
+#pragma once
+#include "Metrics.hpp"
+#include <jjyou/glsl/glsl.hpp>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <chrono>
+#include <cstdint>
+
+/***********************************************************************
+ * @class	FramePrefetcher
+ * @brief	FramePrefetcher class that reads and decodes the frames of a
+ *			data loader ahead of the consumer on background threads.
+ *
+ * A reader thread calls the read function for each frame in order, which
+ * fetches the compressed data of the frame into a slot. A pool of worker
+ * threads calls the decode function on the read slots concurrently. The
+ * consumer gets the decoded slots in order with `next`. There are
+ * `lookAhead + 1` slots, so at most `lookAhead` frames are read or decoded
+ * ahead of the consumer, and the memory is bounded. The slot returned by
+ * `next` stays valid until the following call. Exceptions thrown by the
+ * read or decode function are rethrown by `next`.
+ ***********************************************************************/
+class FramePrefetcher {
+
+public:
+
+	/***********************************************************************
+	 * @class	Slot
+	 * @brief	Data of a frame.
+	 ***********************************************************************/
+	struct Slot {
+		std::uint64_t frameIndex = 0ULL;
+		std::optional<jjyou::glsl::mat4> view = std::nullopt;
+		std::vector<std::uint8_t> colorData{};			//!< Compressed color data, filled by the read function.
+		std::vector<std::uint8_t> depthData{};			//!< Compressed depth data, filled by the read function.
+		std::unique_ptr<std::uint8_t[]> colorMap{};		//!< Decoded color map, filled by the decode function.
+		std::unique_ptr<float[]> depthMap{};			//!< Decoded depth map, filled by the decode function.
+	};
+
+	/***********************************************************************
+	 * @class	Statistics
+	 * @brief	Ingest statistics.
+	 ***********************************************************************/
+	struct Statistics {
+		std::uint32_t numFrames = 0U;					//!< Number of frames returned by `next`.
+		std::uint32_t numDecodedFrames = 0U;			//!< Number of frames decoded by the workers.
+		std::uint64_t numBytesRead = 0ULL;				//!< Number of bytes returned by the read function.
+		std::chrono::duration<double> readTime{};		//!< Time spent by the reader thread in the read function.
+		std::chrono::duration<double> decodeTime{};		//!< Time spent by all workers in the decode function.
+		std::chrono::duration<double> waitTime{};		//!< Time spent by `next` waiting for decoded frames.
+		std::chrono::duration<double> elapsedTime{};	//!< Wall-clock time from the start of the prefetcher to the last decoded frame.
+	};
+
+	/** @brief	Read function. Fills `view`, `colorData` and `depthData` of the slot, and returns the number of bytes read.
+	  */
+	using ReadFunction = std::function<std::size_t(Slot&)>;
+
+	/** @brief	Decode function. Fills `colorMap` and `depthMap` of the slot. Called concurrently on different slots.
+	  */
+	using DecodeFunction = std::function<void(Slot&)>;
+
+	/** @brief	Start the reader and the workers.
+	  * @param	numFrames_			Number of frames.
+	  * @param	colorMapSize_		Size of the decoded color map in bytes.
+	  * @param	numDepthPixels_		Number of pixels of the decoded depth map.
+	  * @param	numThreads_			Number of decoding threads. If 0, the number of hardware threads is used.
+	  * @param	lookAhead_			Maximal number of frames read and decoded ahead of the consumer. At least 1.
+	  * @param	read_				Read function, called in frame order on the reader thread.
+	  * @param	decode_				Decode function, called on the worker threads.
+	  */
+	FramePrefetcher(
+		std::uint64_t numFrames_,
+		std::size_t colorMapSize_,
+		std::size_t numDepthPixels_,
+		std::uint32_t numThreads_,
+		std::uint32_t lookAhead_,
+		ReadFunction read_,
+		DecodeFunction decode_
+	);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	FramePrefetcher(const FramePrefetcher&) = delete;
+	FramePrefetcher(FramePrefetcher&&) = delete;
+	FramePrefetcher& operator=(const FramePrefetcher&) = delete;
+	FramePrefetcher& operator=(FramePrefetcher&&) = delete;
+
+	/** @brief	Destructor. Stop the reader and the workers.
+	  */
+	~FramePrefetcher(void);
+
+	/** @brief	Wait for the next decoded frame, and release the previous one.
+	  *
+	  * Throws `std::logic_error` if all frames have been returned.
+	  */
+	const Slot& next(void);
+
+	/** @brief	Get the slot returned by the last `next` call, or nullptr.
+	  */
+	const Slot* last(void) const;
+
+	/** @brief	Getters.
+	  */
+	std::uint64_t numFrames(void) const { return this->_numFrames; }
+	std::uint32_t numThreads(void) const { return static_cast<std::uint32_t>(this->_workers.size()); }
+	std::uint32_t lookAhead(void) const { return static_cast<std::uint32_t>(this->_slots.size() - 1U); }
+
+	/** @brief	Get the ingest statistics.
+	  */
+	Statistics statistics(void) const;
+
+	/** @brief	Register the ingest metrics in a registry, and update them from now on:
+	  *			the read / decode / wait times, the bytes read, and the number of
+	  *			frames decoded ahead of the consumer.
+	  * @param	pMetrics_	The registry, which must outlive this instance, or nullptr to stop updating.
+	  */
+	void setMetrics(MetricsRegistry* pMetrics_);
+
+private:
+
+	enum class _SlotState { Empty, Read, Decoded };
+
+	std::uint64_t _numFrames = 0ULL;
+	std::uint64_t _nextFrameIndex = 0ULL;
+	ReadFunction _read{};
+	DecodeFunction _decode{};
+	std::vector<Slot> _slots{};				// Frame `i` uses slot `i % _slots.size()`.
+	std::vector<_SlotState> _slotStates{};
+	std::deque<std::uint64_t> _decodeQueue{};
+	mutable std::mutex _mutex{};
+	std::condition_variable _condition{};
+	bool _stop = false;
+	std::exception_ptr _exception{};
+	Statistics _statistics{};
+	std::chrono::steady_clock::time_point _startTime{};
+	struct _Metrics {
+		MetricsRegistry::Histogram* pReadTime = nullptr;
+		MetricsRegistry::Histogram* pDecodeTime = nullptr;
+		MetricsRegistry::Histogram* pWaitTime = nullptr;
+		MetricsRegistry::Counter* pBytesRead = nullptr;
+		MetricsRegistry::Gauge* pFramesAhead = nullptr;
+	} _metrics{};	// Guarded by `_mutex`. All nullptr if no registry is set.
+	std::thread _reader{};
+	std::vector<std::thread> _workers{};
+
+	/** @brief	Main function of the reader thread.
+	  */
+	void _readFrames(void);
+
+	/** @brief	Main function of the worker threads.
+	  */
+	void _decodeFrames(void);
+
+};
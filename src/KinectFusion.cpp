@@ -1,7 +1,12 @@
 #include "KinectFusion.hpp"
 #include <exception>
 #include <stdexcept>
-#include <Eigen/Eigen>
+#include <cstddef>
+#include <chrono>
+#include <future>
+#include <algorithm>
+#include <cmath>
+#include "PLYWriter.hpp"
 
 #define VK_THROW(err) \
 	throw std::runtime_error("[KinectFusion] Vulkan error in file " + std::string(__FILE__) + " line " + std::to_string(__LINE__) + ": " + vk::to_string(err))
@@ -20,7 +25,17 @@ KinectFusion::KinectFusion(
 	const jjyou::glsl::uvec3 & resolution_,
 	float size_,
 	std::optional<jjyou::glsl::vec3> corner_,
-	std::optional<float> truncationDistance_
+	std::optional<float> truncationDistance_,
+	bool sparseVolume_,
+	std::uint32_t trackingLevel_,
+	std::uint32_t meshCacheSlabs_,
+	bool pipelinedTracking_,
+	bool halfPrecision_,
+	std::optional<std::uint32_t> colorBrickCapacity_,
+	std::uint32_t modelMapCacheSize_,
+	float modelMapCacheDistance_,
+	float modelMapCacheAngle_,
+	const jjyou::glsl::uvec2& fusionWorkGroupSize_
 ) : 
 	_pEngine(&engine_),
 	_colorFrameExtent(colorFrameExtent_),
@@ -28,23 +43,60 @@ KinectFusion::KinectFusion(
 	_truncationWeight(truncationWeight_),
 	_minDepth(minDepth_),
 	_maxDepth(maxDepth_),
-	_invalidDepth(invalidDepth_)
+	_invalidDepth(invalidDepth_),
+	_trackingLevel(trackingLevel_),
+	_pipelinedTracking(pipelinedTracking_),
+	_trackingQueueType(pipelinedTracking_ ? jjyou::vk::Context::QueueType::Main : jjyou::vk::Context::QueueType::Compute),
+	_halfPrecision(halfPrecision_ && engine_.enabledVulkan12Features().shaderFloat16)
 {
+	if (trackingLevel_ >= KinectFusion::NUM_PYRAMID_LEVELS) {
+		throw std::logic_error("[KinectFusion] The tracking level is " + std::to_string(trackingLevel_) + " but there are only " + std::to_string(KinectFusion::NUM_PYRAMID_LEVELS) + " pyramid levels.");
+	}
 	if (depthFrameExtent_.width % (1U << KinectFusion::NUM_PYRAMID_LEVELS) != 0) {
 		throw std::logic_error("The width of depth frame is " + std::to_string(depthFrameExtent_.width) + " which is not a multiple of " + std::to_string(1U << KinectFusion::NUM_PYRAMID_LEVELS) + ".");
 	}
 	if (depthFrameExtent_.height % (1U << KinectFusion::NUM_PYRAMID_LEVELS) != 0) {
 		throw std::logic_error("The height of depth frame is " + std::to_string(depthFrameExtent_.height) + " which is not a multiple of " + std::to_string(1U << KinectFusion::NUM_PYRAMID_LEVELS) + ".");
 	}
+	if (pipelinedTracking_) {
+		std::uint32_t mainQueueFamilyIndex = *this->_pEngine->context().queueFamilyIndex(jjyou::vk::Context::QueueType::Main);
+		vk::QueueFlags mainQueueFlags = this->_pEngine->context().physicalDevice().getQueueFamilyProperties()[mainQueueFamilyIndex].queueFlags;
+		if (!(mainQueueFlags & vk::QueueFlagBits::eCompute)) {
+			throw std::runtime_error("[KinectFusion] Pipelined tracking requires a main queue that supports compute.");
+		}
+	}
+	const vk::PhysicalDeviceLimits& limits = this->_pEngine->context().physicalDevice().getProperties().limits;
+	if (fusionWorkGroupSize_.x == 0U || fusionWorkGroupSize_.y == 0U ||
+		fusionWorkGroupSize_.x > limits.maxComputeWorkGroupSize[0] || fusionWorkGroupSize_.y > limits.maxComputeWorkGroupSize[1] ||
+		fusionWorkGroupSize_.x * fusionWorkGroupSize_.y > limits.maxComputeWorkGroupInvocations) {
+		throw std::logic_error("[KinectFusion] The fusion work group size " + std::to_string(fusionWorkGroupSize_.x) + "x" + std::to_string(fusionWorkGroupSize_.y) + " exceeds the compute limits of the device.");
+	}
 	this->_createDescriptorSetLayouts();
-	this->_tsdfVolume = TSDFVolume(*this->_pEngine, *this, resolution_, size_, corner_, truncationDistance_);
+	this->_tsdfVolume = TSDFVolume(*this->_pEngine, *this, resolution_, size_, corner_, truncationDistance_, sparseVolume_, colorBrickCapacity_);
+	// The volume falls back to dense if the device does not support sparse residency.
+	this->_pipelineTraits.sparseVolume = this->_tsdfVolume.sparse();
+	this->_pipelineTraits.halfPrecision = this->_halfPrecision;
+	this->_pipelineTraits.fusionWorkGroupSize = fusionWorkGroupSize_;
 	this->_createPipelineLayouts();
 	this->_createPipelines();
 	this->_createAlgorithmData();
+	if (meshCacheSlabs_ != 0U)
+		this->_meshCache = MeshCache(*this->_pEngine, *this, meshCacheSlabs_);
+	this->_modelMapCache.capacity = modelMapCacheSize_;
+	this->_modelMapCache.maxDistance = modelMapCacheDistance_;
+	this->_modelMapCache.maxAngle = modelMapCacheAngle_;
 	this->initTSDFVolume();
 }
 
-void KinectFusion::initTSDFVolume(void) const {
+void KinectFusion::initTSDFVolume(void) {
+	this->endFuse();
+	// The predicted model maps show the old volume.
+	this->_waitModelRayCasting();
+	this->_poseEstimationAlgorithmData.predictedModelView = std::nullopt;
+	this->_clearModelMapCache();
+	this->_modelMapCache.statistics = ModelMapCacheStatistics{};
+	this->_tsdfVolume.releasePages();
+	this->_worldGravity = std::nullopt;
 	const vk::raii::CommandBuffer& commandBuffer = this->_initVolumeAlgorithmData.commandBuffer;
 	const vk::raii::Fence& fence = this->_initVolumeAlgorithmData.fence;
 	commandBuffer.begin(
@@ -68,10 +120,15 @@ void KinectFusion::initTSDFVolume(void) const {
 		.setSignalSemaphores(nullptr),
 		*fence
 	);
-	vk::Result waitResult = this->_pEngine->context().device().waitForFences(*fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+	vk::Result waitResult = this->_pEngine->waitForFences(*fence);
 	VK_CHECK(waitResult);
 	this->_pEngine->context().device().resetFences(*fence);
 	commandBuffer.reset(vk::CommandBufferResetFlags(0));
+	// The initialized volume has no surface and no colors.
+	this->_tsdfVolume.resetModifiedBricks();
+	this->_tsdfVolume.resetColorBricks();
+	if (this->meshCacheEnabled())
+		this->_meshCache.reset();
 }
 
 void KinectFusion::rayCasting(
@@ -83,7 +140,9 @@ void KinectFusion::rayCasting(
 	float invalidDepth_,
 	std::optional<float> marchingStep_
 ) const {
-	const RayCastingDescriptorSet& rayCastingDescriptorSet = this->_rayCastingAlgorithmData.descriptorSet;
+	if (this->_fusionPending) {
+		throw std::logic_error("[KinectFusion] Cannot ray cast the volume while a fusion is pending. Please call `endFuse` first.");
+	}
 	const vk::raii::CommandBuffer& commandBuffer = this->_rayCastingAlgorithmData.commandBuffer;
 	const vk::raii::Fence& fence = this->_rayCastingAlgorithmData.fence;
 	commandBuffer.begin(
@@ -91,25 +150,79 @@ void KinectFusion::rayCasting(
 		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
 		.setPInheritanceInfo(nullptr)
 	);
-	commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_rayCastingPipeline);
-	this->_tsdfVolume.bind(commandBuffer, vk::PipelineBindPoint::eCompute, this->_rayCastingPipelineLayout, 0);
+	this->recordRayCasting(commandBuffer, this->_rayCastingAlgorithmData.descriptorSet, surface_, camera_, view_, minDepth_, maxDepth_, invalidDepth_, marchingStep_);
+	commandBuffer.end();
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(*commandBuffer)
+		.setSignalSemaphores(nullptr),
+		*fence
+	);
+	vk::Result waitResult = this->_pEngine->waitForFences(*fence);
+	VK_CHECK(waitResult);
+	this->_pEngine->context().device().resetFences(*fence);
+	commandBuffer.reset(vk::CommandBufferResetFlags(0));
+}
+
+void KinectFusion::recordRayCasting(
+	const vk::raii::CommandBuffer& commandBuffer_,
+	const RayCastingDescriptorSet& descriptorSet_,
+	const Surface<Lambertian>& surface_,
+	const Camera& camera_,
+	const jjyou::glsl::mat4& view_,
+	float minDepth_,
+	float maxDepth_,
+	float invalidDepth_,
+	std::optional<float> marchingStep_
+) const {
+	if (this->_fusionPending) {
+		throw std::logic_error("[KinectFusion] Cannot ray cast the volume while a fusion is pending. Please call `endFuse` first.");
+	}
+	commandBuffer_.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_rayCastingPipeline);
+	this->_tsdfVolume.bind(commandBuffer_, vk::PipelineBindPoint::eCompute, this->_rayCastingPipelineLayout, 0);
 	jjyou::glsl::mat3 projection = camera_.getVisionProjection();
-	rayCastingDescriptorSet.rayCastingParameters().fx = projection[0][0];
-	rayCastingDescriptorSet.rayCastingParameters().fy = projection[1][1];
-	rayCastingDescriptorSet.rayCastingParameters().cx = projection[2][0];
-	rayCastingDescriptorSet.rayCastingParameters().cy = projection[2][1];
-	rayCastingDescriptorSet.rayCastingParameters().invView = jjyou::glsl::inverse(view_);
-	rayCastingDescriptorSet.rayCastingParameters().minDepth = minDepth_;
-	rayCastingDescriptorSet.rayCastingParameters().maxDepth = maxDepth_;
-	rayCastingDescriptorSet.rayCastingParameters().invalidDepth = invalidDepth_;
-	rayCastingDescriptorSet.rayCastingParameters().marchingStep = marchingStep_.has_value() ? *marchingStep_ : (0.5f * this->_tsdfVolume.size());
-	rayCastingDescriptorSet.bind(commandBuffer, vk::PipelineBindPoint::eCompute, this->_rayCastingPipelineLayout, 1);
-	surface_.bindStorage(commandBuffer, vk::PipelineBindPoint::eCompute, this->_rayCastingPipelineLayout, 2);
-	commandBuffer.dispatch(
+	descriptorSet_.rayCastingParameters().fx = projection[0][0];
+	descriptorSet_.rayCastingParameters().fy = projection[1][1];
+	descriptorSet_.rayCastingParameters().cx = projection[2][0];
+	descriptorSet_.rayCastingParameters().cy = projection[2][1];
+	descriptorSet_.rayCastingParameters().invView = jjyou::glsl::inverse(view_);
+	descriptorSet_.rayCastingParameters().minDepth = minDepth_;
+	descriptorSet_.rayCastingParameters().maxDepth = maxDepth_;
+	descriptorSet_.rayCastingParameters().invalidDepth = invalidDepth_;
+	descriptorSet_.rayCastingParameters().marchingStep = marchingStep_.has_value() ? *marchingStep_ : (0.5f * this->_tsdfVolume.size());
+	descriptorSet_.bind(commandBuffer_, vk::PipelineBindPoint::eCompute, this->_rayCastingPipelineLayout, 1);
+	surface_.bindStorage(commandBuffer_, vk::PipelineBindPoint::eCompute, this->_rayCastingPipelineLayout, 2);
+	commandBuffer_.dispatch(
 		(surface_.texture(0).extent().width + KinectFusion::_rayCastingWorkGroupSize.x - 1U) / KinectFusion::_rayCastingWorkGroupSize.x,
 		(surface_.texture(0).extent().height + KinectFusion::_rayCastingWorkGroupSize.y - 1U) / KinectFusion::_rayCastingWorkGroupSize.y,
 		1U
 	);
+}
+
+void KinectFusion::batchRayCasting(
+	const std::vector<const Surface<Lambertian>*>& surfaces_,
+	const std::vector<Camera>& cameras_,
+	const std::vector<jjyou::glsl::mat4>& views_,
+	float minDepth_,
+	float maxDepth_,
+	float invalidDepth_,
+	std::optional<float> marchingStep_
+) const {
+	if (this->_fusionPending) {
+		throw std::logic_error("[KinectFusion] Cannot ray cast the volume while a fusion is pending. Please call `endFuse` first.");
+	}
+	if (surfaces_.empty())
+		return;
+	const vk::raii::CommandBuffer& commandBuffer = this->_rayCastingAlgorithmData.commandBuffer;
+	const vk::raii::Fence& fence = this->_rayCastingAlgorithmData.fence;
+	commandBuffer.begin(
+		vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	this->recordBatchRayCasting(commandBuffer, this->_rayCastingAlgorithmData.batchDescriptorSets, surfaces_, cameras_, views_, minDepth_, maxDepth_, invalidDepth_, marchingStep_);
 	commandBuffer.end();
 	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
 		vk::SubmitInfo()
@@ -119,12 +232,78 @@ void KinectFusion::rayCasting(
 		.setSignalSemaphores(nullptr),
 		*fence
 	);
-	vk::Result waitResult = this->_pEngine->context().device().waitForFences(*fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+	vk::Result waitResult = this->_pEngine->waitForFences(*fence);
 	VK_CHECK(waitResult);
 	this->_pEngine->context().device().resetFences(*fence);
 	commandBuffer.reset(vk::CommandBufferResetFlags(0));
 }
 
+void KinectFusion::recordBatchRayCasting(
+	const vk::raii::CommandBuffer& commandBuffer_,
+	std::vector<BatchRayCastingDescriptorSet>& descriptorSets_,
+	const std::vector<const Surface<Lambertian>*>& surfaces_,
+	const std::vector<Camera>& cameras_,
+	const std::vector<jjyou::glsl::mat4>& views_,
+	float minDepth_,
+	float maxDepth_,
+	float invalidDepth_,
+	std::optional<float> marchingStep_
+) const {
+	if (this->_fusionPending) {
+		throw std::logic_error("[KinectFusion] Cannot ray cast the volume while a fusion is pending. Please call `endFuse` first.");
+	}
+	if (cameras_.size() != surfaces_.size() || views_.size() != surfaces_.size()) {
+		throw std::logic_error("[KinectFusion] The numbers of surfaces, cameras, and views of batched ray casting must be the same.");
+	}
+	if (surfaces_.empty())
+		return;
+	std::uint32_t numViews = static_cast<std::uint32_t>(surfaces_.size());
+	std::uint32_t numDispatches = (numViews + BatchRayCastingDescriptorSet::MAX_VIEWS - 1U) / BatchRayCastingDescriptorSet::MAX_VIEWS;
+	while (descriptorSets_.size() < numDispatches)
+		descriptorSets_.emplace_back(*this->_pEngine, *this);
+	commandBuffer_.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_batchRayCastingPipeline);
+	this->_tsdfVolume.bind(commandBuffer_, vk::PipelineBindPoint::eCompute, this->_batchRayCastingPipelineLayout, 0);
+	for (std::uint32_t dispatch = 0; dispatch < numDispatches; ++dispatch) {
+		const BatchRayCastingDescriptorSet& batchDescriptorSet = descriptorSets_[dispatch];
+		BatchRayCastingDescriptorSet::BatchRayCastingParameters& parameters = batchDescriptorSet.batchRayCastingParameters();
+		std::uint32_t beginView = dispatch * BatchRayCastingDescriptorSet::MAX_VIEWS;
+		std::uint32_t endView = std::min(beginView + BatchRayCastingDescriptorSet::MAX_VIEWS, numViews);
+		std::vector<std::array<vk::ImageView, 3>> imageViews;
+		imageViews.reserve(endView - beginView);
+		vk::Extent2D maxExtent(0U, 0U);
+		for (std::uint32_t view = beginView; view < endView; ++view) {
+			const Surface<Lambertian>& surface = *surfaces_[view];
+			vk::Extent2D extent = surface.texture(0).extent();
+			jjyou::glsl::mat3 projection = cameras_[view].getVisionProjection();
+			BatchRayCastingDescriptorSet::ViewParameters& viewParameters = parameters.views[view - beginView];
+			viewParameters.fx = projection[0][0];
+			viewParameters.fy = projection[1][1];
+			viewParameters.cx = projection[2][0];
+			viewParameters.cy = projection[2][1];
+			viewParameters.invView = jjyou::glsl::inverse(views_[view]);
+			viewParameters.minDepth = minDepth_;
+			viewParameters.maxDepth = maxDepth_;
+			viewParameters.invalidDepth = invalidDepth_;
+			viewParameters.marchingStep = marchingStep_.has_value() ? *marchingStep_ : (0.5f * this->_tsdfVolume.size());
+			viewParameters.width = extent.width;
+			viewParameters.height = extent.height;
+			imageViews.push_back({ *surface.texture(0).imageView(), *surface.texture(1).imageView(), *surface.texture(2).imageView() });
+			maxExtent.width = std::max(maxExtent.width, extent.width);
+			maxExtent.height = std::max(maxExtent.height, extent.height);
+		}
+		parameters.numViews = endView - beginView;
+		batchDescriptorSet.setImageViews(imageViews);
+		batchDescriptorSet.bind(commandBuffer_, vk::PipelineBindPoint::eCompute, this->_batchRayCastingPipelineLayout, 1);
+		// The view index is the fastest varying dimension of the work groups, so that the same
+		// tile of all views is launched together. Smaller views return early beyond their extents.
+		commandBuffer_.dispatch(
+			endView - beginView,
+			(maxExtent.width + KinectFusion::_batchRayCastingWorkGroupSize.x - 1U) / KinectFusion::_batchRayCastingWorkGroupSize.x,
+			(maxExtent.height + KinectFusion::_batchRayCastingWorkGroupSize.y - 1U) / KinectFusion::_batchRayCastingWorkGroupSize.y
+		);
+	}
+}
+
 std::optional<jjyou::glsl::mat4> KinectFusion::estimatePose(
 	const Surface<Simple>& surface_,
 	const Camera& camera_,
@@ -133,8 +312,193 @@ std::optional<jjyou::glsl::mat4> KinectFusion::estimatePose(
 	float sigmaSpace_,
 	int filterKernelSize_,
 	float distanceThreshold_,
-	float angleThreshold_
+	float angleThreshold_,
+	const std::vector<jjyou::glsl::mat4>& poseHypotheses_,
+	const std::optional<jjyou::glsl::vec3>& gravity_,
+	float gravityWeight_
+) const {
+	std::optional<jjyou::glsl::mat4> view = this->_estimatePose(
+		surface_,
+		camera_,
+		initialView_,
+		sigmaColor_,
+		sigmaSpace_,
+		filterKernelSize_,
+		distanceThreshold_,
+		angleThreshold_,
+		poseHypotheses_,
+		gravity_,
+		gravityWeight_,
+		this->_halfPrecision
+	);
+	if (this->_metrics.pICPFailures != nullptr) {
+		if (!view.has_value())
+			this->_metrics.pICPFailures->add();
+		else
+			this->_metrics.pICPIterations->record(static_cast<double>(this->numICPIterations()));
+	}
+	return view;
+}
+
+std::optional<jjyou::glsl::mat4> KinectFusion::alignGravity(const jjyou::glsl::mat4& view_, const jjyou::glsl::vec3& gravity_) const {
+	if (!this->_worldGravity.has_value())
+		return std::nullopt;
+	jjyou::glsl::vec3 predicted = jjyou::glsl::normalized(jjyou::glsl::mat3(view_) * *this->_worldGravity);
+	jjyou::glsl::vec3 axis = jjyou::glsl::cross(predicted, gravity_);
+	float cosine = jjyou::glsl::dot(predicted, gravity_);
+	if (cosine <= -0.99f)
+		return std::nullopt;
+	// Rodrigues' formula: R = cI + [k]x + kk^T / (1 + c), where k = p x m and c = p . m.
+	jjyou::glsl::mat3 rotation(cosine);
+	rotation[1][0] -= axis.z; rotation[2][0] += axis.y;
+	rotation[0][1] += axis.z; rotation[2][1] -= axis.x;
+	rotation[0][2] -= axis.y; rotation[1][2] += axis.x;
+	for (int col = 0; col < 3; ++col)
+		for (int row = 0; row < 3; ++row)
+			rotation[col][row] += axis[row] * axis[col] / (1.0f + cosine);
+	return jjyou::glsl::mat4(rotation) * view_;
+}
+
+KinectFusion::HalfPrecisionComparison KinectFusion::compareHalfPrecision(
+	const Surface<Simple>& surface_,
+	const Camera& camera_,
+	const jjyou::glsl::mat4& initialView_,
+	float sigmaColor_,
+	float sigmaSpace_,
+	int filterKernelSize_,
+	float distanceThreshold_,
+	float angleThreshold_,
+	const std::vector<jjyou::glsl::mat4>& poseHypotheses_,
+	const std::optional<jjyou::glsl::vec3>& gravity_,
+	float gravityWeight_
+) const {
+	if (!this->_pEngine->enabledVulkan12Features().shaderFloat16) {
+		throw std::logic_error("[KinectFusion] Cannot compare the half precision kernels because shaderFloat16 is not enabled.");
+	}
+	this->_createHalfPrecisionPipelines();
+	// Run pose estimation and download the depth and normal maps of the frame pyramid.
+	struct Run {
+		std::optional<jjyou::glsl::mat4> view;
+		std::array<std::vector<float>, KinectFusion::NUM_PYRAMID_LEVELS> depthMaps;
+		std::array<std::vector<float>, KinectFusion::NUM_PYRAMID_LEVELS> normalMaps;
+		KernelTimes times;
+	};
+	const std::array<PyramidData, KinectFusion::NUM_PYRAMID_LEVELS>& framePyramid = this->_poseEstimationAlgorithmData.framePyramid;
+	auto run = [&](bool halfPrecision_) {
+		Run result{};
+		result.view = this->_estimatePose(surface_, camera_, initialView_, sigmaColor_, sigmaSpace_, filterKernelSize_, distanceThreshold_, angleThreshold_, poseHypotheses_, gravity_, gravityWeight_, halfPrecision_);
+		result.times = this->kernelTimes().value_or(KernelTimes{});
+		for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+			vk::Extent2D extent = framePyramid[level].texture(0).extent();
+			std::size_t numPixels = static_cast<std::size_t>(extent.width) * static_cast<std::size_t>(extent.height);
+			result.depthMaps[level].resize(numPixels);
+			framePyramid[level].texture(0).download(result.depthMaps[level].data());
+			result.normalMaps[level].resize(numPixels * 4U);
+			framePyramid[level].texture(2).download(result.normalMaps[level].data());
+		}
+		return result;
+	};
+	// `estimatePose` runs twice on the same frame, but the model map cache statistics count it once.
+	Run fp32 = run(false);
+	ModelMapCacheStatistics modelMapCacheStatistics = this->_modelMapCache.statistics;
+	Run fp16 = run(true);
+	modelMapCacheStatistics.numKeyframes = this->_modelMapCache.statistics.numKeyframes;
+	this->_modelMapCache.statistics = modelMapCacheStatistics;
+	HalfPrecisionComparison comparison{};
+	comparison.fp32Times = fp32.times;
+	comparison.fp16Times = fp16.times;
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		std::size_t numPixels = fp32.depthMaps[level].size();
+		comparison.numPixels[level] = static_cast<std::uint32_t>(numPixels);
+		for (std::size_t pixel = 0; pixel < numPixels; ++pixel) {
+			// Invalid depths are +inf.
+			float depth32 = fp32.depthMaps[level][pixel];
+			float depth16 = fp16.depthMaps[level][pixel];
+			if (std::isfinite(depth32) && std::isfinite(depth16))
+				comparison.maxDepthError[level] = std::max(comparison.maxDepthError[level], std::abs(depth32 - depth16));
+			const float* normal32 = &fp32.normalMaps[level][pixel * 4U];
+			const float* normal16 = &fp16.normalMaps[level][pixel * 4U];
+			bool valid32 = (normal32[3] != 0.0f);
+			bool valid16 = (normal16[3] != 0.0f);
+			if (valid32 != valid16) {
+				++comparison.numMismatchedPixels[level];
+			}
+			else if (valid32) {
+				float cosine = normal32[0] * normal16[0] + normal32[1] * normal16[1] + normal32[2] * normal16[2];
+				comparison.maxNormalError[level] = std::max(comparison.maxNormalError[level], std::acos(std::clamp(cosine, -1.0f, 1.0f)));
+			}
+		}
+	}
+	comparison.trackingMismatch = (fp32.view.has_value() != fp16.view.has_value());
+	if (fp32.view.has_value() && fp16.view.has_value()) {
+		// The relative rotation R16 * R32^T has the trace 1 + 2cos(angle).
+		jjyou::glsl::mat3 rotation32(*fp32.view);
+		jjyou::glsl::mat3 rotation16(*fp16.view);
+		float trace = 0.0f;
+		for (int i = 0; i < 3; ++i)
+			trace += jjyou::glsl::dot(jjyou::glsl::vec3(rotation16[i]), jjyou::glsl::vec3(rotation32[i]));
+		comparison.rotationError = std::acos(std::clamp((trace - 1.0f) * 0.5f, -1.0f, 1.0f));
+		jjyou::glsl::vec3 translationError = jjyou::glsl::vec3(jjyou::glsl::inverse(*fp32.view)[3]) - jjyou::glsl::vec3(jjyou::glsl::inverse(*fp16.view)[3]);
+		comparison.translationError = jjyou::glsl::norm(translationError);
+	}
+	return comparison;
+}
+
+std::optional<KinectFusion::KernelTimes> KinectFusion::kernelTimes(void) const {
+	const vk::raii::QueryPool& timestampQueryPool = this->_poseEstimationAlgorithmData.timestampQueryPool;
+	if (!*timestampQueryPool)
+		return std::nullopt;
+	// Each query returns its timestamp and its availability. Queries not written by the last call are unavailable.
+	std::uint32_t numQueries = KinectFusion::_numTimestampQueries();
+	std::vector<std::uint64_t> results = timestampQueryPool.getResults<std::uint64_t>(
+		0U,
+		numQueries,
+		static_cast<std::size_t>(numQueries) * 2U * sizeof(std::uint64_t),
+		2U * sizeof(std::uint64_t),
+		vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability
+	).second;
+	std::uint32_t queueFamilyIndex = *this->_pEngine->context().queueFamilyIndex(this->_trackingQueueType);
+	std::uint32_t timestampValidBits = this->_pEngine->context().physicalDevice().getQueueFamilyProperties()[queueFamilyIndex].timestampValidBits;
+	std::uint64_t timestampMask = (timestampValidBits >= 64U) ? ~0ULL : ((1ULL << timestampValidBits) - 1ULL);
+	double timestampPeriod = static_cast<double>(this->_pEngine->context().physicalDevice().getProperties().limits.timestampPeriod);
+	auto elapsed = [&](std::uint32_t query_) {
+		if (results[2U * query_ + 1U] == 0ULL || results[2U * query_ + 3U] == 0ULL)
+			return std::chrono::duration<double>(0.0);
+		std::uint64_t ticks = (results[2U * query_ + 2U] - results[2U * query_]) & timestampMask;
+		return std::chrono::duration<double>(static_cast<double>(ticks) * timestampPeriod * 1.0e-9);
+	};
+	KernelTimes kernelTimes{};
+	kernelTimes.bilateralFiltering = elapsed(KinectFusion::_bilateralFilteringTimestampQuery());
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		kernelTimes.halfSampling += elapsed(KinectFusion::_halfSamplingTimestampQuery(level));
+		kernelTimes.compactValidPixels += elapsed(KinectFusion::_compactValidPixelsTimestampQuery(level));
+		kernelTimes.computeVertexMap += elapsed(KinectFusion::_computeVertexMapTimestampQuery(level));
+		kernelTimes.computeNormalMap += elapsed(KinectFusion::_computeNormalMapTimestampQuery(level));
+		for (std::uint32_t icpIteration = 0; icpIteration < KinectFusion::NUM_ICP_ITERATIONS[level]; ++icpIteration)
+			kernelTimes.buildLinearFunction += elapsed(KinectFusion::_buildLinearFunctionTimestampQuery(level, icpIteration));
+	}
+	return kernelTimes;
+}
+
+std::optional<jjyou::glsl::mat4> KinectFusion::_estimatePose(
+	const Surface<Simple>& surface_,
+	const Camera& camera_,
+	const jjyou::glsl::mat4& initialView_,
+	float sigmaColor_,
+	float sigmaSpace_,
+	int filterKernelSize_,
+	float distanceThreshold_,
+	float angleThreshold_,
+	const std::vector<jjyou::glsl::mat4>& poseHypotheses_,
+	const std::optional<jjyou::glsl::vec3>& gravity_,
+	float gravityWeight_,
+	bool halfPrecision_
 ) const {
+	// Without predicted model maps, the volume is ray casted, so it must not be fused concurrently.
+	bool usePredictedModel = this->_pipelinedTracking && this->_poseEstimationAlgorithmData.predictedModelView.has_value();
+	if (!usePredictedModel && this->_fusionPending) {
+		throw std::logic_error("[KinectFusion] Cannot ray cast the volume while a fusion is pending. Please call `endFuse` first.");
+	}
 	angleThreshold_ = std::cos(angleThreshold_);
 	vk::Result waitResult{};
 	// Prepare memory barriers for sychronizaton use.
@@ -155,40 +519,83 @@ std::optional<jjyou::glsl::mat4> KinectFusion::estimatePose(
 		.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
 		//.setImage()
 		.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0U, 1U, 0U, 1U));
+	// Select the fp32 or the fp16 variants of the image-space kernels.
+	const vk::raii::Pipeline& bilateralFilteringPipeline = halfPrecision_ ? this->_bilateralFilteringFP16Pipeline : this->_bilateralFilteringPipeline;
+	const vk::raii::Pipeline& halfSamplingPipeline = halfPrecision_ ? this->_halfSamplingFP16Pipeline : this->_halfSamplingPipeline;
+	const vk::raii::Pipeline& computeNormalMapPipeline = halfPrecision_ ? this->_computeNormalMapFP16Pipeline : this->_computeNormalMapPipeline;
+	const vk::raii::Pipeline& buildLinearFunctionPipeline = halfPrecision_ ? this->_buildLinearFunctionFP16Pipeline : this->_buildLinearFunctionPipeline;
+	// Write a timestamp before and after each kernel dispatch, if supported.
+	const vk::raii::QueryPool& timestampQueryPool = this->_poseEstimationAlgorithmData.timestampQueryPool;
+	auto writeTimestamp = [&timestampQueryPool](const vk::raii::CommandBuffer& commandBuffer_, std::uint32_t query_) {
+		if (*timestampQueryPool)
+			commandBuffer_.writeTimestamp(vk::PipelineStageFlagBits::eComputeShader, *timestampQueryPool, query_);
+	};
 	// 1. Build pyramid.
 	const vk::raii::CommandBuffer& buildPyramidCommandBuffer = this->_poseEstimationAlgorithmData.buildPyramidCommandBuffer;
 	const vk::raii::Fence& buildPyramidFence = this->_poseEstimationAlgorithmData.buildPyramidFence;
 	const std::array<PyramidData, KinectFusion::NUM_PYRAMID_LEVELS>& framePyramid = this->_poseEstimationAlgorithmData.framePyramid;
-	// Apply bilateral filtering to the input depth map.
+	const std::array<ValidPixelsDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS>& frameDepthValidPixels = this->_poseEstimationAlgorithmData.frameDepthValidPixels;
+	const std::array<ValidPixelsDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS>& frameValidPixels = this->_poseEstimationAlgorithmData.frameValidPixels;
 	buildPyramidCommandBuffer.begin(
 		vk::CommandBufferBeginInfo()
 		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
 		.setPInheritanceInfo(nullptr)
 	);
-	buildPyramidCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_bilateralFilteringPipeline);
+	this->_recordResetValidPixels(buildPyramidCommandBuffer, frameDepthValidPixels);
+	this->_recordResetValidPixels(buildPyramidCommandBuffer, frameValidPixels);
+	// The vertex and normal maps are only written for the listed pixels, so the other pixels are cleared to invalid here.
+	{
+		std::vector<vk::ImageMemoryBarrier> imageMemoryBarriers;
+		imageMemoryBarriers.reserve(2 * KinectFusion::NUM_PYRAMID_LEVELS);
+		for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level)
+			for (std::uint32_t texture = 1U; texture < PyramidData::numTextures; ++texture) {
+				buildPyramidCommandBuffer.clearColorImage(
+					*framePyramid[level].texture(texture).image(),
+					vk::ImageLayout::eGeneral,
+					vk::ClearColorValue(std::array<float, 4>{ {0.0f, 0.0f, 0.0f, 0.0f} }),
+					vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0U, 1U, 0U, 1U)
+				);
+				imageMemoryBarriers.push_back(vk::ImageMemoryBarrier(readAfterWriteImageMemoryBarrier)
+					.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+					.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite)
+					.setImage(*framePyramid[level].texture(texture).image())
+				);
+			}
+		buildPyramidCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, nullptr, imageMemoryBarriers);
+	}
+	// The vertex and normal map kernels are dispatched with the arguments written by the depth compaction.
+	vk::BufferMemoryBarrier indirectAfterWriteBufferMemoryBarrier = vk::BufferMemoryBarrier(readAfterWriteBufferMemoryBarrier)
+		.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eIndirectCommandRead);
+	if (*timestampQueryPool)
+		buildPyramidCommandBuffer.resetQueryPool(*timestampQueryPool, 0U, KinectFusion::_buildLinearFunctionTimestampQuery(0U, 0U));
+	// Apply bilateral filtering to the input depth map, sampled at the tracking resolution.
+	buildPyramidCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *bilateralFilteringPipeline);
 	surface_.bindStorage(buildPyramidCommandBuffer, vk::PipelineBindPoint::eCompute, this->_bilateralFilteringPipelineLayout, 0);
-	framePyramid[0].bind(buildPyramidCommandBuffer, vk::PipelineBindPoint::eCompute, this->_bilateralFilteringPipelineLayout, 1);
+	framePyramid[this->_trackingLevel].bind(buildPyramidCommandBuffer, vk::PipelineBindPoint::eCompute, this->_bilateralFilteringPipelineLayout, 1);
 	_BilateralFilteringParameters bilateralFilteringParameters{
 		.sigmaColor = sigmaColor_,
 		.sigmaSpace = sigmaSpace_,
 		.d = filterKernelSize_,
 		.minDepth = this->_minDepth,
 		.maxDepth = this->_maxDepth,
-		.invalidDepth = this->_invalidDepth
+		.invalidDepth = this->_invalidDepth,
+		.stride = 1 << this->_trackingLevel
 	};
 	buildPyramidCommandBuffer.pushConstants<_BilateralFilteringParameters>(*this->_bilateralFilteringPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0U, bilateralFilteringParameters);
+	writeTimestamp(buildPyramidCommandBuffer, KinectFusion::_bilateralFilteringTimestampQuery());
 	buildPyramidCommandBuffer.dispatch(
-		(surface_.texture(0).extent().width + KinectFusion::_bilateralFilteringWorkGroupSize.x - 1U) / KinectFusion::_bilateralFilteringWorkGroupSize.x,
-		(surface_.texture(0).extent().height + KinectFusion::_bilateralFilteringWorkGroupSize.y - 1U) / KinectFusion::_bilateralFilteringWorkGroupSize.y,
+		(framePyramid[this->_trackingLevel].texture(0).extent().width + KinectFusion::_bilateralFilteringWorkGroupSize.x - 1U) / KinectFusion::_bilateralFilteringWorkGroupSize.x,
+		(framePyramid[this->_trackingLevel].texture(0).extent().height + KinectFusion::_bilateralFilteringWorkGroupSize.y - 1U) / KinectFusion::_bilateralFilteringWorkGroupSize.y,
 		1U
 	);
+	writeTimestamp(buildPyramidCommandBuffer, KinectFusion::_bilateralFilteringTimestampQuery() + 1U);
 	// Push constant to the pipeline layout of half-sampling.
 	_HalfSamplingParameters halfSamplingParameters{
 		.sigmaColor = sigmaColor_
 	};
 	buildPyramidCommandBuffer.pushConstants<_HalfSamplingParameters>(*this->_halfSamplingPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0U, halfSamplingParameters);
 	// Half-sample depth maps & generate vertex maps and normals.
-	for (std::uint32_t level = 0; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
 		// Barrier for bilateral filtering / half-sampling that writes to current level's depth map.
 		readAfterWriteImageMemoryBarrier.setImage(*framePyramid[level].texture(0).image());
 		buildPyramidCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, nullptr, readAfterWriteImageMemoryBarrier);
@@ -196,15 +603,28 @@ std::optional<jjyou::glsl::mat4> KinectFusion::estimatePose(
 		if (level != KinectFusion::NUM_PYRAMID_LEVELS - 1) {
 			framePyramid[level].bind(buildPyramidCommandBuffer, vk::PipelineBindPoint::eCompute, this->_halfSamplingPipelineLayout, 0);
 			framePyramid[level + 1].bind(buildPyramidCommandBuffer, vk::PipelineBindPoint::eCompute, this->_halfSamplingPipelineLayout, 1);
-			buildPyramidCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_halfSamplingPipeline);
+			buildPyramidCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *halfSamplingPipeline);
+			writeTimestamp(buildPyramidCommandBuffer, KinectFusion::_halfSamplingTimestampQuery(level));
 			buildPyramidCommandBuffer.dispatch(
 				(framePyramid[level + 1].texture(0).extent().width + KinectFusion::_halfSamplingWorkGroupSize.x - 1U) / KinectFusion::_halfSamplingWorkGroupSize.x,
 				(framePyramid[level + 1].texture(0).extent().height + KinectFusion::_halfSamplingWorkGroupSize.y - 1U) / KinectFusion::_halfSamplingWorkGroupSize.y,
 				1U
 			);
+			writeTimestamp(buildPyramidCommandBuffer, KinectFusion::_halfSamplingTimestampQuery(level) + 1U);
 		}
-		// Bind descriptor set to the pipeline layout of computing vertex / normal map.
+		// Compact the pixels with a valid depth, so that the vertex and normal maps are only computed for them.
+		writeTimestamp(buildPyramidCommandBuffer, KinectFusion::_compactValidPixelsTimestampQuery(level));
+		this->_recordCompactValidPixels(buildPyramidCommandBuffer, framePyramid[level], frameDepthValidPixels[level], true);
+		writeTimestamp(buildPyramidCommandBuffer, KinectFusion::_compactValidPixelsTimestampQuery(level) + 1U);
+		std::array<vk::BufferMemoryBarrier, 2> compactionBufferMemoryBarriers = { {
+			vk::BufferMemoryBarrier(indirectAfterWriteBufferMemoryBarrier).setBuffer(*frameDepthValidPixels[level].validPixelsBuffer()),
+			vk::BufferMemoryBarrier(indirectAfterWriteBufferMemoryBarrier).setBuffer(*frameDepthValidPixels[level].validPixelsCounterBuffer())
+		} };
+		buildPyramidCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, compactionBufferMemoryBarriers, nullptr);
+		// Bind descriptor sets to the pipeline layout of computing vertex / normal map.
 		framePyramid[level].bind(buildPyramidCommandBuffer, vk::PipelineBindPoint::eCompute, this->_computeVertexNormalMapPipelineLayout, 0);
+		frameDepthValidPixels[level].bind(buildPyramidCommandBuffer, vk::PipelineBindPoint::eCompute, this->_computeVertexNormalMapPipelineLayout, 1);
+		frameValidPixels[level].bind(buildPyramidCommandBuffer, vk::PipelineBindPoint::eCompute, this->_computeVertexNormalMapPipelineLayout, 2);
 		// Push constant to the pipeline layout of computing vertex / normal map.
 		Camera levelCamera = camera_;
 		levelCamera.resize(framePyramid[level].texture(0).extent());
@@ -218,24 +638,24 @@ std::optional<jjyou::glsl::mat4> KinectFusion::estimatePose(
 		buildPyramidCommandBuffer.pushConstants<_CameraIntrinsics>(*this->_computeVertexNormalMapPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0U, cameraIntrinsics);
 		// Compute vertex map.
 		buildPyramidCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_computeVertexMapPipeline);
-		buildPyramidCommandBuffer.dispatch(
-			(framePyramid[level].texture(0).extent().width + KinectFusion::_computeVertexMapWorkGroupSize.x - 1U) / KinectFusion::_computeVertexMapWorkGroupSize.x,
-			(framePyramid[level].texture(0).extent().height + KinectFusion::_computeVertexMapWorkGroupSize.y - 1U) / KinectFusion::_computeVertexMapWorkGroupSize.y,
-			1U
-		);
+		writeTimestamp(buildPyramidCommandBuffer, KinectFusion::_computeVertexMapTimestampQuery(level));
+		buildPyramidCommandBuffer.dispatchIndirect(*frameDepthValidPixels[level].validPixelsCounterBuffer(), offsetof(ValidPixelsDescriptorSet::ValidPixelsCounter, dispatchIndirectCommand));
+		writeTimestamp(buildPyramidCommandBuffer, KinectFusion::_computeVertexMapTimestampQuery(level) + 1U);
 		// Barrier for computing vertex map.
 		readAfterWriteImageMemoryBarrier.setImage(*framePyramid[level].texture(1).image());
 		buildPyramidCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, nullptr, readAfterWriteImageMemoryBarrier);
-		// Compute normal map.
-		buildPyramidCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_computeNormalMapPipeline);
-		buildPyramidCommandBuffer.dispatch(
-			(framePyramid[level].texture(0).extent().width + KinectFusion::_computeNormalMapWorkGroupSize.x - 1U) / KinectFusion::_computeNormalMapWorkGroupSize.x,
-			(framePyramid[level].texture(0).extent().height + KinectFusion::_computeNormalMapWorkGroupSize.y - 1U) / KinectFusion::_computeNormalMapWorkGroupSize.y,
-			1U
-		);
+		// Compute normal map. It also appends the pixels with a valid vertex and normal to the list read by ICP,
+		// so that ICP only launches work groups for them.
+		buildPyramidCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *computeNormalMapPipeline);
+		writeTimestamp(buildPyramidCommandBuffer, KinectFusion::_computeNormalMapTimestampQuery(level));
+		buildPyramidCommandBuffer.dispatchIndirect(*frameDepthValidPixels[level].validPixelsCounterBuffer(), offsetof(ValidPixelsDescriptorSet::ValidPixelsCounter, dispatchIndirectCommand));
+		writeTimestamp(buildPyramidCommandBuffer, KinectFusion::_computeNormalMapTimestampQuery(level) + 1U);
+		// Barrier for computing normal map.
+		readAfterWriteImageMemoryBarrier.setImage(*framePyramid[level].texture(2).image());
+		buildPyramidCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, nullptr, readAfterWriteImageMemoryBarrier);
 	}
 	buildPyramidCommandBuffer.end();
-	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+	this->_pEngine->context().queue(this->_trackingQueueType)->submit(
 		vk::SubmitInfo()
 		.setWaitSemaphores(nullptr)
 		.setWaitDstStageMask(nullptr)
@@ -243,19 +663,504 @@ std::optional<jjyou::glsl::mat4> KinectFusion::estimatePose(
 		.setSignalSemaphores(nullptr),
 		*buildPyramidFence
 	);
-	// 2. Perform ray casting to generate vertex maps and normals.
-	const std::array<RayCastingDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS>& rayCastingDescriptorSets = this->_poseEstimationAlgorithmData.rayCastingDescriptorSets;
-	const vk::raii::CommandBuffer& rayCastingCommandBuffer = this->_poseEstimationAlgorithmData.rayCastingCommandBuffer;
-	const vk::raii::Fence& rayCastingFence = this->_poseEstimationAlgorithmData.rayCastingFence;
+	// 2. Perform ray casting to generate vertex maps and normals, unless `beginFuse` has predicted them.
+	// If a cached keyframe is close enough, its model maps are copied instead. Otherwise, the ray casted maps are cached.
+	std::optional<std::size_t> cachedModel = usePredictedModel ? std::nullopt : this->_findModelMaps(camera_, initialView_);
+	jjyou::glsl::mat4 modelView = initialView_;
+	if (usePredictedModel)
+		modelView = *this->_poseEstimationAlgorithmData.predictedModelView;
+	else if (cachedModel.has_value())
+		modelView = this->_modelMapCache.entries[*cachedModel].view;
+	if (!usePredictedModel) {
+		const vk::raii::CommandBuffer& rayCastingCommandBuffer = this->_poseEstimationAlgorithmData.rayCastingCommandBuffer;
+		rayCastingCommandBuffer.begin(
+			vk::CommandBufferBeginInfo()
+			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+			.setPInheritanceInfo(nullptr)
+		);
+		if (cachedModel.has_value()) {
+			this->_recordRestoreModelMaps(rayCastingCommandBuffer, *cachedModel);
+		}
+		else {
+			this->_recordModelRayCasting(rayCastingCommandBuffer, camera_, initialView_);
+			if (this->modelMapCacheEnabled())
+				this->_recordCacheModelMaps(rayCastingCommandBuffer, camera_, initialView_);
+		}
+		rayCastingCommandBuffer.end();
+		this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+			vk::SubmitInfo()
+			.setWaitSemaphores(nullptr)
+			.setWaitDstStageMask(nullptr)
+			.setCommandBuffers(*rayCastingCommandBuffer)
+			.setSignalSemaphores(nullptr),
+			*this->_poseEstimationAlgorithmData.rayCastingFence
+		);
+		this->_poseEstimationAlgorithmData.modelRayCastingPending = true;
+	}
 	const std::array<PyramidData, KinectFusion::NUM_PYRAMID_LEVELS>& modelPyramid = this->_poseEstimationAlgorithmData.modelPyramid;
-	rayCastingCommandBuffer.begin(
+	const std::array<ValidPixelsDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS>& modelValidPixels = this->_poseEstimationAlgorithmData.modelValidPixels;
+	waitResult = this->_pEngine->waitForFences(*buildPyramidFence);
+	VK_CHECK(waitResult);
+	this->_pEngine->context().device().resetFences(*buildPyramidFence);
+	buildPyramidCommandBuffer.reset(vk::CommandBufferResetFlags(0));
+	this->_waitModelRayCasting();
+	// 3. Perform ICP, from coarse to fine.
+	// All iterations are recorded into one command buffer. After each iteration, `solveLinearFunction.comp`
+	// updates the poses and writes the dispatch arguments of the next iteration on the GPU.
+	// Once ICP converges in a level or fails, the remaining iterations of the level are no-ops.
+	// If there are multiple hypotheses, they are evaluated in the same dispatches in the coarsest level.
+	// Then the host picks the best one, and only the best one is refined in the finer levels, if any.
+	std::uint32_t numHypotheses = static_cast<std::uint32_t>(poseHypotheses_.size()) + 1U;
+	if (numHypotheses > ICPDescriptorSet::MAX_NUM_HYPOTHESES) {
+		throw std::logic_error("[KinectFusion] At most " + std::to_string(ICPDescriptorSet::MAX_NUM_HYPOTHESES) + " pose hypotheses are supported, but " + std::to_string(numHypotheses) + " are given.");
+	}
+	const ICPDescriptorSet& icpDescriptorSet = this->_poseEstimationAlgorithmData.icpDescriptorSet;
+	const vk::raii::CommandBuffer& icpCommandBuffer = this->_poseEstimationAlgorithmData.icpCommandBuffer;
+	const vk::raii::Fence& icpFence = this->_poseEstimationAlgorithmData.icpFence;
+	ICPDescriptorSet::ICPState& icpState = icpDescriptorSet.icpState();
+	icpDescriptorSet.icpParameters().modelView = modelView;
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		Camera levelCamera = camera_;
+		levelCamera.resize(framePyramid[level].texture(0).extent());
+		jjyou::glsl::mat3 projection = levelCamera.getVisionProjection();
+		icpDescriptorSet.icpParameters().intrinsics[level] = jjyou::glsl::vec4(projection[0][0], projection[1][1], projection[2][0], projection[2][1]);
+	}
+	icpDescriptorSet.icpParameters().distanceThreshold = distanceThreshold_;
+	icpDescriptorSet.icpParameters().angleThreshold = angleThreshold_;
+	icpDescriptorSet.icpParameters().minDeterminant = KinectFusion::ICP_MIN_DETERMINANT;
+	icpDescriptorSet.icpParameters().maxIncrement = KinectFusion::ICP_MAX_INCREMENT;
+	icpDescriptorSet.icpParameters().convergenceThreshold = KinectFusion::ICP_CONVERGENCE_THRESHOLD;
+	bool useGravity = gravity_.has_value() && this->_worldGravity.has_value();
+	icpDescriptorSet.icpParameters().frameGravity = jjyou::glsl::vec4(useGravity ? *gravity_ : jjyou::glsl::vec3(0.0f), useGravity ? 1.0f : 0.0f);
+	icpDescriptorSet.icpParameters().worldGravity = jjyou::glsl::vec4(this->_worldGravity.value_or(jjyou::glsl::vec3(0.0f)), 0.0f);
+	icpDescriptorSet.icpParameters().gravityWeight = gravityWeight_;
+	icpState.numHypotheses = numHypotheses;
+	for (std::uint32_t hypothesis = 0; hypothesis < numHypotheses; ++hypothesis) {
+		jjyou::glsl::mat4 view = (hypothesis == 0U) ? initialView_ : poseHypotheses_[hypothesis - 1U];
+		icpState.hypotheses[hypothesis] = ICPDescriptorSet::ICPHypothesis{
+			.frameInvView = jjyou::glsl::inverse(view),
+			.converged = 0U,
+			.failed = 0U,
+			.numIterations = 0U,
+			.numInliers = 0U,
+			.residual = 0.0f,
+			.padding = { 0U, 0U, 0U }
+		};
+	}
+	// The x dimension of the first `buildLinearFunction.comp` dispatch is copied from the valid pixel counter on the GPU.
+	icpState.buildLinearFunctionDispatchIndirectCommand = vk::DispatchIndirectCommand(0U, numHypotheses, 1U);
+	icpState.reductionDispatchIndirectCommand = vk::DispatchIndirectCommand(ICPDescriptorSet::NUM_SUM_TERMS, numHypotheses, 1U);
+	vk::BufferMemoryBarrier icpStateBufferMemoryBarrier = vk::BufferMemoryBarrier()
+		.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+		.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eIndirectCommandRead)
+		.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		.setBuffer(*icpDescriptorSet.icpStateBuffer())
+		.setOffset(0ULL)
+		.setSize(VK_WHOLE_SIZE);
+	// Record the ICP iterations of the levels [beginLevel_, endLevel_), from coarse to fine.
+	auto recordICPLevels = [&](std::uint32_t beginLevel_, std::uint32_t endLevel_) {
+		for (std::uint32_t level = beginLevel_; level-- > endLevel_; ) {
+			_ICPLevel icpLevel{
+				.level = level
+			};
+			for (std::uint32_t icpIteration = 0; icpIteration < KinectFusion::NUM_ICP_ITERATIONS[level]; ++icpIteration) {
+				// Build linear function
+				framePyramid[level].bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_buildLinearFunctionPipelineLayout, 0);
+				modelPyramid[level].bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_buildLinearFunctionPipelineLayout, 1);
+				icpDescriptorSet.bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_buildLinearFunctionPipelineLayout, 2);
+				frameValidPixels[level].bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_buildLinearFunctionPipelineLayout, 3);
+				modelValidPixels[level].bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_buildLinearFunctionPipelineLayout, 4);
+				icpCommandBuffer.pushConstants<_ICPLevel>(*this->_buildLinearFunctionPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0U, icpLevel);
+				icpCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *buildLinearFunctionPipeline);
+				// Only launch work groups for valid pixels. The number of work groups is zero once all hypotheses have converged or failed.
+				writeTimestamp(icpCommandBuffer, KinectFusion::_buildLinearFunctionTimestampQuery(level, icpIteration));
+				icpCommandBuffer.dispatchIndirect(*icpDescriptorSet.icpStateBuffer(), offsetof(ICPDescriptorSet::ICPState, buildLinearFunctionDispatchIndirectCommand));
+				writeTimestamp(icpCommandBuffer, KinectFusion::_buildLinearFunctionTimestampQuery(level, icpIteration) + 1U);
+				// Insert a buffer memory barrier.
+				readAfterWriteBufferMemoryBarrier.setBuffer(*icpDescriptorSet.globalSumBufferBuffer());
+				icpCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, readAfterWriteBufferMemoryBarrier, nullptr);
+				// Sum reduction. The length of the global sum buffer is read from the ICP state.
+				icpDescriptorSet.bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_buildLinearFunctionReductionPipelineLayout, 0);
+				icpCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_buildLinearFunctionReductionPipeline);
+				icpCommandBuffer.dispatchIndirect(*icpDescriptorSet.icpStateBuffer(), offsetof(ICPDescriptorSet::ICPState, reductionDispatchIndirectCommand));
+				// Insert a buffer memory barrier.
+				readAfterWriteBufferMemoryBarrier.setBuffer(*icpDescriptorSet.reductionResultBuffer());
+				icpCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, readAfterWriteBufferMemoryBarrier, nullptr);
+				// Solve the functions, update the poses, and size the next iteration.
+				bool lastIterationOfLevel = (icpIteration == KinectFusion::NUM_ICP_ITERATIONS[level] - 1U);
+				std::uint32_t nextLevel = (lastIterationOfLevel && level != this->_trackingLevel) ? level - 1U : level;
+				_SolveParameters solveParameters{
+					.beginNextLevel = lastIterationOfLevel ? 1U : 0U
+				};
+				icpDescriptorSet.bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_solveLinearFunctionPipelineLayout, 0);
+				frameValidPixels[nextLevel].bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_solveLinearFunctionPipelineLayout, 1);
+				icpCommandBuffer.pushConstants<_SolveParameters>(*this->_solveLinearFunctionPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0U, solveParameters);
+				icpCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_solveLinearFunctionPipeline);
+				icpCommandBuffer.dispatch(1U, 1U, 1U);
+				// Insert a buffer memory barrier for the poses and the dispatch arguments.
+				icpCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, icpStateBufferMemoryBarrier, nullptr);
+			}
+		}
+	};
+	auto submitICP = [&](void) {
+		icpCommandBuffer.end();
+		this->_pEngine->context().queue(this->_trackingQueueType)->submit(
+			vk::SubmitInfo()
+			.setWaitSemaphores(nullptr)
+			.setWaitDstStageMask(nullptr)
+			.setCommandBuffers(*icpCommandBuffer)
+			.setSignalSemaphores(nullptr),
+			*icpFence
+		);
+		waitResult = this->_pEngine->waitForFences(*icpFence);
+		VK_CHECK(waitResult);
+		this->_pEngine->context().device().resetFences(*icpFence);
+		icpCommandBuffer.reset(vk::CommandBufferResetFlags(0));
+	};
+	icpCommandBuffer.begin(
 		vk::CommandBufferBeginInfo()
 		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
 		.setPInheritanceInfo(nullptr)
 	);
-	rayCastingCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_rayCastingICPPipeline);
-	this->_tsdfVolume.bind(rayCastingCommandBuffer, vk::PipelineBindPoint::eCompute, this->_rayCastingICPPipelineLayout, 0);
-	for (std::uint32_t level = 0; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+	if (*timestampQueryPool)
+		icpCommandBuffer.resetQueryPool(*timestampQueryPool, KinectFusion::_buildLinearFunctionTimestampQuery(0U, 0U), KinectFusion::_numTimestampQueries() - KinectFusion::_buildLinearFunctionTimestampQuery(0U, 0U));
+	// The lists of valid pixels and their counters were written in earlier submissions. They are read by the
+	// ICP shaders, and read as dispatch arguments.
+	icpCommandBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eComputeShader,
+		vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eComputeShader,
+		vk::DependencyFlags(0),
+		vk::MemoryBarrier()
+		.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+		.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eIndirectCommandRead),
+		nullptr,
+		nullptr
+	);
+	// The coarsest level's valid pixel counter sizes the first iteration. It is written by the normal map kernel.
+	icpCommandBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eComputeShader,
+		vk::PipelineStageFlagBits::eTransfer,
+		vk::DependencyFlags(0),
+		nullptr,
+		vk::BufferMemoryBarrier(readAfterWriteBufferMemoryBarrier)
+		.setDstAccessMask(vk::AccessFlagBits::eTransferRead)
+		.setBuffer(*frameValidPixels[KinectFusion::NUM_PYRAMID_LEVELS - 1U].validPixelsCounterBuffer()),
+		nullptr
+	);
+	icpCommandBuffer.copyBuffer(
+		*frameValidPixels[KinectFusion::NUM_PYRAMID_LEVELS - 1U].validPixelsCounterBuffer(),
+		*icpDescriptorSet.icpStateBuffer(),
+		vk::BufferCopy()
+		.setSrcOffset(offsetof(ValidPixelsDescriptorSet::ValidPixelsCounter, dispatchIndirectCommand))
+		.setDstOffset(offsetof(ICPDescriptorSet::ICPState, buildLinearFunctionDispatchIndirectCommand))
+		.setSize(sizeof(std::uint32_t))
+	);
+	icpCommandBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eTransfer,
+		vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eComputeShader,
+		vk::DependencyFlags(0),
+		nullptr,
+		vk::BufferMemoryBarrier(icpStateBufferMemoryBarrier).setSrcAccessMask(vk::AccessFlagBits::eTransferWrite),
+		nullptr
+	);
+	if (numHypotheses > 1U) {
+		recordICPLevels(KinectFusion::NUM_PYRAMID_LEVELS, KinectFusion::NUM_PYRAMID_LEVELS - 1U);
+		submitICP();
+		// Pick the hypothesis with the most inliers. Break ties with the sum of squared residuals.
+		std::optional<std::uint32_t> bestHypothesis;
+		for (std::uint32_t hypothesis = 0; hypothesis < numHypotheses; ++hypothesis) {
+			const ICPDescriptorSet::ICPHypothesis& candidate = icpState.hypotheses[hypothesis];
+			if (candidate.failed != 0U)
+				continue;
+			if (!bestHypothesis.has_value()) {
+				bestHypothesis = hypothesis;
+				continue;
+			}
+			const ICPDescriptorSet::ICPHypothesis& best = icpState.hypotheses[*bestHypothesis];
+			if (candidate.numInliers > best.numInliers ||
+				(candidate.numInliers == best.numInliers && candidate.residual < best.residual))
+				bestHypothesis = hypothesis;
+		}
+		if (!bestHypothesis.has_value())
+			return std::nullopt;
+		// Only refine the best hypothesis in the finer levels.
+		// The dispatch arguments of the next level have been written by the last iteration.
+		icpState.hypotheses[0] = icpState.hypotheses[*bestHypothesis];
+		icpState.numHypotheses = 1U;
+		icpState.buildLinearFunctionDispatchIndirectCommand.y = 1U;
+		icpState.reductionDispatchIndirectCommand.y = 1U;
+		if (KinectFusion::NUM_PYRAMID_LEVELS - 1U > this->_trackingLevel) {
+			icpCommandBuffer.begin(
+				vk::CommandBufferBeginInfo()
+				.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+				.setPInheritanceInfo(nullptr)
+			);
+			recordICPLevels(KinectFusion::NUM_PYRAMID_LEVELS - 1U, this->_trackingLevel);
+			submitICP();
+		}
+	}
+	else {
+		recordICPLevels(KinectFusion::NUM_PYRAMID_LEVELS, this->_trackingLevel);
+		submitICP();
+	}
+	// Download the result.
+	if (icpState.hypotheses[0].failed != 0U)
+		return std::nullopt;
+	return jjyou::glsl::inverse(icpState.hypotheses[0].frameInvView);
+}
+
+std::array<float, KinectFusion::NUM_PYRAMID_LEVELS> KinectFusion::validPixelRatios(void) const {
+	std::array<float, KinectFusion::NUM_PYRAMID_LEVELS> res{};
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		const ValidPixelsDescriptorSet& validPixels = this->_poseEstimationAlgorithmData.frameValidPixels[level];
+		res[level] = static_cast<float>(validPixels.validPixelsCounter().numValidPixels) / static_cast<float>(validPixels.extent().width * validPixels.extent().height);
+	}
+	return res;
+}
+
+void KinectFusion::fuse(
+	const Surface<Simple>& surface_,
+	const Camera& camera_,
+	const jjyou::glsl::mat4& view_,
+	const std::optional<jjyou::glsl::vec3>& gravity_
+) {
+	this->beginFuse(surface_, camera_, view_, gravity_, false);
+	this->endFuse();
+}
+
+void KinectFusion::beginFuse(
+	const Surface<Simple>& surface_,
+	const Camera& camera_,
+	const jjyou::glsl::mat4& view_,
+	const std::optional<jjyou::glsl::vec3>& gravity_,
+	bool predictModel_
+) {
+	if (this->_fusionPending) {
+		throw std::logic_error("[KinectFusion] The last fusion has not ended. Please call `endFuse` first.");
+	}
+	if (predictModel_ && !this->_pipelinedTracking) {
+		throw std::logic_error("[KinectFusion] Predicting the model maps requires pipelined tracking.");
+	}
+	if (!this->_worldGravity.has_value() && gravity_.has_value())
+		this->_worldGravity = jjyou::glsl::normalized(jjyou::glsl::transpose(jjyou::glsl::mat3(view_)) * *gravity_);
+	// The cached model maps show the volume without this frame.
+	if (!this->_modelMapCache.entries.empty())
+		this->_clearModelMapCache();
+	// Ray cast the model maps of the next frame from the volume without this frame.
+	if (predictModel_) {
+		this->_waitModelRayCasting();
+		const vk::raii::CommandBuffer& rayCastingCommandBuffer = this->_poseEstimationAlgorithmData.rayCastingCommandBuffer;
+		rayCastingCommandBuffer.begin(
+			vk::CommandBufferBeginInfo()
+			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+			.setPInheritanceInfo(nullptr)
+		);
+		this->_recordModelRayCasting(rayCastingCommandBuffer, camera_, view_);
+		rayCastingCommandBuffer.end();
+		this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+			vk::SubmitInfo()
+			.setWaitSemaphores(nullptr)
+			.setWaitDstStageMask(nullptr)
+			.setCommandBuffers(*rayCastingCommandBuffer)
+			.setSignalSemaphores(nullptr),
+			*this->_poseEstimationAlgorithmData.rayCastingFence
+		);
+		this->_poseEstimationAlgorithmData.modelRayCastingPending = true;
+		this->_poseEstimationAlgorithmData.predictedModelView = view_;
+	}
+	const FusionDescriptorSet& fusionDescriptorSet = this->_fusionAlgorithmData.descriptorSet;
+	const vk::raii::CommandBuffer& commandBuffer = this->_fusionAlgorithmData.commandBuffer;
+	const vk::raii::Fence& fence = this->_fusionAlgorithmData.fence;
+	commandBuffer.begin(
+		vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	// The model ray casting submitted just before, and the ray casting and downloads recorded by other
+	// users of the volume (e.g. `MapPublisher`) that may still run, read the voxels that fusion overwrites.
+	// They precede this barrier in submission order, so fusion starts after they end.
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, nullptr, nullptr);
+	commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_fusionPipeline);
+	this->_tsdfVolume.bind(commandBuffer, vk::PipelineBindPoint::eCompute, this->_fusionPipelineLayout, 0);
+	jjyou::glsl::mat3 projection = camera_.getVisionProjection();
+	fusionDescriptorSet.fusionParameters().fx = projection[0][0];
+	fusionDescriptorSet.fusionParameters().fy = projection[1][1];
+	fusionDescriptorSet.fusionParameters().cx = projection[2][0];
+	fusionDescriptorSet.fusionParameters().cy = projection[2][1];
+	fusionDescriptorSet.fusionParameters().view = view_;
+	fusionDescriptorSet.fusionParameters().viewPos = jjyou::glsl::vec4(-jjyou::glsl::transpose(jjyou::glsl::mat3(view_)) * jjyou::glsl::vec3(view_[3]), 1.0f);
+	fusionDescriptorSet.fusionParameters().truncationWeight = static_cast<int>(this->_truncationWeight);
+	fusionDescriptorSet.fusionParameters().minDepth = this->_minDepth;
+	fusionDescriptorSet.fusionParameters().maxDepth = this->_maxDepth;
+	fusionDescriptorSet.fusionParameters().invalidDepth = this->_invalidDepth;
+	fusionDescriptorSet.bind(commandBuffer, vk::PipelineBindPoint::eCompute, this->_fusionPipelineLayout, 1);
+	surface_.bindStorage(commandBuffer, vk::PipelineBindPoint::eCompute, this->_fusionPipelineLayout, 2);
+	commandBuffer.dispatch(
+		(this->_tsdfVolume.resolution().x + this->_pipelineTraits.fusionWorkGroupSize.x - 1U) / this->_pipelineTraits.fusionWorkGroupSize.x,
+		(this->_tsdfVolume.resolution().y + this->_pipelineTraits.fusionWorkGroupSize.y - 1U) / this->_pipelineTraits.fusionWorkGroupSize.y,
+		1U
+	);
+	this->_tsdfVolume.recordColorBrickReadback(commandBuffer);
+	commandBuffer.end();
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(*commandBuffer)
+		.setSignalSemaphores(nullptr),
+		*fence
+	);
+	this->_fusionPending = true;
+}
+
+void KinectFusion::endFuse(void) {
+	if (!this->_fusionPending)
+		return;
+	const vk::raii::CommandBuffer& commandBuffer = this->_fusionAlgorithmData.commandBuffer;
+	const vk::raii::Fence& fence = this->_fusionAlgorithmData.fence;
+	std::chrono::steady_clock::time_point waitBegin = std::chrono::steady_clock::now();
+	vk::Result waitResult = this->_pEngine->waitForFences(*fence);
+	VK_CHECK(waitResult);
+	std::chrono::duration<double> waitTime = std::chrono::steady_clock::now() - waitBegin;
+	this->_pEngine->context().device().resetFences(*fence);
+	commandBuffer.reset(vk::CommandBufferResetFlags(0));
+	this->_fusionPending = false;
+	// Bind memory for the pages that fusion skipped. They will be updated from the next frame on.
+	this->_tsdfVolume.commitRequestedPages();
+	if (this->meshCacheEnabled())
+		this->_updateMeshCache(this->_tsdfVolume.takeModifiedBricks());
+	if (this->_metrics.pFusionWaitTime != nullptr) {
+		this->_metrics.pFusionWaitTime->record(waitTime);
+		this->_metrics.pResidentPages->set(static_cast<double>(this->_tsdfVolume.numResidentPages()));
+		this->_metrics.pOccupancy->set(static_cast<double>(this->_tsdfVolume.numResidentPages()) / static_cast<double>(std::max(this->_tsdfVolume.numPages(), 1U)));
+		this->_metrics.pAllocatedColorBricks->set(static_cast<double>(this->_tsdfVolume.numAllocatedColorBricks()));
+	}
+}
+
+void KinectFusion::setMetrics(MetricsRegistry* pMetrics_) {
+	if (pMetrics_ == nullptr) {
+		this->_metrics = _Metrics{};
+		return;
+	}
+	this->_metrics.pICPFailures = &pMetrics_->counter("kinectfusion_icp_failures_total", "Number of frames whose pose estimation failed.");
+	this->_metrics.pICPIterations = &pMetrics_->histogram("kinectfusion_icp_iterations", "Number of ICP iterations of the frames whose pose was estimated.", 1.0);
+	this->_metrics.pFusionWaitTime = &pMetrics_->histogram("kinectfusion_fusion_wait_seconds", "Time spent waiting for the GPU to fuse a frame.", 1.0e-6);
+	this->_metrics.pResidentPages = &pMetrics_->gauge("kinectfusion_volume_resident_pages", "Number of pages of the TSDF volume backed by device memory.");
+	this->_metrics.pOccupancy = &pMetrics_->gauge("kinectfusion_volume_occupancy_ratio", "Ratio of the pages of the TSDF volume backed by device memory.");
+	this->_metrics.pAllocatedColorBricks = &pMetrics_->gauge("kinectfusion_volume_color_bricks", "Number of allocated color bricks.");
+}
+
+void KinectFusion::saveTSDFVolume(const std::filesystem::path& path_) {
+	this->endFuse();
+	this->_tsdfVolume.save(path_);
+}
+
+void KinectFusion::loadTSDFVolume(const std::filesystem::path& path_) {
+	this->initTSDFVolume();
+	this->_tsdfVolume.load(path_);
+	// All bricks are modified. Re-mesh them in batches no larger than the mesh cache, so that
+	// the slabs of the bricks without surface are released before the next batch.
+	if (this->meshCacheEnabled()) {
+		std::vector<std::uint32_t> modifiedBricks = this->_tsdfVolume.takeModifiedBricks();
+		std::size_t batchSize = static_cast<std::size_t>(this->_meshCache.numSlabs());
+		for (std::size_t begin = 0; begin < modifiedBricks.size(); begin += batchSize) {
+			std::size_t end = std::min(begin + batchSize, modifiedBricks.size());
+			this->_updateMeshCache(std::vector<std::uint32_t>(modifiedBricks.begin() + begin, modifiedBricks.begin() + end));
+		}
+	}
+}
+
+void KinectFusion::_updateMeshCache(const std::vector<std::uint32_t>& modifiedBricks_) {
+	std::chrono::steady_clock::time_point beginTime = std::chrono::steady_clock::now();
+	std::uint32_t numWorkItems = this->_meshCache.prepareUpdate(modifiedBricks_);
+	if (numWorkItems != 0U) {
+		const vk::raii::CommandBuffer& commandBuffer = this->_meshBricksAlgorithmData.commandBuffer;
+		const vk::raii::Fence& fence = this->_meshBricksAlgorithmData.fence;
+		commandBuffer.begin(
+			vk::CommandBufferBeginInfo()
+			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+			.setPInheritanceInfo(nullptr)
+		);
+		// Downloads of the mesh submitted before (e.g. by `MapPublisher`) may still read the slabs.
+		commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, nullptr, nullptr);
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_meshBricksPipeline);
+		this->_tsdfVolume.bind(commandBuffer, vk::PipelineBindPoint::eCompute, this->_meshBricksPipelineLayout, 0);
+		this->_meshCache.bind(commandBuffer, vk::PipelineBindPoint::eCompute, this->_meshBricksPipelineLayout, 1);
+		// One work group per modified brick.
+		commandBuffer.dispatch(numWorkItems, 1U, 1U);
+		commandBuffer.end();
+		// Frames submitted to the main queue may still draw the slabs being patched.
+		const vk::raii::Semaphore& graphicsFinishedSemaphore = this->_meshBricksAlgorithmData.graphicsFinishedSemaphore;
+		this->_pEngine->signalAfterSubmittedFrames(*graphicsFinishedSemaphore);
+		vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eComputeShader;
+		this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+			vk::SubmitInfo()
+			.setWaitSemaphores(*graphicsFinishedSemaphore)
+			.setWaitDstStageMask(waitStage)
+			.setCommandBuffers(*commandBuffer)
+			.setSignalSemaphores(nullptr),
+			*fence
+		);
+		vk::Result waitResult = this->_pEngine->waitForFences(*fence);
+		VK_CHECK(waitResult);
+		this->_pEngine->context().device().resetFences(*fence);
+		commandBuffer.reset(vk::CommandBufferResetFlags(0));
+	}
+	this->_meshCache.finishUpdate(std::chrono::steady_clock::now() - beginTime);
+}
+
+void KinectFusion::_recordResetValidPixels(const vk::raii::CommandBuffer& commandBuffer_, const std::array<ValidPixelsDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS>& validPixels_) const {
+	vk::BufferMemoryBarrier computeAfterFillBufferMemoryBarrier = vk::BufferMemoryBarrier()
+		.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+		.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite)
+		.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		//.setBuffer()
+		.setOffset(0ULL)
+		.setSize(VK_WHOLE_SIZE);
+	std::vector<vk::BufferMemoryBarrier> bufferMemoryBarriers;
+	bufferMemoryBarriers.reserve(2 * KinectFusion::NUM_PYRAMID_LEVELS);
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		validPixels_[level].reset(commandBuffer_);
+		bufferMemoryBarriers.push_back(computeAfterFillBufferMemoryBarrier.setBuffer(*validPixels_[level].validityMaskBuffer()));
+		bufferMemoryBarriers.push_back(computeAfterFillBufferMemoryBarrier.setBuffer(*validPixels_[level].validPixelsCounterBuffer()));
+	}
+	commandBuffer_.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, bufferMemoryBarriers, nullptr);
+}
+
+void KinectFusion::_recordCompactValidPixels(const vk::raii::CommandBuffer& commandBuffer_, const PyramidData& pyramidData_, const ValidPixelsDescriptorSet& validPixels_, bool depth_) const {
+	commandBuffer_.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_compactValidPixelsPipeline);
+	pyramidData_.bind(commandBuffer_, vk::PipelineBindPoint::eCompute, this->_compactValidPixelsPipelineLayout, 0);
+	validPixels_.bind(commandBuffer_, vk::PipelineBindPoint::eCompute, this->_compactValidPixelsPipelineLayout, 1);
+	_CompactValidPixelsParameters compactValidPixelsParameters{
+		.depth = depth_ ? 1U : 0U
+	};
+	commandBuffer_.pushConstants<_CompactValidPixelsParameters>(*this->_compactValidPixelsPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0U, compactValidPixelsParameters);
+	commandBuffer_.dispatch(
+		(pyramidData_.texture(0).extent().width + KinectFusion::_compactValidPixelsWorkGroupSize.x - 1U) / KinectFusion::_compactValidPixelsWorkGroupSize.x,
+		(pyramidData_.texture(0).extent().height + KinectFusion::_compactValidPixelsWorkGroupSize.y - 1U) / KinectFusion::_compactValidPixelsWorkGroupSize.y,
+		1U
+	);
+}
+
+void KinectFusion::_recordModelRayCasting(const vk::raii::CommandBuffer& commandBuffer_, const Camera& camera_, const jjyou::glsl::mat4& view_) const {
+	vk::ImageMemoryBarrier readAfterWriteImageMemoryBarrier = vk::ImageMemoryBarrier()
+		.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+		.setDstAccessMask(vk::AccessFlagBits::eShaderWrite)
+		.setOldLayout(vk::ImageLayout::eGeneral)
+		.setNewLayout(vk::ImageLayout::eGeneral)
+		.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		//.setImage()
+		.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0U, 1U, 0U, 1U));
+	const std::array<RayCastingDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS>& rayCastingDescriptorSets = this->_poseEstimationAlgorithmData.rayCastingDescriptorSets;
+	const std::array<PyramidData, KinectFusion::NUM_PYRAMID_LEVELS>& modelPyramid = this->_poseEstimationAlgorithmData.modelPyramid;
+	const std::array<ValidPixelsDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS>& modelValidPixels = this->_poseEstimationAlgorithmData.modelValidPixels;
+	this->_recordResetValidPixels(commandBuffer_, modelValidPixels);
+	commandBuffer_.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_rayCastingICPPipeline);
+	this->_tsdfVolume.bind(commandBuffer_, vk::PipelineBindPoint::eCompute, this->_rayCastingICPPipelineLayout, 0);
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
 		Camera levelCamera = camera_;
 		levelCamera.resize(modelPyramid[level].texture(0).extent());
 		jjyou::glsl::mat3 projection = levelCamera.getVisionProjection();
@@ -263,166 +1168,309 @@ std::optional<jjyou::glsl::mat4> KinectFusion::estimatePose(
 		rayCastingDescriptorSets[level].rayCastingParameters().fy = projection[1][1];
 		rayCastingDescriptorSets[level].rayCastingParameters().cx = projection[2][0];
 		rayCastingDescriptorSets[level].rayCastingParameters().cy = projection[2][1];
-		rayCastingDescriptorSets[level].rayCastingParameters().invView = jjyou::glsl::inverse(initialView_);
+		rayCastingDescriptorSets[level].rayCastingParameters().invView = jjyou::glsl::inverse(view_);
 		rayCastingDescriptorSets[level].rayCastingParameters().minDepth = this->_minDepth;
 		rayCastingDescriptorSets[level].rayCastingParameters().maxDepth = this->_maxDepth;
 		rayCastingDescriptorSets[level].rayCastingParameters().invalidDepth = this->_invalidDepth;
 		rayCastingDescriptorSets[level].rayCastingParameters().marchingStep = 0.5f * this->_tsdfVolume.size();
-		rayCastingDescriptorSets[level].bind(rayCastingCommandBuffer, vk::PipelineBindPoint::eCompute, this->_rayCastingICPPipelineLayout, 1);
-		modelPyramid[level].bind(rayCastingCommandBuffer, vk::PipelineBindPoint::eCompute, this->_rayCastingICPPipelineLayout, 2);
-		rayCastingCommandBuffer.dispatch(
+		rayCastingDescriptorSets[level].bind(commandBuffer_, vk::PipelineBindPoint::eCompute, this->_rayCastingICPPipelineLayout, 1);
+		modelPyramid[level].bind(commandBuffer_, vk::PipelineBindPoint::eCompute, this->_rayCastingICPPipelineLayout, 2);
+		commandBuffer_.dispatch(
 			(modelPyramid[level].texture(0).extent().width + KinectFusion::_rayCastingICPWorkGroupSize.x - 1U) / KinectFusion::_rayCastingICPWorkGroupSize.x,
 			(modelPyramid[level].texture(0).extent().height + KinectFusion::_rayCastingICPWorkGroupSize.y - 1U) / KinectFusion::_rayCastingICPWorkGroupSize.y,
 			1U
 		);
 	}
-	rayCastingCommandBuffer.end();
-	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
-		vk::SubmitInfo()
-		.setWaitSemaphores(nullptr)
-		.setWaitDstStageMask(nullptr)
-		.setCommandBuffers(*rayCastingCommandBuffer)
-		.setSignalSemaphores(nullptr),
-		*rayCastingFence
-	);
-	waitResult = this->_pEngine->context().device().waitForFences({ *buildPyramidFence, *rayCastingFence }, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
-	VK_CHECK(waitResult);
-	this->_pEngine->context().device().resetFences(*buildPyramidFence);
-	this->_pEngine->context().device().resetFences(*rayCastingFence);
-	buildPyramidCommandBuffer.reset(vk::CommandBufferResetFlags(0));
-	rayCastingCommandBuffer.reset(vk::CommandBufferResetFlags(0));
-	// 3. Perform ICP, from coarse to fine.
-	const ICPDescriptorSet& icpDescriptorSet = this->_poseEstimationAlgorithmData.icpDescriptorSet;
-	const vk::raii::CommandBuffer& icpCommandBuffer = this->_poseEstimationAlgorithmData.icpCommandBuffer;
-	const vk::raii::Fence& icpFence = this->_poseEstimationAlgorithmData.icpFence;
-	jjyou::glsl::dmat4 estimatedInvView = jjyou::glsl::inverse(initialView_).cast<double>();
-	Eigen::Map<Eigen::Matrix4d> estimatedInvViewEigen(estimatedInvView.data.data());
-	// Starting with the coarsest level.
-	for (std::uint32_t reverseLevel = 0; reverseLevel < KinectFusion::NUM_PYRAMID_LEVELS; ++reverseLevel) {
-		std::uint32_t level = KinectFusion::NUM_PYRAMID_LEVELS - 1U - reverseLevel;
-		Camera levelCamera = camera_;
-		levelCamera.resize(framePyramid[level].texture(0).extent());
-		jjyou::glsl::mat3 projection = levelCamera.getVisionProjection();
-		icpDescriptorSet.icpParameters().modelView = initialView_;
-		icpDescriptorSet.icpParameters().fx = projection[0][0];
-		icpDescriptorSet.icpParameters().fy = projection[1][1];
-		icpDescriptorSet.icpParameters().cx = projection[2][0];
-		icpDescriptorSet.icpParameters().cy = projection[2][1];
-		icpDescriptorSet.icpParameters().distanceThreshold = distanceThreshold_;
-		icpDescriptorSet.icpParameters().angleThreshold = angleThreshold_;
-		// Iteratively build and solve linear functions.
-		for (std::uint32_t icpIteration = 0; icpIteration < KinectFusion::NUM_ICP_ITERATIONS[level]; ++icpIteration) {
-			// Build linear function
-			icpCommandBuffer.begin(
-				vk::CommandBufferBeginInfo()
-				.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
-				.setPInheritanceInfo(nullptr)
+	// Build the validity bitmasks of the model pyramid. ICP tests them before loading model vertices and normals.
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		readAfterWriteImageMemoryBarrier.setImage(*modelPyramid[level].texture(1).image());
+		commandBuffer_.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, nullptr, readAfterWriteImageMemoryBarrier);
+		readAfterWriteImageMemoryBarrier.setImage(*modelPyramid[level].texture(2).image());
+		commandBuffer_.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, nullptr, readAfterWriteImageMemoryBarrier);
+		this->_recordCompactValidPixels(commandBuffer_, modelPyramid[level], modelValidPixels[level], false);
+	}
+}
+
+void KinectFusion::_clearModelMapCache(void) {
+	// The keyframes may still be read by the pending ray casting.
+	this->_waitModelRayCasting();
+	this->_modelMapCache.entries.clear();
+	this->_modelMapCache.numUses = 0ULL;
+	this->_modelMapCache.statistics.numKeyframes = 0U;
+}
+
+std::optional<std::size_t> KinectFusion::_findModelMaps(const Camera& camera_, const jjyou::glsl::mat4& view_) const {
+	if (!this->modelMapCacheEnabled())
+		return std::nullopt;
+	jjyou::glsl::mat3 rotation(view_);
+	jjyou::glsl::vec3 center = -jjyou::glsl::transpose(rotation) * jjyou::glsl::vec3(view_[3]);
+	std::optional<std::size_t> found = std::nullopt;
+	float minDistance = std::numeric_limits<float>::max();
+	for (std::size_t i = 0; i < this->_modelMapCache.entries.size(); ++i) {
+		const _ModelMapCacheEntry& entry = this->_modelMapCache.entries[i];
+		// The model maps are only valid for the same intrinsics.
+		if (entry.camera.xFov != camera_.xFov || entry.camera.yFov != camera_.yFov ||
+			entry.camera.xOffset != camera_.xOffset || entry.camera.yOffset != camera_.yOffset ||
+			entry.camera.width != camera_.width || entry.camera.height != camera_.height)
+			continue;
+		jjyou::glsl::mat3 entryRotation(entry.view);
+		jjyou::glsl::vec3 entryCenter = -jjyou::glsl::transpose(entryRotation) * jjyou::glsl::vec3(entry.view[3]);
+		float distance = jjyou::glsl::norm(center - entryCenter);
+		jjyou::glsl::mat3 relativeRotation = rotation * jjyou::glsl::transpose(entryRotation);
+		float cosAngle = std::clamp((relativeRotation[0][0] + relativeRotation[1][1] + relativeRotation[2][2] - 1.0f) / 2.0f, -1.0f, 1.0f);
+		if (distance > this->_modelMapCache.maxDistance || std::acos(cosAngle) > this->_modelMapCache.maxAngle || distance >= minDistance)
+			continue;
+		found = i;
+		minDistance = distance;
+	}
+	return found;
+}
+
+void KinectFusion::_recordCacheModelMaps(const vk::raii::CommandBuffer& commandBuffer_, const Camera& camera_, const jjyou::glsl::mat4& view_) const {
+	const std::array<PyramidData, KinectFusion::NUM_PYRAMID_LEVELS>& modelPyramid = this->_poseEstimationAlgorithmData.modelPyramid;
+	_ModelMapCache& cache = this->_modelMapCache;
+	++cache.statistics.numMisses;
+	// Take a new keyframe, or replace the least recently used one.
+	bool newEntry = cache.entries.size() < cache.capacity;
+	if (newEntry) {
+		_ModelMapCacheEntry& entry = cache.entries.emplace_back();
+		for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+			for (std::uint32_t i = 0; i < PyramidData::numTextures; ++i) {
+				entry.textures.emplace_back(
+					*this->_pEngine,
+					modelPyramid[level].texture(i).format(),
+					modelPyramid[level].texture(i).extent(),
+					vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst,
+					std::set<std::uint32_t>{ *this->_pEngine->context().queueFamilyIndex(jjyou::vk::Context::QueueType::Compute) }
+				);
+			}
+		}
+		cache.statistics.numKeyframes = static_cast<std::uint32_t>(cache.entries.size());
+	}
+	else {
+		auto leastRecentlyUsed = std::min_element(
+			cache.entries.begin(),
+			cache.entries.end(),
+			[](const _ModelMapCacheEntry& a_, const _ModelMapCacheEntry& b_) { return a_.lastUse < b_.lastUse; }
+		);
+		std::rotate(leastRecentlyUsed, leastRecentlyUsed + 1, cache.entries.end());
+		++cache.statistics.numEvictions;
+	}
+	_ModelMapCacheEntry& entry = cache.entries.back();
+	entry.view = view_;
+	entry.camera = camera_;
+	entry.lastUse = ++cache.numUses;
+	// Wait for the ray casting, and transition the layouts of new keyframes.
+	std::vector<vk::ImageMemoryBarrier> imageMemoryBarriers;
+	imageMemoryBarriers.reserve(2 * entry.textures.size());
+	vk::ImageMemoryBarrier imageMemoryBarrier = vk::ImageMemoryBarrier()
+		.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0U, 1U, 0U, 1U));
+	std::size_t index = 0;
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		for (std::uint32_t i = 0; i < PyramidData::numTextures; ++i, ++index) {
+			imageMemoryBarriers.push_back(imageMemoryBarrier
+				.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+				.setDstAccessMask(vk::AccessFlagBits::eTransferRead)
+				.setOldLayout(vk::ImageLayout::eGeneral)
+				.setNewLayout(vk::ImageLayout::eGeneral)
+				.setImage(*modelPyramid[level].texture(i).image())
 			);
-			framePyramid[level].bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_buildLinearFunctionPipelineLayout, 0);
-			modelPyramid[level].bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_buildLinearFunctionPipelineLayout, 1);
-			icpDescriptorSet.icpParameters().frameInvView = estimatedInvView.cast<float>();
-			icpDescriptorSet.bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_buildLinearFunctionPipelineLayout, 2);
-			icpCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_buildLinearFunctionPipeline);
-			jjyou::glsl::uvec3 numWorkGroups(
-				(modelPyramid[level].texture(0).extent().width + KinectFusion::_buildLinearFunctionWorkGroupSize.x - 1U) / KinectFusion::_buildLinearFunctionWorkGroupSize.x,
-				(modelPyramid[level].texture(0).extent().height + KinectFusion::_buildLinearFunctionWorkGroupSize.y - 1U) / KinectFusion::_buildLinearFunctionWorkGroupSize.y,
-				1U
+			imageMemoryBarriers.push_back(imageMemoryBarrier
+				.setSrcAccessMask(vk::AccessFlags(0))
+				.setDstAccessMask(vk::AccessFlagBits::eTransferWrite)
+				.setOldLayout(newEntry ? vk::ImageLayout::eUndefined : vk::ImageLayout::eGeneral)
+				.setNewLayout(vk::ImageLayout::eGeneral)
+				.setImage(*entry.textures[index].image())
 			);
-			icpCommandBuffer.dispatch(numWorkGroups.x, numWorkGroups.y, numWorkGroups.z);
-			// Insert a buffer memory barrier.
-			readAfterWriteBufferMemoryBarrier.setBuffer(*icpDescriptorSet.globalSumBufferBuffer());
-			icpCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, readAfterWriteBufferMemoryBarrier, nullptr);
-			// Sum reduction.
-			_GlobalSumBufferLength globalSumBufferLength{
-				.len = numWorkGroups.x * numWorkGroups.y * numWorkGroups.z
-			};
-			icpCommandBuffer.pushConstants<_GlobalSumBufferLength>(*this->_buildLinearFunctionReductionPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0U, globalSumBufferLength);
-			icpDescriptorSet.bind(icpCommandBuffer, vk::PipelineBindPoint::eCompute, this->_buildLinearFunctionReductionPipelineLayout, 0);
-			icpCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_buildLinearFunctionReductionPipeline);
-			icpCommandBuffer.dispatch(27U, 1U, 1U);
-			icpCommandBuffer.end();
-			this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
-				vk::SubmitInfo()
-				.setWaitSemaphores(nullptr)
-				.setWaitDstStageMask(nullptr)
-				.setCommandBuffers(*icpCommandBuffer)
-				.setSignalSemaphores(nullptr),
-				*icpFence
+		}
+	}
+	commandBuffer_.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(0), nullptr, nullptr, imageMemoryBarriers);
+	index = 0;
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		for (std::uint32_t i = 0; i < PyramidData::numTextures; ++i, ++index) {
+			vk::Extent2D extent = modelPyramid[level].texture(i).extent();
+			commandBuffer_.copyImage(
+				*modelPyramid[level].texture(i).image(),
+				vk::ImageLayout::eGeneral,
+				*entry.textures[index].image(),
+				vk::ImageLayout::eGeneral,
+				vk::ImageCopy(
+					vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0U, 0U, 1U),
+					vk::Offset3D(0, 0, 0),
+					vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0U, 0U, 1U),
+					vk::Offset3D(0, 0, 0),
+					vk::Extent3D(extent, 1U)
+				)
+			);
+		}
+	}
+}
+
+void KinectFusion::_recordRestoreModelMaps(const vk::raii::CommandBuffer& commandBuffer_, std::size_t entry_) const {
+	const std::array<PyramidData, KinectFusion::NUM_PYRAMID_LEVELS>& modelPyramid = this->_poseEstimationAlgorithmData.modelPyramid;
+	const std::array<ValidPixelsDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS>& modelValidPixels = this->_poseEstimationAlgorithmData.modelValidPixels;
+	_ModelMapCache& cache = this->_modelMapCache;
+	_ModelMapCacheEntry& entry = cache.entries[entry_];
+	entry.lastUse = ++cache.numUses;
+	++cache.statistics.numHits;
+	// The model pyramid may still be read by the previous ICP. Its old contents are discarded.
+	std::vector<vk::ImageMemoryBarrier> imageMemoryBarriers;
+	imageMemoryBarriers.reserve(entry.textures.size());
+	vk::ImageMemoryBarrier imageMemoryBarrier = vk::ImageMemoryBarrier()
+		.setSrcAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite)
+		.setDstAccessMask(vk::AccessFlagBits::eTransferWrite)
+		.setOldLayout(vk::ImageLayout::eGeneral)
+		.setNewLayout(vk::ImageLayout::eGeneral)
+		.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+		//.setImage()
+		.setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0U, 1U, 0U, 1U));
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		for (std::uint32_t i = 0; i < PyramidData::numTextures; ++i) {
+			imageMemoryBarriers.push_back(imageMemoryBarrier.setImage(*modelPyramid[level].texture(i).image()));
+		}
+	}
+	commandBuffer_.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(0), nullptr, nullptr, imageMemoryBarriers);
+	std::size_t index = 0;
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		for (std::uint32_t i = 0; i < PyramidData::numTextures; ++i, ++index) {
+			vk::Extent2D extent = modelPyramid[level].texture(i).extent();
+			commandBuffer_.copyImage(
+				*entry.textures[index].image(),
+				vk::ImageLayout::eGeneral,
+				*modelPyramid[level].texture(i).image(),
+				vk::ImageLayout::eGeneral,
+				vk::ImageCopy(
+					vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0U, 0U, 1U),
+					vk::Offset3D(0, 0, 0),
+					vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0U, 0U, 1U),
+					vk::Offset3D(0, 0, 0),
+					vk::Extent3D(extent, 1U)
+				)
 			);
-			waitResult = this->_pEngine->context().device().waitForFences(*icpFence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
-			VK_CHECK(waitResult);
-			this->_pEngine->context().device().resetFences(*icpFence);
-			icpCommandBuffer.reset(vk::CommandBufferResetFlags(0));
-			// Download data.
-			int counter = 0;
-			Eigen::Matrix<float, 6, 6> A{};
-			Eigen::Vector<float, 6> b{};
-			for (int i = 0; i < 6; ++i) {
-				for (int j = i; j < 7; ++j) {
-					if (j == 6)
-						b[i] = icpDescriptorSet.reductionResult().data[counter];
-					else
-						A(i, j) = A(j, i) = icpDescriptorSet.reductionResult().data[counter];
-					++counter;
-				}
-			}
-			Eigen::Matrix<double, 6, 6> _A = A.cast<double>();
-			Eigen::Vector<double, 6> _b = b.cast<double>();
-			// Solve the function. We use 64-bit double for higher precision.
-			double detA = _A.determinant();
-			if (std::isnan(detA) || std::abs(detA) < 50000.0)
-				return std::nullopt;
-			Eigen::Vector<double, 6> x = _A.ldlt().solve(_b);
-			double normX = x.norm();
-			if (normX > 0.15)
-				return std::nullopt;
-			Eigen::Quaterniond rotation =
-				Eigen::AngleAxisd(x(2), Eigen::Vector3d::UnitZ()) *
-				Eigen::AngleAxisd(x(1), Eigen::Vector3d::UnitY()) *
-				Eigen::AngleAxisd(x(0), Eigen::Vector3d::UnitX());
-			Eigen::Vector3d translation = x.tail<3>();
-			Eigen::Matrix4d deltaTransform = Eigen::Matrix4d::Identity();
-			deltaTransform.topLeftCorner<3, 3>() = rotation.matrix();
-			deltaTransform.topRightCorner<3, 1>() = translation;
-			estimatedInvViewEigen = deltaTransform * estimatedInvViewEigen;
 		}
 	}
-	return jjyou::glsl::inverse(estimatedInvView.cast<float>());
+	// The compaction and ICP read the copied maps.
+	for (vk::ImageMemoryBarrier& barrier : imageMemoryBarriers)
+		barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite).setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+	this->_recordResetValidPixels(commandBuffer_, modelValidPixels);
+	commandBuffer_.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, vk::DependencyFlags(0), nullptr, nullptr, imageMemoryBarriers);
+	for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		this->_recordCompactValidPixels(commandBuffer_, modelPyramid[level], modelValidPixels[level], false);
+	}
 }
 
-void KinectFusion::fuse(
-	const Surface<Simple>& surface_,
-	const Camera& camera_,
-	const jjyou::glsl::mat4& view_
-) const {
-	const FusionDescriptorSet& fusionDescriptorSet = this->_fusionAlgorithmData.descriptorSet;
-	const vk::raii::CommandBuffer& commandBuffer = this->_fusionAlgorithmData.commandBuffer;
-	const vk::raii::Fence& fence = this->_fusionAlgorithmData.fence;
+void KinectFusion::_waitModelRayCasting(void) const {
+	if (!this->_poseEstimationAlgorithmData.modelRayCastingPending)
+		return;
+	const vk::raii::Fence& rayCastingFence = this->_poseEstimationAlgorithmData.rayCastingFence;
+	vk::Result waitResult = this->_pEngine->waitForFences(*rayCastingFence);
+	VK_CHECK(waitResult);
+	this->_pEngine->context().device().resetFences(*rayCastingFence);
+	this->_poseEstimationAlgorithmData.rayCastingCommandBuffer.reset(vk::CommandBufferResetFlags(0));
+	this->_poseEstimationAlgorithmData.modelRayCastingPending = false;
+}
+
+KinectFusion::PointCloudStatistics KinectFusion::exportPointCloud(const std::filesystem::path& path_, vk::DeviceSize stagingBudget_) {
+	this->endFuse();
+	std::chrono::steady_clock::time_point beginTime = std::chrono::steady_clock::now();
+	PointCloudStatistics statistics{};
+	const jjyou::glsl::uvec3& resolution = this->_tsdfVolume.resolution();
+	// A slab generates at most 3 points per voxel. Each append buffer holds at least one slab, so that every chunk can be extracted.
+	std::uint64_t slabCapacity = 3ULL * resolution.y * resolution.z;
+	std::uint64_t capacity = std::max<std::uint64_t>(stagingBudget_ / (2ULL * sizeof(Vertex<MaterialType::Lambertian>)), slabCapacity);
+	if (capacity * 7ULL > static_cast<std::uint64_t>(std::numeric_limits<std::uint32_t>::max())) {
+		capacity = static_cast<std::uint64_t>(std::numeric_limits<std::uint32_t>::max()) / 7ULL;
+		if (capacity < slabCapacity) {
+			throw std::logic_error("[KinectFusion] The volume is too large to extract a point cloud slab by slab.");
+		}
+	}
+	std::array<PointCloudDescriptorSet, 2> pointClouds = { {
+		PointCloudDescriptorSet(*this->_pEngine, *this, static_cast<std::uint32_t>(capacity)),
+		PointCloudDescriptorSet(*this->_pEngine, *this, static_cast<std::uint32_t>(capacity))
+	} };
+	PLYWriter writer(path_, PLYWriter::DEFERRED_COUNT, 0ULL);
+	std::future<void> pendingWrite{};
+	std::uint32_t beginX = 0U;
+	std::uint32_t chunkSize = resolution.x;
+	std::uint32_t bank = 0U;
+	while (beginX < resolution.x) {
+		const PointCloudDescriptorSet& pointCloud = pointClouds[bank];
+		// Extract the chunk, halving it until its points fit.
+		std::uint32_t endX = std::min(beginX + chunkSize, resolution.x);
+		while (true) {
+			std::chrono::steady_clock::time_point extractionBegin = std::chrono::steady_clock::now();
+			this->_extractPointCloudChunk(pointCloud, beginX, endX);
+			statistics.extractionTime += std::chrono::steady_clock::now() - extractionBegin;
+			if (pointCloud.numPoints() <= pointCloud.capacity())
+				break;
+			++statistics.numRetries;
+			endX = beginX + std::max((endX - beginX) / 2U, 1U);
+		}
+		std::uint32_t numPoints = pointCloud.numPoints();
+		// Grow the next chunk if this one used little of the buffer.
+		chunkSize = endX - beginX;
+		if (numPoints < pointCloud.capacity() / 4U)
+			chunkSize = std::min(chunkSize * 2U, resolution.x);
+		// Write this chunk in the background while the next chunk is extracted into the other buffer.
+		// The previous write used the other buffer, so it must finish first.
+		if (pendingWrite.valid()) {
+			std::chrono::steady_clock::time_point waitBegin = std::chrono::steady_clock::now();
+			pendingWrite.get();
+			statistics.writeWaitTime += std::chrono::steady_clock::now() - waitBegin;
+		}
+		pendingWrite = std::async(std::launch::async, [&writer, &pointCloud, numPoints](void) {
+			const Vertex<MaterialType::Lambertian>* pPoints = pointCloud.points();
+			for (std::uint32_t i = 0; i < numPoints; ++i)
+				writer.writeVertex(pPoints[i].position, pPoints[i].normal, pPoints[i].color);
+		});
+		statistics.numPoints += numPoints;
+		++statistics.numChunks;
+		beginX = endX;
+		bank = 1U - bank;
+	}
+	if (pendingWrite.valid()) {
+		std::chrono::steady_clock::time_point waitBegin = std::chrono::steady_clock::now();
+		pendingWrite.get();
+		statistics.writeWaitTime += std::chrono::steady_clock::now() - waitBegin;
+	}
+	writer.close();
+	statistics.numBytes = writer.numBytes();
+	statistics.totalTime = std::chrono::steady_clock::now() - beginTime;
+	return statistics;
+}
+
+void KinectFusion::_extractPointCloudChunk(const PointCloudDescriptorSet& pointCloud_, std::uint32_t beginX_, std::uint32_t endX_) {
+	const vk::raii::CommandBuffer& commandBuffer = this->_extractPointCloudAlgorithmData.commandBuffer;
+	const vk::raii::Fence& fence = this->_extractPointCloudAlgorithmData.fence;
+	const jjyou::glsl::uvec3& resolution = this->_tsdfVolume.resolution();
+	pointCloud_.reset();
 	commandBuffer.begin(
 		vk::CommandBufferBeginInfo()
 		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
 		.setPInheritanceInfo(nullptr)
 	);
-	commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_fusionPipeline);
-	this->_tsdfVolume.bind(commandBuffer, vk::PipelineBindPoint::eCompute, this->_fusionPipelineLayout, 0);
-	jjyou::glsl::mat3 projection = camera_.getVisionProjection();
-	fusionDescriptorSet.fusionParameters().fx = projection[0][0];
-	fusionDescriptorSet.fusionParameters().fy = projection[1][1];
-	fusionDescriptorSet.fusionParameters().cx = projection[2][0];
-	fusionDescriptorSet.fusionParameters().cy = projection[2][1];
-	fusionDescriptorSet.fusionParameters().view = view_;
-	fusionDescriptorSet.fusionParameters().viewPos = jjyou::glsl::vec4(-jjyou::glsl::transpose(jjyou::glsl::mat3(view_)) * jjyou::glsl::vec3(view_[3]), 1.0f);
-	fusionDescriptorSet.fusionParameters().truncationWeight = static_cast<int>(this->_truncationWeight);
-	fusionDescriptorSet.fusionParameters().minDepth = this->_minDepth;
-	fusionDescriptorSet.fusionParameters().maxDepth = this->_maxDepth;
-	fusionDescriptorSet.fusionParameters().invalidDepth = this->_invalidDepth;
-	fusionDescriptorSet.bind(commandBuffer, vk::PipelineBindPoint::eCompute, this->_fusionPipelineLayout, 1);
-	surface_.bindStorage(commandBuffer, vk::PipelineBindPoint::eCompute, this->_fusionPipelineLayout, 2);
+	commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_extractPointCloudPipeline);
+	this->_tsdfVolume.bind(commandBuffer, vk::PipelineBindPoint::eCompute, this->_extractPointCloudPipelineLayout, 0);
+	pointCloud_.bind(commandBuffer, vk::PipelineBindPoint::eCompute, this->_extractPointCloudPipelineLayout, 1);
+	KinectFusion::_ExtractPointCloudParameters extractPointCloudParameters{
+		.beginX = beginX_,
+		.endX = endX_,
+		.capacity = pointCloud_.capacity()
+	};
+	commandBuffer.pushConstants<_ExtractPointCloudParameters>(*this->_extractPointCloudPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0U, extractPointCloudParameters);
 	commandBuffer.dispatch(
-		(this->_tsdfVolume.resolution().x + KinectFusion::_fusionWorkGroupSize.x - 1U) / KinectFusion::_fusionWorkGroupSize.x,
-		(this->_tsdfVolume.resolution().y + KinectFusion::_fusionWorkGroupSize.y - 1U) / KinectFusion::_fusionWorkGroupSize.y,
-		1U
+		(endX_ - beginX_ + KinectFusion::_extractPointCloudWorkGroupSize.x - 1U) / KinectFusion::_extractPointCloudWorkGroupSize.x,
+		(resolution.y + KinectFusion::_extractPointCloudWorkGroupSize.y - 1U) / KinectFusion::_extractPointCloudWorkGroupSize.y,
+		(resolution.z + KinectFusion::_extractPointCloudWorkGroupSize.z - 1U) / KinectFusion::_extractPointCloudWorkGroupSize.z
 	);
+	// Make the points visible to the host.
+	vk::MemoryBarrier memoryBarrier = vk::MemoryBarrier()
+		.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+		.setDstAccessMask(vk::AccessFlagBits::eHostRead);
+	commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eHost, vk::DependencyFlags(0), memoryBarrier, nullptr, nullptr);
 	commandBuffer.end();
 	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
 		vk::SubmitInfo()
@@ -432,7 +1480,7 @@ void KinectFusion::fuse(
 		.setSignalSemaphores(nullptr),
 		*fence
 	);
-	vk::Result waitResult = this->_pEngine->context().device().waitForFences(*fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+	vk::Result waitResult = this->_pEngine->waitForFences(*fence);
 	VK_CHECK(waitResult);
 	this->_pEngine->context().device().resetFences(*fence);
 	commandBuffer.reset(vk::CommandBufferResetFlags(0));
@@ -440,19 +1488,31 @@ void KinectFusion::fuse(
 
 void KinectFusion::_createDescriptorSetLayouts(void) {
 	// TSDF volume storage buffer
-	this->_tsdfVolumeDescriptorSetLayout = TSDFVolume::createDescriptorSetLayout(this->_pEngine->context().device());
+	this->_tsdfVolumeDescriptorSetLayout = TSDFVolume::createDescriptorSetLayout(this->_pEngine->descriptorAllocator());
 
 	// Ray casting uniform block
-	this->_rayCastingDescriptorSetLayout = RayCastingDescriptorSet::createDescriptorSetLayout(this->_pEngine->context().device());
+	this->_rayCastingDescriptorSetLayout = RayCastingDescriptorSet::createDescriptorSetLayout(this->_pEngine->descriptorAllocator());
+
+	// Batched ray casting uniform block and surfaces
+	this->_batchRayCastingDescriptorSetLayout = BatchRayCastingDescriptorSet::createDescriptorSetLayout(this->_pEngine->descriptorAllocator());
 	
 	// Fusion uniform block
-	this->_fusionDescriptorSetLayout = FusionDescriptorSet::createDescriptorSetLayout(this->_pEngine->context().device());
+	this->_fusionDescriptorSetLayout = FusionDescriptorSet::createDescriptorSetLayout(this->_pEngine->descriptorAllocator());
 
 	// Pyramid data
-	this->_pyramidDataDescriptorSetLayout = PyramidData::createDescriptorSetLayout(this->_pEngine->context().device());
+	this->_pyramidDataDescriptorSetLayout = PyramidData::createDescriptorSetLayout(this->_pEngine->descriptorAllocator());
 
 	// ICP
-	this->_icpDescriptorSetLayout = ICPDescriptorSet::createDescriptorSetLayout(this->_pEngine->context().device());
+	this->_icpDescriptorSetLayout = ICPDescriptorSet::createDescriptorSetLayout(this->_pEngine->descriptorAllocator());
+
+	// Valid pixels
+	this->_validPixelsDescriptorSetLayout = ValidPixelsDescriptorSet::createDescriptorSetLayout(this->_pEngine->descriptorAllocator());
+
+	// Mesh cache
+	this->_meshCacheDescriptorSetLayout = MeshCache::createDescriptorSetLayout(this->_pEngine->descriptorAllocator());
+
+	// Point cloud
+	this->_pointCloudDescriptorSetLayout = PointCloudDescriptorSet::createDescriptorSetLayout(this->_pEngine->descriptorAllocator());
 }
 
 void KinectFusion::_createPipelineLayouts(void) {
@@ -482,6 +1542,19 @@ void KinectFusion::_createPipelineLayouts(void) {
 		this->_rayCastingPipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
 	}
 
+	// Batched ray casting
+	{
+		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
+			*this->_tsdfVolumeDescriptorSetLayout,
+			*this->_batchRayCastingDescriptorSetLayout
+		};
+		vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo()
+			.setFlags(vk::PipelineLayoutCreateFlags(0))
+			.setSetLayouts(descriptorSetLayouts)
+			.setPushConstantRanges(nullptr);
+		this->_batchRayCastingPipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
+	}
+
 	// Fusion
 	{
 		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
@@ -530,7 +1603,9 @@ void KinectFusion::_createPipelineLayouts(void) {
 	// Compute vertex/normal map
 	{
 		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
-			*this->_pyramidDataDescriptorSetLayout
+			*this->_pyramidDataDescriptorSetLayout,
+			*this->_validPixelsDescriptorSetLayout,
+			*this->_validPixelsDescriptorSetLayout
 		};
 		vk::PushConstantRange pushConstantRange = vk::PushConstantRange()
 			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
@@ -560,17 +1635,40 @@ void KinectFusion::_createPipelineLayouts(void) {
 		this->_halfSamplingPipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
 	}
 
+	// Compact valid pixels
+	{
+		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
+			*this->_pyramidDataDescriptorSetLayout,
+			*this->_validPixelsDescriptorSetLayout
+		};
+		vk::PushConstantRange pushConstantRange = vk::PushConstantRange()
+			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+			.setOffset(0U)
+			.setSize(sizeof(KinectFusion::_CompactValidPixelsParameters));
+		vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo()
+			.setFlags(vk::PipelineLayoutCreateFlags(0))
+			.setSetLayouts(descriptorSetLayouts)
+			.setPushConstantRanges(pushConstantRange);
+		this->_compactValidPixelsPipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
+	}
+
 	// Build linear function
 	{
 		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
 			*this->_pyramidDataDescriptorSetLayout,
 			*this->_pyramidDataDescriptorSetLayout,
-			*this->_icpDescriptorSetLayout
+			*this->_icpDescriptorSetLayout,
+			*this->_validPixelsDescriptorSetLayout,
+			*this->_validPixelsDescriptorSetLayout
 		};
+		vk::PushConstantRange pushConstantRange = vk::PushConstantRange()
+			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+			.setOffset(0U)
+			.setSize(sizeof(KinectFusion::_ICPLevel));
 		vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo()
 			.setFlags(vk::PipelineLayoutCreateFlags(0))
 			.setSetLayouts(descriptorSetLayouts)
-			.setPushConstantRanges(nullptr);
+			.setPushConstantRanges(pushConstantRange);
 		this->_buildLinearFunctionPipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
 	}
 
@@ -579,22 +1677,87 @@ void KinectFusion::_createPipelineLayouts(void) {
 		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
 			*this->_icpDescriptorSetLayout
 		};
+		vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo()
+			.setFlags(vk::PipelineLayoutCreateFlags(0))
+			.setSetLayouts(descriptorSetLayouts)
+			.setPushConstantRanges(nullptr);
+		this->_buildLinearFunctionReductionPipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
+	}
+
+	// Solve linear function
+	{
+		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
+			*this->_icpDescriptorSetLayout,
+			*this->_validPixelsDescriptorSetLayout
+		};
 		vk::PushConstantRange pushConstantRange = vk::PushConstantRange()
 			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
 			.setOffset(0U)
-			.setSize(sizeof(KinectFusion::_GlobalSumBufferLength));
+			.setSize(sizeof(KinectFusion::_SolveParameters));
 		vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo()
 			.setFlags(vk::PipelineLayoutCreateFlags(0))
 			.setSetLayouts(descriptorSetLayouts)
 			.setPushConstantRanges(pushConstantRange);
-		this->_buildLinearFunctionReductionPipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
+		this->_solveLinearFunctionPipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
+	}
+
+	// Mesh bricks
+	{
+		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
+			*this->_tsdfVolumeDescriptorSetLayout,
+			*this->_meshCacheDescriptorSetLayout
+		};
+		vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo()
+			.setFlags(vk::PipelineLayoutCreateFlags(0))
+			.setSetLayouts(descriptorSetLayouts)
+			.setPushConstantRanges(nullptr);
+		this->_meshBricksPipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
+	}
+
+	// Extract point cloud
+	{
+		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
+			*this->_tsdfVolumeDescriptorSetLayout,
+			*this->_pointCloudDescriptorSetLayout
+		};
+		vk::PushConstantRange pushConstantRange = vk::PushConstantRange()
+			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+			.setOffset(0U)
+			.setSize(sizeof(KinectFusion::_ExtractPointCloudParameters));
+		vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo()
+			.setFlags(vk::PipelineLayoutCreateFlags(0))
+			.setSetLayouts(descriptorSetLayouts)
+			.setPushConstantRanges(pushConstantRange);
+		this->_extractPointCloudPipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
 	}
 }
 
 void KinectFusion::_createPipelines(void) {
+	// Specialization constants of the shaders that include `tsdfVolumeCommon.h`. The ids must match the shaders.
+	// Map entries of constants that a shader does not declare are ignored.
+	struct VolumeSpecializationConstants {
+		vk::Bool32 sparseVolume;				// constant_id = 0
+		std::uint32_t fusionWorkGroupSizeX;		// constant_id = 1
+		std::uint32_t fusionWorkGroupSizeY;		// constant_id = 2
+	};
+	VolumeSpecializationConstants volumeConstants{
+		.sparseVolume = this->_pipelineTraits.sparseVolume ? VK_TRUE : VK_FALSE,
+		.fusionWorkGroupSizeX = this->_pipelineTraits.fusionWorkGroupSize.x,
+		.fusionWorkGroupSizeY = this->_pipelineTraits.fusionWorkGroupSize.y
+	};
+	std::array<vk::SpecializationMapEntry, 3> volumeMapEntries{ {
+		vk::SpecializationMapEntry(0U, static_cast<std::uint32_t>(offsetof(VolumeSpecializationConstants, sparseVolume)), sizeof(vk::Bool32)),
+		vk::SpecializationMapEntry(1U, static_cast<std::uint32_t>(offsetof(VolumeSpecializationConstants, fusionWorkGroupSizeX)), sizeof(std::uint32_t)),
+		vk::SpecializationMapEntry(2U, static_cast<std::uint32_t>(offsetof(VolumeSpecializationConstants, fusionWorkGroupSizeY)), sizeof(std::uint32_t))
+	} };
+	vk::SpecializationInfo volumeSpecializationInfo = vk::SpecializationInfo()
+		.setMapEntries(volumeMapEntries)
+		.setDataSize(sizeof(VolumeSpecializationConstants))
+		.setPData(&volumeConstants);
+
 	// Init volume
 	{
-#include "./shader/spv/initVolume.comp.spv.h"
+#include "spv/initVolume.comp.spv.h"
 		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(initVolume_comp_spv))
@@ -608,7 +1771,7 @@ void KinectFusion::_createPipelines(void) {
 				.setStage(vk::ShaderStageFlagBits::eCompute)
 				.setModule(*shaderModule)
 				.setPName("main")
-				.setPSpecializationInfo(nullptr)
+				.setPSpecializationInfo(&volumeSpecializationInfo)
 			)
 			.setLayout(*this->_initVolumePipelineLayout)
 			.setBasePipelineHandle(nullptr)
@@ -618,7 +1781,7 @@ void KinectFusion::_createPipelines(void) {
 
 	// Ray casting
 	{
-#include "./shader/spv/rayCasting.comp.spv.h"
+#include "spv/rayCasting.comp.spv.h"
 		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(rayCasting_comp_spv))
@@ -632,7 +1795,7 @@ void KinectFusion::_createPipelines(void) {
 				.setStage(vk::ShaderStageFlagBits::eCompute)
 				.setModule(*shaderModule)
 				.setPName("main")
-				.setPSpecializationInfo(nullptr)
+				.setPSpecializationInfo(&volumeSpecializationInfo)
 			)
 			.setLayout(*this->_rayCastingPipelineLayout)
 			.setBasePipelineHandle(nullptr)
@@ -640,9 +1803,33 @@ void KinectFusion::_createPipelines(void) {
 		this->_rayCastingPipeline = vk::raii::Pipeline(this->_pEngine->context().device(), nullptr, computePipelineCreateInfo);
 	}
 
+	// Batched ray casting
+	{
+#include "spv/rayCastingBatch.comp.spv.h"
+		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
+			.setFlags(vk::ShaderModuleCreateFlags(0))
+			.setPCode(reinterpret_cast<const uint32_t*>(rayCastingBatch_comp_spv))
+			.setCodeSize(sizeof(rayCastingBatch_comp_spv))
+		);
+		vk::ComputePipelineCreateInfo computePipelineCreateInfo = vk::ComputePipelineCreateInfo()
+			.setFlags(vk::PipelineCreateFlags(0))
+			.setStage(
+				vk::PipelineShaderStageCreateInfo()
+				.setFlags(vk::PipelineShaderStageCreateFlags(0))
+				.setStage(vk::ShaderStageFlagBits::eCompute)
+				.setModule(*shaderModule)
+				.setPName("main")
+				.setPSpecializationInfo(&volumeSpecializationInfo)
+			)
+			.setLayout(*this->_batchRayCastingPipelineLayout)
+			.setBasePipelineHandle(nullptr)
+			.setBasePipelineIndex(0);
+		this->_batchRayCastingPipeline = vk::raii::Pipeline(this->_pEngine->context().device(), nullptr, computePipelineCreateInfo);
+	}
+
 	// Fusion
 	{
-#include "./shader/spv/fusion.comp.spv.h"
+#include "spv/fusion.comp.spv.h"
 		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(fusion_comp_spv))
@@ -656,7 +1843,7 @@ void KinectFusion::_createPipelines(void) {
 				.setStage(vk::ShaderStageFlagBits::eCompute)
 				.setModule(*shaderModule)
 				.setPName("main")
-				.setPSpecializationInfo(nullptr)
+				.setPSpecializationInfo(&volumeSpecializationInfo)
 			)
 			.setLayout(*this->_fusionPipelineLayout)
 			.setBasePipelineHandle(nullptr)
@@ -666,7 +1853,7 @@ void KinectFusion::_createPipelines(void) {
 
 	// Bilateral filtering
 	{
-#include "./shader/spv/bilateralFiltering.comp.spv.h"
+#include "spv/bilateralFiltering.comp.spv.h"
 		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(bilateralFiltering_comp_spv))
@@ -690,7 +1877,7 @@ void KinectFusion::_createPipelines(void) {
 
 	// Ray casting for ICP
 	{
-#include "./shader/spv/rayCastingICP.comp.spv.h"
+#include "spv/rayCastingICP.comp.spv.h"
 		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(rayCastingICP_comp_spv))
@@ -704,7 +1891,7 @@ void KinectFusion::_createPipelines(void) {
 				.setStage(vk::ShaderStageFlagBits::eCompute)
 				.setModule(*shaderModule)
 				.setPName("main")
-				.setPSpecializationInfo(nullptr)
+				.setPSpecializationInfo(&volumeSpecializationInfo)
 			)
 			.setLayout(*this->_rayCastingICPPipelineLayout)
 			.setBasePipelineHandle(nullptr)
@@ -714,7 +1901,7 @@ void KinectFusion::_createPipelines(void) {
 
 	// Compute vertex map
 	{
-#include "./shader/spv/computeVertexMap.comp.spv.h"
+#include "spv/computeVertexMap.comp.spv.h"
 		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(computeVertexMap_comp_spv))
@@ -738,7 +1925,7 @@ void KinectFusion::_createPipelines(void) {
 
 	// Compute normal map
 	{
-#include "./shader/spv/computeNormalMap.comp.spv.h"
+#include "spv/computeNormalMap.comp.spv.h"
 		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(computeNormalMap_comp_spv))
@@ -762,7 +1949,7 @@ void KinectFusion::_createPipelines(void) {
 
 	// Half-sampling
 	{
-#include "./shader/spv/halfSampling.comp.spv.h"
+#include "spv/halfSampling.comp.spv.h"
 		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(halfSampling_comp_spv))
@@ -784,9 +1971,33 @@ void KinectFusion::_createPipelines(void) {
 		this->_halfSamplingPipeline = vk::raii::Pipeline(this->_pEngine->context().device(), nullptr, computePipelineCreateInfo);
 	}
 
+	// Compact valid pixels
+	{
+#include "spv/compactValidPixels.comp.spv.h"
+		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
+			.setFlags(vk::ShaderModuleCreateFlags(0))
+			.setPCode(reinterpret_cast<const uint32_t*>(compactValidPixels_comp_spv))
+			.setCodeSize(sizeof(compactValidPixels_comp_spv))
+		);
+		vk::ComputePipelineCreateInfo computePipelineCreateInfo = vk::ComputePipelineCreateInfo()
+			.setFlags(vk::PipelineCreateFlags(0))
+			.setStage(
+				vk::PipelineShaderStageCreateInfo()
+				.setFlags(vk::PipelineShaderStageCreateFlags(0))
+				.setStage(vk::ShaderStageFlagBits::eCompute)
+				.setModule(*shaderModule)
+				.setPName("main")
+				.setPSpecializationInfo(nullptr)
+			)
+			.setLayout(*this->_compactValidPixelsPipelineLayout)
+			.setBasePipelineHandle(nullptr)
+			.setBasePipelineIndex(0);
+		this->_compactValidPixelsPipeline = vk::raii::Pipeline(this->_pEngine->context().device(), nullptr, computePipelineCreateInfo);
+	}
+
 	// Build linear function
 	{
-#include "./shader/spv/buildLinearFunction.comp.spv.h"
+#include "spv/buildLinearFunction.comp.spv.h"
 		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(buildLinearFunction_comp_spv))
@@ -810,7 +2021,7 @@ void KinectFusion::_createPipelines(void) {
 
 	// Build linear function reduction
 	{
-#include "./shader/spv/buildLinearFunctionReduction.comp.spv.h"
+#include "spv/buildLinearFunctionReduction.comp.spv.h"
 		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
 			.setFlags(vk::ShaderModuleCreateFlags(0))
 			.setPCode(reinterpret_cast<const uint32_t*>(buildLinearFunctionReduction_comp_spv))
@@ -831,6 +2042,117 @@ void KinectFusion::_createPipelines(void) {
 			.setBasePipelineIndex(0);
 		this->_buildLinearFunctionReductionPipeline = vk::raii::Pipeline(this->_pEngine->context().device(), nullptr, computePipelineCreateInfo);
 	}
+
+	// Solve linear function
+	{
+#include "spv/solveLinearFunction.comp.spv.h"
+		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
+			.setFlags(vk::ShaderModuleCreateFlags(0))
+			.setPCode(reinterpret_cast<const uint32_t*>(solveLinearFunction_comp_spv))
+			.setCodeSize(sizeof(solveLinearFunction_comp_spv))
+		);
+		vk::ComputePipelineCreateInfo computePipelineCreateInfo = vk::ComputePipelineCreateInfo()
+			.setFlags(vk::PipelineCreateFlags(0))
+			.setStage(
+				vk::PipelineShaderStageCreateInfo()
+				.setFlags(vk::PipelineShaderStageCreateFlags(0))
+				.setStage(vk::ShaderStageFlagBits::eCompute)
+				.setModule(*shaderModule)
+				.setPName("main")
+				.setPSpecializationInfo(nullptr)
+			)
+			.setLayout(*this->_solveLinearFunctionPipelineLayout)
+			.setBasePipelineHandle(nullptr)
+			.setBasePipelineIndex(0);
+		this->_solveLinearFunctionPipeline = vk::raii::Pipeline(this->_pEngine->context().device(), nullptr, computePipelineCreateInfo);
+	}
+
+	// Mesh bricks
+	{
+#include "spv/meshBricks.comp.spv.h"
+		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
+			.setFlags(vk::ShaderModuleCreateFlags(0))
+			.setPCode(reinterpret_cast<const uint32_t*>(meshBricks_comp_spv))
+			.setCodeSize(sizeof(meshBricks_comp_spv))
+		);
+		vk::ComputePipelineCreateInfo computePipelineCreateInfo = vk::ComputePipelineCreateInfo()
+			.setFlags(vk::PipelineCreateFlags(0))
+			.setStage(
+				vk::PipelineShaderStageCreateInfo()
+				.setFlags(vk::PipelineShaderStageCreateFlags(0))
+				.setStage(vk::ShaderStageFlagBits::eCompute)
+				.setModule(*shaderModule)
+				.setPName("main")
+				.setPSpecializationInfo(&volumeSpecializationInfo)
+			)
+			.setLayout(*this->_meshBricksPipelineLayout)
+			.setBasePipelineHandle(nullptr)
+			.setBasePipelineIndex(0);
+		this->_meshBricksPipeline = vk::raii::Pipeline(this->_pEngine->context().device(), nullptr, computePipelineCreateInfo);
+	}
+
+	// Extract point cloud
+	{
+#include "spv/extractPointCloud.comp.spv.h"
+		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
+			.setFlags(vk::ShaderModuleCreateFlags(0))
+			.setPCode(reinterpret_cast<const uint32_t*>(extractPointCloud_comp_spv))
+			.setCodeSize(sizeof(extractPointCloud_comp_spv))
+		);
+		vk::ComputePipelineCreateInfo computePipelineCreateInfo = vk::ComputePipelineCreateInfo()
+			.setFlags(vk::PipelineCreateFlags(0))
+			.setStage(
+				vk::PipelineShaderStageCreateInfo()
+				.setFlags(vk::PipelineShaderStageCreateFlags(0))
+				.setStage(vk::ShaderStageFlagBits::eCompute)
+				.setModule(*shaderModule)
+				.setPName("main")
+				.setPSpecializationInfo(&volumeSpecializationInfo)
+			)
+			.setLayout(*this->_extractPointCloudPipelineLayout)
+			.setBasePipelineHandle(nullptr)
+			.setBasePipelineIndex(0);
+		this->_extractPointCloudPipeline = vk::raii::Pipeline(this->_pEngine->context().device(), nullptr, computePipelineCreateInfo);
+	}
+
+	// FP16 variants of the image-space kernels. Only instantiated if the session uses them.
+	if (this->_pipelineTraits.halfPrecision)
+		this->_createHalfPrecisionPipelines();
+}
+
+void KinectFusion::_createHalfPrecisionPipelines(void) const {
+	if (*this->_bilateralFilteringFP16Pipeline)
+		return;
+	// They share the layouts of the fp32 variants.
+	auto createComputePipeline = [this](const std::uint32_t* pCode_, std::size_t codeSize_, const vk::raii::PipelineLayout& pipelineLayout_) {
+		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
+			.setFlags(vk::ShaderModuleCreateFlags(0))
+			.setPCode(pCode_)
+			.setCodeSize(codeSize_)
+		);
+		vk::ComputePipelineCreateInfo computePipelineCreateInfo = vk::ComputePipelineCreateInfo()
+			.setFlags(vk::PipelineCreateFlags(0))
+			.setStage(
+				vk::PipelineShaderStageCreateInfo()
+				.setFlags(vk::PipelineShaderStageCreateFlags(0))
+				.setStage(vk::ShaderStageFlagBits::eCompute)
+				.setModule(*shaderModule)
+				.setPName("main")
+				.setPSpecializationInfo(nullptr)
+			)
+			.setLayout(*pipelineLayout_)
+			.setBasePipelineHandle(nullptr)
+			.setBasePipelineIndex(0);
+		return vk::raii::Pipeline(this->_pEngine->context().device(), nullptr, computePipelineCreateInfo);
+	};
+#include "spv/bilateralFilteringFP16.comp.spv.h"
+#include "spv/halfSamplingFP16.comp.spv.h"
+#include "spv/computeNormalMapFP16.comp.spv.h"
+#include "spv/buildLinearFunctionFP16.comp.spv.h"
+	this->_bilateralFilteringFP16Pipeline = createComputePipeline(reinterpret_cast<const uint32_t*>(bilateralFilteringFP16_comp_spv), sizeof(bilateralFilteringFP16_comp_spv), this->_bilateralFilteringPipelineLayout);
+	this->_halfSamplingFP16Pipeline = createComputePipeline(reinterpret_cast<const uint32_t*>(halfSamplingFP16_comp_spv), sizeof(halfSamplingFP16_comp_spv), this->_halfSamplingPipelineLayout);
+	this->_computeNormalMapFP16Pipeline = createComputePipeline(reinterpret_cast<const uint32_t*>(computeNormalMapFP16_comp_spv), sizeof(computeNormalMapFP16_comp_spv), this->_computeVertexNormalMapPipelineLayout);
+	this->_buildLinearFunctionFP16Pipeline = createComputePipeline(reinterpret_cast<const uint32_t*>(buildLinearFunctionFP16_comp_spv), sizeof(buildLinearFunctionFP16_comp_spv), this->_buildLinearFunctionPipelineLayout);
 }
 
 void KinectFusion::_createAlgorithmData(void) {
@@ -898,16 +2220,20 @@ void KinectFusion::_createAlgorithmData(void) {
 		ICPDescriptorSet& icpDescriptorSet = this->_poseEstimationAlgorithmData.icpDescriptorSet;
 		vk::raii::CommandBuffer& icpCommandBuffer = this->_poseEstimationAlgorithmData.icpCommandBuffer;
 		vk::raii::Fence& icpFence = this->_poseEstimationAlgorithmData.icpFence;
-		vk::Extent2D levelExtent = _depthFrameExtent;
-		for (std::uint32_t level = 0; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
+		// Levels finer than the tracking level are left empty.
+		vk::Extent2D levelExtent = vk::Extent2D(this->_depthFrameExtent.width >> this->_trackingLevel, this->_depthFrameExtent.height >> this->_trackingLevel);
+		for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level) {
 			this->_poseEstimationAlgorithmData.modelPyramid[level] = PyramidData(*this->_pEngine, *this, levelExtent);
 			this->_poseEstimationAlgorithmData.framePyramid[level] = PyramidData(*this->_pEngine, *this, levelExtent);
+			this->_poseEstimationAlgorithmData.modelValidPixels[level] = ValidPixelsDescriptorSet(*this->_pEngine, *this, levelExtent);
+			this->_poseEstimationAlgorithmData.frameDepthValidPixels[level] = ValidPixelsDescriptorSet(*this->_pEngine, *this, levelExtent);
+			this->_poseEstimationAlgorithmData.frameValidPixels[level] = ValidPixelsDescriptorSet(*this->_pEngine, *this, levelExtent);
 			levelExtent.width /= 2U;
 			levelExtent.height /= 2U;
 		}
 		buildPyramidCommandBuffer = std::move(this->_pEngine->context().device().allocateCommandBuffers(
 			vk::CommandBufferAllocateInfo()
-			.setCommandPool(*this->_pEngine->commandPool(jjyou::vk::Context::QueueType::Compute))
+			.setCommandPool(*this->_pEngine->commandPool(this->_trackingQueueType))
 			.setLevel(vk::CommandBufferLevel::ePrimary)
 			.setCommandBufferCount(1)
 		)[0]);
@@ -915,7 +2241,7 @@ void KinectFusion::_createAlgorithmData(void) {
 			this->_pEngine->context().device(),
 			vk::FenceCreateInfo(vk::FenceCreateFlags(0))
 		);
-		for (std::uint32_t level = 0; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level)
+		for (std::uint32_t level = this->_trackingLevel; level < KinectFusion::NUM_PYRAMID_LEVELS; ++level)
 			rayCastingDescriptorSets[level] = RayCastingDescriptorSet(*this->_pEngine, *this);
 		rayCastingCommandBuffer = std::move(this->_pEngine->context().device().allocateCommandBuffers(
 			vk::CommandBufferAllocateInfo()
@@ -927,15 +2253,12 @@ void KinectFusion::_createAlgorithmData(void) {
 			this->_pEngine->context().device(),
 			vk::FenceCreateInfo(vk::FenceCreateFlags(0))
 		);
-		jjyou::glsl::uvec3 buildLinearFunctionWorkGroupCount(
-			(framePyramid[0].texture(0).extent().width + KinectFusion::_buildLinearFunctionWorkGroupSize.x - 1U) / KinectFusion::_buildLinearFunctionWorkGroupSize.x,
-			(framePyramid[0].texture(0).extent().height + KinectFusion::_buildLinearFunctionWorkGroupSize.y - 1U) / KinectFusion::_buildLinearFunctionWorkGroupSize.y,
-			1U
-		);
-		icpDescriptorSet = ICPDescriptorSet(*this->_pEngine, *this, static_cast<vk::DeviceSize>(buildLinearFunctionWorkGroupCount.x * buildLinearFunctionWorkGroupCount.y * buildLinearFunctionWorkGroupCount.z));
+		// In the worst case, all pixels in the finest tracked level are valid.
+		std::uint32_t maxBuildLinearFunctionWorkGroupCount = (framePyramid[this->_trackingLevel].texture(0).extent().width * framePyramid[this->_trackingLevel].texture(0).extent().height + KinectFusion::_buildLinearFunctionWorkGroupSize.x - 1U) / KinectFusion::_buildLinearFunctionWorkGroupSize.x;
+		icpDescriptorSet = ICPDescriptorSet(*this->_pEngine, *this, maxBuildLinearFunctionWorkGroupCount);
 		icpCommandBuffer = std::move(this->_pEngine->context().device().allocateCommandBuffers(
 			vk::CommandBufferAllocateInfo()
-			.setCommandPool(*this->_pEngine->commandPool(jjyou::vk::Context::QueueType::Compute))
+			.setCommandPool(*this->_pEngine->commandPool(this->_trackingQueueType))
 			.setLevel(vk::CommandBufferLevel::ePrimary)
 			.setCommandBufferCount(1)
 		)[0]);
@@ -943,5 +2266,54 @@ void KinectFusion::_createAlgorithmData(void) {
 			this->_pEngine->context().device(),
 			vk::FenceCreateInfo(vk::FenceCreateFlags(0))
 		);
+		// Time the image-space kernels, if the tracking queue supports timestamps.
+		std::uint32_t queueFamilyIndex = *this->_pEngine->context().queueFamilyIndex(this->_trackingQueueType);
+		if (this->_pEngine->context().physicalDevice().getQueueFamilyProperties()[queueFamilyIndex].timestampValidBits != 0U) {
+			this->_poseEstimationAlgorithmData.timestampQueryPool = vk::raii::QueryPool(
+				this->_pEngine->context().device(),
+				vk::QueryPoolCreateInfo()
+				.setFlags(vk::QueryPoolCreateFlags(0))
+				.setQueryType(vk::QueryType::eTimestamp)
+				.setQueryCount(KinectFusion::_numTimestampQueries())
+				.setPipelineStatistics(vk::QueryPipelineStatisticFlags(0))
+			);
+		}
+	}
+
+	// Mesh bricks
+	{
+		vk::raii::CommandBuffer& commandBuffer = this->_meshBricksAlgorithmData.commandBuffer;
+		vk::raii::Fence& fence = this->_meshBricksAlgorithmData.fence;
+		vk::raii::Semaphore& graphicsFinishedSemaphore = this->_meshBricksAlgorithmData.graphicsFinishedSemaphore;
+		commandBuffer = std::move(this->_pEngine->context().device().allocateCommandBuffers(
+			vk::CommandBufferAllocateInfo()
+			.setCommandPool(*this->_pEngine->commandPool(jjyou::vk::Context::QueueType::Compute))
+			.setLevel(vk::CommandBufferLevel::ePrimary)
+			.setCommandBufferCount(1)
+		)[0]);
+		fence = vk::raii::Fence(
+			this->_pEngine->context().device(),
+			vk::FenceCreateInfo(vk::FenceCreateFlags(0))
+		);
+		graphicsFinishedSemaphore = vk::raii::Semaphore(
+			this->_pEngine->context().device(),
+			vk::SemaphoreCreateInfo(vk::SemaphoreCreateFlags(0))
+		);
+	}
+
+	// Extract point cloud
+	{
+		vk::raii::CommandBuffer& commandBuffer = this->_extractPointCloudAlgorithmData.commandBuffer;
+		vk::raii::Fence& fence = this->_extractPointCloudAlgorithmData.fence;
+		commandBuffer = std::move(this->_pEngine->context().device().allocateCommandBuffers(
+			vk::CommandBufferAllocateInfo()
+			.setCommandPool(*this->_pEngine->commandPool(jjyou::vk::Context::QueueType::Compute))
+			.setLevel(vk::CommandBufferLevel::ePrimary)
+			.setCommandBufferCount(1)
+		)[0]);
+		fence = vk::raii::Fence(
+			this->_pEngine->context().device(),
+			vk::FenceCreateInfo(vk::FenceCreateFlags(0))
+		);
 	}
 }
\ No newline at end of file
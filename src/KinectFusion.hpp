@@ -1,8 +1,12 @@
 #pragma once
 #include "TSDFVolume.hpp"
+#include "MeshCache.hpp"
 #include "Engine.hpp"
 #include "Camera.hpp"
 #include "PyramidData.hpp"
+#include "Metrics.hpp"
+#include <filesystem>
+#include <chrono>
 
 /***********************************************************************
  * @class	KinectFusion
@@ -14,10 +18,16 @@
  *  - Perform ray casting to get a surface (color, depth, normal).
  *  - Estimate the relative transform of a new frame w.r.t. the last frame.
  *  - Fuse a new frame into the global model.
+ *  - Keep a triangle mesh of the model up to date (optional).
+ *  - Export the model as an oriented point cloud.
+ *  - Save the model to a file and load it for localization.
  * All computations are synchronized with the CPU. That is, after each
  * command buffer submission, the CPU waits for a fence.
  * I tried to make the computations asynchronous but found this will make
  * it difficult to decouple this class from the Vulkan Engine class.
+ * The only exception is pipelined tracking: `beginFuse` returns before
+ * fusion ends, so that the next frame can be tracked on another queue
+ * against model maps ray casted before that fusion.
  ***********************************************************************/
 class KinectFusion {
 
@@ -31,6 +41,101 @@ public:
 	  */
 	static inline constexpr std::array<std::uint32_t, NUM_PYRAMID_LEVELS> NUM_ICP_ITERATIONS = { { 4, 5, 10 } };
 
+	/** @brief	ICP fails if the absolute value of the determinant of the linear system is smaller than this value.
+	  */
+	static inline constexpr float ICP_MIN_DETERMINANT = 50000.0f;
+
+	/** @brief	ICP fails if the norm of the pose increment of an iteration is larger than this value.
+	  */
+	static inline constexpr float ICP_MAX_INCREMENT = 0.15f;
+
+	/** @brief	ICP stops iterating in a pyramid level once the norm of the pose increment is smaller than this value.
+	  */
+	static inline constexpr float ICP_CONVERGENCE_THRESHOLD = 1e-5f;
+
+	/***********************************************************************
+	 * @class	PointCloudStatistics
+	 * @brief	Statistics of a point cloud export.
+	 ***********************************************************************/
+	struct PointCloudStatistics {
+		std::uint64_t numPoints = 0ULL;					//!< Number of exported points.
+		std::uint32_t numChunks = 0U;					//!< Number of chunks written to the file.
+		std::uint32_t numRetries = 0U;					//!< Number of chunks extracted again in smaller pieces because their points did not fit.
+		std::chrono::duration<double> extractionTime{};	//!< Time spent waiting for the GPU.
+		std::chrono::duration<double> writeWaitTime{};	//!< Time spent waiting for the file writes that did not overlap with extraction.
+		std::chrono::duration<double> totalTime{};		//!< Total time of the export.
+		std::uint64_t numBytes = 0ULL;					//!< Size of the file.
+	};
+
+	/***********************************************************************
+	 * @class	KernelTimes
+	 * @brief	GPU time of the image-space kernels in one call to `estimatePose`,
+	 *			summed over pyramid levels and ICP iterations.
+	 *
+	 * Each kernel is measured between two timestamps around its dispatch, so
+	 * the time includes waiting for the preceding barrier.
+	 ***********************************************************************/
+	struct KernelTimes {
+		std::chrono::duration<double> bilateralFiltering{};
+		std::chrono::duration<double> halfSampling{};
+		std::chrono::duration<double> compactValidPixels{};		//!< Compaction of the pixels with a valid depth.
+		std::chrono::duration<double> computeVertexMap{};
+		std::chrono::duration<double> computeNormalMap{};
+		std::chrono::duration<double> buildLinearFunction{};
+	};
+
+	/***********************************************************************
+	 * @class	HalfPrecisionComparison
+	 * @brief	Differences between the fp32 and the fp16 kernels on the same frame.
+	 *
+	 * Levels finer than the tracking level are not compared, and their entries are 0.
+	 ***********************************************************************/
+	struct HalfPrecisionComparison {
+		std::array<float, NUM_PYRAMID_LEVELS> maxDepthError{};					//!< Largest difference of depths valid in both, in meters.
+		std::array<float, NUM_PYRAMID_LEVELS> maxNormalError{};					//!< Largest angle between normals valid in both, in radians.
+		std::array<std::uint32_t, NUM_PYRAMID_LEVELS> numMismatchedPixels{};	//!< Number of pixels whose normal is valid in only one of them.
+		std::array<std::uint32_t, NUM_PYRAMID_LEVELS> numPixels{};				//!< Number of pixels of each level.
+		bool trackingMismatch = false;		//!< Whether ICP failed with only one of them.
+		float rotationError = 0.0f;			//!< Angle between the estimated camera orientations, in radians.
+		float translationError = 0.0f;		//!< Distance between the estimated camera positions, in meters.
+		KernelTimes fp32Times{};			//!< GPU time of the fp32 kernels. Zero if timestamps are not supported.
+		KernelTimes fp16Times{};			//!< GPU time of the fp16 kernels. Zero if timestamps are not supported.
+	};
+
+	/***********************************************************************
+	 * @class	ModelMapCacheStatistics
+	 * @brief	Statistics of the model map cache since the last `initTSDFVolume`
+	 *			or `loadTSDFVolume`.
+	 ***********************************************************************/
+	struct ModelMapCacheStatistics {
+		std::uint64_t numHits = 0ULL;		//!< Number of `estimatePose` calls that reused the model maps of a keyframe.
+		std::uint64_t numMisses = 0ULL;		//!< Number of `estimatePose` calls that ray casted the model maps.
+		std::uint64_t numEvictions = 0ULL;	//!< Number of keyframes replaced because the cache was full.
+		std::uint32_t numKeyframes = 0U;	//!< Number of cached keyframes.
+	};
+
+	/***********************************************************************
+	 * @class	PipelineTraits
+	 * @brief	Traits of a session that select the SPIR-V variant and the
+	 *			specialization constants of each pipeline.
+	 *
+	 * They are fixed when the pipelines are created, so the driver compiles
+	 * out the branches of the features that the session does not use.
+	 ***********************************************************************/
+	struct PipelineTraits {
+		bool sparseVolume = true;							//!< If false, the volume shaders skip the page table, whose pages are all resident. `TSDF_SPARSE_VOLUME` in `tsdfVolumeCommon.h`.
+		bool halfPrecision = false;							//!< Whether the image-space kernels use the fp16 SPIR-V variants. The fp16 pipelines are only created if set, or on demand by `compareHalfPrecision`.
+		jjyou::glsl::uvec2 fusionWorkGroupSize{ 32U, 32U };	//!< Local size of `fusion.comp`, whose work items are the (x, y) columns of the volume.
+	};
+
+	/** @brief	Tolerances of `HalfPrecisionComparison`, per frame.
+	  */
+	static inline constexpr float HALF_PRECISION_MAX_DEPTH_ERROR = 1e-3f;
+	static inline constexpr float HALF_PRECISION_MAX_NORMAL_ERROR = 0.0175f;
+	static inline constexpr float HALF_PRECISION_MAX_MISMATCHED_PIXEL_RATIO = 1e-3f;
+	static inline constexpr float HALF_PRECISION_MAX_ROTATION_ERROR = 0.0087f;
+	static inline constexpr float HALF_PRECISION_MAX_TRANSLATION_ERROR = 5e-3f;
+
 	/** @brief	Constructor.
 	  * @param	engine_				The Vulkan engine.
 	  * @param	truncationWeight_	Truncation weight in Eq. 13.
@@ -43,11 +148,35 @@ public:
 	  * @param	size_				Voxel size.
 	  * @param	corner_				The coordinate of the corner voxel's center point.
 	  * @param	truncationDistance_	Truncation distance.
+	  * @param	sparseVolume_		Whether to bind device memory only for the observed regions of the volume.
+	  * @param	trackingLevel_		The finest pyramid level used in pose estimation. Level `l` has
+	  *								`1/2^l` of the depth frame resolution. Finer levels are not allocated,
+	  *								and the input depth map is filtered directly at the tracking resolution.
+	  *								Fusion always uses the full-resolution depth map.
+	  * @param	meshCacheSlabs_		Number of slabs of the mesh cache. If positive, the bricks modified
+	  *								by each fusion are re-meshed, so that the mesh is always available.
+	  *								If 0, the mesh cache is disabled.
+	  * @param	pipelinedTracking_	Whether to build the frame pyramid and run ICP on the main queue, so
+	  *								that they overlap with a fusion started by `beginFuse` on the compute
+	  *								queue. The main queue must support compute.
+	  * @param	halfPrecision_		Whether to use the fp16 variants of bilateral filtering, half-sampling,
+	  *								normal map computation, and the row setup of ICP. They are only used if
+	  *								the engine has enabled `shaderFloat16`; otherwise, the fp32 kernels are used.
+	  * @param	colorBrickCapacity_	Number of color bricks of the volume's color pool.
+	  * @param	modelMapCacheSize_	Number of keyframes of the model map cache. If positive, the model maps ray
+	  *								casted by `estimatePose` are cached with their view, and reused by later frames
+	  *								whose initial view is within `modelMapCacheDistance_` and `modelMapCacheAngle_`
+	  *								of a keyframe. The cache is cleared whenever the volume changes, so it only pays
+	  *								off if frames are tracked without being fused, e.g. for localization in a loaded
+	  *								map. If 0, the model map cache is disabled.
+	  * @param	modelMapCacheDistance_	Maximal distance between the camera positions of a frame and a keyframe, in meters.
+	  * @param	modelMapCacheAngle_		Maximal angle between the camera orientations of a frame and a keyframe, in radians.
+	  * @param	fusionWorkGroupSize_	Work group size of fusion. It must be within the compute limits of the device.
 	  * 
 	  * For more information about `minDepth_`, `maxDepth_`, `invalidDepth_`,
 	  * refer to `DataLoader`.
-	  * For more information about `resolution_`, `size_`, `corner_`, `truncationDistance_`,
-	  * refer to `TSDFVolume`.
+	  * For more information about `resolution_`, `size_`, `corner_`, `truncationDistance_`, `sparseVolume_`,
+	  * `colorBrickCapacity_`, refer to `TSDFVolume`.
 	  */
 	KinectFusion(
 		// Vulkan resources
@@ -67,7 +196,17 @@ public:
 		const jjyou::glsl::uvec3& resolution_,
 		float size_,
 		std::optional<jjyou::glsl::vec3> corner_ = std::nullopt,
-		std::optional<float> truncationDistance_ = std::nullopt
+		std::optional<float> truncationDistance_ = std::nullopt,
+		bool sparseVolume_ = false,
+		std::uint32_t trackingLevel_ = 0U,
+		std::uint32_t meshCacheSlabs_ = 0U,
+		bool pipelinedTracking_ = false,
+		bool halfPrecision_ = false,
+		std::optional<std::uint32_t> colorBrickCapacity_ = std::nullopt,
+		std::uint32_t modelMapCacheSize_ = 0U,
+		float modelMapCacheDistance_ = 0.1f,
+		float modelMapCacheAngle_ = 0.1f,
+		const jjyou::glsl::uvec2& fusionWorkGroupSize_ = jjyou::glsl::uvec2(32U, 32U)
 	);
 
 	/** @brief	Disable copy/move constructor/assignment.
@@ -82,8 +221,10 @@ public:
 	~KinectFusion(void) = default;
 
 	/** @brief	Initialize/Reset the TSDF volume.
+	  *
+	  * If the volume is sparse, the device memory of the observed regions is released.
 	  */
-	void initTSDFVolume(void) const;
+	void initTSDFVolume(void);
 
 	/** @brief	Perform ray casting to get the color, depth, and normal map for visualization.
 	  * @param	surface_		Surface made up of color, depth, and normal textures.
@@ -109,6 +250,69 @@ public:
 		std::optional<float> marchingStep_ = std::nullopt
 	) const;
 
+	/** @brief	Record the ray casting of `rayCasting` into a command buffer, without submitting it.
+	  *
+	  * This lets the caller submit the ray casting together with its own commands (e.g. a download
+	  * of the surface) and poll its completion later.
+	  * @param	commandBuffer_	Command buffer in recording state. It must be submitted to the compute queue.
+	  * @param	descriptorSet_	Ray casting descriptor set owned by the caller. Its parameters must not
+	  *							change until the command buffer has completed.
+	  * @sa		`rayCasting` for the other parameters.
+	  */
+	void recordRayCasting(
+		const vk::raii::CommandBuffer& commandBuffer_,
+		const RayCastingDescriptorSet& descriptorSet_,
+		const Surface<Lambertian>& surface_,
+		const Camera& camera_,
+		const jjyou::glsl::mat4& view_,
+		float minDepth_,
+		float maxDepth_,
+		float invalidDepth_,
+		std::optional<float> marchingStep_ = std::nullopt
+	) const;
+
+	/** @brief	Perform ray casting for several views at once, e.g. thumbnails of several virtual
+	  *			cameras, a stereo pair, or the faces of a cube map.
+	  *
+	  * Up to `BatchRayCastingDescriptorSet::MAX_VIEWS` views are ray casted in one dispatch,
+	  * and all dispatches are submitted with one fence wait. The work groups of the same image
+	  * tile of all views are launched next to each other, so nearby views (e.g. a stereo pair)
+	  * read the bricks they share while these are still in the cache.
+	  * @param	surfaces_		Surfaces of the views, made up of color, depth, and normal textures.
+	  *							The surfaces must be distinct. Their extents may be different.
+	  * @param	cameras_		Camera instances of the views.
+	  * @param	views_			Camera view matrices of the views.
+	  * @sa		`rayCasting` for the other parameters, which are shared by all views.
+	  */
+	void batchRayCasting(
+		const std::vector<const Surface<Lambertian>*>& surfaces_,
+		const std::vector<Camera>& cameras_,
+		const std::vector<jjyou::glsl::mat4>& views_,
+		float minDepth_,
+		float maxDepth_,
+		float invalidDepth_,
+		std::optional<float> marchingStep_ = std::nullopt
+	) const;
+
+	/** @brief	Record the ray casting of `batchRayCasting` into a command buffer, without submitting it.
+	  * @param	commandBuffer_	Command buffer in recording state. It must be submitted to the compute queue.
+	  * @param	descriptorSets_	Batched ray casting descriptor sets owned by the caller, one per dispatch of
+	  *							`BatchRayCastingDescriptorSet::MAX_VIEWS` views. Missing ones are created.
+	  *							They must not be used by another command buffer until this one has completed.
+	  * @sa		`batchRayCasting` for the other parameters.
+	  */
+	void recordBatchRayCasting(
+		const vk::raii::CommandBuffer& commandBuffer_,
+		std::vector<BatchRayCastingDescriptorSet>& descriptorSets_,
+		const std::vector<const Surface<Lambertian>*>& surfaces_,
+		const std::vector<Camera>& cameras_,
+		const std::vector<jjyou::glsl::mat4>& views_,
+		float minDepth_,
+		float maxDepth_,
+		float invalidDepth_,
+		std::optional<float> marchingStep_ = std::nullopt
+	) const;
+
 	/** @brief	Estimate the view matrix of a new frame using frame-to-model tracking.
 	  * @param	surface_			Surface made up of color and depth maps. The color map is not used in this step.
 	  * @param	camera_				Camera instance for computing projection matrices. The matrices will be different for different levels.
@@ -119,7 +323,22 @@ public:
 	  * @param	filterKernelSize_	Bilateral filtering kernel size. Must be an odd number.
 	  * @param	distanceThreshold_	Distance threshold used in projective correspondence search. In meters.
 	  * @param	angleThreshold_		Angle threshold used in projective correspondence search. In radians.
+	  * @param	poseHypotheses_		Additional initial view matrices of the frame (e.g. constant velocity prediction).
+	  *								All hypotheses, including `initialView_`, are evaluated in the same dispatches
+	  *								in the coarsest pyramid level. Only the one with the most inliers is refined in
+	  *								the finer levels. The model maps are always ray casted from `initialView_`.
+	  *								At most `ICPDescriptorSet::MAX_NUM_HYPOTHESES - 1` hypotheses are supported.
+	  *								If the model map cache has a keyframe close to `initialView_`, its model maps
+	  *								are used instead.
+	  * @param	gravity_			Optional unit gravity direction of the frame in camera space.
+	  *								It is only used if the world gravity has been set by `fuse`. The initial
+	  *								views are not corrected. Use `alignGravity` to build a gravity-aligned hypothesis.
+	  * @param	gravityWeight_		Weight of the gravity alignment term added to the linear function,
+	  *								relative to one correspondence. If 0, the term is not added.
 	  * @return	The esimated view matrix for the frame. If the ICP failed, std::nullopt will be returned.
+	  * @note	If tracking is pipelined and `beginFuse` has predicted the model maps, they are used instead
+	  *			of ray casting the volume from `initialView_`, and a fusion may still be running. Otherwise,
+	  *			no fusion may be running.
 	  */
 	std::optional<jjyou::glsl::mat4> estimatePose(
 		const Surface<Simple>& surface_,
@@ -129,19 +348,189 @@ public:
 		float sigmaSpace_,
 		int filterKernelSize_,
 		float distanceThreshold_,
-		float angleThreshold_
+		float angleThreshold_,
+		const std::vector<jjyou::glsl::mat4>& poseHypotheses_ = {},
+		const std::optional<jjyou::glsl::vec3>& gravity_ = std::nullopt,
+		float gravityWeight_ = 0.0f
 	) const;
 
+	/** @brief	Run `estimatePose` once with the fp32 kernels and once with the fp16 kernels on the
+	  *			same frame, and compare the depth maps, the normal maps, and the estimated views.
+	  *
+	  * Requires `shaderFloat16`. Afterwards, the state of pose estimation (e.g. `numICPIterations`)
+	  * is the one of the fp16 run. The model map cache statistics count the two runs as one call.
+	  * @sa		`estimatePose` for the parameters.
+	  */
+	HalfPrecisionComparison compareHalfPrecision(
+		const Surface<Simple>& surface_,
+		const Camera& camera_,
+		const jjyou::glsl::mat4& initialView_,
+		float sigmaColor_,
+		float sigmaSpace_,
+		int filterKernelSize_,
+		float distanceThreshold_,
+		float angleThreshold_,
+		const std::vector<jjyou::glsl::mat4>& poseHypotheses_ = {},
+		const std::optional<jjyou::glsl::vec3>& gravity_ = std::nullopt,
+		float gravityWeight_ = 0.0f
+	) const;
+
+	/** @brief	Rotate a view about the camera center by the minimal rotation that takes the gravity
+	  *			direction predicted from the world gravity to the measured one. This corrects roll
+	  *			and pitch, and keeps yaw and the camera position.
+	  * @param	view_		The view matrix to correct.
+	  * @param	gravity_	Unit gravity direction of the frame in camera space.
+	  * @return	The corrected view matrix. std::nullopt if no world gravity has been set by `fuse`,
+	  *			or if the two directions are nearly opposite.
+	  */
+	std::optional<jjyou::glsl::mat4> alignGravity(const jjyou::glsl::mat4& view_, const jjyou::glsl::vec3& gravity_) const;
+
+	/** @brief	Get the GPU time of the image-space kernels in the last call to `estimatePose`.
+	  *
+	  * Returns std::nullopt if the queue of pose estimation does not support timestamps.
+	  */
+	std::optional<KernelTimes> kernelTimes(void) const;
+
+	/** @brief	Get the number of ICP iterations that updated the pose in the last call to `estimatePose`.
+	  */
+	std::uint32_t numICPIterations(void) const {
+		return this->_poseEstimationAlgorithmData.icpDescriptorSet.icpState().hypotheses[0].numIterations;
+	}
+
 	/** @brief	Fuse a new frame (color + depth) into the TSDF volume.
+	  *
+	  * If the mesh cache is enabled, the bricks modified by the frame are re-meshed afterwards.
 	  * @param	surface_		Surface made up of color and depth maps.
 	  * @param	camera_			Camera instance for computing the projection matrix.
 	  * @param	view_			Camera view matrix that transforms points from world space to camera space.
+	  * @param	gravity_		Optional unit gravity direction of the frame in camera space.
+	  *							The first one fused after `initTSDFVolume` sets the world gravity.
 	  */
 	void fuse(
 		const Surface<Simple>& surface_,
 		const Camera& camera_,
-		const jjyou::glsl::mat4& view_
-	) const;
+		const jjyou::glsl::mat4& view_,
+		const std::optional<jjyou::glsl::vec3>& gravity_ = std::nullopt
+	);
+
+	/** @brief	Start fusing a new frame without waiting for the GPU.
+	  *
+	  * Until `endFuse` is called, the surface must stay alive and the volume must not be accessed,
+	  * except by `estimatePose` with predicted model maps.
+	  * @param	predictModel_	Whether to ray cast the model maps of the next `estimatePose` from `view_`
+	  *							before fusing the frame. The ray casting is submitted to the compute queue
+	  *							ahead of the fusion, and the fusion waits for it with a pipeline barrier, so
+	  *							the maps show the volume without this frame. If false, the last predicted
+	  *							maps are kept. Requires pipelined tracking.
+	  * @sa		`fuse` for the other parameters.
+	  */
+	void beginFuse(
+		const Surface<Simple>& surface_,
+		const Camera& camera_,
+		const jjyou::glsl::mat4& view_,
+		const std::optional<jjyou::glsl::vec3>& gravity_,
+		bool predictModel_
+	);
+
+	/** @brief	Wait for the fusion started by `beginFuse`, if any, and update the mesh cache.
+	  */
+	void endFuse(void);
+
+	/** @brief	Check whether a fusion started by `beginFuse` has not ended.
+	  */
+	bool fusionPending(void) const {
+		return this->_fusionPending;
+	}
+
+	/** @brief	Check whether tracking is pipelined.
+	  */
+	bool pipelinedTracking(void) const {
+		return this->_pipelinedTracking;
+	}
+
+	/** @brief	Check whether the fp16 variants of the image-space kernels are used.
+	  */
+	bool halfPrecision(void) const {
+		return this->_halfPrecision;
+	}
+
+	/** @brief	Get the traits the pipelines were created with.
+	  */
+	const PipelineTraits& pipelineTraits(void) const {
+		return this->_pipelineTraits;
+	}
+
+	/** @brief	Check whether `beginFuse` has predicted the model maps of the next `estimatePose`.
+	  *
+	  * The prediction is dropped by `initTSDFVolume`.
+	  */
+	bool modelPredicted(void) const {
+		return this->_poseEstimationAlgorithmData.predictedModelView.has_value();
+	}
+
+	/** @brief	Extract the zero surface of the TSDF volume as an oriented point cloud and write it to a binary PLY file.
+	  *
+	  * Every voxel edge crossed by the zero surface generates a point with the interpolated normal and color.
+	  * The volume is extracted chunk by chunk (ranges of x slabs) into two host visible append buffers of
+	  * `stagingBudget_ / 2` bytes each. While the GPU extracts a chunk into one buffer, the points of the previous
+	  * chunk are written to the file from the other. A chunk whose points do not fit is extracted again in halves,
+	  * and each buffer holds at least one slab, so volumes larger than the staging budget are supported.
+	  * This function blocks until the file is written.
+	  * @param	path_			Output path.
+	  * @param	stagingBudget_	Total size of the two append buffers, in bytes.
+	  */
+	PointCloudStatistics exportPointCloud(const std::filesystem::path& path_, vk::DeviceSize stagingBudget_);
+
+	/** @brief	Save the TSDF volume to a file.
+	  *
+	  * The pending fusion, if any, is ended first. This function blocks until the file is written.
+	  * @sa		`TSDFVolume::save`.
+	  */
+	void saveTSDFVolume(const std::filesystem::path& path_);
+
+	/** @brief	Reinitialize the TSDF volume and load it from a file written by `saveTSDFVolume`.
+	  *
+	  * The volume must have the parameters of the saved one (see `TSDFVolume::readFileHeader`).
+	  * If the mesh cache is enabled, the whole volume is re-meshed. The model map cache is cleared.
+	  * This function blocks until the volume is loaded.
+	  */
+	void loadTSDFVolume(const std::filesystem::path& path_);
+
+	/** @brief	Whether the model map cache is enabled.
+	  */
+	bool modelMapCacheEnabled(void) const {
+		return this->_modelMapCache.capacity != 0U;
+	}
+
+	/** @brief	Get the statistics of the model map cache.
+	  */
+	const ModelMapCacheStatistics& modelMapCacheStatistics(void) const {
+		return this->_modelMapCache.statistics;
+	}
+
+	/** @brief	Get the gravity direction in world space, if any frame with gravity has been fused.
+	  */
+	const std::optional<jjyou::glsl::vec3>& worldGravity(void) const {
+		return this->_worldGravity;
+	}
+
+	/** @brief	Get the TSDF volume.
+	  */
+	const TSDFVolume& tsdfVolume(void) const {
+		return this->_tsdfVolume;
+	}
+
+	/** @brief	Get the mesh cache. It is in invalid state if the mesh cache is disabled.
+	  */
+	const MeshCache& meshCache(void) const {
+		return this->_meshCache;
+	}
+
+	/** @brief	Whether the mesh cache is enabled.
+	  */
+	bool meshCacheEnabled(void) const {
+		return this->_meshCache.numSlabs() != 0U;
+	}
 
 	/** @brief	Get the descriptor set layout for TSDF volume storage buffer.
 	  */
@@ -155,6 +544,12 @@ public:
 		return this->_rayCastingDescriptorSetLayout;
 	}
 
+	/** @brief	Get the descriptor set layout for batched ray casting.
+	  */
+	const vk::raii::DescriptorSetLayout& batchRayCastingDescriptorSetLayout(void) const {
+		return this->_batchRayCastingDescriptorSetLayout;
+	}
+
 	/** @brief	Get the descriptor set layout for fusion uniform buffer.
 	  */
 	const vk::raii::DescriptorSetLayout& fusionDescriptorSetLayout(void) const {
@@ -173,6 +568,48 @@ public:
 		return this->_icpDescriptorSetLayout;
 	}
 
+	/** @brief	Get the descriptor set layout for the validity bitmask and the valid pixel list.
+	  */
+	const vk::raii::DescriptorSetLayout& validPixelsDescriptorSetLayout(void) const {
+		return this->_validPixelsDescriptorSetLayout;
+	}
+
+	/** @brief	Get the descriptor set layout for the mesh cache.
+	  */
+	const vk::raii::DescriptorSetLayout& meshCacheDescriptorSetLayout(void) const {
+		return this->_meshCacheDescriptorSetLayout;
+	}
+
+	/** @brief	Get the descriptor set layout for the point cloud append buffer.
+	  */
+	const vk::raii::DescriptorSetLayout& pointCloudDescriptorSetLayout(void) const {
+		return this->_pointCloudDescriptorSetLayout;
+	}
+
+	/** @brief	Get the finest pyramid level used in pose estimation.
+	  */
+	std::uint32_t trackingLevel(void) const {
+		return this->_trackingLevel;
+	}
+
+	/** @brief	Get the ratio of valid pixels in each level of the frame pyramid,
+	  *			measured in the last call to `estimatePose`.
+	  *
+	  *			ICP work groups are only launched for valid pixels, so the cost of
+	  *			ICP is proportional to these ratios. The vertex and normal maps are
+	  *			only computed for the pixels with a valid depth. Levels finer than the tracking
+	  *			level are not used, and their ratios are 0.
+	  */
+	std::array<float, KinectFusion::NUM_PYRAMID_LEVELS> validPixelRatios(void) const;
+
+	/** @brief	Register the metrics of tracking and fusion in a registry, and update them from now on.
+	  *
+	  * `estimatePose` counts the ICP failures and records the ICP iterations. `endFuse` records
+	  * the time spent waiting for the fusion, and updates the occupancy of the volume.
+	  * @param	pMetrics_	The registry, which must outlive this instance, or nullptr to stop updating.
+	  */
+	void setMetrics(MetricsRegistry* pMetrics_);
+
 private:
 
 	const Engine* _pEngine = nullptr;
@@ -182,31 +619,58 @@ private:
 	const float _minDepth;
 	const float _maxDepth;
 	const float _invalidDepth;
+	const std::uint32_t _trackingLevel;
+	const bool _pipelinedTracking;
+	const jjyou::vk::Context::QueueType _trackingQueueType;	// Queue of the frame pyramid and ICP. Model ray casting and fusion always use the compute queue.
+	bool _fusionPending = false;
+	const bool _halfPrecision;
+	PipelineTraits _pipelineTraits{};
 	vk::raii::DescriptorSetLayout _tsdfVolumeDescriptorSetLayout{ nullptr };
 	vk::raii::DescriptorSetLayout _rayCastingDescriptorSetLayout{ nullptr };
+	vk::raii::DescriptorSetLayout _batchRayCastingDescriptorSetLayout{ nullptr };
 	vk::raii::DescriptorSetLayout _fusionDescriptorSetLayout{ nullptr };
 	vk::raii::DescriptorSetLayout _pyramidDataDescriptorSetLayout{ nullptr };
 	vk::raii::DescriptorSetLayout _icpDescriptorSetLayout{ nullptr };
+	vk::raii::DescriptorSetLayout _validPixelsDescriptorSetLayout{ nullptr };
+	vk::raii::DescriptorSetLayout _meshCacheDescriptorSetLayout{ nullptr };
+	vk::raii::DescriptorSetLayout _pointCloudDescriptorSetLayout{ nullptr };
 	TSDFVolume _tsdfVolume{ nullptr };
+	MeshCache _meshCache{ nullptr };
+	std::optional<jjyou::glsl::vec3> _worldGravity = std::nullopt;
 	vk::raii::PipelineLayout _initVolumePipelineLayout{ nullptr };
 	vk::raii::PipelineLayout _rayCastingPipelineLayout{ nullptr };
+	vk::raii::PipelineLayout _batchRayCastingPipelineLayout{ nullptr };
 	vk::raii::PipelineLayout _fusionPipelineLayout{ nullptr };
 	vk::raii::PipelineLayout _bilateralFilteringPipelineLayout{ nullptr };
 	vk::raii::PipelineLayout _rayCastingICPPipelineLayout{ nullptr };
 	vk::raii::PipelineLayout _computeVertexNormalMapPipelineLayout{ nullptr };
 	vk::raii::PipelineLayout _halfSamplingPipelineLayout{ nullptr };
+	vk::raii::PipelineLayout _compactValidPixelsPipelineLayout{ nullptr };
 	vk::raii::PipelineLayout _buildLinearFunctionPipelineLayout{ nullptr };
 	vk::raii::PipelineLayout _buildLinearFunctionReductionPipelineLayout{ nullptr };
+	vk::raii::PipelineLayout _solveLinearFunctionPipelineLayout{ nullptr };
+	vk::raii::PipelineLayout _meshBricksPipelineLayout{ nullptr };
+	vk::raii::PipelineLayout _extractPointCloudPipelineLayout{ nullptr };
 	vk::raii::Pipeline _initVolumePipeline{ nullptr };
 	vk::raii::Pipeline _rayCastingPipeline{ nullptr };
+	vk::raii::Pipeline _batchRayCastingPipeline{ nullptr };
 	vk::raii::Pipeline _fusionPipeline{ nullptr };
 	vk::raii::Pipeline _bilateralFilteringPipeline{ nullptr };
 	vk::raii::Pipeline _rayCastingICPPipeline{ nullptr };
 	vk::raii::Pipeline _computeVertexMapPipeline{ nullptr };
 	vk::raii::Pipeline _computeNormalMapPipeline{ nullptr };
 	vk::raii::Pipeline _halfSamplingPipeline{ nullptr };
+	vk::raii::Pipeline _compactValidPixelsPipeline{ nullptr };
 	vk::raii::Pipeline _buildLinearFunctionPipeline{ nullptr };
 	vk::raii::Pipeline _buildLinearFunctionReductionPipeline{ nullptr };
+	vk::raii::Pipeline _solveLinearFunctionPipeline{ nullptr };
+	vk::raii::Pipeline _meshBricksPipeline{ nullptr };
+	vk::raii::Pipeline _extractPointCloudPipeline{ nullptr };
+	// Half precision variants. Created by `_createHalfPrecisionPipelines`.
+	mutable vk::raii::Pipeline _bilateralFilteringFP16Pipeline{ nullptr };
+	mutable vk::raii::Pipeline _computeNormalMapFP16Pipeline{ nullptr };
+	mutable vk::raii::Pipeline _halfSamplingFP16Pipeline{ nullptr };
+	mutable vk::raii::Pipeline _buildLinearFunctionFP16Pipeline{ nullptr };
 
 	struct _InitVolumeAlgorithmData {
 		vk::raii::CommandBuffer commandBuffer{ nullptr };
@@ -215,6 +679,7 @@ private:
 
 	struct _RayCastingAlgorithmData {
 		RayCastingDescriptorSet descriptorSet{ nullptr };
+		mutable std::vector<BatchRayCastingDescriptorSet> batchDescriptorSets{};	// One per dispatch of `batchRayCasting`. Created on demand.
 		vk::raii::CommandBuffer commandBuffer{ nullptr };
 		vk::raii::Fence fence{ nullptr };
 	} _rayCastingAlgorithmData{};
@@ -228,6 +693,9 @@ private:
 	struct _PoseEstimationAlgorithmData {
 		std::array<PyramidData, KinectFusion::NUM_PYRAMID_LEVELS> framePyramid{ {PyramidData{nullptr}, PyramidData{nullptr}, PyramidData{nullptr}} };
 		std::array<PyramidData, KinectFusion::NUM_PYRAMID_LEVELS> modelPyramid{ {PyramidData{nullptr}, PyramidData{nullptr}, PyramidData{nullptr}} };
+		std::array<ValidPixelsDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS> frameDepthValidPixels{ {ValidPixelsDescriptorSet{nullptr}, ValidPixelsDescriptorSet{nullptr}, ValidPixelsDescriptorSet{nullptr}} };
+		std::array<ValidPixelsDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS> frameValidPixels{ {ValidPixelsDescriptorSet{nullptr}, ValidPixelsDescriptorSet{nullptr}, ValidPixelsDescriptorSet{nullptr}} };
+		std::array<ValidPixelsDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS> modelValidPixels{ {ValidPixelsDescriptorSet{nullptr}, ValidPixelsDescriptorSet{nullptr}, ValidPixelsDescriptorSet{nullptr}} };
 		vk::raii::CommandBuffer buildPyramidCommandBuffer{ nullptr };
 		vk::raii::Fence buildPyramidFence{ nullptr };
 		std::array<RayCastingDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS> rayCastingDescriptorSets{ { RayCastingDescriptorSet{nullptr}, RayCastingDescriptorSet{nullptr}, RayCastingDescriptorSet{nullptr} } };
@@ -236,13 +704,143 @@ private:
 		ICPDescriptorSet icpDescriptorSet{ nullptr };
 		vk::raii::CommandBuffer icpCommandBuffer{ nullptr };
 		vk::raii::Fence icpFence{ nullptr };
+		vk::raii::QueryPool timestampQueryPool{ nullptr };						// Timestamps around the image-space kernels. Empty if not supported.
+		std::optional<jjyou::glsl::mat4> predictedModelView = std::nullopt;	// View of the model maps ray casted by `beginFuse`.
+		mutable bool modelRayCastingPending = false;							// Whether `rayCastingFence` has not been waited for.
 	} _poseEstimationAlgorithmData{};
 
+	/** @brief	Model maps (all textures of the tracked levels of the model pyramid) ray casted from a keyframe.
+	  */
+	struct _ModelMapCacheEntry {
+		jjyou::glsl::mat4 view{};
+		Camera camera{};
+		std::uint64_t lastUse = 0ULL;
+		std::vector<Texture2D> textures{};
+	};
+
+	struct _ModelMapCache {
+		std::uint32_t capacity = 0U;
+		float maxDistance = 0.0f;
+		float maxAngle = 0.0f;
+		std::vector<_ModelMapCacheEntry> entries{};
+		std::uint64_t numUses = 0ULL;
+		ModelMapCacheStatistics statistics{};
+	};
+	mutable _ModelMapCache _modelMapCache{};	// Updated by `estimatePose`.
+
+	struct _Metrics {
+		MetricsRegistry::Counter* pICPFailures = nullptr;
+		MetricsRegistry::Histogram* pICPIterations = nullptr;
+		MetricsRegistry::Histogram* pFusionWaitTime = nullptr;
+		MetricsRegistry::Gauge* pResidentPages = nullptr;
+		MetricsRegistry::Gauge* pOccupancy = nullptr;
+		MetricsRegistry::Gauge* pAllocatedColorBricks = nullptr;
+	} _metrics{};	// All nullptr if no registry is set.
+
+	struct _MeshBricksAlgorithmData {
+		vk::raii::CommandBuffer commandBuffer{ nullptr };
+		vk::raii::Fence fence{ nullptr };
+		vk::raii::Semaphore graphicsFinishedSemaphore{ nullptr };	// Signaled once the submitted frames no longer draw the mesh.
+	} _meshBricksAlgorithmData{};
+
+	struct _ExtractPointCloudAlgorithmData {
+		vk::raii::CommandBuffer commandBuffer{ nullptr };
+		vk::raii::Fence fence{ nullptr };
+	} _extractPointCloudAlgorithmData{};
+
 	void _createDescriptorSetLayouts(void);
 	void _createPipelineLayouts(void);
 	void _createPipelines(void);
+
+	/** @brief	Create the fp16 variants of the image-space kernels, if not created yet. Requires `shaderFloat16`.
+	  */
+	void _createHalfPrecisionPipelines(void) const;
 	void _createAlgorithmData(void);
 
+	/** @brief	Re-mesh the given modified bricks and patch the mesh cache.
+	  */
+	void _updateMeshCache(const std::vector<std::uint32_t>& modifiedBricks_);
+
+	/** @brief	Drop all keyframes of the model map cache. Call it whenever the volume changes.
+	  */
+	void _clearModelMapCache(void);
+
+	/** @brief	Find the keyframe of the model map cache closest to `view_` within the thresholds.
+	  * @return	Index of the keyframe, or std::nullopt if there is none.
+	  */
+	std::optional<std::size_t> _findModelMaps(const Camera& camera_, const jjyou::glsl::mat4& view_) const;
+
+	/** @brief	Record copying the model pyramid into a new keyframe of the model map cache.
+	  *
+	  * If the cache is full, the least recently used keyframe is replaced.
+	  * Record it after `_recordModelRayCasting`.
+	  */
+	void _recordCacheModelMaps(const vk::raii::CommandBuffer& commandBuffer_, const Camera& camera_, const jjyou::glsl::mat4& view_) const;
+
+	/** @brief	Record copying the model maps of a keyframe into the model pyramid and compacting its valid pixels.
+	  *
+	  * It replaces `_recordModelRayCasting`.
+	  */
+	void _recordRestoreModelMaps(const vk::raii::CommandBuffer& commandBuffer_, std::size_t entry_) const;
+
+	/** @brief	Record clearing the validity bitmasks and valid pixel counters of the tracked levels.
+	  */
+	void _recordResetValidPixels(const vk::raii::CommandBuffer& commandBuffer_, const std::array<ValidPixelsDescriptorSet, KinectFusion::NUM_PYRAMID_LEVELS>& validPixels_) const;
+
+	/** @brief	Record compacting the valid pixels of a pyramid level.
+	  *
+	  *			A pixel is valid if its depth is valid when `depth_` is true,
+	  *			and if both its vertex and its normal are valid otherwise.
+	  */
+	void _recordCompactValidPixels(const vk::raii::CommandBuffer& commandBuffer_, const PyramidData& pyramidData_, const ValidPixelsDescriptorSet& validPixels_, bool depth_) const;
+
+	/** @brief	Record ray casting the model pyramid and its valid pixels from `view_`.
+	  */
+	void _recordModelRayCasting(const vk::raii::CommandBuffer& commandBuffer_, const Camera& camera_, const jjyou::glsl::mat4& view_) const;
+
+	/** @brief	Wait for the submitted model ray casting, if any.
+	  */
+	void _waitModelRayCasting(void) const;
+
+	/** @brief	Implementation of `estimatePose` with the fp32 or the fp16 image-space kernels.
+	  */
+	std::optional<jjyou::glsl::mat4> _estimatePose(
+		const Surface<Simple>& surface_,
+		const Camera& camera_,
+		const jjyou::glsl::mat4& initialView_,
+		float sigmaColor_,
+		float sigmaSpace_,
+		int filterKernelSize_,
+		float distanceThreshold_,
+		float angleThreshold_,
+		const std::vector<jjyou::glsl::mat4>& poseHypotheses_,
+		const std::optional<jjyou::glsl::vec3>& gravity_,
+		float gravityWeight_,
+		bool halfPrecision_
+	) const;
+
+	/** @brief	Index of the first of the two timestamps around a kernel dispatch in `estimatePose`.
+	  *
+	  * Bilateral filtering is followed by half-sampling, depth compaction, vertex map and normal map
+	  * computation of each level, and by `buildLinearFunction.comp` of each ICP iteration of each level.
+	  */
+	static constexpr std::uint32_t _bilateralFilteringTimestampQuery(void) { return 0U; }
+	static constexpr std::uint32_t _halfSamplingTimestampQuery(std::uint32_t level_) { return 2U + 2U * level_; }
+	static constexpr std::uint32_t _compactValidPixelsTimestampQuery(std::uint32_t level_) { return 2U + 2U * KinectFusion::NUM_PYRAMID_LEVELS + 2U * level_; }
+	static constexpr std::uint32_t _computeVertexMapTimestampQuery(std::uint32_t level_) { return 2U + 4U * KinectFusion::NUM_PYRAMID_LEVELS + 2U * level_; }
+	static constexpr std::uint32_t _computeNormalMapTimestampQuery(std::uint32_t level_) { return 2U + 6U * KinectFusion::NUM_PYRAMID_LEVELS + 2U * level_; }
+	static constexpr std::uint32_t _buildLinearFunctionTimestampQuery(std::uint32_t level_, std::uint32_t iteration_) {
+		std::uint32_t query = 2U + 8U * KinectFusion::NUM_PYRAMID_LEVELS;
+		for (std::uint32_t level = 0; level < level_; ++level)
+			query += 2U * KinectFusion::NUM_ICP_ITERATIONS[level];
+		return query + 2U * iteration_;
+	}
+	static constexpr std::uint32_t _numTimestampQueries(void) { return KinectFusion::_buildLinearFunctionTimestampQuery(KinectFusion::NUM_PYRAMID_LEVELS, 0U); }
+
+	/** @brief	Extract the points of the x slabs in [beginX_, endX_) into `pointCloud_`.
+	  */
+	void _extractPointCloudChunk(const PointCloudDescriptorSet& pointCloud_, std::uint32_t beginX_, std::uint32_t endX_);
+
 	/** @brief	Push constants.
 	  */
 	struct _BilateralFilteringParameters {
@@ -252,6 +850,7 @@ private:
 		float minDepth;
 		float maxDepth;
 		float invalidDepth;
+		int stride;			//!< Output pixel (x, y) is centered at input pixel (x, y) * stride.
 	};
 	struct _HalfSamplingParameters {
 		float sigmaColor;	//!< The sigma value controlling the color term in bilateral filtering.
@@ -259,20 +858,32 @@ private:
 	struct _CameraIntrinsics {
 		float fx, fy, cx, cy;
 	};
-	struct _GlobalSumBufferLength {
-		std::uint32_t len;
+	struct _CompactValidPixelsParameters {
+		std::uint32_t depth;			//!< 1 to test the depth map, 0 to test the vertex map and the normal map.
+	};
+	struct _ICPLevel {
+		std::uint32_t level;			//!< The pyramid level. Selects the camera intrinsics in `ICPParameters`.
+	};
+	struct _SolveParameters {
+		std::uint32_t beginNextLevel;	//!< Whether the next iteration starts a new pyramid level.
+	};
+	struct _ExtractPointCloudParameters {
+		std::uint32_t beginX;			//!< First x slab of the chunk.
+		std::uint32_t endX;				//!< One past the last x slab of the chunk.
+		std::uint32_t capacity;			//!< Capacity of the append buffer.
 	};
 
 	/** @brief	Work group size (local size of compute shaders).
 	  */
 	static inline constexpr jjyou::glsl::uvec3 _initVolumeWorkGroupSize{ 32U, 32U, 1U };
 	static inline constexpr jjyou::glsl::uvec3 _rayCastingWorkGroupSize{ 32U, 32U, 1U };
-	static inline constexpr jjyou::glsl::uvec3 _fusionWorkGroupSize{ 32U, 32U, 1U };
+	static inline constexpr jjyou::glsl::uvec3 _batchRayCastingWorkGroupSize{ 32U, 32U, 1U };
 	static inline constexpr jjyou::glsl::uvec3 _bilateralFilteringWorkGroupSize{ 32U, 32U, 1U };
 	static inline constexpr jjyou::glsl::uvec3 _halfSamplingWorkGroupSize{ 32U, 32U, 1U };
-	static inline constexpr jjyou::glsl::uvec3 _computeVertexMapWorkGroupSize{ 32U, 32U, 1U };
-	static inline constexpr jjyou::glsl::uvec3 _computeNormalMapWorkGroupSize{ 32U, 32U, 1U };
 	static inline constexpr jjyou::glsl::uvec3 _rayCastingICPWorkGroupSize{ 32U, 32U, 1U };
-	static inline constexpr jjyou::glsl::uvec3 _buildLinearFunctionWorkGroupSize{ 32U, 32U, 1U };
+	static inline constexpr jjyou::glsl::uvec3 _compactValidPixelsWorkGroupSize{ 32U, 32U, 1U };
+	static inline constexpr jjyou::glsl::uvec3 _buildLinearFunctionWorkGroupSize{ 1024U, 1U, 1U };
 	static inline constexpr jjyou::glsl::uvec3 _buildLinearFunctionReductionWorkGroupSize{ 1024U, 1U, 1U };
+	static inline constexpr jjyou::glsl::uvec3 _solveLinearFunctionWorkGroupSize{ ICPDescriptorSet::MAX_NUM_HYPOTHESES, 1U, 1U };
+	static inline constexpr jjyou::glsl::uvec3 _extractPointCloudWorkGroupSize{ 8U, 8U, 8U };
 };
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include "MapStream.hpp"
+#include "Engine.hpp"
+#include "KinectFusion.hpp"
+#include <algorithm>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+#include <cstring>
+
+#define VK_THROW(err) \
+	throw std::runtime_error("[MapPublisher] Vulkan error in file " + std::string(__FILE__) + " line " + std::to_string(__LINE__) + ": " + vk::to_string(err))
+
+#define VK_CHECK(value) \
+	if (vk::Result err = (value); err != vk::Result::eSuccess) { VK_THROW(err); }
+
+MapPublisher::MapPublisher(const Engine& engine_, const KinectFusion& kinectFusion_, const Parameters& parameters_) :
+	_pEngine(&engine_),
+	_pKinectFusion(&kinectFusion_),
+	_parameters(parameters_)
+{
+	if (!kinectFusion_.meshCacheEnabled()) {
+		throw std::logic_error("[MapPublisher] The mesh cache must be enabled.");
+	}
+	// A slot must hold at least the header, the thumbnail, and one full brick.
+	std::size_t minSlotSize =
+		sizeof(MapStream::FrameHeader) +
+		4ULL * parameters_.thumbnailSize * parameters_.thumbnailSize +
+		sizeof(MapStream::BrickHeader) + sizeof(Vertex<MaterialType::Lambertian>) * 3ULL * MeshCache::MAX_TRIANGLES_PER_BRICK;
+	if (parameters_.slotSize < minSlotSize) {
+		throw std::logic_error("[MapPublisher] The slot size must be at least " + std::to_string(minSlotSize) + " bytes.");
+	}
+	this->_ring = SharedMemoryRing(parameters_.name, parameters_.numSlots, parameters_.slotSize);
+	this->_brickStates.resize(kinectFusion_.tsdfVolume().numBricks(), _BrickState::Idle);
+	// The payload of a version without its headers never exceeds a slot, so a slot-sized staging buffer always fits it.
+	std::vector<vk::raii::CommandBuffer> commandBuffers = engine_.context().device().allocateCommandBuffers(
+		vk::CommandBufferAllocateInfo()
+		.setCommandPool(*engine_.commandPool(jjyou::vk::Context::QueueType::Compute))
+		.setLevel(vk::CommandBufferLevel::ePrimary)
+		.setCommandBufferCount(MapPublisher::NUM_STAGING_FRAMES)
+	);
+	for (std::uint32_t i = 0; i < MapPublisher::NUM_STAGING_FRAMES; ++i) {
+		_StagingFrame& stagingFrame = this->_stagingFrames[i];
+		stagingFrame.commandBuffer = std::move(commandBuffers[i]);
+		stagingFrame.fence = vk::raii::Fence(engine_.context().device(), vk::FenceCreateInfo(vk::FenceCreateFlags(0)));
+		if (parameters_.thumbnailSize != 0U) {
+			stagingFrame.thumbnail = Surface<MaterialType::Lambertian>(engine_);
+			stagingFrame.batchRayCastingDescriptorSets.emplace_back(engine_, kinectFusion_);
+		}
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(static_cast<vk::DeviceSize>(parameters_.slotSize))
+			.setUsage(vk::BufferUsageFlagBits::eTransferDst)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer stagingBuffer = nullptr;
+		VmaAllocation stagingBufferMemory = nullptr;
+		VmaAllocationInfo allocationInfo{};
+		vmaCreateBuffer(*engine_.allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &stagingBuffer, &stagingBufferMemory, &allocationInfo);
+		stagingFrame.stagingBuffer = vk::raii::Buffer(engine_.context().device(), stagingBuffer);
+		stagingFrame.stagingBufferMemory = jjyou::vk::VmaAllocation(engine_.allocator(), stagingBufferMemory);
+		stagingFrame.stagingBufferMappedAddress = reinterpret_cast<const std::byte*>(allocationInfo.pMappedData);
+	}
+}
+
+MapPublisher::~MapPublisher(void) {
+	if (this->_pEngine != nullptr)
+		this->_writeCompletedVersions(true);
+}
+
+void MapPublisher::publish(std::uint32_t frameIndex_, const Camera& camera_, const jjyou::glsl::mat4& view_) {
+	std::chrono::steady_clock::time_point publishBegin = std::chrono::steady_clock::now();
+	this->_writeCompletedVersions(false);
+	// Reuse the oldest staging frame. Only wait if its downloads are still running.
+	if (this->_stagingFrames[this->_stagingFrameIndex].pending)
+		this->_writeCompletedVersions(true);
+	_StagingFrame& stagingFrame = this->_stagingFrames[this->_stagingFrameIndex];
+	const MeshCache& meshCache = this->_pKinectFusion->meshCache();
+	for (std::uint32_t brick : meshCache.updatedBricks()) {
+		if (this->_brickStates[brick] == _BrickState::Pending)
+			continue;
+		this->_brickStates[brick] = _BrickState::Pending;
+		this->_pendingBricks.push_back(brick);
+	}
+	std::size_t size = sizeof(MapStream::FrameHeader);
+	MapStream::FrameHeader& header = stagingFrame.header;
+	header = MapStream::FrameHeader{};
+	header.frameIndex = frameIndex_;
+	header.epoch = this->_epoch;
+	header.view = view_;
+	header.camera = camera_;
+	header.camera.width = 0U;
+	header.camera.height = 0U;
+	if (this->_parameters.thumbnailSize != 0U) {
+		header.camera = camera_;
+		header.camera.scaleToFit(this->_parameters.thumbnailSize, this->_parameters.thumbnailSize);
+		size += MapStream::thumbnailSize(header);
+	}
+	// Select the changed bricks in order, as far as they fit.
+	std::vector<std::uint32_t>& bricks = stagingFrame.bricks;
+	bricks.clear();
+	std::size_t capacity = this->_ring.slotSize() - size;
+	auto brickSize = [&meshCache](std::uint32_t brick_) {
+		return sizeof(MapStream::BrickHeader) + sizeof(Vertex<MaterialType::Lambertian>) * 3ULL * meshCache.brickNumTriangles(brick_);
+	};
+	while (!this->_pendingBricks.empty() && brickSize(this->_pendingBricks.front()) <= capacity) {
+		std::uint32_t brick = this->_pendingBricks.front();
+		this->_pendingBricks.pop_front();
+		capacity -= brickSize(brick);
+		this->_brickStates[brick] = _BrickState::Selected;
+		bricks.push_back(brick);
+	}
+	// Resend a few unchanged bricks in round robin order.
+	stagingFrame.numRefreshedBricks = 0U;
+	std::uint32_t numAllocatedSlabs = meshCache.numAllocatedSlabs();
+	for (std::uint32_t i = 0; i < numAllocatedSlabs && stagingFrame.numRefreshedBricks < this->_parameters.numRefreshBricks; ++i) {
+		if (this->_refreshSlab >= numAllocatedSlabs) {
+			this->_refreshSlab = 0U;
+			++this->_refreshCycle;
+		}
+		std::uint32_t brick = meshCache.slabBrick(this->_refreshSlab);
+		if (brick != MeshCache::INVALID_SLAB && this->_brickStates[brick] == _BrickState::Idle) {
+			if (brickSize(brick) > capacity)
+				break;
+			capacity -= brickSize(brick);
+			this->_brickStates[brick] = _BrickState::Selected;
+			bricks.push_back(brick);
+			++stagingFrame.numRefreshedBricks;
+		}
+		++this->_refreshSlab;
+	}
+	if (numAllocatedSlabs == 0U)
+		++this->_refreshCycle;
+	header.refreshCycle = this->_refreshCycle;
+	header.numBricks = static_cast<std::uint32_t>(bricks.size());
+	header.numMeshedBricks = meshCache.statistics().numUsedSlabs;
+	header.numPendingBricks = static_cast<std::uint32_t>(this->_pendingBricks.size());
+
+	// Record the thumbnail ray casting and the downloads into the staging buffer.
+	const vk::raii::CommandBuffer& commandBuffer = stagingFrame.commandBuffer;
+	commandBuffer.begin(
+		vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	// The volume and the mesh were written by fusion and re-meshing.
+	commandBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eComputeShader,
+		vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer,
+		vk::DependencyFlags(0),
+		vk::MemoryBarrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eTransferRead),
+		nullptr,
+		nullptr
+	);
+	vk::DeviceSize thumbnailSize = 0ULL;
+	if (this->_parameters.thumbnailSize != 0U) {
+		vk::Extent2D extent(header.camera.width, header.camera.height);
+		if (stagingFrame.thumbnail.texture(0).extent() != extent)
+			stagingFrame.thumbnail.createTextures({ {extent, extent, extent} }, std::nullopt, false);
+		this->_pKinectFusion->recordBatchRayCasting(commandBuffer, stagingFrame.batchRayCastingDescriptorSets, { &stagingFrame.thumbnail }, { header.camera }, { view_ }, camera_.zNear, camera_.zFar, camera_.zFar, std::nullopt);
+		commandBuffer.pipelineBarrier(
+			vk::PipelineStageFlagBits::eComputeShader,
+			vk::PipelineStageFlagBits::eTransfer,
+			vk::DependencyFlags(0),
+			vk::MemoryBarrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eTransferRead),
+			nullptr,
+			nullptr
+		);
+		commandBuffer.copyImageToBuffer(
+			*stagingFrame.thumbnail.texture(0).image(),
+			vk::ImageLayout::eGeneral,
+			*stagingFrame.stagingBuffer,
+			vk::BufferImageCopy()
+			.setBufferOffset(0)
+			.setBufferRowLength(0)
+			.setBufferImageHeight(0)
+			.setImageSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
+			.setImageOffset(vk::Offset3D(0, 0, 0))
+			.setImageExtent(vk::Extent3D(extent, 1))
+		);
+		thumbnailSize = static_cast<vk::DeviceSize>(MapStream::thumbnailSize(header));
+	}
+	stagingFrame.brickNumVertices = meshCache.recordDownloadBricks(commandBuffer, bricks, *stagingFrame.stagingBuffer, thumbnailSize);
+	commandBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eTransfer,
+		vk::PipelineStageFlagBits::eHost,
+		vk::DependencyFlags(0),
+		vk::MemoryBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead),
+		nullptr,
+		nullptr
+	);
+	commandBuffer.end();
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(*commandBuffer)
+		.setSignalSemaphores(nullptr),
+		*stagingFrame.fence
+	);
+	stagingFrame.pending = true;
+	this->_stagingFrameIndex = (this->_stagingFrameIndex + 1U) % MapPublisher::NUM_STAGING_FRAMES;
+	this->_statistics.publishTime = std::chrono::steady_clock::now() - publishBegin;
+}
+
+void MapPublisher::flush(void) {
+	this->_writeCompletedVersions(true);
+}
+
+void MapPublisher::reset(void) {
+	this->_writeCompletedVersions(true);
+	std::fill(this->_brickStates.begin(), this->_brickStates.end(), _BrickState::Idle);
+	this->_pendingBricks.clear();
+	this->_refreshSlab = 0U;
+	++this->_epoch;
+}
+
+void MapPublisher::_writeCompletedVersions(bool wait_) {
+	for (std::uint32_t i = 0; i < MapPublisher::NUM_STAGING_FRAMES; ++i) {
+		_StagingFrame& stagingFrame = this->_stagingFrames[(this->_stagingFrameIndex + i) % MapPublisher::NUM_STAGING_FRAMES];
+		if (!stagingFrame.pending)
+			continue;
+		// Versions are written in submission order, so a running version holds back the later ones.
+		if (wait_) {
+			VK_CHECK(this->_pEngine->waitForFences(*stagingFrame.fence));
+		}
+		else if (stagingFrame.fence.getStatus() != vk::Result::eSuccess)
+			break;
+		this->_pEngine->context().device().resetFences(*stagingFrame.fence);
+		stagingFrame.commandBuffer.reset(vk::CommandBufferResetFlags(0));
+		stagingFrame.pending = false;
+		const MapStream::FrameHeader& header = stagingFrame.header;
+		std::byte* pPayload = this->_ring.beginWrite();
+		std::memcpy(pPayload, &header, sizeof(header));
+		std::size_t size = sizeof(header);
+		std::size_t thumbnailSize = MapStream::thumbnailSize(header);
+		if (thumbnailSize != 0U)
+			std::memcpy(pPayload + size, stagingFrame.stagingBufferMappedAddress, thumbnailSize);
+		size += thumbnailSize;
+		const std::byte* pVertices = stagingFrame.stagingBufferMappedAddress + thumbnailSize;
+		for (std::size_t b = 0; b < stagingFrame.bricks.size(); ++b) {
+			std::uint32_t brick = stagingFrame.bricks[b];
+			MapStream::BrickHeader brickHeader{ .brick = brick, .numVertices = stagingFrame.brickNumVertices[b] };
+			std::memcpy(pPayload + size, &brickHeader, sizeof(brickHeader));
+			size += sizeof(brickHeader);
+			std::size_t verticesSize = sizeof(Vertex<MaterialType::Lambertian>) * brickHeader.numVertices;
+			if (verticesSize != 0U)
+				std::memcpy(pPayload + size, pVertices, verticesSize);
+			pVertices += verticesSize;
+			size += verticesSize;
+			// A brick changed again since it was selected stays pending.
+			if (this->_brickStates[brick] == _BrickState::Selected)
+				this->_brickStates[brick] = _BrickState::Idle;
+		}
+		this->_statistics.version = this->_ring.endWrite(size);
+		this->_statistics.numBricks = header.numBricks;
+		this->_statistics.numRefreshedBricks = stagingFrame.numRefreshedBricks;
+		this->_statistics.numPendingBricks = header.numPendingBricks;
+		this->_statistics.numBytes = size;
+	}
+}
+
+MapSubscriber::MapSubscriber(const std::string& name_) :
+	_ring(name_)
+{}
+
+bool MapSubscriber::update(void) {
+	std::optional<std::uint64_t> version = this->_ring.read(this->_version, this->_payload);
+	if (!version.has_value())
+		return false;
+	if (this->_version != 0ULL)
+		this->_numSkippedVersions += *version - this->_version - 1ULL;
+	this->_version = *version;
+	// Versions are produced by `MapPublisher`, but the sizes are still checked so that a corrupted version cannot overflow.
+	std::size_t offset = 0U;
+	auto read = [this, &offset](void* data_, std::size_t size_) {
+		if (offset + size_ > this->_payload.size()) {
+			throw std::runtime_error("[MapSubscriber] Version " + std::to_string(this->_version) + " is truncated.");
+		}
+		std::memcpy(data_, this->_payload.data() + offset, size_);
+		offset += size_;
+	};
+	this->_changedSlabs.clear();
+	MapStream::FrameHeader header{};
+	read(&header, sizeof(header));
+	if (this->_header.has_value() && this->_header->epoch != header.epoch) {
+		for (const auto& [index, brick] : this->_bricks)
+			this->_freeSlab(brick);
+		this->_bricks.clear();
+	}
+	this->_thumbnail.resize(MapStream::thumbnailSize(header));
+	read(this->_thumbnail.data(), this->_thumbnail.size());
+	std::vector<Vertex<MaterialType::Lambertian>> vertices{};
+	for (std::uint32_t i = 0; i < header.numBricks; ++i) {
+		MapStream::BrickHeader brickHeader{};
+		read(&brickHeader, sizeof(brickHeader));
+		if (brickHeader.numVertices > MapStream::MAX_VERTICES_PER_BRICK) {
+			throw std::runtime_error("[MapSubscriber] Brick " + std::to_string(brickHeader.brick) + " of version " + std::to_string(this->_version) + " does not fit in a slab.");
+		}
+		vertices.resize(brickHeader.numVertices);
+		read(vertices.data(), sizeof(Vertex<MaterialType::Lambertian>) * brickHeader.numVertices);
+		auto it = this->_bricks.find(brickHeader.brick);
+		if (brickHeader.numVertices == 0U) {
+			if (it != this->_bricks.end()) {
+				this->_freeSlab(it->second);
+				this->_bricks.erase(it);
+			}
+			continue;
+		}
+		if (it == this->_bricks.end())
+			it = this->_bricks.emplace(brickHeader.brick, _Brick{ .slab = this->_allocateSlab() }).first;
+		it->second.refreshCycle = header.refreshCycle;
+		this->_writeSlab(it->second, vertices.data(), brickHeader.numVertices);
+	}
+	// Bricks whose removal was skipped are not refreshed anymore.
+	std::erase_if(this->_bricks, [this, &header](const auto& brick_) {
+		if (brick_.second.refreshCycle + 2U >= header.refreshCycle)
+			return false;
+		this->_freeSlab(brick_.second);
+		return true;
+	});
+	this->_header = header;
+	return true;
+}
+
+std::uint32_t MapSubscriber::_allocateSlab(void) {
+	if (this->_freeSlabs.empty()) {
+		std::uint32_t slab = static_cast<std::uint32_t>(this->_mesh.size() / MapStream::MAX_VERTICES_PER_BRICK);
+		this->_mesh.resize(this->_mesh.size() + MapStream::MAX_VERTICES_PER_BRICK, Vertex<MaterialType::Lambertian>{});
+		return slab;
+	}
+	std::pop_heap(this->_freeSlabs.begin(), this->_freeSlabs.end(), std::greater<std::uint32_t>());
+	std::uint32_t slab = this->_freeSlabs.back();
+	this->_freeSlabs.pop_back();
+	return slab;
+}
+
+void MapSubscriber::_writeSlab(_Brick& brick_, const Vertex<MaterialType::Lambertian>* vertices_, std::uint32_t numVertices_) {
+	auto first = this->_mesh.begin() + static_cast<std::ptrdiff_t>(brick_.slab) * MapStream::MAX_VERTICES_PER_BRICK;
+	std::copy(vertices_, vertices_ + numVertices_, first);
+	if (numVertices_ < brick_.numVertices)
+		std::fill(first + numVertices_, first + brick_.numVertices, Vertex<MaterialType::Lambertian>{});
+	this->_numVertices = this->_numVertices + numVertices_ - brick_.numVertices;
+	brick_.numVertices = numVertices_;
+	this->_changedSlabs.push_back(brick_.slab);
+}
+
+void MapSubscriber::_freeSlab(const _Brick& brick_) {
+	auto first = this->_mesh.begin() + static_cast<std::ptrdiff_t>(brick_.slab) * MapStream::MAX_VERTICES_PER_BRICK;
+	std::fill(first, first + brick_.numVertices, Vertex<MaterialType::Lambertian>{});
+	this->_numVertices -= brick_.numVertices;
+	this->_freeSlabs.push_back(brick_.slab);
+	std::push_heap(this->_freeSlabs.begin(), this->_freeSlabs.end(), std::greater<std::uint32_t>());
+	this->_changedSlabs.push_back(brick_.slab);
+}
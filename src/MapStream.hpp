@@ -0,0 +1,332 @@
+#pragma once
+#include <vulkan/vulkan_raii.hpp>
+#include <jjyou/vk/Vulkan.hpp>
+#include <jjyou/glsl/glsl.hpp>
+#include <array>
+#include <vector>
+#include <deque>
+#include <string>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <cstdint>
+#include "SharedMemoryRing.hpp"
+#include "Camera.hpp"
+#include "Primitives.hpp"
+#include "MeshCache.hpp"
+#include "Texture.hpp"
+#include "DescriptorSet.hpp"
+
+class Engine;
+class KinectFusion;
+
+/***********************************************************************
+ * @class	MapStream
+ * @brief	Format of the map versions passed from `MapPublisher` to
+ *			`MapSubscriber` through a `SharedMemoryRing`.
+ *
+ * A version starts with a `FrameHeader`, followed by the RGBA pixels of
+ * the thumbnail ray casted from the current pose, and by the mesh of some
+ * bricks of the mesh cache, each as a `BrickHeader` followed by its
+ * vertices (3 per triangle). A brick with no vertices has lost its
+ * surface.
+ *
+ * A version only carries the bricks changed since the previous version
+ * (as far as they fit in a slot) and a few unchanged bricks in round
+ * robin order, so that subscribers that skip versions still converge:
+ * every meshed brick is sent at least once per refresh cycle. Subscribers
+ * drop the bricks not received for two refresh cycles, and clear the map
+ * when the epoch changes (i.e. the volume was reset).
+ ***********************************************************************/
+class MapStream {
+
+public:
+
+	/** @brief	Header of a version.
+	  */
+	struct FrameHeader {
+		std::uint32_t frameIndex;		//!< Index of the last fused frame.
+		std::uint32_t epoch;			//!< Incremented when the volume is reset.
+		std::uint32_t refreshCycle;		//!< Incremented when the round robin refresh wraps around.
+		std::uint32_t numBricks;		//!< Number of bricks in this version.
+		std::uint32_t numMeshedBricks;	//!< Number of bricks with a surface in the publisher.
+		std::uint32_t numPendingBricks;	//!< Number of changed bricks that did not fit in this version.
+		jjyou::glsl::mat4 view;			//!< View matrix of the last fused frame.
+		Camera camera;					//!< Camera of the thumbnail. Its extent is the thumbnail extent, or 0 without a thumbnail.
+	};
+
+	/** @brief	Header of the mesh of a brick.
+	  */
+	struct BrickHeader {
+		std::uint32_t brick;			//!< Brick index in the TSDF volume.
+		std::uint32_t numVertices;		//!< Number of vertices that follow, 3 per triangle.
+	};
+
+	/** @brief	Maximal number of vertices of a brick, i.e. the capacity of a mesh cache slab.
+	  */
+	static inline constexpr std::uint32_t MAX_VERTICES_PER_BRICK = 3U * MeshCache::MAX_TRIANGLES_PER_BRICK;
+
+	/** @brief	Size of the thumbnail of a frame in bytes.
+	  */
+	static std::size_t thumbnailSize(const FrameHeader& header_) {
+		return 4ULL * header_.camera.width * header_.camera.height;
+	}
+
+};
+
+/***********************************************************************
+ * @class	MapPublisher
+ * @brief	MapPublisher class that publishes the mesh cache, the current
+ *			pose and a small ray casted thumbnail of a KinectFusion instance
+ *			to a shared memory ring after each fusion.
+ *
+ * `publish` records the thumbnail ray casting and the downloads of the
+ * selected bricks into a persistent staging buffer, submits them to the
+ * compute queue, and returns without waiting. The version is written to
+ * the ring by a later call, once its downloads have completed. There are
+ * `NUM_STAGING_FRAMES` staging buffers, so `publish` only waits if the
+ * downloads of the version submitted `NUM_STAGING_FRAMES` calls ago are
+ * still running. Publication never waits for subscribers.
+ ***********************************************************************/
+class MapPublisher {
+
+public:
+
+	/** @brief	Number of versions whose downloads may be in flight.
+	  */
+	static inline constexpr std::uint32_t NUM_STAGING_FRAMES = 2U;
+
+	/** @brief	Publisher parameters.
+	  */
+	struct Parameters {
+		std::string name{};						//!< Name of the shared memory region.
+		std::uint32_t numSlots = 4U;			//!< Number of slots of the ring.
+		std::size_t slotSize = 16ULL << 20;		//!< Size of a slot in bytes.
+		std::uint32_t thumbnailSize = 160U;		//!< Maximal width and height of the thumbnail. If 0, no thumbnail is published.
+		std::uint32_t numRefreshBricks = 64U;	//!< Number of unchanged bricks resent per version.
+	};
+
+	/** @brief	Statistics of the last version.
+	  */
+	struct Statistics {
+		std::uint64_t version = 0ULL;
+		std::uint32_t numBricks = 0U;
+		std::uint32_t numRefreshedBricks = 0U;
+		std::uint32_t numPendingBricks = 0U;
+		std::size_t numBytes = 0U;
+		std::chrono::duration<double> publishTime{};	//!< Host time of the last `publish`, including the writes of the completed versions.
+	};
+
+	/** @brief	Construct an invalid publisher.
+	  */
+	MapPublisher(std::nullptr_t) {}
+
+	/** @brief	Create the shared memory ring.
+	  * @param	engine_			Vulkan engine.
+	  * @param	kinectFusion_	The KinectFusion instance to publish. Its mesh cache must be enabled.
+	  * @param	parameters_		Publisher parameters.
+	  */
+	MapPublisher(const Engine& engine_, const KinectFusion& kinectFusion_, const Parameters& parameters_);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	MapPublisher(const MapPublisher&) = delete;
+	MapPublisher(MapPublisher&&) = delete;
+	MapPublisher& operator=(const MapPublisher&) = delete;
+	MapPublisher& operator=(MapPublisher&&) = delete;
+
+	/** @brief	Destructor. Writes the versions still in flight.
+	  */
+	~MapPublisher(void);
+
+	/** @brief	Submit a new version. Call it after each fusion.
+	  *
+	  * The versions whose downloads have completed are written to the ring first.
+	  * @param	frameIndex_		Index of the fused frame.
+	  * @param	camera_			Camera of the fused frame. The thumbnail is scaled to fit in `thumbnailSize`.
+	  * @param	view_			View matrix of the fused frame.
+	  */
+	void publish(std::uint32_t frameIndex_, const Camera& camera_, const jjyou::glsl::mat4& view_);
+
+	/** @brief	Wait for the versions in flight and write them to the ring.
+	  */
+	void flush(void);
+
+	/** @brief	Write the versions in flight and start a new epoch. Call it before the volume is reset.
+	  */
+	void reset(void);
+
+	/** @brief	Get the statistics of the last written version.
+	  */
+	const Statistics& statistics(void) const { return this->_statistics; }
+
+private:
+
+	enum class _BrickState : std::uint8_t {
+		Idle,
+		Pending,	// Changed, and waiting for a version with enough space.
+		Selected,	// Selected for the version being written.
+	};
+
+	/** @brief	A version whose downloads may be in flight.
+	  *
+	  * The staging buffer holds the thumbnail followed by the vertices of the selected bricks.
+	  */
+	struct _StagingFrame {
+		vk::raii::CommandBuffer commandBuffer{ nullptr };
+		vk::raii::Fence fence{ nullptr };
+		Surface<MaterialType::Lambertian> thumbnail{ nullptr };
+		std::vector<BatchRayCastingDescriptorSet> batchRayCastingDescriptorSets{};
+		vk::raii::Buffer stagingBuffer{ nullptr };
+		jjyou::vk::VmaAllocation stagingBufferMemory{ nullptr };
+		const std::byte* stagingBufferMappedAddress = nullptr;
+		bool pending = false;							// Whether the version is submitted but not written to the ring yet.
+		MapStream::FrameHeader header{};
+		std::vector<std::uint32_t> bricks{};
+		std::vector<std::uint32_t> brickNumVertices{};
+		std::uint32_t numRefreshedBricks = 0U;
+	};
+
+	const Engine* _pEngine = nullptr;
+	const KinectFusion* _pKinectFusion = nullptr;
+	Parameters _parameters{};
+	SharedMemoryRing _ring{ nullptr };
+	std::array<_StagingFrame, MapPublisher::NUM_STAGING_FRAMES> _stagingFrames{};
+	std::uint32_t _stagingFrameIndex = 0U;				// The next staging frame to record, which is also the oldest one in flight.
+	std::vector<_BrickState> _brickStates{};
+	std::deque<std::uint32_t> _pendingBricks{};
+	std::uint32_t _refreshSlab = 0U;
+	std::uint32_t _refreshCycle = 0U;
+	std::uint32_t _epoch = 0U;
+	Statistics _statistics{};
+
+	/** @brief	Write the versions whose downloads have completed to the ring, in submission order.
+	  * @param	wait_	Wait for all versions in flight.
+	  */
+	void _writeCompletedVersions(bool wait_);
+
+};
+
+/***********************************************************************
+ * @class	MapSubscriber
+ * @brief	MapSubscriber class that rebuilds the map published by a
+ *			`MapPublisher` in another process.
+ *
+ * Like the mesh cache, the mesh is laid out in slabs of
+ * `MapStream::MAX_VERTICES_PER_BRICK` vertices, one per received brick,
+ * allocated from a free list that returns the lowest free slab. Unused
+ * vertices are degenerate (all zeros). `update` patches the slabs of the
+ * received bricks in place and reports them in `changedSlabs`, so that
+ * renderers only upload what changed.
+ ***********************************************************************/
+class MapSubscriber {
+
+public:
+
+	/** @brief	Construct an invalid subscriber.
+	  */
+	MapSubscriber(std::nullptr_t) {}
+
+	/** @brief	Open the shared memory ring.
+	  *
+	  * Throws `std::runtime_error` if the publisher has not created it yet.
+	  */
+	explicit MapSubscriber(const std::string& name_);
+
+	/** @brief	Disable copy constructor/assignment.
+	  */
+	MapSubscriber(const MapSubscriber&) = delete;
+	MapSubscriber& operator=(const MapSubscriber&) = delete;
+
+	/** @brief	Default move constructor/assignment.
+	  */
+	MapSubscriber(MapSubscriber&&) = default;
+	MapSubscriber& operator=(MapSubscriber&&) = default;
+
+	/** @brief	Destructor.
+	  */
+	~MapSubscriber(void) = default;
+
+	/** @brief	Apply the latest version, if it is newer than the last applied one.
+	  *
+	  * This function never blocks. Throws `std::runtime_error` if the version
+	  * is corrupted, in which case the subscriber should be recreated.
+	  * @return	Whether the map changed.
+	  */
+	bool update(void);
+
+	/** @brief	Check whether the publisher has closed the stream.
+	  */
+	bool closed(void) const { return this->_ring.closed(); }
+
+	/** @brief	Get the header of the last applied version, if any.
+	  */
+	const std::optional<MapStream::FrameHeader>& header(void) const { return this->_header; }
+
+	/** @brief	Get the RGBA thumbnail of the last applied version.
+	  */
+	const std::vector<std::uint8_t>& thumbnail(void) const { return this->_thumbnail; }
+
+	/** @brief	Get the mesh of all received bricks, one slab per brick.
+	  */
+	const std::vector<Vertex<MaterialType::Lambertian>>& mesh(void) const { return this->_mesh; }
+
+	/** @brief	Get the slabs of the mesh changed by the last `update` that returned true.
+	  *
+	  * The mesh only grows by appending slabs, which are reported as changed.
+	  */
+	const std::vector<std::uint32_t>& changedSlabs(void) const { return this->_changedSlabs; }
+
+	/** @brief	Get the number of non-degenerate triangles of the mesh.
+	  */
+	std::size_t numTriangles(void) const { return this->_numVertices / 3U; }
+
+	/** @brief	Get the number of received bricks.
+	  */
+	std::size_t numBricks(void) const { return this->_bricks.size(); }
+
+	/** @brief	Get the last applied version.
+	  */
+	std::uint64_t version(void) const { return this->_version; }
+
+	/** @brief	Get the number of versions skipped because they were overwritten before being read.
+	  */
+	std::uint64_t numSkippedVersions(void) const { return this->_numSkippedVersions; }
+
+	/** @brief	Get the number of reads torn by the publisher.
+	  */
+	std::uint64_t numTornReads(void) const { return this->_ring.numTornReads(); }
+
+private:
+
+	struct _Brick {
+		std::uint32_t refreshCycle = 0U;	// Refresh cycle in which the brick was last received.
+		std::uint32_t slab = 0U;
+		std::uint32_t numVertices = 0U;
+	};
+
+	SharedMemoryRing _ring{ nullptr };
+	std::vector<std::byte> _payload{};
+	std::uint64_t _version = 0ULL;
+	std::uint64_t _numSkippedVersions = 0ULL;
+	std::optional<MapStream::FrameHeader> _header = std::nullopt;
+	std::vector<std::uint8_t> _thumbnail{};
+	std::unordered_map<std::uint32_t, _Brick> _bricks{};
+	std::vector<Vertex<MaterialType::Lambertian>> _mesh{};
+	std::vector<std::uint32_t> _freeSlabs{};	// Min-heap.
+	std::vector<std::uint32_t> _changedSlabs{};
+	std::size_t _numVertices = 0U;
+
+	/** @brief	Allocate the lowest free slab, growing the mesh if there is none.
+	  */
+	std::uint32_t _allocateSlab(void);
+
+	/** @brief	Write the vertices of a brick to its slab, and make the rest of the slab degenerate.
+	  */
+	void _writeSlab(_Brick& brick_, const Vertex<MaterialType::Lambertian>* vertices_, std::uint32_t numVertices_);
+
+	/** @brief	Make the slab of a removed brick degenerate and free it.
+	  */
+	void _freeSlab(const _Brick& brick_);
+
+};
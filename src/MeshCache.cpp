@@ -0,0 +1,382 @@
+#include "MeshCache.hpp"
+#include "KinectFusion.hpp"
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <cstring>
+
+#define VK_THROW(err) \
+	throw std::runtime_error("[MeshCache] Vulkan error in file " + std::string(__FILE__) + " line " + std::to_string(__LINE__) + ": " + vk::to_string(err))
+
+#define VK_CHECK(value) \
+	if (vk::Result err = (value); err != vk::Result::eSuccess) { VK_THROW(err); }
+
+static_assert(sizeof(Vertex<MaterialType::Lambertian>) == 7 * sizeof(std::uint32_t), "`meshBricks.comp` writes vertices as 7 words.");
+
+MeshCache::MeshCache(
+	const Engine& engine_,
+	const KinectFusion& kinectFusion_,
+	std::uint32_t numSlabs_
+) :
+	Primitives(engine_, MemoryPattern::Static),
+	_pKinectFusion(&kinectFusion_),
+	_descriptorSetLayout(*kinectFusion_.meshCacheDescriptorSetLayout()),
+	_numSlabs(numSlabs_),
+	_brickSlabs(kinectFusion_.tsdfVolume().numBricks(), MeshCache::INVALID_SLAB),
+	_slabBricks(numSlabs_, MeshCache::INVALID_SLAB)
+{
+	if (numSlabs_ == 0U) {
+		throw std::logic_error("[MeshCache] The number of slabs must be positive.");
+	}
+	if (static_cast<std::uint64_t>(numSlabs_) * 3ULL * MeshCache::MAX_TRIANGLES_PER_BRICK * 7ULL > static_cast<std::uint64_t>(std::numeric_limits<std::uint32_t>::max())) {
+		throw std::logic_error("[MeshCache] " + std::to_string(numSlabs_) + " slabs cannot be addressed by the meshing shader.");
+	}
+	this->_createBuffers();
+	this->_createDescriptorSet();
+}
+
+std::uint32_t MeshCache::prepareUpdate(const std::vector<std::uint32_t>& modifiedBricks_) {
+	jjyou::glsl::uvec2* pWorkItems = reinterpret_cast<jjyou::glsl::uvec2*>(this->_workItemsMemoryMappedAddress);
+	this->_statistics.numRemeshedBricks = 0U;
+	this->_statistics.numDroppedBricks = 0U;
+	std::uint32_t numWorkItems = 0U;
+	for (std::uint32_t brick : modifiedBricks_) {
+		std::uint32_t& slab = this->_brickSlabs[brick];
+		if (slab == MeshCache::INVALID_SLAB) {
+			if (!this->_freeSlabs.empty()) {
+				std::pop_heap(this->_freeSlabs.begin(), this->_freeSlabs.end(), std::greater<std::uint32_t>());
+				slab = this->_freeSlabs.back();
+				this->_freeSlabs.pop_back();
+			}
+			else if (this->_numAllocatedSlabs < this->_numSlabs) {
+				slab = this->_numAllocatedSlabs++;
+			}
+		}
+		if (slab != MeshCache::INVALID_SLAB) {
+			this->_slabBricks[slab] = brick;
+			++this->_statistics.numRemeshedBricks;
+		}
+		else {
+			++this->_statistics.numDroppedBricks;
+		}
+		pWorkItems[numWorkItems++] = jjyou::glsl::uvec2(brick, slab);
+	}
+	return numWorkItems;
+}
+
+void MeshCache::finishUpdate(std::chrono::duration<double> remeshTime_) {
+	const jjyou::glsl::uvec2* pWorkItems = reinterpret_cast<const jjyou::glsl::uvec2*>(this->_workItemsMemoryMappedAddress);
+	const std::uint32_t* pSlabTriangleCounts = reinterpret_cast<const std::uint32_t*>(this->_slabTriangleCountsMemoryMappedAddress);
+	// Release the slabs of the re-meshed bricks that no longer have a surface.
+	// Their triangles have been made degenerate by the meshing shader.
+	std::uint32_t numWorkItems = this->_statistics.numRemeshedBricks + this->_statistics.numDroppedBricks;
+	this->_updatedBricks.clear();
+	for (std::uint32_t i = 0; i < numWorkItems; ++i) {
+		std::uint32_t brick = pWorkItems[i].x;
+		std::uint32_t slab = pWorkItems[i].y;
+		if (slab != MeshCache::INVALID_SLAB)
+			this->_updatedBricks.push_back(brick);
+		if (slab == MeshCache::INVALID_SLAB || pSlabTriangleCounts[slab] != 0U)
+			continue;
+		this->_brickSlabs[brick] = MeshCache::INVALID_SLAB;
+		this->_slabBricks[slab] = MeshCache::INVALID_SLAB;
+		this->_freeSlabs.push_back(slab);
+		std::push_heap(this->_freeSlabs.begin(), this->_freeSlabs.end(), std::greater<std::uint32_t>());
+	}
+	// Shrink the drawn range if the last slabs are free.
+	std::uint32_t numAllocatedSlabs = this->_numAllocatedSlabs;
+	while (this->_numAllocatedSlabs > 0U && this->_slabBricks[this->_numAllocatedSlabs - 1U] == MeshCache::INVALID_SLAB)
+		--this->_numAllocatedSlabs;
+	if (this->_numAllocatedSlabs != numAllocatedSlabs) {
+		std::erase_if(this->_freeSlabs, [this](std::uint32_t slab) { return slab >= this->_numAllocatedSlabs; });
+		std::make_heap(this->_freeSlabs.begin(), this->_freeSlabs.end(), std::greater<std::uint32_t>());
+	}
+	this->_numVertices = this->_numAllocatedSlabs * 3U * MeshCache::MAX_TRIANGLES_PER_BRICK;
+	// Update the statistics.
+	this->_statistics.remeshTime = remeshTime_;
+	this->_statistics.numUsedSlabs = this->_numAllocatedSlabs - static_cast<std::uint32_t>(this->_freeSlabs.size());
+	this->_statistics.numTriangles = 0ULL;
+	this->_statistics.numOverflowedBricks = 0U;
+	for (std::uint32_t slab = 0; slab < this->_numAllocatedSlabs; ++slab) {
+		this->_statistics.numTriangles += std::min(pSlabTriangleCounts[slab], MeshCache::MAX_TRIANGLES_PER_BRICK);
+		if (pSlabTriangleCounts[slab] > MeshCache::MAX_TRIANGLES_PER_BRICK)
+			++this->_statistics.numOverflowedBricks;
+	}
+}
+
+void MeshCache::reset(void) {
+	if (this->_numAllocatedSlabs > 0U) {
+		this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+			.setPInheritanceInfo(nullptr)
+		);
+		// Downloads of the mesh submitted before may still read the slabs.
+		this->_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(0), nullptr, nullptr, nullptr);
+		this->_commandBuffer.fillBuffer(*this->_vertexBuffer, 0ULL, MeshCache::_slabSize * this->_numAllocatedSlabs, 0U);
+		this->_commandBuffer.end();
+		// Frames submitted to the main queue may still draw the mesh being cleared.
+		this->_submitAndWait(true);
+	}
+	std::memset(this->_slabTriangleCountsMemoryMappedAddress, 0, sizeof(std::uint32_t) * this->_numSlabs);
+	std::fill(this->_brickSlabs.begin(), this->_brickSlabs.end(), MeshCache::INVALID_SLAB);
+	std::fill(this->_slabBricks.begin(), this->_slabBricks.end(), MeshCache::INVALID_SLAB);
+	this->_freeSlabs.clear();
+	this->_updatedBricks.clear();
+	this->_numAllocatedSlabs = 0U;
+	this->_numVertices = 0U;
+	this->_statistics.numRemeshedBricks = 0U;
+	this->_statistics.numDroppedBricks = 0U;
+	this->_statistics.numOverflowedBricks = 0U;
+	this->_statistics.remeshTime = std::chrono::duration<double>(0.0);
+	this->_statistics.numUsedSlabs = 0U;
+	this->_statistics.numTriangles = 0ULL;
+}
+
+std::vector<Vertex<MaterialType::Lambertian>> MeshCache::download(void) const {
+	std::vector<Vertex<MaterialType::Lambertian>> vertices{};
+	vertices.reserve(3ULL * this->_statistics.numTriangles);
+	this->download([&vertices](const Vertex<MaterialType::Lambertian>* pVertices_, std::uint32_t numVertices_) {
+		vertices.insert(vertices.end(), pVertices_, pVertices_ + numVertices_);
+	});
+	return vertices;
+}
+
+void MeshCache::download(const std::function<void(const Vertex<MaterialType::Lambertian>*, std::uint32_t)>& callback_) const {
+	if (this->_numAllocatedSlabs == 0U)
+		return;
+	// Copy the used slabs to a staging buffer.
+	vk::DeviceSize size = MeshCache::_slabSize * this->_numAllocatedSlabs;
+	void* pMappedData = nullptr;
+	auto [stagingBufferRAII, stagingBufferMemoryRAII] = this->_createStagingBuffer(size, pMappedData);
+	this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	this->_commandBuffer.copyBuffer(*this->_vertexBuffer, *stagingBufferRAII, vk::BufferCopy(0ULL, 0ULL, size));
+	this->_commandBuffer.end();
+	this->_submitAndWait();
+	// Keep the valid triangles of each used slab.
+	const Vertex<MaterialType::Lambertian>* pVertices = reinterpret_cast<const Vertex<MaterialType::Lambertian>*>(pMappedData);
+	const std::uint32_t* pSlabTriangleCounts = reinterpret_cast<const std::uint32_t*>(this->_slabTriangleCountsMemoryMappedAddress);
+	for (std::uint32_t slab = 0; slab < this->_numAllocatedSlabs; ++slab) {
+		if (this->_slabBricks[slab] == MeshCache::INVALID_SLAB)
+			continue;
+		const Vertex<MaterialType::Lambertian>* pSlab = pVertices + 3ULL * MeshCache::MAX_TRIANGLES_PER_BRICK * slab;
+		std::uint32_t numTriangles = std::min(pSlabTriangleCounts[slab], MeshCache::MAX_TRIANGLES_PER_BRICK);
+		if (numTriangles != 0U)
+			callback_(pSlab, 3U * numTriangles);
+	}
+}
+
+std::uint32_t MeshCache::brickNumTriangles(std::uint32_t brick_) const {
+	std::uint32_t slab = this->_brickSlabs[brick_];
+	if (slab == MeshCache::INVALID_SLAB)
+		return 0U;
+	return std::min(reinterpret_cast<const std::uint32_t*>(this->_slabTriangleCountsMemoryMappedAddress)[slab], MeshCache::MAX_TRIANGLES_PER_BRICK);
+}
+
+std::vector<std::uint32_t> MeshCache::recordDownloadBricks(
+	const vk::raii::CommandBuffer& commandBuffer_,
+	const std::vector<std::uint32_t>& bricks_,
+	vk::Buffer dstBuffer_,
+	vk::DeviceSize dstOffset_
+) const {
+	std::vector<vk::BufferCopy> regions{};
+	std::vector<std::uint32_t> numVertices(bricks_.size(), 0U);
+	vk::DeviceSize offset = dstOffset_;
+	for (std::size_t i = 0; i < bricks_.size(); ++i) {
+		std::uint32_t numTriangles = this->brickNumTriangles(bricks_[i]);
+		if (numTriangles == 0U)
+			continue;
+		vk::DeviceSize regionSize = sizeof(Vertex<MaterialType::Lambertian>) * 3ULL * numTriangles;
+		regions.push_back(vk::BufferCopy(MeshCache::_slabSize * this->_brickSlabs[bricks_[i]], offset, regionSize));
+		numVertices[i] = 3U * numTriangles;
+		offset += regionSize;
+	}
+	if (!regions.empty())
+		commandBuffer_.copyBuffer(*this->_vertexBuffer, dstBuffer_, regions);
+	return numVertices;
+}
+
+std::pair<vk::raii::Buffer, jjyou::vk::VmaAllocation> MeshCache::_createStagingBuffer(vk::DeviceSize size_, void*& pMappedData_) const {
+	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+		.setFlags(vk::BufferCreateFlags(0))
+		.setSize(size_)
+		.setUsage(vk::BufferUsageFlagBits::eTransferDst)
+		.setSharingMode(vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(nullptr);
+	VmaAllocationCreateInfo vmaAllocationCreateInfo{
+		.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+		.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.memoryTypeBits = 0,
+		.pool = nullptr,
+		.pUserData = nullptr,
+		.priority = 0.0f,
+	};
+	VkBuffer stagingBuffer = nullptr;
+	VmaAllocation stagingBufferMemory = nullptr;
+	VmaAllocationInfo allocationInfo{};
+	vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &stagingBuffer, &stagingBufferMemory, &allocationInfo);
+	pMappedData_ = allocationInfo.pMappedData;
+	return {
+		vk::raii::Buffer(this->_pEngine->context().device(), stagingBuffer),
+		jjyou::vk::VmaAllocation(this->_pEngine->allocator(), stagingBufferMemory)
+	};
+}
+
+void MeshCache::_createBuffers(void) {
+	// Create the vertex buffer. It is written by the compute queue and read by the graphics queue.
+	{
+		std::set<std::uint32_t> queueFamilyIndicesSet = {
+			*this->_pEngine->context().queueFamilyIndex(jjyou::vk::Context::QueueType::Main),
+			*this->_pEngine->context().queueFamilyIndex(jjyou::vk::Context::QueueType::Compute)
+		};
+		std::vector<std::uint32_t> queueFamilyIndices(queueFamilyIndicesSet.begin(), queueFamilyIndicesSet.end());
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(MeshCache::_slabSize * this->_numSlabs)
+			.setUsage(vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst)
+			.setSharingMode(queueFamilyIndices.size() >= 2 ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(queueFamilyIndices);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer vertexBuffer = nullptr;
+		VmaAllocation vertexBufferMemory = nullptr;
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &vertexBuffer, &vertexBufferMemory, nullptr);
+		this->_vertexBuffer = vk::raii::Buffer(this->_pEngine->context().device(), vertexBuffer);
+		this->_vertexBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), vertexBufferMemory);
+	}
+	// Create a host visible storage buffer for the number of triangles of each slab.
+	{
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(sizeof(std::uint32_t) * this->_numSlabs)
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer slabTriangleCountsBuffer = nullptr;
+		VmaAllocation slabTriangleCountsBufferMemory = nullptr;
+		VmaAllocationInfo allocationInfo{};
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &slabTriangleCountsBuffer, &slabTriangleCountsBufferMemory, &allocationInfo);
+		this->_slabTriangleCounts = vk::raii::Buffer(this->_pEngine->context().device(), slabTriangleCountsBuffer);
+		this->_slabTriangleCountsMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), slabTriangleCountsBufferMemory);
+		this->_slabTriangleCountsMemoryMappedAddress = allocationInfo.pMappedData;
+		std::memset(this->_slabTriangleCountsMemoryMappedAddress, 0, sizeof(std::uint32_t) * this->_numSlabs);
+	}
+	// Create a host visible storage buffer for the work items. Each brick is modified at most once per update.
+	{
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(sizeof(jjyou::glsl::uvec2) * this->_brickSlabs.size())
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer workItemsBuffer = nullptr;
+		VmaAllocation workItemsBufferMemory = nullptr;
+		VmaAllocationInfo allocationInfo{};
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &workItemsBuffer, &workItemsBufferMemory, &allocationInfo);
+		this->_workItems = vk::raii::Buffer(this->_pEngine->context().device(), workItemsBuffer);
+		this->_workItemsMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), workItemsBufferMemory);
+		this->_workItemsMemoryMappedAddress = allocationInfo.pMappedData;
+	}
+	this->_statistics.memorySize =
+		MeshCache::_slabSize * this->_numSlabs +
+		sizeof(std::uint32_t) * this->_numSlabs +
+		sizeof(jjyou::glsl::uvec2) * this->_brickSlabs.size();
+	// Create the command buffer and synchronization objects.
+	this->_commandBuffer = std::move(this->_pEngine->context().device().allocateCommandBuffers(
+		vk::CommandBufferAllocateInfo()
+		.setCommandPool(*this->_pEngine->commandPool(jjyou::vk::Context::QueueType::Compute))
+		.setLevel(vk::CommandBufferLevel::ePrimary)
+		.setCommandBufferCount(1)
+	)[0]);
+	this->_fence = vk::raii::Fence(this->_pEngine->context().device(), vk::FenceCreateInfo(vk::FenceCreateFlags(0)));
+	this->_graphicsFinishedSemaphore = vk::raii::Semaphore(this->_pEngine->context().device(), vk::SemaphoreCreateInfo(vk::SemaphoreCreateFlags(0)));
+	// Unused triangles must be degenerate.
+	this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	this->_commandBuffer.fillBuffer(*this->_vertexBuffer, 0ULL, VK_WHOLE_SIZE, 0U);
+	this->_commandBuffer.end();
+	this->_submitAndWait();
+}
+
+void MeshCache::_createDescriptorSet(void) {
+	this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
+	vk::DescriptorBufferInfo vertexBufferDescriptorBufferInfo(*this->_vertexBuffer, 0, VK_WHOLE_SIZE);
+	vk::DescriptorBufferInfo slabTriangleCountsDescriptorBufferInfo(*this->_slabTriangleCounts, 0, VK_WHOLE_SIZE);
+	vk::DescriptorBufferInfo workItemsDescriptorBufferInfo(*this->_workItems, 0, VK_WHOLE_SIZE);
+	std::array<vk::WriteDescriptorSet, 3> writeDescriptorSets = {
+		vk::WriteDescriptorSet()
+		.setDstSet(*this->_descriptorSet)
+		.setDstBinding(0)
+		.setDstArrayElement(0)
+		.setDescriptorCount(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setBufferInfo(vertexBufferDescriptorBufferInfo),
+		vk::WriteDescriptorSet()
+		.setDstSet(*this->_descriptorSet)
+		.setDstBinding(1)
+		.setDstArrayElement(0)
+		.setDescriptorCount(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setBufferInfo(slabTriangleCountsDescriptorBufferInfo),
+		vk::WriteDescriptorSet()
+		.setDstSet(*this->_descriptorSet)
+		.setDstBinding(2)
+		.setDstArrayElement(0)
+		.setDescriptorCount(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setBufferInfo(workItemsDescriptorBufferInfo)
+	};
+	this->_pEngine->context().device().updateDescriptorSets(writeDescriptorSets, {});
+}
+
+void MeshCache::_submitAndWait(bool afterSubmittedFrames_) const {
+	vk::SubmitInfo submitInfo = vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(*this->_commandBuffer)
+		.setSignalSemaphores(nullptr);
+	vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eTransfer;
+	if (afterSubmittedFrames_) {
+		this->_pEngine->signalAfterSubmittedFrames(*this->_graphicsFinishedSemaphore);
+		submitInfo.setWaitSemaphores(*this->_graphicsFinishedSemaphore).setWaitDstStageMask(waitStage);
+	}
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(submitInfo, *this->_fence);
+	vk::Result waitResult = this->_pEngine->waitForFences(*this->_fence);
+	VK_CHECK(waitResult);
+	this->_pEngine->context().device().resetFences(*this->_fence);
+	this->_commandBuffer.reset(vk::CommandBufferResetFlags(0));
+}
@@ -0,0 +1,277 @@
+#pragma once
+#include <vulkan/vulkan_raii.hpp>
+#include <jjyou/vk/Vulkan.hpp>
+#include <jjyou/glsl/glsl.hpp>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <utility>
+#include "Engine.hpp"
+#include "Primitives.hpp"
+
+class KinectFusion;
+
+/***********************************************************************
+ * @class	MeshCache
+ * @brief	MeshCache class that keeps a triangle mesh of the zero surface
+ *			of the TSDF volume up to date.
+ *
+ *	The mesh is extracted brick by brick with surface nets (see
+ *	`meshBricks.comp`). Each brick that has a surface owns a slab of
+ *	`MAX_TRIANGLES_PER_BRICK` triangles in a fixed-capacity vertex buffer.
+ *	Slabs are allocated from a free list that always returns the lowest
+ *	free slab, so that the used slabs stay packed at the front of the buffer.
+ *	After each fusion, KinectFusion re-meshes only the bricks modified by
+ *	fusion and patches their slabs in place. Unused triangles of a slab are
+ *	degenerate (all zeros), so the whole mesh can be drawn as lambertian
+ *	triangles with a single draw call over the used slabs.
+ *
+ *	The vertex buffer is shared by the graphics and compute queue families.
+ *	The mesh is drawn with an identity model matrix.
+ ***********************************************************************/
+class MeshCache : public Primitives<MaterialType::Lambertian, PrimitiveType::Triangle> {
+
+public:
+
+	/** @brief	Capacity of a slab. Must match `meshBricks.comp`.
+	  */
+	static inline constexpr std::uint32_t MAX_TRIANGLES_PER_BRICK = 512U;
+
+	/** @brief	Slab index of bricks that do not own a slab.
+	  */
+	static inline constexpr std::uint32_t INVALID_SLAB = ~0U;
+
+	/***********************************************************************
+	 * @class	Statistics
+	 * @brief	Statistics of the mesh cache.
+	 ***********************************************************************/
+	struct Statistics {
+		std::uint32_t numRemeshedBricks = 0U;		//!< Number of bricks re-meshed in the last update.
+		std::uint32_t numDroppedBricks = 0U;		//!< Number of modified bricks not re-meshed in the last update because all slabs were in use.
+		std::uint32_t numOverflowedBricks = 0U;		//!< Number of bricks whose surface does not fit in a slab.
+		std::chrono::duration<double> remeshTime{};	//!< Time spent by the last update, including the GPU work.
+		std::uint32_t numUsedSlabs = 0U;			//!< Number of slabs owned by bricks.
+		std::uint64_t numTriangles = 0ULL;			//!< Number of non-degenerate triangles.
+		vk::DeviceSize memorySize = 0ULL;			//!< Size of all buffers of the mesh cache.
+	};
+
+	/** @brief	Construct an empty mesh cache in invalid state.
+	  */
+	MeshCache(std::nullptr_t) : Primitives(nullptr) {}
+
+	/** @brief	Create a mesh cache.
+	  * @param	engine_				Vulkan engine.
+	  * @param	kinectFusion_		The KinectFusion instance that owns this mesh cache.
+	  * @param	numSlabs_			Number of slabs. Modified bricks that do not find a free slab are not meshed.
+	  */
+	MeshCache(
+		const Engine& engine_,
+		const KinectFusion& kinectFusion_,
+		std::uint32_t numSlabs_
+	);
+
+	/** @brief	Copy constructor is disabled.
+	  */
+	MeshCache(const MeshCache&) = delete;
+
+	/** @brief	Move constructor.
+	  */
+	MeshCache(MeshCache&& other_) = default;
+
+	/** @brief	Copy assignment is disabled.
+	  */
+	MeshCache& operator=(const MeshCache&) = delete;
+
+	/** @brief	Move assignment.
+	  */
+	MeshCache& operator=(MeshCache&& other_) noexcept {
+		if (this != &other_) {
+			this->Primitives::operator=(std::move(other_));
+			this->_pKinectFusion = other_._pKinectFusion;
+			this->_descriptorSetLayout = other_._descriptorSetLayout;
+			this->_numSlabs = other_._numSlabs;
+			this->_numAllocatedSlabs = other_._numAllocatedSlabs;
+			this->_brickSlabs = std::move(other_._brickSlabs);
+			this->_slabBricks = std::move(other_._slabBricks);
+			this->_freeSlabs = std::move(other_._freeSlabs);
+			this->_updatedBricks = std::move(other_._updatedBricks);
+			this->_slabTriangleCounts = std::move(other_._slabTriangleCounts);
+			this->_slabTriangleCountsMemory = std::move(other_._slabTriangleCountsMemory);
+			this->_slabTriangleCountsMemoryMappedAddress = other_._slabTriangleCountsMemoryMappedAddress;
+			this->_workItems = std::move(other_._workItems);
+			this->_workItemsMemory = std::move(other_._workItemsMemory);
+			this->_workItemsMemoryMappedAddress = other_._workItemsMemoryMappedAddress;
+			this->_commandBuffer = std::move(other_._commandBuffer);
+			this->_fence = std::move(other_._fence);
+			this->_graphicsFinishedSemaphore = std::move(other_._graphicsFinishedSemaphore);
+			this->_descriptorSet = std::move(other_._descriptorSet);
+			this->_statistics = other_._statistics;
+		}
+		return *this;
+	}
+
+	/** @brief	Destructor.
+	  */
+	~MeshCache(void) = default;
+
+	/** @brief	Get the number of slabs.
+	  */
+	std::uint32_t numSlabs(void) const { return this->_numSlabs; }
+
+	/** @brief	Get the number of slabs in the drawn range. Some of them may be free.
+	  */
+	std::uint32_t numAllocatedSlabs(void) const { return this->_numAllocatedSlabs; }
+
+	/** @brief	Get the brick that owns a slab, or `INVALID_SLAB` if the slab is free.
+	  */
+	std::uint32_t slabBrick(std::uint32_t slab_) const { return this->_slabBricks[slab_]; }
+
+	/** @brief	Get the number of triangles of a brick. Bricks without a slab have no triangles.
+	  */
+	std::uint32_t brickNumTriangles(std::uint32_t brick_) const;
+
+	/** @brief	Get the bricks re-meshed by the last update, including the ones whose surface disappeared.
+	  */
+	const std::vector<std::uint32_t>& updatedBricks(void) const { return this->_updatedBricks; }
+
+	/** @brief	Get the statistics of the mesh cache.
+	  */
+	const Statistics& statistics(void) const { return this->_statistics; }
+
+	/** @brief	Get the descriptor set layout.
+	  */
+	vk::DescriptorSetLayout descriptorSetLayout(void) const { return this->_descriptorSetLayout; }
+
+	/** @brief	Allocate slabs for the modified bricks and write them to the work item buffer.
+	  *
+	  * Bricks that already own a slab keep it. Bricks that do not find a free slab are
+	  * written with `INVALID_SLAB`, so that the meshing shader still clears their modified flags.
+	  * @param	modifiedBricks_		The bricks taken from `TSDFVolume::takeModifiedBricks`.
+	  * @return	The number of work items, i.e. the number of work groups of the meshing shader.
+	  */
+	std::uint32_t prepareUpdate(const std::vector<std::uint32_t>& modifiedBricks_);
+
+	/** @brief	Release the slabs of the bricks whose surface disappeared and update the statistics.
+	  *
+	  * Call it after the meshing shader has finished.
+	  * @param	remeshTime_		Time spent by the update.
+	  */
+	void finishUpdate(std::chrono::duration<double> remeshTime_);
+
+	/** @brief	Release all slabs and clear the mesh.
+	  *
+	  * This function blocks until the mesh is cleared. Call it when the volume is reinitialized.
+	  */
+	void reset(void);
+
+	/** @brief	Download the non-degenerate triangles of the mesh.
+	  *
+	  * This function blocks until the download is finished.
+	  */
+	std::vector<Vertex<MaterialType::Lambertian>> download(void) const;
+
+	/** @brief	Download the non-degenerate triangles of the mesh and pass them to `callback_` slab by slab.
+	  *
+	  * The vertices are read directly from the mapped staging memory, which is only valid during the callback.
+	  * This function blocks until all slabs are visited.
+	  * @param	callback_	Called with the vertices of a slab and their number (3 per triangle).
+	  */
+	void download(const std::function<void(const Vertex<MaterialType::Lambertian>*, std::uint32_t)>& callback_) const;
+
+	/** @brief	Record the copies of the triangles of the given bricks into a buffer, packed in the given order.
+	  *
+	  * Only the valid triangles of the slabs of the given bricks are copied. The caller submits the
+	  * command buffer and synchronizes the copies with the updates of the mesh.
+	  * @param	commandBuffer_	Command buffer in recording state, submitted to the compute queue.
+	  * @param	bricks_			The bricks to download.
+	  * @param	dstBuffer_		Destination buffer. It must be large enough for all vertices.
+	  * @param	dstOffset_		Offset of the first vertex in the destination buffer.
+	  * @return	The number of vertices of each brick (3 per triangle). Bricks without triangles have none.
+	  */
+	std::vector<std::uint32_t> recordDownloadBricks(
+		const vk::raii::CommandBuffer& commandBuffer_,
+		const std::vector<std::uint32_t>& bricks_,
+		vk::Buffer dstBuffer_,
+		vk::DeviceSize dstOffset_
+	) const;
+
+	/** @brief	Bind the descriptor set.
+	  */
+	void bind(
+		const vk::raii::CommandBuffer& commandBuffer_,
+		vk::PipelineBindPoint pipelineBindPoint_,
+		const vk::raii::PipelineLayout& pipelineLayout_,
+		std::uint32_t setIndex_
+	) const {
+		commandBuffer_.bindDescriptorSets(pipelineBindPoint_, *pipelineLayout_, setIndex_, *this->_descriptorSet, nullptr);
+	}
+
+	/** @brief	Create a descriptor set layout for the mesh cache.
+	  */
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
+		std::vector<vk::DescriptorSetLayoutBinding> descriptorSetLayoutBindings = {
+		vk::DescriptorSetLayoutBinding()
+		.setBinding(0)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setDescriptorCount(1)
+		.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+		.setPImmutableSamplers(nullptr),
+		vk::DescriptorSetLayoutBinding()
+		.setBinding(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setDescriptorCount(1)
+		.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+		.setPImmutableSamplers(nullptr),
+		vk::DescriptorSetLayoutBinding()
+		.setBinding(2)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setDescriptorCount(1)
+		.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+		.setPImmutableSamplers(nullptr)
+		};
+		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
+			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
+			.setBindings(descriptorSetLayoutBindings);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+	}
+
+private:
+
+	const KinectFusion* _pKinectFusion = nullptr;
+	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by KinectFusion.
+	std::uint32_t _numSlabs = 0U;
+	std::uint32_t _numAllocatedSlabs = 0U;				// Slabs in [0, _numAllocatedSlabs) have been used at least once since the last reset.
+	std::vector<std::uint32_t> _brickSlabs{};			// The slab of each brick, or INVALID_SLAB.
+	std::vector<std::uint32_t> _slabBricks{};			// The brick of each slab, or INVALID_SLAB if the slab is free.
+	std::vector<std::uint32_t> _freeSlabs{};			// Min-heap of free slabs below `_numAllocatedSlabs`.
+	std::vector<std::uint32_t> _updatedBricks{};		// Bricks re-meshed by the last update.
+	vk::raii::Buffer _slabTriangleCounts{ nullptr };
+	jjyou::vk::VmaAllocation _slabTriangleCountsMemory{ nullptr };
+	void* _slabTriangleCountsMemoryMappedAddress = nullptr;
+	vk::raii::Buffer _workItems{ nullptr };
+	jjyou::vk::VmaAllocation _workItemsMemory{ nullptr };
+	void* _workItemsMemoryMappedAddress = nullptr;
+	vk::raii::CommandBuffer _commandBuffer{ nullptr };
+	vk::raii::Fence _fence{ nullptr };
+	vk::raii::Semaphore _graphicsFinishedSemaphore{ nullptr };	// Signaled once the submitted frames no longer draw the mesh.
+	PooledDescriptorSet _descriptorSet{ nullptr };
+	Statistics _statistics{};
+
+	/** @brief	Number of bytes of a slab in the vertex buffer.
+	  */
+	static inline constexpr vk::DeviceSize _slabSize = sizeof(Vertex<MaterialType::Lambertian>) * 3ULL * MeshCache::MAX_TRIANGLES_PER_BRICK;
+
+	void _createBuffers(void);
+	void _createDescriptorSet(void);
+
+	/** @brief	Create a host visible buffer to copy slabs to.
+	  */
+	std::pair<vk::raii::Buffer, jjyou::vk::VmaAllocation> _createStagingBuffer(vk::DeviceSize size_, void*& pMappedData_) const;
+
+	/** @brief	Submit the command buffer to the compute queue and wait for it.
+	  * @param	afterSubmittedFrames_	Whether the command buffer waits for the frames submitted to the main queue,
+	  *									because it writes the vertex buffer.
+	  */
+	void _submitAndWait(bool afterSubmittedFrames_ = false) const;
+
+};
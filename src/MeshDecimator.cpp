@@ -0,0 +1,447 @@
+#include "MeshDecimator.hpp"
+#include "PLYWriter.hpp"
+#include <algorithm>
+#include <iterator>
+#include <atomic>
+#include <thread>
+#include <queue>
+#include <functional>
+#include <cmath>
+#include <bit>
+
+namespace {
+
+	using dvec3 = jjyou::glsl::vec<double, 3>;
+
+	/** @brief	Symmetric 4x4 quadric, stored as the upper triangle in row-major order:
+	  *			a2, ab, ac, ad, b2, bc, bd, c2, cd, d2.
+	  */
+	using Quadric = std::array<double, 10>;
+
+	dvec3 toDouble(const jjyou::glsl::vec<float, 3>& v_) {
+		return dvec3(static_cast<double>(v_.x), static_cast<double>(v_.y), static_cast<double>(v_.z));
+	}
+
+	Quadric planeQuadric(const dvec3& normal_, double distance_, double weight_) {
+		const double a = normal_.x, b = normal_.y, c = normal_.z, d = distance_;
+		return {
+			weight_ * a * a, weight_ * a * b, weight_ * a * c, weight_ * a * d,
+			weight_ * b * b, weight_ * b * c, weight_ * b * d,
+			weight_ * c * c, weight_ * c * d,
+			weight_ * d * d
+		};
+	}
+
+	void addQuadric(Quadric& quadric_, const Quadric& other_) {
+		for (std::size_t i = 0; i < quadric_.size(); ++i)
+			quadric_[i] += other_[i];
+	}
+
+	double evaluateQuadric(const Quadric& q_, const dvec3& p_) {
+		const double x = p_.x, y = p_.y, z = p_.z;
+		return
+			q_[0] * x * x + 2.0 * q_[1] * x * y + 2.0 * q_[2] * x * z + 2.0 * q_[3] * x +
+			q_[4] * y * y + 2.0 * q_[5] * y * z + 2.0 * q_[6] * y +
+			q_[7] * z * z + 2.0 * q_[8] * z +
+			q_[9];
+	}
+
+	/** @brief	Find the position that minimizes the quadric.
+	  * @return	`false` if the quadric is (nearly) singular, e.g. on a plane or a crease.
+	  */
+	bool minimizeQuadric(const Quadric& q_, dvec3& p_) {
+		const double a00 = q_[0], a01 = q_[1], a02 = q_[2];
+		const double a11 = q_[4], a12 = q_[5], a22 = q_[7];
+		const double b0 = -q_[3], b1 = -q_[6], b2 = -q_[8];
+		const double c00 = a11 * a22 - a12 * a12;
+		const double c01 = a02 * a12 - a01 * a22;
+		const double c02 = a01 * a12 - a02 * a11;
+		const double det = a00 * c00 + a01 * c01 + a02 * c02;
+		const double trace = a00 + a11 + a22;
+		if (!(std::abs(det) > 1e-9 * trace * trace * trace))
+			return false;
+		const double c11 = a00 * a22 - a02 * a02;
+		const double c12 = a01 * a02 - a00 * a12;
+		const double c22 = a00 * a11 - a01 * a01;
+		p_ = dvec3(
+			(c00 * b0 + c01 * b1 + c02 * b2) / det,
+			(c01 * b0 + c11 * b1 + c12 * b2) / det,
+			(c02 * b0 + c12 * b1 + c22 * b2) / det
+		);
+		return true;
+	}
+
+	dvec3 triangleNormal(const dvec3& p0_, const dvec3& p1_, const dvec3& p2_) {
+		return jjyou::glsl::cross(p1_ - p0_, p2_ - p0_);
+	}
+
+	std::uint64_t edgeKey(std::uint32_t v0_, std::uint32_t v1_) {
+		return (static_cast<std::uint64_t>(std::min(v0_, v1_)) << 32) | static_cast<std::uint64_t>(std::max(v0_, v1_));
+	}
+
+	struct Collapse {
+		double cost;				// Area-weighted quadric error, which orders the collapses.
+		double errorSquared;		// Quadric error normalized by the accumulated area, i.e. the mean squared distance to the planes.
+		std::uint32_t v0;			// Kept vertex.
+		std::uint32_t v1;			// Removed vertex.
+		std::uint32_t version0;
+		std::uint32_t version1;
+		dvec3 position;
+		bool operator>(const Collapse& other_) const { return this->cost > other_.cost; }
+	};
+
+}
+
+void MeshDecimator::addTriangles(const Vertex<MaterialType::Lambertian>* vertices_, std::uint32_t numVertices_) {
+	for (std::uint32_t i = 0; i + 2 < numVertices_; i += 3) {
+		std::array<std::uint32_t, 3> triangle{};
+		for (std::uint32_t k = 0; k < 3; ++k) {
+			const Vertex<MaterialType::Lambertian>& vertex = vertices_[i + k];
+			_VertexKey key{ {
+				std::bit_cast<std::uint32_t>(vertex.position.x),
+				std::bit_cast<std::uint32_t>(vertex.position.y),
+				std::bit_cast<std::uint32_t>(vertex.position.z)
+			} };
+			auto [iter, inserted] = this->_vertexIndices.try_emplace(key, static_cast<std::uint32_t>(this->_positions.size()));
+			if (inserted) {
+				this->_positions.push_back(vertex.position);
+				this->_normals.push_back(vertex.normal);
+				this->_colors.push_back(vertex.color);
+			}
+			triangle[k] = iter->second;
+		}
+		if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0])
+			continue;
+		this->_triangles.push_back(triangle);
+	}
+}
+
+void MeshDecimator::decimate(const Parameters& parameters_) {
+	auto beginTime = std::chrono::steady_clock::now();
+	this->_vertexIndices = {};
+	this->_statistics = Statistics{};
+	this->_statistics.numInputVertices = this->_positions.size();
+	this->_statistics.numInputTriangles = this->_triangles.size();
+	std::uint32_t numThreads = parameters_.numThreads;
+	if (numThreads == 0U)
+		numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+	double maxErrorSquared = (parameters_.maxError > 0.0f) ?
+		static_cast<double>(parameters_.maxError) * static_cast<double>(parameters_.maxError) :
+		std::numeric_limits<double>::infinity();
+	bool bounded = (parameters_.targetTriangles != 0ULL) || (parameters_.maxError > 0.0f);
+
+	// Partition grid: a cube of cells enclosing the mesh, with several cells per thread
+	// so that the partitions are balanced between threads.
+	constexpr float maxFloat = std::numeric_limits<float>::max();
+	vec3f minCorner(maxFloat, maxFloat, maxFloat);
+	vec3f maxCorner(-maxFloat, -maxFloat, -maxFloat);
+	for (const vec3f& position : this->_positions) {
+		for (int k = 0; k < 3; ++k) {
+			minCorner[k] = std::min(minCorner[k], position[k]);
+			maxCorner[k] = std::max(maxCorner[k], position[k]);
+		}
+	}
+	std::uint32_t gridResolution = std::max(static_cast<std::uint32_t>(std::ceil(std::cbrt(8.0 * numThreads))), 1U);
+	float extent = std::max({ maxCorner.x - minCorner.x, maxCorner.y - minCorner.y, maxCorner.z - minCorner.z });
+	float cellSize = (extent > 0.0f) ? extent / static_cast<float>(gridResolution) : 1.0f;
+
+	for (std::uint32_t pass = 0; bounded && pass < parameters_.numPasses; ++pass) {
+		std::uint64_t numTriangles = this->_triangles.size();
+		if (numTriangles == 0ULL || numTriangles <= parameters_.targetTriangles)
+			break;
+		// Spread the reduction geometrically over the remaining passes.
+		double ratio = 0.0;
+		if (parameters_.targetTriangles != 0ULL) {
+			ratio = std::pow(
+				static_cast<double>(parameters_.targetTriangles) / static_cast<double>(numTriangles),
+				1.0 / static_cast<double>(parameters_.numPasses - pass)
+			);
+		}
+
+		// Assign the triangles to cells by their centroids. The grid is shifted by half a cell in odd passes.
+		float offset = (pass % 2U == 1U) ? 0.5f * cellSize : 0.0f;
+		std::unordered_map<std::uint64_t, std::uint32_t> cellPartitions;
+		std::vector<std::vector<std::uint32_t>> partitions;
+		std::vector<std::uint32_t> vertexPartitions(this->_positions.size(), ~0U);
+		std::vector<std::uint8_t> shared(this->_positions.size(), 0U);
+		for (std::uint32_t t = 0; t < numTriangles; ++t) {
+			const std::array<std::uint32_t, 3>& triangle = this->_triangles[t];
+			std::uint64_t cellKey = 0ULL;
+			for (int k = 0; k < 3; ++k) {
+				float centroid = (this->_positions[triangle[0]][k] + this->_positions[triangle[1]][k] + this->_positions[triangle[2]][k]) / 3.0f;
+				std::uint64_t cell = static_cast<std::uint64_t>(std::max((centroid - minCorner[k] + offset) / cellSize, 0.0f));
+				cellKey = (cellKey << 21) | (cell & 0x1FFFFFULL);
+			}
+			auto [iter, inserted] = cellPartitions.try_emplace(cellKey, static_cast<std::uint32_t>(partitions.size()));
+			if (inserted)
+				partitions.emplace_back();
+			std::uint32_t partition = iter->second;
+			partitions[partition].push_back(t);
+			for (std::uint32_t v : triangle) {
+				if (vertexPartitions[v] == ~0U)
+					vertexPartitions[v] = partition;
+				else if (vertexPartitions[v] != partition)
+					shared[v] = 1U;
+			}
+		}
+		if (pass == 0U)
+			this->_statistics.numPartitions = static_cast<std::uint32_t>(partitions.size());
+
+		// Decimate the partitions on the worker threads.
+		std::vector<std::vector<std::array<std::uint32_t, 3>>> outputs(partitions.size());
+		std::atomic<std::size_t> nextPartition = 0U;
+		auto worker = [&](void) {
+			for (std::size_t p = nextPartition++; p < partitions.size(); p = nextPartition++)
+				this->_decimatePartition(partitions[p], shared, ratio, maxErrorSquared, outputs[p]);
+		};
+		std::vector<std::thread> threads;
+		std::uint32_t numWorkers = std::min(numThreads, static_cast<std::uint32_t>(partitions.size()));
+		for (std::uint32_t i = 1; i < numWorkers; ++i)
+			threads.emplace_back(worker);
+		worker();
+		for (std::thread& thread : threads)
+			thread.join();
+
+		this->_triangles.clear();
+		for (const std::vector<std::array<std::uint32_t, 3>>& output : outputs)
+			this->_triangles.insert(this->_triangles.end(), output.begin(), output.end());
+	}
+
+	std::vector<std::uint8_t> referenced(this->_positions.size(), 0U);
+	for (const std::array<std::uint32_t, 3>& triangle : this->_triangles)
+		for (std::uint32_t v : triangle)
+			referenced[v] = 1U;
+	this->_statistics.numOutputVertices = static_cast<std::uint64_t>(std::count(referenced.begin(), referenced.end(), 1U));
+	this->_statistics.numOutputTriangles = this->_triangles.size();
+	this->_statistics.decimationTime = std::chrono::steady_clock::now() - beginTime;
+}
+
+std::uint64_t MeshDecimator::write(const std::filesystem::path& path_) const {
+	// Renumber the referenced vertices in their current order, so that they can be streamed without a compacted copy.
+	std::vector<std::uint32_t> indices(this->_positions.size(), ~0U);
+	for (const std::array<std::uint32_t, 3>& triangle : this->_triangles)
+		for (std::uint32_t v : triangle)
+			indices[v] = 0U;
+	std::uint32_t numVertices = 0U;
+	for (std::uint32_t& index : indices)
+		if (index != ~0U)
+			index = numVertices++;
+	PLYWriter writer(path_, numVertices, this->_triangles.size());
+	for (std::size_t v = 0; v < indices.size(); ++v)
+		if (indices[v] != ~0U)
+			writer.writeVertex(this->_positions[v], this->_normals[v], this->_colors[v]);
+	for (const std::array<std::uint32_t, 3>& triangle : this->_triangles)
+		writer.writeFace(indices[triangle[0]], indices[triangle[1]], indices[triangle[2]]);
+	writer.close();
+	return writer.numBytes();
+}
+
+void MeshDecimator::_decimatePartition(
+	const std::vector<std::uint32_t>& triangles_,
+	const std::vector<std::uint8_t>& shared_,
+	double ratio_,
+	double maxErrorSquared_,
+	std::vector<std::array<std::uint32_t, 3>>& output_
+) {
+	// Build the local mesh of the partition.
+	std::unordered_map<std::uint32_t, std::uint32_t> localIndices;
+	std::vector<std::uint32_t> globalIndices;
+	std::vector<std::array<std::uint32_t, 3>> triangles(triangles_.size());
+	for (std::size_t t = 0; t < triangles_.size(); ++t) {
+		for (int k = 0; k < 3; ++k) {
+			std::uint32_t globalIndex = this->_triangles[triangles_[t]][k];
+			auto [iter, inserted] = localIndices.try_emplace(globalIndex, static_cast<std::uint32_t>(globalIndices.size()));
+			if (inserted)
+				globalIndices.push_back(globalIndex);
+			triangles[t][k] = iter->second;
+		}
+	}
+	std::size_t numVertices = globalIndices.size();
+	std::vector<dvec3> positions(numVertices);
+	std::vector<Quadric> quadrics(numVertices, Quadric{});
+	std::vector<double> areas(numVertices, 0.0);	// Accumulated weight of the quadric of each vertex.
+	std::vector<std::vector<std::uint32_t>> vertexTriangles(numVertices);
+	std::vector<std::uint8_t> locked(numVertices, 0U);
+	std::vector<std::uint8_t> removed(numVertices, 0U);
+	std::vector<std::uint32_t> versions(numVertices, 0U);
+	std::vector<std::uint8_t> removedTriangles(triangles.size(), 0U);
+	for (std::size_t v = 0; v < numVertices; ++v) {
+		positions[v] = toDouble(this->_positions[globalIndices[v]]);
+		locked[v] = shared_[globalIndices[v]];
+	}
+	std::unordered_map<std::uint64_t, std::uint32_t> edgeCounts;
+	for (std::uint32_t t = 0; t < triangles.size(); ++t) {
+		const std::array<std::uint32_t, 3>& triangle = triangles[t];
+		dvec3 normal = triangleNormal(positions[triangle[0]], positions[triangle[1]], positions[triangle[2]]);
+		double length = jjyou::glsl::norm(normal);
+		if (length > 0.0) {
+			normal = normal / length;
+			Quadric quadric = planeQuadric(normal, -jjyou::glsl::dot(normal, positions[triangle[0]]), 0.5 * length);
+			for (std::uint32_t v : triangle) {
+				addQuadric(quadrics[v], quadric);
+				areas[v] += 0.5 * length;
+			}
+		}
+		for (int k = 0; k < 3; ++k) {
+			vertexTriangles[triangle[k]].push_back(t);
+			++edgeCounts[edgeKey(triangle[k], triangle[(k + 1) % 3])];
+		}
+	}
+	// Vertices on open boundaries or non-manifold edges are locked.
+	for (const auto& [key, count] : edgeCounts) {
+		if (count != 2U) {
+			locked[static_cast<std::uint32_t>(key >> 32)] = 1U;
+			locked[static_cast<std::uint32_t>(key)] = 1U;
+		}
+	}
+
+	auto neighbors = [&](std::uint32_t v_) {
+		std::vector<std::uint32_t> result;
+		for (std::uint32_t t : vertexTriangles[v_])
+			for (std::uint32_t w : triangles[t])
+				if (w != v_)
+					result.push_back(w);
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+		return result;
+	};
+
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+	auto pushCollapse = [&](std::uint32_t v0_, std::uint32_t v1_) {
+		if (locked[v0_] && locked[v1_])
+			return;
+		if (locked[v1_])
+			std::swap(v0_, v1_);
+		Quadric quadric = quadrics[v0_];
+		addQuadric(quadric, quadrics[v1_]);
+		dvec3 position = positions[v0_];
+		double cost = evaluateQuadric(quadric, position);
+		if (!locked[v0_]) {
+			dvec3 optimum{};
+			if (minimizeQuadric(quadric, optimum)) {
+				position = optimum;
+				cost = evaluateQuadric(quadric, position);
+			}
+			else {
+				for (const dvec3& candidate : { positions[v1_], (positions[v0_] + positions[v1_]) * 0.5 }) {
+					double candidateCost = evaluateQuadric(quadric, candidate);
+					if (candidateCost < cost) {
+						cost = candidateCost;
+						position = candidate;
+					}
+				}
+			}
+		}
+		cost = std::max(cost, 0.0);
+		double area = areas[v0_] + areas[v1_];
+		double errorSquared = (area > 0.0) ? cost / area : 0.0;
+		heap.push(Collapse{ cost, errorSquared, v0_, v1_, versions[v0_], versions[v1_], position });
+	};
+	for (const auto& [key, count] : edgeCounts)
+		pushCollapse(static_cast<std::uint32_t>(key >> 32), static_cast<std::uint32_t>(key));
+	edgeCounts = {};
+
+	std::size_t numTriangles = triangles.size();
+	std::size_t targetTriangles = static_cast<std::size_t>(std::ceil(ratio_ * static_cast<double>(triangles.size())));
+	while (numTriangles > targetTriangles && !heap.empty()) {
+		Collapse collapse = heap.top();
+		heap.pop();
+		std::uint32_t v0 = collapse.v0, v1 = collapse.v1;
+		if (removed[v0] || removed[v1] || versions[v0] != collapse.version0 || versions[v1] != collapse.version1)
+			continue;
+		// The heap is ordered by the area-weighted cost, so a large error does not bound the other entries.
+		if (collapse.errorSquared > maxErrorSquared_)
+			continue;
+		// Link condition: the edge's endpoints may only share the vertices opposite to the edge,
+		// otherwise the collapse would create a non-manifold fold.
+		std::uint32_t numSharedTriangles = 0U;
+		for (std::uint32_t t : vertexTriangles[v0])
+			if (std::find(triangles[t].begin(), triangles[t].end(), v1) != triangles[t].end())
+				++numSharedTriangles;
+		std::vector<std::uint32_t> neighbors0 = neighbors(v0);
+		std::vector<std::uint32_t> neighbors1 = neighbors(v1);
+		std::vector<std::uint32_t> commonNeighbors;
+		std::set_intersection(neighbors0.begin(), neighbors0.end(), neighbors1.begin(), neighbors1.end(), std::back_inserter(commonNeighbors));
+		if (numSharedTriangles == 0U || commonNeighbors.size() != numSharedTriangles)
+			continue;
+		// Reject collapses that flip or degenerate the remaining triangles around the edge.
+		bool valid = true;
+		for (std::uint32_t v : { v0, v1 }) {
+			for (std::uint32_t t : vertexTriangles[v]) {
+				const std::array<std::uint32_t, 3>& triangle = triangles[t];
+				if (std::find(triangle.begin(), triangle.end(), v0) != triangle.end() &&
+					std::find(triangle.begin(), triangle.end(), v1) != triangle.end())
+					continue;
+				std::array<dvec3, 3> corners = { positions[triangle[0]], positions[triangle[1]], positions[triangle[2]] };
+				dvec3 oldNormal = triangleNormal(corners[0], corners[1], corners[2]);
+				for (int k = 0; k < 3; ++k)
+					if (triangle[k] == v)
+						corners[k] = collapse.position;
+				dvec3 newNormal = triangleNormal(corners[0], corners[1], corners[2]);
+				double oldLength = jjyou::glsl::norm(oldNormal);
+				double newLength = jjyou::glsl::norm(newNormal);
+				if (!(newLength > 0.0) || (oldLength > 0.0 && jjyou::glsl::dot(oldNormal, newNormal) < 0.2 * oldLength * newLength)) {
+					valid = false;
+					break;
+				}
+			}
+			if (!valid)
+				break;
+		}
+		if (!valid)
+			continue;
+
+		// Interpolate the attributes by the projection of the new position on the edge.
+		if (!locked[v0]) {
+			dvec3 edge = positions[v1] - positions[v0];
+			double edgeLengthSquared = jjyou::glsl::dot(edge, edge);
+			float t = (edgeLengthSquared > 0.0) ?
+				static_cast<float>(std::clamp(jjyou::glsl::dot(collapse.position - positions[v0], edge) / edgeLengthSquared, 0.0, 1.0)) :
+				0.5f;
+			std::uint32_t g0 = globalIndices[v0], g1 = globalIndices[v1];
+			vec3f normal = this->_normals[g0] * (1.0f - t) + this->_normals[g1] * t;
+			float normalLength = jjyou::glsl::norm(normal);
+			if (normalLength > 0.0f)
+				this->_normals[g0] = normal / normalLength;
+			for (int k = 0; k < 4; ++k)
+				this->_colors[g0][k] = static_cast<unsigned char>(std::lround((1.0f - t) * static_cast<float>(this->_colors[g0][k]) + t * static_cast<float>(this->_colors[g1][k])));
+			this->_positions[g0] = vec3f(
+				static_cast<float>(collapse.position.x),
+				static_cast<float>(collapse.position.y),
+				static_cast<float>(collapse.position.z)
+			);
+		}
+
+		// Collapse v1 into v0.
+		for (std::uint32_t t : vertexTriangles[v1]) {
+			std::array<std::uint32_t, 3>& triangle = triangles[t];
+			if (std::find(triangle.begin(), triangle.end(), v0) != triangle.end()) {
+				removedTriangles[t] = 1U;
+				--numTriangles;
+				for (std::uint32_t w : triangle)
+					if (w != v1)
+						std::erase(vertexTriangles[w], t);
+			}
+			else {
+				std::replace(triangle.begin(), triangle.end(), v1, v0);
+				vertexTriangles[v0].push_back(t);
+			}
+		}
+		vertexTriangles[v1].clear();
+		removed[v1] = 1U;
+		positions[v0] = collapse.position;
+		addQuadric(quadrics[v0], quadrics[v1]);
+		areas[v0] += areas[v1];
+		++versions[v0];
+		++versions[v1];
+		for (std::uint32_t w : neighbors(v0))
+			pushCollapse(v0, w);
+	}
+
+	output_.reserve(numTriangles);
+	for (std::size_t t = 0; t < triangles.size(); ++t) {
+		if (removedTriangles[t])
+			continue;
+		output_.push_back({ globalIndices[triangles[t][0]], globalIndices[triangles[t][1]], globalIndices[triangles[t][2]] });
+	}
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include <jjyou/glsl/glsl.hpp>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include "Primitives.hpp"
+
+/***********************************************************************
+ * @class	MeshDecimator
+ * @brief	MeshDecimator class that simplifies a triangle mesh with
+ *			quadric error metrics on multiple threads and writes it to a
+ *			PLY file.
+ *
+ * Triangles are added as vertex soup (e.g. slab by slab from
+ * `MeshCache::download`) and welded by their positions into an indexed
+ * mesh, which is the only copy of the mesh kept on the host.
+ *
+ * The mesh is decimated in several passes. In each pass, the triangles
+ * are partitioned by a uniform grid over their centroids, and the
+ * partitions are decimated in parallel by greedy edge collapse ordered by
+ * the quadric error (Garland and Heckbert). Vertices shared by several
+ * partitions or lying on an open boundary are locked, so the partitions
+ * never touch the same vertex. The grid is shifted by half a cell between
+ * passes, so that the edges locked in one pass can be collapsed in the
+ * next. The colors and normals of collapsed vertices are interpolated
+ * along the collapsed edge.
+ *
+ * `write` streams the decimated mesh to a `PLYWriter` directly from the
+ * working arrays, skipping unreferenced vertices.
+ ***********************************************************************/
+class MeshDecimator {
+
+public:
+
+	using vec3f = jjyou::glsl::vec<float, 3>;
+	using vec4uc = jjyou::glsl::vec<unsigned char, 4>;
+
+	/** @brief	Decimation parameters.
+	  */
+	struct Parameters {
+		std::uint64_t targetTriangles = 0ULL;	//!< Stop when the mesh has at most this many triangles. If 0, only `maxError` stops the decimation.
+		float maxError = 0.0f;					//!< Do not collapse edges whose area-normalized quadric error is larger than this distance, in meters. If 0, the error is unbounded.
+		std::uint32_t numThreads = 0U;			//!< Number of worker threads. If 0, the number of hardware threads is used.
+		std::uint32_t numPasses = 2U;			//!< Number of partitioned passes.
+	};
+
+	/** @brief	Statistics of the last decimation.
+	  */
+	struct Statistics {
+		std::uint64_t numInputVertices = 0ULL;
+		std::uint64_t numInputTriangles = 0ULL;
+		std::uint64_t numOutputVertices = 0ULL;
+		std::uint64_t numOutputTriangles = 0ULL;
+		std::uint32_t numPartitions = 0U;			//!< Number of non-empty partitions in the first pass.
+		std::chrono::duration<double> decimationTime{};
+	};
+
+	/** @brief	Construct an empty mesh.
+	  */
+	MeshDecimator(void) = default;
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	MeshDecimator(const MeshDecimator&) = delete;
+	MeshDecimator(MeshDecimator&&) = delete;
+	MeshDecimator& operator=(const MeshDecimator&) = delete;
+	MeshDecimator& operator=(MeshDecimator&&) = delete;
+
+	/** @brief	Destructor.
+	  */
+	~MeshDecimator(void) = default;
+
+	/** @brief	Add triangles given as vertex soup, 3 vertices per triangle.
+	  *
+	  * Vertices with the same position are welded. Degenerate triangles are skipped.
+	  */
+	void addTriangles(const Vertex<MaterialType::Lambertian>* vertices_, std::uint32_t numVertices_);
+
+	/** @brief	Decimate the mesh. Triangles cannot be added afterwards.
+	  */
+	void decimate(const Parameters& parameters_);
+
+	/** @brief	Get the number of triangles.
+	  */
+	std::uint64_t numTriangles(void) const { return this->_triangles.size(); }
+
+	/** @brief	Write the mesh to a binary PLY file.
+	  * @return	The size of the file in bytes.
+	  */
+	std::uint64_t write(const std::filesystem::path& path_) const;
+
+	/** @brief	Get the statistics of the last decimation.
+	  */
+	const Statistics& statistics(void) const { return this->_statistics; }
+
+private:
+
+	struct _VertexKey {
+		std::array<std::uint32_t, 3> bits{};
+		bool operator==(const _VertexKey&) const = default;
+	};
+
+	struct _VertexKeyHash {
+		std::size_t operator()(const _VertexKey& key_) const {
+			std::uint64_t hash = 1469598103934665603ULL;
+			for (std::uint32_t bits : key_.bits)
+				hash = (hash ^ bits) * 1099511628211ULL;
+			return static_cast<std::size_t>(hash);
+		}
+	};
+
+	std::unordered_map<_VertexKey, std::uint32_t, _VertexKeyHash> _vertexIndices{};	// Only used while adding triangles.
+	std::vector<vec3f> _positions{};
+	std::vector<vec3f> _normals{};
+	std::vector<vec4uc> _colors{};
+	std::vector<std::array<std::uint32_t, 3>> _triangles{};
+	Statistics _statistics{};
+
+	/** @brief	Decimate the triangles of a partition.
+	  *
+	  * Only the unlocked vertices of the partition are written, so partitions can be decimated concurrently.
+	  * @param	triangles_			Indices of the triangles of the partition.
+	  * @param	shared_				Whether each vertex is used by more than one partition.
+	  * @param	ratio_				Ratio of triangles to keep.
+	  * @param	maxErrorSquared_	Maximal quadric error of a collapse, normalized by the accumulated area.
+	  * @param	output_				Output triangles of the partition.
+	  */
+	void _decimatePartition(
+		const std::vector<std::uint32_t>& triangles_,
+		const std::vector<std::uint8_t>& shared_,
+		double ratio_,
+		double maxErrorSquared_,
+		std::vector<std::array<std::uint32_t, 3>>& output_
+	);
+
+};
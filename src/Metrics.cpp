@@ -0,0 +1,316 @@
+#include "Metrics.hpp"
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <ios>
+
+namespace {
+
+	/** @brief	Check whether a name matches [a-zA-Z_:][a-zA-Z0-9_:]*, so that it can be written
+	  *			in the Prometheus format and in JSON without escaping.
+	  */
+	bool isValidName(const std::string& name_) {
+		if (name_.empty() || (name_[0] >= '0' && name_[0] <= '9'))
+			return false;
+		return std::all_of(name_.begin(), name_.end(), [](char c_) {
+			return (c_ >= 'a' && c_ <= 'z') || (c_ >= 'A' && c_ <= 'Z') || (c_ >= '0' && c_ <= '9') || c_ == '_' || c_ == ':';
+		});
+	}
+
+	/** @brief	Get the bucket of a value in ticks.
+	  */
+	std::uint32_t bucketIndex(std::uint64_t ticks_) {
+		using Histogram = MetricsRegistry::Histogram;
+		if (ticks_ < Histogram::NUM_SUB_BUCKETS)
+			return static_cast<std::uint32_t>(ticks_);
+		std::uint32_t exponent = static_cast<std::uint32_t>(std::bit_width(ticks_)) - 1U;
+		if (exponent > Histogram::MAX_EXPONENT)
+			return Histogram::NUM_BUCKETS - 1U;
+		std::uint32_t subBucket = static_cast<std::uint32_t>(ticks_ >> (exponent - Histogram::SUB_BUCKET_BITS)) - Histogram::NUM_SUB_BUCKETS;
+		return Histogram::NUM_SUB_BUCKETS * (exponent - Histogram::SUB_BUCKET_BITS + 1U) + subBucket;
+	}
+
+	/** @brief	Write a JSON number. NaN and infinity are written as null.
+	  */
+	void writeJsonNumber(std::ostream& out_, double value_) {
+		if (std::isfinite(value_))
+			out_ << value_;
+		else
+			out_ << "null";
+	}
+
+}
+
+double MetricsRegistry::Histogram::Snapshot::quantile(double q_) const {
+	if (this->count == 0ULL)
+		return 0.0;
+	std::uint64_t rank = std::max<std::uint64_t>(static_cast<std::uint64_t>(std::ceil(q_ * static_cast<double>(this->count))), 1ULL);
+	std::uint64_t numValues = 0ULL;
+	for (std::uint32_t bucket = 0; bucket < Histogram::NUM_BUCKETS; ++bucket) {
+		numValues += this->buckets[bucket];
+		if (numValues >= rank)
+			return std::min(Histogram::bucketUpperValue(bucket, this->unit), this->max);
+	}
+	return this->max;
+}
+
+void MetricsRegistry::Histogram::record(double value_) {
+	std::uint64_t ticks = 0ULL;
+	if (value_ > 0.0)
+		ticks = static_cast<std::uint64_t>(std::min(value_ / this->_unit + 0.5, 9.0e18));
+	this->_buckets[bucketIndex(ticks)].fetch_add(1ULL, std::memory_order_relaxed);
+	this->_sum.fetch_add(ticks, std::memory_order_relaxed);
+	std::uint64_t max = this->_max.load(std::memory_order_relaxed);
+	while (ticks > max && !this->_max.compare_exchange_weak(max, ticks, std::memory_order_relaxed));
+}
+
+MetricsRegistry::Histogram::Snapshot MetricsRegistry::Histogram::snapshot(void) const {
+	Snapshot snapshot{};
+	snapshot.unit = this->_unit;
+	for (std::uint32_t bucket = 0; bucket < Histogram::NUM_BUCKETS; ++bucket) {
+		snapshot.buckets[bucket] = this->_buckets[bucket].load(std::memory_order_relaxed);
+		snapshot.count += snapshot.buckets[bucket];
+	}
+	snapshot.sum = static_cast<double>(this->_sum.load(std::memory_order_relaxed)) * this->_unit;
+	snapshot.max = static_cast<double>(this->_max.load(std::memory_order_relaxed)) * this->_unit;
+	return snapshot;
+}
+
+std::uint64_t MetricsRegistry::Histogram::bucketLowerBound(std::uint32_t bucket_) {
+	if (bucket_ < Histogram::NUM_SUB_BUCKETS)
+		return bucket_;
+	std::uint32_t exponent = bucket_ / Histogram::NUM_SUB_BUCKETS - 1U + Histogram::SUB_BUCKET_BITS;
+	std::uint64_t subBucket = bucket_ % Histogram::NUM_SUB_BUCKETS;
+	return (Histogram::NUM_SUB_BUCKETS + subBucket) << (exponent - Histogram::SUB_BUCKET_BITS);
+}
+
+std::uint64_t MetricsRegistry::Histogram::bucketUpperBound(std::uint32_t bucket_) {
+	if (bucket_ < Histogram::NUM_SUB_BUCKETS)
+		return bucket_ + 1ULL;
+	std::uint32_t exponent = bucket_ / Histogram::NUM_SUB_BUCKETS - 1U + Histogram::SUB_BUCKET_BITS;
+	return Histogram::bucketLowerBound(bucket_) + (1ULL << (exponent - Histogram::SUB_BUCKET_BITS));
+}
+
+double MetricsRegistry::Histogram::bucketUpperValue(std::uint32_t bucket_, double unit_) {
+	// `record` rounds values to the nearest tick, so the values below the exclusive upper bound U
+	// in ticks are those below (U - 0.5) ticks.
+	return (static_cast<double>(Histogram::bucketUpperBound(bucket_)) - 0.5) * unit_;
+}
+
+MetricsRegistry::Counter& MetricsRegistry::counter(const std::string& name_, const std::string& help_) {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	for (const std::unique_ptr<Counter>& pCounter : this->_counters)
+		if (pCounter->name() == name_)
+			return *pCounter;
+	if (!isValidName(name_))
+		throw std::logic_error("[MetricsRegistry] Invalid metric name \"" + name_ + "\".");
+	if (this->_contains(name_))
+		throw std::logic_error("[MetricsRegistry] Metric " + name_ + " is already registered with another type.");
+	this->_counters.push_back(std::make_unique<Counter>(name_, help_));
+	return *this->_counters.back();
+}
+
+MetricsRegistry::Gauge& MetricsRegistry::gauge(const std::string& name_, const std::string& help_) {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	for (const std::unique_ptr<Gauge>& pGauge : this->_gauges)
+		if (pGauge->name() == name_)
+			return *pGauge;
+	if (!isValidName(name_))
+		throw std::logic_error("[MetricsRegistry] Invalid metric name \"" + name_ + "\".");
+	if (this->_contains(name_))
+		throw std::logic_error("[MetricsRegistry] Metric " + name_ + " is already registered with another type.");
+	this->_gauges.push_back(std::make_unique<Gauge>(name_, help_));
+	return *this->_gauges.back();
+}
+
+MetricsRegistry::Histogram& MetricsRegistry::histogram(const std::string& name_, const std::string& help_, double unit_) {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	for (const std::unique_ptr<Histogram>& pHistogram : this->_histograms)
+		if (pHistogram->name() == name_)
+			return *pHistogram;
+	if (!isValidName(name_))
+		throw std::logic_error("[MetricsRegistry] Invalid metric name \"" + name_ + "\".");
+	if (this->_contains(name_))
+		throw std::logic_error("[MetricsRegistry] Metric " + name_ + " is already registered with another type.");
+	if (!(unit_ > 0.0))
+		throw std::logic_error("[MetricsRegistry] The unit of histogram " + name_ + " must be positive.");
+	this->_histograms.push_back(std::make_unique<Histogram>(name_, help_, unit_));
+	return *this->_histograms.back();
+}
+
+void MetricsRegistry::writePrometheus(std::ostream& out_) const {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	std::streamsize precision = out_.precision(9);
+	for (const std::unique_ptr<Counter>& pCounter : this->_counters) {
+		out_ << "# HELP " << pCounter->name() << " " << pCounter->help() << "\n";
+		out_ << "# TYPE " << pCounter->name() << " counter\n";
+		out_ << pCounter->name() << " " << pCounter->value() << "\n";
+	}
+	for (const std::unique_ptr<Gauge>& pGauge : this->_gauges) {
+		out_ << "# HELP " << pGauge->name() << " " << pGauge->help() << "\n";
+		out_ << "# TYPE " << pGauge->name() << " gauge\n";
+		double value = pGauge->value();
+		out_ << pGauge->name() << " ";
+		if (std::isnan(value))
+			out_ << "NaN";
+		else if (std::isinf(value))
+			out_ << (value > 0.0 ? "+Inf" : "-Inf");
+		else
+			out_ << value;
+		out_ << "\n";
+	}
+	for (const std::unique_ptr<Histogram>& pHistogram : this->_histograms) {
+		Histogram::Snapshot snapshot = pHistogram->snapshot();
+		out_ << "# HELP " << pHistogram->name() << " " << pHistogram->help() << "\n";
+		out_ << "# TYPE " << pHistogram->name() << " histogram\n";
+		// One cumulative bucket per power of two. The set of buckets is the same in every scrape, so
+		// that `histogram_quantile` can aggregate them over time. The last power of two also holds
+		// the larger values, so it is only covered by the +Inf bucket.
+		std::uint64_t numValues = 0ULL;
+		for (std::uint32_t bucket = 0; bucket + 1U < Histogram::NUM_BUCKETS; ++bucket) {
+			numValues += snapshot.buckets[bucket];
+			if ((bucket + 1U) % Histogram::NUM_SUB_BUCKETS != 0U)
+				continue;
+			out_ << pHistogram->name() << "_bucket{le=\"" << Histogram::bucketUpperValue(bucket, pHistogram->unit()) << "\"} " << numValues << "\n";
+		}
+		out_ << pHistogram->name() << "_bucket{le=\"+Inf\"} " << snapshot.count << "\n";
+		out_ << pHistogram->name() << "_sum " << snapshot.sum << "\n";
+		out_ << pHistogram->name() << "_count " << snapshot.count << "\n";
+	}
+	out_.precision(precision);
+}
+
+void MetricsRegistry::writeJson(std::ostream& out_, double timestamp_) const {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	std::streamsize precision = out_.precision(6);
+	out_ << "{\"timestamp\":" << std::fixed << timestamp_ << std::defaultfloat;
+	out_.precision(9);
+	out_ << ",\"counters\":{";
+	for (std::size_t i = 0; i < this->_counters.size(); ++i)
+		out_ << (i == 0 ? "" : ",") << "\"" << this->_counters[i]->name() << "\":" << this->_counters[i]->value();
+	out_ << "},\"gauges\":{";
+	for (std::size_t i = 0; i < this->_gauges.size(); ++i) {
+		out_ << (i == 0 ? "" : ",") << "\"" << this->_gauges[i]->name() << "\":";
+		writeJsonNumber(out_, this->_gauges[i]->value());
+	}
+	out_ << "},\"histograms\":{";
+	for (std::size_t i = 0; i < this->_histograms.size(); ++i) {
+		Histogram::Snapshot snapshot = this->_histograms[i]->snapshot();
+		out_ << (i == 0 ? "" : ",") << "\"" << this->_histograms[i]->name() << "\":{"
+			<< "\"count\":" << snapshot.count
+			<< ",\"sum\":" << snapshot.sum
+			<< ",\"max\":" << snapshot.max
+			<< ",\"p50\":" << snapshot.quantile(0.5)
+			<< ",\"p90\":" << snapshot.quantile(0.9)
+			<< ",\"p99\":" << snapshot.quantile(0.99)
+			<< ",\"p999\":" << snapshot.quantile(0.999)
+			<< "}";
+	}
+	out_ << "}}";
+	out_.precision(precision);
+}
+
+std::chrono::duration<double> MetricsRegistry::measureUpdateTime(std::uint32_t numIterations_) {
+	Counter counter("counter", "");
+	Histogram histogram("histogram", "", 1.0e-6);
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	for (std::uint32_t i = 0; i < numIterations_; ++i) {
+		counter.add();
+		histogram.record(static_cast<double>(i & 0xFFFFU) * 1.0e-6);
+	}
+	std::chrono::duration<double> time = std::chrono::steady_clock::now() - begin;
+	// Keep the updates observable.
+	if (counter.value() != numIterations_)
+		throw std::logic_error("[MetricsRegistry] Lost counter updates.");
+	return time / static_cast<double>(std::max(numIterations_, 1U));
+}
+
+bool MetricsRegistry::_contains(const std::string& name_) const {
+	return
+		std::any_of(this->_counters.begin(), this->_counters.end(), [&](const std::unique_ptr<Counter>& pCounter_) { return pCounter_->name() == name_; }) ||
+		std::any_of(this->_gauges.begin(), this->_gauges.end(), [&](const std::unique_ptr<Gauge>& pGauge_) { return pGauge_->name() == name_; }) ||
+		std::any_of(this->_histograms.begin(), this->_histograms.end(), [&](const std::unique_ptr<Histogram>& pHistogram_) { return pHistogram_->name() == name_; });
+}
+
+MetricsExporter::MetricsExporter(
+	MetricsRegistry& registry_,
+	const std::optional<std::filesystem::path>& prometheusPath_,
+	const std::optional<std::filesystem::path>& jsonPath_,
+	std::chrono::duration<double> period_
+) :
+	_pRegistry(&registry_),
+	_prometheusPath(prometheusPath_),
+	_period(period_)
+{
+	if (jsonPath_.has_value()) {
+		this->_jsonFile.open(*jsonPath_, std::ios::out | std::ios::trunc);
+		if (!this->_jsonFile.is_open())
+			throw std::runtime_error("[MetricsExporter] Cannot open " + jsonPath_->string() + ".");
+	}
+	this->_pExportTime = &registry_.histogram("kinectfusion_metrics_export_seconds", "Time spent writing the metrics.", 1.0e-6);
+	this->_thread = std::thread([this](void) {
+		std::unique_lock<std::mutex> lock(this->_mutex);
+		while (!this->_stop) {
+			this->_condition.wait_for(lock, this->_period, [this](void) { return this->_stop; });
+			if (this->_stop)
+				break;
+			lock.unlock();
+			this->_export();
+			lock.lock();
+		}
+	});
+}
+
+MetricsExporter::~MetricsExporter(void) {
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_stop = true;
+	}
+	this->_condition.notify_all();
+	if (this->_thread.joinable())
+		this->_thread.join();
+	// Write the final values.
+	this->_export();
+}
+
+MetricsExporter::Statistics MetricsExporter::statistics(void) const {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return this->_statistics;
+}
+
+void MetricsExporter::_export(void) {
+	std::chrono::steady_clock::time_point exportBegin = std::chrono::steady_clock::now();
+	bool failed = false;
+	if (this->_prometheusPath.has_value()) {
+		// Write to a temporary file and rename it, so that readers never see a partial file.
+		std::filesystem::path temporaryPath = *this->_prometheusPath;
+		temporaryPath += ".tmp";
+		{
+			std::ofstream file(temporaryPath, std::ios::out | std::ios::trunc);
+			if (file.is_open())
+				this->_pRegistry->writePrometheus(file);
+			failed = !file.is_open() || !file.good();
+		}
+		std::error_code error{};
+		if (!failed)
+			std::filesystem::rename(temporaryPath, *this->_prometheusPath, error);
+		failed = failed || static_cast<bool>(error);
+	}
+	if (this->_jsonFile.is_open()) {
+		double timestamp = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+		this->_pRegistry->writeJson(this->_jsonFile, timestamp);
+		this->_jsonFile << "\n";
+		this->_jsonFile.flush();
+		failed = failed || !this->_jsonFile.good();
+	}
+	std::chrono::duration<double> exportTime = std::chrono::steady_clock::now() - exportBegin;
+	this->_pExportTime->record(exportTime);
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	++this->_statistics.numExports;
+	if (failed)
+		++this->_statistics.numFailures;
+	this->_statistics.exportTime += exportTime;
+	this->_statistics.maxExportTime = std::max(this->_statistics.maxExportTime, exportTime);
+}
@@ -0,0 +1,282 @@
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <optional>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+/***********************************************************************
+ * @class	MetricsRegistry
+ * @brief	MetricsRegistry class that holds the operational metrics of a
+ *			long running session: counters, gauges, and histograms.
+ *
+ * Metrics are registered once by name, and the returned references stay
+ * valid for the lifetime of the registry. Updates are lock-free relaxed
+ * atomic operations without allocations, so they can be done from hot
+ * paths and from any thread. Registration and export take a mutex.
+ *
+ * Histograms are HDR-style: values are quantized to integer ticks of
+ * `unit_`, and each power of two is divided into `2^SUB_BUCKET_BITS`
+ * linear buckets, so quantiles have a relative error of at most
+ * `2^-SUB_BUCKET_BITS` over the whole range.
+ *
+ * Metric names follow the Prometheus conventions, e.g.
+ * "kinectfusion_tracking_seconds" or "kinectfusion_frames_processed_total".
+ ***********************************************************************/
+class MetricsRegistry {
+
+public:
+
+	/***********************************************************************
+	 * @class	Counter
+	 * @brief	Monotonically increasing counter.
+	 ***********************************************************************/
+	class Counter {
+	public:
+		Counter(const std::string& name_, const std::string& help_) : _name(name_), _help(help_) {}
+		void add(std::uint64_t value_ = 1ULL) { this->_value.fetch_add(value_, std::memory_order_relaxed); }
+		std::uint64_t value(void) const { return this->_value.load(std::memory_order_relaxed); }
+		const std::string& name(void) const { return this->_name; }
+		const std::string& help(void) const { return this->_help; }
+	private:
+		std::string _name{};
+		std::string _help{};
+		std::atomic<std::uint64_t> _value = 0ULL;
+	};
+
+	/***********************************************************************
+	 * @class	Gauge
+	 * @brief	Value that can go up and down, e.g. a queue depth.
+	 ***********************************************************************/
+	class Gauge {
+	public:
+		Gauge(const std::string& name_, const std::string& help_) : _name(name_), _help(help_) {}
+		void set(double value_) { this->_value.store(value_, std::memory_order_relaxed); }
+		double value(void) const { return this->_value.load(std::memory_order_relaxed); }
+		const std::string& name(void) const { return this->_name; }
+		const std::string& help(void) const { return this->_help; }
+	private:
+		std::string _name{};
+		std::string _help{};
+		std::atomic<double> _value = 0.0;
+	};
+
+	/***********************************************************************
+	 * @class	Histogram
+	 * @brief	HDR-style histogram with a bounded relative error.
+	 ***********************************************************************/
+	class Histogram {
+	public:
+
+		/** @brief	Each power of two is divided into `2^SUB_BUCKET_BITS` buckets.
+		  */
+		static inline constexpr std::uint32_t SUB_BUCKET_BITS = 3U;
+		static inline constexpr std::uint32_t NUM_SUB_BUCKETS = 1U << SUB_BUCKET_BITS;
+
+		/** @brief	Values of `2^(MAX_EXPONENT + 1)` ticks or more are counted in the last bucket.
+		  *			The first `NUM_SUB_BUCKETS` buckets hold one tick each.
+		  */
+		static inline constexpr std::uint32_t MAX_EXPONENT = 40U;
+		static inline constexpr std::uint32_t NUM_BUCKETS = NUM_SUB_BUCKETS * (MAX_EXPONENT - SUB_BUCKET_BITS + 2U);
+
+		/***********************************************************************
+		 * @class	Snapshot
+		 * @brief	Copy of the buckets at some point in time.
+		 ***********************************************************************/
+		struct Snapshot {
+			std::uint64_t count = 0ULL;
+			double sum = 0.0;
+			double max = 0.0;
+			double unit = 1.0;
+			std::array<std::uint64_t, NUM_BUCKETS> buckets{};
+
+			/** @brief	Get the upper bound of the bucket that holds the `q`-quantile.
+			  */
+			double quantile(double q_) const;
+		};
+
+		/** @brief	Constructor.
+		  * @param	unit_	Size of a tick, e.g. 1e-6 to record seconds with a resolution of one microsecond.
+		  */
+		Histogram(const std::string& name_, const std::string& help_, double unit_) : _name(name_), _help(help_), _unit(unit_) {}
+
+		/** @brief	Record a value. Negative values are recorded as 0.
+		  */
+		void record(double value_);
+
+		/** @brief	Record a duration in seconds.
+		  */
+		void record(std::chrono::duration<double> duration_) { this->record(duration_.count()); }
+
+		/** @brief	Take a snapshot. The buckets are read one by one while other threads may record,
+		  *			so `count` is computed from the copied buckets to stay consistent with them.
+		  */
+		Snapshot snapshot(void) const;
+
+		/** @brief	Get the lower (inclusive) / upper (exclusive) bound of a bucket in ticks.
+		  */
+		static std::uint64_t bucketLowerBound(std::uint32_t bucket_);
+		static std::uint64_t bucketUpperBound(std::uint32_t bucket_);
+
+		/** @brief	Get the upper bound of the values recorded in a bucket, in the unit of the values.
+		  *			It is the `le` label of the bucket in the Prometheus format.
+		  */
+		static double bucketUpperValue(std::uint32_t bucket_, double unit_);
+
+		const std::string& name(void) const { return this->_name; }
+		const std::string& help(void) const { return this->_help; }
+		double unit(void) const { return this->_unit; }
+
+	private:
+		std::string _name{};
+		std::string _help{};
+		double _unit = 1.0;
+		std::array<std::atomic<std::uint64_t>, NUM_BUCKETS> _buckets{};
+		std::atomic<std::uint64_t> _sum = 0ULL;		// In ticks.
+		std::atomic<std::uint64_t> _max = 0ULL;		// In ticks.
+	};
+
+	/** @brief	Default constructor.
+	  */
+	MetricsRegistry(void) {}
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	MetricsRegistry(const MetricsRegistry&) = delete;
+	MetricsRegistry(MetricsRegistry&&) = delete;
+	MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+	MetricsRegistry& operator=(MetricsRegistry&&) = delete;
+
+	/** @brief	Destructor.
+	  */
+	~MetricsRegistry(void) = default;
+
+	/** @brief	Register a metric, or get the one registered with the same name.
+	  *
+	  * Throws `std::logic_error` if the name is not a valid Prometheus metric name,
+	  * or if it is registered with another type.
+	  */
+	Counter& counter(const std::string& name_, const std::string& help_);
+	Gauge& gauge(const std::string& name_, const std::string& help_);
+	Histogram& histogram(const std::string& name_, const std::string& help_, double unit_);
+
+	/** @brief	Write all metrics in the Prometheus text exposition format.
+	  *
+	  * Histograms are written with the same buckets in every call, one per power of two of ticks,
+	  * so that the series of a bucket never disappears between scrapes.
+	  */
+	void writePrometheus(std::ostream& out_) const;
+
+	/** @brief	Write all metrics as one JSON object on a single line.
+	  *
+	  * Histograms are written as their count, sum, max, and p50 / p90 / p99 / p999 quantiles.
+	  * @param	timestamp_	Seconds since the Unix epoch.
+	  */
+	void writeJson(std::ostream& out_, double timestamp_) const;
+
+	/** @brief	Measure the mean host time of one counter increment plus one histogram record,
+	  *			i.e. the overhead that a hot path pays per instrumented event.
+	  */
+	static std::chrono::duration<double> measureUpdateTime(std::uint32_t numIterations_ = 1000000U);
+
+private:
+
+	mutable std::mutex _mutex{};
+	std::vector<std::unique_ptr<Counter>> _counters{};
+	std::vector<std::unique_ptr<Gauge>> _gauges{};
+	std::vector<std::unique_ptr<Histogram>> _histograms{};
+
+	bool _contains(const std::string& name_) const;
+
+};
+
+/***********************************************************************
+ * @class	MetricsExporter
+ * @brief	MetricsExporter class that periodically writes a metrics
+ *			registry on a background thread.
+ *
+ * The Prometheus text file is written to a temporary file that is then
+ * renamed over the target, so that a reader (e.g. the textfile collector
+ * of node_exporter) never sees a partial file. The JSON lines are
+ * appended to their file, one line per export. A final export is done on
+ * destruction.
+ *
+ * The exporter records its own export time in the registry as
+ * "kinectfusion_metrics_export_seconds". The export walks every bucket of
+ * every histogram, so its cost is bounded by the number of metrics and
+ * does not grow with the session length.
+ ***********************************************************************/
+class MetricsExporter {
+
+public:
+
+	/***********************************************************************
+	 * @class	Statistics
+	 * @brief	Statistics of the exports.
+	 ***********************************************************************/
+	struct Statistics {
+		std::uint32_t numExports = 0U;
+		std::uint32_t numFailures = 0U;					//!< Number of exports that could not write a file.
+		std::chrono::duration<double> exportTime{};		//!< Total time spent by the exports.
+		std::chrono::duration<double> maxExportTime{};
+	};
+
+	/** @brief	Start exporting.
+	  * @param	registry_			The registry. It must outlive the exporter.
+	  * @param	prometheusPath_		Path of the Prometheus text file, or std::nullopt.
+	  * @param	jsonPath_			Path of the JSON lines file, or std::nullopt. It is truncated.
+	  * @param	period_				Time between two exports.
+	  */
+	MetricsExporter(
+		MetricsRegistry& registry_,
+		const std::optional<std::filesystem::path>& prometheusPath_,
+		const std::optional<std::filesystem::path>& jsonPath_,
+		std::chrono::duration<double> period_
+	);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	MetricsExporter(const MetricsExporter&) = delete;
+	MetricsExporter(MetricsExporter&&) = delete;
+	MetricsExporter& operator=(const MetricsExporter&) = delete;
+	MetricsExporter& operator=(MetricsExporter&&) = delete;
+
+	/** @brief	Destructor. Stop the thread and export one last time.
+	  */
+	~MetricsExporter(void);
+
+	/** @brief	Get the statistics of the exports.
+	  */
+	Statistics statistics(void) const;
+
+	/** @brief	Getters.
+	  */
+	std::chrono::duration<double> period(void) const { return this->_period; }
+
+private:
+
+	MetricsRegistry* _pRegistry = nullptr;
+	std::optional<std::filesystem::path> _prometheusPath{};
+	std::ofstream _jsonFile{};
+	std::chrono::duration<double> _period{};
+	MetricsRegistry::Histogram* _pExportTime = nullptr;
+	mutable std::mutex _mutex{};
+	std::condition_variable _condition{};
+	bool _stop = false;
+	Statistics _statistics{};
+	std::thread _thread{};
+
+	/** @brief	Write the registry to the files. I/O errors are counted instead of thrown.
+	  */
+	void _export(void);
+
+};
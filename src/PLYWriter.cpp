@@ -0,0 +1,123 @@
+#include "PLYWriter.hpp"
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <bit>
+
+static_assert(std::endian::native == std::endian::little, "PLYWriter writes the host memory as binary_little_endian.");
+
+PLYWriter::PLYWriter(
+	const std::filesystem::path& path_,
+	std::uint64_t numVertices_,
+	std::uint64_t numFaces_
+) :
+	_numVertices(numVertices_),
+	_numFaces(numFaces_),
+	_buffer(PLYWriter::BUFFER_SIZE)
+{
+	if (numVertices_ == PLYWriter::DEFERRED_COUNT && numFaces_ != 0ULL) {
+		throw std::logic_error("[PLYWriter] The number of vertices can only be deferred without faces.");
+	}
+	this->_file.open(path_, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!this->_file.is_open()) {
+		throw std::runtime_error("[PLYWriter] Cannot open file " + path_.string() + ".");
+	}
+	std::string header =
+		"ply\n"
+		"format binary_little_endian 1.0\n"
+		"comment Generated by KinectFusion-Vulkan\n"
+		"element vertex ";
+	if (numVertices_ == PLYWriter::DEFERRED_COUNT) {
+		this->_vertexCountOffset = header.size();
+		header += PLYWriter::_formatDeferredCount(0ULL);
+	}
+	else {
+		header += std::to_string(numVertices_);
+	}
+	header += "\n"
+		"property float x\n"
+		"property float y\n"
+		"property float z\n"
+		"property float nx\n"
+		"property float ny\n"
+		"property float nz\n"
+		"property uchar red\n"
+		"property uchar green\n"
+		"property uchar blue\n"
+		"element face " + std::to_string(numFaces_) + "\n"
+		"property list uchar uint vertex_indices\n"
+		"end_header\n";
+	this->_write(header.data(), header.size());
+}
+
+PLYWriter::~PLYWriter(void) {
+	if (this->_file.is_open()) {
+		this->_flush();
+		this->_file.close();
+	}
+}
+
+void PLYWriter::writeVertex(const vec3f& position_, const vec3f& normal_, const vec4uc& color_) {
+	if (this->_numWrittenVertices == this->_numVertices) {
+		throw std::logic_error("[PLYWriter] More vertices than declared in the header are written.");
+	}
+	this->_write(position_.data.data(), sizeof(float) * 3);
+	this->_write(normal_.data.data(), sizeof(float) * 3);
+	this->_write(color_.data.data(), sizeof(unsigned char) * 3);
+	++this->_numWrittenVertices;
+}
+
+void PLYWriter::writeFace(std::uint32_t v0_, std::uint32_t v1_, std::uint32_t v2_) {
+	if (this->_numWrittenVertices != this->_numVertices) {
+		throw std::logic_error("[PLYWriter] Faces are written before all vertices.");
+	}
+	if (this->_numWrittenFaces == this->_numFaces) {
+		throw std::logic_error("[PLYWriter] More faces than declared in the header are written.");
+	}
+	std::uint8_t numIndices = 3U;
+	std::uint32_t indices[3] = { v0_, v1_, v2_ };
+	this->_write(&numIndices, sizeof(numIndices));
+	this->_write(indices, sizeof(indices));
+	++this->_numWrittenFaces;
+}
+
+void PLYWriter::close(void) {
+	if (this->_vertexCountOffset != 0ULL)
+		this->_numVertices = this->_numWrittenVertices;
+	if (this->_numWrittenVertices != this->_numVertices || this->_numWrittenFaces != this->_numFaces) {
+		throw std::logic_error("[PLYWriter] " + std::to_string(this->_numWrittenVertices) + " vertices and " + std::to_string(this->_numWrittenFaces) + " faces are written, but the header declares " + std::to_string(this->_numVertices) + " and " + std::to_string(this->_numFaces) + ".");
+	}
+	this->_flush();
+	if (this->_vertexCountOffset != 0ULL) {
+		std::string count = PLYWriter::_formatDeferredCount(this->_numVertices);
+		this->_file.seekp(static_cast<std::streamoff>(this->_vertexCountOffset));
+		this->_file.write(count.data(), static_cast<std::streamsize>(count.size()));
+		this->_vertexCountOffset = 0ULL;
+	}
+	this->_file.close();
+	if (this->_file.fail()) {
+		throw std::runtime_error("[PLYWriter] Failed to write the file.");
+	}
+}
+
+void PLYWriter::_write(const void* data_, std::size_t size_) {
+	if (this->_bufferOffset + size_ > this->_buffer.size())
+		this->_flush();
+	std::memcpy(this->_buffer.data() + this->_bufferOffset, data_, size_);
+	this->_bufferOffset += size_;
+	this->_numBytes += size_;
+}
+
+void PLYWriter::_flush(void) {
+	if (this->_bufferOffset == 0U)
+		return;
+	this->_file.write(this->_buffer.data(), static_cast<std::streamsize>(this->_bufferOffset));
+	this->_bufferOffset = 0U;
+}
+
+std::string PLYWriter::_formatDeferredCount(std::uint64_t count_) {
+	// Zero-padded to the width of the largest 64-bit count, so that it can be patched in place.
+	std::string count = std::to_string(count_);
+	return std::string(20U - count.size(), '0') + count;
+}
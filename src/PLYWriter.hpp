@@ -0,0 +1,97 @@
+#pragma once
+#include <jjyou/glsl/glsl.hpp>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/***********************************************************************
+ * @class	PLYWriter
+ * @brief	PLYWriter class that streams a triangle mesh to a binary
+ *			little endian PLY file.
+ *
+ * The numbers of vertices and faces are written in the header, so they
+ * must be known when the file is opened. Vertices and then faces are
+ * appended one by one through a fixed-size buffer, so the caller never
+ * needs to build the file contents in memory. Each vertex has a position,
+ * a normal, and an RGB color. Each face is a triangle.
+ *
+ * If the number of vertices is not known in advance (e.g. when a point
+ * cloud is streamed chunk by chunk), pass `DEFERRED_COUNT`. The header
+ * then reserves a fixed-width field that `close` patches in place.
+ ***********************************************************************/
+class PLYWriter {
+
+public:
+
+	using vec3f = jjyou::glsl::vec<float, 3>;
+	using vec4uc = jjyou::glsl::vec<unsigned char, 4>;
+
+	/** @brief	Size of the write buffer in bytes.
+	  */
+	static inline constexpr std::size_t BUFFER_SIZE = 1U << 20;
+
+	/** @brief	Pass as the number of vertices to fill it in when the file is closed.
+	  *			Only supported without faces.
+	  */
+	static inline constexpr std::uint64_t DEFERRED_COUNT = ~0ULL;
+
+	/** @brief	Open the file and write the header.
+	  * @param	path_			Output path.
+	  * @param	numVertices_	Number of vertices that will be written, or `DEFERRED_COUNT`.
+	  * @param	numFaces_		Number of faces that will be written.
+	  */
+	PLYWriter(
+		const std::filesystem::path& path_,
+		std::uint64_t numVertices_,
+		std::uint64_t numFaces_
+	);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	PLYWriter(const PLYWriter&) = delete;
+	PLYWriter(PLYWriter&&) = delete;
+	PLYWriter& operator=(const PLYWriter&) = delete;
+	PLYWriter& operator=(PLYWriter&&) = delete;
+
+	/** @brief	Destructor. Flushes the buffer if `close` was not called.
+	  */
+	~PLYWriter(void);
+
+	/** @brief	Append a vertex. All vertices must be written before the first face.
+	  */
+	void writeVertex(const vec3f& position_, const vec3f& normal_, const vec4uc& color_);
+
+	/** @brief	Append a triangle.
+	  */
+	void writeFace(std::uint32_t v0_, std::uint32_t v1_, std::uint32_t v2_);
+
+	/** @brief	Flush the buffer and close the file.
+	  *
+	  * Throws if the number of written vertices or faces differs from the header.
+	  * If the number of vertices is deferred, it is written to the header now.
+	  */
+	void close(void);
+
+	/** @brief	Get the number of bytes written so far, including the header.
+	  */
+	std::uint64_t numBytes(void) const { return this->_numBytes; }
+
+private:
+
+	std::ofstream _file{};
+	std::uint64_t _numVertices = 0ULL;
+	std::uint64_t _numFaces = 0ULL;
+	std::uint64_t _numWrittenVertices = 0ULL;
+	std::uint64_t _numWrittenFaces = 0ULL;
+	std::uint64_t _numBytes = 0ULL;
+	std::uint64_t _vertexCountOffset = 0ULL;	// Offset of the deferred vertex count in the file, or 0.
+	std::vector<char> _buffer{};
+	std::size_t _bufferOffset = 0U;
+
+	void _write(const void* data_, std::size_t size_);
+	void _flush(void);
+	static std::string _formatDeferredCount(std::uint64_t count_);
+
+};
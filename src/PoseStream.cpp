@@ -0,0 +1,116 @@
+#include "PoseStream.hpp"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <cstring>
+
+PosePublisher::PosePublisher(const std::string& name_, std::uint32_t historySize_) :
+	_ring(name_, std::max(historySize_, 2U), sizeof(PoseStream::Sample))
+{}
+
+std::uint64_t PosePublisher::publish(PoseStream::Sample sample_) {
+	std::byte* pPayload = this->_ring.beginWrite();
+	sample_.publishTime = PoseStream::now();
+	std::memcpy(pPayload, &sample_, sizeof(sample_));
+	this->_version = this->_ring.endWrite(sizeof(sample_));
+	this->_sample = sample_;
+	return this->_version;
+}
+
+PoseSubscriber::PoseSubscriber(const std::string& name_) :
+	_ring(name_)
+{
+	if (this->_ring.slotSize() < sizeof(PoseStream::Sample)) {
+		throw std::runtime_error("[PoseSubscriber] Region \"" + name_ + "\" is not a pose stream.");
+	}
+}
+
+std::optional<PoseStream::Sample> PoseSubscriber::poll(void) {
+	std::optional<std::uint64_t> version = this->_ring.read(this->_version, this->_payload);
+	if (!version.has_value() || this->_payload.size() != sizeof(PoseStream::Sample))
+		return std::nullopt;
+	std::int64_t readTime = PoseStream::now();
+	PoseStream::Sample sample{};
+	std::memcpy(&sample, this->_payload.data(), sizeof(sample));
+	if (this->_version != 0ULL)
+		this->_numSkippedVersions += *version - this->_version - 1ULL;
+	this->_version = *version;
+	this->_sample = sample;
+	// Record the latency. It is only meaningful if the samples were published with the same clock.
+	std::int64_t latency = std::max<std::int64_t>(readTime - sample.publishTime, 0);
+	std::size_t bin = std::min(static_cast<std::size_t>(latency / 1000LL), PoseSubscriber::_NUM_LATENCY_BINS);
+	++this->_latencyHistogram[bin];
+	++this->_numLatencySamples;
+	this->_sumLatency += latency;
+	this->_maxLatency = std::max(this->_maxLatency, latency);
+	return sample;
+}
+
+std::vector<PoseStream::Sample> PoseSubscriber::history(std::uint32_t count_) const {
+	std::vector<PoseStream::Sample> samples{};
+	std::uint64_t latestVersion = this->_ring.latestVersion();
+	std::uint64_t numVersions = std::min<std::uint64_t>({ count_, latestVersion, this->_ring.numSlots() - 1ULL });
+	std::vector<std::byte> payload{};
+	for (std::uint64_t version = latestVersion - numVersions + 1ULL; version <= latestVersion; ++version) {
+		if (!this->_ring.readVersion(version, payload) || payload.size() != sizeof(PoseStream::Sample))
+			continue;
+		PoseStream::Sample& sample = samples.emplace_back();
+		std::memcpy(&sample, payload.data(), sizeof(sample));
+	}
+	return samples;
+}
+
+PoseSubscriber::LatencyStatistics PoseSubscriber::latencyStatistics(void) const {
+	LatencyStatistics statistics{};
+	statistics.numSamples = this->_numLatencySamples;
+	if (this->_numLatencySamples == 0ULL)
+		return statistics;
+	statistics.mean = std::chrono::nanoseconds(this->_sumLatency / static_cast<std::int64_t>(this->_numLatencySamples));
+	statistics.max = std::chrono::nanoseconds(this->_maxLatency);
+	auto percentile = [this](double fraction_) {
+		std::uint64_t rank = static_cast<std::uint64_t>(fraction_ * static_cast<double>(this->_numLatencySamples - 1ULL));
+		std::uint64_t count = 0ULL;
+		for (std::size_t bin = 0; bin < PoseSubscriber::_NUM_LATENCY_BINS; ++bin) {
+			count += this->_latencyHistogram[bin];
+			if (count > rank)
+				return std::chrono::duration<double>(std::chrono::microseconds(bin));
+		}
+		return std::chrono::duration<double>(std::chrono::nanoseconds(this->_maxLatency));
+	};
+	statistics.p50 = percentile(0.5);
+	statistics.p99 = percentile(0.99);
+	return statistics;
+}
+
+PoseLatencyProbe::PoseLatencyProbe(const std::string& name_) :
+	_subscriber(name_)
+{
+	this->_thread = std::thread([this](void) {
+		while (!this->_stop.load(std::memory_order_relaxed)) {
+			bool received = false;
+			{
+				std::lock_guard<std::mutex> lock(this->_mutex);
+				received = this->_subscriber.poll().has_value();
+			}
+			if (!received)
+				std::this_thread::yield();
+		}
+	});
+}
+
+PoseLatencyProbe::~PoseLatencyProbe(void) {
+	if (this->_thread.joinable()) {
+		this->_stop.store(true, std::memory_order_relaxed);
+		this->_thread.join();
+	}
+}
+
+PoseSubscriber::LatencyStatistics PoseLatencyProbe::latencyStatistics(void) const {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return this->_subscriber.latencyStatistics();
+}
+
+std::uint64_t PoseLatencyProbe::numSkippedVersions(void) const {
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return this->_subscriber.numSkippedVersions();
+}
@@ -0,0 +1,259 @@
+#pragma once
+#include <jjyou/glsl/glsl.hpp>
+#include <vector>
+#include <array>
+#include <string>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "SharedMemoryRing.hpp"
+
+/***********************************************************************
+ * @class	PoseStream
+ * @brief	Format of the pose samples passed from `PosePublisher` to
+ *			`PoseSubscriber` through a `SharedMemoryRing`.
+ *
+ * Each version of the ring is one `Sample`. Times are nanoseconds of
+ * `std::chrono::steady_clock`, which is system-wide on the supported
+ * platforms (CLOCK_MONOTONIC / QueryPerformanceCounter), so they can be
+ * compared across processes on the same machine.
+ ***********************************************************************/
+class PoseStream {
+
+public:
+
+	/** @brief	Tracking status of a sample.
+	  */
+	enum class TrackingStatus : std::uint32_t {
+		Initial,	//!< The pose is the initial pose of the data loader.
+		Tracked,	//!< The pose is estimated by ICP.
+		Lost,		//!< ICP failed. The pose is the last tracked pose.
+	};
+
+	/** @brief	Pose sample.
+	  */
+	struct Sample {
+		std::uint32_t frameIndex;			//!< Index of the frame.
+		TrackingStatus status;				//!< Tracking status.
+		std::uint32_t numICPIterations;		//!< Number of ICP iterations run for the frame.
+		std::uint32_t reserved;
+		std::int64_t captureTime;			//!< Time when the frame was received from the data loader.
+		std::int64_t publishTime;			//!< Time when the sample was published.
+		jjyou::glsl::mat4 view;				//!< View matrix of the frame.
+	};
+
+	/** @brief	Get the current time in nanoseconds of `std::chrono::steady_clock`.
+	  */
+	static std::int64_t now(void) {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+};
+
+/***********************************************************************
+ * @class	PosePublisher
+ * @brief	PosePublisher class that publishes the camera pose of each
+ *			frame to a shared memory ring as soon as it is estimated.
+ *
+ * Publication copies one sample into the ring and never waits for
+ * subscribers. The ring keeps the last `historySize - 1` samples, which
+ * subscribers can read as a bounded history.
+ ***********************************************************************/
+class PosePublisher {
+
+public:
+
+	/** @brief	Construct an invalid publisher.
+	  */
+	PosePublisher(std::nullptr_t) {}
+
+	/** @brief	Create the shared memory ring.
+	  * @param	name_			Name of the shared memory region.
+	  * @param	historySize_	Number of slots of the ring. At least 2 slots are used.
+	  */
+	PosePublisher(const std::string& name_, std::uint32_t historySize_);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	PosePublisher(const PosePublisher&) = delete;
+	PosePublisher(PosePublisher&&) = delete;
+	PosePublisher& operator=(const PosePublisher&) = delete;
+	PosePublisher& operator=(PosePublisher&&) = delete;
+
+	/** @brief	Destructor.
+	  */
+	~PosePublisher(void) = default;
+
+	/** @brief	Publish a sample. Its publish time is set by this function.
+	  * @return	The published version.
+	  */
+	std::uint64_t publish(PoseStream::Sample sample_);
+
+	/** @brief	Get the last published version.
+	  */
+	std::uint64_t version(void) const { return this->_version; }
+
+	/** @brief	Get the last published sample, if any.
+	  */
+	const std::optional<PoseStream::Sample>& sample(void) const { return this->_sample; }
+
+private:
+
+	SharedMemoryRing _ring{ nullptr };
+	std::uint64_t _version = 0ULL;
+	std::optional<PoseStream::Sample> _sample = std::nullopt;
+
+};
+
+/***********************************************************************
+ * @class	PoseSubscriber
+ * @brief	PoseSubscriber class that reads the samples published by a
+ *			`PosePublisher`, possibly in another process, and measures
+ *			the publish-to-read latency.
+ ***********************************************************************/
+class PoseSubscriber {
+
+public:
+
+	/** @brief	Statistics of the publish-to-read latency.
+	  */
+	struct LatencyStatistics {
+		std::uint64_t numSamples = 0ULL;
+		std::chrono::duration<double> mean{};
+		std::chrono::duration<double> max{};
+		std::chrono::duration<double> p50{};	//!< Median, with a resolution of 1 microsecond.
+		std::chrono::duration<double> p99{};	//!< 99th percentile, with a resolution of 1 microsecond.
+	};
+
+	/** @brief	Construct an invalid subscriber.
+	  */
+	PoseSubscriber(std::nullptr_t) {}
+
+	/** @brief	Open the shared memory ring.
+	  *
+	  * Throws `std::runtime_error` if the publisher has not created it yet.
+	  */
+	explicit PoseSubscriber(const std::string& name_);
+
+	/** @brief	Disable copy constructor/assignment.
+	  */
+	PoseSubscriber(const PoseSubscriber&) = delete;
+	PoseSubscriber& operator=(const PoseSubscriber&) = delete;
+
+	/** @brief	Default move constructor/assignment.
+	  */
+	PoseSubscriber(PoseSubscriber&&) = default;
+	PoseSubscriber& operator=(PoseSubscriber&&) = default;
+
+	/** @brief	Destructor.
+	  */
+	~PoseSubscriber(void) = default;
+
+	/** @brief	Read the latest sample, if it is newer than the last read one.
+	  *
+	  * This function never blocks. The latency of each new sample is recorded.
+	  * @return	The new sample, or std::nullopt if there is none.
+	  */
+	std::optional<PoseStream::Sample> poll(void);
+
+	/** @brief	Read the last samples still in the ring, oldest first.
+	  * @param	count_	Maximal number of samples.
+	  */
+	std::vector<PoseStream::Sample> history(std::uint32_t count_) const;
+
+	/** @brief	Check whether the publisher has closed the stream.
+	  */
+	bool closed(void) const { return this->_ring.closed(); }
+
+	/** @brief	Get the last read sample, if any.
+	  */
+	const std::optional<PoseStream::Sample>& latest(void) const { return this->_sample; }
+
+	/** @brief	Get the last read version.
+	  */
+	std::uint64_t version(void) const { return this->_version; }
+
+	/** @brief	Get the number of versions skipped because a newer one was published before they were read.
+	  */
+	std::uint64_t numSkippedVersions(void) const { return this->_numSkippedVersions; }
+
+	/** @brief	Get the number of reads torn by the publisher.
+	  */
+	std::uint64_t numTornReads(void) const { return this->_ring.numTornReads(); }
+
+	/** @brief	Get the statistics of the publish-to-read latency.
+	  */
+	LatencyStatistics latencyStatistics(void) const;
+
+private:
+
+	/** @brief	The latency histogram has 1 microsecond bins up to 10 milliseconds, and an overflow bin.
+	  */
+	static inline constexpr std::size_t _NUM_LATENCY_BINS = 10000U;
+
+	SharedMemoryRing _ring{ nullptr };
+	std::vector<std::byte> _payload{};
+	std::uint64_t _version = 0ULL;
+	std::uint64_t _numSkippedVersions = 0ULL;
+	std::optional<PoseStream::Sample> _sample = std::nullopt;
+	std::vector<std::uint64_t> _latencyHistogram = std::vector<std::uint64_t>(PoseSubscriber::_NUM_LATENCY_BINS + 1U, 0ULL);
+	std::uint64_t _numLatencySamples = 0ULL;
+	std::int64_t _sumLatency = 0LL;
+	std::int64_t _maxLatency = 0LL;
+
+};
+
+/***********************************************************************
+ * @class	PoseLatencyProbe
+ * @brief	PoseLatencyProbe class that polls a pose stream on a
+ *			background thread as fast as possible, to measure the
+ *			publish-to-read latency seen by a consumer that is always
+ *			ready.
+ *
+ * The probe occupies one CPU core while it runs. The measured latency
+ * also includes the scheduling delay of its thread.
+ ***********************************************************************/
+class PoseLatencyProbe {
+
+public:
+
+	/** @brief	Construct an invalid probe.
+	  */
+	PoseLatencyProbe(std::nullptr_t) {}
+
+	/** @brief	Open the shared memory ring and start polling.
+	  *
+	  * Throws `std::runtime_error` if the publisher has not created it yet.
+	  */
+	explicit PoseLatencyProbe(const std::string& name_);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	PoseLatencyProbe(const PoseLatencyProbe&) = delete;
+	PoseLatencyProbe(PoseLatencyProbe&&) = delete;
+	PoseLatencyProbe& operator=(const PoseLatencyProbe&) = delete;
+	PoseLatencyProbe& operator=(PoseLatencyProbe&&) = delete;
+
+	/** @brief	Destructor. Stop polling.
+	  */
+	~PoseLatencyProbe(void);
+
+	/** @brief	Get the statistics of the publish-to-read latency.
+	  */
+	PoseSubscriber::LatencyStatistics latencyStatistics(void) const;
+
+	/** @brief	Get the number of versions skipped by the probe.
+	  */
+	std::uint64_t numSkippedVersions(void) const;
+
+private:
+
+	PoseSubscriber _subscriber{ nullptr };
+	mutable std::mutex _mutex{};
+	std::atomic<bool> _stop = false;
+	std::thread _thread{};
+
+};
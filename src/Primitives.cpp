@@ -207,7 +207,7 @@ Primitives<_materialType, _primitiveType>& Primitives<_materialType, _primitiveT
 		}
 		// 9. CPU waits fences
 		{
-			vk::Result waitResult = this->_pEngine->context().device().waitForFences({ *fences[0], *fences[1], *fences[2] }, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+			vk::Result waitResult = this->_pEngine->waitForFences({ *fences[0], *fences[1], *fences[2] });
 			VK_CHECK(waitResult);
 		}
 	}
@@ -248,6 +248,26 @@ Primitives<_materialType, _primitiveType>& Primitives<_materialType, _primitiveT
 	return *this;
 }
 
+template <MaterialType _materialType, PrimitiveType _primitiveType>
+Primitives<_materialType, _primitiveType>& Primitives<_materialType, _primitiveType>::updateVertexData(
+	std::uint32_t firstVertex_,
+	const Vertex<_materialType>* data_,
+	std::uint32_t numVertices_
+) {
+	if (this->_memoryPattern != MemoryPattern::Dynamic) {
+		throw std::logic_error("[Primitives] Only dynamic primitives can be updated in place.");
+	}
+	if (static_cast<std::uint64_t>(firstVertex_) + numVertices_ > this->_numVertices) {
+		throw std::logic_error("[Primitives] The updated range exceeds the vertex buffer.");
+	}
+	memcpy(
+		static_cast<Vertex<_materialType>*>(this->_vertexBufferMemoryMappedAddress) + firstVertex_,
+		data_,
+		sizeof(Vertex<_materialType>) * numVertices_
+	);
+	return *this;
+}
+
 template class Primitives<MaterialType::Simple, PrimitiveType::Point>;
 template class Primitives<MaterialType::Simple, PrimitiveType::Line>;
 template class Primitives<MaterialType::Simple, PrimitiveType::Triangle>;
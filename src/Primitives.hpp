@@ -2,6 +2,8 @@
 #include <vulkan/vulkan_raii.hpp>
 #include <jjyou/vk/Vulkan.hpp>
 #include <jjyou/glsl/glsl.hpp>
+#include <string>
+#include <atomic>
 
 /***********************************************************************
  * @enum	MaterialType
@@ -40,6 +42,57 @@ enum class MemoryPattern : std::size_t {
 	NumMemoryPatterns,	/**< Used to indicate the number of memory patterns. */
 };
 
+/***********************************************************************
+ * @enum	ColorFormat
+ * @brief	Enum used to describe the layout of raw color data uploaded
+ *			to a surface.
+ *
+ *			Formats other than RGBA8888 are uploaded as-is and converted
+ *			to R8G8B8A8Unorm by a compute shader. The values must match
+ *			`convertColor.comp`.
+ ***********************************************************************/
+enum class ColorFormat : std::uint32_t {
+	RGBA8888 = 0,	/**< 4 bytes per pixel. Copied to the texture directly. */
+	RGB888 = 1,		/**< 3 bytes per pixel, packed. */
+	YUYV = 2,		/**< YUV 4:2:2, 2 bytes per pixel, interleaved as Y0 U Y1 V. The width must be even. */
+	NV12 = 3,		/**< YUV 4:2:0, a Y plane followed by an interleaved UV plane. The width and height must be even. */
+};
+
+/** @brief	Helper function to convert ColorFormat to std::string
+  */
+inline std::string to_string(ColorFormat colorFormat_) {
+	switch (colorFormat_) {
+	case ColorFormat::RGBA8888:
+		return "RGBA8888";
+	case ColorFormat::RGB888:
+		return "RGB888";
+	case ColorFormat::YUYV:
+		return "YUYV";
+	case ColorFormat::NV12:
+		return "NV12";
+	default:
+		return "Undefined";
+	}
+}
+
+/** @brief	Number of bytes of a color frame in the given format.
+  */
+inline std::size_t colorFrameSize(ColorFormat colorFormat_, vk::Extent2D extent_) {
+	std::size_t numPixels = static_cast<std::size_t>(extent_.width) * static_cast<std::size_t>(extent_.height);
+	switch (colorFormat_) {
+	case ColorFormat::RGBA8888:
+		return numPixels * 4;
+	case ColorFormat::RGB888:
+		return numPixels * 3;
+	case ColorFormat::YUYV:
+		return numPixels * 2;
+	case ColorFormat::NV12:
+		return numPixels * 3 / 2;
+	default:
+		return 0;
+	}
+}
+
 /***********************************************************************
  * @class	Vertex
  * @brief	Vertex class that provides vertex binding information of
@@ -142,6 +195,15 @@ struct Vertex<MaterialType::Lambertian> {
 
 class Engine;
 
+/** @brief	Get a new geometry id for `Primitives` or `Surface`.
+  *			Ids increase in creation order, so that draws sorted by id are
+  *			recorded in the same order in every run.
+  */
+inline std::uint64_t nextGeometryId(void) {
+	static std::atomic<std::uint64_t> counter = 0ULL;
+	return ++counter;
+}
+
 /***********************************************************************
  * @class	Primitives
  * @brief	Primitives class that manages relevant Vulkan resources for rendering
@@ -194,16 +256,18 @@ public:
 	Primitives& operator=(Primitives&& other_) noexcept {
 		if (this != &other_) {
 			this->_pEngine = other_._pEngine;
+			this->_geometryId = other_._geometryId;
 			this->_vertexBuffer = std::move(other_._vertexBuffer);
 			this->_vertexBufferMemory = std::move(other_._vertexBufferMemory);
 			this->_numVertices = other_._numVertices;
+			this->_memoryPattern = other_._memoryPattern;
 		}
 		return *this;
 	}
 
 	/** @brief	Construct an empty collection of primitives.
 	  */
-	Primitives(const Engine& engine_, MemoryPattern memoryPattern_) : _pEngine(&engine_), _memoryPattern(memoryPattern_) {}
+	Primitives(const Engine& engine_, MemoryPattern memoryPattern_) : _pEngine(&engine_), _geometryId(nextGeometryId()), _memoryPattern(memoryPattern_) {}
 
 	/** @brief	Set the vertex buffer from CPU data.
 	  */
@@ -222,22 +286,45 @@ public:
 	  */
 	Primitives& setVertexData(const Vertex<_materialType>* data_, std::uint32_t numVertices_, bool waitIdle_);
 
+	/** @brief	Overwrite a range of the vertex buffer in place.
+	  *
+	  * Only for `MemoryPattern::Dynamic`. The range must lie in the vertex buffer,
+	  * and must not be read by the frames in flight.
+	  * @param	firstVertex_	Index of the first overwritten vertex.
+	  */
+	Primitives& updateVertexData(std::uint32_t firstVertex_, const Vertex<_materialType>* data_, std::uint32_t numVertices_);
+
 	/** @brief	Get the number of vertices.
 	  */
 	std::uint32_t numVertices(void) const {
 		return this->_numVertices;
 	}
 
+	/** @brief	Get the geometry id, which identifies the primitives in draw commands.
+	  */
+	std::uint64_t geometryId(void) const {
+		return this->_geometryId;
+	}
+
 	/** @brief	Bind vertex buffer and draw the primitives.
+	  * @param	commandBuffer_		The command buffer to record to.
+	  * @param	instanceCount_		Number of instances to draw.
+	  * @param	firstInstance_		Index of the first instance. The shaders use `gl_InstanceIndex`
+	  *								to look up the model transforms of each instance.
 	  */
-	void draw(const vk::raii::CommandBuffer& commandBuffer_) const {
+	void draw(
+		const vk::raii::CommandBuffer& commandBuffer_,
+		std::uint32_t instanceCount_ = 1U,
+		std::uint32_t firstInstance_ = 0U
+	) const {
 		commandBuffer_.bindVertexBuffers(0, *this->_vertexBuffer, vk::DeviceSize(0));
-		commandBuffer_.draw(this->_numVertices, 1, 0, 0);
+		commandBuffer_.draw(this->_numVertices, instanceCount_, 0, firstInstance_);
 	}
 
 protected:
 
 	const Engine* _pEngine = nullptr;
+	std::uint64_t _geometryId = 0ULL;
 	MemoryPattern _memoryPattern = MemoryPattern::Static;
 	vk::raii::Buffer _vertexBuffer{ nullptr };
 	jjyou::vk::VmaAllocation _vertexBufferMemory{ nullptr };
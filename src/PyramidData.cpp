@@ -31,18 +31,18 @@ PyramidData::PyramidData(
 				*this->_pEngine,
 				formats[i],
 				extent_,
-				vk::ImageUsageFlagBits::eStorage,
-				{ *this->_pEngine->context().queueFamilyIndex(jjyou::vk::Context::QueueType::Compute) }
+				vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst,
+				// With pipelined tracking, the frame pyramid is built on the main queue and the model pyramid on the compute queue.
+				{
+					*this->_pEngine->context().queueFamilyIndex(jjyou::vk::Context::QueueType::Main),
+					*this->_pEngine->context().queueFamilyIndex(jjyou::vk::Context::QueueType::Compute)
+				}
 			);
 		}
 	}
 	// Create and update descriptor set
 	{
-		vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo()
-			.setDescriptorPool(*this->_pEngine->descriptorPool())
-			.setDescriptorSetCount(1)
-			.setSetLayouts(this->_descriptorSetLayout);
-		this->_descriptorSet = std::move(this->_pEngine->context().device().allocateDescriptorSets(descriptorSetAllocateInfo)[0]);
+		this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
 		std::array<vk::DescriptorImageInfo, PyramidData::numTextures> descriptorImageInfos{};
 		std::array<vk::WriteDescriptorSet, PyramidData::numTextures> writeDescriptorSets{};
 		for (std::uint32_t i = 0; i < PyramidData::numTextures; ++i) {
@@ -95,7 +95,7 @@ PyramidData::PyramidData(
 			.setSignalSemaphores(nullptr),
 			*fence
 		);
-		vk::Result waitResult = this->_pEngine->context().device().waitForFences(*fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+		vk::Result waitResult = this->_pEngine->waitForFences(*fence);
 		VK_CHECK(waitResult);
 	}
 }
\ No newline at end of file
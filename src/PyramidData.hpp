@@ -17,7 +17,8 @@ class KinectFusion;
  *			for higher precision. The last channel of vertex/normal map serves
  *			as the validity mask (zero for invalid, nonzero for valid).
  *			The images will be exclusively owned by the compute queue. The images'
- *			layout will be `vk::ImageLayout::eGeneral`.
+ *			layout will be `vk::ImageLayout::eGeneral`. They can also be
+ *			copied to and from, so that `KinectFusion` can cache model maps.
  ***********************************************************************/
 class PyramidData {
 
@@ -93,7 +94,7 @@ public:
 
 	/** @brief	Create the descriptor set layout of 3 storage image descriptors.
 	  */
-	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(const vk::raii::Device& device_) {
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
 		std::array<vk::DescriptorSetLayoutBinding, PyramidData::numTextures> descriptorSetLayoutBindings;
 		for (std::uint32_t i = 0; i < PyramidData::numTextures; ++i) {
 			descriptorSetLayoutBindings[i]
@@ -106,7 +107,7 @@ public:
 		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
 			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
 			.setBindings(descriptorSetLayoutBindings);
-		return vk::raii::DescriptorSetLayout(device_, descriptorSetLayoutCreateInfo);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
 	}
 
 private:
@@ -115,6 +116,6 @@ private:
 	const KinectFusion* _pKinectFusion = nullptr;
 	vk::DescriptorSetLayout _descriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by KinectFusion.
 	std::array<Texture2D, PyramidData::numTextures> _textures{ { Texture2D{nullptr},Texture2D{nullptr},Texture2D{nullptr} } };
-	vk::raii::DescriptorSet _descriptorSet{ nullptr };
+	PooledDescriptorSet _descriptorSet{ nullptr };
 
 };
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "ScalabilityMonitor.hpp"
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <iomanip>
+
+ScalabilityMonitor::ScalabilityMonitor(
+	const Engine& engine_,
+	double duration_,
+	double windowLength_,
+	double warmup_,
+	double driftTolerance_,
+	double driftFloor_,
+	double memoryGrowthTolerance_
+) :
+	_pEngine(&engine_),
+	_duration(duration_),
+	_windowLength(windowLength_),
+	_warmup(warmup_),
+	_driftTolerance(driftTolerance_),
+	_driftFloor(driftFloor_),
+	_memoryGrowthTolerance(memoryGrowthTolerance_)
+{
+	if (this->_windowLength <= 0.0)
+		throw std::logic_error("[ScalabilityMonitor] The window length must be positive.");
+	if (this->_warmup + 2.0 * this->_windowLength > this->_duration)
+		throw std::logic_error("[ScalabilityMonitor] The duration must cover the warmup period and at least two windows.");
+	this->_startTime = Clock::now();
+}
+
+void ScalabilityMonitor::recordFrame(
+	Duration frameTime_,
+	Duration fenceWaitTime_,
+	std::size_t numPrimitivesToDraw_,
+	std::uint32_t mapAllocationCount_,
+	VkDeviceSize mapAllocationBytes_
+) {
+	double now = Duration(Clock::now() - this->_startTime).count();
+	++this->_currentWindow.numFrames;
+	this->_currentWindowFrameTime += frameTime_.count();
+	this->_currentWindowFenceWaitTime += fenceWaitTime_.count();
+	this->_currentWindow.maxFrameTime = std::max(this->_currentWindow.maxFrameTime, frameTime_.count());
+	this->_currentWindow.maxFenceWaitTime = std::max(this->_currentWindow.maxFenceWaitTime, fenceWaitTime_.count());
+	this->_currentWindow.maxNumPrimitivesToDraw = std::max(this->_currentWindow.maxNumPrimitivesToDraw, numPrimitivesToDraw_);
+	this->_currentWindow.maxNumDescriptorSetAllocations = std::max(this->_currentWindow.maxNumDescriptorSetAllocations, this->_pEngine->descriptorAllocator().statistics().numFrameAllocations);
+	this->_mapAllocationCount = mapAllocationCount_;
+	this->_mapAllocationBytes = mapAllocationBytes_;
+	if (now - this->_currentWindow.beginTime >= this->_windowLength)
+		this->_closeWindow(now);
+}
+
+void ScalabilityMonitor::recordFailure(const std::string& reason_) {
+	double now = Duration(Clock::now() - this->_startTime).count();
+	this->_failures.push_back("t=" + std::to_string(now) + "s: " + reason_);
+}
+
+bool ScalabilityMonitor::finished(void) const {
+	return Duration(Clock::now() - this->_startTime).count() >= this->_duration;
+}
+
+bool ScalabilityMonitor::report(std::ostream& out_) const {
+	std::vector<std::string> failures = this->_failures;
+	out_ << "[ScalabilityMonitor] " << this->_windows.size() << " windows of " << this->_windowLength << "s." << std::endl;
+	out_ << std::fixed << std::setprecision(2);
+	for (const WindowStatistics& window : this->_windows) {
+		out_ << "  t=" << window.beginTime << "s"
+			<< " fps=" << window.framesPerSecond
+			<< " frame=" << window.meanFrameTime * 1000.0 << "ms (max " << window.maxFrameTime * 1000.0 << "ms)"
+			<< " fence=" << window.meanFenceWaitTime * 1000.0 << "ms (max " << window.maxFenceWaitTime * 1000.0 << "ms)"
+			<< " memory=" << static_cast<double>(window.allocationBytes) / 1048576.0 << "MiB"
+			<< " allocations=" << window.allocationCount << " (+" << window.mapAllocationCount << " map)"
+			<< " primitives=" << window.maxNumPrimitivesToDraw
+			<< " descriptorSets=" << window.numLiveDescriptorSets << " (pools " << window.numDescriptorPools << ", max " << window.maxNumDescriptorSetAllocations << " allocations/frame)"
+			<< std::endl;
+	}
+	// Find the baseline window (the first window after warmup), and compare every later window with it.
+	// Only the first window that exceeds the baseline is reported for each quantity.
+	auto baseline = std::find_if(this->_windows.begin(), this->_windows.end(), [&](const WindowStatistics& window) { return window.beginTime >= this->_warmup; });
+	if (baseline == this->_windows.end() || baseline == std::prev(this->_windows.end())) {
+		failures.push_back("Not enough windows after warmup to detect drift.");
+	}
+	else {
+		const WindowStatistics& first = *baseline;
+		auto findDrift = [&](auto exceeds) -> const WindowStatistics* {
+			auto window = std::find_if(std::next(baseline), this->_windows.end(), exceeds);
+			return (window == this->_windows.end()) ? nullptr : &*window;
+		};
+		auto at = [](const WindowStatistics& window) { return " (window at t=" + std::to_string(window.beginTime) + "s)"; };
+		auto drifted = [&](double baseline_, double value_) { return value_ > baseline_ * (1.0 + this->_driftTolerance) && value_ - baseline_ > this->_driftFloor; };
+		if (const WindowStatistics* window = findDrift([&](const WindowStatistics& w) { return drifted(first.meanFrameTime, w.meanFrameTime); }))
+			failures.push_back("Frame time drifted from " + std::to_string(first.meanFrameTime * 1000.0) + "ms to " + std::to_string(window->meanFrameTime * 1000.0) + "ms" + at(*window) + ".");
+		if (const WindowStatistics* window = findDrift([&](const WindowStatistics& w) { return drifted(first.meanFenceWaitTime, w.meanFenceWaitTime); }))
+			failures.push_back("Fence wait time drifted from " + std::to_string(first.meanFenceWaitTime * 1000.0) + "ms to " + std::to_string(window->meanFenceWaitTime * 1000.0) + "ms" + at(*window) + ".");
+		if (const WindowStatistics* window = findDrift([&](const WindowStatistics& w) { return static_cast<double>(w.allocationBytes) > static_cast<double>(first.allocationBytes) * (1.0 + this->_memoryGrowthTolerance); }))
+			failures.push_back("Allocated memory grew from " + std::to_string(first.allocationBytes) + " bytes to " + std::to_string(window->allocationBytes) + " bytes" + at(*window) + ".");
+		if (const WindowStatistics* window = findDrift([&](const WindowStatistics& w) { return w.allocationCount > first.allocationCount; }))
+			failures.push_back("Number of allocations grew from " + std::to_string(first.allocationCount) + " to " + std::to_string(window->allocationCount) + at(*window) + ".");
+		if (const WindowStatistics* window = findDrift([&](const WindowStatistics& w) { return w.maxNumPrimitivesToDraw > first.maxNumPrimitivesToDraw; }))
+			failures.push_back("Number of drawn primitives grew from " + std::to_string(first.maxNumPrimitivesToDraw) + " to " + std::to_string(window->maxNumPrimitivesToDraw) + at(*window) + ".");
+		if (const WindowStatistics* window = findDrift([&](const WindowStatistics& w) { return w.numLiveDescriptorSets > first.numLiveDescriptorSets; }))
+			failures.push_back("Number of descriptor sets grew from " + std::to_string(first.numLiveDescriptorSets) + " to " + std::to_string(window->numLiveDescriptorSets) + at(*window) + ".");
+		if (const WindowStatistics* window = findDrift([&](const WindowStatistics& w) { return w.numDescriptorPools > first.numDescriptorPools; }))
+			failures.push_back("Number of descriptor pools grew from " + std::to_string(first.numDescriptorPools) + " to " + std::to_string(window->numDescriptorPools) + at(*window) + ".");
+	}
+	for (const std::string& failure : failures)
+		out_ << "  FAILED: " << failure << std::endl;
+	out_ << "[ScalabilityMonitor] " << (failures.empty() ? "PASSED" : "FAILED") << "." << std::endl;
+	out_ << std::defaultfloat;
+	return failures.empty();
+}
+
+void ScalabilityMonitor::_closeWindow(double now_) {
+	double windowLength = now_ - this->_currentWindow.beginTime;
+	this->_currentWindow.framesPerSecond = static_cast<double>(this->_currentWindow.numFrames) / windowLength;
+	this->_currentWindow.meanFrameTime = this->_currentWindowFrameTime / static_cast<double>(this->_currentWindow.numFrames);
+	this->_currentWindow.meanFenceWaitTime = this->_currentWindowFenceWaitTime / static_cast<double>(this->_currentWindow.numFrames);
+	// Query the memory allocated through VMA, and exclude the allocations owned by the map.
+	const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+	vmaGetMemoryProperties(*this->_pEngine->allocator(), &pMemoryProperties);
+	std::vector<VmaBudget> budgets(pMemoryProperties->memoryHeapCount);
+	vmaGetHeapBudgets(*this->_pEngine->allocator(), budgets.data());
+	for (const VmaBudget& budget : budgets) {
+		this->_currentWindow.allocationBytes += budget.statistics.allocationBytes;
+		this->_currentWindow.allocationCount += budget.statistics.allocationCount;
+	}
+	this->_currentWindow.allocationBytes -= std::min(this->_mapAllocationBytes, this->_currentWindow.allocationBytes);
+	this->_currentWindow.allocationCount -= std::min(this->_mapAllocationCount, this->_currentWindow.allocationCount);
+	this->_currentWindow.mapAllocationCount = this->_mapAllocationCount;
+	DescriptorAllocator::Statistics descriptorAllocatorStatistics = this->_pEngine->descriptorAllocator().statistics();
+	this->_currentWindow.numLiveDescriptorSets = descriptorAllocatorStatistics.numLiveSets;
+	this->_currentWindow.numDescriptorPools = descriptorAllocatorStatistics.numPools;
+	this->_windows.push_back(this->_currentWindow);
+	this->_currentWindow = WindowStatistics{};
+	this->_currentWindow.beginTime = now_;
+	this->_currentWindowFrameTime = 0.0;
+	this->_currentWindowFenceWaitTime = 0.0;
+}
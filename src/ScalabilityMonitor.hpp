@@ -0,0 +1,148 @@
+#pragma once
+#include <vulkan/vulkan_raii.hpp>
+#include <jjyou/vk/Vulkan.hpp>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <ostream>
+#include "Engine.hpp"
+
+/***********************************************************************
+ * @class	ScalabilityMonitor
+ * @brief	Helper class that records per-frame statistics of a long
+ *			running session and detects drift in per-frame cost.
+ *
+ * The application reports every frame via `recordFrame`. The samples are
+ * grouped into fixed-length time windows. For each window the monitor
+ * stores the frame rate, the frame time, the time the host spent blocked
+ * on fences, the Vulkan memory allocated through VMA, the descriptor sets
+ * allocated by the engine's descriptor allocator, and the number of
+ * primitives submitted for drawing.
+ *
+ * After the warmup period, the first window is used as the baseline, and
+ * every later window is compared with it. The session fails if, in any
+ * later window:
+ *  - The frame time or the fence wait time exceeds the baseline by more
+ *    than `driftTolerance_` (relative) and by more than `driftFloor_`
+ *    (absolute). The floor keeps sub-millisecond fence waits from failing
+ *    on scheduling noise.
+ *  - The allocated memory grows by more than `memoryGrowthTolerance_` (relative).
+ *  - The number of VMA allocations, live descriptor sets, descriptor pools,
+ *    or drawn primitives grows at all.
+ *
+ * Allocations that legitimately grow with the map, i.e. the resident pages
+ * of a sparse volume (one VMA allocation per page), are reported by the
+ * application via `recordFrame` and subtracted from the allocated memory
+ * and the number of allocations.
+ *  - Any failure (e.g. descriptor pool or staging memory exhaustion) is
+ *    reported via `recordFailure`.
+ ***********************************************************************/
+class ScalabilityMonitor {
+
+public:
+
+	using Clock = std::chrono::steady_clock;
+	using Duration = std::chrono::duration<double>;
+
+	/** @brief	Statistics of a time window.
+	  */
+	struct WindowStatistics {
+		double beginTime = 0.0;						//!< Start time of the window in seconds.
+		std::uint32_t numFrames = 0U;
+		double framesPerSecond = 0.0;
+		double meanFrameTime = 0.0;					//!< In seconds.
+		double maxFrameTime = 0.0;					//!< In seconds.
+		double meanFenceWaitTime = 0.0;				//!< Host time blocked on fences per frame. In seconds.
+		double maxFenceWaitTime = 0.0;				//!< In seconds.
+		VkDeviceSize allocationBytes = 0;			//!< Bytes allocated through VMA at the end of the window, excluding map allocations.
+		std::uint32_t allocationCount = 0U;			//!< Number of VMA allocations at the end of the window, excluding map allocations.
+		std::uint32_t mapAllocationCount = 0U;		//!< Number of map allocations (resident volume pages) at the end of the window.
+		std::size_t maxNumPrimitivesToDraw = 0U;	//!< Maximum number of primitives drawn in one frame.
+		std::uint32_t maxNumDescriptorSetAllocations = 0U;	//!< Maximum number of descriptor set allocations in one frame.
+		std::uint32_t numLiveDescriptorSets = 0U;	//!< Number of persistent descriptor sets at the end of the window.
+		std::uint32_t numDescriptorPools = 0U;		//!< Number of descriptor pools at the end of the window.
+	};
+
+	/** @brief	Constructor.
+	  * @param	engine_					The Vulkan engine.
+	  * @param	duration_				Duration of the session in seconds.
+	  * @param	windowLength_			Length of a statistics window in seconds.
+	  * @param	warmup_					Windows starting before this time are excluded from drift detection.
+	  * @param	driftTolerance_			Allowed relative growth of frame time and fence wait time.
+	  * @param	driftFloor_				Allowed absolute growth of frame time and fence wait time in seconds.
+	  * @param	memoryGrowthTolerance_	Allowed relative growth of allocated memory.
+	  */
+	ScalabilityMonitor(
+		const Engine& engine_,
+		double duration_,
+		double windowLength_,
+		double warmup_,
+		double driftTolerance_,
+		double driftFloor_,
+		double memoryGrowthTolerance_
+	);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	ScalabilityMonitor(const ScalabilityMonitor&) = delete;
+	ScalabilityMonitor(ScalabilityMonitor&&) = delete;
+	ScalabilityMonitor& operator=(const ScalabilityMonitor&) = delete;
+	ScalabilityMonitor& operator=(ScalabilityMonitor&&) = delete;
+
+	/** @brief	Destructor.
+	  */
+	~ScalabilityMonitor(void) = default;
+
+	/** @brief	Record a frame.
+	  * @param	frameTime_				Wall time of the frame.
+	  * @param	fenceWaitTime_			Host time blocked on fences during the frame.
+	  * @param	numPrimitivesToDraw_	Number of primitives submitted for drawing.
+	  * @param	mapAllocationCount_		Number of VMA allocations owned by the map, e.g. the resident pages of a sparse volume.
+	  * @param	mapAllocationBytes_		Bytes of the VMA allocations owned by the map.
+	  */
+	void recordFrame(
+		Duration frameTime_,
+		Duration fenceWaitTime_,
+		std::size_t numPrimitivesToDraw_,
+		std::uint32_t mapAllocationCount_,
+		VkDeviceSize mapAllocationBytes_
+	);
+
+	/** @brief	Record a failure that happened during the session.
+	  */
+	void recordFailure(const std::string& reason_);
+
+	/** @brief	Check whether the session has reached its duration.
+	  */
+	bool finished(void) const;
+
+	/** @brief	Get the statistics of all completed windows.
+	  */
+	const std::vector<WindowStatistics>& windows(void) const { return this->_windows; }
+
+	/** @brief	Check the recorded statistics and print a report.
+	  * @return	`true` if no drift or failure is detected.
+	  */
+	bool report(std::ostream& out_) const;
+
+private:
+
+	const Engine* _pEngine = nullptr;
+	double _duration = 0.0;
+	double _windowLength = 0.0;
+	double _warmup = 0.0;
+	double _driftTolerance = 0.0;
+	double _driftFloor = 0.0;
+	double _memoryGrowthTolerance = 0.0;
+	Clock::time_point _startTime{};
+	std::vector<WindowStatistics> _windows{};
+	WindowStatistics _currentWindow{};
+	double _currentWindowFrameTime = 0.0;
+	double _currentWindowFenceWaitTime = 0.0;
+	std::uint32_t _mapAllocationCount = 0U;
+	VkDeviceSize _mapAllocationBytes = 0;
+	std::vector<std::string> _failures{};
+
+	void _closeWindow(double now_);
+
+};
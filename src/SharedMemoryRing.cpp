@@ -0,0 +1,249 @@
+#include "SharedMemoryRing.hpp"
+#include <exception>
+#include <stdexcept>
+#include <cstring>
+#include <new>
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+SharedMemoryRing::SharedMemoryRing(const std::string& name_, std::uint32_t numSlots_, std::size_t slotSize_) :
+	_name(name_),
+	_writer(true)
+{
+	if (name_.empty() || name_.find_first_of("/\\") != std::string::npos) {
+		throw std::logic_error("[SharedMemoryRing] Invalid region name \"" + name_ + "\".");
+	}
+	if (numSlots_ < 2U) {
+		throw std::logic_error("[SharedMemoryRing] At least 2 slots are required, so that readers can copy one version while the next is written.");
+	}
+	std::size_t headerSize = (sizeof(_Header) + SharedMemoryRing::_ALIGNMENT - 1U) / SharedMemoryRing::_ALIGNMENT * SharedMemoryRing::_ALIGNMENT;
+	std::size_t slotStride = (sizeof(_SlotHeader) + slotSize_ + SharedMemoryRing::_ALIGNMENT - 1U) / SharedMemoryRing::_ALIGNMENT * SharedMemoryRing::_ALIGNMENT;
+	this->_regionSize = headerSize + slotStride * numSlots_;
+	this->_map(true);
+	// The region may be left over by a writer that crashed.
+	std::memset(this->_pRegion, 0, this->_regionSize);
+	_Header* pHeader = new (this->_pRegion) _Header{};
+	pHeader->layoutVersion = SharedMemoryRing::LAYOUT_VERSION;
+	pHeader->numSlots = numSlots_;
+	pHeader->slotSize = slotSize_;
+	pHeader->slotStride = slotStride;
+	pHeader->latestVersion.store(0ULL, std::memory_order_relaxed);
+	pHeader->closed.store(0U, std::memory_order_relaxed);
+	for (std::uint32_t slot = 0; slot < numSlots_; ++slot) {
+		_SlotHeader* pSlotHeader = new (reinterpret_cast<std::byte*>(this->_pRegion) + headerSize + slotStride * slot) _SlotHeader{};
+		pSlotHeader->sequence.store(0ULL, std::memory_order_relaxed);
+		pSlotHeader->size = 0ULL;
+	}
+	pHeader->magic.store(SharedMemoryRing::MAGIC, std::memory_order_release);
+}
+
+SharedMemoryRing::SharedMemoryRing(const std::string& name_) :
+	_name(name_),
+	_writer(false)
+{
+	this->_map(false);
+	if (this->_regionSize < sizeof(_Header) ||
+		this->_header().magic.load(std::memory_order_acquire) != SharedMemoryRing::MAGIC ||
+		this->_header().layoutVersion != SharedMemoryRing::LAYOUT_VERSION
+	) {
+		this->_unmap();
+		throw std::runtime_error("[SharedMemoryRing] Region \"" + name_ + "\" is not initialized or has an incompatible layout.");
+	}
+}
+
+SharedMemoryRing::SharedMemoryRing(SharedMemoryRing&& other_) noexcept {
+	*this = std::move(other_);
+}
+
+SharedMemoryRing& SharedMemoryRing::operator=(SharedMemoryRing&& other_) noexcept {
+	if (this != &other_) {
+		this->_unmap();
+		this->_name = std::move(other_._name);
+		this->_writer = other_._writer;
+		this->_pRegion = std::exchange(other_._pRegion, nullptr);
+		this->_regionSize = std::exchange(other_._regionSize, 0U);
+		this->_handle = std::exchange(other_._handle, nullptr);
+		this->_fd = std::exchange(other_._fd, -1);
+		this->_writeVersion = other_._writeVersion;
+		this->_numTornReads = other_._numTornReads;
+	}
+	return *this;
+}
+
+SharedMemoryRing::~SharedMemoryRing(void) {
+	this->_unmap();
+}
+
+std::uint32_t SharedMemoryRing::numSlots(void) const {
+	return this->_header().numSlots;
+}
+
+std::size_t SharedMemoryRing::slotSize(void) const {
+	return static_cast<std::size_t>(this->_header().slotSize);
+}
+
+std::byte* SharedMemoryRing::beginWrite(void) {
+	if (!this->_writer) {
+		throw std::logic_error("[SharedMemoryRing] Only the writer can write.");
+	}
+	std::uint64_t version = this->_writeVersion + 1ULL;
+	_SlotHeader& slotHeader = this->_slotHeader(version);
+	slotHeader.sequence.store(2ULL * version + 1ULL, std::memory_order_relaxed);
+	// Readers that see the payload being written must also see the odd sequence number.
+	std::atomic_thread_fence(std::memory_order_release);
+	return this->_slotPayload(version);
+}
+
+std::uint64_t SharedMemoryRing::endWrite(std::size_t size_) {
+	if (size_ > this->slotSize()) {
+		throw std::logic_error("[SharedMemoryRing] The payload of " + std::to_string(size_) + " bytes does not fit in a slot of " + std::to_string(this->slotSize()) + " bytes.");
+	}
+	std::uint64_t version = ++this->_writeVersion;
+	_SlotHeader& slotHeader = this->_slotHeader(version);
+	slotHeader.size = size_;
+	slotHeader.sequence.store(2ULL * version + 2ULL, std::memory_order_release);
+	this->_header().latestVersion.store(version, std::memory_order_release);
+	return version;
+}
+
+std::uint64_t SharedMemoryRing::latestVersion(void) const {
+	return this->_header().latestVersion.load(std::memory_order_acquire);
+}
+
+bool SharedMemoryRing::closed(void) const {
+	return this->_header().closed.load(std::memory_order_acquire) != 0U;
+}
+
+std::optional<std::uint64_t> SharedMemoryRing::read(std::uint64_t lastVersion_, std::vector<std::byte>& payload_) const {
+	constexpr int maxNumAttempts = 4;
+	for (int attempt = 0; attempt < maxNumAttempts; ++attempt) {
+		std::uint64_t version = this->latestVersion();
+		if (version == 0ULL || version <= lastVersion_)
+			return std::nullopt;
+		if (this->readVersion(version, payload_))
+			return version;
+	}
+	return std::nullopt;
+}
+
+bool SharedMemoryRing::readVersion(std::uint64_t version_, std::vector<std::byte>& payload_) const {
+	if (version_ == 0ULL || version_ > this->latestVersion())
+		return false;
+	const _SlotHeader& slotHeader = this->_slotHeader(version_);
+	std::uint64_t sequence = slotHeader.sequence.load(std::memory_order_acquire);
+	if (sequence != 2ULL * version_ + 2ULL) {
+		// Overwritten by a newer version, or being overwritten.
+		++this->_numTornReads;
+		return false;
+	}
+	std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(slotHeader.size, this->_header().slotSize));
+	payload_.resize(size);
+	std::memcpy(payload_.data(), this->_slotPayload(version_), size);
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (slotHeader.sequence.load(std::memory_order_relaxed) != sequence) {
+		++this->_numTornReads;
+		return false;
+	}
+	return true;
+}
+
+SharedMemoryRing::_SlotHeader& SharedMemoryRing::_slotHeader(std::uint64_t version_) const {
+	std::size_t headerSize = (sizeof(_Header) + SharedMemoryRing::_ALIGNMENT - 1U) / SharedMemoryRing::_ALIGNMENT * SharedMemoryRing::_ALIGNMENT;
+	std::size_t slot = static_cast<std::size_t>(version_ % this->_header().numSlots);
+	return *reinterpret_cast<_SlotHeader*>(reinterpret_cast<std::byte*>(this->_pRegion) + headerSize + this->_header().slotStride * slot);
+}
+
+std::byte* SharedMemoryRing::_slotPayload(std::uint64_t version_) const {
+	return reinterpret_cast<std::byte*>(&this->_slotHeader(version_)) + sizeof(_SlotHeader);
+}
+
+void SharedMemoryRing::_map(bool create_) {
+#ifdef _WIN32
+	std::string name = "Local\\" + this->_name;
+	HANDLE handle = nullptr;
+	if (create_) {
+		std::uint64_t size = static_cast<std::uint64_t>(this->_regionSize);
+		handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFFULL), name.c_str());
+	}
+	else {
+		handle = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+	}
+	if (handle == nullptr) {
+		throw std::runtime_error("[SharedMemoryRing] Cannot " + std::string(create_ ? "create" : "open") + " shared memory \"" + this->_name + "\".");
+	}
+	void* pRegion = MapViewOfFile(handle, create_ ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, create_ ? this->_regionSize : 0);
+	if (pRegion == nullptr) {
+		CloseHandle(handle);
+		throw std::runtime_error("[SharedMemoryRing] Cannot map shared memory \"" + this->_name + "\".");
+	}
+	if (!create_) {
+		MEMORY_BASIC_INFORMATION memoryInformation{};
+		VirtualQuery(pRegion, &memoryInformation, sizeof(memoryInformation));
+		this->_regionSize = static_cast<std::size_t>(memoryInformation.RegionSize);
+	}
+	this->_handle = handle;
+	this->_pRegion = pRegion;
+#else
+	std::string name = "/" + this->_name;
+	int fd = create_ ? shm_open(name.c_str(), O_CREAT | O_RDWR, 0600) : shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0) {
+		throw std::runtime_error("[SharedMemoryRing] Cannot " + std::string(create_ ? "create" : "open") + " shared memory \"" + this->_name + "\".");
+	}
+	if (create_) {
+		if (ftruncate(fd, static_cast<off_t>(this->_regionSize)) != 0) {
+			close(fd);
+			shm_unlink(name.c_str());
+			throw std::runtime_error("[SharedMemoryRing] Cannot resize shared memory \"" + this->_name + "\".");
+		}
+	}
+	else {
+		struct stat fileStatus {};
+		if (fstat(fd, &fileStatus) != 0) {
+			close(fd);
+			throw std::runtime_error("[SharedMemoryRing] Cannot get the size of shared memory \"" + this->_name + "\".");
+		}
+		this->_regionSize = static_cast<std::size_t>(fileStatus.st_size);
+	}
+	void* pRegion = (this->_regionSize == 0U) ? MAP_FAILED : mmap(nullptr, this->_regionSize, create_ ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+	if (pRegion == MAP_FAILED) {
+		close(fd);
+		if (create_)
+			shm_unlink(name.c_str());
+		throw std::runtime_error("[SharedMemoryRing] Cannot map shared memory \"" + this->_name + "\".");
+	}
+	this->_fd = fd;
+	this->_pRegion = pRegion;
+#endif
+}
+
+void SharedMemoryRing::_unmap(void) {
+	if (this->_pRegion == nullptr)
+		return;
+	if (this->_writer)
+		this->_header().closed.store(1U, std::memory_order_release);
+#ifdef _WIN32
+	UnmapViewOfFile(this->_pRegion);
+	CloseHandle(reinterpret_cast<HANDLE>(this->_handle));
+	this->_handle = nullptr;
+#else
+	munmap(this->_pRegion, this->_regionSize);
+	close(this->_fd);
+	this->_fd = -1;
+	if (this->_writer)
+		shm_unlink(("/" + this->_name).c_str());
+#endif
+	this->_pRegion = nullptr;
+	this->_regionSize = 0U;
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************************
+ * @class	SharedMemoryRing
+ * @brief	SharedMemoryRing class that passes versioned messages from one
+ *			writer process to any number of reader processes on the same
+ *			machine through a named shared memory region.
+ *
+ * The region holds a header and a ring of fixed-size slots. Version `v`
+ * (starting from 1) is written to slot `v % numSlots`. Each slot is guarded
+ * by a sequence number (seqlock): the writer makes it odd before writing the
+ * payload and sets it to `2 * v + 2` afterwards, then publishes `v` as the
+ * latest version. The writer never waits for readers, so publication is
+ * wait-free. Readers only read the latest version and copy it out of the
+ * slot; if the sequence number changed during the copy, the slot was reused
+ * by the writer and the read is retried with the new latest version.
+ * Readers that are slower than the writer therefore skip versions, and
+ * messages must be self-contained or tolerate skipped versions. The last
+ * `numSlots - 1` versions can also be read by number, so the ring doubles
+ * as a bounded history.
+ *
+ * The writer creates the region and removes its name on destruction.
+ * Readers can open the region only after the writer has initialized it.
+ ***********************************************************************/
+class SharedMemoryRing {
+
+public:
+
+	/** @brief	Magic number at the beginning of the region.
+	  */
+	static inline constexpr std::uint32_t MAGIC = 0x474E5253U; // "SRNG"
+
+	/** @brief	Layout version of the region. Readers refuse regions of another layout.
+	  */
+	static inline constexpr std::uint32_t LAYOUT_VERSION = 1U;
+
+	/** @brief	Construct an invalid ring.
+	  */
+	SharedMemoryRing(std::nullptr_t) {}
+
+	/** @brief	Create the region as the writer.
+	  * @param	name_		Name of the region, e.g. "kinectfusion". It must not contain slashes.
+	  * @param	numSlots_	Number of slots. Readers skip versions if they are more than `numSlots_ - 1` versions behind.
+	  * @param	slotSize_	Maximal payload size of a version, in bytes.
+	  */
+	SharedMemoryRing(const std::string& name_, std::uint32_t numSlots_, std::size_t slotSize_);
+
+	/** @brief	Open an existing region as a reader.
+	  *
+	  * Throws `std::runtime_error` if the region does not exist or is not initialized yet.
+	  */
+	explicit SharedMemoryRing(const std::string& name_);
+
+	/** @brief	Disable copy constructor/assignment.
+	  */
+	SharedMemoryRing(const SharedMemoryRing&) = delete;
+	SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+	/** @brief	Move constructor.
+	  */
+	SharedMemoryRing(SharedMemoryRing&& other_) noexcept;
+
+	/** @brief	Move assignment.
+	  */
+	SharedMemoryRing& operator=(SharedMemoryRing&& other_) noexcept;
+
+	/** @brief	Destructor. The writer marks the region as closed and removes its name.
+	  */
+	~SharedMemoryRing(void);
+
+	/** @brief	Check whether the ring is valid.
+	  */
+	explicit operator bool(void) const { return this->_pRegion != nullptr; }
+
+	/** @brief	Get the number of slots.
+	  */
+	std::uint32_t numSlots(void) const;
+
+	/** @brief	Get the maximal payload size of a version.
+	  */
+	std::size_t slotSize(void) const;
+
+	/** @brief	Start writing the next version and get the payload memory of its slot.
+	  *
+	  * Only the writer can call it. The payload is visible to readers after `endWrite`.
+	  * @return	Pointer to `slotSize()` bytes.
+	  */
+	std::byte* beginWrite(void);
+
+	/** @brief	Publish the version started by `beginWrite`.
+	  * @param	size_	Number of payload bytes written.
+	  * @return	The published version.
+	  */
+	std::uint64_t endWrite(std::size_t size_);
+
+	/** @brief	Get the latest published version, or 0 if nothing is published.
+	  */
+	std::uint64_t latestVersion(void) const;
+
+	/** @brief	Check whether the writer has destroyed the ring.
+	  */
+	bool closed(void) const;
+
+	/** @brief	Copy the latest version if it is newer than `lastVersion_`.
+	  *
+	  * This function never blocks. It retries a bounded number of times if the
+	  * writer overwrites the slot during the copy.
+	  * @param	lastVersion_	The last version seen by the caller.
+	  * @param	payload_		Receives the payload.
+	  * @return	The version copied to `payload_`, or std::nullopt if there is no newer
+	  *			version or all retries were torn.
+	  */
+	std::optional<std::uint64_t> read(std::uint64_t lastVersion_, std::vector<std::byte>& payload_) const;
+
+	/** @brief	Copy a given version if it is still in the ring.
+	  *
+	  * This function never blocks. Versions older than the last `numSlots() - 1` ones
+	  * may have been overwritten.
+	  * @param	version_	The version to copy.
+	  * @param	payload_	Receives the payload.
+	  * @return	Whether the version was copied.
+	  */
+	bool readVersion(std::uint64_t version_, std::vector<std::byte>& payload_) const;
+
+	/** @brief	Get the number of reads torn by the writer.
+	  */
+	std::uint64_t numTornReads(void) const { return this->_numTornReads; }
+
+private:
+
+	struct _Header {
+		std::atomic<std::uint32_t> magic;			// Written last by the writer.
+		std::uint32_t layoutVersion;
+		std::uint32_t numSlots;
+		std::uint32_t reserved;
+		std::uint64_t slotSize;
+		std::uint64_t slotStride;
+		std::atomic<std::uint64_t> latestVersion;	// 0 if nothing is published.
+		std::atomic<std::uint32_t> closed;
+	};
+
+	struct _SlotHeader {
+		std::atomic<std::uint64_t> sequence;		// Odd while the slot is written, `2 * v + 2` after version `v` is written.
+		std::uint64_t size;
+	};
+
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free, "Atomics in shared memory must be lock free.");
+
+	/** @brief	Headers and slots are aligned to cache lines.
+	  */
+	static inline constexpr std::size_t _ALIGNMENT = 64U;
+
+	std::string _name{};
+	bool _writer = false;
+	void* _pRegion = nullptr;
+	std::size_t _regionSize = 0U;
+	void* _handle = nullptr;	// File mapping handle on Windows.
+	int _fd = -1;				// File descriptor elsewhere.
+	std::uint64_t _writeVersion = 0ULL;
+	mutable std::uint64_t _numTornReads = 0ULL;
+
+	_Header& _header(void) const { return *reinterpret_cast<_Header*>(this->_pRegion); }
+	_SlotHeader& _slotHeader(std::uint64_t version_) const;
+	std::byte* _slotPayload(std::uint64_t version_) const;
+	void _map(bool create_);
+	void _unmap(void);
+
+};
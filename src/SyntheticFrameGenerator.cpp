@@ -0,0 +1,191 @@
+#include "SyntheticFrameGenerator.hpp"
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#define VK_THROW(err) \
+	throw std::runtime_error("[SyntheticFrameGenerator] Vulkan error in file " + std::string(__FILE__) + " line " + std::to_string(__LINE__) + ": " + vk::to_string(err))
+
+#define VK_CHECK(value) \
+	if (vk::Result err = (value); err != vk::Result::eSuccess) { VK_THROW(err); }
+
+static_assert(sizeof(SyntheticFrameGenerator::Parameters) <= 128U, "Vulkan only guarantees 128 bytes of push constants.");
+
+SyntheticFrameGenerator::SyntheticFrameGenerator(
+	const Engine& engine_,
+	ProceduralDataLoader& dataLoader_
+) :
+	_pEngine(&engine_),
+	_sceneSize(dataLoader_.sceneSize()),
+	_windowRatio(dataLoader_.windowRatio()),
+	_minDepth(dataLoader_.minDepth()),
+	_maxDepth(dataLoader_.maxDepth()),
+	_invalidDepth(dataLoader_.invalidDepth()),
+	_numBoxes(static_cast<std::uint32_t>(dataLoader_.pillars().size()))
+{
+	// Create the box buffer. It is written once, so it stays in host visible memory.
+	{
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(sizeof(SyntheticFrameGenerator::Box) * std::max(this->_numBoxes, 1U))
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer boxBuffer = nullptr;
+		VmaAllocation boxBufferMemory = nullptr;
+		VmaAllocationInfo allocationInfo{};
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &boxBuffer, &boxBufferMemory, &allocationInfo);
+		this->_boxBuffer = vk::raii::Buffer(this->_pEngine->context().device(), boxBuffer);
+		this->_boxBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), boxBufferMemory);
+		SyntheticFrameGenerator::Box* pBoxes = reinterpret_cast<SyntheticFrameGenerator::Box*>(allocationInfo.pMappedData);
+		for (std::uint32_t i = 0; i < this->_numBoxes; ++i) {
+			const ProceduralDataLoader::Box& pillar = dataLoader_.pillars()[i];
+			pBoxes[i].minCorner = jjyou::glsl::vec4(pillar.minCorner, 0.0f);
+			pBoxes[i].maxCorner = jjyou::glsl::vec4(pillar.maxCorner, 0.0f);
+			pBoxes[i].color = jjyou::glsl::vec4(
+				static_cast<float>(pillar.color.x) / 255.0f,
+				static_cast<float>(pillar.color.y) / 255.0f,
+				static_cast<float>(pillar.color.z) / 255.0f,
+				static_cast<float>(pillar.color.w) / 255.0f
+			);
+		}
+	}
+	// Create the descriptor set layout and the descriptor set
+	{
+		vk::DescriptorSetLayoutBinding descriptorSetLayoutBinding = vk::DescriptorSetLayoutBinding()
+			.setBinding(0)
+			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+			.setDescriptorCount(1)
+			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+			.setPImmutableSamplers(nullptr);
+		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
+			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
+			.setBindings(descriptorSetLayoutBinding);
+		this->_descriptorSetLayout = this->_pEngine->descriptorAllocator().createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+		this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(*this->_descriptorSetLayout);
+		vk::DescriptorBufferInfo descriptorBufferInfo = vk::DescriptorBufferInfo()
+			.setBuffer(*this->_boxBuffer)
+			.setOffset(0)
+			.setRange(VK_WHOLE_SIZE);
+		vk::WriteDescriptorSet writeDescriptorSet = vk::WriteDescriptorSet()
+			.setDstSet(*this->_descriptorSet)
+			.setDstBinding(0)
+			.setDstArrayElement(0)
+			.setDescriptorCount(1)
+			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+			.setBufferInfo(descriptorBufferInfo);
+		this->_pEngine->context().device().updateDescriptorSets(writeDescriptorSet, nullptr);
+	}
+	// Create the pipeline
+	{
+		std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {
+			*this->_pEngine->surfaceStorageDescriptorSetLayout(MaterialType::Simple),
+			*this->_descriptorSetLayout
+		};
+		vk::PushConstantRange pushConstantRange = vk::PushConstantRange()
+			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+			.setOffset(0U)
+			.setSize(sizeof(SyntheticFrameGenerator::Parameters));
+		vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo()
+			.setFlags(vk::PipelineLayoutCreateFlags(0))
+			.setSetLayouts(descriptorSetLayouts)
+			.setPushConstantRanges(pushConstantRange);
+		this->_pipelineLayout = vk::raii::PipelineLayout(this->_pEngine->context().device(), pipelineLayoutCreateInfo);
+#include "spv/syntheticFrame.comp.spv.h"
+		vk::raii::ShaderModule shaderModule(this->_pEngine->context().device(), vk::ShaderModuleCreateInfo()
+			.setFlags(vk::ShaderModuleCreateFlags(0))
+			.setPCode(reinterpret_cast<const uint32_t*>(syntheticFrame_comp_spv))
+			.setCodeSize(sizeof(syntheticFrame_comp_spv))
+		);
+		vk::ComputePipelineCreateInfo computePipelineCreateInfo = vk::ComputePipelineCreateInfo()
+			.setFlags(vk::PipelineCreateFlags(0))
+			.setStage(
+				vk::PipelineShaderStageCreateInfo()
+				.setFlags(vk::PipelineShaderStageCreateFlags(0))
+				.setStage(vk::ShaderStageFlagBits::eCompute)
+				.setModule(*shaderModule)
+				.setPName("main")
+				.setPSpecializationInfo(nullptr)
+			)
+			.setLayout(*this->_pipelineLayout)
+			.setBasePipelineHandle(nullptr)
+			.setBasePipelineIndex(0);
+		this->_pipeline = vk::raii::Pipeline(this->_pEngine->context().device(), nullptr, computePipelineCreateInfo);
+	}
+	// Create the command buffer and the fence
+	{
+		this->_commandBuffer = std::move(this->_pEngine->context().device().allocateCommandBuffers(
+			vk::CommandBufferAllocateInfo()
+			.setCommandPool(*this->_pEngine->commandPool(jjyou::vk::Context::QueueType::Compute))
+			.setLevel(vk::CommandBufferLevel::ePrimary)
+			.setCommandBufferCount(1)
+		)[0]);
+		this->_fence = vk::raii::Fence(
+			this->_pEngine->context().device(),
+			vk::FenceCreateInfo(vk::FenceCreateFlags(0))
+		);
+	}
+}
+
+void SyntheticFrameGenerator::generate(
+	const Surface<MaterialType::Simple>& surface_,
+	const Camera& camera_,
+	const jjyou::glsl::mat4& view_
+) const {
+	jjyou::glsl::mat3 projection = camera_.getVisionProjection();
+	jjyou::glsl::vec3 roomHalfSize = this->_sceneSize * 0.5f;
+	SyntheticFrameGenerator::Parameters parameters{
+		.invView = jjyou::glsl::inverse(view_),
+		.fx = projection[0][0],
+		.fy = projection[1][1],
+		.cx = projection[2][0],
+		.cy = projection[2][1],
+		.roomHalfSizeX = roomHalfSize.x,
+		.roomHalfSizeY = roomHalfSize.y,
+		.roomHalfSizeZ = roomHalfSize.z,
+		.windowRatio = this->_windowRatio,
+		.minDepth = this->_minDepth,
+		.maxDepth = this->_maxDepth,
+		.invalidDepth = this->_invalidDepth,
+		.numBoxes = this->_numBoxes,
+	};
+	this->_commandBuffer.begin(
+		vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	this->_commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_pipeline);
+	surface_.bindStorage(this->_commandBuffer, vk::PipelineBindPoint::eCompute, this->_pipelineLayout, 0);
+	this->_commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *this->_pipelineLayout, 1, *this->_descriptorSet, nullptr);
+	this->_commandBuffer.pushConstants<SyntheticFrameGenerator::Parameters>(*this->_pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0U, parameters);
+	this->_commandBuffer.dispatch(
+		(surface_.texture(1).extent().width + SyntheticFrameGenerator::_workGroupSize.x - 1U) / SyntheticFrameGenerator::_workGroupSize.x,
+		(surface_.texture(1).extent().height + SyntheticFrameGenerator::_workGroupSize.y - 1U) / SyntheticFrameGenerator::_workGroupSize.y,
+		1U
+	);
+	this->_commandBuffer.end();
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(*this->_commandBuffer)
+		.setSignalSemaphores(nullptr),
+		*this->_fence
+	);
+	vk::Result waitResult = this->_pEngine->waitForFences(*this->_fence);
+	VK_CHECK(waitResult);
+	this->_pEngine->context().device().resetFences(*this->_fence);
+	this->_commandBuffer.reset(vk::CommandBufferResetFlags(0));
+}
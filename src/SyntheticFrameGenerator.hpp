@@ -0,0 +1,106 @@
+#pragma once
+#include <vulkan/vulkan_raii.hpp>
+#include <jjyou/vk/Vulkan.hpp>
+#include <jjyou/glsl/glsl.hpp>
+#include <cstdint>
+#include "Engine.hpp"
+#include "Texture.hpp"
+#include "Camera.hpp"
+#include "DataLoader.hpp"
+#include "DescriptorAllocator.hpp"
+
+/***********************************************************************
+ * @class	SyntheticFrameGenerator
+ * @brief	SyntheticFrameGenerator class that renders the frames of a
+ *			`ProceduralDataLoader` directly into input surfaces on the
+ *			compute queue (see `syntheticFrame.comp`).
+ *
+ *	No frame data is decoded, stored in host memory, or uploaded, so the
+ *	input stage costs one small dispatch per frame. It is used to measure
+ *	the throughput of the GPU pipeline alone, at arbitrary resolutions.
+ *	The data loader should be created with `hostRendering_ = false`, and
+ *	still provides the camera and the groundtruth pose of each frame.
+ ***********************************************************************/
+class SyntheticFrameGenerator {
+
+public:
+
+	/** @brief	Push constants of `syntheticFrame.comp`.
+	  */
+	struct Parameters {
+		jjyou::glsl::mat4 invView;
+		float fx, fy, cx, cy;
+		float roomHalfSizeX, roomHalfSizeY, roomHalfSizeZ;
+		float windowRatio;
+		float minDepth;
+		float maxDepth;
+		float invalidDepth;
+		std::uint32_t numBoxes;
+	};
+
+	/** @brief	Box in the storage buffer of `syntheticFrame.comp`.
+	  */
+	struct Box {
+		jjyou::glsl::vec4 minCorner;
+		jjyou::glsl::vec4 maxCorner;
+		jjyou::glsl::vec4 color;
+	};
+
+	/** @brief	Construct an invalid generator.
+	  */
+	SyntheticFrameGenerator(std::nullptr_t) {}
+
+	/** @brief	Create the pipeline and upload the scene of the data loader.
+	  */
+	SyntheticFrameGenerator(
+		const Engine& engine_,
+		ProceduralDataLoader& dataLoader_
+	);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	SyntheticFrameGenerator(const SyntheticFrameGenerator&) = delete;
+	SyntheticFrameGenerator(SyntheticFrameGenerator&&) = delete;
+	SyntheticFrameGenerator& operator=(const SyntheticFrameGenerator&) = delete;
+	SyntheticFrameGenerator& operator=(SyntheticFrameGenerator&&) = delete;
+
+	/** @brief	Destructor.
+	  */
+	~SyntheticFrameGenerator(void) = default;
+
+	/** @brief	Render a frame into the color and depth textures of a surface.
+	  *
+	  * The function returns after the GPU finishes rendering.
+	  * @param	surface_	The input surface. Its textures must have been created.
+	  * @param	camera_		The camera of the frame.
+	  * @param	view_		The groundtruth view matrix of the frame.
+	  */
+	void generate(
+		const Surface<MaterialType::Simple>& surface_,
+		const Camera& camera_,
+		const jjyou::glsl::mat4& view_
+	) const;
+
+private:
+
+	const Engine* _pEngine = nullptr;
+	jjyou::glsl::vec3 _sceneSize{};
+	float _windowRatio = 0.0f;
+	float _minDepth = 0.0f;
+	float _maxDepth = 0.0f;
+	float _invalidDepth = 0.0f;
+	std::uint32_t _numBoxes = 0U;
+	vk::raii::Buffer _boxBuffer{ nullptr };
+	jjyou::vk::VmaAllocation _boxBufferMemory{ nullptr };
+	vk::raii::DescriptorSetLayout _descriptorSetLayout{ nullptr };
+	PooledDescriptorSet _descriptorSet{ nullptr };
+	vk::raii::PipelineLayout _pipelineLayout{ nullptr };
+	vk::raii::Pipeline _pipeline{ nullptr };
+	vk::raii::CommandBuffer _commandBuffer{ nullptr };
+	vk::raii::Fence _fence{ nullptr };
+
+	/** @brief	Work group size of `syntheticFrame.comp`.
+	  */
+	static inline constexpr jjyou::glsl::uvec2 _workGroupSize{ 32U, 32U };
+
+};
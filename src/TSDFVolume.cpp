@@ -1,5 +1,10 @@
 #include "TSDFVolume.hpp"
 #include "KinectFusion.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <cstring>
+#include <cstddef>
 
 #define VK_THROW(err) \
 	throw std::runtime_error("[TSDFVolume] Vulkan error in file " + std::string(__FILE__) + " line " + std::to_string(__LINE__) + ": " + vk::to_string(err))
@@ -13,7 +18,9 @@ TSDFVolume::TSDFVolume(
 	const jjyou::glsl::uvec3& resolution_,
 	float size_,
 	std::optional<jjyou::glsl::vec3> corner_,
-	std::optional<float> truncationDistance_
+	std::optional<float> truncationDistance_,
+	bool sparse_,
+	std::optional<std::uint32_t> colorBrickCapacity_
 ) :
 	_pEngine(&engine_),
 	_pKinectFusion(&kinectFusion_),
@@ -22,15 +29,366 @@ TSDFVolume::TSDFVolume(
 	_size(size_),
 	_corner(corner_.has_value() ? (*corner_) : (-(resolution_ - 1U).cast<float>() * size_ / 2.0f)),
 	_truncationDistance(truncationDistance_.has_value() ? (*truncationDistance_) : (3.0f * size_)),
-	_bufferSize(sizeof(TSDFVolume::TSDFParams) + sizeof(jjyou::glsl::ivec2) * this->_resolution.x * this->_resolution.y * this->_resolution.z)
+	_bufferSize(sizeof(TSDFVolume::TSDFParams) + sizeof(std::int32_t) * this->_resolution.x * this->_resolution.y * this->_resolution.z),
+	_brickResolution((resolution_ + (TSDFVolume::BRICK_SIZE - 2U)) / TSDFVolume::BRICK_SIZE),
+	_numBricks(this->_brickResolution.x * this->_brickResolution.y * this->_brickResolution.z),
+	_colorBrickResolution((resolution_ + (TSDFVolume::BRICK_SIZE - 1U)) / TSDFVolume::BRICK_SIZE),
+	_numColorBricks(this->_colorBrickResolution.x * this->_colorBrickResolution.y * this->_colorBrickResolution.z)
 {
+	this->_colorBrickCapacity = std::clamp(
+		colorBrickCapacity_.value_or((this->_numColorBricks + TSDFVolume::DEFAULT_COLOR_BRICK_RATIO - 1U) / TSDFVolume::DEFAULT_COLOR_BRICK_RATIO),
+		1U,
+		this->_numColorBricks
+	);
+	// Fall back to a dense volume if sparse residency buffers are not supported.
+	if (sparse_) {
+		std::uint32_t computeQueueFamilyIndex = *this->_pEngine->context().queueFamilyIndex(jjyou::vk::Context::QueueType::Compute);
+		vk::QueueFlags computeQueueFlags = this->_pEngine->context().physicalDevice().getQueueFamilyProperties()[computeQueueFamilyIndex].queueFlags;
+		this->_sparse =
+			this->_pEngine->enabledFeatures().sparseBinding &&
+			this->_pEngine->enabledFeatures().sparseResidencyBuffer &&
+			static_cast<bool>(computeQueueFlags & vk::QueueFlagBits::eSparseBinding);
+	}
 	this->_createStorageBuffer();
+	this->_createPageTable();
+	this->_createBrickFlags();
+	this->_createColorBricks();
 	this->_createDescriptorSet();
 }
 
+std::uint32_t TSDFVolume::numAllocatedColorBricks(void) const {
+	const TSDFVolume::ColorBrickTableHeader* pHeader = reinterpret_cast<const TSDFVolume::ColorBrickTableHeader*>(this->_colorBrickReadbackMemoryMappedAddress);
+	return std::min(pHeader->numRequestedBricks, this->_colorBrickCapacity);
+}
+
+std::uint32_t TSDFVolume::numDroppedColorBricks(void) const {
+	const TSDFVolume::ColorBrickTableHeader* pHeader = reinterpret_cast<const TSDFVolume::ColorBrickTableHeader*>(this->_colorBrickReadbackMemoryMappedAddress);
+	return pHeader->numRequestedBricks - std::min(pHeader->numRequestedBricks, this->_colorBrickCapacity);
+}
+
+void TSDFVolume::recordColorBrickReadback(const vk::raii::CommandBuffer& commandBuffer_) const {
+	commandBuffer_.pipelineBarrier(
+		vk::PipelineStageFlagBits::eComputeShader,
+		vk::PipelineStageFlagBits::eTransfer,
+		vk::DependencyFlags(0),
+		vk::MemoryBarrier()
+		.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+		.setDstAccessMask(vk::AccessFlagBits::eTransferRead),
+		nullptr,
+		nullptr
+	);
+	commandBuffer_.copyBuffer(
+		*this->_colorBrickTable,
+		*this->_colorBrickReadback,
+		vk::BufferCopy()
+		.setSrcOffset(0ULL)
+		.setDstOffset(0ULL)
+		.setSize(sizeof(TSDFVolume::ColorBrickTableHeader))
+	);
+	commandBuffer_.pipelineBarrier(
+		vk::PipelineStageFlagBits::eTransfer,
+		vk::PipelineStageFlagBits::eHost,
+		vk::DependencyFlags(0),
+		vk::MemoryBarrier()
+		.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+		.setDstAccessMask(vk::AccessFlagBits::eHostRead),
+		nullptr,
+		nullptr
+	);
+}
+
+void TSDFVolume::resetColorBricks(void) {
+	TSDFVolume::ColorBrickTableHeader header{
+		.numRequestedBricks = 0U,
+		.capacity = this->_colorBrickCapacity
+	};
+	*reinterpret_cast<TSDFVolume::ColorBrickTableHeader*>(this->_colorBrickReadbackMemoryMappedAddress) = header;
+	this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	this->_commandBuffer.updateBuffer<TSDFVolume::ColorBrickTableHeader>(*this->_colorBrickTable, 0ULL, header);
+	this->_commandBuffer.fillBuffer(*this->_colorBrickTable, sizeof(TSDFVolume::ColorBrickTableHeader), VK_WHOLE_SIZE, 0U);
+	// Colors are packed with `packUnorm4x8`. Voxels that have no color yet are 0, i.e. have zero alpha.
+	this->_commandBuffer.fillBuffer(*this->_colorBricks, 0ULL, VK_WHOLE_SIZE, 0U);
+	this->_commandBuffer.end();
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(*this->_commandBuffer)
+		.setSignalSemaphores(nullptr),
+		*this->_fence
+	);
+	vk::Result waitResult = this->_pEngine->waitForFences(*this->_fence);
+	VK_CHECK(waitResult);
+	this->_pEngine->context().device().resetFences(*this->_fence);
+	this->_commandBuffer.reset(vk::CommandBufferResetFlags(0));
+}
+
+std::vector<std::uint32_t> TSDFVolume::takeModifiedBricks(void) {
+	std::uint32_t* pModifiedBricks = reinterpret_cast<std::uint32_t*>(this->_modifiedBricksMemoryMappedAddress);
+	std::uint32_t numModifiedBricks = std::min(pModifiedBricks[0], this->_numBricks);
+	std::vector<std::uint32_t> bricks(pModifiedBricks + 1, pModifiedBricks + 1 + numModifiedBricks);
+	pModifiedBricks[0] = 0U;
+	return bricks;
+}
+
+void TSDFVolume::resetModifiedBricks(void) {
+	reinterpret_cast<std::uint32_t*>(this->_modifiedBricksMemoryMappedAddress)[0] = 0U;
+	this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	this->_commandBuffer.fillBuffer(*this->_brickFlags, 0ULL, VK_WHOLE_SIZE, 0U);
+	this->_commandBuffer.end();
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(*this->_commandBuffer)
+		.setSignalSemaphores(nullptr),
+		*this->_fence
+	);
+	vk::Result waitResult = this->_pEngine->waitForFences(*this->_fence);
+	VK_CHECK(waitResult);
+	this->_pEngine->context().device().resetFences(*this->_fence);
+	this->_commandBuffer.reset(vk::CommandBufferResetFlags(0));
+}
+
+std::uint32_t TSDFVolume::commitRequestedPages(void) {
+	if (!this->_sparse)
+		return 0U;
+	std::uint32_t* pPageRequests = reinterpret_cast<std::uint32_t*>(this->_pageRequestsMemoryMappedAddress);
+	std::uint32_t numRequests = std::min(pPageRequests[0], this->_numPages);
+	std::vector<std::uint32_t> pages(pPageRequests + 1, pPageRequests + 1 + numRequests);
+	pPageRequests[0] = 0U;
+	this->_updatePages(pages, true);
+	return numRequests;
+}
+
+void TSDFVolume::releasePages(void) {
+	if (!this->_sparse)
+		return;
+	// The first page contains the header. Never release it.
+	std::vector<std::uint32_t> pages;
+	for (std::uint32_t page = 1U; page < this->_numPages; ++page)
+		if (*this->_pageMemory[page] != nullptr)
+			pages.push_back(page);
+	this->_updatePages(pages, false);
+}
+
+void TSDFVolume::save(const std::filesystem::path& path_) const {
+	std::ofstream file(path_, std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("[TSDFVolume] Cannot open \"" + path_.string() + "\" for writing.");
+	}
+	vk::DeviceSize colorBrickTableSize = sizeof(TSDFVolume::ColorBrickTableHeader) + sizeof(std::uint32_t) * this->_numColorBricks;
+	vk::DeviceSize stagingSize = std::max(TSDFVolume::_FILE_STAGING_SIZE, colorBrickTableSize);
+	void* pMappedData = nullptr;
+	auto [stagingBuffer, stagingBufferMemory] = this->_createStagingBuffer(stagingSize, pMappedData);
+	std::byte* pStaging = reinterpret_cast<std::byte*>(pMappedData);
+	// Write the header and the color brick indirection table.
+	this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	this->_commandBuffer.copyBuffer(*this->_colorBrickTable, *stagingBuffer, vk::BufferCopy(0ULL, 0ULL, colorBrickTableSize));
+	this->_commandBuffer.end();
+	this->_submitAndWait();
+	TSDFVolume::ColorBrickTableHeader colorBrickTableHeader{};
+	std::memcpy(&colorBrickTableHeader, pStaging, sizeof(colorBrickTableHeader));
+	TSDFVolume::FileHeader header{
+		.magic = TSDFVolume::FILE_MAGIC,
+		.version = TSDFVolume::FILE_VERSION,
+		.resolution = this->_resolution,
+		.size = this->_size,
+		.corner = this->_corner,
+		.truncationDistance = this->_truncationDistance,
+		.colorBrickCapacity = this->_colorBrickCapacity,
+		.numColorBricks = std::min(colorBrickTableHeader.numRequestedBricks, this->_colorBrickCapacity),
+		.numChunks = 0ULL
+	};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(pStaging), static_cast<std::streamsize>(colorBrickTableSize));
+	// Write the allocated slots of the pool. Slots are allocated in order.
+	std::uint32_t colorBricksPerBatch = static_cast<std::uint32_t>(stagingSize / TSDFVolume::COLOR_BRICK_SIZE);
+	for (std::uint32_t firstSlot = 0U; firstSlot < header.numColorBricks; firstSlot += colorBricksPerBatch) {
+		vk::DeviceSize size = std::min(colorBricksPerBatch, header.numColorBricks - firstSlot) * TSDFVolume::COLOR_BRICK_SIZE;
+		this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+			.setPInheritanceInfo(nullptr)
+		);
+		this->_commandBuffer.copyBuffer(*this->_colorBricks, *stagingBuffer, vk::BufferCopy(firstSlot * TSDFVolume::COLOR_BRICK_SIZE, 0ULL, size));
+		this->_commandBuffer.end();
+		this->_submitAndWait();
+		file.write(reinterpret_cast<const char*>(pStaging), static_cast<std::streamsize>(size));
+	}
+	// Write the non-empty chunks of voxels, batch by batch.
+	// Non-resident pages are not copied. They are left as zero in the staging buffer.
+	std::uint64_t numVoxels = static_cast<std::uint64_t>(this->_resolution.x) * this->_resolution.y * this->_resolution.z;
+	vk::DeviceSize chunkSize = sizeof(std::int32_t) * TSDFVolume::FILE_CHUNK_SIZE;
+	std::uint64_t numChunks = (numVoxels + TSDFVolume::FILE_CHUNK_SIZE - 1ULL) / TSDFVolume::FILE_CHUNK_SIZE;
+	std::uint64_t chunksPerBatch = stagingSize / chunkSize;
+	for (std::uint64_t firstChunk = 0ULL; firstChunk < numChunks; firstChunk += chunksPerBatch) {
+		std::uint64_t endChunk = std::min(firstChunk + chunksPerBatch, numChunks);
+		std::memset(pStaging, 0, static_cast<std::size_t>((endChunk - firstChunk) * chunkSize));
+		std::vector<vk::BufferCopy> regions{};
+		for (std::uint64_t chunk = firstChunk; chunk < endChunk; ++chunk) {
+			vk::DeviceSize beginOffset = sizeof(TSDFVolume::TSDFParams) + chunk * chunkSize;
+			vk::DeviceSize endOffset = sizeof(TSDFVolume::TSDFParams) + std::min((chunk + 1ULL) * TSDFVolume::FILE_CHUNK_SIZE, numVoxels) * sizeof(std::int32_t);
+			for (vk::DeviceSize pageBegin = beginOffset / this->_pageSize * this->_pageSize; pageBegin < endOffset; pageBegin += this->_pageSize) {
+				std::uint32_t page = static_cast<std::uint32_t>(pageBegin / this->_pageSize);
+				if (this->_sparse && *this->_pageMemory[page] == nullptr)
+					continue;
+				vk::DeviceSize srcOffset = std::max(pageBegin, beginOffset);
+				vk::DeviceSize size = std::min(pageBegin + this->_pageSize, endOffset) - srcOffset;
+				regions.push_back(vk::BufferCopy(srcOffset, (chunk - firstChunk) * chunkSize + (srcOffset - beginOffset), size));
+			}
+		}
+		if (regions.empty())
+			continue;
+		this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+			.setPInheritanceInfo(nullptr)
+		);
+		this->_commandBuffer.copyBuffer(*this->_volume, *stagingBuffer, regions);
+		this->_commandBuffer.end();
+		this->_submitAndWait();
+		for (std::uint64_t chunk = firstChunk; chunk < endChunk; ++chunk) {
+			std::uint64_t firstVoxel = chunk * TSDFVolume::FILE_CHUNK_SIZE;
+			std::uint64_t chunkNumVoxels = std::min(TSDFVolume::FILE_CHUNK_SIZE, numVoxels - firstVoxel);
+			const std::int32_t* pVoxels = reinterpret_cast<const std::int32_t*>(pStaging + (chunk - firstChunk) * chunkSize);
+			if (std::all_of(pVoxels, pVoxels + chunkNumVoxels, [](std::int32_t voxel_) { return voxel_ == 0; }))
+				continue;
+			file.write(reinterpret_cast<const char*>(&firstVoxel), sizeof(firstVoxel));
+			file.write(reinterpret_cast<const char*>(pVoxels), static_cast<std::streamsize>(sizeof(std::int32_t) * chunkNumVoxels));
+			++header.numChunks;
+		}
+	}
+	file.seekp(offsetof(TSDFVolume::FileHeader, numChunks));
+	file.write(reinterpret_cast<const char*>(&header.numChunks), sizeof(header.numChunks));
+	if (!file) {
+		throw std::runtime_error("[TSDFVolume] Failed to write \"" + path_.string() + "\".");
+	}
+}
+
+void TSDFVolume::load(const std::filesystem::path& path_) {
+	TSDFVolume::FileHeader header = TSDFVolume::readFileHeader(path_);
+	if (header.resolution.x != this->_resolution.x || header.resolution.y != this->_resolution.y || header.resolution.z != this->_resolution.z ||
+		header.corner.x != this->_corner.x || header.corner.y != this->_corner.y || header.corner.z != this->_corner.z ||
+		header.size != this->_size ||
+		header.truncationDistance != this->_truncationDistance
+	) {
+		throw std::runtime_error("[TSDFVolume] \"" + path_.string() + "\" was saved from a volume with other parameters.");
+	}
+	if (header.numColorBricks > this->_colorBrickCapacity) {
+		throw std::runtime_error("[TSDFVolume] \"" + path_.string() + "\" has " + std::to_string(header.numColorBricks) + " color bricks, but the pool only has " + std::to_string(this->_colorBrickCapacity) + " slots.");
+	}
+	std::ifstream file(path_, std::ios::binary);
+	file.seekg(sizeof(header));
+	vk::DeviceSize colorBrickTableSize = sizeof(TSDFVolume::ColorBrickTableHeader) + sizeof(std::uint32_t) * this->_numColorBricks;
+	vk::DeviceSize stagingSize = std::max(TSDFVolume::_FILE_STAGING_SIZE, colorBrickTableSize);
+	void* pMappedData = nullptr;
+	auto [stagingBuffer, stagingBufferMemory] = this->_createStagingBuffer(stagingSize, pMappedData);
+	std::byte* pStaging = reinterpret_cast<std::byte*>(pMappedData);
+	auto readFile = [&](void* pData_, std::size_t size_) {
+		file.read(reinterpret_cast<char*>(pData_), static_cast<std::streamsize>(size_));
+		if (!file) {
+			throw std::runtime_error("[TSDFVolume] \"" + path_.string() + "\" is truncated.");
+		}
+	};
+	// Read the color brick indirection table. The allocated slots keep their indices,
+	// and the header takes the capacity of this pool.
+	readFile(pStaging, static_cast<std::size_t>(colorBrickTableSize));
+	TSDFVolume::ColorBrickTableHeader colorBrickTableHeader{};
+	std::memcpy(&colorBrickTableHeader, pStaging, sizeof(colorBrickTableHeader));
+	colorBrickTableHeader.capacity = this->_colorBrickCapacity;
+	std::memcpy(pStaging, &colorBrickTableHeader, sizeof(colorBrickTableHeader));
+	*reinterpret_cast<TSDFVolume::ColorBrickTableHeader*>(this->_colorBrickReadbackMemoryMappedAddress) = colorBrickTableHeader;
+	this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	this->_commandBuffer.copyBuffer(*stagingBuffer, *this->_colorBrickTable, vk::BufferCopy(0ULL, 0ULL, colorBrickTableSize));
+	this->_commandBuffer.end();
+	this->_submitAndWait();
+	// Read the allocated slots of the pool.
+	std::uint32_t colorBricksPerBatch = static_cast<std::uint32_t>(stagingSize / TSDFVolume::COLOR_BRICK_SIZE);
+	for (std::uint32_t firstSlot = 0U; firstSlot < header.numColorBricks; firstSlot += colorBricksPerBatch) {
+		vk::DeviceSize size = std::min(colorBricksPerBatch, header.numColorBricks - firstSlot) * TSDFVolume::COLOR_BRICK_SIZE;
+		readFile(pStaging, static_cast<std::size_t>(size));
+		this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+			.setPInheritanceInfo(nullptr)
+		);
+		this->_commandBuffer.copyBuffer(*stagingBuffer, *this->_colorBricks, vk::BufferCopy(0ULL, firstSlot * TSDFVolume::COLOR_BRICK_SIZE, size));
+		this->_commandBuffer.end();
+		this->_submitAndWait();
+	}
+	// Read the chunks of voxels, batch by batch. If the volume is sparse, bind memory for their pages first.
+	std::uint64_t numVoxels = static_cast<std::uint64_t>(this->_resolution.x) * this->_resolution.y * this->_resolution.z;
+	vk::DeviceSize chunkSize = sizeof(std::int32_t) * TSDFVolume::FILE_CHUNK_SIZE;
+	std::uint64_t chunksPerBatch = stagingSize / chunkSize;
+	for (std::uint64_t firstChunk = 0ULL; firstChunk < header.numChunks; firstChunk += chunksPerBatch) {
+		std::uint64_t endChunk = std::min(firstChunk + chunksPerBatch, header.numChunks);
+		std::vector<vk::BufferCopy> regions{};
+		std::vector<std::uint32_t> pages{};
+		for (std::uint64_t chunk = firstChunk; chunk < endChunk; ++chunk) {
+			std::uint64_t firstVoxel = 0ULL;
+			readFile(&firstVoxel, sizeof(firstVoxel));
+			if (firstVoxel % TSDFVolume::FILE_CHUNK_SIZE != 0ULL || firstVoxel >= numVoxels) {
+				throw std::runtime_error("[TSDFVolume] \"" + path_.string() + "\" has an invalid chunk at voxel " + std::to_string(firstVoxel) + ".");
+			}
+			vk::DeviceSize size = sizeof(std::int32_t) * std::min(TSDFVolume::FILE_CHUNK_SIZE, numVoxels - firstVoxel);
+			vk::DeviceSize stagingOffset = (chunk - firstChunk) * chunkSize;
+			readFile(pStaging + stagingOffset, static_cast<std::size_t>(size));
+			vk::DeviceSize dstOffset = sizeof(TSDFVolume::TSDFParams) + sizeof(std::int32_t) * firstVoxel;
+			regions.push_back(vk::BufferCopy(stagingOffset, dstOffset, size));
+			if (this->_sparse) {
+				for (std::uint32_t page = static_cast<std::uint32_t>(dstOffset / this->_pageSize); page <= static_cast<std::uint32_t>((dstOffset + size - 1ULL) / this->_pageSize); ++page)
+					if (*this->_pageMemory[page] == nullptr && (pages.empty() || pages.back() != page))
+						pages.push_back(page);
+			}
+		}
+		this->_updatePages(pages, true);
+		this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+			.setPInheritanceInfo(nullptr)
+		);
+		this->_commandBuffer.copyBuffer(*stagingBuffer, *this->_volume, regions);
+		this->_commandBuffer.end();
+		this->_submitAndWait();
+	}
+	// Put all bricks in the modified list and set their flags, as if fusion had modified them.
+	std::uint32_t* pModifiedBricks = reinterpret_cast<std::uint32_t*>(this->_modifiedBricksMemoryMappedAddress);
+	pModifiedBricks[0] = this->_numBricks;
+	for (std::uint32_t brick = 0U; brick < this->_numBricks; ++brick)
+		pModifiedBricks[1U + brick] = brick;
+	this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	this->_commandBuffer.fillBuffer(*this->_brickFlags, 0ULL, VK_WHOLE_SIZE, 1U);
+	this->_commandBuffer.end();
+	this->_submitAndWait();
+}
+
+TSDFVolume::FileHeader TSDFVolume::readFileHeader(const std::filesystem::path& path_) {
+	std::ifstream file(path_, std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("[TSDFVolume] Cannot open \"" + path_.string() + "\" for reading.");
+	}
+	TSDFVolume::FileHeader header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || header.magic != TSDFVolume::FILE_MAGIC || header.version != TSDFVolume::FILE_VERSION) {
+		throw std::runtime_error("[TSDFVolume] \"" + path_.string() + "\" is not a volume file of version " + std::to_string(TSDFVolume::FILE_VERSION) + ".");
+	}
+	return header;
+}
+
 void TSDFVolume::_createStorageBuffer(void) {
-	// Create a storage buffer.
-	{
+	if (!this->_sparse) {
 		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
 			.setFlags(vk::BufferCreateFlags(0))
 			.setSize(this->_bufferSize)
@@ -52,20 +410,66 @@ void TSDFVolume::_createStorageBuffer(void) {
 		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &storageBuffer, &storageBufferMemory, nullptr);
 		this->_volume = vk::raii::Buffer(this->_pEngine->context().device(), storageBuffer);
 		this->_volumeMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), storageBufferMemory);
+		this->_pageSize = TSDFVolume::DENSE_PAGE_SIZE;
+		this->_numPages = static_cast<std::uint32_t>((this->_bufferSize + this->_pageSize - 1ULL) / this->_pageSize);
+		this->_numResidentPages = this->_numPages;
 	}
-	// Create a staging buffer and copy the header information.
-	// Since the storage buffer is not large, we will do the copy on the compute queue.
-	vk::raii::Buffer stagingBuffer{ nullptr };
-	jjyou::vk::VmaAllocation stagingBufferMemory{ nullptr };
+	else {
+		// Create a sparse storage buffer. Memory is bound page by page in `_updatePages`.
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlagBits::eSparseBinding | vk::BufferCreateFlagBits::eSparseResidency)
+			.setSize(this->_bufferSize)
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		this->_volume = vk::raii::Buffer(this->_pEngine->context().device(), bufferCreateInfo);
+		vk::MemoryRequirements memoryRequirements = this->_volume.getMemoryRequirements();
+		this->_pageSize = memoryRequirements.alignment;
+		this->_numPages = static_cast<std::uint32_t>((memoryRequirements.size + this->_pageSize - 1ULL) / this->_pageSize);
+		this->_numResidentPages = 0U;
+		this->_pageMemory.clear();
+		this->_pageMemory.reserve(this->_numPages);
+		for (std::uint32_t page = 0; page < this->_numPages; ++page)
+			this->_pageMemory.emplace_back(nullptr);
+	}
+}
+
+void TSDFVolume::_createPageTable(void) {
+	// Create a page table storage buffer.
 	{
 		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
 			.setFlags(vk::BufferCreateFlags(0))
-			.setSize(sizeof(TSDFVolume::TSDFParams))
-			.setUsage(vk::BufferUsageFlagBits::eTransferSrc)
+			.setSize(sizeof(TSDFVolume::PageTableHeader) + sizeof(std::uint32_t) * this->_numPages)
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst)
 			.setSharingMode(vk::SharingMode::eExclusive)
 			.setQueueFamilyIndices(nullptr);
 		VmaAllocationCreateInfo vmaAllocationCreateInfo{
-			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+			.flags = VmaAllocationCreateFlags(0),
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer pageTableBuffer = nullptr;
+		VmaAllocation pageTableBufferMemory = nullptr;
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &pageTableBuffer, &pageTableBufferMemory, nullptr);
+		this->_pageTable = vk::raii::Buffer(this->_pEngine->context().device(), pageTableBuffer);
+		this->_pageTableMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), pageTableBufferMemory);
+	}
+	// Create a host visible storage buffer for page requests.
+	// Each page is requested at most once, so the list cannot overflow.
+	{
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(sizeof(std::uint32_t) * (this->_numPages + 1U))
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
 			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
 			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
 			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
@@ -74,60 +478,410 @@ void TSDFVolume::_createStorageBuffer(void) {
 			.pUserData = nullptr,
 			.priority = 0.0f,
 		};
-		VkBuffer pStagingBuffer = nullptr;
-		VmaAllocation pStagingBufferMemory = nullptr;
+		VkBuffer pageRequestsBuffer = nullptr;
+		VmaAllocation pageRequestsBufferMemory = nullptr;
 		VmaAllocationInfo allocationInfo{};
-		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &pStagingBuffer, &pStagingBufferMemory, &allocationInfo);
-		stagingBuffer = vk::raii::Buffer(this->_pEngine->context().device(), pStagingBuffer);
-		stagingBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), pStagingBufferMemory);
-		TSDFVolume::TSDFParams params {
-			.resolution = this->_resolution,
-			.size = this->_size,
-			.corner = this->_corner,
-			.truncationDistance = this->_truncationDistance
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &pageRequestsBuffer, &pageRequestsBufferMemory, &allocationInfo);
+		this->_pageRequests = vk::raii::Buffer(this->_pEngine->context().device(), pageRequestsBuffer);
+		this->_pageRequestsMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), pageRequestsBufferMemory);
+		this->_pageRequestsMemoryMappedAddress = allocationInfo.pMappedData;
+		reinterpret_cast<std::uint32_t*>(this->_pageRequestsMemoryMappedAddress)[0] = 0U;
+	}
+	// Create the command buffer and synchronization objects used to update pages.
+	this->_commandBuffer = std::move(this->_pEngine->context().device().allocateCommandBuffers(
+		vk::CommandBufferAllocateInfo()
+		.setCommandPool(*this->_pEngine->commandPool(jjyou::vk::Context::QueueType::Compute))
+		.setLevel(vk::CommandBufferLevel::ePrimary)
+		.setCommandBufferCount(1)
+	)[0]);
+	this->_fence = vk::raii::Fence(this->_pEngine->context().device(), vk::FenceCreateInfo(vk::FenceCreateFlags(0)));
+	this->_bindSemaphore = vk::raii::Semaphore(this->_pEngine->context().device(), vk::SemaphoreCreateInfo(vk::SemaphoreCreateFlags(0)));
+	// The first page contains the header, so it must be resident before the header is written.
+	if (this->_sparse)
+		this->_updatePages({ 0U }, true);
+	// Write the volume header and the page table.
+	// Since the headers are small, we will write them with `vkCmdUpdateBuffer` on the compute queue.
+	TSDFVolume::TSDFParams params{
+		.resolution = this->_resolution,
+		.size = this->_size,
+		.corner = this->_corner,
+		.truncationDistance = this->_truncationDistance
+	};
+	TSDFVolume::PageTableHeader pageTableHeader{
+		.headerSizeInVoxels = static_cast<std::uint32_t>(sizeof(TSDFVolume::TSDFParams) / sizeof(std::int32_t)),
+		.voxelsPerPage = static_cast<std::uint32_t>(this->_pageSize / sizeof(std::int32_t))
+	};
+	this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	this->_commandBuffer.updateBuffer<TSDFVolume::TSDFParams>(*this->_volume, 0ULL, params);
+	this->_commandBuffer.updateBuffer<TSDFVolume::PageTableHeader>(*this->_pageTable, 0ULL, pageTableHeader);
+	if (this->_sparse)
+		this->_commandBuffer.fillBuffer(*this->_pageTable, sizeof(TSDFVolume::PageTableHeader) + sizeof(std::uint32_t), VK_WHOLE_SIZE, 0U);
+	else
+		this->_commandBuffer.fillBuffer(*this->_pageTable, sizeof(TSDFVolume::PageTableHeader), VK_WHOLE_SIZE, TSDFVolume::PAGE_RESIDENT);
+	this->_commandBuffer.end();
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(*this->_commandBuffer)
+		.setSignalSemaphores(nullptr),
+		*this->_fence
+	);
+	vk::Result waitResult = this->_pEngine->waitForFences(*this->_fence);
+	VK_CHECK(waitResult);
+	this->_pEngine->context().device().resetFences(*this->_fence);
+	this->_commandBuffer.reset(vk::CommandBufferResetFlags(0));
+}
+
+void TSDFVolume::_createBrickFlags(void) {
+	// Create a storage buffer for the modified flags of bricks.
+	{
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(sizeof(std::uint32_t) * this->_numBricks)
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlags(0),
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
 		};
-		memcpy(allocationInfo.pMappedData, &params, sizeof(TSDFVolume::TSDFParams));
+		VkBuffer brickFlagsBuffer = nullptr;
+		VmaAllocation brickFlagsBufferMemory = nullptr;
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &brickFlagsBuffer, &brickFlagsBufferMemory, nullptr);
+		this->_brickFlags = vk::raii::Buffer(this->_pEngine->context().device(), brickFlagsBuffer);
+		this->_brickFlagsMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), brickFlagsBufferMemory);
 	}
-	// Create a compute command buffer and copy staging buffer to the final storage buffer
+	// Create a host visible storage buffer for the modified list.
+	// Each brick is listed at most once, so the list cannot overflow.
 	{
-		vk::raii::CommandBuffer computeCommandBuffer = std::move(this->_pEngine->context().device().allocateCommandBuffers(
-			vk::CommandBufferAllocateInfo()
-			.setCommandPool(*this->_pEngine->commandPool(jjyou::vk::Context::QueueType::Compute))
-			.setLevel(vk::CommandBufferLevel::ePrimary)
-			.setCommandBufferCount(1)
-		)[0]);
-		vk::raii::Fence fence = vk::raii::Fence(this->_pEngine->context().device(), vk::FenceCreateInfo(vk::FenceCreateFlags(0)));
-		computeCommandBuffer.begin(vk::CommandBufferBeginInfo()
-			.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
-			.setPInheritanceInfo(nullptr)
-		);
-		computeCommandBuffer.copyBuffer(*stagingBuffer, *this->_volume, vk::BufferCopy(0, 0, sizeof(TSDFVolume::TSDFParams)));
-		computeCommandBuffer.end();
-		this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
-			vk::SubmitInfo()
-			.setWaitSemaphores(nullptr)
-			.setWaitDstStageMask(nullptr)
-			.setCommandBuffers(*computeCommandBuffer)
-			.setSignalSemaphores(nullptr),
-			*fence
-		);
-		vk::Result waitResult = this->_pEngine->context().device().waitForFences(*fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
-		VK_CHECK(waitResult);
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(sizeof(std::uint32_t) * (this->_numBricks + 1U))
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer modifiedBricksBuffer = nullptr;
+		VmaAllocation modifiedBricksBufferMemory = nullptr;
+		VmaAllocationInfo allocationInfo{};
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &modifiedBricksBuffer, &modifiedBricksBufferMemory, &allocationInfo);
+		this->_modifiedBricks = vk::raii::Buffer(this->_pEngine->context().device(), modifiedBricksBuffer);
+		this->_modifiedBricksMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), modifiedBricksBufferMemory);
+		this->_modifiedBricksMemoryMappedAddress = allocationInfo.pMappedData;
+	}
+	this->resetModifiedBricks();
+}
+
+void TSDFVolume::_createColorBricks(void) {
+	// Create a storage buffer for the indirection table.
+	{
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(sizeof(TSDFVolume::ColorBrickTableHeader) + sizeof(std::uint32_t) * this->_numColorBricks)
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlags(0),
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer colorBrickTableBuffer = nullptr;
+		VmaAllocation colorBrickTableBufferMemory = nullptr;
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &colorBrickTableBuffer, &colorBrickTableBufferMemory, nullptr);
+		this->_colorBrickTable = vk::raii::Buffer(this->_pEngine->context().device(), colorBrickTableBuffer);
+		this->_colorBrickTableMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), colorBrickTableBufferMemory);
+	}
+	// Create a storage buffer for the pool.
+	{
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(this->_colorBrickCapacity * TSDFVolume::COLOR_BRICK_SIZE)
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer colorBricksBuffer = nullptr;
+		VmaAllocation colorBricksBufferMemory = nullptr;
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &colorBricksBuffer, &colorBricksBufferMemory, nullptr);
+		this->_colorBricks = vk::raii::Buffer(this->_pEngine->context().device(), colorBricksBuffer);
+		this->_colorBricksMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), colorBricksBufferMemory);
+	}
+	// Create a host visible buffer that receives the header of the indirection table.
+	{
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(sizeof(TSDFVolume::ColorBrickTableHeader))
+			.setUsage(vk::BufferUsageFlagBits::eTransferDst)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer colorBrickReadbackBuffer = nullptr;
+		VmaAllocation colorBrickReadbackBufferMemory = nullptr;
+		VmaAllocationInfo allocationInfo{};
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &colorBrickReadbackBuffer, &colorBrickReadbackBufferMemory, &allocationInfo);
+		this->_colorBrickReadback = vk::raii::Buffer(this->_pEngine->context().device(), colorBrickReadbackBuffer);
+		this->_colorBrickReadbackMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), colorBrickReadbackBufferMemory);
+		this->_colorBrickReadbackMemoryMappedAddress = allocationInfo.pMappedData;
+	}
+	this->resetColorBricks();
+}
+
+std::pair<vk::raii::Buffer, jjyou::vk::VmaAllocation> TSDFVolume::_createStagingBuffer(vk::DeviceSize size_, void*& pMappedData_) const {
+	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+		.setFlags(vk::BufferCreateFlags(0))
+		.setSize(size_)
+		.setUsage(vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst)
+		.setSharingMode(vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(nullptr);
+	VmaAllocationCreateInfo vmaAllocationCreateInfo{
+		.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+		.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.memoryTypeBits = 0,
+		.pool = nullptr,
+		.pUserData = nullptr,
+		.priority = 0.0f,
+	};
+	VkBuffer stagingBuffer = nullptr;
+	VmaAllocation stagingBufferMemory = nullptr;
+	VmaAllocationInfo allocationInfo{};
+	vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &stagingBuffer, &stagingBufferMemory, &allocationInfo);
+	pMappedData_ = allocationInfo.pMappedData;
+	return {
+		vk::raii::Buffer(this->_pEngine->context().device(), stagingBuffer),
+		jjyou::vk::VmaAllocation(this->_pEngine->allocator(), stagingBufferMemory)
+	};
+}
+
+void TSDFVolume::_submitAndWait(void) const {
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(*this->_commandBuffer)
+		.setSignalSemaphores(nullptr),
+		*this->_fence
+	);
+	vk::Result waitResult = this->_pEngine->waitForFences(*this->_fence);
+	VK_CHECK(waitResult);
+	this->_pEngine->context().device().resetFences(*this->_fence);
+	this->_commandBuffer.reset(vk::CommandBufferResetFlags(0));
+}
+
+void TSDFVolume::_updatePages(const std::vector<std::uint32_t>& pages_, bool resident_) {
+	if (pages_.empty())
+		return;
+	std::uint32_t numPages = static_cast<std::uint32_t>(pages_.size());
+	// Allocate device memory for the pages. Each page is a separate VMA allocation,
+	// so that pages can be released individually.
+	std::vector<vk::SparseMemoryBind> sparseMemoryBinds;
+	sparseMemoryBinds.reserve(numPages);
+	if (resident_) {
+		VkMemoryRequirements memoryRequirements{
+			.size = this->_pageSize,
+			.alignment = this->_pageSize,
+			.memoryTypeBits = this->_volume.getMemoryRequirements().memoryTypeBits
+		};
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlags(0),
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_UNKNOWN,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		std::vector<VmaAllocation> allocations(numPages, nullptr);
+		std::vector<VmaAllocationInfo> allocationInfos(numPages);
+		VkResult allocationResult = vmaAllocateMemoryPages(*this->_pEngine->allocator(), &memoryRequirements, &vmaAllocationCreateInfo, numPages, allocations.data(), allocationInfos.data());
+		if (allocationResult != VK_SUCCESS)
+			throw std::runtime_error("[TSDFVolume] Failed to allocate device memory for " + std::to_string(numPages) + " volume pages.");
+		for (std::uint32_t i = 0; i < numPages; ++i) {
+			this->_pageMemory[pages_[i]] = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), allocations[i]);
+			sparseMemoryBinds.push_back(
+				vk::SparseMemoryBind()
+				.setResourceOffset(pages_[i] * this->_pageSize)
+				.setSize(this->_pageSize)
+				.setMemory(allocationInfos[i].deviceMemory)
+				.setMemoryOffset(allocationInfos[i].offset)
+				.setFlags(vk::SparseMemoryBindFlags(0))
+			);
+		}
+	}
+	else {
+		for (std::uint32_t page : pages_) {
+			sparseMemoryBinds.push_back(
+				vk::SparseMemoryBind()
+				.setResourceOffset(page * this->_pageSize)
+				.setSize(this->_pageSize)
+				.setMemory(nullptr)
+				.setMemoryOffset(0ULL)
+				.setFlags(vk::SparseMemoryBindFlags(0))
+			);
+		}
+	}
+	// Bind or unbind the memory.
+	vk::SparseBufferMemoryBindInfo sparseBufferMemoryBindInfo = vk::SparseBufferMemoryBindInfo()
+		.setBuffer(*this->_volume)
+		.setBinds(sparseMemoryBinds);
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->bindSparse(
+		vk::BindSparseInfo()
+		.setWaitSemaphores(nullptr)
+		.setBufferBinds(sparseBufferMemoryBindInfo)
+		.setImageOpaqueBinds(nullptr)
+		.setImageBinds(nullptr)
+		.setSignalSemaphores(*this->_bindSemaphore),
+		nullptr
+	);
+	// Zero-initialize the new pages and update the page table.
+	this->_commandBuffer.begin(vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	for (std::uint32_t page : pages_) {
+		if (resident_)
+			this->_commandBuffer.fillBuffer(*this->_volume, page * this->_pageSize, this->_pageSize, 0U);
+		this->_commandBuffer.fillBuffer(*this->_pageTable, sizeof(TSDFVolume::PageTableHeader) + sizeof(std::uint32_t) * page, sizeof(std::uint32_t), resident_ ? TSDFVolume::PAGE_RESIDENT : 0U);
+	}
+	this->_commandBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eTransfer,
+		vk::PipelineStageFlagBits::eComputeShader,
+		vk::DependencyFlags(0),
+		vk::MemoryBarrier()
+		.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+		.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite),
+		nullptr,
+		nullptr
+	);
+	this->_commandBuffer.end();
+	vk::PipelineStageFlags waitDstStageMask = vk::PipelineStageFlagBits::eTransfer;
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(*this->_bindSemaphore)
+		.setWaitDstStageMask(waitDstStageMask)
+		.setCommandBuffers(*this->_commandBuffer)
+		.setSignalSemaphores(nullptr),
+		*this->_fence
+	);
+	vk::Result waitResult = this->_pEngine->waitForFences(*this->_fence);
+	VK_CHECK(waitResult);
+	this->_pEngine->context().device().resetFences(*this->_fence);
+	this->_commandBuffer.reset(vk::CommandBufferResetFlags(0));
+	// Release the memory of unbound pages.
+	if (resident_) {
+		this->_numResidentPages += numPages;
+	}
+	else {
+		for (std::uint32_t page : pages_)
+			this->_pageMemory[page] = jjyou::vk::VmaAllocation(nullptr);
+		this->_numResidentPages -= numPages;
 	}
 }
 
 void TSDFVolume::_createDescriptorSet(void) {
-	vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo()
-		.setDescriptorPool(*this->_pEngine->descriptorPool())
-		.setSetLayouts(this->_descriptorSetLayout);
-	this->_descriptorSet = std::move(this->_pEngine->context().device().allocateDescriptorSets(descriptorSetAllocateInfo)[0]);
+	this->_descriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_descriptorSetLayout);
 	vk::DescriptorBufferInfo descriptorBufferInfo(*this->_volume, 0, this->_bufferSize);
-	vk::WriteDescriptorSet writeDescriptorSet = vk::WriteDescriptorSet()
+	vk::DescriptorBufferInfo pageTableDescriptorBufferInfo(*this->_pageTable, 0, VK_WHOLE_SIZE);
+	vk::DescriptorBufferInfo pageRequestsDescriptorBufferInfo(*this->_pageRequests, 0, VK_WHOLE_SIZE);
+	vk::DescriptorBufferInfo brickFlagsDescriptorBufferInfo(*this->_brickFlags, 0, VK_WHOLE_SIZE);
+	vk::DescriptorBufferInfo modifiedBricksDescriptorBufferInfo(*this->_modifiedBricks, 0, VK_WHOLE_SIZE);
+	vk::DescriptorBufferInfo colorBrickTableDescriptorBufferInfo(*this->_colorBrickTable, 0, VK_WHOLE_SIZE);
+	vk::DescriptorBufferInfo colorBricksDescriptorBufferInfo(*this->_colorBricks, 0, VK_WHOLE_SIZE);
+	std::array<vk::WriteDescriptorSet, 7> writeDescriptorSets = {
+		vk::WriteDescriptorSet()
 		.setDstSet(*this->_descriptorSet)
 		.setDstBinding(0)
 		.setDstArrayElement(0)
 		.setDescriptorCount(1)
 		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
-		.setBufferInfo(descriptorBufferInfo);
-	this->_pEngine->context().device().updateDescriptorSets({ writeDescriptorSet }, {});
+		.setBufferInfo(descriptorBufferInfo),
+		vk::WriteDescriptorSet()
+		.setDstSet(*this->_descriptorSet)
+		.setDstBinding(1)
+		.setDstArrayElement(0)
+		.setDescriptorCount(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setBufferInfo(pageTableDescriptorBufferInfo),
+		vk::WriteDescriptorSet()
+		.setDstSet(*this->_descriptorSet)
+		.setDstBinding(2)
+		.setDstArrayElement(0)
+		.setDescriptorCount(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setBufferInfo(pageRequestsDescriptorBufferInfo),
+		vk::WriteDescriptorSet()
+		.setDstSet(*this->_descriptorSet)
+		.setDstBinding(3)
+		.setDstArrayElement(0)
+		.setDescriptorCount(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setBufferInfo(brickFlagsDescriptorBufferInfo),
+		vk::WriteDescriptorSet()
+		.setDstSet(*this->_descriptorSet)
+		.setDstBinding(4)
+		.setDstArrayElement(0)
+		.setDescriptorCount(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setBufferInfo(modifiedBricksDescriptorBufferInfo),
+		vk::WriteDescriptorSet()
+		.setDstSet(*this->_descriptorSet)
+		.setDstBinding(5)
+		.setDstArrayElement(0)
+		.setDescriptorCount(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setBufferInfo(colorBrickTableDescriptorBufferInfo),
+		vk::WriteDescriptorSet()
+		.setDstSet(*this->_descriptorSet)
+		.setDstBinding(6)
+		.setDstArrayElement(0)
+		.setDescriptorCount(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setBufferInfo(colorBricksDescriptorBufferInfo)
+	};
+	this->_pEngine->context().device().updateDescriptorSets(writeDescriptorSets, {});
 }
\ No newline at end of file
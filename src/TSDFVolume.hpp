@@ -3,6 +3,8 @@
 #include <jjyou/vk/Vulkan.hpp>
 #include <jjyou/glsl/glsl.hpp>
 #include <optional>
+#include <vector>
+#include <filesystem>
 #include "Engine.hpp"
 
 class KinectFusion;
@@ -15,6 +17,31 @@ class KinectFusion;
  *	This class follows RAII design pattern. Similar to Vulkan RAII
  *	wrappers, it has a constructor that takes std::nullptr to construct
  *	an empty volume.
+ *
+ *	The volume storage buffer is divided into pages. A page table
+ *	records which pages are backed by device memory. If the volume is
+ *	sparse, the storage buffer is created with sparse residency and only
+ *	the first page (which contains the header) is bound initially. The
+ *	fusion shader appends the pages it needs to write to a request list,
+ *	and the host binds memory for them via `commitRequestedPages` between
+ *	frames. Voxels in non-resident pages are read as zero (i.e. zero
+ *	weight). If the volume is dense, all pages are marked as resident and
+ *	the shaders behave as if the volume was fully committed.
+ *
+ *	The cells of the volume are grouped into bricks of `BRICK_SIZE`^3 cells.
+ *	The fusion shader appends the bricks whose surface may have changed to
+ *	a modified list, which is taken by the host via `takeModifiedBricks`.
+ *
+ *	Colors are only fused near the surface, so they are not stored per voxel.
+ *	The voxels are also grouped into color bricks of `BRICK_SIZE`^3 voxels.
+ *	The fusion shader allocates a color brick from a fixed-size pool when it
+ *	first writes a color in it, and records its slot in an indirection table
+ *	indexed by the color brick. Voxels in unallocated color bricks are read as
+ *	opaque black. If the pool is full, the colors of further color bricks are
+ *	dropped.
+ *
+ *	The volume can be saved to and loaded from a file with `save` and `load`,
+ *	so that a map can be reused by later sessions.
  ***********************************************************************/
 class TSDFVolume {
 
@@ -25,8 +52,8 @@ public:
 	 * @brief	TSDF volume storage buffer header.
 	 * 
 	 * In the compute shader, the TSDF volume storage buffer is made up of
-	 * two parts: The header which includes the parameters; And an array of ivec2
-	 * which includes the data (tsdf + weight + color).
+	 * two parts: The header which includes the parameters; And an array of int
+	 * which includes the data (tsdf + weight).
 	 * This C++ structure corresponds to the header.
 	 ***********************************************************************/
 	struct TSDFParams {
@@ -36,6 +63,83 @@ public:
 		float truncationDistance;
 	};
 
+	/***********************************************************************
+	 * @class	PageTableHeader
+	 * @brief	Page table storage buffer header.
+	 *
+	 * The header is followed by an array of uint flags, one per page.
+	 ***********************************************************************/
+	struct PageTableHeader {
+		std::uint32_t headerSizeInVoxels;	//!< Size of `TSDFParams` in voxels (int).
+		std::uint32_t voxelsPerPage;		//!< Number of voxels (int) in a page.
+	};
+
+	/***********************************************************************
+	 * @class	ColorBrickTableHeader
+	 * @brief	Color brick indirection table storage buffer header.
+	 *
+	 * The header is followed by an array of uint entries, one per color brick.
+	 * An entry is 0 if the color brick is not allocated, and the slot of the
+	 * color brick in the pool plus 1 otherwise.
+	 ***********************************************************************/
+	struct ColorBrickTableHeader {
+		std::uint32_t numRequestedBricks;	//!< Number of color bricks that fusion tried to allocate, including the dropped ones.
+		std::uint32_t capacity;				//!< Number of slots of the pool.
+	};
+
+	/***********************************************************************
+	 * @class	FileHeader
+	 * @brief	Header of a volume file written by `save`.
+	 *
+	 * The header is followed by the color brick indirection table (including
+	 * its header), the allocated slots of the color brick pool, and the
+	 * non-empty chunks of the voxel data. Each chunk is the uint64 index of its
+	 * first voxel followed by up to `FILE_CHUNK_SIZE` voxels (int). Chunks whose
+	 * voxels are all zero (i.e. zero weight) are not written.
+	 ***********************************************************************/
+	struct FileHeader {
+		std::uint32_t magic;
+		std::uint32_t version;
+		jjyou::glsl::uvec3 resolution;
+		float size;
+		jjyou::glsl::vec3 corner;
+		float truncationDistance;
+		std::uint32_t colorBrickCapacity;	//!< Number of slots of the pool of the saved volume.
+		std::uint32_t numColorBricks;		//!< Number of allocated slots written to the file.
+		std::uint64_t numChunks;			//!< Number of voxel chunks written to the file.
+	};
+
+	/** @brief	Magic number and version of volume files.
+	  */
+	static inline constexpr std::uint32_t FILE_MAGIC = 0x46445354U; // "TSDF"
+	static inline constexpr std::uint32_t FILE_VERSION = 1U;
+
+	/** @brief	Number of voxels of a chunk in volume files.
+	  */
+	static inline constexpr std::uint64_t FILE_CHUNK_SIZE = 16384ULL;
+
+	/** @brief	Page flags in the page table.
+	  */
+	static inline constexpr std::uint32_t PAGE_RESIDENT = 1U;
+	static inline constexpr std::uint32_t PAGE_REQUESTED = 2U;
+
+	/** @brief	Page size of a dense volume. The page table is only used to
+	  *			make dense and sparse volumes share the same shaders.
+	  */
+	static inline constexpr vk::DeviceSize DENSE_PAGE_SIZE = 65536ULL;
+
+	/** @brief	Number of cells along each axis of a brick. Must match `tsdfVolumeCommon.h`.
+	  */
+	static inline constexpr std::uint32_t BRICK_SIZE = 8U;
+
+	/** @brief	Size of the colors of a color brick in bytes. Each color is packed into a uint.
+	  */
+	static inline constexpr vk::DeviceSize COLOR_BRICK_SIZE = sizeof(std::uint32_t) * TSDFVolume::BRICK_SIZE * TSDFVolume::BRICK_SIZE * TSDFVolume::BRICK_SIZE;
+
+	/** @brief	By default, the pool has a slot for 1 / `DEFAULT_COLOR_BRICK_RATIO` of the color bricks.
+	  */
+	static inline constexpr std::uint32_t DEFAULT_COLOR_BRICK_RATIO = 8U;
+
 	/** @brief	Construct an empty volume in invalid state.
 	  */
 	TSDFVolume(std::nullptr_t) {}
@@ -49,6 +153,11 @@ public:
 	  *									By default, the volume will be placed such that
 	  *									its center point is at the origin.
 	  * @param	truncationDistance_		Truncation distance. By default, it is 3x the voxel size.
+	  * @param	sparse_					Whether to bind device memory only for the pages touched by fusion.
+	  *									If the device does not support sparse residency buffers,
+	  *									the volume will fall back to a dense volume.
+	  * @param	colorBrickCapacity_		Number of color bricks of the pool. By default, it is
+	  *									1 / `DEFAULT_COLOR_BRICK_RATIO` of the color bricks.
 	  */
 	TSDFVolume(
 		// Vulkan resources
@@ -61,7 +170,9 @@ public:
 		const jjyou::glsl::uvec3& resolution_,
 		float size_,
 		std::optional<jjyou::glsl::vec3> corner_ = std::nullopt,
-		std::optional<float> truncationDistance_ = std::nullopt
+		std::optional<float> truncationDistance_ = std::nullopt,
+		bool sparse_ = false,
+		std::optional<std::uint32_t> colorBrickCapacity_ = std::nullopt
 	);
 
 	/** @brief	Copy constructor is disabled.
@@ -89,8 +200,38 @@ public:
 			this->_corner = other_._corner;
 			this->_truncationDistance = other_._truncationDistance;
 			this->_bufferSize = other_._bufferSize;
+			this->_sparse = other_._sparse;
+			this->_pageSize = other_._pageSize;
+			this->_numPages = other_._numPages;
+			this->_numResidentPages = other_._numResidentPages;
+			this->_brickResolution = other_._brickResolution;
+			this->_numBricks = other_._numBricks;
+			this->_colorBrickResolution = other_._colorBrickResolution;
+			this->_numColorBricks = other_._numColorBricks;
+			this->_colorBrickCapacity = other_._colorBrickCapacity;
 			this->_volume = std::move(other_._volume);
 			this->_volumeMemory = std::move(other_._volumeMemory);
+			this->_pageMemory = std::move(other_._pageMemory);
+			this->_pageTable = std::move(other_._pageTable);
+			this->_pageTableMemory = std::move(other_._pageTableMemory);
+			this->_pageRequests = std::move(other_._pageRequests);
+			this->_pageRequestsMemory = std::move(other_._pageRequestsMemory);
+			this->_pageRequestsMemoryMappedAddress = other_._pageRequestsMemoryMappedAddress;
+			this->_brickFlags = std::move(other_._brickFlags);
+			this->_brickFlagsMemory = std::move(other_._brickFlagsMemory);
+			this->_modifiedBricks = std::move(other_._modifiedBricks);
+			this->_modifiedBricksMemory = std::move(other_._modifiedBricksMemory);
+			this->_modifiedBricksMemoryMappedAddress = other_._modifiedBricksMemoryMappedAddress;
+			this->_colorBrickTable = std::move(other_._colorBrickTable);
+			this->_colorBrickTableMemory = std::move(other_._colorBrickTableMemory);
+			this->_colorBricks = std::move(other_._colorBricks);
+			this->_colorBricksMemory = std::move(other_._colorBricksMemory);
+			this->_colorBrickReadback = std::move(other_._colorBrickReadback);
+			this->_colorBrickReadbackMemory = std::move(other_._colorBrickReadbackMemory);
+			this->_colorBrickReadbackMemoryMappedAddress = other_._colorBrickReadbackMemoryMappedAddress;
+			this->_commandBuffer = std::move(other_._commandBuffer);
+			this->_fence = std::move(other_._fence);
+			this->_bindSemaphore = std::move(other_._bindSemaphore);
 			this->_descriptorSet = std::move(other_._descriptorSet);
 		}
 		return *this;
@@ -126,6 +267,127 @@ public:
 	  */
 	vk::DeviceSize bufferSize(void) const { return this->_bufferSize; }
 
+	/** @brief	Check whether the volume is sparse.
+	  */
+	bool sparse(void) const { return this->_sparse; }
+
+	/** @brief	Get the page size in bytes.
+	  */
+	vk::DeviceSize pageSize(void) const { return this->_pageSize; }
+
+	/** @brief	Get the number of pages.
+	  */
+	std::uint32_t numPages(void) const { return this->_numPages; }
+
+	/** @brief	Get the number of pages backed by device memory.
+	  */
+	std::uint32_t numResidentPages(void) const { return this->_numResidentPages; }
+
+	/** @brief	Get the number of bricks along the x/y/z axis.
+	  */
+	const jjyou::glsl::uvec3& brickResolution(void) const { return this->_brickResolution; }
+
+	/** @brief	Get the number of bricks.
+	  */
+	std::uint32_t numBricks(void) const { return this->_numBricks; }
+
+	/** @brief	Get the number of color bricks along the x/y/z axis.
+	  */
+	const jjyou::glsl::uvec3& colorBrickResolution(void) const { return this->_colorBrickResolution; }
+
+	/** @brief	Get the number of color bricks.
+	  */
+	std::uint32_t numColorBricks(void) const { return this->_numColorBricks; }
+
+	/** @brief	Get the number of slots of the color brick pool.
+	  */
+	std::uint32_t colorBrickCapacity(void) const { return this->_colorBrickCapacity; }
+
+	/** @brief	Get the number of allocated color bricks, as of the last `recordColorBrickReadback`.
+	  */
+	std::uint32_t numAllocatedColorBricks(void) const;
+
+	/** @brief	Get the number of color bricks dropped because the pool was full, as of the last `recordColorBrickReadback`.
+	  */
+	std::uint32_t numDroppedColorBricks(void) const;
+
+	/** @brief	Get the device memory size of the colors, including the pool and the indirection table.
+	  */
+	vk::DeviceSize colorMemorySize(void) const {
+		return this->_colorBrickCapacity * TSDFVolume::COLOR_BRICK_SIZE + sizeof(TSDFVolume::ColorBrickTableHeader) + sizeof(std::uint32_t) * this->_numColorBricks;
+	}
+
+	/** @brief	Get the device memory size that a color per voxel would take.
+	  */
+	vk::DeviceSize denseColorMemorySize(void) const {
+		return sizeof(std::uint32_t) * static_cast<vk::DeviceSize>(this->_resolution.x) * this->_resolution.y * this->_resolution.z;
+	}
+
+	/** @brief	Record the commands that copy the allocation counter of the color bricks to host memory.
+	  *
+	  * Record it after the fusion dispatch. The counter is read by `numAllocatedColorBricks` and
+	  * `numDroppedColorBricks` once the command buffer has completed.
+	  */
+	void recordColorBrickReadback(const vk::raii::CommandBuffer& commandBuffer_) const;
+
+	/** @brief	Free all color bricks.
+	  *
+	  * This function blocks until the pool is cleared. Call it when the volume is reinitialized.
+	  */
+	void resetColorBricks(void);
+
+	/** @brief	Take the linear indices of the bricks modified by fusion since the last call.
+	  *
+	  * The modified list is cleared, but the flags of the bricks stay set, so that a brick
+	  * is not listed again until the consumer clears its flag on the GPU. The list therefore
+	  * never overflows, even if nobody consumes it.
+	  */
+	std::vector<std::uint32_t> takeModifiedBricks(void);
+
+	/** @brief	Clear the modified list and the flags of all bricks.
+	  *
+	  * This function blocks until the flags are cleared. Call it when the volume is reinitialized.
+	  */
+	void resetModifiedBricks(void);
+
+	/** @brief	Bind device memory for the pages requested by the fusion shader.
+	  *
+	  * The newly bound pages are zero-initialized and marked as resident in the page table.
+	  * This function blocks until the pages are ready. Call it after fusion has completed.
+	  * It does nothing if the volume is dense.
+	  * @return	Number of newly bound pages.
+	  */
+	std::uint32_t commitRequestedPages(void);
+
+	/** @brief	Unbind the device memory of all pages except the first one.
+	  *
+	  * This function blocks until the memory is released. Call it before reinitializing
+	  * the volume. It does nothing if the volume is dense.
+	  */
+	void releasePages(void);
+
+	/** @brief	Write the voxels and the colors to a file.
+	  *
+	  * Only the resident pages are read, and the empty chunks are skipped, so the file size is
+	  * proportional to the observed regions. This function blocks until the file is written.
+	  * No fusion may be running.
+	  */
+	void save(const std::filesystem::path& path_) const;
+
+	/** @brief	Read the voxels and the colors from a file written by `save`.
+	  *
+	  * The volume must have been initialized, and must have the resolution, voxel size, corner and
+	  * truncation distance of the saved volume (see `readFileHeader`). Its color brick pool must have
+	  * a slot for each saved color brick. If the volume is sparse, memory is bound for the pages of
+	  * the loaded chunks. All bricks are put in the modified list, so that a mesh cache re-meshes them.
+	  * This function blocks until the volume is loaded.
+	  */
+	void load(const std::filesystem::path& path_);
+
+	/** @brief	Read and validate the header of a file written by `save`.
+	  */
+	static FileHeader readFileHeader(const std::filesystem::path& path_);
+
 	/** @brief	Get the descriptor set layout for the volume storage buffer.
 	  */
 	vk::DescriptorSetLayout descriptorSetLayout(void) const { return this->_descriptorSetLayout; }
@@ -151,19 +413,55 @@ public:
 
 	/** @brief	Create the descriptor set layout for TSDF volume storage buffer.
 	  */
-	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(const vk::raii::Device& device_) {
+	static vk::raii::DescriptorSetLayout createDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
 		std::vector<vk::DescriptorSetLayoutBinding> descriptorSetLayoutBindings = {
 		vk::DescriptorSetLayoutBinding()
 		.setBinding(0)
 		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
 		.setDescriptorCount(1)
 		.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+		.setPImmutableSamplers(nullptr),
+		vk::DescriptorSetLayoutBinding()
+		.setBinding(1)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setDescriptorCount(1)
+		.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+		.setPImmutableSamplers(nullptr),
+		vk::DescriptorSetLayoutBinding()
+		.setBinding(2)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setDescriptorCount(1)
+		.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+		.setPImmutableSamplers(nullptr),
+		vk::DescriptorSetLayoutBinding()
+		.setBinding(3)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setDescriptorCount(1)
+		.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+		.setPImmutableSamplers(nullptr),
+		vk::DescriptorSetLayoutBinding()
+		.setBinding(4)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setDescriptorCount(1)
+		.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+		.setPImmutableSamplers(nullptr),
+		vk::DescriptorSetLayoutBinding()
+		.setBinding(5)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setDescriptorCount(1)
+		.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+		.setPImmutableSamplers(nullptr),
+		vk::DescriptorSetLayoutBinding()
+		.setBinding(6)
+		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setDescriptorCount(1)
+		.setStageFlags(vk::ShaderStageFlagBits::eCompute)
 		.setPImmutableSamplers(nullptr)
 		};
 		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
 			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
 			.setBindings(descriptorSetLayoutBindings);
-		return vk::raii::DescriptorSetLayout(device_, descriptorSetLayoutCreateInfo);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
 	}
 
 private:
@@ -176,10 +474,61 @@ private:
 	jjyou::glsl::vec3 _corner{};
 	float _truncationDistance = 0.0f;
 	vk::DeviceSize _bufferSize = 0ULL;
+	bool _sparse = false;
+	vk::DeviceSize _pageSize = 0ULL;
+	std::uint32_t _numPages = 0U;
+	std::uint32_t _numResidentPages = 0U;
+	jjyou::glsl::uvec3 _brickResolution{};
+	std::uint32_t _numBricks = 0U;
+	jjyou::glsl::uvec3 _colorBrickResolution{};
+	std::uint32_t _numColorBricks = 0U;
+	std::uint32_t _colorBrickCapacity = 0U;
+	std::vector<jjyou::vk::VmaAllocation> _pageMemory{};				// Only used by sparse volumes. One allocation per page.
 	vk::raii::Buffer _volume{ nullptr };
-	jjyou::vk::VmaAllocation _volumeMemory{ nullptr };
-	vk::raii::DescriptorSet _descriptorSet{ nullptr };
+	jjyou::vk::VmaAllocation _volumeMemory{ nullptr };					// Only used by dense volumes.
+	vk::raii::Buffer _pageTable{ nullptr };
+	jjyou::vk::VmaAllocation _pageTableMemory{ nullptr };
+	vk::raii::Buffer _pageRequests{ nullptr };
+	jjyou::vk::VmaAllocation _pageRequestsMemory{ nullptr };
+	void* _pageRequestsMemoryMappedAddress = nullptr;
+	vk::raii::Buffer _brickFlags{ nullptr };
+	jjyou::vk::VmaAllocation _brickFlagsMemory{ nullptr };
+	vk::raii::Buffer _modifiedBricks{ nullptr };
+	jjyou::vk::VmaAllocation _modifiedBricksMemory{ nullptr };
+	void* _modifiedBricksMemoryMappedAddress = nullptr;
+	vk::raii::Buffer _colorBrickTable{ nullptr };
+	jjyou::vk::VmaAllocation _colorBrickTableMemory{ nullptr };
+	vk::raii::Buffer _colorBricks{ nullptr };
+	jjyou::vk::VmaAllocation _colorBricksMemory{ nullptr };
+	vk::raii::Buffer _colorBrickReadback{ nullptr };
+	jjyou::vk::VmaAllocation _colorBrickReadbackMemory{ nullptr };
+	void* _colorBrickReadbackMemoryMappedAddress = nullptr;
+	vk::raii::CommandBuffer _commandBuffer{ nullptr };
+	vk::raii::Fence _fence{ nullptr };
+	vk::raii::Semaphore _bindSemaphore{ nullptr };
+	PooledDescriptorSet _descriptorSet{ nullptr };
 
 	void _createStorageBuffer(void);
+	void _createPageTable(void);
+	void _createBrickFlags(void);
+	void _createColorBricks(void);
 	void _createDescriptorSet(void);
+
+	/** @brief	Size of the staging buffer of `save` and `load`.
+	  */
+	static inline constexpr vk::DeviceSize _FILE_STAGING_SIZE = 16ULL << 20;
+
+	/** @brief	Create a host visible buffer for copies between the volume and host memory.
+	  */
+	std::pair<vk::raii::Buffer, jjyou::vk::VmaAllocation> _createStagingBuffer(vk::DeviceSize size_, void*& pMappedData_) const;
+
+	/** @brief	Submit `_commandBuffer` to the compute queue and wait for it.
+	  */
+	void _submitAndWait(void) const;
+
+	/** @brief	Bind or unbind device memory for pages and update the page table.
+	  * @param	pages_		Indices of the pages.
+	  * @param	resident_	Whether to bind (and zero-initialize) or unbind the pages.
+	  */
+	void _updatePages(const std::vector<std::uint32_t>& pages_, bool resident_);
 };
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "TarArchive.hpp"
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <charconv>
+#include <random>
+#include <sstream>
+#include <system_error>
+#ifdef KINECTFUSION_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+	/** @brief	Tar streams consist of 512-byte blocks.
+	  */
+	constexpr std::size_t TAR_BLOCK_SIZE = 512U;
+
+	/** @brief	Size of the chunks read from a compressed archive and inflated.
+	  */
+	constexpr std::size_t GZIP_CHUNK_SIZE = 1U << 20;
+
+	/** @brief	Parse a numeric field of a tar header, in octal or in base-256 (GNU extension for large files).
+	  */
+	std::uint64_t parseNumber(const char* field_, std::size_t size_) {
+		std::uint64_t value = 0ULL;
+		if (static_cast<unsigned char>(field_[0]) & 0x80U) {
+			value = static_cast<unsigned char>(field_[0]) & 0x7FU;
+			for (std::size_t i = 1; i < size_; ++i)
+				value = (value << 8) | static_cast<unsigned char>(field_[i]);
+			return value;
+		}
+		std::size_t i = 0;
+		while (i < size_ && (field_[i] == ' ' || field_[i] == '\0'))
+			++i;
+		for (; i < size_ && field_[i] >= '0' && field_[i] <= '7'; ++i)
+			value = (value << 3) | static_cast<std::uint64_t>(field_[i] - '0');
+		return value;
+	}
+
+	/** @brief	Parse a NUL-terminated string field of a tar header.
+	  */
+	std::string parseString(const char* field_, std::size_t size_) {
+		return std::string(field_, std::find(field_, field_ + size_, '\0'));
+	}
+
+	/** @brief	Find the "path" record of a PAX extended header. Records are formatted as "<length> <key>=<value>\n".
+	  */
+	std::string parsePaxPath(const std::vector<char>& records_) {
+		const char* last = records_.data() + records_.size();
+		std::size_t begin = 0U;
+		while (begin < records_.size()) {
+			// The records are not NUL-terminated, so the length is parsed within the buffer.
+			std::size_t length = 0U;
+			std::from_chars_result result = std::from_chars(records_.data() + begin, last, length);
+			if (result.ec != std::errc() || length == 0U || length > records_.size() - begin || result.ptr >= records_.data() + begin + length || *result.ptr != ' ')
+				break;
+			std::string record(result.ptr + 1, records_.data() + begin + length);
+			if (!record.empty() && record.back() == '\n')
+				record.pop_back();
+			if (record.starts_with("path="))
+				return record.substr(5);
+			begin += length;
+		}
+		return std::string();
+	}
+
+}
+
+bool TarArchive::isArchive(const std::filesystem::path& path_) {
+	std::string extension = path_.extension().string();
+	return extension == ".tar" || extension == ".tgz" || (extension == ".gz" && path_.stem().extension().string() == ".tar");
+}
+
+TarArchive::TarArchive(const std::filesystem::path& path_) :
+	_path(path_)
+{
+	std::chrono::steady_clock::time_point indexBegin = std::chrono::steady_clock::now();
+	std::string extension = path_.extension().string();
+	this->_compressed = (extension == ".tgz" || extension == ".gz");
+	this->_file.open(path_, std::ios::in | std::ios::binary);
+	if (!this->_file.is_open())
+		throw std::runtime_error("[TarArchive] Cannot open " + path_.string() + ".");
+	try {
+		if (this->_compressed) {
+#ifdef KINECTFUSION_WITH_ZLIB
+			this->_spool();
+#else
+			throw std::runtime_error("[TarArchive] " + path_.string() + " is gzip-compressed, but the program is built without zlib. Please decompress it to a .tar file first.");
+#endif
+		}
+		// Only the headers are read. The data of the members is skipped by seeking.
+		this->_index(
+			[this](char* dst_, std::size_t size_) {
+				this->_file.read(dst_, static_cast<std::streamsize>(size_));
+				if (static_cast<std::size_t>(this->_file.gcount()) != size_)
+					throw std::runtime_error("[TarArchive] Unexpected end of " + this->_path.string() + ".");
+			},
+			[this](std::uint64_t size_) {
+				this->_file.seekg(static_cast<std::streamoff>(size_), std::ios::cur);
+			}
+		);
+	}
+	catch (...) {
+		this->_removeSpool();
+		throw;
+	}
+	this->_indexTime = std::chrono::steady_clock::now() - indexBegin;
+}
+
+TarArchive::~TarArchive(void) {
+	this->_removeSpool();
+}
+
+std::vector<std::string> TarArchive::names(void) const {
+	std::vector<std::string> names{};
+	names.reserve(this->_members.size());
+	for (const auto& [name, member] : this->_members)
+		names.push_back(name);
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+bool TarArchive::read(const std::string& name_, std::vector<std::uint8_t>& data_) {
+	auto iter = this->_members.find(name_);
+	if (iter == this->_members.end())
+		return false;
+	const _Member& member = iter->second;
+	data_.resize(static_cast<std::size_t>(member.size));
+	this->_file.clear();
+	this->_file.seekg(static_cast<std::streamoff>(member.offset), std::ios::beg);
+	this->_file.read(reinterpret_cast<char*>(data_.data()), static_cast<std::streamsize>(member.size));
+	if (static_cast<std::uint64_t>(this->_file.gcount()) != member.size)
+		throw std::runtime_error("[TarArchive] Cannot read " + name_ + " from " + this->_path.string() + ".");
+	return true;
+}
+
+#ifdef KINECTFUSION_WITH_ZLIB
+void TarArchive::_spool(void) {
+	// The name is made unique by the process-wide random device, so that several instances can spool the same archive.
+	std::random_device randomDevice{};
+	std::ostringstream spoolName{};
+	spoolName << "kinectfusion-" << this->_path.stem().string() << "-" << std::hex << randomDevice() << randomDevice() << ".tar";
+	this->_spoolPath = std::filesystem::temp_directory_path() / spoolName.str();
+	std::ofstream spool(this->_spoolPath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!spool.is_open())
+		throw std::runtime_error("[TarArchive] Cannot create " + this->_spoolPath.string() + ".");
+	z_stream stream{};
+	// 16 + MAX_WBITS: expect a gzip header.
+	if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+		throw std::runtime_error("[TarArchive] Cannot initialize zlib.");
+	std::vector<char> input(GZIP_CHUNK_SIZE);
+	std::vector<char> output(GZIP_CHUNK_SIZE);
+	int result = Z_OK;
+	while (result != Z_STREAM_END) {
+		if (stream.avail_in == 0U) {
+			this->_file.read(input.data(), static_cast<std::streamsize>(input.size()));
+			stream.next_in = reinterpret_cast<Bytef*>(input.data());
+			stream.avail_in = static_cast<uInt>(this->_file.gcount());
+			if (stream.avail_in == 0U) {
+				inflateEnd(&stream);
+				throw std::runtime_error("[TarArchive] Unexpected end of " + this->_path.string() + ".");
+			}
+		}
+		stream.next_out = reinterpret_cast<Bytef*>(output.data());
+		stream.avail_out = static_cast<uInt>(output.size());
+		result = inflate(&stream, Z_NO_FLUSH);
+		if (result != Z_OK && result != Z_STREAM_END) {
+			inflateEnd(&stream);
+			throw std::runtime_error("[TarArchive] Corrupted gzip stream in " + this->_path.string() + ".");
+		}
+		spool.write(output.data(), static_cast<std::streamsize>(output.size() - stream.avail_out));
+		if (!spool) {
+			inflateEnd(&stream);
+			throw std::runtime_error("[TarArchive] Cannot write " + this->_spoolPath.string() + ".");
+		}
+	}
+	inflateEnd(&stream);
+	spool.close();
+	// The members are read from the spooled tar stream from now on.
+	this->_file.close();
+	this->_file.open(this->_spoolPath, std::ios::in | std::ios::binary);
+	if (!this->_file.is_open())
+		throw std::runtime_error("[TarArchive] Cannot open " + this->_spoolPath.string() + ".");
+}
+#endif
+
+void TarArchive::_removeSpool(void) {
+	if (this->_spoolPath.empty())
+		return;
+	this->_file.close();
+	std::error_code errorCode{};
+	std::filesystem::remove(this->_spoolPath, errorCode);
+	this->_spoolPath.clear();
+}
+
+template <class ReadFunction, class SkipFunction>
+void TarArchive::_index(ReadFunction read_, SkipFunction skip_) {
+	std::array<char, TAR_BLOCK_SIZE> header{};
+	std::uint64_t offset = 0ULL;
+	std::string extendedName{};
+	while (true) {
+		read_(header.data(), header.size());
+		offset += TAR_BLOCK_SIZE;
+		// The archive ends with zero blocks.
+		if (std::all_of(header.begin(), header.end(), [](char c_) { return c_ == '\0'; }))
+			break;
+		// The checksum is the sum of the header bytes, with the checksum field itself counted as spaces.
+		std::uint64_t checksum = 0ULL;
+		for (std::size_t i = 0; i < header.size(); ++i)
+			checksum += (i >= 148U && i < 156U) ? static_cast<std::uint64_t>(' ') : static_cast<std::uint64_t>(static_cast<unsigned char>(header[i]));
+		if (checksum != parseNumber(&header[148], 8U))
+			throw std::runtime_error("[TarArchive] " + this->_path.string() + " is not a tar archive, or is corrupted at offset " + std::to_string(offset - TAR_BLOCK_SIZE) + ".");
+		std::uint64_t size = parseNumber(&header[124], 12U);
+		std::uint64_t paddedSize = (size + TAR_BLOCK_SIZE - 1U) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+		char type = header[156];
+		// GNU long names and PAX extended headers apply to the next member.
+		if (type == 'L' || type == 'x') {
+			std::vector<char> extendedHeader(static_cast<std::size_t>(size));
+			read_(extendedHeader.data(), extendedHeader.size());
+			skip_(paddedSize - size);
+			offset += paddedSize;
+			if (type == 'L')
+				extendedName = parseString(extendedHeader.data(), extendedHeader.size());
+			else if (std::string paxPath = parsePaxPath(extendedHeader); !paxPath.empty())
+				extendedName = std::move(paxPath);
+			continue;
+		}
+		std::string name{};
+		if (!extendedName.empty()) {
+			name = std::move(extendedName);
+			extendedName.clear();
+		}
+		else {
+			name = parseString(&header[0], 100U);
+			std::string prefix = (std::memcmp(&header[257], "ustar", 5) == 0) ? parseString(&header[345], 155U) : std::string();
+			if (!prefix.empty())
+				name = prefix + "/" + name;
+		}
+		while (name.starts_with("./"))
+			name.erase(0, 2);
+		if (type == '0' || type == '\0' || type == '7') {
+			_Member& member = this->_members[name];
+			member.size = size;
+			member.offset = offset;
+			skip_(paddedSize);
+		}
+		else {
+			skip_(paddedSize);
+		}
+		offset += paddedSize;
+	}
+	this->_numBytes = offset;
+}
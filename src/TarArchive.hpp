@@ -0,0 +1,106 @@
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+
+/***********************************************************************
+ * @class	TarArchive
+ * @brief	TarArchive class that indexes the members of a tar archive,
+ *			optionally gzip-compressed, and reads them by name without
+ *			extracting the archive.
+ *
+ * The archive is streamed through once on construction, and only the
+ * offsets of the members are kept. The data is read from the file on
+ * demand. A gzip stream cannot be seeked, so a compressed archive is
+ * first inflated to a temporary .tar file, which takes the size of the
+ * uncompressed archive on disk and is deleted by the destructor.
+ * Compressed archives require zlib (`KINECTFUSION_WITH_ZLIB`).
+ *
+ * Regular files are indexed by their path in the archive, e.g.
+ * "rgbd_dataset_freiburg1_xyz/rgb.txt". GNU long names and PAX paths are
+ * supported. Other members (directories, links, ...) are skipped.
+ ***********************************************************************/
+class TarArchive {
+
+public:
+
+	/** @brief	Check whether a path has the extension of a supported archive (.tar, .tgz, .tar.gz).
+	  */
+	static bool isArchive(const std::filesystem::path& path_);
+
+	/** @brief	Index an archive.
+	  * @param	path_	Path to the archive. It is gzip-compressed if its extension is .tgz or .gz.
+	  */
+	explicit TarArchive(const std::filesystem::path& path_);
+
+	/** @brief	Disable copy/move constructor/assignment.
+	  */
+	TarArchive(const TarArchive&) = delete;
+	TarArchive(TarArchive&&) = delete;
+	TarArchive& operator=(const TarArchive&) = delete;
+	TarArchive& operator=(TarArchive&&) = delete;
+
+	/** @brief	Destructor. Delete the temporary .tar file of a compressed archive.
+	  */
+	~TarArchive(void);
+
+	/** @brief	Check whether the archive has a regular file.
+	  */
+	bool contains(const std::string& name_) const { return this->_members.contains(name_); }
+
+	/** @brief	Get the names of all regular files.
+	  */
+	std::vector<std::string> names(void) const;
+
+	/** @brief	Read a regular file.
+	  *
+	  * This function is not thread-safe.
+	  * @param	name_	Path of the file in the archive.
+	  * @param	data_	Receives the data.
+	  * @return	Whether the file exists.
+	  */
+	bool read(const std::string& name_, std::vector<std::uint8_t>& data_);
+
+	/** @brief	Getters.
+	  */
+	const std::filesystem::path& path(void) const { return this->_path; }
+	bool compressed(void) const { return this->_compressed; }
+	std::size_t numMembers(void) const { return this->_members.size(); }
+	std::uint64_t numBytes(void) const { return this->_numBytes; }	//!< Number of bytes of the (uncompressed) tar stream.
+	std::chrono::duration<double> indexTime(void) const { return this->_indexTime; }
+
+private:
+
+	struct _Member {
+		std::uint64_t offset = 0ULL;		// Offset in the tar stream.
+		std::uint64_t size = 0ULL;
+	};
+
+	std::filesystem::path _path{};
+	bool _compressed = false;
+	std::filesystem::path _spoolPath{};		// Temporary .tar file of a compressed archive.
+	std::ifstream _file{};					// The archive, or its temporary .tar file.
+	std::unordered_map<std::string, _Member> _members{};
+	std::uint64_t _numBytes = 0ULL;
+	std::chrono::duration<double> _indexTime{};
+
+	/** @brief	Index the members of the tar stream.
+	  * @param	read_	Reads the given number of bytes of the tar stream, or throws if the stream ends.
+	  * @param	skip_	Skips the given number of bytes of the tar stream.
+	  */
+	template <class ReadFunction, class SkipFunction>
+	void _index(ReadFunction read_, SkipFunction skip_);
+
+	/** @brief	Inflate the compressed archive to a temporary .tar file, and reopen `_file` on it.
+	  */
+	void _spool(void);
+
+	/** @brief	Close and delete the temporary .tar file, if any.
+	  */
+	void _removeSpool(void);
+
+};
@@ -1,6 +1,7 @@
 #include "Texture.hpp"
 #include "Engine.hpp"
 #include <stdexcept>
+#include <cstring>
 
 #define VK_THROW(err) \
 	throw std::runtime_error("[Texture] Vulkan error in file " + std::string(__FILE__) + " line " + std::to_string(__LINE__) + ": " + vk::to_string(err))
@@ -59,9 +60,91 @@ Texture2D::Texture2D(
 	this->_imageView = vk::raii::ImageView(this->_pEngine->context().device(), imageViewCreateInfo);
 }
 
+void Texture2D::download(void* data_) const {
+	if (this->_format != vk::Format::eR8G8B8A8Unorm && this->_format != vk::Format::eR32Sfloat && this->_format != vk::Format::eR32G32B32A32Sfloat) {
+		throw std::logic_error("[Texture2D] Downloading textures of format " + vk::to_string(this->_format) + " is not supported.");
+	}
+	vk::DeviceSize texelSize = (this->_format == vk::Format::eR32G32B32A32Sfloat) ? 16ULL : 4ULL;
+	vk::DeviceSize dataSize = texelSize * static_cast<vk::DeviceSize>(this->_extent.width) * static_cast<vk::DeviceSize>(this->_extent.height);
+	// Create a staging buffer.
+	vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+		.setFlags(vk::BufferCreateFlags(0))
+		.setSize(dataSize)
+		.setUsage(vk::BufferUsageFlagBits::eTransferDst)
+		.setSharingMode(vk::SharingMode::eExclusive)
+		.setQueueFamilyIndices(nullptr);
+	VmaAllocationCreateInfo vmaAllocationCreateInfo{
+		.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+		.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+		.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		.memoryTypeBits = 0,
+		.pool = nullptr,
+		.pUserData = nullptr,
+		.priority = 0.0f,
+	};
+	VkBuffer pStagingBuffer = nullptr;
+	VmaAllocation pStagingBufferMemory = nullptr;
+	VmaAllocationInfo allocationInfo{};
+	vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &pStagingBuffer, &pStagingBufferMemory, &allocationInfo);
+	vk::raii::Buffer stagingBuffer(this->_pEngine->context().device(), pStagingBuffer);
+	jjyou::vk::VmaAllocation stagingBufferMemory(this->_pEngine->allocator(), pStagingBufferMemory);
+	// Copy the image to the staging buffer on the compute queue. The images written by shaders
+	// (e.g. the pyramids of KinectFusion) are owned by or shared with the compute queue family,
+	// so no ownership transfer is needed.
+	vk::raii::CommandBuffer transferCommandBuffer = std::move(this->_pEngine->context().device().allocateCommandBuffers(
+		vk::CommandBufferAllocateInfo()
+		.setCommandPool(*this->_pEngine->commandPool(jjyou::vk::Context::QueueType::Compute))
+		.setLevel(vk::CommandBufferLevel::ePrimary)
+		.setCommandBufferCount(1)
+	)[0]);
+	vk::raii::Fence fence = vk::raii::Fence(this->_pEngine->context().device(), vk::FenceCreateInfo(vk::FenceCreateFlags(0)));
+	transferCommandBuffer.begin(vk::CommandBufferBeginInfo()
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(nullptr)
+	);
+	vk::BufferImageCopy bufferImageCopy = vk::BufferImageCopy()
+		.setBufferOffset(0)
+		.setBufferRowLength(0)
+		.setBufferImageHeight(0)
+		.setImageSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
+		.setImageOffset(vk::Offset3D(0, 0, 0))
+		.setImageExtent(vk::Extent3D(this->_extent, 1));
+	transferCommandBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eComputeShader,
+		vk::PipelineStageFlagBits::eTransfer,
+		vk::DependencyFlags(0),
+		vk::MemoryBarrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eTransferRead),
+		nullptr,
+		nullptr
+	);
+	transferCommandBuffer.copyImageToBuffer(*this->_image, vk::ImageLayout::eGeneral, *stagingBuffer, bufferImageCopy);
+	transferCommandBuffer.pipelineBarrier(
+		vk::PipelineStageFlagBits::eTransfer,
+		vk::PipelineStageFlagBits::eHost,
+		vk::DependencyFlags(0),
+		vk::MemoryBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead),
+		nullptr,
+		nullptr
+	);
+	transferCommandBuffer.end();
+	this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+		vk::SubmitInfo()
+		.setWaitSemaphores(nullptr)
+		.setWaitDstStageMask(nullptr)
+		.setCommandBuffers(*transferCommandBuffer)
+		.setSignalSemaphores(nullptr),
+		*fence
+	);
+	vk::Result waitResult = this->_pEngine->waitForFences(*fence);
+	VK_CHECK(waitResult);
+	std::memcpy(data_, allocationInfo.pMappedData, static_cast<std::size_t>(dataSize));
+}
+
 template <MaterialType _materialType>
 Surface<_materialType>::Surface(const Engine& engine_) :
 	_pEngine(&engine_),
+	_geometryId(nextGeometryId()),
 	_samplerDescriptorSetLayout(*engine_.surfaceSamplerDescriptorSetLayout(_materialType)),
 	_storageDescriptorSetLayout(*engine_.surfaceStorageDescriptorSetLayout(_materialType))
 {
@@ -94,28 +177,28 @@ Surface<_materialType>::Surface(const Engine& engine_) :
 		this->_sampler = vk::raii::Sampler(this->_pEngine->context().device(), samplerCreateInfo);
 	}
 	// Create descriptor set
-	{
-		vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo()
-			.setDescriptorPool(*this->_pEngine->descriptorPool())
-			.setDescriptorSetCount(1)
-			.setSetLayouts(this->_samplerDescriptorSetLayout);
-		this->_samplerDescriptorSet = std::move(this->_pEngine->context().device().allocateDescriptorSets(descriptorSetAllocateInfo)[0]);
-	}
-	{
-		vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo = vk::DescriptorSetAllocateInfo()
-			.setDescriptorPool(*this->_pEngine->descriptorPool())
-			.setDescriptorSetCount(1)
-			.setSetLayouts(this->_storageDescriptorSetLayout);
-		this->_storageDescriptorSet = std::move(this->_pEngine->context().device().allocateDescriptorSets(descriptorSetAllocateInfo)[0]);
-	}
+	this->_samplerDescriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_samplerDescriptorSetLayout);
+	this->_storageDescriptorSet = this->_pEngine->descriptorAllocator().allocate(this->_storageDescriptorSetLayout);
 }
 
 template <MaterialType _materialType>
 Surface<_materialType>& Surface<_materialType>::createTextures(
 	std::array<vk::Extent2D, Surface::numTextures> extents_,
 	std::optional<std::array<const void*, Surface::numTextures>> data_,
-	bool waitIdle_
+	bool waitIdle_,
+	ColorFormat colorFormat_
 ) {
+	// Raw color data other than RGBA8888 is converted by `convertColor.comp`,
+	// which writes the storage descriptor set of simple surfaces.
+	bool convertColor = (data_ != std::nullopt && colorFormat_ != ColorFormat::RGBA8888);
+	if (convertColor) {
+		if constexpr (_materialType != MaterialType::Simple)
+			throw std::logic_error("[Surface] Color formats other than RGBA8888 are only supported by simple surfaces.");
+		if ((colorFormat_ == ColorFormat::YUYV || colorFormat_ == ColorFormat::NV12) && extents_[0].width % 2 != 0)
+			throw std::logic_error("[Surface] The width of a " + to_string(colorFormat_) + " color map must be even.");
+		if (colorFormat_ == ColorFormat::NV12 && extents_[0].height % 2 != 0)
+			throw std::logic_error("[Surface] The height of a NV12 color map must be even.");
+	}
 	// Wait graphics and compute queues to be idle.
 	if (waitIdle_) {
 		this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Main)->waitIdle();
@@ -220,14 +303,25 @@ Surface<_materialType>& Surface<_materialType>::createTextures(
 			}
 		}
 		// Create staging buffer and copy CPU data to it.
+		// Raw color data is copied to the staging buffer of the color conversion instead.
+		_ColorConversionFrame* pColorConversionFrame = nullptr;
 		std::vector<vk::raii::Buffer> stagingBuffers{};
 		std::vector<jjyou::vk::VmaAllocation> stagingBufferMemorys{};
 		if (data_ != std::nullopt) {
 			for (std::uint32_t i = 0; i < Surface::numTextures; ++i) {
-				vk::DeviceSize bufferSize = elementSizes[i] * static_cast<vk::DeviceSize>(extents_[i].width) * static_cast<vk::DeviceSize>(extents_[i].height);
+				vk::DeviceSize dataSize = elementSizes[i] * static_cast<vk::DeviceSize>(extents_[i].width) * static_cast<vk::DeviceSize>(extents_[i].height);
+				if (i == 0 && convertColor) {
+					// The shader reads the raw data as 32-bit words.
+					dataSize = static_cast<vk::DeviceSize>(colorFrameSize(colorFormat_, extents_[0]));
+					pColorConversionFrame = &this->_nextColorConversionFrame((dataSize + 3) & ~static_cast<vk::DeviceSize>(3));
+					memcpy(pColorConversionFrame->stagingBufferMappedAddress, (*data_)[0], dataSize);
+					stagingBuffers.emplace_back(nullptr);
+					stagingBufferMemorys.emplace_back(nullptr);
+					continue;
+				}
 				vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
 					.setFlags(vk::BufferCreateFlags(0))
-					.setSize(bufferSize)
+					.setSize(dataSize)
 					.setUsage(vk::BufferUsageFlagBits::eTransferSrc)
 					.setSharingMode(vk::SharingMode::eExclusive)
 					.setQueueFamilyIndices(nullptr);
@@ -247,7 +341,7 @@ Surface<_materialType>& Surface<_materialType>::createTextures(
 				vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &pStagingBuffer, &pStagingBufferMemory, &allocationInfo);
 				stagingBuffers.emplace_back(this->_pEngine->context().device(), pStagingBuffer);
 				stagingBufferMemorys.emplace_back(this->_pEngine->allocator(), pStagingBufferMemory);
-				memcpy(allocationInfo.pMappedData, (*data_)[i], bufferSize);
+				memcpy(allocationInfo.pMappedData, (*data_)[i], dataSize);
 				vk::BufferImageCopy bufferImageCopy = vk::BufferImageCopy()
 					.setBufferOffset(0)
 					.setBufferRowLength(0)
@@ -258,27 +352,119 @@ Surface<_materialType>& Surface<_materialType>::createTextures(
 				transferCommandBuffer.copyBufferToImage(*stagingBuffers[i], *this->_textures[i].image(), vk::ImageLayout::eGeneral, bufferImageCopy);
 			}
 		}
-		// Transfer command buffer submits (signal fence)
+		// Transfer command buffer submits (signal fence, and signal semaphore if the color map needs conversion)
 		{
 			transferCommandBuffer.end();
-			this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Transfer)->submit(
-				vk::SubmitInfo()
+			vk::SubmitInfo submitInfo = vk::SubmitInfo()
 				.setWaitSemaphores(nullptr)
 				.setWaitDstStageMask(nullptr)
 				.setCommandBuffers(*transferCommandBuffer)
+				.setSignalSemaphores(nullptr);
+			if (convertColor)
+				submitInfo.setSignalSemaphores(*pColorConversionFrame->transferFinishedSemaphore);
+			this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Transfer)->submit(submitInfo, *fence);
+		}
+		// Convert the raw color data on the compute queue after the layout transition (signal fence)
+		if (convertColor) {
+			const vk::raii::CommandBuffer& computeCommandBuffer = pColorConversionFrame->commandBuffer;
+			computeCommandBuffer.reset(vk::CommandBufferResetFlags(0));
+			computeCommandBuffer.begin(vk::CommandBufferBeginInfo()
+				.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+				.setPInheritanceInfo(nullptr)
+			);
+			computeCommandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *this->_pEngine->colorConversionPipeline());
+			this->bindStorage(computeCommandBuffer, vk::PipelineBindPoint::eCompute, this->_pEngine->colorConversionPipelineLayout(), 0);
+			computeCommandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *this->_pEngine->colorConversionPipelineLayout(), 1, *pColorConversionFrame->descriptorSet, nullptr);
+			ColorConversionParameters colorConversionParameters{ .format = static_cast<std::uint32_t>(colorFormat_) };
+			computeCommandBuffer.pushConstants<ColorConversionParameters>(*this->_pEngine->colorConversionPipelineLayout(), vk::ShaderStageFlagBits::eCompute, 0U, colorConversionParameters);
+			computeCommandBuffer.dispatch((extents_[0].width + 31) / 32, (extents_[0].height + 31) / 32, 1);
+			computeCommandBuffer.end();
+			vk::PipelineStageFlags waitDstStageMask = vk::PipelineStageFlagBits::eComputeShader;
+			this->_pEngine->context().queue(jjyou::vk::Context::QueueType::Compute)->submit(
+				vk::SubmitInfo()
+				.setWaitSemaphores(*pColorConversionFrame->transferFinishedSemaphore)
+				.setWaitDstStageMask(waitDstStageMask)
+				.setCommandBuffers(*computeCommandBuffer)
 				.setSignalSemaphores(nullptr),
-				*fence
+				*pColorConversionFrame->fence
 			);
 		}
-		// CPU waits the fence
+		// CPU waits the fences
 		{
-			vk::Result waitResult = this->_pEngine->context().device().waitForFences(*fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+			vk::Result waitResult = this->_pEngine->waitForFences(*fence);
 			VK_CHECK(waitResult);
+			if (convertColor) {
+				waitResult = this->_pEngine->waitForFences(*pColorConversionFrame->fence);
+				VK_CHECK(waitResult);
+				this->_pEngine->context().device().resetFences(*pColorConversionFrame->fence);
+			}
 		}
 	}
 	return *this;
 }
 
+template <MaterialType _materialType>
+typename Surface<_materialType>::_ColorConversionFrame& Surface<_materialType>::_nextColorConversionFrame(vk::DeviceSize size_) {
+	if (this->_colorConversionFrames.empty()) {
+		this->_colorConversionFrames.resize(Engine::NUM_FRAMES_IN_FLIGHT);
+		std::vector<vk::raii::CommandBuffer> commandBuffers = this->_pEngine->context().device().allocateCommandBuffers(
+			vk::CommandBufferAllocateInfo()
+			.setCommandPool(*this->_pEngine->commandPool(jjyou::vk::Context::QueueType::Compute))
+			.setLevel(vk::CommandBufferLevel::ePrimary)
+			.setCommandBufferCount(Engine::NUM_FRAMES_IN_FLIGHT)
+		);
+		for (std::uint32_t i = 0; i < Engine::NUM_FRAMES_IN_FLIGHT; ++i) {
+			_ColorConversionFrame& frame = this->_colorConversionFrames[i];
+			frame.commandBuffer = std::move(commandBuffers[i]);
+			frame.fence = vk::raii::Fence(this->_pEngine->context().device(), vk::FenceCreateInfo(vk::FenceCreateFlags(0)));
+			frame.transferFinishedSemaphore = vk::raii::Semaphore(this->_pEngine->context().device(), vk::SemaphoreCreateInfo().setFlags(vk::SemaphoreCreateFlags(0)));
+			frame.descriptorSet = this->_pEngine->descriptorAllocator().allocate(*this->_pEngine->colorConversionDescriptorSetLayout());
+		}
+	}
+	_ColorConversionFrame& frame = this->_colorConversionFrames[this->_colorConversionFrameIndex];
+	this->_colorConversionFrameIndex = (this->_colorConversionFrameIndex + 1U) % Engine::NUM_FRAMES_IN_FLIGHT;
+	if (frame.stagingBufferSize < size_) {
+		vk::BufferCreateInfo bufferCreateInfo = vk::BufferCreateInfo()
+			.setFlags(vk::BufferCreateFlags(0))
+			.setSize(size_)
+			.setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
+			.setSharingMode(vk::SharingMode::eExclusive)
+			.setQueueFamilyIndices(nullptr);
+		VmaAllocationCreateInfo vmaAllocationCreateInfo{
+			.flags = VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_MAPPED_BIT,
+			.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO,
+			.requiredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.preferredFlags = VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VkMemoryPropertyFlagBits::VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			.memoryTypeBits = 0,
+			.pool = nullptr,
+			.pUserData = nullptr,
+			.priority = 0.0f,
+		};
+		VkBuffer pStagingBuffer = nullptr;
+		VmaAllocation pStagingBufferMemory = nullptr;
+		VmaAllocationInfo allocationInfo{};
+		vmaCreateBuffer(*this->_pEngine->allocator(), reinterpret_cast<VkBufferCreateInfo*>(&bufferCreateInfo), &vmaAllocationCreateInfo, &pStagingBuffer, &pStagingBufferMemory, &allocationInfo);
+		frame.stagingBuffer = vk::raii::Buffer(this->_pEngine->context().device(), pStagingBuffer);
+		frame.stagingBufferMemory = jjyou::vk::VmaAllocation(this->_pEngine->allocator(), pStagingBufferMemory);
+		frame.stagingBufferMappedAddress = allocationInfo.pMappedData;
+		frame.stagingBufferSize = size_;
+		// The descriptor set is not in use, since the last conversion of this frame has been waited for.
+		vk::DescriptorBufferInfo descriptorBufferInfo = vk::DescriptorBufferInfo()
+			.setBuffer(*frame.stagingBuffer)
+			.setOffset(0)
+			.setRange(VK_WHOLE_SIZE);
+		vk::WriteDescriptorSet writeDescriptorSet = vk::WriteDescriptorSet()
+			.setDstSet(*frame.descriptorSet)
+			.setDstBinding(0)
+			.setDstArrayElement(0)
+			.setDescriptorCount(1)
+			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+			.setBufferInfo(descriptorBufferInfo);
+		this->_pEngine->context().device().updateDescriptorSets(writeDescriptorSet, nullptr);
+	}
+	return frame;
+}
+
 template <MaterialType _materialType>
 Surface<_materialType>& Surface<_materialType>::connect(
 	const Surface<MaterialType::Simple>& color_,
@@ -3,6 +3,7 @@
 #include <jjyou/vk/Vulkan.hpp>
 #include <jjyou/glsl/glsl.hpp>
 #include "Primitives.hpp"
+#include "DescriptorAllocator.hpp"
 
 class Engine;
 
@@ -103,6 +104,17 @@ public:
 	  */
 	const std::optional<vk::raii::Sampler>& sampler(void) const { return this->_sampler; }
 
+	/** @brief	Download the texture to CPU memory.
+	  *
+	  * Only R8G8B8A8Unorm, R32Sfloat, and R32G32B32A32Sfloat are supported.
+	  * The image must be in general layout, must be owned by or shared with the compute queue family,
+	  * and must not be used by any queue. The copy is submitted to the compute queue.
+	  * This function blocks until the data are copied to `data_`.
+	  * @param	data_	Receives `texelSize * width * height` bytes, where the texel size
+	  *					is 16 bytes for R32G32B32A32Sfloat and 4 bytes otherwise.
+	  */
+	void download(void* data_) const;
+
 private:
 
 	const Engine* _pEngine = nullptr;
@@ -163,12 +175,15 @@ public:
 	Surface& operator=(Surface&& other_) noexcept {
 		if (this != &other_) {
 			this->_pEngine = other_._pEngine;
+			this->_geometryId = other_._geometryId;
 			this->_samplerDescriptorSetLayout = other_._samplerDescriptorSetLayout;
 			this->_storageDescriptorSetLayout = other_._storageDescriptorSetLayout;
 			this->_textures = std::move(other_._textures);
 			this->_sampler = std::move(other_._sampler);
 			this->_samplerDescriptorSet = std::move(other_._samplerDescriptorSet);
 			this->_storageDescriptorSet = std::move(other_._storageDescriptorSet);
+			this->_colorConversionFrames = std::move(other_._colorConversionFrames);
+			this->_colorConversionFrameIndex = other_._colorConversionFrameIndex;
 		}
 		return *this;
 	}
@@ -177,16 +192,27 @@ public:
 	  */
 	Surface(const Engine& engine_);
 
+	/** @brief	Push constants of `convertColor.comp`.
+	  */
+	struct ColorConversionParameters {
+		std::uint32_t format;	//!< `ColorFormat` of the raw color data.
+	};
+
 	/** @brief	Create textures, and optionally upload data from CPU.
 	  * 
-	  *			The data formats of color map should be R8G8B8A8Unorm.
+	  *			The data format of color map is given by `colorFormat_`.
+	  *			Formats other than RGBA8888 are only supported by simple surfaces.
+	  *			They are uploaded as-is in a storage buffer and converted to
+	  *			R8G8B8A8Unorm on the compute queue. The resources of the conversion
+	  *			are allocated on first use, once per frame in flight, and reused.
 	  *			The data formats of depth map should be R32Sfloat.
 	  *			The data formats of normal map should be R32G32B32A32Sfloat.
 	  */
 	Surface& createTextures(
 		std::array<vk::Extent2D, Surface::numTextures> extents_,
 		std::optional<std::array<const void*, Surface::numTextures>> data_,
-		bool waitIdle_
+		bool waitIdle_,
+		ColorFormat colorFormat_ = ColorFormat::RGBA8888
 	);
 
 	/** @brief	Combine multiple surfaces into one descriptor set.
@@ -224,6 +250,12 @@ public:
 		commandBuffer_.bindDescriptorSets(pipelineBindPoint_, *pipelineLayout_, setIndex_, *this->_storageDescriptorSet, nullptr);
 	}
 
+	/** @brief	Get the geometry id, which identifies the surface in draw commands.
+	  */
+	std::uint64_t geometryId(void) const {
+		return this->_geometryId;
+	}
+
 	/** @brief	Draw the surface.
 	  */
 	void draw(const vk::raii::CommandBuffer& commandBuffer_) const {
@@ -250,7 +282,7 @@ public:
 
 	/** @brief	Create the descriptor set layout of combind image samplers.
 	  */
-	static vk::raii::DescriptorSetLayout createSamplerDescriptorSetLayout(const vk::raii::Device& device_) {
+	static vk::raii::DescriptorSetLayout createSamplerDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
 		std::array<vk::DescriptorSetLayoutBinding, Surface::numTextures> descriptorSetLayoutBindings;
 		for (std::uint32_t i = 0; i < Surface::numTextures; ++i) {
 			descriptorSetLayoutBindings[i]
@@ -263,12 +295,12 @@ public:
 		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
 			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
 			.setBindings(descriptorSetLayoutBindings);
-		return vk::raii::DescriptorSetLayout(device_, descriptorSetLayoutCreateInfo);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
 	}
 
 	/** @brief	Create the descriptor set layout of storage images.
 	  */
-	static vk::raii::DescriptorSetLayout createStorageDescriptorSetLayout(const vk::raii::Device& device_) {
+	static vk::raii::DescriptorSetLayout createStorageDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
 		std::array<vk::DescriptorSetLayoutBinding, Surface::numTextures> descriptorSetLayoutBindings;
 		for (std::uint32_t i = 0; i < Surface::numTextures; ++i) {
 			descriptorSetLayoutBindings[i]
@@ -281,18 +313,54 @@ public:
 		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
 			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
 			.setBindings(descriptorSetLayoutBindings);
-		return vk::raii::DescriptorSetLayout(device_, descriptorSetLayoutCreateInfo);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
+	}
+
+	/** @brief	Create the descriptor set layout of the raw color buffer read by `convertColor.comp`.
+	  */
+	static vk::raii::DescriptorSetLayout createColorConversionDescriptorSetLayout(DescriptorAllocator& descriptorAllocator_) {
+		vk::DescriptorSetLayoutBinding descriptorSetLayoutBinding = vk::DescriptorSetLayoutBinding()
+			.setBinding(0)
+			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+			.setDescriptorCount(1)
+			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+			.setPImmutableSamplers(nullptr);
+		vk::DescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
+			.setFlags(vk::DescriptorSetLayoutCreateFlags(0))
+			.setBindings(descriptorSetLayoutBinding);
+		return descriptorAllocator_.createDescriptorSetLayout(descriptorSetLayoutCreateInfo);
 	}
 
 private:
 
 	const Engine* _pEngine = nullptr;
+	std::uint64_t _geometryId = 0ULL;
 	vk::DescriptorSetLayout _samplerDescriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by the engine.
 	vk::DescriptorSetLayout _storageDescriptorSetLayout{ nullptr }; // Descriptor set layout should be owned by the engine.
 	std::vector<Texture2D> _textures{};
 	vk::raii::Sampler _sampler{ nullptr };
-	vk::raii::DescriptorSet _samplerDescriptorSet{ nullptr };
-	vk::raii::DescriptorSet _storageDescriptorSet{ nullptr };
+	PooledDescriptorSet _samplerDescriptorSet{ nullptr };
+	PooledDescriptorSet _storageDescriptorSet{ nullptr };
+
+	/** @brief	Resources of one color conversion, reused every `Engine::NUM_FRAMES_IN_FLIGHT` uploads.
+	  */
+	struct _ColorConversionFrame {
+		vk::raii::CommandBuffer commandBuffer{ nullptr };
+		vk::raii::Fence fence{ nullptr };
+		vk::raii::Semaphore transferFinishedSemaphore{ nullptr };
+		PooledDescriptorSet descriptorSet{ nullptr };				//!< Binds `stagingBuffer`.
+		vk::raii::Buffer stagingBuffer{ nullptr };					//!< Raw color data. It only grows.
+		jjyou::vk::VmaAllocation stagingBufferMemory{ nullptr };
+		void* stagingBufferMappedAddress = nullptr;
+		vk::DeviceSize stagingBufferSize = 0ULL;
+	};
+	std::vector<_ColorConversionFrame> _colorConversionFrames{};
+	std::uint32_t _colorConversionFrameIndex = 0U;
+
+	/** @brief	Get the resources of the next color conversion, creating them on first use.
+	  *			The staging buffer holds at least `size_` bytes.
+	  */
+	_ColorConversionFrame& _nextColorConversionFrame(vk::DeviceSize size_);
 
 	template <MaterialType __materialType>
 	friend class Surface;
@@ -3,5 +3,5 @@
 int main(int argc, char** argv) {
 	Application application(argc, argv);
 	application.mainLoop();
-	return 0;
+	return application.succeeded() ? 0 : 1;
 }
\ No newline at end of file
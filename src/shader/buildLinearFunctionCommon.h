@@ -0,0 +1,207 @@
+/***********************************************************************
+ * @file	buildLinearFunctionCommon.h
+ * @author	jjyou
+ * @date	2024-6-7
+ * @brief	This file declares the resources and the helper functions
+ *			shared by `buildLinearFunction.comp` and its half precision
+ *			variant `buildLinearFunctionFP16.comp`.
+ *
+ *			The variants only differ in how the row of the linear
+ *			function is computed from a correspondence. The projective
+ *			correspondence search and the sum reduction are always
+ *			computed in fp32.
+***********************************************************************/
+
+layout (local_size_x = 1024) in;
+
+/** @brief	Frame pyramid data (ICP algorithm's source), in frame's local space.
+  */
+layout (set = 0, binding = 1, rgba32f) uniform readonly image2D frameVertexMap;
+layout (set = 0, binding = 2, rgba32f) uniform readonly image2D frameNormalMap;
+
+/** @brief	Model pyramid data (ICP algorithm's destination), in world space.
+  */
+layout (set = 1, binding = 1, rgba32f) uniform readonly image2D modelVertexMap;
+layout (set = 1, binding = 2, rgba32f) uniform readonly image2D modelNormalMap;
+
+/** @brief	ICP parameters.
+  */
+layout(set = 2, binding = 0) uniform ICPParameters {
+	mat4 modelView;				//!< The current view matrix of the model data.
+	vec4 intrinsics[3];			//!< The camera projection parameters (fx, fy, cx, cy) of the model data in each pyramid level.
+	vec4 frameGravity;			//!< Not used in this shader.
+	vec4 worldGravity;			//!< Not used in this shader.
+	float distanceThreshold;	//!< Distance threshold used in projective correspondence search.
+	float angleThreshold;		//!< Angle threshold used in projective correspondence search.
+	float minDeterminant;		//!< Not used in this shader.
+	float maxIncrement;			//!< Not used in this shader.
+	float convergenceThreshold;	//!< Not used in this shader.
+	float gravityWeight;		//!< Not used in this shader.
+} icpParameters;
+
+#include "icpCommon.h"
+
+/** @brief	ICP state updated by `solveLinearFunction.comp`.
+  */
+layout(set = 2, binding = 3) readonly buffer ICPState {
+	uint buildLinearFunctionNumWorkGroups[3];
+	uint reductionNumWorkGroups[3];
+	uint numHypotheses;
+	uint padding;
+	ICPHypothesis hypotheses[MAX_NUM_HYPOTHESES];
+} icpState;
+
+/** @brief	Level of the pyramid.
+  */
+layout(push_constant) uniform ICPLevel {
+	uint level;
+} icpLevel;
+
+/** @brief	Valid pixels of the frame pyramid level.
+  */
+layout(set = 3, binding = 1) readonly buffer FrameValidPixels {
+	uint data[];
+} frameValidPixels;
+layout(set = 3, binding = 2) readonly buffer FrameValidPixelsCounter {
+	uint numValidPixels;
+	uint numWorkGroups[3];
+} frameValidPixelsCounter;
+
+/** @brief	Validity bitmask of the model pyramid level.
+  */
+layout(set = 4, binding = 0) readonly buffer ModelValidityMask {
+	uint data[];
+} modelValidityMask;
+
+/** @brief	Storage buffer to store the 6x6 matrix A and 6d vector b.
+  *
+  *			A is a symmetric matrix, so we only need to store 21 elements.
+  *			The total number of floats for each work group is 21+6=27,
+  *			followed by the sum of squared residuals and the number of
+  *			inliers.
+  *			Each hypothesis owns a slice of the buffer whose length is
+  *			equal to the number of work groups (aka blocks in CUDA).
+  *			Within each work group we will perform a sum reduction for all
+  *			1024 invocations (aka threads in CUDA).
+  */
+layout(set = 2, binding = 1) buffer GlobalSumBuffer {
+	float data[][NUM_SUM_TERMS];
+} globalSumBuffer;
+
+/** @brief	A buffer used to sum up values for all invocations within
+  *			the current work group.
+  */
+const uint numLocalInvocations = gl_WorkGroupSize.x;
+shared float sumBuffer[numLocalInvocations];
+
+/** @brief	Helper function to test a bit in the model validity bitmask.
+  */
+bool validModelPixel(ivec2 pixelPos, ivec2 size) {
+	uint pixelIndex = uint(pixelPos.y) * uint(size.x) + uint(pixelPos.x);
+	return (modelValidityMask.data[pixelIndex / 32] & (1u << (pixelIndex % 32))) != 0u;
+}
+
+/** @brief	Sum up a value over all invocations in the work group and store it in the global sum buffer.
+  */
+void reduceAndStore(float value, uint globalWorkGroupID, uint term) {
+	barrier();
+	sumBuffer[gl_LocalInvocationIndex] = value;
+	barrier();
+	// Suppose the number of invocations within one work group won't exceed 1024.
+	// We can manually unroll a loop here.
+	if (numLocalInvocations >= 1024) {
+		if (gl_LocalInvocationIndex < 512) sumBuffer[gl_LocalInvocationIndex] += sumBuffer[gl_LocalInvocationIndex + 512];
+		barrier();
+	}
+	if (numLocalInvocations >= 512) {
+		if (gl_LocalInvocationIndex < 256) sumBuffer[gl_LocalInvocationIndex] += sumBuffer[gl_LocalInvocationIndex + 256];
+		barrier();
+	}
+	if (numLocalInvocations >= 256) {
+		if (gl_LocalInvocationIndex < 128) sumBuffer[gl_LocalInvocationIndex] += sumBuffer[gl_LocalInvocationIndex + 128];
+		barrier();
+	}
+	if (numLocalInvocations >= 128) {
+		if (gl_LocalInvocationIndex < 64) sumBuffer[gl_LocalInvocationIndex] += sumBuffer[gl_LocalInvocationIndex + 64];
+		barrier();
+	}
+	if (numLocalInvocations >= 64) {
+		if (gl_LocalInvocationIndex < 32) sumBuffer[gl_LocalInvocationIndex] += sumBuffer[gl_LocalInvocationIndex + 32];
+		barrier();
+	}
+	if (numLocalInvocations >= 32) {
+		if (gl_LocalInvocationIndex < 16) sumBuffer[gl_LocalInvocationIndex] += sumBuffer[gl_LocalInvocationIndex + 16];
+		barrier();
+	}
+	if (numLocalInvocations >= 16) {
+		if (gl_LocalInvocationIndex < 8) sumBuffer[gl_LocalInvocationIndex] += sumBuffer[gl_LocalInvocationIndex + 8];
+		barrier();
+	}
+	if (numLocalInvocations >= 8) {
+		if (gl_LocalInvocationIndex < 4) sumBuffer[gl_LocalInvocationIndex] += sumBuffer[gl_LocalInvocationIndex + 4];
+		barrier();
+	}
+	if (numLocalInvocations >= 4) {
+		if (gl_LocalInvocationIndex < 2) sumBuffer[gl_LocalInvocationIndex] += sumBuffer[gl_LocalInvocationIndex + 2];
+		barrier();
+	}
+	if (numLocalInvocations >= 2) {
+		if (gl_LocalInvocationIndex < 1) sumBuffer[gl_LocalInvocationIndex] += sumBuffer[gl_LocalInvocationIndex + 1];
+		barrier();
+	}
+	if (gl_LocalInvocationIndex == 0)
+		globalSumBuffer.data[globalWorkGroupID][term] = sumBuffer[0];
+}
+
+/** @brief	Find the correspondence of the frame pixel of the current invocation.
+  *
+  *			The frame vertex is transformed to world space by the pose of the hypothesis.
+  * @return	Whether a correspondence is found.
+  */
+bool findCorrespondence(uint hypothesis, out vec3 frameVertex, out vec3 modelVertex, out vec3 modelNormal) {
+	mat4 frameInvView = icpState.hypotheses[hypothesis].frameInvView;
+	ivec2 frameSize = imageSize(frameVertexMap);
+	// Pixels in the list always have a valid vertex and a valid normal.
+	// The last work group may have invocations beyond the end of the list.
+	if (gl_GlobalInvocationID.x >= frameValidPixelsCounter.numValidPixels)
+		return false;
+	uint pixelIndex = frameValidPixels.data[gl_GlobalInvocationID.x];
+	ivec2 pixelPos = ivec2(pixelIndex % uint(frameSize.x), pixelIndex / uint(frameSize.x));
+	frameVertex = vec3(frameInvView * vec4(imageLoad(frameVertexMap, pixelPos).xyz, 1.0));
+	vec3 frameNormal = mat3(frameInvView) * imageLoad(frameNormalMap, pixelPos).xyz;
+	vec3 frameVertexInModelView = vec3(icpParameters.modelView * vec4(frameVertex, 1.0));
+	vec4 intrinsics = icpParameters.intrinsics[icpLevel.level];
+	ivec2 nearestPixel = ivec2(
+		int(round(intrinsics.x * frameVertexInModelView.x / frameVertexInModelView.z + intrinsics.z)),
+		int(round(intrinsics.y * frameVertexInModelView.y / frameVertexInModelView.z + intrinsics.w))
+	);
+	if (nearestPixel.x < 0 || nearestPixel.x >= frameSize.x ||
+		nearestPixel.y < 0 || nearestPixel.y >= frameSize.y ||
+		frameVertexInModelView.z <= 0 ||
+		!validModelPixel(nearestPixel, frameSize))
+	{
+		return false;
+	}
+	modelVertex = imageLoad(modelVertexMap, nearestPixel).xyz;
+	modelNormal = imageLoad(modelNormalMap, nearestPixel).xyz;
+	return
+		length(frameVertex - modelVertex) <= icpParameters.distanceThreshold &&
+		dot(frameNormal, modelNormal) >= icpParameters.angleThreshold;
+}
+
+/** @brief	Sum up the upper triangle of `row * row^T` and the number of correspondences over the work group.
+  *
+  *			Rows without a correspondence must be zero.
+  */
+void reduceRow(float row[7], bool found, uint hypothesis) {
+	// Each hypothesis owns a slice of the global sum buffer.
+	uint globalWorkGroupID = hypothesis * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+	// The last term of the upper triangle, row[6] * row[6], is the squared residual.
+	uint term = 0;
+	for (int i = 0; i < 7; ++i)
+		for (int j = i; j < 7; ++j) {
+			reduceAndStore(row[i] * row[j], globalWorkGroupID, term);
+			++term;
+		}
+	reduceAndStore(found ? 1.0 : 0.0, globalWorkGroupID, term);
+}
@@ -0,0 +1,21 @@
+/** @brief	Maximum number of initial pose hypotheses evaluated in the same dispatches.
+  */
+const uint MAX_NUM_HYPOTHESES = 8;
+
+/** @brief	Number of floats summed per hypothesis: 21 elements of the symmetric
+  *			matrix A, 6 elements of b, the sum of squared residuals, and the
+  *			number of inliers.
+  */
+const uint NUM_SUM_TERMS = 29;
+
+/** @brief	State of ICP started from one initial pose hypothesis.
+  */
+struct ICPHypothesis {
+	mat4 frameInvView;			//!< The inverse of the current view matrix of the frame data.
+	uint converged;				//!< Whether ICP has converged in the current pyramid level.
+	uint failed;				//!< Whether ICP has failed.
+	uint numIterations;			//!< Number of iterations that updated the pose.
+	uint numInliers;			//!< Number of correspondences found in the last iteration.
+	float residual;				//!< Sum of squared point-to-plane residuals in the last iteration.
+	uint padding[3];
+};
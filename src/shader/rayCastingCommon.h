@@ -78,7 +78,7 @@ float interpolateTSDF(in vec3 pos, out bool valid) {
 		for (uint dy = 0; dy < 2; ++dy)
 			for (uint dz = 0; dz < 2; ++dz) {
 				int weight;
-				unpackVoxel(readVoxelData(baseIndex + uvec3(dx, dy, dz)).x, tsdf[dx][dy][dz], weight);
+				unpackVoxel(readVoxelData(baseIndex + uvec3(dx, dy, dz)), tsdf[dx][dy][dz], weight);
 				if (weight == 0) valid = false;
 			}
 	// Interpolate
@@ -97,6 +97,8 @@ float interpolateTSDF(in vec3 pos, out bool valid) {
 }
 
 /** @brief	Helper function to interpolate the color value.
+  *
+  * The colors are read through the color brick indirection table.
   * @note	It's the caller's reponsibility to make sure `pos` is within valid range.
   * @param	pos		The position in world space.
   * @return			The interpolated color value.
@@ -110,7 +112,7 @@ vec4 interpolateColor(vec3 pos) {
 	for (uint dx = 0; dx < 2; ++dx)
 		for (uint dy = 0; dy < 2; ++dy)
 			for (uint dz = 0; dz < 2; ++dz) {
-				unpackColor(readVoxelData(baseIndex + uvec3(dx, dy, dz)).y, color[dx][dy][dz]);
+				color[dx][dy][dz] = readVoxelColor(baseIndex + uvec3(dx, dy, dz));
 			}
 	// Interpolate
 	vec4 coeff[8];
@@ -142,7 +144,7 @@ vec3 computeNormal(vec3 pos) {
 		for (uint dy = 0; dy < 2; ++dy)
 			for (uint dz = 0; dz < 2; ++dz) {
 				int weight;
-				unpackVoxel(readVoxelData(baseIndex + uvec3(dx, dy, dz)).x, tsdf[dx][dy][dz], weight);
+				unpackVoxel(readVoxelData(baseIndex + uvec3(dx, dy, dz)), tsdf[dx][dy][dz], weight);
 			}
 	// Get the coefficients of trilinear interpolation.
 	float coeff[8];
@@ -156,6 +158,12 @@ vec3 computeNormal(vec3 pos) {
 	return normal;
 }
 
+/** The functions below read `rayCastingParameters`. Shaders that only need the
+  * interpolation helpers define `RAY_CASTING_INTERPOLATION_ONLY` before including
+  * this file.
+  */
+#ifndef RAY_CASTING_INTERPOLATION_ONLY
+
 /** @brief	Function that actually does ray casting.
   *	@return	Ray marching length, in meter. Note that this is not the depth value.
   *			If the ray does not intersect with a zero surface, +infinity will be returned.
@@ -214,4 +222,46 @@ float rayCasting(vec3 rayOrigin, vec3 rayDir, float minLength, float maxLength)
 		}
 	}
 	return (1.0f / 0.0f);
-}
\ No newline at end of file
+}
+
+/** @brief	Helper function to compute the ray of a pixel from `rayCastingParameters`.
+  * @param	pixelPos	The pixel position.
+  * @param	rayOrigin	Output ray origin in world space.
+  * @param	rayDir		Output normalized ray direction in world space.
+  * @return				The ratio between the ray marching length and the depth.
+  */
+float getPixelRay(ivec2 pixelPos, out vec3 rayOrigin, out vec3 rayDir) {
+	rayOrigin = rayCastingParameters.invView[3].xyz;
+	rayDir = vec3(
+		(float(pixelPos.x) - rayCastingParameters.cx) / rayCastingParameters.fx,
+		(float(pixelPos.y) - rayCastingParameters.cy) / rayCastingParameters.fy,
+		1.0
+	);
+	float scaleFactor = length(rayDir);
+	rayDir = normalize(mat3(rayCastingParameters.invView) * rayDir);
+	return scaleFactor;
+}
+
+/** @brief	Ray cast the color, depth, and normal of a pixel of a surface.
+  * @param	pixelPos	The pixel position.
+  * @param	color		Output color. Zero if the ray does not hit the surface.
+  * @param	depth		Output true depth. `rayCastingParameters.invalidDepth` if the ray does not hit the surface.
+  * @param	normal		Output normal in world space. Zero if the ray does not hit the surface.
+  */
+void rayCastSurface(ivec2 pixelPos, out vec4 color, out float depth, out vec3 normal) {
+	vec3 rayOrigin, rayDir;
+	float scaleFactor = getPixelRay(pixelPos, rayOrigin, rayDir);
+	float rayCastingResult = rayCasting(rayOrigin, rayDir, rayCastingParameters.minDepth * scaleFactor, rayCastingParameters.maxDepth * scaleFactor);
+	if (isinf(rayCastingResult)) {
+		color = vec4(0.0, 0.0, 0.0, 0.0);
+		depth = rayCastingParameters.invalidDepth;
+		normal = vec3(0.0, 0.0, 0.0);
+	} else {
+		vec3 pos = rayOrigin + rayCastingResult * rayDir;
+		color = interpolateColor(pos);
+		depth = rayCastingResult / scaleFactor;
+		normal = computeNormal(pos);
+	}
+}
+
+#endif
@@ -14,10 +14,14 @@ layout(set = 0, binding = 0) uniform CameraParameters {
 	vec4 viewPos;
 } cameraParameters;
 
-layout(set = 1, binding = 0) uniform ModelTransforms {
+struct ModelTransform {
 	mat4 model;
 	mat4 normal;
-} modelTransforms;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer ModelTransforms {
+	ModelTransform modelTransforms[];
+};
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec4 inColor;
@@ -25,7 +29,8 @@ layout(location = 1) in vec4 inColor;
 layout(location = 0) out vec4 outColor;
 
 void main() {
-	gl_Position = cameraParameters.projection * cameraParameters.view * modelTransforms.model * vec4(inPosition, 1.0);
+	ModelTransform modelTransform = modelTransforms[gl_InstanceIndex];
+	gl_Position = cameraParameters.projection * cameraParameters.view * modelTransform.model * vec4(inPosition, 1.0);
 	gl_PointSize = 2.0;
 	outColor = inColor;
 }
\ No newline at end of file
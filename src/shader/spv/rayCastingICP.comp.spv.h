@@ -1 +0,0 @@
-constexpr char rayCastingICP_comp_spv[] = { '\x03', '\x02', '\x23', '\x07', '\x00', '\x00', '\x01', '\x00', '\x0b', '\x00', '\x0d', '\x00', '\xd5', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x11', '\x00', '\x02', '\x00', '\x01', '\x00', '\x00', '\x00', '\x11', '\x00', '\x02', '\x00', '\x32', '\x00', '\x00', '\x00', '\x0b', '\x00', '\x06', '\x00', '\x01', '\x00', '\x00', '\x00', '\x47', '\x4c', '\x53', '\x4c', '\x2e', '\x73', '\x74', '\x64', '\x2e', '\x34', '\x35', '\x30', '\x00', '\x00', '\x00', '\x00', '\x0e', '\x00', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x0f', '\x00', '\x06', '\x00', '\x05', '\x00', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x6d', '\x61', '\x69', '\x6e', '\x00', '\x00', '\x00', '\x00', '\x49', '\x03', '\x00', '\x00', '\x10', '\x00', '\x06', '\x00', '\x04', '\x00', '\x00', '\x00', '\x11', '\x00', '\x00', '\x00', '\x20', '\x00', '\x00', '\x00', '\x20', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x03', '\x00', '\x03', '\x00', '\x02', '\x00', '\x00', '\x00', '\xc2', '\x01', '\x00', '\x00', '\x04', '\x00', '\x0a', '\x00', '\x47', '\x4c', '\x5f', '\x47', '\x4f', '\x4f', '\x47', '\x4c', '\x45', '\x5f', '\x63', '\x70', '\x70', '\x5f', '\x73', '\x74', '\x79', '\x6c', '\x65', '\x5f', '\x6c', '\x69', '\x6e', '\x65', '\x5f', '\x64', '\x69', '\x72', '\x65', '\x63', '\x74', '\x69', '\x76', '\x65', '\x00', '\x00', '\x04', '\x00', '\x08', '\x00', '\x47', '\x4c', '\x5f', '\x47', '\x4f', '\x4f', '\x47', '\x4c', '\x45', '\x5f', '\x69', '\x6e', '\x63', '\x6c', '\x75', '\x64', '\x65', '\x5f', '\x64', '\x69', '\x72', '\x65', '\x63', '\x74', '\x69', '\x76', '\x65', '\x00', '\x05', '\x00', '\x04', '\x00', '\x04', '\x00', '\x00', '\x00', '\x6d', '\x61', '\x69', '\x6e', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x08', '\x00', '\x0e', '\x00', '\x00', '\x00', '\x75', '\x6e', '\x70', '\x61', '\x63', '\x6b', '\x56', '\x6f', '\x78', '\x65', '\x6c', '\x28', '\x69', '\x31', '\x3b', '\x66', '\x31', '\x3b', '\x69', '\x31', '\x3b', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x0b', '\x00', '\x00', '\x00', '\x70', '\x61', '\x63', '\x6b', '\x65', '\x64', '\x56', '\x6f', '\x78', '\x65', '\x6c', '\x00', '\x05', '\x00', '\x04', '\x00', '\x0c', '\x00', '\x00', '\x00', '\x74', '\x73', '\x64', '\x66', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x0d', '\x00', '\x00', '\x00', '\x77', '\x65', '\x69', '\x67', '\x68', '\x74', '\x00', '\x00', '\x05', '\x00', '\x07', '\x00', '\x16', '\x00', '\x00', '\x00', '\x72', '\x65', '\x61', '\x64', '\x56', '\x6f', '\x78', '\x65', '\x6c', '\x44', '\x61', '\x74', '\x61', '\x28', '\x76', '\x75', '\x33', '\x3b', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x15', '\x00', '\x00', '\x00', '\x69', '\x6e', '\x64', '\x65', '\x78', '\x00', '\x00', '\x00', '\x05', '\x00', '\x09', '\x00', '\x1f', '\x00', '\x00', '\x00', '\x67', '\x65', '\x74', '\x4d', '\x69', '\x6e', '\x54', '\x28', '\x76', '\x66', '\x33', '\x3b', '\x76', '\x66', '\x33', '\x3b', '\x76', '\x66', '\x33', '\x3b', '\x76', '\x66', '\x33', '\x3b', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x1b', '\x00', '\x00', '\x00', '\x72', '\x61', '\x79', '\x4f', '\x72', '\x69', '\x67', '\x69', '\x6e', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x1c', '\x00', '\x00', '\x00', '\x72', '\x61', '\x79', '\x44', '\x69', '\x72', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x1d', '\x00', '\x00', '\x00', '\x6d', '\x69', '\x6e', '\x43', '\x6f', '\x72', '\x6e', '\x65', '\x72', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x1e', '\x00', '\x00', '\x00', '\x6d', '\x61', '\x78', '\x43', '\x6f', '\x72', '\x6e', '\x65', '\x72', '\x00', '\x00', '\x00', '\x05', '\x00', '\x09', '\x00', '\x25', '\x00', '\x00', '\x00', '\x67', '\x65', '\x74', '\x4d', '\x61', '\x78', '\x54', '\x28', '\x76', '\x66', '\x33', '\x3b', '\x76', '\x66', '\x33', '\x3b', '\x76', '\x66', '\x33', '\x3b', '\x76', '\x66', '\x33', '\x3b', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x21', '\x00', '\x00', '\x00', '\x72', '\x61', '\x79', '\x4f', '\x72', '\x69', '\x67', '\x69', '\x6e', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x22', '\x00', '\x00', '\x00', '\x72', '\x61', '\x79', '\x44', '\x69', '\x72', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x23', '\x00', '\x00', '\x00', '\x6d', '\x69', '\x6e', '\x43', '\x6f', '\x72', '\x6e', '\x65', '\x72', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x24', '\x00', '\x00', '\x00', '\x6d', '\x61', '\x78', '\x43', '\x6f', '\x72', '\x6e', '\x65', '\x72', '\x00', '\x00', '\x00', '\x05', '\x00', '\x0b', '\x00', '\x32', '\x00', '\x00', '\x00', '\x67', '\x65', '\x74', '\x43', '\x6f', '\x65', '\x66', '\x66', '\x69', '\x63', '\x69', '\x65', '\x6e', '\x74', '\x73', '\x28', '\x66', '\x31', '\x5b', '\x32', '\x5d', '\x5b', '\x32', '\x5d', '\x5b', '\x32', '\x5d', '\x3b', '\x66', '\x31', '\x5b', '\x38', '\x5d', '\x3b', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x30', '\x00', '\x00', '\x00', '\x74', '\x73', '\x64', '\x66', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x31', '\x00', '\x00', '\x00', '\x63', '\x6f', '\x65', '\x66', '\x66', '\x00', '\x00', '\x00', '\x05', '\x00', '\x07', '\x00', '\x36', '\x00', '\x00', '\x00', '\x67', '\x65', '\x74', '\x42', '\x61', '\x73', '\x65', '\x49', '\x6e', '\x64', '\x65', '\x78', '\x28', '\x76', '\x66', '\x33', '\x3b', '\x00', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\x35', '\x00', '\x00', '\x00', '\x70', '\x6f', '\x73', '\x00', '\x05', '\x00', '\x08', '\x00', '\x3d', '\x00', '\x00', '\x00', '\x69', '\x6e', '\x74', '\x65', '\x72', '\x70', '\x6f', '\x6c', '\x61', '\x74', '\x65', '\x54', '\x53', '\x44', '\x46', '\x28', '\x76', '\x66', '\x33', '\x3b', '\x62', '\x31', '\x3b', '\x00', '\x05', '\x00', '\x03', '\x00', '\x3b', '\x00', '\x00', '\x00', '\x70', '\x6f', '\x73', '\x00', '\x05', '\x00', '\x04', '\x00', '\x3c', '\x00', '\x00', '\x00', '\x76', '\x61', '\x6c', '\x69', '\x64', '\x00', '\x00', '\x00', '\x05', '\x00', '\x07', '\x00', '\x41', '\x00', '\x00', '\x00', '\x63', '\x6f', '\x6d', '\x70', '\x75', '\x74', '\x65', '\x4e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x28', '\x76', '\x66', '\x33', '\x3b', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\x40', '\x00', '\x00', '\x00', '\x70', '\x6f', '\x73', '\x00', '\x05', '\x00', '\x09', '\x00', '\x48', '\x00', '\x00', '\x00', '\x72', '\x61', '\x79', '\x43', '\x61', '\x73', '\x74', '\x69', '\x6e', '\x67', '\x28', '\x76', '\x66', '\x33', '\x3b', '\x76', '\x66', '\x33', '\x3b', '\x66', '\x31', '\x3b', '\x66', '\x31', '\x3b', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x44', '\x00', '\x00', '\x00', '\x72', '\x61', '\x79', '\x4f', '\x72', '\x69', '\x67', '\x69', '\x6e', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x45', '\x00', '\x00', '\x00', '\x72', '\x61', '\x79', '\x44', '\x69', '\x72', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x46', '\x00', '\x00', '\x00', '\x6d', '\x69', '\x6e', '\x4c', '\x65', '\x6e', '\x67', '\x74', '\x68', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x47', '\x00', '\x00', '\x00', '\x6d', '\x61', '\x78', '\x4c', '\x65', '\x6e', '\x67', '\x74', '\x68', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x54', '\x00', '\x00', '\x00', '\x54', '\x53', '\x44', '\x46', '\x56', '\x6f', '\x6c', '\x75', '\x6d', '\x65', '\x00', '\x00', '\x06', '\x00', '\x06', '\x00', '\x54', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x72', '\x65', '\x73', '\x6f', '\x6c', '\x75', '\x74', '\x69', '\x6f', '\x6e', '\x00', '\x00', '\x06', '\x00', '\x05', '\x00', '\x54', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x73', '\x69', '\x7a', '\x65', '\x00', '\x00', '\x00', '\x00', '\x06', '\x00', '\x05', '\x00', '\x54', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x63', '\x6f', '\x72', '\x6e', '\x65', '\x72', '\x00', '\x00', '\x06', '\x00', '\x08', '\x00', '\x54', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x74', '\x72', '\x75', '\x6e', '\x63', '\x61', '\x74', '\x69', '\x6f', '\x6e', '\x44', '\x69', '\x73', '\x74', '\x61', '\x6e', '\x63', '\x65', '\x00', '\x00', '\x06', '\x00', '\x05', '\x00', '\x54', '\x00', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x64', '\x61', '\x74', '\x61', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x56', '\x00', '\x00', '\x00', '\x74', '\x73', '\x64', '\x66', '\x56', '\x6f', '\x6c', '\x75', '\x6d', '\x65', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x70', '\x00', '\x00', '\x00', '\x78', '\x4d', '\x69', '\x6e', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x84', '\x00', '\x00', '\x00', '\x79', '\x4d', '\x69', '\x6e', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x97', '\x00', '\x00', '\x00', '\x7a', '\x4d', '\x69', '\x6e', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xb1', '\x00', '\x00', '\x00', '\x78', '\x4d', '\x61', '\x78', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xc4', '\x00', '\x00', '\x00', '\x79', '\x4d', '\x61', '\x78', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xd7', '\x00', '\x00', '\x00', '\x7a', '\x4d', '\x61', '\x78', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x4c', '\x01', '\x00', '\x00', '\x62', '\x61', '\x73', '\x65', '\x49', '\x6e', '\x64', '\x65', '\x78', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x74', '\x01', '\x00', '\x00', '\x62', '\x61', '\x73', '\x65', '\x49', '\x6e', '\x64', '\x65', '\x78', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x75', '\x01', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x06', '\x00', '\x78', '\x01', '\x00', '\x00', '\x6e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x69', '\x7a', '\x65', '\x64', '\x50', '\x6f', '\x73', '\x00', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\x84', '\x01', '\x00', '\x00', '\x64', '\x78', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\x8c', '\x01', '\x00', '\x00', '\x64', '\x79', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\x94', '\x01', '\x00', '\x00', '\x64', '\x7a', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xa2', '\x01', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xa4', '\x01', '\x00', '\x00', '\x74', '\x73', '\x64', '\x66', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xa8', '\x01', '\x00', '\x00', '\x77', '\x65', '\x69', '\x67', '\x68', '\x74', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xa9', '\x01', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xab', '\x01', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xac', '\x01', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xbc', '\x01', '\x00', '\x00', '\x63', '\x6f', '\x65', '\x66', '\x66', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xbd', '\x01', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xbf', '\x01', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x06', '\x00', '\xc2', '\x01', '\x00', '\x00', '\x69', '\x6e', '\x74', '\x65', '\x72', '\x70', '\x6f', '\x6c', '\x61', '\x74', '\x65', '\x64', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x01', '\x02', '\x00', '\x00', '\x62', '\x61', '\x73', '\x65', '\x49', '\x6e', '\x64', '\x65', '\x78', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x02', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x06', '\x00', '\x05', '\x02', '\x00', '\x00', '\x6e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x69', '\x7a', '\x65', '\x64', '\x50', '\x6f', '\x73', '\x00', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\x11', '\x02', '\x00', '\x00', '\x64', '\x78', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\x19', '\x02', '\x00', '\x00', '\x64', '\x79', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\x21', '\x02', '\x00', '\x00', '\x64', '\x7a', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x2f', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x31', '\x02', '\x00', '\x00', '\x74', '\x73', '\x64', '\x66', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x35', '\x02', '\x00', '\x00', '\x77', '\x65', '\x69', '\x67', '\x68', '\x74', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x36', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x38', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x39', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x44', '\x02', '\x00', '\x00', '\x63', '\x6f', '\x65', '\x66', '\x66', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x45', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x47', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x4a', '\x02', '\x00', '\x00', '\x6e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\xb7', '\x02', '\x00', '\x00', '\x6d', '\x69', '\x6e', '\x43', '\x6f', '\x72', '\x6e', '\x65', '\x72', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\xba', '\x02', '\x00', '\x00', '\x6d', '\x61', '\x78', '\x43', '\x6f', '\x72', '\x6e', '\x65', '\x72', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xc7', '\x02', '\x00', '\x00', '\x6d', '\x69', '\x6e', '\x54', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xc8', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xca', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xcc', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xce', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xd4', '\x02', '\x00', '\x00', '\x6d', '\x61', '\x78', '\x54', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xd5', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xd7', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xd9', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xdb', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x63', '\x75', '\x72', '\x72', '\x54', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xeb', '\x02', '\x00', '\x00', '\x6c', '\x61', '\x73', '\x74', '\x54', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\xed', '\x02', '\x00', '\x00', '\x63', '\x75', '\x72', '\x72', '\x54', '\x53', '\x44', '\x46', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\xee', '\x02', '\x00', '\x00', '\x6c', '\x61', '\x73', '\x74', '\x54', '\x53', '\x44', '\x46', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xf7', '\x02', '\x00', '\x00', '\x76', '\x61', '\x6c', '\x69', '\x64', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xfd', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xfe', '\x02', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x08', '\x00', '\x15', '\x03', '\x00', '\x00', '\x52', '\x61', '\x79', '\x43', '\x61', '\x73', '\x74', '\x69', '\x6e', '\x67', '\x50', '\x61', '\x72', '\x61', '\x6d', '\x65', '\x74', '\x65', '\x72', '\x73', '\x00', '\x00', '\x00', '\x00', '\x06', '\x00', '\x04', '\x00', '\x15', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x66', '\x78', '\x00', '\x00', '\x06', '\x00', '\x04', '\x00', '\x15', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x66', '\x79', '\x00', '\x00', '\x06', '\x00', '\x04', '\x00', '\x15', '\x03', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x63', '\x78', '\x00', '\x00', '\x06', '\x00', '\x04', '\x00', '\x15', '\x03', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x63', '\x79', '\x00', '\x00', '\x06', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x69', '\x6e', '\x76', '\x56', '\x69', '\x65', '\x77', '\x00', '\x06', '\x00', '\x06', '\x00', '\x15', '\x03', '\x00', '\x00', '\x05', '\x00', '\x00', '\x00', '\x6d', '\x69', '\x6e', '\x44', '\x65', '\x70', '\x74', '\x68', '\x00', '\x00', '\x00', '\x00', '\x06', '\x00', '\x06', '\x00', '\x15', '\x03', '\x00', '\x00', '\x06', '\x00', '\x00', '\x00', '\x6d', '\x61', '\x78', '\x44', '\x65', '\x70', '\x74', '\x68', '\x00', '\x00', '\x00', '\x00', '\x06', '\x00', '\x07', '\x00', '\x15', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x69', '\x6e', '\x76', '\x61', '\x6c', '\x69', '\x64', '\x44', '\x65', '\x70', '\x74', '\x68', '\x00', '\x00', '\x00', '\x00', '\x06', '\x00', '\x07', '\x00', '\x15', '\x03', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x6d', '\x61', '\x72', '\x63', '\x68', '\x69', '\x6e', '\x67', '\x53', '\x74', '\x65', '\x70', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x08', '\x00', '\x17', '\x03', '\x00', '\x00', '\x72', '\x61', '\x79', '\x43', '\x61', '\x73', '\x74', '\x69', '\x6e', '\x67', '\x50', '\x61', '\x72', '\x61', '\x6d', '\x65', '\x74', '\x65', '\x72', '\x73', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\x2f', '\x03', '\x00', '\x00', '\x74', '\x00', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\x40', '\x03', '\x00', '\x00', '\x74', '\x00', '\x00', '\x00', '\x05', '\x00', '\x06', '\x00', '\x47', '\x03', '\x00', '\x00', '\x6f', '\x75', '\x74', '\x70', '\x75', '\x74', '\x50', '\x69', '\x78', '\x65', '\x6c', '\x50', '\x6f', '\x73', '\x00', '\x00', '\x05', '\x00', '\x08', '\x00', '\x49', '\x03', '\x00', '\x00', '\x67', '\x6c', '\x5f', '\x47', '\x6c', '\x6f', '\x62', '\x61', '\x6c', '\x49', '\x6e', '\x76', '\x6f', '\x63', '\x61', '\x74', '\x69', '\x6f', '\x6e', '\x49', '\x44', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x52', '\x03', '\x00', '\x00', '\x6f', '\x75', '\x74', '\x70', '\x75', '\x74', '\x53', '\x69', '\x7a', '\x65', '\x00', '\x00', '\x05', '\x00', '\x07', '\x00', '\x55', '\x03', '\x00', '\x00', '\x6f', '\x75', '\x74', '\x70', '\x75', '\x74', '\x44', '\x65', '\x70', '\x74', '\x68', '\x49', '\x6d', '\x61', '\x67', '\x65', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x69', '\x03', '\x00', '\x00', '\x72', '\x61', '\x79', '\x4f', '\x72', '\x69', '\x67', '\x69', '\x6e', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x6e', '\x03', '\x00', '\x00', '\x72', '\x61', '\x79', '\x44', '\x69', '\x72', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\x83', '\x03', '\x00', '\x00', '\x73', '\x63', '\x61', '\x6c', '\x65', '\x46', '\x61', '\x63', '\x74', '\x6f', '\x72', '\x00', '\x05', '\x00', '\x07', '\x00', '\x94', '\x03', '\x00', '\x00', '\x72', '\x61', '\x79', '\x43', '\x61', '\x73', '\x74', '\x69', '\x6e', '\x67', '\x52', '\x65', '\x73', '\x75', '\x6c', '\x74', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x9d', '\x03', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\x9f', '\x03', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xa1', '\x03', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xa2', '\x03', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\xa8', '\x03', '\x00', '\x00', '\x6f', '\x75', '\x74', '\x44', '\x65', '\x70', '\x74', '\x68', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\xa9', '\x03', '\x00', '\x00', '\x6f', '\x75', '\x74', '\x56', '\x65', '\x72', '\x74', '\x65', '\x78', '\x00', '\x00', '\x00', '\x05', '\x00', '\x05', '\x00', '\xab', '\x03', '\x00', '\x00', '\x6f', '\x75', '\x74', '\x4e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x00', '\x00', '\x00', '\x05', '\x00', '\x04', '\x00', '\xac', '\x03', '\x00', '\x00', '\x6d', '\x61', '\x73', '\x6b', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x03', '\x00', '\xae', '\x03', '\x00', '\x00', '\x70', '\x6f', '\x73', '\x00', '\x05', '\x00', '\x04', '\x00', '\xb8', '\x03', '\x00', '\x00', '\x70', '\x61', '\x72', '\x61', '\x6d', '\x00', '\x00', '\x00', '\x05', '\x00', '\x06', '\x00', '\xc1', '\x03', '\x00', '\x00', '\x6f', '\x75', '\x74', '\x70', '\x75', '\x74', '\x56', '\x65', '\x72', '\x74', '\x65', '\x78', '\x4d', '\x61', '\x70', '\x00', '\x05', '\x00', '\x06', '\x00', '\xca', '\x03', '\x00', '\x00', '\x6f', '\x75', '\x74', '\x70', '\x75', '\x74', '\x4e', '\x6f', '\x72', '\x6d', '\x61', '\x6c', '\x4d', '\x61', '\x70', '\x00', '\x47', '\x00', '\x04', '\x00', '\x53', '\x00', '\x00', '\x00', '\x06', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x48', '\x00', '\x04', '\x00', '\x54', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x18', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x54', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x48', '\x00', '\x04', '\x00', '\x54', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x18', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x54', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x00', '\x00', '\x48', '\x00', '\x04', '\x00', '\x54', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x18', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x54', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x10', '\x00', '\x00', '\x00', '\x48', '\x00', '\x04', '\x00', '\x54', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x18', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x54', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x00', '\x00', '\x48', '\x00', '\x04', '\x00', '\x54', '\x00', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x18', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x54', '\x00', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x20', '\x00', '\x00', '\x00', '\x47', '\x00', '\x03', '\x00', '\x54', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\x56', '\x00', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\x56', '\x00', '\x00', '\x00', '\x21', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x00', '\x00', '\x48', '\x00', '\x04', '\x00', '\x15', '\x03', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x05', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x10', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x10', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x05', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x50', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x06', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x54', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x48', '\x00', '\x05', '\x00', '\x15', '\x03', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x47', '\x00', '\x03', '\x00', '\x15', '\x03', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\x17', '\x03', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\x17', '\x03', '\x00', '\x00', '\x21', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\x49', '\x03', '\x00', '\x00', '\x0b', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\x55', '\x03', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\x55', '\x03', '\x00', '\x00', '\x21', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\xc1', '\x03', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\xc1', '\x03', '\x00', '\x00', '\x21', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\xca', '\x03', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\xca', '\x03', '\x00', '\x00', '\x21', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x47', '\x00', '\x04', '\x00', '\xd4', '\x03', '\x00', '\x00', '\x0b', '\x00', '\x00', '\x00', '\x19', '\x00', '\x00', '\x00', '\x13', '\x00', '\x02', '\x00', '\x02', '\x00', '\x00', '\x00', '\x21', '\x00', '\x03', '\x00', '\x03', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x15', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x20', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x07', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x06', '\x00', '\x00', '\x00', '\x16', '\x00', '\x03', '\x00', '\x08', '\x00', '\x00', '\x00', '\x20', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x21', '\x00', '\x06', '\x00', '\x0a', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x09', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x15', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x20', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x17', '\x00', '\x04', '\x00', '\x11', '\x00', '\x00', '\x00', '\x10', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x12', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x11', '\x00', '\x00', '\x00', '\x17', '\x00', '\x04', '\x00', '\x13', '\x00', '\x00', '\x00', '\x06', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x21', '\x00', '\x04', '\x00', '\x14', '\x00', '\x00', '\x00', '\x13', '\x00', '\x00', '\x00', '\x12', '\x00', '\x00', '\x00', '\x17', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x18', '\x00', '\x00', '\x00', '\x21', '\x00', '\x07', '\x00', '\x1a', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x19', '\x00', '\x00', '\x00', '\x19', '\x00', '\x00', '\x00', '\x19', '\x00', '\x00', '\x00', '\x19', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x04', '\x00', '\x28', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x04', '\x00', '\x29', '\x00', '\x00', '\x00', '\x28', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x04', '\x00', '\x2a', '\x00', '\x00', '\x00', '\x29', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x2b', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x2a', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x2c', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x04', '\x00', '\x2d', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x2c', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x2e', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x2d', '\x00', '\x00', '\x00', '\x21', '\x00', '\x05', '\x00', '\x2f', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x00', '\x00', '\x2e', '\x00', '\x00', '\x00', '\x21', '\x00', '\x04', '\x00', '\x34', '\x00', '\x00', '\x00', '\x11', '\x00', '\x00', '\x00', '\x19', '\x00', '\x00', '\x00', '\x14', '\x00', '\x02', '\x00', '\x38', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x39', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x38', '\x00', '\x00', '\x00', '\x21', '\x00', '\x05', '\x00', '\x3a', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x19', '\x00', '\x00', '\x00', '\x39', '\x00', '\x00', '\x00', '\x21', '\x00', '\x04', '\x00', '\x3f', '\x00', '\x00', '\x00', '\x18', '\x00', '\x00', '\x00', '\x19', '\x00', '\x00', '\x00', '\x21', '\x00', '\x07', '\x00', '\x43', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x19', '\x00', '\x00', '\x00', '\x19', '\x00', '\x00', '\x00', '\x09', '\x00', '\x00', '\x00', '\x09', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x4b', '\x00', '\x00', '\x00', '\x10', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x4e', '\x00', '\x00', '\x00', '\x00', '\x01', '\x00', '\x38', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x51', '\x00', '\x00', '\x00', '\xff', '\xff', '\x00', '\x00', '\x1d', '\x00', '\x03', '\x00', '\x53', '\x00', '\x00', '\x00', '\x13', '\x00', '\x00', '\x00', '\x1e', '\x00', '\x07', '\x00', '\x54', '\x00', '\x00', '\x00', '\x11', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x18', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x53', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x55', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x54', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x55', '\x00', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x57', '\x00', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x59', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x10', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x5e', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x10', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x6b', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x13', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\xfc', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x04', '\x01', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x18', '\x01', '\x00', '\x00', '\x05', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x25', '\x01', '\x00', '\x00', '\x06', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x32', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x4e', '\x01', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x18', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x52', '\x01', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x29', '\x00', '\x03', '\x00', '\x38', '\x00', '\x00', '\x00', '\x73', '\x01', '\x00', '\x00', '\x2a', '\x00', '\x03', '\x00', '\x38', '\x00', '\x00', '\x00', '\xb5', '\x01', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x9b', '\x02', '\x00', '\x00', '\xac', '\xc5', '\x27', '\x37', '\x20', '\x00', '\x04', '\x00', '\xbd', '\x02', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x11', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe6', '\x02', '\x00', '\x00', '\x00', '\x00', '\x80', '\x7f', '\x2b', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xec', '\x02', '\x00', '\x00', '\x00', '\x00', '\x80', '\xbf', '\x2b', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x08', '\x03', '\x00', '\x00', '\x33', '\x33', '\x73', '\x3f', '\x17', '\x00', '\x04', '\x00', '\x13', '\x03', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x18', '\x00', '\x04', '\x00', '\x14', '\x03', '\x00', '\x00', '\x13', '\x03', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x1e', '\x00', '\x0b', '\x00', '\x15', '\x03', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x14', '\x03', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x16', '\x03', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x15', '\x03', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x16', '\x03', '\x00', '\x00', '\x17', '\x03', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x18', '\x03', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x27', '\x03', '\x00', '\x00', '\xac', '\xc5', '\x27', '\xb7', '\x20', '\x00', '\x04', '\x00', '\x46', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x13', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x48', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x11', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x48', '\x03', '\x00', '\x00', '\x49', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x4a', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x10', '\x00', '\x00', '\x00', '\x19', '\x00', '\x09', '\x00', '\x53', '\x03', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x54', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x53', '\x03', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x54', '\x03', '\x00', '\x00', '\x55', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\x6a', '\x03', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x13', '\x03', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x81', '\x03', '\x00', '\x00', '\x00', '\x00', '\x80', '\x3f', '\x20', '\x00', '\x04', '\x00', '\x86', '\x03', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x14', '\x03', '\x00', '\x00', '\x18', '\x00', '\x04', '\x00', '\x89', '\x03', '\x00', '\x00', '\x18', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\x2c', '\x00', '\x06', '\x00', '\x18', '\x00', '\x00', '\x00', '\xaa', '\x03', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\x19', '\x00', '\x09', '\x00', '\xbf', '\x03', '\x00', '\x00', '\x08', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x20', '\x00', '\x04', '\x00', '\xc0', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xbf', '\x03', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\xc0', '\x03', '\x00', '\x00', '\xc1', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\xc0', '\x03', '\x00', '\x00', '\xca', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x2b', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\xd3', '\x03', '\x00', '\x00', '\x20', '\x00', '\x00', '\x00', '\x2c', '\x00', '\x06', '\x00', '\x11', '\x00', '\x00', '\x00', '\xd4', '\x03', '\x00', '\x00', '\xd3', '\x03', '\x00', '\x00', '\xd3', '\x03', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x36', '\x00', '\x05', '\x00', '\x02', '\x00', '\x00', '\x00', '\x04', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x05', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x46', '\x03', '\x00', '\x00', '\x47', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x46', '\x03', '\x00', '\x00', '\x52', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\x69', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\x6e', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x83', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x94', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\x9d', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\x9f', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xa1', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xa2', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xa8', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xa9', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xab', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xac', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xae', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xb8', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x4a', '\x03', '\x00', '\x00', '\x4b', '\x03', '\x00', '\x00', '\x49', '\x03', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x4c', '\x03', '\x00', '\x00', '\x4b', '\x03', '\x00', '\x00', '\x7c', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x4d', '\x03', '\x00', '\x00', '\x4c', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x4a', '\x03', '\x00', '\x00', '\x4e', '\x03', '\x00', '\x00', '\x49', '\x03', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x4f', '\x03', '\x00', '\x00', '\x4e', '\x03', '\x00', '\x00', '\x7c', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x50', '\x03', '\x00', '\x00', '\x4f', '\x03', '\x00', '\x00', '\x50', '\x00', '\x05', '\x00', '\x13', '\x00', '\x00', '\x00', '\x51', '\x03', '\x00', '\x00', '\x4d', '\x03', '\x00', '\x00', '\x50', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x47', '\x03', '\x00', '\x00', '\x51', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x53', '\x03', '\x00', '\x00', '\x56', '\x03', '\x00', '\x00', '\x55', '\x03', '\x00', '\x00', '\x68', '\x00', '\x04', '\x00', '\x13', '\x00', '\x00', '\x00', '\x57', '\x03', '\x00', '\x00', '\x56', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x52', '\x03', '\x00', '\x00', '\x57', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x07', '\x00', '\x00', '\x00', '\x58', '\x03', '\x00', '\x00', '\x47', '\x03', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x59', '\x03', '\x00', '\x00', '\x58', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x07', '\x00', '\x00', '\x00', '\x5a', '\x03', '\x00', '\x00', '\x52', '\x03', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x5b', '\x03', '\x00', '\x00', '\x5a', '\x03', '\x00', '\x00', '\xaf', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x5c', '\x03', '\x00', '\x00', '\x59', '\x03', '\x00', '\x00', '\x5b', '\x03', '\x00', '\x00', '\xa8', '\x00', '\x04', '\x00', '\x38', '\x00', '\x00', '\x00', '\x5d', '\x03', '\x00', '\x00', '\x5c', '\x03', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\x5f', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x5d', '\x03', '\x00', '\x00', '\x5e', '\x03', '\x00', '\x00', '\x5f', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x5e', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x07', '\x00', '\x00', '\x00', '\x60', '\x03', '\x00', '\x00', '\x47', '\x03', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x61', '\x03', '\x00', '\x00', '\x60', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x07', '\x00', '\x00', '\x00', '\x62', '\x03', '\x00', '\x00', '\x52', '\x03', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x63', '\x03', '\x00', '\x00', '\x62', '\x03', '\x00', '\x00', '\xaf', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x64', '\x03', '\x00', '\x00', '\x61', '\x03', '\x00', '\x00', '\x63', '\x03', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x5f', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x5f', '\x03', '\x00', '\x00', '\xf5', '\x00', '\x07', '\x00', '\x38', '\x00', '\x00', '\x00', '\x65', '\x03', '\x00', '\x00', '\x5c', '\x03', '\x00', '\x00', '\x05', '\x00', '\x00', '\x00', '\x64', '\x03', '\x00', '\x00', '\x5e', '\x03', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\x67', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x65', '\x03', '\x00', '\x00', '\x66', '\x03', '\x00', '\x00', '\x67', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x66', '\x03', '\x00', '\x00', '\xfd', '\x00', '\x01', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x67', '\x03', '\x00', '\x00', '\x41', '\x00', '\x06', '\x00', '\x6a', '\x03', '\x00', '\x00', '\x6b', '\x03', '\x00', '\x00', '\x17', '\x03', '\x00', '\x00', '\x57', '\x00', '\x00', '\x00', '\x04', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x13', '\x03', '\x00', '\x00', '\x6c', '\x03', '\x00', '\x00', '\x6b', '\x03', '\x00', '\x00', '\x4f', '\x00', '\x08', '\x00', '\x18', '\x00', '\x00', '\x00', '\x6d', '\x03', '\x00', '\x00', '\x6c', '\x03', '\x00', '\x00', '\x6c', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x69', '\x03', '\x00', '\x00', '\x6d', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x07', '\x00', '\x00', '\x00', '\x6f', '\x03', '\x00', '\x00', '\x47', '\x03', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x70', '\x03', '\x00', '\x00', '\x6f', '\x03', '\x00', '\x00', '\x6f', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x71', '\x03', '\x00', '\x00', '\x70', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x72', '\x03', '\x00', '\x00', '\x17', '\x03', '\x00', '\x00', '\xfc', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x73', '\x03', '\x00', '\x00', '\x72', '\x03', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x74', '\x03', '\x00', '\x00', '\x71', '\x03', '\x00', '\x00', '\x73', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x75', '\x03', '\x00', '\x00', '\x17', '\x03', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x76', '\x03', '\x00', '\x00', '\x75', '\x03', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x77', '\x03', '\x00', '\x00', '\x74', '\x03', '\x00', '\x00', '\x76', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x07', '\x00', '\x00', '\x00', '\x78', '\x03', '\x00', '\x00', '\x47', '\x03', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x79', '\x03', '\x00', '\x00', '\x78', '\x03', '\x00', '\x00', '\x6f', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7a', '\x03', '\x00', '\x00', '\x79', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x7b', '\x03', '\x00', '\x00', '\x17', '\x03', '\x00', '\x00', '\x04', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7c', '\x03', '\x00', '\x00', '\x7b', '\x03', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7d', '\x03', '\x00', '\x00', '\x7a', '\x03', '\x00', '\x00', '\x7c', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x7e', '\x03', '\x00', '\x00', '\x17', '\x03', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7f', '\x03', '\x00', '\x00', '\x7e', '\x03', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x80', '\x03', '\x00', '\x00', '\x7d', '\x03', '\x00', '\x00', '\x7f', '\x03', '\x00', '\x00', '\x50', '\x00', '\x06', '\x00', '\x18', '\x00', '\x00', '\x00', '\x82', '\x03', '\x00', '\x00', '\x77', '\x03', '\x00', '\x00', '\x80', '\x03', '\x00', '\x00', '\x81', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x6e', '\x03', '\x00', '\x00', '\x82', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x84', '\x03', '\x00', '\x00', '\x6e', '\x03', '\x00', '\x00', '\x0c', '\x00', '\x06', '\x00', '\x08', '\x00', '\x00', '\x00', '\x85', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x42', '\x00', '\x00', '\x00', '\x84', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x83', '\x03', '\x00', '\x00', '\x85', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x86', '\x03', '\x00', '\x00', '\x87', '\x03', '\x00', '\x00', '\x17', '\x03', '\x00', '\x00', '\x57', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x14', '\x03', '\x00', '\x00', '\x88', '\x03', '\x00', '\x00', '\x87', '\x03', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x13', '\x03', '\x00', '\x00', '\x8a', '\x03', '\x00', '\x00', '\x88', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x4f', '\x00', '\x08', '\x00', '\x18', '\x00', '\x00', '\x00', '\x8b', '\x03', '\x00', '\x00', '\x8a', '\x03', '\x00', '\x00', '\x8a', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x13', '\x03', '\x00', '\x00', '\x8c', '\x03', '\x00', '\x00', '\x88', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x4f', '\x00', '\x08', '\x00', '\x18', '\x00', '\x00', '\x00', '\x8d', '\x03', '\x00', '\x00', '\x8c', '\x03', '\x00', '\x00', '\x8c', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x13', '\x03', '\x00', '\x00', '\x8e', '\x03', '\x00', '\x00', '\x88', '\x03', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x4f', '\x00', '\x08', '\x00', '\x18', '\x00', '\x00', '\x00', '\x8f', '\x03', '\x00', '\x00', '\x8e', '\x03', '\x00', '\x00', '\x8e', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x50', '\x00', '\x06', '\x00', '\x89', '\x03', '\x00', '\x00', '\x90', '\x03', '\x00', '\x00', '\x8b', '\x03', '\x00', '\x00', '\x8d', '\x03', '\x00', '\x00', '\x8f', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x91', '\x03', '\x00', '\x00', '\x6e', '\x03', '\x00', '\x00', '\x91', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\x92', '\x03', '\x00', '\x00', '\x90', '\x03', '\x00', '\x00', '\x91', '\x03', '\x00', '\x00', '\x0c', '\x00', '\x06', '\x00', '\x18', '\x00', '\x00', '\x00', '\x93', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x92', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x6e', '\x03', '\x00', '\x00', '\x93', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x95', '\x03', '\x00', '\x00', '\x17', '\x03', '\x00', '\x00', '\x18', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x96', '\x03', '\x00', '\x00', '\x95', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x97', '\x03', '\x00', '\x00', '\x83', '\x03', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x98', '\x03', '\x00', '\x00', '\x96', '\x03', '\x00', '\x00', '\x97', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x99', '\x03', '\x00', '\x00', '\x17', '\x03', '\x00', '\x00', '\x25', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x9a', '\x03', '\x00', '\x00', '\x99', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x9b', '\x03', '\x00', '\x00', '\x83', '\x03', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x9c', '\x03', '\x00', '\x00', '\x9a', '\x03', '\x00', '\x00', '\x9b', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x9e', '\x03', '\x00', '\x00', '\x69', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x9d', '\x03', '\x00', '\x00', '\x9e', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xa0', '\x03', '\x00', '\x00', '\x6e', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x9f', '\x03', '\x00', '\x00', '\xa0', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa1', '\x03', '\x00', '\x00', '\x98', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa2', '\x03', '\x00', '\x00', '\x9c', '\x03', '\x00', '\x00', '\x39', '\x00', '\x08', '\x00', '\x08', '\x00', '\x00', '\x00', '\xa3', '\x03', '\x00', '\x00', '\x48', '\x00', '\x00', '\x00', '\x9d', '\x03', '\x00', '\x00', '\x9f', '\x03', '\x00', '\x00', '\xa1', '\x03', '\x00', '\x00', '\xa2', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x94', '\x03', '\x00', '\x00', '\xa3', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xa4', '\x03', '\x00', '\x00', '\x94', '\x03', '\x00', '\x00', '\x9d', '\x00', '\x04', '\x00', '\x38', '\x00', '\x00', '\x00', '\xa5', '\x03', '\x00', '\x00', '\xa4', '\x03', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\xa7', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\xa5', '\x03', '\x00', '\x00', '\xa6', '\x03', '\x00', '\x00', '\xad', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xa6', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa8', '\x03', '\x00', '\x00', '\xe6', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa9', '\x03', '\x00', '\x00', '\xaa', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xab', '\x03', '\x00', '\x00', '\xaa', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xac', '\x03', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xa7', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xad', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xaf', '\x03', '\x00', '\x00', '\x69', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xb0', '\x03', '\x00', '\x00', '\x94', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xb1', '\x03', '\x00', '\x00', '\x6e', '\x03', '\x00', '\x00', '\x8e', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\xb2', '\x03', '\x00', '\x00', '\xb1', '\x03', '\x00', '\x00', '\xb0', '\x03', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\xb3', '\x03', '\x00', '\x00', '\xaf', '\x03', '\x00', '\x00', '\xb2', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xae', '\x03', '\x00', '\x00', '\xb3', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xb4', '\x03', '\x00', '\x00', '\x94', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xb5', '\x03', '\x00', '\x00', '\x83', '\x03', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xb6', '\x03', '\x00', '\x00', '\xb4', '\x03', '\x00', '\x00', '\xb5', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa8', '\x03', '\x00', '\x00', '\xb6', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xb7', '\x03', '\x00', '\x00', '\xae', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa9', '\x03', '\x00', '\x00', '\xb7', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xb9', '\x03', '\x00', '\x00', '\xae', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xb8', '\x03', '\x00', '\x00', '\xb9', '\x03', '\x00', '\x00', '\x39', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\xba', '\x03', '\x00', '\x00', '\x41', '\x00', '\x00', '\x00', '\xb8', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xab', '\x03', '\x00', '\x00', '\xba', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xac', '\x03', '\x00', '\x00', '\x81', '\x03', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xa7', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xa7', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x53', '\x03', '\x00', '\x00', '\xbb', '\x03', '\x00', '\x00', '\x55', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x13', '\x00', '\x00', '\x00', '\xbc', '\x03', '\x00', '\x00', '\x47', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xbd', '\x03', '\x00', '\x00', '\xa8', '\x03', '\x00', '\x00', '\x50', '\x00', '\x07', '\x00', '\x13', '\x03', '\x00', '\x00', '\xbe', '\x03', '\x00', '\x00', '\xbd', '\x03', '\x00', '\x00', '\xbd', '\x03', '\x00', '\x00', '\xbd', '\x03', '\x00', '\x00', '\xbd', '\x03', '\x00', '\x00', '\x63', '\x00', '\x04', '\x00', '\xbb', '\x03', '\x00', '\x00', '\xbc', '\x03', '\x00', '\x00', '\xbe', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\xbf', '\x03', '\x00', '\x00', '\xc2', '\x03', '\x00', '\x00', '\xc1', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x13', '\x00', '\x00', '\x00', '\xc3', '\x03', '\x00', '\x00', '\x47', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xc4', '\x03', '\x00', '\x00', '\xa9', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc5', '\x03', '\x00', '\x00', '\xac', '\x03', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc6', '\x03', '\x00', '\x00', '\xc4', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc7', '\x03', '\x00', '\x00', '\xc4', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc8', '\x03', '\x00', '\x00', '\xc4', '\x03', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x50', '\x00', '\x07', '\x00', '\x13', '\x03', '\x00', '\x00', '\xc9', '\x03', '\x00', '\x00', '\xc6', '\x03', '\x00', '\x00', '\xc7', '\x03', '\x00', '\x00', '\xc8', '\x03', '\x00', '\x00', '\xc5', '\x03', '\x00', '\x00', '\x63', '\x00', '\x04', '\x00', '\xc2', '\x03', '\x00', '\x00', '\xc3', '\x03', '\x00', '\x00', '\xc9', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\xbf', '\x03', '\x00', '\x00', '\xcb', '\x03', '\x00', '\x00', '\xca', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x13', '\x00', '\x00', '\x00', '\xcc', '\x03', '\x00', '\x00', '\x47', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xcd', '\x03', '\x00', '\x00', '\xab', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xce', '\x03', '\x00', '\x00', '\xac', '\x03', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xcf', '\x03', '\x00', '\x00', '\xcd', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd0', '\x03', '\x00', '\x00', '\xcd', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd1', '\x03', '\x00', '\x00', '\xcd', '\x03', '\x00', '\x00', '\x02', '\x00', '\x00', '\x00', '\x50', '\x00', '\x07', '\x00', '\x13', '\x03', '\x00', '\x00', '\xd2', '\x03', '\x00', '\x00', '\xcf', '\x03', '\x00', '\x00', '\xd0', '\x03', '\x00', '\x00', '\xd1', '\x03', '\x00', '\x00', '\xce', '\x03', '\x00', '\x00', '\x63', '\x00', '\x04', '\x00', '\xcb', '\x03', '\x00', '\x00', '\xcc', '\x03', '\x00', '\x00', '\xd2', '\x03', '\x00', '\x00', '\xfd', '\x00', '\x01', '\x00', '\x38', '\x00', '\x01', '\x00', '\x36', '\x00', '\x05', '\x00', '\x02', '\x00', '\x00', '\x00', '\x0e', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x0a', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x07', '\x00', '\x00', '\x00', '\x0b', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x09', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x07', '\x00', '\x00', '\x00', '\x0d', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x0f', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x4a', '\x00', '\x00', '\x00', '\x0b', '\x00', '\x00', '\x00', '\xc3', '\x00', '\x05', '\x00', '\x06', '\x00', '\x00', '\x00', '\x4c', '\x00', '\x00', '\x00', '\x4a', '\x00', '\x00', '\x00', '\x4b', '\x00', '\x00', '\x00', '\x6f', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x4d', '\x00', '\x00', '\x00', '\x4c', '\x00', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x4f', '\x00', '\x00', '\x00', '\x4d', '\x00', '\x00', '\x00', '\x4e', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x0c', '\x00', '\x00', '\x00', '\x4f', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x50', '\x00', '\x00', '\x00', '\x0b', '\x00', '\x00', '\x00', '\xc7', '\x00', '\x05', '\x00', '\x06', '\x00', '\x00', '\x00', '\x52', '\x00', '\x00', '\x00', '\x50', '\x00', '\x00', '\x00', '\x51', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x0d', '\x00', '\x00', '\x00', '\x52', '\x00', '\x00', '\x00', '\xfd', '\x00', '\x01', '\x00', '\x38', '\x00', '\x01', '\x00', '\x36', '\x00', '\x05', '\x00', '\x13', '\x00', '\x00', '\x00', '\x16', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x14', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x12', '\x00', '\x00', '\x00', '\x15', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x17', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x59', '\x00', '\x00', '\x00', '\x5a', '\x00', '\x00', '\x00', '\x15', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x5b', '\x00', '\x00', '\x00', '\x5a', '\x00', '\x00', '\x00', '\x41', '\x00', '\x06', '\x00', '\x5e', '\x00', '\x00', '\x00', '\x5f', '\x00', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x60', '\x00', '\x00', '\x00', '\x5f', '\x00', '\x00', '\x00', '\x84', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\x61', '\x00', '\x00', '\x00', '\x5b', '\x00', '\x00', '\x00', '\x60', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x59', '\x00', '\x00', '\x00', '\x62', '\x00', '\x00', '\x00', '\x15', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x63', '\x00', '\x00', '\x00', '\x62', '\x00', '\x00', '\x00', '\x80', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\x64', '\x00', '\x00', '\x00', '\x61', '\x00', '\x00', '\x00', '\x63', '\x00', '\x00', '\x00', '\x41', '\x00', '\x06', '\x00', '\x5e', '\x00', '\x00', '\x00', '\x65', '\x00', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x66', '\x00', '\x00', '\x00', '\x65', '\x00', '\x00', '\x00', '\x84', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\x67', '\x00', '\x00', '\x00', '\x64', '\x00', '\x00', '\x00', '\x66', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x59', '\x00', '\x00', '\x00', '\x68', '\x00', '\x00', '\x00', '\x15', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x69', '\x00', '\x00', '\x00', '\x68', '\x00', '\x00', '\x00', '\x80', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\x6a', '\x00', '\x00', '\x00', '\x67', '\x00', '\x00', '\x00', '\x69', '\x00', '\x00', '\x00', '\x41', '\x00', '\x06', '\x00', '\x6b', '\x00', '\x00', '\x00', '\x6c', '\x00', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\x57', '\x00', '\x00', '\x00', '\x6a', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x13', '\x00', '\x00', '\x00', '\x6d', '\x00', '\x00', '\x00', '\x6c', '\x00', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\x6d', '\x00', '\x00', '\x00', '\x38', '\x00', '\x01', '\x00', '\x36', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1f', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x1a', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x1b', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x1d', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x1e', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x20', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x70', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x75', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x84', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x88', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x97', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x9b', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x71', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x72', '\x00', '\x00', '\x00', '\x71', '\x00', '\x00', '\x00', '\xba', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x74', '\x00', '\x00', '\x00', '\x72', '\x00', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\x77', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x74', '\x00', '\x00', '\x00', '\x76', '\x00', '\x00', '\x00', '\x7a', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x76', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x78', '\x00', '\x00', '\x00', '\x1d', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x79', '\x00', '\x00', '\x00', '\x78', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x75', '\x00', '\x00', '\x00', '\x79', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x77', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x7a', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x7b', '\x00', '\x00', '\x00', '\x1e', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7c', '\x00', '\x00', '\x00', '\x7b', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x75', '\x00', '\x00', '\x00', '\x7c', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x77', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x77', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7d', '\x00', '\x00', '\x00', '\x75', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x7e', '\x00', '\x00', '\x00', '\x1b', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7f', '\x00', '\x00', '\x00', '\x7e', '\x00', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x80', '\x00', '\x00', '\x00', '\x7d', '\x00', '\x00', '\x00', '\x7f', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x81', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x82', '\x00', '\x00', '\x00', '\x81', '\x00', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x83', '\x00', '\x00', '\x00', '\x80', '\x00', '\x00', '\x00', '\x82', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x70', '\x00', '\x00', '\x00', '\x83', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x85', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x86', '\x00', '\x00', '\x00', '\x85', '\x00', '\x00', '\x00', '\xba', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x87', '\x00', '\x00', '\x00', '\x86', '\x00', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\x8a', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x87', '\x00', '\x00', '\x00', '\x89', '\x00', '\x00', '\x00', '\x8d', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x89', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x8b', '\x00', '\x00', '\x00', '\x1d', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x8c', '\x00', '\x00', '\x00', '\x8b', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x88', '\x00', '\x00', '\x00', '\x8c', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x8a', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x8d', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x8e', '\x00', '\x00', '\x00', '\x1e', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x8f', '\x00', '\x00', '\x00', '\x8e', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x88', '\x00', '\x00', '\x00', '\x8f', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x8a', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x8a', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x90', '\x00', '\x00', '\x00', '\x88', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x91', '\x00', '\x00', '\x00', '\x1b', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x92', '\x00', '\x00', '\x00', '\x91', '\x00', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x93', '\x00', '\x00', '\x00', '\x90', '\x00', '\x00', '\x00', '\x92', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x94', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x95', '\x00', '\x00', '\x00', '\x94', '\x00', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x96', '\x00', '\x00', '\x00', '\x93', '\x00', '\x00', '\x00', '\x95', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x84', '\x00', '\x00', '\x00', '\x96', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x98', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x99', '\x00', '\x00', '\x00', '\x98', '\x00', '\x00', '\x00', '\xba', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x9a', '\x00', '\x00', '\x00', '\x99', '\x00', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\x9d', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x9a', '\x00', '\x00', '\x00', '\x9c', '\x00', '\x00', '\x00', '\xa0', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x9c', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x9e', '\x00', '\x00', '\x00', '\x1d', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x9f', '\x00', '\x00', '\x00', '\x9e', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x9b', '\x00', '\x00', '\x00', '\x9f', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x9d', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xa0', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xa1', '\x00', '\x00', '\x00', '\x1e', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xa2', '\x00', '\x00', '\x00', '\xa1', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x9b', '\x00', '\x00', '\x00', '\xa2', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x9d', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x9d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xa3', '\x00', '\x00', '\x00', '\x9b', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xa4', '\x00', '\x00', '\x00', '\x1b', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xa5', '\x00', '\x00', '\x00', '\xa4', '\x00', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xa6', '\x00', '\x00', '\x00', '\xa3', '\x00', '\x00', '\x00', '\xa5', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xa7', '\x00', '\x00', '\x00', '\x1c', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xa8', '\x00', '\x00', '\x00', '\xa7', '\x00', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xa9', '\x00', '\x00', '\x00', '\xa6', '\x00', '\x00', '\x00', '\xa8', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x97', '\x00', '\x00', '\x00', '\xa9', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xaa', '\x00', '\x00', '\x00', '\x70', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xab', '\x00', '\x00', '\x00', '\x84', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x08', '\x00', '\x00', '\x00', '\xac', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x28', '\x00', '\x00', '\x00', '\xaa', '\x00', '\x00', '\x00', '\xab', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xad', '\x00', '\x00', '\x00', '\x97', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x08', '\x00', '\x00', '\x00', '\xae', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x28', '\x00', '\x00', '\x00', '\xac', '\x00', '\x00', '\x00', '\xad', '\x00', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\xae', '\x00', '\x00', '\x00', '\x38', '\x00', '\x01', '\x00', '\x36', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x25', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x1a', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x21', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x24', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x26', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xb1', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xb5', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xc4', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xc8', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xd7', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xdb', '\x00', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xb2', '\x00', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xb3', '\x00', '\x00', '\x00', '\xb2', '\x00', '\x00', '\x00', '\xba', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\xb4', '\x00', '\x00', '\x00', '\xb3', '\x00', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\xb7', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\xb4', '\x00', '\x00', '\x00', '\xb6', '\x00', '\x00', '\x00', '\xba', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xb6', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xb8', '\x00', '\x00', '\x00', '\x24', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xb9', '\x00', '\x00', '\x00', '\xb8', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xb5', '\x00', '\x00', '\x00', '\xb9', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xb7', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xba', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xbb', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xbc', '\x00', '\x00', '\x00', '\xbb', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xb5', '\x00', '\x00', '\x00', '\xbc', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xb7', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xb7', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xbd', '\x00', '\x00', '\x00', '\xb5', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xbe', '\x00', '\x00', '\x00', '\x21', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xbf', '\x00', '\x00', '\x00', '\xbe', '\x00', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc0', '\x00', '\x00', '\x00', '\xbd', '\x00', '\x00', '\x00', '\xbf', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xc1', '\x00', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc2', '\x00', '\x00', '\x00', '\xc1', '\x00', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc3', '\x00', '\x00', '\x00', '\xc0', '\x00', '\x00', '\x00', '\xc2', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xb1', '\x00', '\x00', '\x00', '\xc3', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xc5', '\x00', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc6', '\x00', '\x00', '\x00', '\xc5', '\x00', '\x00', '\x00', '\xba', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\xc7', '\x00', '\x00', '\x00', '\xc6', '\x00', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\xca', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\xc7', '\x00', '\x00', '\x00', '\xc9', '\x00', '\x00', '\x00', '\xcd', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xc9', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xcb', '\x00', '\x00', '\x00', '\x24', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xcc', '\x00', '\x00', '\x00', '\xcb', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xc8', '\x00', '\x00', '\x00', '\xcc', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xca', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xcd', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xce', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xcf', '\x00', '\x00', '\x00', '\xce', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xc8', '\x00', '\x00', '\x00', '\xcf', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xca', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xca', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd0', '\x00', '\x00', '\x00', '\xc8', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xd1', '\x00', '\x00', '\x00', '\x21', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd2', '\x00', '\x00', '\x00', '\xd1', '\x00', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd3', '\x00', '\x00', '\x00', '\xd0', '\x00', '\x00', '\x00', '\xd2', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xd4', '\x00', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd5', '\x00', '\x00', '\x00', '\xd4', '\x00', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd6', '\x00', '\x00', '\x00', '\xd3', '\x00', '\x00', '\x00', '\xd5', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xc4', '\x00', '\x00', '\x00', '\xd6', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xd8', '\x00', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd9', '\x00', '\x00', '\x00', '\xd8', '\x00', '\x00', '\x00', '\xba', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\xda', '\x00', '\x00', '\x00', '\xd9', '\x00', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\xdd', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\xda', '\x00', '\x00', '\x00', '\xdc', '\x00', '\x00', '\x00', '\xe0', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xdc', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xde', '\x00', '\x00', '\x00', '\x24', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xdf', '\x00', '\x00', '\x00', '\xde', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xdb', '\x00', '\x00', '\x00', '\xdf', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xdd', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xe0', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xe1', '\x00', '\x00', '\x00', '\x23', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe2', '\x00', '\x00', '\x00', '\xe1', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xdb', '\x00', '\x00', '\x00', '\xe2', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xdd', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xdd', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe3', '\x00', '\x00', '\x00', '\xdb', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xe4', '\x00', '\x00', '\x00', '\x21', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe5', '\x00', '\x00', '\x00', '\xe4', '\x00', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe6', '\x00', '\x00', '\x00', '\xe3', '\x00', '\x00', '\x00', '\xe5', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xe7', '\x00', '\x00', '\x00', '\x22', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe8', '\x00', '\x00', '\x00', '\xe7', '\x00', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe9', '\x00', '\x00', '\x00', '\xe6', '\x00', '\x00', '\x00', '\xe8', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xd7', '\x00', '\x00', '\x00', '\xe9', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xea', '\x00', '\x00', '\x00', '\xb1', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xeb', '\x00', '\x00', '\x00', '\xc4', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x08', '\x00', '\x00', '\x00', '\xec', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x25', '\x00', '\x00', '\x00', '\xea', '\x00', '\x00', '\x00', '\xeb', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xed', '\x00', '\x00', '\x00', '\xd7', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x08', '\x00', '\x00', '\x00', '\xee', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x25', '\x00', '\x00', '\x00', '\xec', '\x00', '\x00', '\x00', '\xed', '\x00', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\xee', '\x00', '\x00', '\x00', '\x38', '\x00', '\x01', '\x00', '\x36', '\x00', '\x05', '\x00', '\x02', '\x00', '\x00', '\x00', '\x32', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x2f', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x2b', '\x00', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x2e', '\x00', '\x00', '\x00', '\x31', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x33', '\x00', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\xf1', '\x00', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf2', '\x00', '\x00', '\x00', '\xf1', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xf3', '\x00', '\x00', '\x00', '\x31', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xf3', '\x00', '\x00', '\x00', '\xf2', '\x00', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\xf5', '\x00', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf6', '\x00', '\x00', '\x00', '\xf5', '\x00', '\x00', '\x00', '\x7f', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x00', '\x00', '\xf6', '\x00', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xfb', '\x00', '\x00', '\x00', '\x31', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xfb', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\xfd', '\x00', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xfe', '\x00', '\x00', '\x00', '\xfd', '\x00', '\x00', '\x00', '\x7f', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xff', '\x00', '\x00', '\x00', '\xfe', '\x00', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x01', '\x01', '\x00', '\x00', '\x00', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x02', '\x01', '\x00', '\x00', '\xff', '\x00', '\x00', '\x00', '\x01', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x03', '\x01', '\x00', '\x00', '\x31', '\x00', '\x00', '\x00', '\xfc', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x03', '\x01', '\x00', '\x00', '\x02', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x05', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x06', '\x01', '\x00', '\x00', '\x05', '\x01', '\x00', '\x00', '\x7f', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x07', '\x01', '\x00', '\x00', '\x06', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x08', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x09', '\x01', '\x00', '\x00', '\x08', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x0a', '\x01', '\x00', '\x00', '\x07', '\x01', '\x00', '\x00', '\x09', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x0b', '\x01', '\x00', '\x00', '\x31', '\x00', '\x00', '\x00', '\x04', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x0b', '\x01', '\x00', '\x00', '\x0a', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x0c', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x0d', '\x01', '\x00', '\x00', '\x0c', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x0e', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x0f', '\x01', '\x00', '\x00', '\x0e', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x10', '\x01', '\x00', '\x00', '\x0d', '\x01', '\x00', '\x00', '\x0f', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x11', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x12', '\x01', '\x00', '\x00', '\x11', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x13', '\x01', '\x00', '\x00', '\x10', '\x01', '\x00', '\x00', '\x12', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x14', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x15', '\x01', '\x00', '\x00', '\x14', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x16', '\x01', '\x00', '\x00', '\x13', '\x01', '\x00', '\x00', '\x15', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x17', '\x01', '\x00', '\x00', '\x31', '\x00', '\x00', '\x00', '\x57', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x17', '\x01', '\x00', '\x00', '\x16', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x19', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1a', '\x01', '\x00', '\x00', '\x19', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x1b', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1c', '\x01', '\x00', '\x00', '\x1b', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1d', '\x01', '\x00', '\x00', '\x1a', '\x01', '\x00', '\x00', '\x1c', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x1e', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1f', '\x01', '\x00', '\x00', '\x1e', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x20', '\x01', '\x00', '\x00', '\x1d', '\x01', '\x00', '\x00', '\x1f', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x21', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x22', '\x01', '\x00', '\x00', '\x21', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x23', '\x01', '\x00', '\x00', '\x20', '\x01', '\x00', '\x00', '\x22', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x24', '\x01', '\x00', '\x00', '\x31', '\x00', '\x00', '\x00', '\x18', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x24', '\x01', '\x00', '\x00', '\x23', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x26', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x27', '\x01', '\x00', '\x00', '\x26', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x28', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x29', '\x01', '\x00', '\x00', '\x28', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x2a', '\x01', '\x00', '\x00', '\x27', '\x01', '\x00', '\x00', '\x29', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x2b', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x2c', '\x01', '\x00', '\x00', '\x2b', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x2d', '\x01', '\x00', '\x00', '\x2a', '\x01', '\x00', '\x00', '\x2c', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x2e', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x2f', '\x01', '\x00', '\x00', '\x2e', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x30', '\x01', '\x00', '\x00', '\x2d', '\x01', '\x00', '\x00', '\x2f', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x31', '\x01', '\x00', '\x00', '\x31', '\x00', '\x00', '\x00', '\x25', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x31', '\x01', '\x00', '\x00', '\x30', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x33', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x34', '\x01', '\x00', '\x00', '\x33', '\x01', '\x00', '\x00', '\x7f', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x35', '\x01', '\x00', '\x00', '\x34', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x36', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x37', '\x01', '\x00', '\x00', '\x36', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x38', '\x01', '\x00', '\x00', '\x35', '\x01', '\x00', '\x00', '\x37', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x39', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x3a', '\x01', '\x00', '\x00', '\x39', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x3b', '\x01', '\x00', '\x00', '\x38', '\x01', '\x00', '\x00', '\x3a', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x3c', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x3d', '\x01', '\x00', '\x00', '\x3c', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x3e', '\x01', '\x00', '\x00', '\x3b', '\x01', '\x00', '\x00', '\x3d', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x3f', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x40', '\x01', '\x00', '\x00', '\x3f', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x41', '\x01', '\x00', '\x00', '\x3e', '\x01', '\x00', '\x00', '\x40', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x42', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x43', '\x01', '\x00', '\x00', '\x42', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x44', '\x01', '\x00', '\x00', '\x41', '\x01', '\x00', '\x00', '\x43', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x45', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x46', '\x01', '\x00', '\x00', '\x45', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x47', '\x01', '\x00', '\x00', '\x44', '\x01', '\x00', '\x00', '\x46', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x48', '\x01', '\x00', '\x00', '\x30', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x49', '\x01', '\x00', '\x00', '\x48', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x4a', '\x01', '\x00', '\x00', '\x47', '\x01', '\x00', '\x00', '\x49', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x4b', '\x01', '\x00', '\x00', '\x31', '\x00', '\x00', '\x00', '\x32', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x4b', '\x01', '\x00', '\x00', '\x4a', '\x01', '\x00', '\x00', '\xfd', '\x00', '\x01', '\x00', '\x38', '\x00', '\x01', '\x00', '\x36', '\x00', '\x05', '\x00', '\x11', '\x00', '\x00', '\x00', '\x36', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x34', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x35', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x37', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x12', '\x00', '\x00', '\x00', '\x4c', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x4d', '\x01', '\x00', '\x00', '\x35', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x4e', '\x01', '\x00', '\x00', '\x4f', '\x01', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\xfc', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x50', '\x01', '\x00', '\x00', '\x4f', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\x51', '\x01', '\x00', '\x00', '\x4d', '\x01', '\x00', '\x00', '\x50', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x53', '\x01', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x54', '\x01', '\x00', '\x00', '\x53', '\x01', '\x00', '\x00', '\x50', '\x00', '\x06', '\x00', '\x18', '\x00', '\x00', '\x00', '\x55', '\x01', '\x00', '\x00', '\x54', '\x01', '\x00', '\x00', '\x54', '\x01', '\x00', '\x00', '\x54', '\x01', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\x56', '\x01', '\x00', '\x00', '\x51', '\x01', '\x00', '\x00', '\x55', '\x01', '\x00', '\x00', '\x6d', '\x00', '\x04', '\x00', '\x11', '\x00', '\x00', '\x00', '\x57', '\x01', '\x00', '\x00', '\x56', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x4c', '\x01', '\x00', '\x00', '\x57', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x59', '\x00', '\x00', '\x00', '\x58', '\x01', '\x00', '\x00', '\x4c', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x59', '\x01', '\x00', '\x00', '\x58', '\x01', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x10', '\x00', '\x00', '\x00', '\x5a', '\x01', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x29', '\x00', '\x00', '\x00', '\x59', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x41', '\x00', '\x06', '\x00', '\x5e', '\x00', '\x00', '\x00', '\x5b', '\x01', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x5c', '\x01', '\x00', '\x00', '\x5b', '\x01', '\x00', '\x00', '\x82', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\x5d', '\x01', '\x00', '\x00', '\x5c', '\x01', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x10', '\x00', '\x00', '\x00', '\x5e', '\x01', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x26', '\x00', '\x00', '\x00', '\x5a', '\x01', '\x00', '\x00', '\x5d', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x59', '\x00', '\x00', '\x00', '\x5f', '\x01', '\x00', '\x00', '\x4c', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x5f', '\x01', '\x00', '\x00', '\x5e', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x59', '\x00', '\x00', '\x00', '\x60', '\x01', '\x00', '\x00', '\x4c', '\x01', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x61', '\x01', '\x00', '\x00', '\x60', '\x01', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x10', '\x00', '\x00', '\x00', '\x62', '\x01', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x29', '\x00', '\x00', '\x00', '\x61', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x41', '\x00', '\x06', '\x00', '\x5e', '\x00', '\x00', '\x00', '\x63', '\x01', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x64', '\x01', '\x00', '\x00', '\x63', '\x01', '\x00', '\x00', '\x82', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\x65', '\x01', '\x00', '\x00', '\x64', '\x01', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x10', '\x00', '\x00', '\x00', '\x66', '\x01', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x26', '\x00', '\x00', '\x00', '\x62', '\x01', '\x00', '\x00', '\x65', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x59', '\x00', '\x00', '\x00', '\x67', '\x01', '\x00', '\x00', '\x4c', '\x01', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x67', '\x01', '\x00', '\x00', '\x66', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x59', '\x00', '\x00', '\x00', '\x68', '\x01', '\x00', '\x00', '\x4c', '\x01', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x69', '\x01', '\x00', '\x00', '\x68', '\x01', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x10', '\x00', '\x00', '\x00', '\x6a', '\x01', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x29', '\x00', '\x00', '\x00', '\x69', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x41', '\x00', '\x06', '\x00', '\x5e', '\x00', '\x00', '\x00', '\x6b', '\x01', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x6c', '\x01', '\x00', '\x00', '\x6b', '\x01', '\x00', '\x00', '\x82', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\x6d', '\x01', '\x00', '\x00', '\x6c', '\x01', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x10', '\x00', '\x00', '\x00', '\x6e', '\x01', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x26', '\x00', '\x00', '\x00', '\x6a', '\x01', '\x00', '\x00', '\x6d', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x59', '\x00', '\x00', '\x00', '\x6f', '\x01', '\x00', '\x00', '\x4c', '\x01', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x6f', '\x01', '\x00', '\x00', '\x6e', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x11', '\x00', '\x00', '\x00', '\x70', '\x01', '\x00', '\x00', '\x4c', '\x01', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\x70', '\x01', '\x00', '\x00', '\x38', '\x00', '\x01', '\x00', '\x36', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x3a', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x39', '\x00', '\x00', '\x00', '\x3c', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x3e', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x12', '\x00', '\x00', '\x00', '\x74', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\x75', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x59', '\x00', '\x00', '\x00', '\x84', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x59', '\x00', '\x00', '\x00', '\x8c', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x59', '\x00', '\x00', '\x00', '\x94', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x12', '\x00', '\x00', '\x00', '\xa2', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x2b', '\x00', '\x00', '\x00', '\xa4', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x07', '\x00', '\x00', '\x00', '\xa8', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x07', '\x00', '\x00', '\x00', '\xa9', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xab', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x07', '\x00', '\x00', '\x00', '\xac', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x2e', '\x00', '\x00', '\x00', '\xbc', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x2b', '\x00', '\x00', '\x00', '\xbd', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x2e', '\x00', '\x00', '\x00', '\xbf', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xc2', '\x01', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x3c', '\x00', '\x00', '\x00', '\x73', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x76', '\x01', '\x00', '\x00', '\x3b', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x75', '\x01', '\x00', '\x00', '\x76', '\x01', '\x00', '\x00', '\x39', '\x00', '\x05', '\x00', '\x11', '\x00', '\x00', '\x00', '\x77', '\x01', '\x00', '\x00', '\x36', '\x00', '\x00', '\x00', '\x75', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x74', '\x01', '\x00', '\x00', '\x77', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x79', '\x01', '\x00', '\x00', '\x3b', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x4e', '\x01', '\x00', '\x00', '\x7a', '\x01', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\xfc', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x7b', '\x01', '\x00', '\x00', '\x7a', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\x7c', '\x01', '\x00', '\x00', '\x79', '\x01', '\x00', '\x00', '\x7b', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x7d', '\x01', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7e', '\x01', '\x00', '\x00', '\x7d', '\x01', '\x00', '\x00', '\x50', '\x00', '\x06', '\x00', '\x18', '\x00', '\x00', '\x00', '\x7f', '\x01', '\x00', '\x00', '\x7e', '\x01', '\x00', '\x00', '\x7e', '\x01', '\x00', '\x00', '\x7e', '\x01', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\x80', '\x01', '\x00', '\x00', '\x7c', '\x01', '\x00', '\x00', '\x7f', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x11', '\x00', '\x00', '\x00', '\x81', '\x01', '\x00', '\x00', '\x74', '\x01', '\x00', '\x00', '\x70', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x82', '\x01', '\x00', '\x00', '\x81', '\x01', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\x83', '\x01', '\x00', '\x00', '\x80', '\x01', '\x00', '\x00', '\x82', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x78', '\x01', '\x00', '\x00', '\x83', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x84', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x85', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x85', '\x01', '\x00', '\x00', '\xf6', '\x00', '\x04', '\x00', '\x87', '\x01', '\x00', '\x00', '\x88', '\x01', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x89', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x89', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x8a', '\x01', '\x00', '\x00', '\x84', '\x01', '\x00', '\x00', '\xb0', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x8b', '\x01', '\x00', '\x00', '\x8a', '\x01', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x8b', '\x01', '\x00', '\x00', '\x86', '\x01', '\x00', '\x00', '\x87', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x86', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x8c', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x8d', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x8d', '\x01', '\x00', '\x00', '\xf6', '\x00', '\x04', '\x00', '\x8f', '\x01', '\x00', '\x00', '\x90', '\x01', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x91', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x91', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x92', '\x01', '\x00', '\x00', '\x8c', '\x01', '\x00', '\x00', '\xb0', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x93', '\x01', '\x00', '\x00', '\x92', '\x01', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x93', '\x01', '\x00', '\x00', '\x8e', '\x01', '\x00', '\x00', '\x8f', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x8e', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x94', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x95', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x95', '\x01', '\x00', '\x00', '\xf6', '\x00', '\x04', '\x00', '\x97', '\x01', '\x00', '\x00', '\x98', '\x01', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x99', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x99', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x9a', '\x01', '\x00', '\x00', '\x94', '\x01', '\x00', '\x00', '\xb0', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x9b', '\x01', '\x00', '\x00', '\x9a', '\x01', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x9b', '\x01', '\x00', '\x00', '\x96', '\x01', '\x00', '\x00', '\x97', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x96', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x11', '\x00', '\x00', '\x00', '\x9c', '\x01', '\x00', '\x00', '\x74', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x9d', '\x01', '\x00', '\x00', '\x84', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x9e', '\x01', '\x00', '\x00', '\x8c', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x9f', '\x01', '\x00', '\x00', '\x94', '\x01', '\x00', '\x00', '\x50', '\x00', '\x06', '\x00', '\x11', '\x00', '\x00', '\x00', '\xa0', '\x01', '\x00', '\x00', '\x9d', '\x01', '\x00', '\x00', '\x9e', '\x01', '\x00', '\x00', '\x9f', '\x01', '\x00', '\x00', '\x80', '\x00', '\x05', '\x00', '\x11', '\x00', '\x00', '\x00', '\xa1', '\x01', '\x00', '\x00', '\x9c', '\x01', '\x00', '\x00', '\xa0', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa2', '\x01', '\x00', '\x00', '\xa1', '\x01', '\x00', '\x00', '\x39', '\x00', '\x05', '\x00', '\x13', '\x00', '\x00', '\x00', '\xa3', '\x01', '\x00', '\x00', '\x16', '\x00', '\x00', '\x00', '\xa2', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\xa5', '\x01', '\x00', '\x00', '\x84', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\xa6', '\x01', '\x00', '\x00', '\x8c', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\xa7', '\x01', '\x00', '\x00', '\x94', '\x01', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x06', '\x00', '\x00', '\x00', '\xaa', '\x01', '\x00', '\x00', '\xa3', '\x01', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa9', '\x01', '\x00', '\x00', '\xaa', '\x01', '\x00', '\x00', '\x39', '\x00', '\x07', '\x00', '\x02', '\x00', '\x00', '\x00', '\xad', '\x01', '\x00', '\x00', '\x0e', '\x00', '\x00', '\x00', '\xa9', '\x01', '\x00', '\x00', '\xab', '\x01', '\x00', '\x00', '\xac', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xae', '\x01', '\x00', '\x00', '\xab', '\x01', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\xaf', '\x01', '\x00', '\x00', '\xa4', '\x01', '\x00', '\x00', '\xa5', '\x01', '\x00', '\x00', '\xa6', '\x01', '\x00', '\x00', '\xa7', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xaf', '\x01', '\x00', '\x00', '\xae', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\xb0', '\x01', '\x00', '\x00', '\xac', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa8', '\x01', '\x00', '\x00', '\xb0', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\xb1', '\x01', '\x00', '\x00', '\xa8', '\x01', '\x00', '\x00', '\xaa', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\xb2', '\x01', '\x00', '\x00', '\xb1', '\x01', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\xb4', '\x01', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\xb2', '\x01', '\x00', '\x00', '\xb3', '\x01', '\x00', '\x00', '\xb4', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xb3', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x3c', '\x00', '\x00', '\x00', '\xb5', '\x01', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xb4', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xb4', '\x01', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x98', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x98', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\xb6', '\x01', '\x00', '\x00', '\x94', '\x01', '\x00', '\x00', '\x80', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\xb7', '\x01', '\x00', '\x00', '\xb6', '\x01', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x94', '\x01', '\x00', '\x00', '\xb7', '\x01', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x95', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x97', '\x01', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x90', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x90', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\xb8', '\x01', '\x00', '\x00', '\x8c', '\x01', '\x00', '\x00', '\x80', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\xb9', '\x01', '\x00', '\x00', '\xb8', '\x01', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x8c', '\x01', '\x00', '\x00', '\xb9', '\x01', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x8d', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x8f', '\x01', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x88', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x88', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\xba', '\x01', '\x00', '\x00', '\x84', '\x01', '\x00', '\x00', '\x80', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\xbb', '\x01', '\x00', '\x00', '\xba', '\x01', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x84', '\x01', '\x00', '\x00', '\xbb', '\x01', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x85', '\x01', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x87', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x2a', '\x00', '\x00', '\x00', '\xbe', '\x01', '\x00', '\x00', '\xa4', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xbd', '\x01', '\x00', '\x00', '\xbe', '\x01', '\x00', '\x00', '\x39', '\x00', '\x06', '\x00', '\x02', '\x00', '\x00', '\x00', '\xc0', '\x01', '\x00', '\x00', '\x32', '\x00', '\x00', '\x00', '\xbd', '\x01', '\x00', '\x00', '\xbf', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x2d', '\x00', '\x00', '\x00', '\xc1', '\x01', '\x00', '\x00', '\xbf', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xbc', '\x01', '\x00', '\x00', '\xc1', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xc3', '\x01', '\x00', '\x00', '\xbc', '\x01', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc4', '\x01', '\x00', '\x00', '\xc3', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xc5', '\x01', '\x00', '\x00', '\xbc', '\x01', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc6', '\x01', '\x00', '\x00', '\xc5', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xc7', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc8', '\x01', '\x00', '\x00', '\xc7', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc9', '\x01', '\x00', '\x00', '\xc6', '\x01', '\x00', '\x00', '\xc8', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xca', '\x01', '\x00', '\x00', '\xc4', '\x01', '\x00', '\x00', '\xc9', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xcb', '\x01', '\x00', '\x00', '\xbc', '\x01', '\x00', '\x00', '\xfc', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xcc', '\x01', '\x00', '\x00', '\xcb', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xcd', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xce', '\x01', '\x00', '\x00', '\xcd', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xcf', '\x01', '\x00', '\x00', '\xcc', '\x01', '\x00', '\x00', '\xce', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd0', '\x01', '\x00', '\x00', '\xca', '\x01', '\x00', '\x00', '\xcf', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xd1', '\x01', '\x00', '\x00', '\xbc', '\x01', '\x00', '\x00', '\x04', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd2', '\x01', '\x00', '\x00', '\xd1', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xd3', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd4', '\x01', '\x00', '\x00', '\xd3', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd5', '\x01', '\x00', '\x00', '\xd2', '\x01', '\x00', '\x00', '\xd4', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd6', '\x01', '\x00', '\x00', '\xd0', '\x01', '\x00', '\x00', '\xd5', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xd7', '\x01', '\x00', '\x00', '\xbc', '\x01', '\x00', '\x00', '\x57', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd8', '\x01', '\x00', '\x00', '\xd7', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xd9', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xda', '\x01', '\x00', '\x00', '\xd9', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xdb', '\x01', '\x00', '\x00', '\xd8', '\x01', '\x00', '\x00', '\xda', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xdc', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xdd', '\x01', '\x00', '\x00', '\xdc', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xde', '\x01', '\x00', '\x00', '\xdb', '\x01', '\x00', '\x00', '\xdd', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xdf', '\x01', '\x00', '\x00', '\xd6', '\x01', '\x00', '\x00', '\xde', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xe0', '\x01', '\x00', '\x00', '\xbc', '\x01', '\x00', '\x00', '\x18', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe1', '\x01', '\x00', '\x00', '\xe0', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xe2', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe3', '\x01', '\x00', '\x00', '\xe2', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe4', '\x01', '\x00', '\x00', '\xe1', '\x01', '\x00', '\x00', '\xe3', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xe5', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe6', '\x01', '\x00', '\x00', '\xe5', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe7', '\x01', '\x00', '\x00', '\xe4', '\x01', '\x00', '\x00', '\xe6', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe8', '\x01', '\x00', '\x00', '\xdf', '\x01', '\x00', '\x00', '\xe7', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xe9', '\x01', '\x00', '\x00', '\xbc', '\x01', '\x00', '\x00', '\x25', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xea', '\x01', '\x00', '\x00', '\xe9', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xeb', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xec', '\x01', '\x00', '\x00', '\xeb', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xed', '\x01', '\x00', '\x00', '\xea', '\x01', '\x00', '\x00', '\xec', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xee', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xef', '\x01', '\x00', '\x00', '\xee', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf0', '\x01', '\x00', '\x00', '\xed', '\x01', '\x00', '\x00', '\xef', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf1', '\x01', '\x00', '\x00', '\xe8', '\x01', '\x00', '\x00', '\xf0', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xf2', '\x01', '\x00', '\x00', '\xbc', '\x01', '\x00', '\x00', '\x32', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf3', '\x01', '\x00', '\x00', '\xf2', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xf4', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf5', '\x01', '\x00', '\x00', '\xf4', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf6', '\x01', '\x00', '\x00', '\xf3', '\x01', '\x00', '\x00', '\xf5', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xf7', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf8', '\x01', '\x00', '\x00', '\xf7', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf9', '\x01', '\x00', '\x00', '\xf6', '\x01', '\x00', '\x00', '\xf8', '\x01', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xfa', '\x01', '\x00', '\x00', '\x78', '\x01', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xfb', '\x01', '\x00', '\x00', '\xfa', '\x01', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xfc', '\x01', '\x00', '\x00', '\xf9', '\x01', '\x00', '\x00', '\xfb', '\x01', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xfd', '\x01', '\x00', '\x00', '\xf1', '\x01', '\x00', '\x00', '\xfc', '\x01', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xc2', '\x01', '\x00', '\x00', '\xfd', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xfe', '\x01', '\x00', '\x00', '\xc2', '\x01', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\xfe', '\x01', '\x00', '\x00', '\x38', '\x00', '\x01', '\x00', '\x36', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\x41', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x3f', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x40', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x42', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x12', '\x00', '\x00', '\x00', '\x01', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\x02', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x59', '\x00', '\x00', '\x00', '\x11', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x59', '\x00', '\x00', '\x00', '\x19', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x59', '\x00', '\x00', '\x00', '\x21', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x12', '\x00', '\x00', '\x00', '\x2f', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x2b', '\x00', '\x00', '\x00', '\x31', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x07', '\x00', '\x00', '\x00', '\x35', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x07', '\x00', '\x00', '\x00', '\x36', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x38', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x07', '\x00', '\x00', '\x00', '\x39', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x2e', '\x00', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x2b', '\x00', '\x00', '\x00', '\x45', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x2e', '\x00', '\x00', '\x00', '\x47', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\x4a', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x03', '\x02', '\x00', '\x00', '\x40', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x02', '\x02', '\x00', '\x00', '\x03', '\x02', '\x00', '\x00', '\x39', '\x00', '\x05', '\x00', '\x11', '\x00', '\x00', '\x00', '\x04', '\x02', '\x00', '\x00', '\x36', '\x00', '\x00', '\x00', '\x02', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x01', '\x02', '\x00', '\x00', '\x04', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x06', '\x02', '\x00', '\x00', '\x40', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x4e', '\x01', '\x00', '\x00', '\x07', '\x02', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\xfc', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x08', '\x02', '\x00', '\x00', '\x07', '\x02', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\x09', '\x02', '\x00', '\x00', '\x06', '\x02', '\x00', '\x00', '\x08', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x0a', '\x02', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x0b', '\x02', '\x00', '\x00', '\x0a', '\x02', '\x00', '\x00', '\x50', '\x00', '\x06', '\x00', '\x18', '\x00', '\x00', '\x00', '\x0c', '\x02', '\x00', '\x00', '\x0b', '\x02', '\x00', '\x00', '\x0b', '\x02', '\x00', '\x00', '\x0b', '\x02', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\x0d', '\x02', '\x00', '\x00', '\x09', '\x02', '\x00', '\x00', '\x0c', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x11', '\x00', '\x00', '\x00', '\x0e', '\x02', '\x00', '\x00', '\x01', '\x02', '\x00', '\x00', '\x70', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x0f', '\x02', '\x00', '\x00', '\x0e', '\x02', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\x10', '\x02', '\x00', '\x00', '\x0d', '\x02', '\x00', '\x00', '\x0f', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x05', '\x02', '\x00', '\x00', '\x10', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x11', '\x02', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x12', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x12', '\x02', '\x00', '\x00', '\xf6', '\x00', '\x04', '\x00', '\x14', '\x02', '\x00', '\x00', '\x15', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x16', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x16', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x17', '\x02', '\x00', '\x00', '\x11', '\x02', '\x00', '\x00', '\xb0', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x18', '\x02', '\x00', '\x00', '\x17', '\x02', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x18', '\x02', '\x00', '\x00', '\x13', '\x02', '\x00', '\x00', '\x14', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x13', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x19', '\x02', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x1a', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x1a', '\x02', '\x00', '\x00', '\xf6', '\x00', '\x04', '\x00', '\x1c', '\x02', '\x00', '\x00', '\x1d', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x1e', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x1e', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x1f', '\x02', '\x00', '\x00', '\x19', '\x02', '\x00', '\x00', '\xb0', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x20', '\x02', '\x00', '\x00', '\x1f', '\x02', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x20', '\x02', '\x00', '\x00', '\x1b', '\x02', '\x00', '\x00', '\x1c', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x1b', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x21', '\x02', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x22', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x22', '\x02', '\x00', '\x00', '\xf6', '\x00', '\x04', '\x00', '\x24', '\x02', '\x00', '\x00', '\x25', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x26', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x26', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x27', '\x02', '\x00', '\x00', '\x21', '\x02', '\x00', '\x00', '\xb0', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x28', '\x02', '\x00', '\x00', '\x27', '\x02', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x28', '\x02', '\x00', '\x00', '\x23', '\x02', '\x00', '\x00', '\x24', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x23', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x11', '\x00', '\x00', '\x00', '\x29', '\x02', '\x00', '\x00', '\x01', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x2a', '\x02', '\x00', '\x00', '\x11', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x2b', '\x02', '\x00', '\x00', '\x19', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x2c', '\x02', '\x00', '\x00', '\x21', '\x02', '\x00', '\x00', '\x50', '\x00', '\x06', '\x00', '\x11', '\x00', '\x00', '\x00', '\x2d', '\x02', '\x00', '\x00', '\x2a', '\x02', '\x00', '\x00', '\x2b', '\x02', '\x00', '\x00', '\x2c', '\x02', '\x00', '\x00', '\x80', '\x00', '\x05', '\x00', '\x11', '\x00', '\x00', '\x00', '\x2e', '\x02', '\x00', '\x00', '\x29', '\x02', '\x00', '\x00', '\x2d', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x2f', '\x02', '\x00', '\x00', '\x2e', '\x02', '\x00', '\x00', '\x39', '\x00', '\x05', '\x00', '\x13', '\x00', '\x00', '\x00', '\x30', '\x02', '\x00', '\x00', '\x16', '\x00', '\x00', '\x00', '\x2f', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x32', '\x02', '\x00', '\x00', '\x11', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x33', '\x02', '\x00', '\x00', '\x19', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x34', '\x02', '\x00', '\x00', '\x21', '\x02', '\x00', '\x00', '\x51', '\x00', '\x05', '\x00', '\x06', '\x00', '\x00', '\x00', '\x37', '\x02', '\x00', '\x00', '\x30', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x36', '\x02', '\x00', '\x00', '\x37', '\x02', '\x00', '\x00', '\x39', '\x00', '\x07', '\x00', '\x02', '\x00', '\x00', '\x00', '\x3a', '\x02', '\x00', '\x00', '\x0e', '\x00', '\x00', '\x00', '\x36', '\x02', '\x00', '\x00', '\x38', '\x02', '\x00', '\x00', '\x39', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x3b', '\x02', '\x00', '\x00', '\x38', '\x02', '\x00', '\x00', '\x41', '\x00', '\x07', '\x00', '\x09', '\x00', '\x00', '\x00', '\x3c', '\x02', '\x00', '\x00', '\x31', '\x02', '\x00', '\x00', '\x32', '\x02', '\x00', '\x00', '\x33', '\x02', '\x00', '\x00', '\x34', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x3c', '\x02', '\x00', '\x00', '\x3b', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x06', '\x00', '\x00', '\x00', '\x3d', '\x02', '\x00', '\x00', '\x39', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x35', '\x02', '\x00', '\x00', '\x3d', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x25', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x25', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x3e', '\x02', '\x00', '\x00', '\x21', '\x02', '\x00', '\x00', '\x80', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\x3f', '\x02', '\x00', '\x00', '\x3e', '\x02', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x21', '\x02', '\x00', '\x00', '\x3f', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x22', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x24', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x1d', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x1d', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x40', '\x02', '\x00', '\x00', '\x19', '\x02', '\x00', '\x00', '\x80', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\x41', '\x02', '\x00', '\x00', '\x40', '\x02', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x19', '\x02', '\x00', '\x00', '\x41', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x1a', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x1c', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x15', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x15', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x10', '\x00', '\x00', '\x00', '\x42', '\x02', '\x00', '\x00', '\x11', '\x02', '\x00', '\x00', '\x80', '\x00', '\x05', '\x00', '\x10', '\x00', '\x00', '\x00', '\x43', '\x02', '\x00', '\x00', '\x42', '\x02', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x11', '\x02', '\x00', '\x00', '\x43', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x12', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x14', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x2a', '\x00', '\x00', '\x00', '\x46', '\x02', '\x00', '\x00', '\x31', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x45', '\x02', '\x00', '\x00', '\x46', '\x02', '\x00', '\x00', '\x39', '\x00', '\x06', '\x00', '\x02', '\x00', '\x00', '\x00', '\x48', '\x02', '\x00', '\x00', '\x32', '\x00', '\x00', '\x00', '\x45', '\x02', '\x00', '\x00', '\x47', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x2d', '\x00', '\x00', '\x00', '\x49', '\x02', '\x00', '\x00', '\x47', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x44', '\x02', '\x00', '\x00', '\x49', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x4b', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x4c', '\x02', '\x00', '\x00', '\x4b', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x4d', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x57', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x4e', '\x02', '\x00', '\x00', '\x4d', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x4f', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x50', '\x02', '\x00', '\x00', '\x4f', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x51', '\x02', '\x00', '\x00', '\x4e', '\x02', '\x00', '\x00', '\x50', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x52', '\x02', '\x00', '\x00', '\x4c', '\x02', '\x00', '\x00', '\x51', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x53', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x18', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x54', '\x02', '\x00', '\x00', '\x53', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x55', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x56', '\x02', '\x00', '\x00', '\x55', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x57', '\x02', '\x00', '\x00', '\x54', '\x02', '\x00', '\x00', '\x56', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x58', '\x02', '\x00', '\x00', '\x52', '\x02', '\x00', '\x00', '\x57', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x59', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x32', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x5a', '\x02', '\x00', '\x00', '\x59', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x5b', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x5c', '\x02', '\x00', '\x00', '\x5b', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x5d', '\x02', '\x00', '\x00', '\x5a', '\x02', '\x00', '\x00', '\x5c', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x5e', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x5f', '\x02', '\x00', '\x00', '\x5e', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x60', '\x02', '\x00', '\x00', '\x5d', '\x02', '\x00', '\x00', '\x5f', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x61', '\x02', '\x00', '\x00', '\x58', '\x02', '\x00', '\x00', '\x60', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x62', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\xfc', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x63', '\x02', '\x00', '\x00', '\x62', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x64', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x57', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x65', '\x02', '\x00', '\x00', '\x64', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x66', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x67', '\x02', '\x00', '\x00', '\x66', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x68', '\x02', '\x00', '\x00', '\x65', '\x02', '\x00', '\x00', '\x67', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x69', '\x02', '\x00', '\x00', '\x63', '\x02', '\x00', '\x00', '\x68', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x6a', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x25', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x6b', '\x02', '\x00', '\x00', '\x6a', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x6c', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x6d', '\x02', '\x00', '\x00', '\x6c', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x6e', '\x02', '\x00', '\x00', '\x6b', '\x02', '\x00', '\x00', '\x6d', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x6f', '\x02', '\x00', '\x00', '\x69', '\x02', '\x00', '\x00', '\x6e', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x70', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x32', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x71', '\x02', '\x00', '\x00', '\x70', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x72', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x73', '\x02', '\x00', '\x00', '\x72', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x74', '\x02', '\x00', '\x00', '\x71', '\x02', '\x00', '\x00', '\x73', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x75', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x76', '\x02', '\x00', '\x00', '\x75', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x77', '\x02', '\x00', '\x00', '\x74', '\x02', '\x00', '\x00', '\x76', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x78', '\x02', '\x00', '\x00', '\x6f', '\x02', '\x00', '\x00', '\x77', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x79', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x04', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7a', '\x02', '\x00', '\x00', '\x79', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x7b', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x18', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7c', '\x02', '\x00', '\x00', '\x7b', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x7d', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7e', '\x02', '\x00', '\x00', '\x7d', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x7f', '\x02', '\x00', '\x00', '\x7c', '\x02', '\x00', '\x00', '\x7e', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x80', '\x02', '\x00', '\x00', '\x7a', '\x02', '\x00', '\x00', '\x7f', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x81', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x25', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x82', '\x02', '\x00', '\x00', '\x81', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x83', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x84', '\x02', '\x00', '\x00', '\x83', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x85', '\x02', '\x00', '\x00', '\x82', '\x02', '\x00', '\x00', '\x84', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x86', '\x02', '\x00', '\x00', '\x80', '\x02', '\x00', '\x00', '\x85', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x87', '\x02', '\x00', '\x00', '\x44', '\x02', '\x00', '\x00', '\x32', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x88', '\x02', '\x00', '\x00', '\x87', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x89', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x8a', '\x02', '\x00', '\x00', '\x89', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x8b', '\x02', '\x00', '\x00', '\x88', '\x02', '\x00', '\x00', '\x8a', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x8c', '\x02', '\x00', '\x00', '\x05', '\x02', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x8d', '\x02', '\x00', '\x00', '\x8c', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x8e', '\x02', '\x00', '\x00', '\x8b', '\x02', '\x00', '\x00', '\x8d', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x8f', '\x02', '\x00', '\x00', '\x86', '\x02', '\x00', '\x00', '\x8e', '\x02', '\x00', '\x00', '\x50', '\x00', '\x06', '\x00', '\x18', '\x00', '\x00', '\x00', '\x90', '\x02', '\x00', '\x00', '\x61', '\x02', '\x00', '\x00', '\x78', '\x02', '\x00', '\x00', '\x8f', '\x02', '\x00', '\x00', '\x0c', '\x00', '\x06', '\x00', '\x18', '\x00', '\x00', '\x00', '\x91', '\x02', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x90', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x4a', '\x02', '\x00', '\x00', '\x91', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\x92', '\x02', '\x00', '\x00', '\x4a', '\x02', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\x92', '\x02', '\x00', '\x00', '\x38', '\x00', '\x01', '\x00', '\x36', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x48', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\x43', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x44', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x19', '\x00', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x09', '\x00', '\x00', '\x00', '\x46', '\x00', '\x00', '\x00', '\x37', '\x00', '\x03', '\x00', '\x09', '\x00', '\x00', '\x00', '\x47', '\x00', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x49', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x98', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xa4', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xaf', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xb7', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xba', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xc7', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xc8', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xca', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xcc', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xce', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xd4', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xd5', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xd7', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xd9', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xdb', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xeb', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xed', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\xee', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x39', '\x00', '\x00', '\x00', '\xf7', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x19', '\x00', '\x00', '\x00', '\xfd', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x39', '\x00', '\x00', '\x00', '\xfe', '\x02', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x2f', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x3b', '\x00', '\x04', '\x00', '\x09', '\x00', '\x00', '\x00', '\x40', '\x03', '\x00', '\x00', '\x07', '\x00', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x95', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x96', '\x02', '\x00', '\x00', '\x95', '\x02', '\x00', '\x00', '\xb4', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x97', '\x02', '\x00', '\x00', '\x96', '\x02', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\x9a', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x97', '\x02', '\x00', '\x00', '\x99', '\x02', '\x00', '\x00', '\x9c', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x99', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x98', '\x02', '\x00', '\x00', '\x9b', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x9a', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x9c', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\x9d', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x9e', '\x02', '\x00', '\x00', '\x9d', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x98', '\x02', '\x00', '\x00', '\x9e', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\x9a', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x9a', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x9f', '\x02', '\x00', '\x00', '\x98', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xa0', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x58', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa0', '\x02', '\x00', '\x00', '\x9f', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xa1', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xa2', '\x02', '\x00', '\x00', '\xa1', '\x02', '\x00', '\x00', '\xb4', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\xa3', '\x02', '\x00', '\x00', '\xa2', '\x02', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\xa6', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\xa3', '\x02', '\x00', '\x00', '\xa5', '\x02', '\x00', '\x00', '\xa7', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xa5', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa4', '\x02', '\x00', '\x00', '\x9b', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xa6', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xa7', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xa8', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xa9', '\x02', '\x00', '\x00', '\xa8', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xa4', '\x02', '\x00', '\x00', '\xa9', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xa6', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xa6', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xaa', '\x02', '\x00', '\x00', '\xa4', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xab', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xab', '\x02', '\x00', '\x00', '\xaa', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xac', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xad', '\x02', '\x00', '\x00', '\xac', '\x02', '\x00', '\x00', '\xb4', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\xae', '\x02', '\x00', '\x00', '\xad', '\x02', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\xb1', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\xae', '\x02', '\x00', '\x00', '\xb0', '\x02', '\x00', '\x00', '\xb2', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xb0', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xaf', '\x02', '\x00', '\x00', '\x9b', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xb1', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xb2', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xb3', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xb4', '\x02', '\x00', '\x00', '\xb3', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xaf', '\x02', '\x00', '\x00', '\xb4', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xb1', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xb1', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xb5', '\x02', '\x00', '\x00', '\xaf', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x09', '\x00', '\x00', '\x00', '\xb6', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x27', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xb6', '\x02', '\x00', '\x00', '\xb5', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x4e', '\x01', '\x00', '\x00', '\xb8', '\x02', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\xfc', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xb9', '\x02', '\x00', '\x00', '\xb8', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xb7', '\x02', '\x00', '\x00', '\xb9', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x4e', '\x01', '\x00', '\x00', '\xbb', '\x02', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\xfc', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xbc', '\x02', '\x00', '\x00', '\xbb', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\xbd', '\x02', '\x00', '\x00', '\xbe', '\x02', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\x5c', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x11', '\x00', '\x00', '\x00', '\xbf', '\x02', '\x00', '\x00', '\xbe', '\x02', '\x00', '\x00', '\x50', '\x00', '\x06', '\x00', '\x11', '\x00', '\x00', '\x00', '\xc0', '\x02', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x5d', '\x00', '\x00', '\x00', '\x82', '\x00', '\x05', '\x00', '\x11', '\x00', '\x00', '\x00', '\xc1', '\x02', '\x00', '\x00', '\xbf', '\x02', '\x00', '\x00', '\xc0', '\x02', '\x00', '\x00', '\x70', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xc2', '\x02', '\x00', '\x00', '\xc1', '\x02', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\xc3', '\x02', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\xf4', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xc4', '\x02', '\x00', '\x00', '\xc3', '\x02', '\x00', '\x00', '\x8e', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\xc5', '\x02', '\x00', '\x00', '\xc2', '\x02', '\x00', '\x00', '\xc4', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\xc6', '\x02', '\x00', '\x00', '\xbc', '\x02', '\x00', '\x00', '\xc5', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xba', '\x02', '\x00', '\x00', '\xc6', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xc9', '\x02', '\x00', '\x00', '\x44', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xc8', '\x02', '\x00', '\x00', '\xc9', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xcb', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xca', '\x02', '\x00', '\x00', '\xcb', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xcd', '\x02', '\x00', '\x00', '\xb7', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xcc', '\x02', '\x00', '\x00', '\xcd', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xcf', '\x02', '\x00', '\x00', '\xba', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xce', '\x02', '\x00', '\x00', '\xcf', '\x02', '\x00', '\x00', '\x39', '\x00', '\x08', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd0', '\x02', '\x00', '\x00', '\x1f', '\x00', '\x00', '\x00', '\xc8', '\x02', '\x00', '\x00', '\xca', '\x02', '\x00', '\x00', '\xcc', '\x02', '\x00', '\x00', '\xce', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xc7', '\x02', '\x00', '\x00', '\xd0', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd1', '\x02', '\x00', '\x00', '\xc7', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd2', '\x02', '\x00', '\x00', '\x46', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x08', '\x00', '\x00', '\x00', '\xd3', '\x02', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x28', '\x00', '\x00', '\x00', '\xd1', '\x02', '\x00', '\x00', '\xd2', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xc7', '\x02', '\x00', '\x00', '\xd3', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xd6', '\x02', '\x00', '\x00', '\x44', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xd5', '\x02', '\x00', '\x00', '\xd6', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xd8', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xd7', '\x02', '\x00', '\x00', '\xd8', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xda', '\x02', '\x00', '\x00', '\xb7', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xd9', '\x02', '\x00', '\x00', '\xda', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xdc', '\x02', '\x00', '\x00', '\xba', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xdb', '\x02', '\x00', '\x00', '\xdc', '\x02', '\x00', '\x00', '\x39', '\x00', '\x08', '\x00', '\x08', '\x00', '\x00', '\x00', '\xdd', '\x02', '\x00', '\x00', '\x25', '\x00', '\x00', '\x00', '\xd5', '\x02', '\x00', '\x00', '\xd7', '\x02', '\x00', '\x00', '\xd9', '\x02', '\x00', '\x00', '\xdb', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xd4', '\x02', '\x00', '\x00', '\xdd', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xde', '\x02', '\x00', '\x00', '\xd4', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xdf', '\x02', '\x00', '\x00', '\x47', '\x00', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe0', '\x02', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x25', '\x00', '\x00', '\x00', '\xde', '\x02', '\x00', '\x00', '\xdf', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xd4', '\x02', '\x00', '\x00', '\xe0', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe1', '\x02', '\x00', '\x00', '\xc7', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe2', '\x02', '\x00', '\x00', '\xd4', '\x02', '\x00', '\x00', '\xbe', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\xe3', '\x02', '\x00', '\x00', '\xe1', '\x02', '\x00', '\x00', '\xe2', '\x02', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\xe5', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\xe3', '\x02', '\x00', '\x00', '\xe4', '\x02', '\x00', '\x00', '\xe5', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xe4', '\x02', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\xe6', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xe5', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xe9', '\x02', '\x00', '\x00', '\xc7', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\xea', '\x02', '\x00', '\x00', '\xe9', '\x02', '\x00', '\x00', '\x9b', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xe8', '\x02', '\x00', '\x00', '\xea', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xeb', '\x02', '\x00', '\x00', '\xec', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xed', '\x02', '\x00', '\x00', '\xec', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xee', '\x02', '\x00', '\x00', '\xec', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xef', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xef', '\x02', '\x00', '\x00', '\xf6', '\x00', '\x04', '\x00', '\xf1', '\x02', '\x00', '\x00', '\xf2', '\x02', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xf3', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xf3', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf4', '\x02', '\x00', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xf5', '\x02', '\x00', '\x00', '\xd4', '\x02', '\x00', '\x00', '\xb8', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\xf6', '\x02', '\x00', '\x00', '\xf4', '\x02', '\x00', '\x00', '\xf5', '\x02', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\xf6', '\x02', '\x00', '\x00', '\xf0', '\x02', '\x00', '\x00', '\xf1', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xf0', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xf7', '\x02', '\x00', '\x00', '\x73', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xf8', '\x02', '\x00', '\x00', '\x44', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x18', '\x00', '\x00', '\x00', '\xf9', '\x02', '\x00', '\x00', '\x45', '\x00', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\xfa', '\x02', '\x00', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x8e', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\xfb', '\x02', '\x00', '\x00', '\xf9', '\x02', '\x00', '\x00', '\xfa', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x18', '\x00', '\x00', '\x00', '\xfc', '\x02', '\x00', '\x00', '\xf8', '\x02', '\x00', '\x00', '\xfb', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xfd', '\x02', '\x00', '\x00', '\xfc', '\x02', '\x00', '\x00', '\x39', '\x00', '\x06', '\x00', '\x08', '\x00', '\x00', '\x00', '\xff', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x00', '\x00', '\xfd', '\x02', '\x00', '\x00', '\xfe', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x38', '\x00', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\xfe', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xf7', '\x02', '\x00', '\x00', '\x00', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xed', '\x02', '\x00', '\x00', '\xff', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x38', '\x00', '\x00', '\x00', '\x01', '\x03', '\x00', '\x00', '\xf7', '\x02', '\x00', '\x00', '\xa8', '\x00', '\x04', '\x00', '\x38', '\x00', '\x00', '\x00', '\x02', '\x03', '\x00', '\x00', '\x01', '\x03', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\x04', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x02', '\x03', '\x00', '\x00', '\x03', '\x03', '\x00', '\x00', '\x0d', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x03', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x05', '\x03', '\x00', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xeb', '\x02', '\x00', '\x00', '\x05', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x06', '\x03', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\x04', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x07', '\x03', '\x00', '\x00', '\x06', '\x03', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x09', '\x03', '\x00', '\x00', '\x07', '\x03', '\x00', '\x00', '\x08', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x0a', '\x03', '\x00', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x0b', '\x03', '\x00', '\x00', '\x0a', '\x03', '\x00', '\x00', '\x09', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x0b', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xee', '\x02', '\x00', '\x00', '\xec', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xf2', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x0d', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x0e', '\x03', '\x00', '\x00', '\xed', '\x02', '\x00', '\x00', '\xba', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x0f', '\x03', '\x00', '\x00', '\x0e', '\x03', '\x00', '\x00', '\x9b', '\x02', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\x11', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x0f', '\x03', '\x00', '\x00', '\x10', '\x03', '\x00', '\x00', '\x25', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x10', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x12', '\x03', '\x00', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xeb', '\x02', '\x00', '\x00', '\x12', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x19', '\x03', '\x00', '\x00', '\x17', '\x03', '\x00', '\x00', '\x18', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1a', '\x03', '\x00', '\x00', '\x19', '\x03', '\x00', '\x00', '\x41', '\x00', '\x05', '\x00', '\x52', '\x01', '\x00', '\x00', '\x1b', '\x03', '\x00', '\x00', '\x56', '\x00', '\x00', '\x00', '\x04', '\x01', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1c', '\x03', '\x00', '\x00', '\x1b', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1d', '\x03', '\x00', '\x00', '\xed', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1e', '\x03', '\x00', '\x00', '\x1c', '\x03', '\x00', '\x00', '\x1d', '\x03', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x1f', '\x03', '\x00', '\x00', '\x1e', '\x03', '\x00', '\x00', '\x08', '\x03', '\x00', '\x00', '\x0c', '\x00', '\x07', '\x00', '\x08', '\x00', '\x00', '\x00', '\x20', '\x03', '\x00', '\x00', '\x01', '\x00', '\x00', '\x00', '\x28', '\x00', '\x00', '\x00', '\x1a', '\x03', '\x00', '\x00', '\x1f', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x21', '\x03', '\x00', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x22', '\x03', '\x00', '\x00', '\x21', '\x03', '\x00', '\x00', '\x20', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x22', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x23', '\x03', '\x00', '\x00', '\xed', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\xee', '\x02', '\x00', '\x00', '\x23', '\x03', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xf2', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x25', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x26', '\x03', '\x00', '\x00', '\xed', '\x02', '\x00', '\x00', '\xb8', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x28', '\x03', '\x00', '\x00', '\x26', '\x03', '\x00', '\x00', '\x27', '\x03', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\x2a', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x28', '\x03', '\x00', '\x00', '\x29', '\x03', '\x00', '\x00', '\x3f', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x29', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x2b', '\x03', '\x00', '\x00', '\xee', '\x02', '\x00', '\x00', '\xba', '\x00', '\x05', '\x00', '\x38', '\x00', '\x00', '\x00', '\x2c', '\x03', '\x00', '\x00', '\x2b', '\x03', '\x00', '\x00', '\x73', '\x00', '\x00', '\x00', '\xf7', '\x00', '\x03', '\x00', '\x2e', '\x03', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xfa', '\x00', '\x04', '\x00', '\x2c', '\x03', '\x00', '\x00', '\x2d', '\x03', '\x00', '\x00', '\x3d', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x2d', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x30', '\x03', '\x00', '\x00', '\xeb', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x31', '\x03', '\x00', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x32', '\x03', '\x00', '\x00', '\xeb', '\x02', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x33', '\x03', '\x00', '\x00', '\x31', '\x03', '\x00', '\x00', '\x32', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x34', '\x03', '\x00', '\x00', '\xee', '\x02', '\x00', '\x00', '\x85', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x35', '\x03', '\x00', '\x00', '\x33', '\x03', '\x00', '\x00', '\x34', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x36', '\x03', '\x00', '\x00', '\xee', '\x02', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x37', '\x03', '\x00', '\x00', '\xed', '\x02', '\x00', '\x00', '\x83', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x38', '\x03', '\x00', '\x00', '\x36', '\x03', '\x00', '\x00', '\x37', '\x03', '\x00', '\x00', '\x88', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x39', '\x03', '\x00', '\x00', '\x35', '\x03', '\x00', '\x00', '\x38', '\x03', '\x00', '\x00', '\x81', '\x00', '\x05', '\x00', '\x08', '\x00', '\x00', '\x00', '\x3a', '\x03', '\x00', '\x00', '\x30', '\x03', '\x00', '\x00', '\x39', '\x03', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x2f', '\x03', '\x00', '\x00', '\x3a', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x3b', '\x03', '\x00', '\x00', '\x2f', '\x03', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\x3b', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x3d', '\x03', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\xe6', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x2e', '\x03', '\x00', '\x00', '\xff', '\x00', '\x01', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x3f', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x41', '\x03', '\x00', '\x00', '\xe8', '\x02', '\x00', '\x00', '\x3e', '\x00', '\x03', '\x00', '\x40', '\x03', '\x00', '\x00', '\x41', '\x03', '\x00', '\x00', '\x3d', '\x00', '\x04', '\x00', '\x08', '\x00', '\x00', '\x00', '\x42', '\x03', '\x00', '\x00', '\x40', '\x03', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\x42', '\x03', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x2a', '\x03', '\x00', '\x00', '\xff', '\x00', '\x01', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x11', '\x03', '\x00', '\x00', '\xff', '\x00', '\x01', '\x00', '\xf8', '\x00', '\x02', '\x00', '\x04', '\x03', '\x00', '\x00', '\xff', '\x00', '\x01', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xf2', '\x02', '\x00', '\x00', '\xf9', '\x00', '\x02', '\x00', '\xef', '\x02', '\x00', '\x00', '\xf8', '\x00', '\x02', '\x00', '\xf1', '\x02', '\x00', '\x00', '\xfe', '\x00', '\x02', '\x00', '\xe6', '\x02', '\x00', '\x00', '\x38', '\x00', '\x01', '\x00' };
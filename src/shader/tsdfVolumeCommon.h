@@ -23,9 +23,199 @@ void unpackColor(in int packedColor, out vec4 color) {
 	color = unpackUnorm4x8(uint(packedColor));
 }
 
-/** @brief	Helper function to read a voxel.
+/** @brief	Page table of the TSDF volume storage buffer.
+  *
+  * Each page has a flag. Bit 0 indicates the page is backed by device memory.
+  * Bit 1 indicates the page has been appended to the request list.
+  */
+layout(set = 0, binding = 1) buffer TSDFPageTable {
+	uint headerSizeInVoxels;
+	uint voxelsPerPage;
+	uint flags[];
+} tsdfPageTable;
+
+/** @brief	Pages requested by fusion. The host binds memory for them between frames.
+  */
+layout(set = 0, binding = 2) buffer TSDFPageRequests {
+	uint numRequests;
+	uint pages[];
+} tsdfPageRequests;
+
+const uint TSDF_PAGE_RESIDENT = 1;
+const uint TSDF_PAGE_REQUESTED = 2;
+
+/** @brief	Whether the volume is sparse. It is specialized to false for dense volumes,
+  *			whose pages are all resident, so that the page table is never read.
+  */
+layout(constant_id = 0) const bool TSDF_SPARSE_VOLUME = true;
+
+/** @brief	Modified flags of bricks. A brick is a block of `TSDF_BRICK_SIZE`^3 cells,
+  *			where cell (x, y, z) is the cube between voxels (x, y, z) and (x+1, y+1, z+1).
+  *
+  * A flag is set when the brick is appended to the modified list, and cleared by the
+  * consumer of the list (e.g. `meshBricks.comp`).
+  */
+layout(set = 0, binding = 3) buffer TSDFBrickFlags {
+	uint flags[];
+} tsdfBrickFlags;
+
+/** @brief	Bricks whose surface may have been changed by fusion. The host takes the list between frames.
+  */
+layout(set = 0, binding = 4) buffer TSDFModifiedBricks {
+	uint numModifiedBricks;
+	uint bricks[];
+} tsdfModifiedBricks;
+
+const uint TSDF_BRICK_SIZE = 8;
+
+/** @brief	Indirection table of the color bricks. A color brick holds the colors of
+  *			`TSDF_BRICK_SIZE`^3 voxels, and is allocated by fusion when it first writes a color in it.
+  *
+  * An entry is 0 if the color brick is not allocated, `TSDF_COLOR_BRICK_LOCKED` while it is
+  * being allocated, `TSDF_COLOR_BRICK_DROPPED` if the pool was full, and the slot of the color
+  * brick in the pool plus 1 otherwise.
+  */
+layout(set = 0, binding = 5) buffer TSDFColorBrickTable {
+	uint numRequestedBricks;
+	uint capacity;
+	uint entries[];
+} tsdfColorBrickTable;
+
+/** @brief	Pool of color bricks. Each color is packed with `packColor`.
+  *			Voxels that have not been colored yet are 0, i.e. have zero alpha.
+  */
+layout(set = 0, binding = 6) buffer TSDFColorBricks {
+	uint colors[];
+} tsdfColorBricks;
+
+const uint TSDF_COLOR_BRICK_LOCKED = 0xFFFFFFFF;
+const uint TSDF_COLOR_BRICK_DROPPED = 0xFFFFFFFE;
+
+/** @brief	Helper function to compute the linear index of a voxel.
+  */
+uint voxelLinearIndex(uvec3 index) {
+	return (index.x * tsdfVolume.resolution.y + index.y) * tsdfVolume.resolution.z + index.z;
+}
+
+/** @brief	Helper function to compute the page that contains a voxel.
+  */
+uint voxelPage(uint voxelIndex) {
+	return (voxelIndex + tsdfPageTable.headerSizeInVoxels) / tsdfPageTable.voxelsPerPage;
+}
+
+/** @brief	Helper function to check whether a voxel is backed by device memory.
+  */
+bool voxelResident(uint voxelIndex) {
+	if (!TSDF_SPARSE_VOLUME)
+		return true;
+	return (tsdfPageTable.flags[voxelPage(voxelIndex)] & TSDF_PAGE_RESIDENT) != 0;
+}
+
+/** @brief	Helper function to request the page that contains a non-resident voxel.
+  *
+  * Each page is appended to the request list at most once.
+  */
+void requestVoxelPage(uint voxelIndex) {
+	uint page = voxelPage(voxelIndex);
+	uint oldFlags = atomicOr(tsdfPageTable.flags[page], TSDF_PAGE_REQUESTED);
+	if ((oldFlags & (TSDF_PAGE_RESIDENT | TSDF_PAGE_REQUESTED)) == 0)
+		tsdfPageRequests.pages[atomicAdd(tsdfPageRequests.numRequests, 1)] = page;
+}
+
+/** @brief	Helper function to compute the number of bricks along the x/y/z axis.
+  */
+uvec3 brickResolution() {
+	return (tsdfVolume.resolution + (TSDF_BRICK_SIZE - 2)) / TSDF_BRICK_SIZE;
+}
+
+/** @brief	Helper function to compute the linear index of a brick.
+  */
+uint brickLinearIndex(uvec3 brick) {
+	uvec3 resolution = brickResolution();
+	return (brick.x * resolution.y + brick.y) * resolution.z + brick.z;
+}
+
+/** @brief	Helper function to append the bricks affected by a modified voxel to the modified list.
+  *
+  * A voxel is a corner of the cells in [index-1, index]. A surface quad is generated by the
+  * cell at the far end of its edge and uses the vertices of the 3 cells before it, so the
+  * quads of the cells in [index-1, index+1] may change. Each brick is appended at most once.
+  */
+void markVoxelModified(uvec3 index) {
+	uvec3 numCells = tsdfVolume.resolution - 1;
+	uvec3 minBrick = (max(index, uvec3(1)) - 1) / TSDF_BRICK_SIZE;
+	uvec3 maxBrick = min(index + 1, numCells - 1) / TSDF_BRICK_SIZE;
+	for (uint x = minBrick.x; x <= maxBrick.x; ++x)
+		for (uint y = minBrick.y; y <= maxBrick.y; ++y)
+			for (uint z = minBrick.z; z <= maxBrick.z; ++z) {
+				uint brick = brickLinearIndex(uvec3(x, y, z));
+				if (tsdfBrickFlags.flags[brick] == 0 && atomicExchange(tsdfBrickFlags.flags[brick], 1) == 0)
+					tsdfModifiedBricks.bricks[atomicAdd(tsdfModifiedBricks.numModifiedBricks, 1)] = brick;
+			}
+}
+
+/** @brief	Helper function to read a voxel. Non-resident voxels have zero weight.
   * @note	It's the caller's reponsibility to make sure `index` is within valid range.
   */
-ivec2 readVoxelData(uvec3 index) {
-	return tsdfVolume.data[(index.x *  tsdfVolume.resolution.y + index.y) * tsdfVolume.resolution.z + index.z];
+int readVoxelData(uvec3 index) {
+	uint voxelIndex = voxelLinearIndex(index);
+	if (!voxelResident(voxelIndex))
+		return 0;
+	return tsdfVolume.data[voxelIndex];
+}
+
+/** @brief	Helper function to compute the linear index of the color brick that contains a voxel.
+  */
+uint colorBrickLinearIndex(uvec3 index) {
+	uvec3 resolution = (tsdfVolume.resolution + (TSDF_BRICK_SIZE - 1)) / TSDF_BRICK_SIZE;
+	uvec3 brick = index / TSDF_BRICK_SIZE;
+	return (brick.x * resolution.y + brick.y) * resolution.z + brick.z;
+}
+
+/** @brief	Helper function to compute the position of a voxel's color in a color brick slot.
+  */
+uint colorBrickOffset(uint slot, uvec3 index) {
+	uvec3 local = index % TSDF_BRICK_SIZE;
+	return slot * (TSDF_BRICK_SIZE * TSDF_BRICK_SIZE * TSDF_BRICK_SIZE) + (local.x * TSDF_BRICK_SIZE + local.y) * TSDF_BRICK_SIZE + local.z;
+}
+
+/** @brief	Helper function to read the color of a voxel. Voxels without colors are opaque black.
+  * @note	It's the caller's reponsibility to make sure `index` is within valid range.
+  */
+vec4 readVoxelColor(uvec3 index) {
+	uint entry = tsdfColorBrickTable.entries[colorBrickLinearIndex(index)];
+	if (entry == 0 || entry >= TSDF_COLOR_BRICK_DROPPED)
+		return vec4(0.0, 0.0, 0.0, 1.0);
+	vec4 color;
+	unpackColor(int(tsdfColorBricks.colors[colorBrickOffset(entry - 1, index)]), color);
+	return (color.a == 0.0) ? vec4(0.0, 0.0, 0.0, 1.0) : color;
+}
+
+/** @brief	Helper function to find the color of a voxel for writing, allocating its color brick if needed.
+  *
+  * Only the invocation that locks an unallocated entry allocates the color brick. The other
+  * invocations that write colors in the same color brick meanwhile skip them, so the colors of a
+  * few voxels miss one frame instead of waiting for the lock.
+  * @param	offset	The position of the color in `tsdfColorBricks.colors`.
+  * @return	false if the color brick is being allocated or was dropped because the pool was full.
+  */
+bool acquireVoxelColor(uvec3 index, out uint offset) {
+	offset = 0;
+	uint brick = colorBrickLinearIndex(index);
+	uint entry = tsdfColorBrickTable.entries[brick];
+	if (entry == 0) {
+		if (atomicCompSwap(tsdfColorBrickTable.entries[brick], 0, TSDF_COLOR_BRICK_LOCKED) != 0)
+			return false;
+		uint slot = atomicAdd(tsdfColorBrickTable.numRequestedBricks, 1);
+		if (slot >= tsdfColorBrickTable.capacity) {
+			atomicExchange(tsdfColorBrickTable.entries[brick], TSDF_COLOR_BRICK_DROPPED);
+			return false;
+		}
+		entry = slot + 1;
+		atomicExchange(tsdfColorBrickTable.entries[brick], entry);
+	}
+	if (entry >= TSDF_COLOR_BRICK_DROPPED)
+		return false;
+	offset = colorBrickOffset(entry - 1, index);
+	return true;
 }
\ No newline at end of file
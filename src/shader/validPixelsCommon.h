@@ -0,0 +1,100 @@
+/***********************************************************************
+ * @file	validPixelsCommon.h
+ * @author	jjyou
+ * @date	2024-6-2
+ * @brief	This file declares the buffers of `ValidPixelsDescriptorSet`
+ *			and the helper functions to read or append to the compacted
+ *			list of valid pixels of a pyramid level.
+ *
+ *			Define `VALID_PIXELS_INPUT_SET` before including this file to
+ *			read a list, and `VALID_PIXELS_OUTPUT_SET` to append to one.
+ *			Shaders dispatched indirectly over a list must have a local
+ *			size of `validPixelsWorkGroupSize` along x.
+***********************************************************************/
+
+/** @brief	Local size of the shaders dispatched over a list of valid pixels.
+  *			It sizes the indirect dispatch arguments in `ValidPixelsCounter`.
+  */
+const uint validPixelsWorkGroupSize = 1024;
+
+#ifdef VALID_PIXELS_INPUT_SET
+
+/** @brief	Row-major indices of the valid pixels to read.
+  */
+layout(set = VALID_PIXELS_INPUT_SET, binding = 1) readonly buffer InputValidPixels {
+	uint data[];
+} inputValidPixels;
+
+/** @brief	Number of valid pixels to read.
+  */
+layout(set = VALID_PIXELS_INPUT_SET, binding = 2) readonly buffer InputValidPixelsCounter {
+	uint numValidPixels;
+	uint numWorkGroups[3];
+} inputValidPixelsCounter;
+
+/** @brief	Get the position of the valid pixel of the current invocation.
+  * @return	False if the invocation is beyond the end of the list,
+  *			which may happen in the last work group.
+  */
+bool inputValidPixel(ivec2 size, out ivec2 pixelPos) {
+	if (gl_GlobalInvocationID.x >= inputValidPixelsCounter.numValidPixels)
+		return false;
+	uint pixelIndex = inputValidPixels.data[gl_GlobalInvocationID.x];
+	pixelPos = ivec2(pixelIndex % uint(size.x), pixelIndex / uint(size.x));
+	return true;
+}
+
+#endif
+
+#ifdef VALID_PIXELS_OUTPUT_SET
+
+/** @brief	Validity bitmask. Bit `i % 32` of word `i / 32` is set if pixel `i` is valid.
+  */
+layout(set = VALID_PIXELS_OUTPUT_SET, binding = 0) buffer OutputValidityMask {
+	uint data[];
+} outputValidityMask;
+
+/** @brief	Row-major indices of valid pixels.
+  */
+layout(set = VALID_PIXELS_OUTPUT_SET, binding = 1) buffer OutputValidPixels {
+	uint data[];
+} outputValidPixels;
+
+/** @brief	Number of valid pixels and the indirect dispatch arguments.
+  */
+layout(set = VALID_PIXELS_OUTPUT_SET, binding = 2) buffer OutputValidPixelsCounter {
+	uint numValidPixels;
+	uint numWorkGroups[3];
+} outputValidPixelsCounter;
+
+shared uint validPixelsLocalCount;
+shared uint validPixelsLocalOffset;
+
+/** @brief	Append the pixel of the current invocation to the list if it is valid.
+  *
+  *			All invocations of the work group must call this function, since it
+  *			contains barriers. Each work group reserves its range of the list with
+  *			a single global atomic. The bitmask and the counter must be zeroed
+  *			before dispatch.
+  */
+void appendValidPixel(bool valid, uint pixelIndex) {
+	if (gl_LocalInvocationIndex == 0)
+		validPixelsLocalCount = 0;
+	barrier();
+	uint localIndex = 0;
+	if (valid) {
+		atomicOr(outputValidityMask.data[pixelIndex / 32], 1u << (pixelIndex % 32));
+		localIndex = atomicAdd(validPixelsLocalCount, 1);
+	}
+	barrier();
+	if (gl_LocalInvocationIndex == 0 && validPixelsLocalCount != 0) {
+		validPixelsLocalOffset = atomicAdd(outputValidPixelsCounter.numValidPixels, validPixelsLocalCount);
+		uint numValidPixels = validPixelsLocalOffset + validPixelsLocalCount;
+		atomicMax(outputValidPixelsCounter.numWorkGroups[0], (numValidPixels + validPixelsWorkGroupSize - 1) / validPixelsWorkGroupSize);
+	}
+	barrier();
+	if (valid)
+		outputValidPixels.data[validPixelsLocalOffset + localIndex] = pixelIndex;
+}
+
+#endif
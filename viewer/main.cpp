@@ -0,0 +1,172 @@
+/***********************************************************************
+ * @file	main.cpp
+ * @brief	KinectFusion-Viewer, a standalone viewer of the map published
+ *			by KinectFusion-Vulkan with `--map-stream`.
+ *
+ *			The viewer reads the latest version of the map stream every
+ *			frame without blocking the publisher, and reconnects when
+ *			the publisher restarts. It either draws the received mesh and
+ *			the camera pose with a free scene camera, or the thumbnail
+ *			ray casted from the camera pose.
+***********************************************************************/
+
+#include "Engine.hpp"
+#include "MapStream.hpp"
+#include <backends/imgui_impl_glfw.h>
+#include <backends/imgui_impl_vulkan.h>
+#include <argparse/argparse.hpp>
+#include <memory>
+#include <array>
+#include <vector>
+#include <unordered_set>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+
+int main(int argc, char** argv) {
+	// Parse arguments.
+	argparse::ArgumentParser argumentParser("KinectFusion-Viewer", "1.0");
+	argumentParser
+		.add_argument("--map-stream")
+		.help("The name of the map stream, as passed to KinectFusion-Vulkan.")
+		.default_value("kinectfusion");
+	argumentParser.add_argument("--debug")
+		.help("Enable debug mode.")
+		.flag();
+	argumentParser.parse_args(argc, argv);
+	std::string name = argumentParser.get<std::string>("--map-stream");
+
+	// Create Vulkan engine and assets.
+	Engine engine(false, argumentParser.get<bool>("--debug"));
+	Primitives<MaterialType::Simple, PrimitiveType::Line> axis = engine.createPrimitives<MaterialType::Simple, PrimitiveType::Line>(MemoryPattern::Static);
+	{
+		std::array<Vertex<MaterialType::Simple>, 6> axisData = { {
+			Vertex<MaterialType::Simple>{.position{0.0f, 0.0f, 0.0f}, .color{255, 0, 0, 255} },
+			Vertex<MaterialType::Simple>{.position{1.0f, 0.0f, 0.0f}, .color{255, 0, 0, 255} },
+			Vertex<MaterialType::Simple>{.position{0.0f, 0.0f, 0.0f}, .color{0, 255, 0, 255} },
+			Vertex<MaterialType::Simple>{.position{0.0f, 1.0f, 0.0f}, .color{0, 255, 0, 255} },
+			Vertex<MaterialType::Simple>{.position{0.0f, 0.0f, 0.0f}, .color{0, 0, 255, 255} },
+			Vertex<MaterialType::Simple>{.position{0.0f, 0.0f, 1.0f}, .color{0, 0, 255, 255} },
+		} };
+		axis.setVertexData(axisData, false);
+	}
+	// The mesh and the thumbnail are updated while the previous frames may still be drawn, so each frame in flight has its own copy.
+	// A copy is either re-uploaded entirely when the mesh grows or the subscriber changes, or patched with the slabs changed since it was last drawn.
+	std::vector<Primitives<MaterialType::Lambertian, PrimitiveType::Triangle>> meshes{};
+	std::vector<Surface<MaterialType::Simple>> thumbnails{};
+	for (std::uint32_t i = 0; i < Engine::NUM_FRAMES_IN_FLIGHT; ++i) {
+		meshes.push_back(engine.createPrimitives<MaterialType::Lambertian, PrimitiveType::Triangle>(MemoryPattern::Dynamic));
+		thumbnails.push_back(engine.createSurface<MaterialType::Simple>());
+	}
+	std::array<bool, Engine::NUM_FRAMES_IN_FLIGHT> meshOutdated{};
+	std::array<std::unordered_set<std::uint32_t>, Engine::NUM_FRAMES_IN_FLIGHT> outdatedSlabs{};
+	std::array<bool, Engine::NUM_FRAMES_IN_FLIGHT> thumbnailOutdated{};
+	std::vector<float> thumbnailDepth{};
+
+	// Main loop
+	std::unique_ptr<MapSubscriber> pSubscriber{};
+	std::chrono::steady_clock::time_point lastConnectionAttempt{};
+	std::uint32_t resourceCycleCounter = 0U;
+	bool displayThumbnail = false;
+	auto disconnect = [&]() {
+		pSubscriber.reset();
+		meshOutdated.fill(true);
+		for (std::unordered_set<std::uint32_t>& slabs : outdatedSlabs)
+			slabs.clear();
+	};
+	while (!engine.window().windowShouldClose()) {
+		if (engine.prepareFrame() != vk::Result::eSuccess)
+			continue;
+
+		// Connect to the publisher, and reconnect when it restarts.
+		if (pSubscriber && pSubscriber->closed())
+			disconnect();
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (!pSubscriber && now - lastConnectionAttempt > std::chrono::seconds(1)) {
+			lastConnectionAttempt = now;
+			try {
+				pSubscriber.reset(new MapSubscriber(name));
+			}
+			catch (const std::runtime_error&) {}
+		}
+
+		// Apply the latest version. A corrupted version drops the subscriber, which is recreated by the reconnection above.
+		if (pSubscriber) {
+			try {
+				if (pSubscriber->update()) {
+					for (std::unordered_set<std::uint32_t>& slabs : outdatedSlabs)
+						slabs.insert(pSubscriber->changedSlabs().begin(), pSubscriber->changedSlabs().end());
+					thumbnailOutdated.fill(true);
+				}
+			}
+			catch (const std::runtime_error&) {
+				disconnect();
+				lastConnectionAttempt = now;
+			}
+		}
+		const std::vector<Vertex<MaterialType::Lambertian>>* pMesh = pSubscriber ? &pSubscriber->mesh() : nullptr;
+		bool hasMesh = pMesh && !pMesh->empty();
+		if (hasMesh) {
+			Primitives<MaterialType::Lambertian, PrimitiveType::Triangle>& frameMesh = meshes[resourceCycleCounter];
+			if (meshOutdated[resourceCycleCounter] || frameMesh.numVertices() != pMesh->size()) {
+				frameMesh.setVertexData(*pMesh, false);
+			}
+			else {
+				for (std::uint32_t slab : outdatedSlabs[resourceCycleCounter]) {
+					std::uint32_t firstVertex = slab * MapStream::MAX_VERTICES_PER_BRICK;
+					frameMesh.updateVertexData(firstVertex, pMesh->data() + firstVertex, MapStream::MAX_VERTICES_PER_BRICK);
+				}
+			}
+			meshOutdated[resourceCycleCounter] = false;
+			outdatedSlabs[resourceCycleCounter].clear();
+		}
+		std::optional<MapStream::FrameHeader> header = pSubscriber ? pSubscriber->header() : std::nullopt;
+		bool hasThumbnail = header.has_value() && header->camera.width != 0U;
+		if (hasThumbnail && thumbnailOutdated[resourceCycleCounter]) {
+			thumbnailOutdated[resourceCycleCounter] = false;
+			vk::Extent2D extent(header->camera.width, header->camera.height);
+			thumbnailDepth.assign(static_cast<std::size_t>(extent.width) * extent.height, header->camera.zNear);
+			thumbnails[resourceCycleCounter].createTextures(
+				{ {extent, extent} },
+				{ {pSubscriber->thumbnail().data(), thumbnailDepth.data()} },
+				false
+			);
+		}
+
+		// Draw UI
+		if (ImGui::Begin("KinectFusion-Viewer")) {
+			ImGui::Text("Map stream: %s (%s)", name.c_str(), pSubscriber ? "connected" : "waiting for the publisher");
+			if (hasThumbnail)
+				ImGui::Checkbox("Display thumbnail", &displayThumbnail);
+			if (header.has_value()) {
+				ImGui::Text("Version: %llu (%llu skipped, %llu torn reads)", static_cast<unsigned long long>(pSubscriber->version()), static_cast<unsigned long long>(pSubscriber->numSkippedVersions()), static_cast<unsigned long long>(pSubscriber->numTornReads()));
+				ImGui::Text("Frame index: %u", header->frameIndex);
+				ImGui::Text("Bricks: %zu received, %u meshed, %u pending", pSubscriber->numBricks(), header->numMeshedBricks, header->numPendingBricks);
+				ImGui::Text("Triangles: %zu", pSubscriber->numTriangles());
+			}
+		}
+		ImGui::End();
+
+		// Draw the thumbnail from the camera pose, or the mesh with a scene camera.
+		if (displayThumbnail && hasThumbnail) {
+			engine.setCameraMode(Window::CameraMode::Fixed, header->view, header->camera);
+			engine.drawSurface(thumbnails[resourceCycleCounter]);
+		}
+		else {
+			engine.setCameraMode(Window::CameraMode::Scene, std::nullopt, std::nullopt);
+			if (hasMesh)
+				engine.drawPrimitives(meshes[resourceCycleCounter], jjyou::glsl::mat4(1.0f));
+			engine.drawPrimitives(axis, jjyou::glsl::mat4(1.0f));
+			if (header.has_value())
+				engine.drawPrimitives(axis, jjyou::glsl::inverse(header->view) * jjyou::glsl::mat4(jjyou::glsl::mat3(0.2f)));
+		}
+
+		// Record command buffer and present frame.
+		engine.recordCommandbuffer();
+		engine.presentFrame();
+		engine.window().pollEvents();
+		resourceCycleCounter = (resourceCycleCounter + 1) % Engine::NUM_FRAMES_IN_FLIGHT;
+	}
+	engine.waitIdle();
+	return 0;
+}